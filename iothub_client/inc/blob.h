@@ -22,10 +22,12 @@
 
 #ifdef __cplusplus
 #include <cstddef>
+#include <cstdint>
 extern "C"
 {
 #else
 #include <stddef.h>
+#include <stdint.h>
 #endif
 
 #include "azure_c_shared_utility/umock_c_prod.h"
@@ -36,6 +38,9 @@ extern "C"
 #define MAX_BLOCK_COUNT 50000
 #endif
 
+/* Maximum number of Put Block requests Blob_UploadMultipleBlocksFromSasUri keeps in flight */
+#define BLOB_MAX_PARALLEL_UPLOADS 16
+
 #define BLOB_RESULT_VALUES \
     BLOB_OK,               \
     BLOB_ERROR,            \
@@ -46,6 +51,36 @@ extern "C"
 
 DEFINE_ENUM(BLOB_RESULT, BLOB_RESULT_VALUES)
 
+/**
+* @brief  Invoked by Blob_UploadMultipleBlocksFromSasUri, in block order, every time one more block is uploaded
+*
+* @param  blockCount        Number of blocks uploaded so far (block IDs 0 to blockCount - 1)
+* @param  uploadedBytes     Number of bytes in those blocks
+* @param  contentHash       Fingerprint (64 bit FNV-1a hash) of those bytes, to be saved with the checkpoint
+* @param  context           The onBlockUploadedContext of the BLOB_UPLOAD_CHECKPOINT
+*/
+typedef void(*BLOB_BLOCK_UPLOADED_CALLBACK)(unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash, void* context);
+
+typedef struct BLOB_UPLOAD_CHECKPOINT_TAG
+{
+    unsigned int blockCount;                    /*blocks already uploaded by an earlier attempt, they are not uploaded again*/
+    size_t uploadedBytes;                       /*bytes in those blocks, checked against the data returned by getDataCallbackEx*/
+    uint64_t contentHash;                       /*fingerprint of those bytes, checked against the data so a source modified since the earlier attempt is not resumed*/
+    BLOB_BLOCK_UPLOADED_CALLBACK onBlockUploaded;
+    void* onBlockUploadedContext;
+} BLOB_UPLOAD_CHECKPOINT;
+
+/**
+* @brief  Invoked by Blob_UploadMultipleBlocksFromReader to read the next block directly into the buffer that is uploaded
+*
+* @param  block             An empty buffer. The callback sizes it with BUFFER_pre_build (at most BLOCK_SIZE bytes) and fills BUFFER_u_char, or leaves it empty when there is no more data
+* @param  offset            Offset in the data of the block to read
+* @param  context           The context passed to Blob_UploadMultipleBlocksFromReader
+*
+* @return 0 if the block has been read, any other value aborts the upload with BLOB_ERROR
+*/
+typedef int(*BLOB_READ_BLOCK_CALLBACK)(BUFFER_HANDLE block, unsigned long long offset, void* context);
+
 /**
 * @brief  Synchronously uploads a byte array to blob storage
 *
@@ -56,10 +91,41 @@ DEFINE_ENUM(BLOB_RESULT, BLOB_RESULT_VALUES)
 * @param  httpResponse      A BUFFER_HANDLE that receives the HTTP response from the server (available only when the return value is BLOB_OK)
 * @param  certificates      A null terminated string containing CA certificates to be used
 * @param    proxyOptions    A structure that contains optional web proxy information
+* @param  parallelUploads   Number of blocks uploaded concurrently, each over its own connection (1 uploads the blocks one after another)
+* @param  checkpoint        Optional. Blocks already uploaded by an earlier attempt, and the callback notified as new blocks are uploaded
 *
 * @return	A @c BLOB_RESULT. BLOB_OK means the blob has been uploaded successfully. Any other value indicates an error
 */
-MOCKABLE_FUNCTION(, BLOB_RESULT, Blob_UploadMultipleBlocksFromSasUri, const char*, SASURI, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX, getDataCallbackEx, void*, context, unsigned int*, httpStatus, BUFFER_HANDLE, httpResponse, const char*, certificates, HTTP_PROXY_OPTIONS*, proxyOptions)
+MOCKABLE_FUNCTION(, BLOB_RESULT, Blob_UploadMultipleBlocksFromSasUri, const char*, SASURI, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX, getDataCallbackEx, void*, context, unsigned int*, httpStatus, BUFFER_HANDLE, httpResponse, const char*, certificates, HTTP_PROXY_OPTIONS*, proxyOptions, size_t, parallelUploads, BLOB_UPLOAD_CHECKPOINT*, checkpoint)
+
+/**
+* @brief  Synchronously uploads to blob storage blocks read directly into the buffers sent to the server
+*
+* @param  SASURI            The URI to use to upload data
+* @param  readBlockCallback A callback to be invoked to read every block into its upload buffer
+* @param  context           Any data provided by the user to serve as context on readBlockCallback.
+* @param  httpStatus        A pointer to an out argument receiving the HTTP status (available only when the return value is BLOB_OK)
+* @param  httpResponse      A BUFFER_HANDLE that receives the HTTP response from the server (available only when the return value is BLOB_OK)
+* @param  certificates      A null terminated string containing CA certificates to be used
+* @param    proxyOptions    A structure that contains optional web proxy information
+* @param  parallelUploads   Number of blocks uploaded concurrently, each over its own connection (1 uploads the blocks one after another)
+* @param  checkpoint        Optional. Blocks already uploaded by an earlier attempt, and the callback notified as new blocks are uploaded
+*
+* @return	A @c BLOB_RESULT. BLOB_OK means the blob has been uploaded successfully. Any other value indicates an error
+*/
+MOCKABLE_FUNCTION(, BLOB_RESULT, Blob_UploadMultipleBlocksFromReader, const char*, SASURI, BLOB_READ_BLOCK_CALLBACK, readBlockCallback, void*, context, unsigned int*, httpStatus, BUFFER_HANDLE, httpResponse, const char*, certificates, HTTP_PROXY_OPTIONS*, proxyOptions, size_t, parallelUploads, BLOB_UPLOAD_CHECKPOINT*, checkpoint)
+
+/**
+* @brief  Checks that the blocks uploaded by an earlier attempt are still uncommitted in blob storage
+*
+* @param  SASURI            The URI to use to query the block list of the blob
+* @param  blockCount        Number of blocks expected (block IDs 0 to blockCount - 1)
+* @param  certificates      A null terminated string containing CA certificates to be used
+* @param  proxyOptions      A structure that contains optional web proxy information
+*
+* @return	A @c BLOB_RESULT. BLOB_OK means all the blocks are uncommitted in storage and the upload can be resumed
+*/
+MOCKABLE_FUNCTION(, BLOB_RESULT, Blob_VerifyUncommittedBlocks, const char*, SASURI, unsigned int, blockCount, const char*, certificates, HTTP_PROXY_OPTIONS*, proxyOptions)
 
 /**
 * @brief  Synchronously uploads a byte array as a new block to blob storage
@@ -52,7 +52,9 @@ DEFINE_ENUM(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_RESULT_VALUES);
     IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF,      \
     IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF,                 \
     IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER,                 \
-    IOTHUB_CLIENT_RETRY_RANDOM
+    IOTHUB_CLIENT_RETRY_RANDOM,                 \
+    IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER,                 \
+    IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER
 
 /** @brief Enumeration passed in by the IoT Hub when the event confirmation
 *		   callback is invoked to indicate status of the event processing in
@@ -204,6 +206,30 @@ extern "C"
     */
     typedef void(*IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK)(IOTHUB_CLIENT_FILE_UPLOAD_RESULT result, unsigned char const ** data, size_t* size, void* context);
     typedef IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT (*IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX)(IOTHUB_CLIENT_FILE_UPLOAD_RESULT result, unsigned char const ** data, size_t* size, void* context);
+
+#define IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT_VALUES \
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOADED, \
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_NOT_FOUND, \
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_ERROR
+
+    DEFINE_ENUM(IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT, IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT_VALUES);
+
+    /**
+    *  @brief           Storage for the progress of uploads to blob, passed with OPTION_BLOB_UPLOAD_CHECKPOINT_STORE.
+    *  @remarks         load_checkpoint returns IOTHUB_BLOB_UPLOAD_CHECKPOINT_NOT_FOUND when nothing was saved for destinationFileName, and
+    *                   IOTHUB_BLOB_UPLOAD_CHECKPOINT_ERROR when the storage cannot be read; the upload then fails and the checkpoint is left alone.
+    *                   save_checkpoint is invoked after every block and delete_checkpoint once the checkpoint can no longer be resumed.
+    *                   contentHash is a fingerprint of the uploadedBytes bytes; it has to be saved and loaded with the rest of the checkpoint
+    *                   so that a source that was modified since the checkpoint was saved is uploaded again instead of resumed.
+    *                   The functions are invoked on the thread performing the upload, context is passed to all of them.
+    */
+    typedef struct IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE_TAG
+    {
+        IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT(*load_checkpoint)(const char* destinationFileName, unsigned int* blockCount, size_t* uploadedBytes, uint64_t* contentHash, void* context);
+        void(*save_checkpoint)(const char* destinationFileName, unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash, void* context);
+        void(*delete_checkpoint)(const char* destinationFileName, void* context);
+        void* context;
+    } IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE;
 #endif /* DONT_USE_UPLOADTOBLOB */
 
     /** @brief	This struct captures IoTHub client configuration. */
@@ -611,6 +637,18 @@ extern "C"
      */
      MOCKABLE_FUNCTION(, IOTHUB_CLIENT_RESULT, IoTHubClient_LL_UploadMultipleBlocksToBlobEx, IOTHUB_CLIENT_LL_HANDLE, iotHubClientHandle, const char*, destinationFileName, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX, getDataCallbackEx, void*, context);
 
+     /**
+     * @brief    This API uploads to Azure Storage the content of the local file @p sourceFilePath
+     *           under the blob name devicename/@pdestinationFileName
+     *
+     * @param    iotHubClientHandle      The handle created by a call to the create function.
+     * @param    destinationFileName     name of the file.
+     * @param    sourceFilePath          path of the local file to upload. It is read one block at a time, so it can be larger than the available memory.
+     *
+     * @return   IOTHUB_CLIENT_OK upon success or an error code upon failure.
+     */
+     MOCKABLE_FUNCTION(, IOTHUB_CLIENT_RESULT, IoTHubClient_LL_UploadFileToBlob, IOTHUB_CLIENT_LL_HANDLE, iotHubClientHandle, const char*, destinationFileName, const char*, sourceFilePath);
+
 #endif /*DONT_USE_UPLOADTOBLOB*/
 
 #ifdef __cplusplus
@@ -4,6 +4,9 @@
 #ifndef IOTHUB_CLIENT_OPTIONS_H
 #define IOTHUB_CLIENT_OPTIONS_H
 
+#include <stddef.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -16,12 +19,46 @@ extern "C"
         const char* password;
     } IOTHUB_PROXY_OPTIONS;
 
+    typedef struct IOTHUB_EVENT_BATCHING_OPTIONS_TAG
+    {
+        size_t linger_time_ms;
+        size_t max_batch_size_bytes;
+        size_t max_batch_message_count;
+    } IOTHUB_EVENT_BATCHING_OPTIONS;
+
+    typedef enum IOTHUB_EVENT_SENDER_DISPATCH_TAG
+    {
+        IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN,
+        IOTHUB_EVENT_SENDER_DISPATCH_LEAST_OUTSTANDING
+    } IOTHUB_EVENT_SENDER_DISPATCH;
+
+    typedef struct IOTHUB_EVENT_SENDER_LINKS_OPTIONS_TAG
+    {
+        size_t link_count;
+        IOTHUB_EVENT_SENDER_DISPATCH dispatch;
+        bool ordered_completion;
+    } IOTHUB_EVENT_SENDER_LINKS_OPTIONS;
+
+    typedef struct IOTHUB_C2D_PREFETCH_OPTIONS_TAG
+    {
+        size_t initial_credit;
+        size_t min_credit;
+        size_t max_credit;
+    } IOTHUB_C2D_PREFETCH_OPTIONS;
+
     static const char* OPTION_LOG_TRACE = "logtrace";
     static const char* OPTION_X509_CERT = "x509certificate";
     static const char* OPTION_X509_PRIVATE_KEY = "x509privatekey";
     static const char* OPTION_KEEP_ALIVE = "keepalive";
     static const char* OPTION_CONNECTION_TIMEOUT = "connect_timeout";
 
+    /*
+    * @brief Controls the MQTT CleanSession flag sent on CONNECT (bool*). The default is false, meaning the session (and any in-flight
+    *        QoS 1 publishes) is kept by the service across reconnects. Unacknowledged telemetry is retransmitted right after CONNACK,
+    *        with the DUP flag set when the service reports the session as present.
+    */
+    static const char* OPTION_CLEAN_SESSION = "clean_session";
+
     static const char* OPTION_PROXY_HOST = "proxy_address";
     static const char* OPTION_PROXY_USERNAME = "proxy_username";
     static const char* OPTION_PROXY_PASSWORD = "proxy_password";
@@ -33,6 +70,34 @@ extern "C"
     static const char* OPTION_MIN_POLLING_TIME = "MinimumPollingTime";
     static const char* OPTION_BATCHING = "Batching";
 
+    /*
+    * @brief Linger policy for AMQP telemetry (IOTHUB_EVENT_BATCHING_OPTIONS*). Pending events are held for up to `linger_time_ms`,
+    *        or until `max_batch_size_bytes` or `max_batch_message_count` is reached, and then sent as a single batched AMQP message.
+    *        A zero field disables that threshold; with `linger_time_ms` zero (the default) events are sent on the next DoWork.
+    */
+    static const char* OPTION_EVENT_BATCHING = "event_batching";
+
+    /*
+    * @brief Number of AMQP links used to send telemetry for each device (IOTHUB_EVENT_SENDER_LINKS_OPTIONS*), from 1 (the default) to 8.
+    *        Batches are spread over the links in turn, or to the link with the fewest unsettled batches. With `ordered_completion`
+    *        set, send confirmations are reported in the order the batches were sent. Link changes apply on the next connection.
+    */
+    static const char* OPTION_EVENT_SENDER_LINKS = "event_sender_links";
+
+    /*
+    * @brief Reported state coalescing window for AMQP and MQTT twin (size_t*), from 0 (the default, disabled) to 60 seconds. Reported state
+    *        patches are held until the oldest one is this old and then merged into a single PATCH, later values winning for the
+    *        same property path. Every original IoTHubClient_SendReportedState callback is invoked with the result of the merged PATCH.
+    */
+    static const char* OPTION_TWIN_REPORTED_STATE_COALESCE_SECS = "twin_reported_state_coalesce_secs";
+
+    /*
+    * @brief Link credit (prefetch) of the AMQP cloud-to-device receiver link (IOTHUB_C2D_PREFETCH_OPTIONS*). The link starts with
+    *        `initial_credit`; it doubles, up to `max_credit`, while messages arrive faster than it is replenished, and halves, down to
+    *        `min_credit`, while the application holds as many unsettled messages as the credit allows. Applies on the next connection.
+    */
+    static const char* OPTION_C2D_PREFETCH = "c2d_prefetch";
+
     static const char* OPTION_MESSAGE_TIMEOUT = "messageTimeout";
     static const char* OPTION_PRODUCT_INFO = "product_info";
     /*
@@ -55,6 +120,28 @@ extern "C"
     */
     static const char* OPTION_REMOTE_IDLE_TIMEOUT_RATIO = "cl2svc_keep_alive_send_ratio"; 
 
+    /*
+    * @brief Number of AMQP sessions (size_t*, from 1 to 16) opened on a multiplexed AMQP connection. Registered devices are spread
+    *        over the sessions by device id, which reduces contention on session flow control when many devices share the connection.
+    *        The default is 1. Changes apply on the next connection.
+    */
+    static const char* OPTION_AMQP_SESSION_COUNT = "amqp_session_count";
+
+    /*
+    * @brief Number of blocks upload-to-blob sends at once (size_t*), from 1 (the default, one block after another) to 16. Each
+    *        block in flight uses its own connection to the storage account and holds one block of data in memory; a block that
+    *        fails with a connection error or a 5xx status is retried twice before the upload fails.
+    */
+    static const char* OPTION_BLOB_UPLOAD_PARALLELISM = "blob_upload_parallelism";
+
+    /*
+    * @brief Store (const IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE*, copied) where upload-to-blob saves its progress after every block.
+    *        If an upload of the same destination file name fails or the process restarts, the next upload skips the blocks
+    *        already in storage instead of sending the whole file again. The data source must return the same blocks.
+    *        NULL stops saving progress.
+    */
+    static const char* OPTION_BLOB_UPLOAD_CHECKPOINT_STORE = "blob_upload_checkpoint_store";
+
     //diagnostic sampling percentage value, [0-100]
     static const char* OPTION_DIAGNOSTIC_SAMPLING_PERCENTAGE = "diag_sampling_percentage";
 
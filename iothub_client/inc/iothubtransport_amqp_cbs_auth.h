@@ -36,6 +36,8 @@ extern "C"
         AUTHENTICATION_ERROR_SAS_REFRESH_FAILED
     } AUTHENTICATION_ERROR_CODE;
 
+    typedef struct AUTHENTICATION_PUT_TOKEN_QUEUE* AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE;
+
     typedef void(*ON_AUTHENTICATION_STATE_CHANGED_CALLBACK)(void* context, AUTHENTICATION_STATE previous_state, AUTHENTICATION_STATE new_state);
     typedef void(*ON_AUTHENTICATION_ERROR_CALLBACK)(void* context, AUTHENTICATION_ERROR_CODE error_code);
 
@@ -52,6 +54,10 @@ extern "C"
 
         IOTHUB_AUTHORIZATION_HANDLE authorization_module;                   // with either SAS Token, x509 Certs, and Device SAS Token
 
+        size_t device_id_hash;                                              // Hash of `device_id`; gives each device a stable position within the SAS token refresh spread window.
+
+        AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue;              // Optional; shared by the devices of a connection to bound their put-tokens in progress.
+
     } AUTHENTICATION_CONFIG;
 
     typedef struct AUTHENTICATION_INSTANCE* AUTHENTICATION_HANDLE;
@@ -64,6 +70,10 @@ extern "C"
     MOCKABLE_FUNCTION(, int, authentication_set_option, AUTHENTICATION_HANDLE, authentication_handle, const char*, name, void*, value);
     MOCKABLE_FUNCTION(, OPTIONHANDLER_HANDLE, authentication_retrieve_options, AUTHENTICATION_HANDLE, authentication_handle);
 
+    MOCKABLE_FUNCTION(, AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE, authentication_put_token_queue_create, size_t, max_put_tokens_in_progress);
+    MOCKABLE_FUNCTION(, void, authentication_put_token_queue_do_work, AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE, put_token_queue);
+    MOCKABLE_FUNCTION(, void, authentication_put_token_queue_destroy, AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE, put_token_queue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,7 @@
 #include "azure_uamqp_c/cbs.h"
 #include "iothub_message.h"
 #include "iothub_client_private.h"
+#include "iothubtransport_amqp_cbs_auth.h"
 #include "iothubtransport_amqp_device.h"
 
 #ifdef __cplusplus
@@ -23,6 +24,10 @@ static const char* DEVICE_OPTION_EVENT_SEND_TIMEOUT_SECS = "event_send_timeout_s
 static const char* DEVICE_OPTION_CBS_REQUEST_TIMEOUT_SECS = "cbs_request_timeout_secs";
 static const char* DEVICE_OPTION_SAS_TOKEN_REFRESH_TIME_SECS = "sas_token_refresh_time_secs";
 static const char* DEVICE_OPTION_SAS_TOKEN_LIFETIME_SECS = "sas_token_lifetime_secs";
+static const char* DEVICE_OPTION_EVENT_BATCHING = "event_batching";
+static const char* DEVICE_OPTION_EVENT_SENDER_LINKS = "event_sender_links";
+static const char* DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS = "twin_reported_state_coalesce_secs";
+static const char* DEVICE_OPTION_C2D_PREFETCH = "c2d_prefetch";
 
 #define DEVICE_STATE_VALUES \
     DEVICE_STATE_STOPPED, \
@@ -101,6 +106,12 @@ typedef struct DEVICE_CONFIG_TAG
     // Auth module used to generating handle authorization
     // with either SAS Token, x509 Certs, and Device SAS Token
     IOTHUB_AUTHORIZATION_HANDLE authorization_module;
+
+    // Hash of the device id, used to spread SAS token refreshes of different devices.
+    size_t device_id_hash;
+
+    // Optional queue shared by the devices of a connection, bounding how many put-tokens they have in progress.
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue;
 } DEVICE_CONFIG;
 
 typedef struct AMQP_DEVICE_INSTANCE* AMQP_DEVICE_HANDLE;
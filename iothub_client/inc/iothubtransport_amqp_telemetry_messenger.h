@@ -20,6 +20,9 @@ extern "C"
 
 
 static const char* TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS = "telemetry_event_send_timeout_secs";
+static const char* TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING = "telemetry_event_batching";
+static const char* TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS = "telemetry_event_sender_links";
+static const char* TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH = "telemetry_c2d_prefetch";
 static const char* TELEMETRY_MESSENGER_OPTION_SAVED_OPTIONS = "saved_telemetry_messenger_options";
 
 typedef struct TELEMETRY_MESSENGER_INSTANCE* TELEMETRY_MESSENGER_HANDLE;
@@ -17,6 +17,8 @@ extern "C"
 
 	typedef struct TWIN_MESSENGER_INSTANCE* TWIN_MESSENGER_HANDLE;
 
+	static const char* TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS = "twin_reported_state_coalesce_secs";
+
 	#define TWIN_MESSENGER_SEND_STATUS_VALUES \
 		TWIN_MESSENGER_SEND_STATUS_IDLE, \
 		TWIN_MESSENGER_SEND_STATUS_BUSY
@@ -7,6 +7,7 @@
 #include "iothub_message.h"
 #include "azure_uamqp_c/message.h"
 #include "azure_c_shared_utility/umock_c_prod.h"
+#include "azure_c_shared_utility/buffer_.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -15,6 +16,7 @@ extern "C"
 
 	MOCKABLE_FUNCTION(, int, message_create_IoTHubMessage_from_uamqp_message, MESSAGE_HANDLE, uamqp_message, IOTHUB_MESSAGE_HANDLE*, iothubclient_message);
 	MOCKABLE_FUNCTION(, int, message_create_uamqp_encoding_from_iothub_message, MESSAGE_HANDLE, message_batch_container, IOTHUB_MESSAGE_HANDLE, message_handle, BINARY_DATA*, body_binary_data);
+	MOCKABLE_FUNCTION(, int, message_create_uamqp_encoding_from_iothub_message_in_buffer, MESSAGE_HANDLE, message_batch_container, IOTHUB_MESSAGE_HANDLE, message_handle, BUFFER_HANDLE, encode_buffer, BINARY_DATA*, body_binary_data);
 
 #ifdef __cplusplus
 }
@@ -4,12 +4,207 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "azure_c_shared_utility/gballoc.h"
+#include "azure_c_shared_utility/optimize_size.h"
 #include "blob.h"
 
 #include "azure_c_shared_utility/httpapiex.h"
+#include "azure_c_shared_utility/httpapi.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/base64.h"
 #include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/lock.h"
+
+/*a block upload that fails at the HTTP level or with a 5xx status is attempted at most this many times when uploading in parallel*/
+#define BLOB_BLOCK_UPLOAD_MAX_ATTEMPTS 3
+/*blocks uploaded ahead of a slower block wait for it to be added to the block list in a window this many times parallelUploads*/
+#define BLOB_BLOCK_COMMIT_WINDOW_FACTOR 2
+/*how long an idle upload thread or the calling thread sleeps before looking for work again*/
+#define BLOB_UPLOAD_IDLE_SLEEP_MS 1
+/*64 bit FNV-1a, the fingerprint of the uploaded data saved in checkpoints*/
+#define BLOB_CONTENT_HASH_OFFSET_BASIS 14695981039346656037ULL
+#define BLOB_CONTENT_HASH_PRIME 1099511628211ULL
+
+typedef struct BLOB_BLOCK_UPLOAD_TAG
+{
+    BUFFER_HANDLE requestContent;       /*NULL once the block is uploaded*/
+    size_t size;                        /*size of requestContent*/
+    uint64_t contentHash;               /*fingerprint of the data up to and including this block*/
+    unsigned int blockID;
+    int isUploaded;
+    BLOB_RESULT result;
+    unsigned int httpStatus;
+} BLOB_BLOCK_UPLOAD;
+
+typedef struct BLOB_UPLOADER_TAG
+{
+    struct BLOB_PARALLEL_UPLOAD_TAG* parallelUpload;
+    HTTPAPIEX_HANDLE httpApiExHandle;   /*each uploader keeps its own connection for the whole blob*/
+    BUFFER_HANDLE httpResponse;
+    THREAD_HANDLE threadHandle;         /*NULL for the calling thread and for a thread that could not be created*/
+} BLOB_UPLOADER;
+
+/*all the fields below lock are only accessed with lock held*/
+typedef struct BLOB_PARALLEL_UPLOAD_TAG
+{
+    const char* relativePath;
+    size_t parallelUploads;
+    BLOB_UPLOADER* uploaders;           /*uploaders[0] is the calling thread, the others run upload_thread*/
+    size_t windowSize;
+    BLOB_BLOCK_UPLOAD* blocks;          /*block N is blocks[N % windowSize] until it is added to the block list*/
+    LOCK_HANDLE lock;
+    unsigned int nextBlockToCommit;     /*blocks nextBlockToCommit... nextBlockToQueue-1 are in the window*/
+    unsigned int nextBlockToUpload;     /*blocks nextBlockToUpload... nextBlockToQueue-1 are waiting for an uploader*/
+    unsigned int nextBlockToQueue;
+    size_t blocksInMemory;              /*blocks that are read and not uploaded yet*/
+    size_t uploadsInProgress;
+    int isStopping;
+    int isFailed;
+    BLOB_RESULT failedResult;
+    unsigned int failedHttpStatus;
+    BLOB_UPLOADER* failedUploader;      /*its httpResponse holds the response of the failed block*/
+} BLOB_PARALLEL_UPLOAD;
+
+/*where the blocks come from: either getDataCallbackEx, whose data is copied into the upload buffer, or readBlockCallback, that reads directly into it*/
+typedef struct BLOB_BLOCK_SOURCE_TAG
+{
+    IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx;
+    BLOB_READ_BLOCK_CALLBACK readBlockCallback;
+    void* context;
+    unsigned long long offset;          /*offset of the next block read by readBlockCallback*/
+    uint64_t contentHash;               /*fingerprint of the data read so far*/
+} BLOB_BLOCK_SOURCE;
+
+typedef enum BLOB_PARALLEL_UPLOAD_ACTION_TAG
+{
+    BLOB_PARALLEL_UPLOAD_COMMIT,
+    BLOB_PARALLEL_UPLOAD_READ,
+    BLOB_PARALLEL_UPLOAD_UPLOAD,
+    BLOB_PARALLEL_UPLOAD_WAIT,
+    BLOB_PARALLEL_UPLOAD_DONE
+} BLOB_PARALLEL_UPLOAD_ACTION;
+
+static STRING_HANDLE create_block_id_string(unsigned int blockID)
+{
+    STRING_HANDLE result;
+    char temp[7]; /*this will contain 000000... 049999*/
+
+    if (sprintf(temp, "%6u", (unsigned int)blockID) != 6) /*produces 000000... 049999*/
+    {
+        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+        LogError("failed to sprintf");
+        result = NULL;
+    }
+    /*Codes_SRS_BLOB_02_020: [ Blob_UploadMultipleBlocksFromSasUri shall construct a BASE64 encoded string from the block ID (000000... 049999) ]*/
+    else if ((result = Base64_Encode_Bytes((const unsigned char*)temp, 6)) == NULL)
+    {
+        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+        LogError("unable to Base64_Encode_Bytes");
+    }
+
+    return result;
+}
+
+static int append_block_id_string(STRING_HANDLE blockIDList, STRING_HANDLE blockIdString)
+{
+    int result;
+
+    /*add the blockId base64 encoded to the XML*/
+    if (!(
+        (STRING_concat(blockIDList, "<Latest>") == 0) &&
+        (STRING_concat_with_STRING(blockIDList, blockIdString) == 0) &&
+        (STRING_concat(blockIDList, "</Latest>") == 0)
+        ))
+    {
+        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+        LogError("unable to STRING_concat");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+/*adds the <Latest> element of a block to the block list*/
+static int append_block_id(STRING_HANDLE blockIDList, unsigned int blockID)
+{
+    int result;
+    STRING_HANDLE blockIdString = create_block_id_string(blockID);
+
+    if (blockIdString == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = append_block_id_string(blockIDList, blockIdString);
+        STRING_delete(blockIdString);
+    }
+
+    return result;
+}
+
+static BLOB_RESULT put_block(HTTPAPIEX_HANDLE httpApiExHandle, const char* relativePath, BUFFER_HANDLE requestContent, STRING_HANDLE blockIdString, unsigned int* httpStatus, BUFFER_HANDLE httpResponse)
+{
+    BLOB_RESULT result;
+
+    /*Codes_SRS_BLOB_02_022: [ Blob_UploadMultipleBlocksFromSasUri shall construct a new relativePath from following string: base relativePath + "&comp=block&blockid=BASE64 encoded string of blockId" ]*/
+    STRING_HANDLE newRelativePath = STRING_construct(relativePath);
+    if (newRelativePath == NULL)
+    {
+        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+        LogError("unable to STRING_construct");
+        result = BLOB_ERROR;
+    }
+    else
+    {
+        if (!(
+            (STRING_concat(newRelativePath, "&comp=block&blockid=") == 0) &&
+            (STRING_concat_with_STRING(newRelativePath, blockIdString) == 0)
+            ))
+        {
+            /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+            LogError("unable to STRING concatenate");
+            result = BLOB_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_BLOB_02_024: [ Blob_UploadMultipleBlocksFromSasUri shall call HTTPAPIEX_ExecuteRequest with a PUT operation, passing httpStatus and httpResponse. ]*/
+            if (HTTPAPIEX_ExecuteRequest(
+                httpApiExHandle,
+                HTTPAPI_REQUEST_PUT,
+                STRING_c_str(newRelativePath),
+                NULL,
+                requestContent,
+                httpStatus,
+                NULL,
+                httpResponse) != HTTPAPIEX_OK
+                )
+            {
+                /*Codes_SRS_BLOB_02_025: [ If HTTPAPIEX_ExecuteRequest fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_HTTP_ERROR. ]*/
+                LogError("unable to HTTPAPIEX_ExecuteRequest");
+                result = BLOB_HTTP_ERROR;
+            }
+            else if (*httpStatus >= 300)
+            {
+                /*Codes_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
+                LogError("HTTP status from storage does not indicate success (%d)", (int)*httpStatus);
+                result = BLOB_OK;
+            }
+            else
+            {
+                /*Codes_SRS_BLOB_02_027: [ Otherwise Blob_UploadMultipleBlocksFromSasUri shall continue execution. ]*/
+                result = BLOB_OK;
+            }
+        }
+        STRING_delete(newRelativePath);
+    }
+
+    return result;
+}
 
 BLOB_RESULT Blob_UploadBlock(
         HTTPAPIEX_HANDLE httpApiExHandle,
@@ -21,110 +216,924 @@ BLOB_RESULT Blob_UploadBlock(
         BUFFER_HANDLE httpResponse)
 {
     BLOB_RESULT result;
-
-    if (requestContent == NULL ||
-        blockIDList == NULL ||
-        relativePath == NULL ||
-        httpApiExHandle == NULL ||
-        httpStatus == NULL ||
-        httpResponse == NULL)
+
+    if (requestContent == NULL ||
+        blockIDList == NULL ||
+        relativePath == NULL ||
+        httpApiExHandle == NULL ||
+        httpStatus == NULL ||
+        httpResponse == NULL)
+    {
+        LogError("invalid argument detected requestContent=%p blockIDList=%p relativePath=%p httpApiExHandle=%p httpStatus=%p httpResponse=%p", requestContent, blockIDList, relativePath, httpApiExHandle, httpStatus, httpResponse);
+        result = BLOB_ERROR;
+    }
+    else
+    {
+        STRING_HANDLE blockIdString = create_block_id_string(blockID);
+        if (blockIdString == NULL)
+        {
+            result = BLOB_ERROR;
+        }
+        else
+        {
+            if (append_block_id_string(blockIDList, blockIdString) != 0)
+            {
+                result = BLOB_ERROR;
+            }
+            else
+            {
+                result = put_block(httpApiExHandle, relativePath, requestContent, blockIdString, httpStatus, httpResponse);
+            }
+            STRING_delete(blockIdString);
+        }
+    }
+    return result;
+}
+
+static int set_http_api_ex_options(HTTPAPIEX_HANDLE httpApiExHandle, const char* certificates, HTTP_PROXY_OPTIONS *proxyOptions)
+{
+    int result;
+
+    if ((certificates != NULL) && (HTTPAPIEX_SetOption(httpApiExHandle, "TrustedCerts", certificates) == HTTPAPIEX_ERROR))
+    {
+        LogError("failure in setting trusted certificates");
+        result = __FAILURE__;
+    }
+    else if ((proxyOptions != NULL && proxyOptions->host_address != NULL) && HTTPAPIEX_SetOption(httpApiExHandle, OPTION_HTTP_PROXY, proxyOptions) == HTTPAPIEX_ERROR)
+    {
+        LogError("failure in setting proxy options");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static uint64_t hash_content(uint64_t contentHash, const unsigned char* data, size_t size)
+{
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        contentHash = (contentHash ^ data[i]) * BLOB_CONTENT_HASH_PRIME;
+    }
+    return contentHash;
+}
+
+static BLOB_RESULT read_block(BLOB_BLOCK_SOURCE* blockSource, unsigned int blockID, BUFFER_HANDLE* block, size_t* size)
+{
+    BLOB_RESULT result;
+
+    *block = NULL;
+
+    if (blockSource->readBlockCallback != NULL)
+    {
+        /*Codes_SRS_BLOB_09_027: [ `Blob_UploadMultipleBlocksFromReader` shall create an empty BUFFER_HANDLE for every block and call `readBlockCallback` with it and the offset of the block, and shall upload that same buffer. ]*/
+        if ((*block = BUFFER_new()) == NULL)
+        {
+            LogError("unable to BUFFER_new");
+            result = BLOB_ERROR;
+        }
+        else if (blockSource->readBlockCallback(*block, blockSource->offset, blockSource->context) != 0)
+        {
+            /*Codes_SRS_BLOB_09_028: [ If `readBlockCallback` fails, `Blob_UploadMultipleBlocksFromReader` shall fail and return `BLOB_ERROR`. ]*/
+            LogError("unable to read the block at offset %llu", blockSource->offset);
+            result = BLOB_ERROR;
+        }
+        else if ((*size = BUFFER_length(*block)) == 0)
+        {
+            /*Codes_SRS_BLOB_09_029: [ If `readBlockCallback` leaves the buffer empty, `Blob_UploadMultipleBlocksFromReader` shall exit the loop. ]*/
+            result = BLOB_OK;
+        }
+        else if (*size > BLOCK_SIZE)
+        {
+            /*Codes_SRS_BLOB_99_001: [ If the size of the block returned by `getDataCallbackEx` is bigger than 4MB, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+            LogError("tried to upload block of size %lu, max allowed size is %d", (unsigned long)*size, BLOCK_SIZE);
+            result = BLOB_INVALID_ARG;
+        }
+        else if (blockID >= MAX_BLOCK_COUNT)
+        {
+            /*Codes_SRS_BLOB_99_003: [ If `getDataCallbackEx` returns more than 50000 blocks, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+            LogError("unable to upload more than %lu blocks in one blob", (unsigned long)MAX_BLOCK_COUNT);
+            result = BLOB_INVALID_ARG;
+        }
+        else
+        {
+            blockSource->offset += *size;
+            blockSource->contentHash = hash_content(blockSource->contentHash, BUFFER_u_char(*block), *size);
+            result = BLOB_OK;
+        }
+
+        if ((*block != NULL) && (result != BLOB_OK || *size == 0))
+        {
+            BUFFER_delete(*block);
+            *block = NULL;
+        }
+    }
+    else
+    {
+        unsigned char const * source;
+
+        if (blockSource->getDataCallbackEx(FILE_UPLOAD_OK, &source, size, blockSource->context) == IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_ABORT)
+        {
+            /*Codes_SRS_BLOB_99_004: [ If `getDataCallbackEx` returns `IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT_ABORT`, then `Blob_UploadMultipleBlocksFromSasUri` shall exit the loop and return `BLOB_ABORTED`. ]*/
+            LogInfo("Upload to blob has been aborted by the user");
+            result = BLOB_ABORTED;
+        }
+        else if (source == NULL || *size == 0)
+        {
+            /*Codes_SRS_BLOB_99_002: [ If the size of the block returned by `getDataCallbackEx` is 0 or if the data is NULL, then `Blob_UploadMultipleBlocksFromSasUri` shall exit the loop. ]*/
+            result = BLOB_OK;
+        }
+        else if (*size > BLOCK_SIZE)
+        {
+            /*Codes_SRS_BLOB_99_001: [ If the size of the block returned by `getDataCallbackEx` is bigger than 4MB, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+            LogError("tried to upload block of size %lu, max allowed size is %d", (unsigned long)*size, BLOCK_SIZE);
+            result = BLOB_INVALID_ARG;
+        }
+        else if (blockID >= MAX_BLOCK_COUNT)
+        {
+            /*Codes_SRS_BLOB_99_003: [ If `getDataCallbackEx` returns more than 50000 blocks, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+            LogError("unable to upload more than %lu blocks in one blob", (unsigned long)MAX_BLOCK_COUNT);
+            result = BLOB_INVALID_ARG;
+        }
+        /*Codes_SRS_BLOB_02_023: [ Blob_UploadMultipleBlocksFromSasUri shall create a BUFFER_HANDLE from source and size parameters. ]*/
+        else if ((*block = BUFFER_create(source, *size)) == NULL)
+        {
+            LogError("unable to BUFFER_create");
+            result = BLOB_ERROR;
+        }
+        else
+        {
+            blockSource->contentHash = hash_content(blockSource->contentHash, source, *size);
+            result = BLOB_OK;
+        }
+    }
+
+    return result;
+}
+
+static BLOB_RESULT skip_uploaded_blocks(BLOB_BLOCK_SOURCE* blockSource, const BLOB_UPLOAD_CHECKPOINT* checkpoint, STRING_HANDLE blockIDList)
+{
+    BLOB_RESULT result = BLOB_OK;
+    size_t skippedBytes = 0;
+    unsigned int blockID;
+
+    /*Codes_SRS_BLOB_09_008: [ `Blob_UploadMultipleBlocksFromSasUri` shall obtain the first `checkpoint->blockCount` blocks from `getDataCallbackEx` and add their IDs to the block list without uploading them. ]*/
+    for (blockID = 0; blockID < checkpoint->blockCount && result == BLOB_OK; blockID++)
+    {
+        unsigned char const * source;
+        size_t size;
+
+        if (blockSource->readBlockCallback != NULL)
+        {
+            /*the skipped blocks are read only to find where the next block starts*/
+            BUFFER_HANDLE block;
+
+            if ((result = read_block(blockSource, blockID, &block, &size)) == BLOB_OK)
+            {
+                source = (block == NULL) ? NULL : BUFFER_u_char(block);
+                BUFFER_delete(block);
+            }
+        }
+        else if (blockSource->getDataCallbackEx(FILE_UPLOAD_OK, &source, &size, blockSource->context) == IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_ABORT)
+        {
+            LogInfo("Upload to blob has been aborted by the user");
+            result = BLOB_ABORTED;
+        }
+
+        if (result != BLOB_OK)
+        {
+            /*do nothing, it will be reported "as is"*/
+        }
+        else if (source == NULL || size == 0)
+        {
+            /*Codes_SRS_BLOB_09_009: [ If the data ends before `checkpoint->blockCount` blocks, or their total size is not `checkpoint->uploadedBytes`, or their fingerprint is not `checkpoint->contentHash`, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+            LogError("data ended after %u blocks, the checkpoint has %u", blockID, checkpoint->blockCount);
+            result = BLOB_INVALID_ARG;
+        }
+        else if (append_block_id(blockIDList, blockID) != 0)
+        {
+            result = BLOB_ERROR;
+        }
+        else
+        {
+            if (blockSource->readBlockCallback == NULL)
+            {
+                /*read_block hashes the blocks it reads*/
+                blockSource->contentHash = hash_content(blockSource->contentHash, source, size);
+            }
+            skippedBytes += size;
+        }
+    }
+
+    if (result != BLOB_OK)
+    {
+        /*do nothing, it will be reported "as is"*/
+    }
+    else if (skippedBytes != checkpoint->uploadedBytes)
+    {
+        /*Codes_SRS_BLOB_09_009: [ If the data ends before `checkpoint->blockCount` blocks, or their total size is not `checkpoint->uploadedBytes`, or their fingerprint is not `checkpoint->contentHash`, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+        LogError("the first %u blocks have %lu bytes, the checkpoint has %lu", checkpoint->blockCount, (unsigned long)skippedBytes, (unsigned long)checkpoint->uploadedBytes);
+        result = BLOB_INVALID_ARG;
+    }
+    else if (blockSource->contentHash != checkpoint->contentHash)
+    {
+        /*Codes_SRS_BLOB_09_009: [ If the data ends before `checkpoint->blockCount` blocks, or their total size is not `checkpoint->uploadedBytes`, or their fingerprint is not `checkpoint->contentHash`, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+        LogError("the first %u blocks have changed since the checkpoint was saved", checkpoint->blockCount);
+        result = BLOB_INVALID_ARG;
+    }
+
+    return result;
+}
+
+static void notify_block_uploaded(BLOB_UPLOAD_CHECKPOINT* checkpoint, unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash)
+{
+    /*Codes_SRS_BLOB_09_010: [ After each block is uploaded with an HTTP status < 300, `Blob_UploadMultipleBlocksFromSasUri` shall call `checkpoint->onBlockUploaded`, in block order, with the number of blocks and bytes uploaded so far and the fingerprint of those bytes. ]*/
+    if (checkpoint != NULL && checkpoint->onBlockUploaded != NULL)
+    {
+        checkpoint->onBlockUploaded(blockCount, uploadedBytes, contentHash, checkpoint->onBlockUploadedContext);
+    }
+}
+
+/*lock must be held*/
+static void record_parallel_upload_failure(BLOB_PARALLEL_UPLOAD* parallelUpload, BLOB_UPLOADER* uploader, BLOB_RESULT result, unsigned int httpStatus)
+{
+    if (!parallelUpload->isFailed)
+    {
+        parallelUpload->isFailed = 1;
+        parallelUpload->failedResult = result;
+        parallelUpload->failedHttpStatus = httpStatus;
+        parallelUpload->failedUploader = uploader;
+    }
+}
+
+/*lock must be held, returns NULL if no block is waiting for an uploader*/
+static BLOB_BLOCK_UPLOAD* take_queued_block(BLOB_PARALLEL_UPLOAD* parallelUpload)
+{
+    BLOB_BLOCK_UPLOAD* result;
+
+    if (parallelUpload->isStopping || parallelUpload->isFailed || parallelUpload->nextBlockToUpload == parallelUpload->nextBlockToQueue)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = &parallelUpload->blocks[parallelUpload->nextBlockToUpload % parallelUpload->windowSize];
+        parallelUpload->nextBlockToUpload++;
+        parallelUpload->uploadsInProgress++;
+    }
+
+    return result;
+}
+
+static void upload_queued_block(BLOB_UPLOADER* uploader, BLOB_BLOCK_UPLOAD* blockUpload)
+{
+    BLOB_PARALLEL_UPLOAD* parallelUpload = uploader->parallelUpload;
+    STRING_HANDLE blockIdString = create_block_id_string(blockUpload->blockID);
+
+    if (blockIdString == NULL)
+    {
+        blockUpload->result = BLOB_ERROR;
+    }
+    else
+    {
+        size_t attempt;
+
+        for (attempt = 0; attempt < BLOB_BLOCK_UPLOAD_MAX_ATTEMPTS; attempt++)
+        {
+            blockUpload->result = put_block(uploader->httpApiExHandle, parallelUpload->relativePath, blockUpload->requestContent, blockIdString, &blockUpload->httpStatus, uploader->httpResponse);
+
+            /*Codes_SRS_BLOB_09_004: [ When uploading in parallel, a block that fails with `BLOB_HTTP_ERROR` or an HTTP status >= 500 shall be uploaded again, up to 3 attempts in total. ]*/
+            if (!(blockUpload->result == BLOB_HTTP_ERROR || (blockUpload->result == BLOB_OK && blockUpload->httpStatus >= 500)))
+            {
+                break;
+            }
+
+            LogInfo("upload of block %u failed (attempt %lu)", blockUpload->blockID, (unsigned long)(attempt + 1));
+        }
+
+        STRING_delete(blockIdString);
+    }
+
+    /*Codes_SRS_BLOB_09_003: [ When uploading in parallel, no more than `parallelUploads` blocks obtained from `getDataCallbackEx` shall be held in memory at any time, and a block shall be released as soon as it is uploaded. ]*/
+    BUFFER_delete(blockUpload->requestContent);
+    blockUpload->requestContent = NULL;
+
+    if (Lock(parallelUpload->lock) != LOCK_OK)
+    {
+        /*the calling thread would wait forever for this block*/
+        LogError("unable to Lock, block %u is lost", blockUpload->blockID);
+    }
+    else
+    {
+        blockUpload->isUploaded = 1;
+        parallelUpload->blocksInMemory--;
+        parallelUpload->uploadsInProgress--;
+
+        if (blockUpload->result != BLOB_OK || blockUpload->httpStatus >= 300)
+        {
+            LogError("unable to upload block %u. Returned value=%d, httpStatus=%u", blockUpload->blockID, blockUpload->result, blockUpload->httpStatus);
+            record_parallel_upload_failure(parallelUpload, uploader, blockUpload->result, blockUpload->httpStatus);
+        }
+
+        (void)Unlock(parallelUpload->lock);
+    }
+}
+
+static int upload_thread(void* context)
+{
+    BLOB_UPLOADER* uploader = (BLOB_UPLOADER*)context;
+    BLOB_PARALLEL_UPLOAD* parallelUpload = uploader->parallelUpload;
+    int isStopping = 0;
+
+    /*Codes_SRS_BLOB_09_005: [ Each upload thread shall take the oldest block waiting for an uploader, upload it, and repeat until `Blob_UploadMultipleBlocksFromSasUri` stops it. ]*/
+    while (!isStopping)
+    {
+        BLOB_BLOCK_UPLOAD* blockUpload;
+
+        if (Lock(parallelUpload->lock) != LOCK_OK)
+        {
+            LogError("unable to Lock, upload thread exits");
+            isStopping = 1;
+        }
+        else
+        {
+            isStopping = parallelUpload->isStopping;
+            blockUpload = take_queued_block(parallelUpload);
+            (void)Unlock(parallelUpload->lock);
+
+            if (blockUpload != NULL)
+            {
+                upload_queued_block(uploader, blockUpload);
+            }
+            else if (!isStopping)
+            {
+                ThreadAPI_Sleep(BLOB_UPLOAD_IDLE_SLEEP_MS);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*the calling thread reads the blocks, uploads a block itself when all the upload threads are busy, and adds the uploaded blocks to the block list in block order*/
+static BLOB_RESULT run_parallel_upload(BLOB_PARALLEL_UPLOAD* parallelUpload, BLOB_BLOCK_SOURCE* blockSource, STRING_HANDLE blockIDList, unsigned int* httpStatus, BLOB_UPLOAD_CHECKPOINT* checkpoint)
+{
+    BLOB_RESULT result = BLOB_OK;
+    size_t uploadedBytes = (checkpoint == NULL) ? 0 : checkpoint->uploadedBytes;
+    int isDataEnded = 0;
+    BLOB_PARALLEL_UPLOAD_ACTION action = BLOB_PARALLEL_UPLOAD_WAIT;
+
+    while (result == BLOB_OK && action != BLOB_PARALLEL_UPLOAD_DONE)
+    {
+        BLOB_BLOCK_UPLOAD* blockUpload = NULL;
+
+        if (Lock(parallelUpload->lock) != LOCK_OK)
+        {
+            LogError("unable to Lock");
+            result = BLOB_ERROR;
+            break;
+        }
+
+        if ((parallelUpload->nextBlockToCommit != parallelUpload->nextBlockToQueue) &&
+            (parallelUpload->blocks[parallelUpload->nextBlockToCommit % parallelUpload->windowSize].isUploaded) &&
+            (parallelUpload->blocks[parallelUpload->nextBlockToCommit % parallelUpload->windowSize].result == BLOB_OK) &&
+            (parallelUpload->blocks[parallelUpload->nextBlockToCommit % parallelUpload->windowSize].httpStatus < 300))
+        {
+            blockUpload = &parallelUpload->blocks[parallelUpload->nextBlockToCommit % parallelUpload->windowSize];
+            parallelUpload->nextBlockToCommit++;
+            action = BLOB_PARALLEL_UPLOAD_COMMIT;
+        }
+        else if (parallelUpload->isFailed)
+        {
+            /*the blocks still uploading finish before the upload threads are joined*/
+            action = BLOB_PARALLEL_UPLOAD_DONE;
+        }
+        else if (!isDataEnded &&
+            (parallelUpload->nextBlockToQueue - parallelUpload->nextBlockToCommit < parallelUpload->windowSize) &&
+            (parallelUpload->blocksInMemory < parallelUpload->parallelUploads))
+        {
+            blockUpload = &parallelUpload->blocks[parallelUpload->nextBlockToQueue % parallelUpload->windowSize];
+            action = BLOB_PARALLEL_UPLOAD_READ;
+        }
+        else if ((blockUpload = take_queued_block(parallelUpload)) != NULL)
+        {
+            action = BLOB_PARALLEL_UPLOAD_UPLOAD;
+        }
+        else if (parallelUpload->uploadsInProgress > 0)
+        {
+            action = BLOB_PARALLEL_UPLOAD_WAIT;
+        }
+        else
+        {
+            action = BLOB_PARALLEL_UPLOAD_DONE;
+        }
+
+        (void)Unlock(parallelUpload->lock);
+
+        switch (action)
+        {
+            case BLOB_PARALLEL_UPLOAD_COMMIT:
+                /*Codes_SRS_BLOB_09_006: [ Uploaded blocks shall be appended to the block list in block order, each one as soon as all the blocks before it are uploaded. ]*/
+                *httpStatus = blockUpload->httpStatus;
+
+                if (append_block_id(blockIDList, blockUpload->blockID) != 0)
+                {
+                    result = BLOB_ERROR;
+                }
+                else
+                {
+                    uploadedBytes += blockUpload->size;
+                    notify_block_uploaded(checkpoint, blockUpload->blockID + 1, uploadedBytes, blockUpload->contentHash);
+                }
+                break;
+
+            case BLOB_PARALLEL_UPLOAD_READ:
+                /*Codes_SRS_BLOB_09_003: [ When uploading in parallel, no more than `parallelUploads` blocks obtained from `getDataCallbackEx` shall be held in memory at any time, and a block shall be released as soon as it is uploaded. ]*/
+                if ((result = read_block(blockSource, parallelUpload->nextBlockToQueue, &blockUpload->requestContent, &blockUpload->size)) != BLOB_OK)
+                {
+                    /*do nothing, it will be reported "as is"*/
+                }
+                else if (blockUpload->requestContent == NULL)
+                {
+                    isDataEnded = 1;
+                }
+                else
+                {
+                    blockUpload->blockID = parallelUpload->nextBlockToQueue;
+                    blockUpload->contentHash = blockSource->contentHash;
+                    blockUpload->isUploaded = 0;
+
+                    if (Lock(parallelUpload->lock) != LOCK_OK)
+                    {
+                        LogError("unable to Lock");
+                        BUFFER_delete(blockUpload->requestContent);
+                        blockUpload->requestContent = NULL;
+                        result = BLOB_ERROR;
+                    }
+                    else
+                    {
+                        parallelUpload->nextBlockToQueue++;
+                        parallelUpload->blocksInMemory++;
+                        (void)Unlock(parallelUpload->lock);
+                    }
+                }
+                break;
+
+            case BLOB_PARALLEL_UPLOAD_UPLOAD:
+                /*Codes_SRS_BLOB_09_001: [ If `parallelUploads` is greater than 1, `Blob_UploadMultipleBlocksFromSasUri` shall keep up to `parallelUploads` Put Block requests in flight at once, uploading a block on the calling thread when all the upload threads are busy. ]*/
+                upload_queued_block(&parallelUpload->uploaders[0], blockUpload);
+                break;
+
+            case BLOB_PARALLEL_UPLOAD_WAIT:
+                ThreadAPI_Sleep(BLOB_UPLOAD_IDLE_SLEEP_MS);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return result;
+}
+
+static BLOB_RESULT Blob_UploadBlocksInParallel(
+        const char* hostname,
+        HTTPAPIEX_HANDLE httpApiExHandle,
+        const char* certificates,
+        HTTP_PROXY_OPTIONS *proxyOptions,
+        const char* relativePath,
+        BLOB_BLOCK_SOURCE* blockSource,
+        size_t parallelUploads,
+        STRING_HANDLE blockIDList,
+        unsigned int* httpStatus,
+        BUFFER_HANDLE httpResponse,
+        BLOB_UPLOAD_CHECKPOINT* checkpoint,
+        unsigned int* isError)
+{
+    BLOB_RESULT result;
+    /*the state is on the heap because it is leaked, not freed, if an upload thread cannot be joined*/
+    BLOB_PARALLEL_UPLOAD* parallelUpload = (BLOB_PARALLEL_UPLOAD*)malloc(sizeof(BLOB_PARALLEL_UPLOAD));
+
+    if (parallelUpload == NULL)
+    {
+        LogError("unable to allocate the parallel upload");
+        result = BLOB_ERROR;
+    }
+    else
+    {
+        size_t i;
+        unsigned int isHttpApiInitialized = 0;
+        int isLeaked = 0;
+
+        (void)memset(parallelUpload, 0, sizeof(BLOB_PARALLEL_UPLOAD));
+        parallelUpload->relativePath = relativePath;
+        parallelUpload->parallelUploads = parallelUploads;
+        parallelUpload->windowSize = parallelUploads * BLOB_BLOCK_COMMIT_WINDOW_FACTOR;
+        parallelUpload->nextBlockToCommit = (checkpoint == NULL) ? 0 : checkpoint->blockCount;
+        parallelUpload->nextBlockToUpload = parallelUpload->nextBlockToCommit;
+        parallelUpload->nextBlockToQueue = parallelUpload->nextBlockToCommit;
+
+        if ((parallelUpload->blocks = (BLOB_BLOCK_UPLOAD*)malloc(sizeof(BLOB_BLOCK_UPLOAD) * parallelUpload->windowSize)) == NULL)
+        {
+            LogError("unable to allocate %lu block uploads", (unsigned long)parallelUpload->windowSize);
+            result = BLOB_ERROR;
+        }
+        else if ((parallelUpload->uploaders = (BLOB_UPLOADER*)malloc(sizeof(BLOB_UPLOADER) * parallelUploads)) == NULL)
+        {
+            LogError("unable to allocate %lu uploaders", (unsigned long)parallelUploads);
+            result = BLOB_ERROR;
+        }
+        /*Codes_SRS_BLOB_09_016: [ Before any upload thread is created, `Blob_UploadMultipleBlocksFromSasUri` shall call `HTTPAPI_Init` on the calling thread, so the upload threads do not run the HTTP stack global initialization concurrently, and shall call `HTTPAPI_Deinit` once the upload is done. ]*/
+        else if (HTTPAPI_Init() != HTTPAPI_OK)
+        {
+            LogError("unable to HTTPAPI_Init");
+            result = BLOB_ERROR;
+        }
+        else
+        {
+            isHttpApiInitialized = 1;
+
+            if ((parallelUpload->lock = Lock_Init()) == NULL)
+            {
+                LogError("unable to Lock_Init");
+                result = BLOB_ERROR;
+            }
+            else
+            {
+                result = BLOB_OK;
+            }
+        }
+
+        if (parallelUpload->blocks != NULL)
+        {
+            (void)memset(parallelUpload->blocks, 0, sizeof(BLOB_BLOCK_UPLOAD) * parallelUpload->windowSize);
+        }
+
+        if (parallelUpload->uploaders != NULL)
+        {
+            (void)memset(parallelUpload->uploaders, 0, sizeof(BLOB_UPLOADER) * parallelUploads);
+        }
+
+        /*Codes_SRS_BLOB_09_002: [ The calling thread and each of the `parallelUploads` - 1 upload threads shall use their own HTTPAPIEX_HANDLE, configured like the first one, for all the blocks they upload. ]*/
+        for (i = 0; i < parallelUploads && result == BLOB_OK; i++)
+        {
+            parallelUpload->uploaders[i].parallelUpload = parallelUpload;
+
+            if ((parallelUpload->uploaders[i].httpApiExHandle = (i == 0 ? httpApiExHandle : HTTPAPIEX_Create(hostname))) == NULL)
+            {
+                LogError("unable to create a HTTPAPIEX_HANDLE");
+                result = BLOB_ERROR;
+            }
+            else if (i > 0 && set_http_api_ex_options(parallelUpload->uploaders[i].httpApiExHandle, certificates, proxyOptions) != 0)
+            {
+                LogError("unable to set the options of a HTTPAPIEX_HANDLE");
+                result = BLOB_ERROR;
+            }
+            else if ((parallelUpload->uploaders[i].httpResponse = BUFFER_new()) == NULL)
+            {
+                LogError("unable to BUFFER_new");
+                result = BLOB_ERROR;
+            }
+        }
+
+        if (result == BLOB_OK)
+        {
+            for (i = 1; i < parallelUploads; i++)
+            {
+                if (ThreadAPI_Create(&parallelUpload->uploaders[i].threadHandle, upload_thread, &parallelUpload->uploaders[i]) != THREADAPI_OK)
+                {
+                    /*Codes_SRS_BLOB_09_007: [ If an upload thread cannot be created, its blocks shall be uploaded by the other upload threads and the calling thread. ]*/
+                    LogError("unable to ThreadAPI_Create, %lu upload threads are running", (unsigned long)(i - 1));
+                    parallelUpload->uploaders[i].threadHandle = NULL;
+                }
+            }
+
+            result = run_parallel_upload(parallelUpload, blockSource, blockIDList, httpStatus, checkpoint);
+
+            if (Lock(parallelUpload->lock) != LOCK_OK)
+            {
+                LogError("unable to Lock, stopping the upload threads anyway");
+                parallelUpload->isStopping = 1;
+            }
+            else
+            {
+                parallelUpload->isStopping = 1;
+                (void)Unlock(parallelUpload->lock);
+            }
+
+            for (i = 1; i < parallelUploads; i++)
+            {
+                if (parallelUpload->uploaders[i].threadHandle != NULL)
+                {
+                    int notUsed;
+                    if (ThreadAPI_Join(parallelUpload->uploaders[i].threadHandle, &notUsed) != THREADAPI_OK)
+                    {
+                        /*Codes_SRS_BLOB_09_017: [ If an upload thread cannot be joined, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_ERROR`, and shall not release anything the thread may still use. ]*/
+                        LogError("unable to ThreadAPI_Join");
+                        isLeaked = 1;
+                        result = BLOB_ERROR;
+                    }
+                }
+            }
+
+            if (isLeaked)
+            {
+                /*do nothing, it will be reported "as is"*/
+            }
+            else if (result == BLOB_OK && parallelUpload->isFailed)
+            {
+                result = parallelUpload->failedResult;
+
+                if (result == BLOB_OK)
+                {
+                    /*Codes_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
+                    const unsigned char* responseContent = BUFFER_u_char(parallelUpload->failedUploader->httpResponse);
+                    size_t responseLength = BUFFER_length(parallelUpload->failedUploader->httpResponse);
+
+                    *httpStatus = parallelUpload->failedHttpStatus;
+                    *isError = 1;
+
+                    if (BUFFER_build(httpResponse, responseContent, responseLength) != 0)
+                    {
+                        LogError("unable to BUFFER_build");
+                        result = BLOB_ERROR;
+                    }
+                }
+            }
+        }
+
+        if (isLeaked)
+        {
+            LogError("an upload thread is still running, its upload state is not released");
+        }
+        else
+        {
+            if (parallelUpload->blocks != NULL)
+            {
+                for (i = 0; i < parallelUpload->windowSize; i++)
+                {
+                    if (parallelUpload->blocks[i].requestContent != NULL)
+                    {
+                        BUFFER_delete(parallelUpload->blocks[i].requestContent);
+                    }
+                }
+                free(parallelUpload->blocks);
+            }
+
+            if (parallelUpload->uploaders != NULL)
+            {
+                for (i = 0; i < parallelUploads; i++)
+                {
+                    if (i > 0 && parallelUpload->uploaders[i].httpApiExHandle != NULL)
+                    {
+                        HTTPAPIEX_Destroy(parallelUpload->uploaders[i].httpApiExHandle);
+                    }
+                    if (parallelUpload->uploaders[i].httpResponse != NULL)
+                    {
+                        BUFFER_delete(parallelUpload->uploaders[i].httpResponse);
+                    }
+                }
+                free(parallelUpload->uploaders);
+            }
+
+            if (parallelUpload->lock != NULL)
+            {
+                Lock_Deinit(parallelUpload->lock);
+            }
+
+            if (isHttpApiInitialized)
+            {
+                HTTPAPI_Deinit();
+            }
+
+            free(parallelUpload);
+        }
+    }
+
+    return result;
+}
+
+static BLOB_RESULT upload_multiple_blocks(const char* SASURI, BLOB_BLOCK_SOURCE* blockSource, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS *proxyOptions, size_t parallelUploads, BLOB_UPLOAD_CHECKPOINT* checkpoint)
+{
+    BLOB_RESULT result;
+    /*Codes_SRS_BLOB_02_017: [ Blob_UploadMultipleBlocksFromSasUri shall copy from SASURI the hostname to a new const char* ]*/
+    /*to find the hostname, the following logic is applied:*/
+    /*the hostname starts at the first character after "://"*/
+    /*the hostname ends at the first character before the next "/" after "://"*/
+    const char* hostnameBegin = strstr(SASURI, "://");
+    if (hostnameBegin == NULL)
     {
-        LogError("invalid argument detected requestContent=%p blockIDList=%p relativePath=%p httpApiExHandle=%p httpStatus=%p httpResponse=%p", requestContent, blockIDList, relativePath, httpApiExHandle, httpStatus, httpResponse);
-        result = BLOB_ERROR;
+        /*Codes_SRS_BLOB_02_005: [ If the hostname cannot be determined, then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
+        LogError("hostname cannot be determined");
+        result = BLOB_INVALID_ARG;
     }
     else
     {
-        char temp[7]; /*this will contain 000000... 049999*/
-        if (sprintf(temp, "%6u", (unsigned int)blockID) != 6) /*produces 000000... 049999*/
+        hostnameBegin += 3; /*have to skip 3 characters which are "://"*/
+        const char* hostnameEnd = strchr(hostnameBegin, '/');
+        if (hostnameEnd == NULL)
         {
-            /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-            LogError("failed to sprintf");
-            result = BLOB_ERROR;
+            /*Codes_SRS_BLOB_02_005: [ If the hostname cannot be determined, then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
+            LogError("hostname cannot be determined");
+            result = BLOB_INVALID_ARG;
         }
         else
         {
-            STRING_HANDLE blockIdString = Base64_Encode_Bytes((const unsigned char*)temp, 6);
-            if (blockIdString == NULL)
+            size_t hostnameSize = hostnameEnd - hostnameBegin;
+            char* hostname = (char*)malloc(hostnameSize + 1); /*+1 because of '\0' at the end*/
+            if (hostname == NULL)
             {
-                /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                LogError("unable to Base64_Encode_Bytes");
+                /*Codes_SRS_BLOB_02_016: [ If the hostname copy cannot be made then then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+                LogError("oom - out of memory");
                 result = BLOB_ERROR;
             }
             else
             {
-                /*add the blockId base64 encoded to the XML*/
-                if (!(
-                    (STRING_concat(blockIDList, "<Latest>") == 0) &&
-                    (STRING_concat_with_STRING(blockIDList, blockIdString) == 0) &&
-                    (STRING_concat(blockIDList, "</Latest>") == 0)
-                    ))
+                HTTPAPIEX_HANDLE httpApiExHandle;
+                (void)memcpy(hostname, hostnameBegin, hostnameSize);
+                hostname[hostnameSize] = '\0';
+
+                /*Codes_SRS_BLOB_02_018: [ Blob_UploadMultipleBlocksFromSasUri shall create a new HTTPAPI_EX_HANDLE by calling HTTPAPIEX_Create passing the hostname. ]*/
+                httpApiExHandle = HTTPAPIEX_Create(hostname);
+                if (httpApiExHandle == NULL)
                 {
-                    /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                    LogError("unable to STRING_concat");
+                    /*Codes_SRS_BLOB_02_007: [ If HTTPAPIEX_Create fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR. ]*/
+                    LogError("unable to create a HTTPAPIEX_HANDLE");
                     result = BLOB_ERROR;
                 }
                 else
                 {
-                    /*Codes_SRS_BLOB_02_022: [ Blob_UploadMultipleBlocksFromSasUri shall construct a new relativePath from following string: base relativePath + "&comp=block&blockid=BASE64 encoded string of blockId" ]*/
-                    STRING_HANDLE newRelativePath = STRING_construct(relativePath);
-                    if (newRelativePath == NULL)
+                    if (set_http_api_ex_options(httpApiExHandle, certificates, proxyOptions) != 0)
                     {
-                        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                        LogError("unable to STRING_construct");
+                        /*Codes_SRS_BLOB_02_038: [ If `HTTPAPIEX_SetOption` fails then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_ERROR`. ]*/
                         result = BLOB_ERROR;
                     }
                     else
                     {
-                        if (!(
-                            (STRING_concat(newRelativePath, "&comp=block&blockid=") == 0) &&
-                            (STRING_concat_with_STRING(newRelativePath, blockIdString) == 0)
-                            ))
+                        /*Codes_SRS_BLOB_02_019: [ Blob_UploadMultipleBlocksFromSasUri shall compute the base relative path of the request from the SASURI parameter. ]*/
+                        const char* relativePath = hostnameEnd; /*this is where the relative path begins in the SasUri*/
+
+                        /*Codes_SRS_BLOB_02_028: [ Blob_UploadMultipleBlocksFromSasUri shall construct an XML string with the following content: ]*/
+                        STRING_HANDLE blockIDList = STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"); /*the XML "build as we go"*/
+                        if (blockIDList == NULL)
                         {
                             /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                            LogError("unable to STRING concatenate");
-                            result = BLOB_ERROR;
+                            LogError("failed to STRING_construct");
+                            result = BLOB_HTTP_ERROR;
                         }
                         else
                         {
-                            /*Codes_SRS_BLOB_02_024: [ Blob_UploadMultipleBlocksFromSasUri shall call HTTPAPIEX_ExecuteRequest with a PUT operation, passing httpStatus and httpResponse. ]*/
-                            if (HTTPAPIEX_ExecuteRequest(
-                                httpApiExHandle,
-                                HTTPAPI_REQUEST_PUT,
-                                STRING_c_str(newRelativePath),
-                                NULL,
-                                requestContent,
-                                httpStatus,
-                                NULL,
-                                httpResponse) != HTTPAPIEX_OK
-                                )
+                            /*Codes_SRS_BLOB_02_021: [ For every block returned by `getDataCallbackEx` the following operations shall happen: ]*/
+                            unsigned int blockID = (checkpoint == NULL) ? 0 : checkpoint->blockCount; /* incremented for each new block */
+                            size_t uploadedBytes = (checkpoint == NULL) ? 0 : checkpoint->uploadedBytes;
+                            unsigned int isError = 0; /* set to 1 if a block upload fails or if getDataCallbackEx returns incorrect blocks to upload */
+                            unsigned int uploadOneMoreBlock = 1; /* set to 1 while getDataCallbackEx returns correct blocks to upload */
+
+                            if ((checkpoint != NULL) && (checkpoint->blockCount > 0) &&
+                                ((result = skip_uploaded_blocks(blockSource, checkpoint, blockIDList)) != BLOB_OK))
+                            {
+                                /*do nothing, it will be reported "as is"*/
+                            }
+                            else if (parallelUploads > 1)
+                            {
+                                /*Codes_SRS_BLOB_09_001: [ If `parallelUploads` is greater than 1, `Blob_UploadMultipleBlocksFromSasUri` shall keep up to `parallelUploads` Put Block requests in flight at once. ]*/
+                                result = Blob_UploadBlocksInParallel(hostname, httpApiExHandle, certificates, proxyOptions, relativePath, blockSource, parallelUploads, blockIDList, httpStatus, httpResponse, checkpoint, &isError);
+                            }
+                            else
                             {
-                                /*Codes_SRS_BLOB_02_025: [ If HTTPAPIEX_ExecuteRequest fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_HTTP_ERROR. ]*/
-                                LogError("unable to HTTPAPIEX_ExecuteRequest");
-                                result = BLOB_HTTP_ERROR;
+                                do
+                                {
+                                    BUFFER_HANDLE requestContent;
+                                    size_t size;
+
+                                    if ((result = read_block(blockSource, blockID, &requestContent, &size)) != BLOB_OK)
+                                    {
+                                        /*do nothing, it will be reported "as is"*/
+                                        isError = 1;
+                                    }
+                                    else if (requestContent == NULL)
+                                    {
+                                        uploadOneMoreBlock = 0;
+                                    }
+                                    else
+                                    {
+                                        result = Blob_UploadBlock(
+                                                httpApiExHandle,
+                                                relativePath,
+                                                requestContent,
+                                                blockID,
+                                                blockIDList,
+                                                httpStatus,
+                                                httpResponse);
+
+                                        BUFFER_delete(requestContent);
+
+                                        /*Codes_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
+                                        if (result != BLOB_OK || *httpStatus >= 300)
+                                        {
+                                            LogError("unable to Blob_UploadBlock. Returned value=%d, httpStatus=%u", result, *httpStatus);
+                                            isError = 1;
+                                        }
+                                        else
+                                        {
+                                            uploadedBytes += size;
+                                            notify_block_uploaded(checkpoint, blockID + 1, uploadedBytes, blockSource->contentHash);
+                                        }
+                                        blockID++;
+                                    }
+                                }
+                                while(uploadOneMoreBlock && !isError);
                             }
-                            else if (*httpStatus >= 300)
+
+                            if (isError || result != BLOB_OK)
                             {
-                                /*Codes_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
-                                LogError("HTTP status from storage does not indicate success (%d)", (int)*httpStatus);
-                                result = BLOB_OK;
+                                /*do nothing, it will be reported "as is"*/
                             }
                             else
                             {
-                                /*Codes_SRS_BLOB_02_027: [ Otherwise Blob_UploadMultipleBlocksFromSasUri shall continue execution. ]*/
-                                result = BLOB_OK;
+                                /*complete the XML*/
+                                if (STRING_concat(blockIDList, "</BlockList>") != 0)
+                                {
+                                    /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+                                    LogError("failed to STRING_concat");
+                                    result = BLOB_ERROR;
+                                }
+                                else
+                                {
+                                    /*Codes_SRS_BLOB_02_029: [Blob_UploadMultipleBlocksFromSasUri shall construct a new relativePath from following string : base relativePath + "&comp=blocklist"]*/
+                                    STRING_HANDLE newRelativePath = STRING_construct(relativePath);
+                                    if (newRelativePath == NULL)
+                                    {
+                                        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+                                        LogError("failed to STRING_construct");
+                                        result = BLOB_ERROR;
+                                    }
+                                    else
+                                    {
+                                        if (STRING_concat(newRelativePath, "&comp=blocklist") != 0)
+                                        {
+                                            /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+                                            LogError("failed to STRING_concat");
+                                            result = BLOB_ERROR;
+                                        }
+                                        else
+                                        {
+                                            /*Codes_SRS_BLOB_02_030: [ Blob_UploadMultipleBlocksFromSasUri shall call HTTPAPIEX_ExecuteRequest with a PUT operation, passing the new relativePath, httpStatus and httpResponse and the XML string as content. ]*/
+                                            const char* s = STRING_c_str(blockIDList);
+                                            BUFFER_HANDLE blockIDListAsBuffer = BUFFER_create((const unsigned char*)s, strlen(s));
+                                            if (blockIDListAsBuffer == NULL)
+                                            {
+                                                /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
+                                                LogError("failed to BUFFER_create");
+                                                result = BLOB_ERROR;
+                                            }
+                                            else
+                                            {
+                                                if (HTTPAPIEX_ExecuteRequest(
+                                                    httpApiExHandle,
+                                                    HTTPAPI_REQUEST_PUT,
+                                                    STRING_c_str(newRelativePath),
+                                                    NULL,
+                                                    blockIDListAsBuffer,
+                                                    httpStatus,
+                                                    NULL,
+                                                    httpResponse
+                                                ) != HTTPAPIEX_OK)
+                                                {
+                                                    /*Codes_SRS_BLOB_02_031: [ If HTTPAPIEX_ExecuteRequest fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_HTTP_ERROR. ]*/
+                                                    LogError("unable to HTTPAPIEX_ExecuteRequest");
+                                                    result = BLOB_HTTP_ERROR;
+                                                }
+                                                else
+                                                {
+                                                    /*Codes_SRS_BLOB_02_032: [ Otherwise, Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
+                                                    result = BLOB_OK;
+                                                }
+                                                BUFFER_delete(blockIDListAsBuffer);
+                                            }
+                                        }
+                                        STRING_delete(newRelativePath);
+                                    }
+                                }
                             }
+                            STRING_delete(blockIDList);
                         }
-                        STRING_delete(newRelativePath);
+
                     }
+                    HTTPAPIEX_Destroy(httpApiExHandle);
                 }
-                STRING_delete(blockIdString);
+                free(hostname);
             }
         }
     }
     return result;
 }
 
-BLOB_RESULT Blob_UploadMultipleBlocksFromSasUri(const char* SASURI, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, void* context, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS *proxyOptions)
+BLOB_RESULT Blob_UploadMultipleBlocksFromSasUri(const char* SASURI, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, void* context, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS *proxyOptions, size_t parallelUploads, BLOB_UPLOAD_CHECKPOINT* checkpoint)
 {
     BLOB_RESULT result;
     /*Codes_SRS_BLOB_02_001: [ If SASURI is NULL then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
@@ -133,248 +1142,302 @@ BLOB_RESULT Blob_UploadMultipleBlocksFromSasUri(const char* SASURI, IOTHUB_CLIEN
         LogError("parameter SASURI is NULL");
         result = BLOB_INVALID_ARG;
     }
+    /*Codes_SRS_BLOB_02_002: [ If getDataCallbackEx is NULL then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
+    else if (getDataCallbackEx == NULL)
+    {
+        LogError("IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx is NULL");
+        result = BLOB_INVALID_ARG;
+    }
+    else
+    {
+        BLOB_BLOCK_SOURCE blockSource;
+        blockSource.getDataCallbackEx = getDataCallbackEx;
+        blockSource.readBlockCallback = NULL;
+        blockSource.context = context;
+        blockSource.offset = 0;
+        blockSource.contentHash = BLOB_CONTENT_HASH_OFFSET_BASIS;
+
+        result = upload_multiple_blocks(SASURI, &blockSource, httpStatus, httpResponse, certificates, proxyOptions, parallelUploads, checkpoint);
+    }
+    return result;
+}
+
+BLOB_RESULT Blob_UploadMultipleBlocksFromReader(const char* SASURI, BLOB_READ_BLOCK_CALLBACK readBlockCallback, void* context, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS *proxyOptions, size_t parallelUploads, BLOB_UPLOAD_CHECKPOINT* checkpoint)
+{
+    BLOB_RESULT result;
+    /*Codes_SRS_BLOB_09_030: [ If `SASURI` or `readBlockCallback` is NULL then `Blob_UploadMultipleBlocksFromReader` shall fail and return `BLOB_INVALID_ARG`. ]*/
+    if (
+        (SASURI == NULL) ||
+        (readBlockCallback == NULL)
+        )
+    {
+        LogError("invalid argument detected SASURI=%p readBlockCallback=%p", SASURI, readBlockCallback);
+        result = BLOB_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_BLOB_09_031: [ Otherwise `Blob_UploadMultipleBlocksFromReader` shall upload the blocks like `Blob_UploadMultipleBlocksFromSasUri`, reading them with `readBlockCallback` instead of copying them from `getDataCallbackEx`. ]*/
+        BLOB_BLOCK_SOURCE blockSource;
+        blockSource.getDataCallbackEx = NULL;
+        blockSource.readBlockCallback = readBlockCallback;
+        blockSource.context = context;
+        blockSource.offset = 0;
+        blockSource.contentHash = BLOB_CONTENT_HASH_OFFSET_BASIS;
+
+        result = upload_multiple_blocks(SASURI, &blockSource, httpStatus, httpResponse, certificates, proxyOptions, parallelUploads, checkpoint);
+    }
+    return result;
+}
+
+/*returns the value of a base64 digit, or -1 when c is not one*/
+static int base64_digit_value(char c)
+{
+    int result;
+
+    if (c >= 'A' && c <= 'Z')
+    {
+        result = c - 'A';
+    }
+    else if (c >= 'a' && c <= 'z')
+    {
+        result = c - 'a' + 26;
+    }
+    else if (c >= '0' && c <= '9')
+    {
+        result = c - '0' + 52;
+    }
+    else if (c == '+')
+    {
+        result = 62;
+    }
+    else if (c == '/')
+    {
+        result = 63;
+    }
+    else
+    {
+        result = -1;
+    }
+
+    return result;
+}
+
+/*reverses create_block_id_string: the 8 characters of name are the base64 encoding of the 6 characters "%6u" of the block ID*/
+static int parse_block_id(const char* name, size_t nameLength, unsigned int* blockID)
+{
+    int result = 0;
+    char decoded[6];
+    size_t i;
+
+    if (nameLength != 8)
+    {
+        result = __FAILURE__;
+    }
+
+    for (i = 0; i < 2 && result == 0; i++)
+    {
+        int digit0 = base64_digit_value(name[i * 4]);
+        int digit1 = base64_digit_value(name[i * 4 + 1]);
+        int digit2 = base64_digit_value(name[i * 4 + 2]);
+        int digit3 = base64_digit_value(name[i * 4 + 3]);
+
+        if (digit0 < 0 || digit1 < 0 || digit2 < 0 || digit3 < 0)
+        {
+            result = __FAILURE__;
+        }
+        else
+        {
+            unsigned long bits = ((unsigned long)digit0 << 18) | ((unsigned long)digit1 << 12) | ((unsigned long)digit2 << 6) | (unsigned long)digit3;
+            decoded[i * 3] = (char)((bits >> 16) & 0xFF);
+            decoded[i * 3 + 1] = (char)((bits >> 8) & 0xFF);
+            decoded[i * 3 + 2] = (char)(bits & 0xFF);
+        }
+    }
+
+    if (result == 0)
+    {
+        i = 0;
+        while (i < 5 && decoded[i] == ' ')
+        {
+            i++;
+        }
+
+        *blockID = 0;
+        for (; i < 6 && result == 0; i++)
+        {
+            if (decoded[i] < '0' || decoded[i] > '9')
+            {
+                result = __FAILURE__;
+            }
+            else
+            {
+                *blockID = *blockID * 10 + (unsigned int)(decoded[i] - '0');
+            }
+        }
+    }
+
+    return result;
+}
+
+/*returns the number of different blocks among 0 to blockCount - 1 that have an element <Name>block ID</Name> in blockList, reading blockList once*/
+static unsigned int count_listed_blocks(const char* blockList, unsigned char* isListed, unsigned int blockCount)
+{
+    unsigned int result = 0;
+    const char* name = blockList;
+    const char* nameEnd;
+
+    while ((name = strstr(name, "<Name>")) != NULL &&
+        (nameEnd = strstr(name + 6, "</Name>")) != NULL)
+    {
+        unsigned int blockID;
+        name += 6;
+
+        if ((parse_block_id(name, nameEnd - name, &blockID) == 0) &&
+            (blockID < blockCount) &&
+            (!isListed[blockID]))
+        {
+            isListed[blockID] = 1;
+            result++;
+        }
+
+        name = nameEnd + 7;
+    }
+
+    return result;
+}
+
+BLOB_RESULT Blob_VerifyUncommittedBlocks(const char* SASURI, unsigned int blockCount, const char* certificates, HTTP_PROXY_OPTIONS* proxyOptions)
+{
+    BLOB_RESULT result;
+    const char* hostnameBegin;
+    const char* hostnameEnd;
+
+    /*Codes_SRS_BLOB_09_011: [ If `SASURI` is NULL, or the hostname cannot be determined from it, `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_INVALID_ARG`. ]*/
+    if (SASURI == NULL)
+    {
+        LogError("parameter SASURI is NULL");
+        result = BLOB_INVALID_ARG;
+    }
+    else if ((hostnameBegin = strstr(SASURI, "://")) == NULL ||
+        (hostnameEnd = strchr(hostnameBegin + 3, '/')) == NULL)
+    {
+        LogError("hostname cannot be determined");
+        result = BLOB_INVALID_ARG;
+    }
     else
     {
-        /*Codes_SRS_BLOB_02_002: [ If getDataCallbackEx is NULL then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
-        if (getDataCallbackEx == NULL)
+        size_t hostnameSize = hostnameEnd - (hostnameBegin + 3);
+        char* hostname = (char*)malloc(hostnameSize + 1);
+        if (hostname == NULL)
         {
-            LogError("IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx is NULL");
-            result = BLOB_INVALID_ARG;
+            LogError("oom - out of memory");
+            result = BLOB_ERROR;
         }
-        /*the below define avoid a "condition always false" on some compilers*/
         else
         {
-            /*Codes_SRS_BLOB_02_017: [ Blob_UploadMultipleBlocksFromSasUri shall copy from SASURI the hostname to a new const char* ]*/
-            /*to find the hostname, the following logic is applied:*/
-            /*the hostname starts at the first character after "://"*/
-            /*the hostname ends at the first character before the next "/" after "://"*/
-            const char* hostnameBegin = strstr(SASURI, "://");
-            if (hostnameBegin == NULL)
+            HTTPAPIEX_HANDLE httpApiExHandle;
+            (void)memcpy(hostname, hostnameBegin + 3, hostnameSize);
+            hostname[hostnameSize] = '\0';
+
+            if ((httpApiExHandle = HTTPAPIEX_Create(hostname)) == NULL)
             {
-                /*Codes_SRS_BLOB_02_005: [ If the hostname cannot be determined, then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
-                LogError("hostname cannot be determined");
-                result = BLOB_INVALID_ARG;
+                LogError("unable to create a HTTPAPIEX_HANDLE");
+                result = BLOB_ERROR;
             }
             else
             {
-                hostnameBegin += 3; /*have to skip 3 characters which are "://"*/
-                const char* hostnameEnd = strchr(hostnameBegin, '/');
-                if (hostnameEnd == NULL)
+                STRING_HANDLE relativePath;
+
+                if (set_http_api_ex_options(httpApiExHandle, certificates, proxyOptions) != 0)
+                {
+                    result = BLOB_ERROR;
+                }
+                /*Codes_SRS_BLOB_09_012: [ `Blob_VerifyUncommittedBlocks` shall get the uncommitted block list of the blob with a GET request to the relative path of `SASURI` + "&comp=blocklist&blocklisttype=uncommitted". ]*/
+                else if ((relativePath = STRING_construct(hostnameEnd)) == NULL)
                 {
-                    /*Codes_SRS_BLOB_02_005: [ If the hostname cannot be determined, then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_INVALID_ARG. ]*/
-                    LogError("hostname cannot be determined");
-                    result = BLOB_INVALID_ARG;
+                    LogError("unable to STRING_construct");
+                    result = BLOB_ERROR;
                 }
                 else
                 {
-                    size_t hostnameSize = hostnameEnd - hostnameBegin;
-                    char* hostname = (char*)malloc(hostnameSize + 1); /*+1 because of '\0' at the end*/
-                    if (hostname == NULL)
+                    BUFFER_HANDLE responseContent;
+
+                    if (STRING_concat(relativePath, "&comp=blocklist&blocklisttype=uncommitted") != 0)
+                    {
+                        LogError("unable to STRING_concat");
+                        result = BLOB_ERROR;
+                    }
+                    else if ((responseContent = BUFFER_new()) == NULL)
                     {
-                        /*Codes_SRS_BLOB_02_016: [ If the hostname copy cannot be made then then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                        LogError("oom - out of memory");
+                        LogError("unable to BUFFER_new");
                         result = BLOB_ERROR;
                     }
                     else
                     {
-                        HTTPAPIEX_HANDLE httpApiExHandle;
-                        (void)memcpy(hostname, hostnameBegin, hostnameSize);
-                        hostname[hostnameSize] = '\0';
+                        unsigned int httpStatus;
 
-                        /*Codes_SRS_BLOB_02_018: [ Blob_UploadMultipleBlocksFromSasUri shall create a new HTTPAPI_EX_HANDLE by calling HTTPAPIEX_Create passing the hostname. ]*/
-                        httpApiExHandle = HTTPAPIEX_Create(hostname);
-                        if (httpApiExHandle == NULL)
+                        if (HTTPAPIEX_ExecuteRequest(httpApiExHandle, HTTPAPI_REQUEST_GET, STRING_c_str(relativePath), NULL, NULL, &httpStatus, NULL, responseContent) != HTTPAPIEX_OK)
+                        {
+                            /*Codes_SRS_BLOB_09_013: [ If the request fails, `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_HTTP_ERROR`. ]*/
+                            LogError("unable to HTTPAPIEX_ExecuteRequest");
+                            result = BLOB_HTTP_ERROR;
+                        }
+                        else if (httpStatus >= 300)
                         {
-                            /*Codes_SRS_BLOB_02_007: [ If HTTPAPIEX_Create fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR. ]*/
-                            LogError("unable to create a HTTPAPIEX_HANDLE");
+                            /*Codes_SRS_BLOB_09_014: [ If the HTTP status is >= 300 (for example the SAS has expired), `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_ERROR`. ]*/
+                            LogError("HTTP status from storage does not indicate success (%u)", httpStatus);
                             result = BLOB_ERROR;
                         }
                         else
                         {
-                            if ((certificates != NULL)&& (HTTPAPIEX_SetOption(httpApiExHandle, "TrustedCerts", certificates) == HTTPAPIEX_ERROR))
-                            {
-                                LogError("failure in setting trusted certificates");
-                                result = BLOB_ERROR;
-                            }
-                            else if ((proxyOptions != NULL && proxyOptions->host_address != NULL) && HTTPAPIEX_SetOption(httpApiExHandle, OPTION_HTTP_PROXY, proxyOptions) == HTTPAPIEX_ERROR)
+                            const unsigned char* responseContent_u_char = BUFFER_u_char(responseContent);
+                            size_t responseContent_length = BUFFER_length(responseContent);
+                            STRING_HANDLE blockList = STRING_from_byte_array(responseContent_u_char, responseContent_length);
+
+                            if (blockList == NULL)
                             {
-                                LogError("failure in setting proxy options");
+                                LogError("unable to STRING_from_byte_array");
                                 result = BLOB_ERROR;
                             }
                             else
                             {
-                                /*Codes_SRS_BLOB_02_019: [ Blob_UploadMultipleBlocksFromSasUri shall compute the base relative path of the request from the SASURI parameter. ]*/
-                                const char* relativePath = hostnameEnd; /*this is where the relative path begins in the SasUri*/
-
-                                /*Codes_SRS_BLOB_02_028: [ Blob_UploadMultipleBlocksFromSasUri shall construct an XML string with the following content: ]*/
-                                STRING_HANDLE blockIDList = STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"); /*the XML "build as we go"*/
-                                if (blockIDList == NULL)
+                                unsigned char* isListed = (unsigned char*)malloc(blockCount + 1);
+                                if (isListed == NULL)
                                 {
-                                    /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                    LogError("failed to STRING_construct");
-                                    result = BLOB_HTTP_ERROR;
+                                    LogError("oom - out of memory");
+                                    result = BLOB_ERROR;
                                 }
                                 else
                                 {
-                                    /*Codes_SRS_BLOB_02_021: [ For every block returned by `getDataCallbackEx` the following operations shall happen: ]*/
-                                    unsigned int blockID = 0; /* incremented for each new block */
-                                    unsigned int isError = 0; /* set to 1 if a block upload fails or if getDataCallbackEx returns incorrect blocks to upload */
-                                    unsigned int uploadOneMoreBlock = 1; /* set to 1 while getDataCallbackEx returns correct blocks to upload */
-                                    unsigned char const * source; /* data set by getDataCallbackEx */
-                                    size_t size; /* source size set by getDataCallbackEx */
-                                    IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT getDataReturnValue;
-
-                                    do
-                                    {
-                                        getDataReturnValue = getDataCallbackEx(FILE_UPLOAD_OK, &source, &size, context);
-                                        if (getDataReturnValue == IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_ABORT)
-                                        {
-                                            /*Codes_SRS_BLOB_99_004: [ If `getDataCallbackEx` returns `IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT_ABORT`, then `Blob_UploadMultipleBlocksFromSasUri` shall exit the loop and return `BLOB_ABORTED`. ]*/
-                                            LogInfo("Upload to blob has been aborted by the user");
-                                            uploadOneMoreBlock = 0;
-                                            result = BLOB_ABORTED;
-                                        }
-                                        else if (source == NULL || size == 0)
-                                        {
-                                            /*Codes_SRS_BLOB_99_002: [ If the size of the block returned by `getDataCallbackEx` is 0 or if the data is NULL, then `Blob_UploadMultipleBlocksFromSasUri` shall exit the loop. ]*/
-                                            uploadOneMoreBlock = 0;
-                                            result = BLOB_OK;
-                                        }
-                                        else
-                                        {
-                                            if (size > BLOCK_SIZE)
-                                            {
-                                                /*Codes_SRS_BLOB_99_001: [ If the size of the block returned by `getDataCallbackEx` is bigger than 4MB, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
-                                                LogError("tried to upload block of size %zu, max allowed size is %d", size, BLOCK_SIZE);
-                                                result = BLOB_INVALID_ARG;
-                                                isError = 1;
-                                            }
-                                            else if (blockID >= MAX_BLOCK_COUNT)
-                                            {
-                                                /*Codes_SRS_BLOB_99_003: [ If `getDataCallbackEx` returns more than 50000 blocks, then `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
-                                                LogError("unable to upload more than %zu blocks in one blob", MAX_BLOCK_COUNT);
-                                                result = BLOB_INVALID_ARG;
-                                                isError = 1;
-                                            }
-                                            else
-                                            {
-                                                /*Codes_SRS_BLOB_02_023: [ Blob_UploadMultipleBlocksFromSasUri shall create a BUFFER_HANDLE from source and size parameters. ]*/
-                                                BUFFER_HANDLE requestContent = BUFFER_create(source, size);
-                                                if (requestContent == NULL)
-                                                {
-                                                    /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                                    LogError("unable to BUFFER_create");
-                                                    result = BLOB_ERROR;
-                                                    isError = 1;
-                                                }
-                                                else
-                                                {
-                                                    result = Blob_UploadBlock(
-                                                            httpApiExHandle,
-                                                            relativePath,
-                                                            requestContent,
-                                                            blockID,
-                                                            blockIDList,
-                                                            httpStatus,
-                                                            httpResponse);
-
-                                                    BUFFER_delete(requestContent);
-                                                }
-
-                                                /*Codes_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
-                                                if (result != BLOB_OK || *httpStatus >= 300)
-                                                {
-                                                    LogError("unable to Blob_UploadBlock. Returned value=%d, httpStatus=%u", result, httpStatus);
-                                                    isError = 1;
-                                                }
-                                            }
-                                            blockID++;
-                                        }
-                                    }
-                                    while(uploadOneMoreBlock && !isError);
+                                    unsigned int listedBlockCount;
+                                    (void)memset(isListed, 0, blockCount + 1);
 
-                                    if (isError || result != BLOB_OK)
+                                    /*Codes_SRS_BLOB_09_015: [ `Blob_VerifyUncommittedBlocks` shall succeed and return `BLOB_OK` only if the IDs of blocks 0 to `blockCount` - 1 are all in the uncommitted block list, otherwise it shall return `BLOB_ERROR`. ]*/
+                                    /*Codes_SRS_BLOB_09_032: [ `Blob_VerifyUncommittedBlocks` shall read the block list only once, decoding the ID of every block it contains. ]*/
+                                    if ((listedBlockCount = count_listed_blocks(STRING_c_str(blockList), isListed, blockCount)) != blockCount)
                                     {
-                                        /*do nothing, it will be reported "as is"*/
+                                        LogError("only %u of %u blocks are uncommitted in storage", listedBlockCount, blockCount);
+                                        result = BLOB_ERROR;
                                     }
                                     else
                                     {
-                                        /*complete the XML*/
-                                        if (STRING_concat(blockIDList, "</BlockList>") != 0)
-                                        {
-                                            /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                            LogError("failed to STRING_concat");
-                                            result = BLOB_ERROR;
-                                        }
-                                        else
-                                        {
-                                            /*Codes_SRS_BLOB_02_029: [Blob_UploadMultipleBlocksFromSasUri shall construct a new relativePath from following string : base relativePath + "&comp=blocklist"]*/
-                                            STRING_HANDLE newRelativePath = STRING_construct(relativePath);
-                                            if (newRelativePath == NULL)
-                                            {
-                                                /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                                LogError("failed to STRING_construct");
-                                                result = BLOB_ERROR;
-                                            }
-                                            else
-                                            {
-                                                if (STRING_concat(newRelativePath, "&comp=blocklist") != 0)
-                                                {
-                                                    /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                                    LogError("failed to STRING_concat");
-                                                    result = BLOB_ERROR;
-                                                }
-                                                else
-                                                {
-                                                    /*Codes_SRS_BLOB_02_030: [ Blob_UploadMultipleBlocksFromSasUri shall call HTTPAPIEX_ExecuteRequest with a PUT operation, passing the new relativePath, httpStatus and httpResponse and the XML string as content. ]*/
-                                                    const char* s = STRING_c_str(blockIDList);
-                                                    BUFFER_HANDLE blockIDListAsBuffer = BUFFER_create((const unsigned char*)s, strlen(s));
-                                                    if (blockIDListAsBuffer == NULL)
-                                                    {
-                                                        /*Codes_SRS_BLOB_02_033: [ If any previous operation that doesn't have an explicit failure description fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_ERROR ]*/
-                                                        LogError("failed to BUFFER_create");
-                                                        result = BLOB_ERROR;
-                                                    }
-                                                    else
-                                                    {
-                                                        if (HTTPAPIEX_ExecuteRequest(
-                                                            httpApiExHandle,
-                                                            HTTPAPI_REQUEST_PUT,
-                                                            STRING_c_str(newRelativePath),
-                                                            NULL,
-                                                            blockIDListAsBuffer,
-                                                            httpStatus,
-                                                            NULL,
-                                                            httpResponse
-                                                        ) != HTTPAPIEX_OK)
-                                                        {
-                                                            /*Codes_SRS_BLOB_02_031: [ If HTTPAPIEX_ExecuteRequest fails then Blob_UploadMultipleBlocksFromSasUri shall fail and return BLOB_HTTP_ERROR. ]*/
-                                                            LogError("unable to HTTPAPIEX_ExecuteRequest");
-                                                            result = BLOB_HTTP_ERROR;
-                                                        }
-                                                        else
-                                                        {
-                                                            /*Codes_SRS_BLOB_02_032: [ Otherwise, Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
-                                                            result = BLOB_OK;
-                                                        }
-                                                        BUFFER_delete(blockIDListAsBuffer);
-                                                    }
-                                                }
-                                                STRING_delete(newRelativePath);
-                                            }
-                                        }
+                                        result = BLOB_OK;
                                     }
-                                    STRING_delete(blockIDList);
+                                    free(isListed);
                                 }
 
+                                STRING_delete(blockList);
                             }
-                            HTTPAPIEX_Destroy(httpApiExHandle);
                         }
-                        free(hostname);
+                        BUFFER_delete(responseContent);
                     }
+                    STRING_delete(relativePath);
                 }
+                HTTPAPIEX_Destroy(httpApiExHandle);
             }
+            free(hostname);
         }
     }
+
     return result;
 }
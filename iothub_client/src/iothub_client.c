@@ -54,6 +54,7 @@ typedef struct UPLOADTOBLOB_SAVED_DATA_TAG
 {
     unsigned char* source;
     size_t size;
+    char* sourceFilePath; /*set instead of source when the data is read from a local file*/
     IOTHUB_CLIENT_FILE_UPLOAD_CALLBACK iotHubClientFileUploadCallback;
 }UPLOADTOBLOB_SAVED_DATA;
 
@@ -148,6 +149,7 @@ static void freeUploadToBlobThreadInfo(UPLOADTOBLOB_THREAD_INFO* threadInfo)
 {
     Lock_Deinit(threadInfo->lockGarbage);
     free(threadInfo->uploadBlobSavedData.source);
+    free(threadInfo->uploadBlobSavedData.sourceFilePath);
     free(threadInfo->destinationFileName);
     free(threadInfo);
 }
@@ -2070,6 +2072,94 @@ IOTHUB_CLIENT_RESULT IoTHubClient_UploadToBlobAsync(IOTHUB_CLIENT_HANDLE iotHubC
     return result;
 }
 
+static int uploadingFileThread(void *data)
+{
+    IOTHUB_CLIENT_FILE_UPLOAD_RESULT upload_result;
+    UPLOADTOBLOB_THREAD_INFO* threadInfo = (UPLOADTOBLOB_THREAD_INFO*)data;
+
+    /*Codes_SRS_IOTHUBCLIENT_09_005: [ The thread shall call IoTHubClient_LL_UploadFileToBlob passing the destinationFileName and the sourceFilePath packed in the structure. ]*/
+    if (IoTHubClient_LL_UploadFileToBlob(threadInfo->iotHubClientHandle->IoTHubClientLLHandle, threadInfo->destinationFileName, threadInfo->uploadBlobSavedData.sourceFilePath) == IOTHUB_CLIENT_OK)
+    {
+        /*Codes_SRS_IOTHUBCLIENT_09_007: [ Otherwise the thread shall call iotHubClientFileUploadCallback passing as result FILE_UPLOAD_OK and the context. ]*/
+        upload_result = FILE_UPLOAD_OK;
+    }
+    else
+    {
+        /*Codes_SRS_IOTHUBCLIENT_09_006: [ If IoTHubClient_LL_UploadFileToBlob fails then the thread shall call iotHubClientFileUploadCallback passing as result FILE_UPLOAD_ERROR and the context. ]*/
+        LogError("unable to IoTHubClient_LL_UploadFileToBlob");
+        upload_result = FILE_UPLOAD_ERROR;
+    }
+
+    if (threadInfo->uploadBlobSavedData.iotHubClientFileUploadCallback != NULL)
+    {
+        threadInfo->uploadBlobSavedData.iotHubClientFileUploadCallback(upload_result, threadInfo->context);
+    }
+
+    /*Codes_SRS_IOTHUBCLIENT_09_008: [ The thread shall mark itself as disposable. ]*/
+    return markThreadReadyToBeGarbageCollected(threadInfo);
+}
+
+IOTHUB_CLIENT_RESULT IoTHubClient_UploadFileToBlobAsync(IOTHUB_CLIENT_HANDLE iotHubClientHandle, const char* destinationFileName, const char* sourceFilePath, IOTHUB_CLIENT_FILE_UPLOAD_CALLBACK iotHubClientFileUploadCallback, void* context)
+{
+    IOTHUB_CLIENT_RESULT result;
+    /*Codes_SRS_IOTHUBCLIENT_09_001: [ If iotHubClientHandle, destinationFileName or sourceFilePath is NULL then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+    if (
+        (iotHubClientHandle == NULL) ||
+        (destinationFileName == NULL) ||
+        (sourceFilePath == NULL)
+        )
+    {
+        LogError("invalid parameters IOTHUB_CLIENT_HANDLE iotHubClientHandle = %p , const char* destinationFileName = %s, const char* sourceFilePath = %s",
+            iotHubClientHandle,
+            destinationFileName,
+            sourceFilePath
+        );
+        result = IOTHUB_CLIENT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_IOTHUBCLIENT_09_002: [ IoTHubClient_UploadFileToBlobAsync shall copy the destinationFileName, sourceFilePath, iotHubClientFileUploadCallback and context into a structure. ]*/
+        UPLOADTOBLOB_THREAD_INFO *threadInfo = allocateUploadToBlob(destinationFileName, iotHubClientHandle, context);
+        if (threadInfo == NULL)
+        {
+            /*Codes_SRS_IOTHUBCLIENT_09_004: [ If copying to the structure or spawning the thread fails, then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+            LogError("unable to create upload thread info");
+            result = IOTHUB_CLIENT_ERROR;
+        }
+        else if (mallocAndStrcpy_s(&threadInfo->uploadBlobSavedData.sourceFilePath, sourceFilePath) != 0)
+        {
+            /*Codes_SRS_IOTHUBCLIENT_09_004: [ If copying to the structure or spawning the thread fails, then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+            LogError("unable to copy sourceFilePath");
+            freeUploadToBlobThreadInfo(threadInfo);
+            result = IOTHUB_CLIENT_ERROR;
+        }
+        else
+        {
+            threadInfo->uploadBlobSavedData.iotHubClientFileUploadCallback = iotHubClientFileUploadCallback;
+
+            if ((result = StartWorkerThreadIfNeeded(iotHubClientHandle)) != IOTHUB_CLIENT_OK)
+            {
+                /*Codes_SRS_IOTHUBCLIENT_09_004: [ If copying to the structure or spawning the thread fails, then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+                LogError("Could not start worker thread");
+                freeUploadToBlobThreadInfo(threadInfo);
+            }
+            /*Codes_SRS_IOTHUBCLIENT_09_003: [ IoTHubClient_UploadFileToBlobAsync shall add the structure to the list of structures that need to be cleaned once file upload finishes and spawn a thread passing the structure as thread data. ]*/
+            else if ((result = startUploadToBlobWorkerThread(threadInfo, uploadingFileThread)) != IOTHUB_CLIENT_OK)
+            {
+                /*Codes_SRS_IOTHUBCLIENT_09_004: [ If copying to the structure or spawning the thread fails, then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+                LogError("unable to start upload thread");
+                freeUploadToBlobThreadInfo(threadInfo);
+            }
+            else
+            {
+                result = IOTHUB_CLIENT_OK;
+            }
+        }
+    }
+
+    return result;
+}
+
 static int uploadMultipleBlock_thread(void* data)
 {
     UPLOADTOBLOB_THREAD_INFO* threadInfo = (UPLOADTOBLOB_THREAD_INFO*)data;
@@ -120,6 +120,7 @@ static void setTransportProtocol(IOTHUB_CLIENT_LL_HANDLE_DATA* handleData, TRANS
     handleData->IoTHubTransport_Subscribe_DeviceMethod = protocol->IoTHubTransport_Subscribe_DeviceMethod;
     handleData->IoTHubTransport_Unsubscribe_DeviceMethod = protocol->IoTHubTransport_Unsubscribe_DeviceMethod;
     handleData->IoTHubTransport_DeviceMethod_Response = protocol->IoTHubTransport_DeviceMethod_Response;
+    handleData->IoTHubTransport_NotifyEventQueued = protocol->IoTHubTransport_NotifyEventQueued;
 }
 
 static void device_twin_data_destroy(IOTHUB_DEVICE_TWIN* client_item)
@@ -1076,6 +1077,13 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_SendEventAsync(IOTHUB_CLIENT_LL_HANDLE iotH
                     newEntry->callback = eventConfirmationCallback;
                     newEntry->context = userContextCallback;
                     DList_InsertTailList(&(iotHubClientHandle->waitingToSend), &(newEntry->entry));
+
+                    /*Codes_SRS_IOTHUBCLIENT_LL_09_028: [If the transport provides IoTHubTransport_NotifyEventQueued, IoTHubClient_LL_SendEventAsync shall invoke it passing the device handle after the event is added to waitingToSend.]*/
+                    if (handleData->IoTHubTransport_NotifyEventQueued != NULL)
+                    {
+                        handleData->IoTHubTransport_NotifyEventQueued(handleData->deviceHandle);
+                    }
+
                     /*Codes_SRS_IOTHUBCLIENT_LL_02_015: [Otherwise IoTHubClient_LL_SendEventAsync shall succeed and return IOTHUB_CLIENT_OK.] */
                     result = IOTHUB_CLIENT_OK;
                 }
@@ -2149,6 +2157,27 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlobEx(IOTHUB_CLIENT_
     return result;
 }
 
+IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadFileToBlob(IOTHUB_CLIENT_LL_HANDLE iotHubClientHandle, const char* destinationFileName, const char* sourceFilePath)
+{
+    IOTHUB_CLIENT_RESULT result;
+    /*Codes_SRS_IOTHUBCLIENT_LL_09_018: [ If `iotHubClientHandle`, `destinationFileName` or `sourceFilePath` is `NULL` then `IoTHubClient_LL_UploadFileToBlob` shall fail and return `IOTHUB_CLIENT_INVALID_ARG`. ]*/
+    if (
+        (iotHubClientHandle == NULL) ||
+        (destinationFileName == NULL) ||
+        (sourceFilePath == NULL)
+        )
+    {
+        LogError("invalid parameters IOTHUB_CLIENT_LL_HANDLE iotHubClientHandle=%p, destinationFileName=%p, sourceFilePath=%p", iotHubClientHandle, destinationFileName, sourceFilePath);
+        result = IOTHUB_CLIENT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_IOTHUBCLIENT_LL_09_019: [ `IoTHubClient_LL_UploadFileToBlob` shall call `IoTHubClient_LL_UploadFileToBlob_Impl` and return its result. ]*/
+        result = IoTHubClient_LL_UploadFileToBlob_Impl(iotHubClientHandle->uploadToBlobHandle, destinationFileName, sourceFilePath);
+    }
+    return result;
+}
+
 
 
 #endif /* DONT_USE_UPLOADTOBLOB */
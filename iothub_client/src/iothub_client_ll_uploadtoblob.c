@@ -6,6 +6,7 @@
 #else
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/gballoc.h"
@@ -26,6 +27,14 @@
 #include "iothub_client_ll_uploadtoblob.h"
 #include "blob.h"
 
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #ifdef WINCE
 #include <stdarg.h>
@@ -71,8 +80,16 @@ typedef struct IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE_DATA_TAG
     char* certificates; /*if there are any certificates used*/
     HTTP_PROXY_OPTIONS http_proxy_options;
     size_t curl_verbose;
+    size_t parallel_uploads;
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE* checkpoint_store; /*NULL when uploads are not resumable*/
 }IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE_DATA;
 
+typedef struct UPLOADTOBLOB_CHECKPOINT_CONTEXT_TAG
+{
+    const IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE* store;
+    const char* destinationFileName;
+}UPLOADTOBLOB_CHECKPOINT_CONTEXT;
+
 typedef struct BLOB_UPLOAD_CONTEXT_TAG
 {
     const unsigned char* blobSource; /* source to upload */
@@ -80,6 +97,12 @@ typedef struct BLOB_UPLOAD_CONTEXT_TAG
     size_t remainingSizeToUpload; /* size not yet uploaded */
 }BLOB_UPLOAD_CONTEXT;
 
+typedef struct FILE_UPLOAD_CONTEXT_TAG
+{
+    int fd; /* source to upload, every block is read at its offset directly into the buffer that is uploaded */
+    unsigned long long fileSize; /* size of the source when it was opened */
+}FILE_UPLOAD_CONTEXT;
+
 IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE IoTHubClient_LL_UploadToBlob_Create(const IOTHUB_CLIENT_CONFIG* config)
 {
     IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE_DATA* handleData = malloc(sizeof(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE_DATA));
@@ -123,6 +146,8 @@ IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE IoTHubClient_LL_UploadToBlob_Create(const I
                 handleData->certificates = NULL;
                 memset(&(handleData->http_proxy_options), 0, sizeof(HTTP_PROXY_OPTIONS));
                 handleData->curl_verbose = 0;
+                handleData->parallel_uploads = 1;
+                handleData->checkpoint_store = NULL;
 
                 if ((config->deviceSasToken != NULL) && (config->deviceKey == NULL))
                 {
@@ -771,6 +796,13 @@ static int IoTHubClient_LL_UploadToBlob_step3(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HAND
     return result;
 }
 
+/*called by Blob_UploadMultipleBlocksFromSasUri after every block, a failure to save only costs the ability to resume*/
+static void save_checkpoint(unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash, void* context)
+{
+    UPLOADTOBLOB_CHECKPOINT_CONTEXT* checkpointContext = (UPLOADTOBLOB_CHECKPOINT_CONTEXT*)context;
+    checkpointContext->store->save_checkpoint(checkpointContext->destinationFileName, blockCount, uploadedBytes, contentHash, checkpointContext->store->context);
+}
+
 // this callback splits the source data into blocks to be fed to IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex)_Impl
 static IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT FileUpload_GetData_Callback(IOTHUB_CLIENT_FILE_UPLOAD_RESULT result, unsigned char const ** data, size_t* size, void* context)
 {
@@ -804,7 +836,8 @@ static IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT FileUpload_GetData_Callback(IOT
     return IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_OK;
 }
 
-IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE handle, const char* destinationFileName, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, void* context)
+/*the blocks are obtained from getDataCallbackEx or, when it is NULL, read by readBlockCallback directly into the buffers that are uploaded*/
+static IOTHUB_CLIENT_RESULT upload_multiple_blocks_to_blob(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE handle, const char* destinationFileName, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, BLOB_READ_BLOCK_CALLBACK readBlockCallback, void* context)
 {
     IOTHUB_CLIENT_RESULT result;
 
@@ -814,10 +847,10 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIE
     if (
         (handle == NULL) ||
         (destinationFileName == NULL) ||
-        (getDataCallbackEx == NULL)
+        ((getDataCallbackEx == NULL) && (readBlockCallback == NULL))
         )
     {
-        LogError("invalid argument detected handle=%p destinationFileName=%p getDataCallbackEx=%p", handle, destinationFileName, getDataCallbackEx);
+        LogError("invalid argument detected handle=%p destinationFileName=%p getDataCallbackEx=%p readBlockCallback=%p", handle, destinationFileName, getDataCallbackEx, readBlockCallback);
         result = IOTHUB_CLIENT_INVALID_ARG;
     }
     else
@@ -920,6 +953,8 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIE
                                         /*do step 2.*/
 
                                         unsigned int httpResponse;
+                                        UPLOADTOBLOB_CHECKPOINT_CONTEXT checkpointContext;
+                                        BLOB_UPLOAD_CHECKPOINT checkpoint;
                                         BUFFER_HANDLE responseToIoTHub = BUFFER_new();
                                         if (responseToIoTHub == NULL)
                                         {
@@ -928,8 +963,83 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIE
                                         }
                                         else
                                         {
-                                            /*Codes_SRS_IOTHUBCLIENT_LL_02_083: [ IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall call Blob_UploadFromSasUri and capture the HTTP return code and HTTP body. ]*/
-                                            BLOB_RESULT uploadMultipleBlocksResult = Blob_UploadMultipleBlocksFromSasUri(STRING_c_str(sasUri), getDataCallbackEx, context, &httpResponse, responseToIoTHub, handleData->certificates, &(handleData->http_proxy_options));
+                                            BLOB_RESULT uploadMultipleBlocksResult;
+                                            int checkpointLoadFailed = 0;
+
+                                            if (handleData->checkpoint_store != NULL)
+                                            {
+                                                IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT loadResult;
+
+                                                /*Codes_SRS_IOTHUBCLIENT_LL_09_015: [ If a checkpoint store is set, IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall have Blob_UploadMultipleBlocksFromSasUri save the number of blocks and bytes uploaded, and the fingerprint of those bytes, to it after every block. ]*/
+                                                checkpointContext.store = handleData->checkpoint_store;
+                                                checkpointContext.destinationFileName = destinationFileName;
+                                                checkpoint.blockCount = 0;
+                                                checkpoint.uploadedBytes = 0;
+                                                checkpoint.contentHash = 0;
+                                                checkpoint.onBlockUploaded = save_checkpoint;
+                                                checkpoint.onBlockUploadedContext = &checkpointContext;
+
+                                                /*Codes_SRS_IOTHUBCLIENT_LL_09_016: [ If the checkpoint store loads a checkpoint of destinationFileName, and Blob_VerifyUncommittedBlocks confirms its blocks are still in storage, the upload shall resume after those blocks once Blob_UploadMultipleBlocksFromSasUri has checked that the data still has the fingerprint of the checkpoint. ]*/
+                                                /*the SAS from step 1 addresses the same blob as the one of the interrupted upload, so its uncommitted blocks can still be used*/
+                                                loadResult = handleData->checkpoint_store->load_checkpoint(destinationFileName, &checkpoint.blockCount, &checkpoint.uploadedBytes, &checkpoint.contentHash, handleData->checkpoint_store->context);
+                                                if (loadResult == IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOADED)
+                                                {
+                                                    if (checkpoint.blockCount > MAX_BLOCK_COUNT)
+                                                    {
+                                                        LogError("the checkpoint of %s is corrupted, uploading it from the beginning", destinationFileName);
+                                                        checkpoint.blockCount = 0;
+                                                        checkpoint.uploadedBytes = 0;
+                                                    }
+                                                    else if (Blob_VerifyUncommittedBlocks(STRING_c_str(sasUri), checkpoint.blockCount, handleData->certificates, &(handleData->http_proxy_options)) == BLOB_OK)
+                                                    {
+                                                        LogInfo("resuming upload of %s after %u blocks", destinationFileName, checkpoint.blockCount);
+                                                    }
+                                                    else
+                                                    {
+                                                        LogInfo("the blocks of %s are no longer in storage, uploading it from the beginning", destinationFileName);
+                                                        checkpoint.blockCount = 0;
+                                                        checkpoint.uploadedBytes = 0;
+                                                    }
+                                                }
+                                                else if (loadResult != IOTHUB_BLOB_UPLOAD_CHECKPOINT_NOT_FOUND)
+                                                {
+                                                    LogError("unable to load the checkpoint of %s", destinationFileName);
+                                                    checkpointLoadFailed = 1;
+                                                }
+                                                else
+                                                {
+                                                    checkpoint.blockCount = 0;
+                                                    checkpoint.uploadedBytes = 0;
+                                                }
+                                            }
+
+                                            if (checkpointLoadFailed)
+                                            {
+                                                /*Codes_SRS_IOTHUBCLIENT_LL_09_025: [ If the checkpoint store fails to load the checkpoint, nothing shall be uploaded, the checkpoint shall be kept and IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall fail as if Blob_UploadMultipleBlocksFromSasUri had failed. ]*/
+                                                uploadMultipleBlocksResult = BLOB_ERROR;
+                                            }
+                                            else
+                                            {
+                                                if (readBlockCallback != NULL)
+                                                {
+                                                    /*Codes_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+                                                    uploadMultipleBlocksResult = Blob_UploadMultipleBlocksFromReader(STRING_c_str(sasUri), readBlockCallback, context, &httpResponse, responseToIoTHub, handleData->certificates, &(handleData->http_proxy_options), handleData->parallel_uploads, (handleData->checkpoint_store != NULL) ? &checkpoint : NULL);
+                                                }
+                                                else
+                                                {
+                                                    /*Codes_SRS_IOTHUBCLIENT_LL_02_083: [ IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall call Blob_UploadFromSasUri and capture the HTTP return code and HTTP body. ]*/
+                                                    uploadMultipleBlocksResult = Blob_UploadMultipleBlocksFromSasUri(STRING_c_str(sasUri), getDataCallbackEx, context, &httpResponse, responseToIoTHub, handleData->certificates, &(handleData->http_proxy_options), handleData->parallel_uploads, (handleData->checkpoint_store != NULL) ? &checkpoint : NULL);
+                                                }
+
+                                                /*Codes_SRS_IOTHUBCLIENT_LL_09_017: [ The checkpoint shall be deleted when the blob is uploaded, when the upload is aborted, or when the data does not match the checkpoint (BLOB_INVALID_ARG); otherwise it is kept for the next upload. ]*/
+                                                /*Codes_SRS_IOTHUBCLIENT_LL_09_026: [ The checkpoint shall be kept when reading the source file fails. ]*/
+                                                if ((handleData->checkpoint_store != NULL) &&
+                                                    ((uploadMultipleBlocksResult == BLOB_ABORTED) || (uploadMultipleBlocksResult == BLOB_INVALID_ARG) || ((uploadMultipleBlocksResult == BLOB_OK) && (httpResponse < 300))))
+                                                {
+                                                    handleData->checkpoint_store->delete_checkpoint(destinationFileName, handleData->checkpoint_store->context);
+                                                }
+                                            }
+
                                             if (uploadMultipleBlocksResult == BLOB_ABORTED)
                                             {
                                                 /*Codes_SRS_IOTHUBCLIENT_LL_99_008: [ If step 2 is aborted by the client, then the HTTP message body shall look like:  ]*/
@@ -1025,10 +1135,161 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIE
         }
     }
 
-    /*Codes_SRS_IOTHUBCLIENT_LL_99_003: [ If `IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex)` return `IOTHUB_CLIENT_OK`, it shall call `getDataCallbackEx` with `result` set to `FILE_UPLOAD_OK`, and `data` and `size` set to NULL. ]*/
-    /*Codes_SRS_IOTHUBCLIENT_LL_99_004: [ If `IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex)` does not return `IOTHUB_CLIENT_OK`, it shall call `getDataCallbackEx` with `result` set to `FILE_UPLOAD_ERROR`, and `data` and `size` set to NULL. ]*/
-    (void)getDataCallbackEx(result == IOTHUB_CLIENT_OK ? FILE_UPLOAD_OK : FILE_UPLOAD_ERROR, NULL, NULL, context);
+    if (getDataCallbackEx != NULL)
+    {
+        /*Codes_SRS_IOTHUBCLIENT_LL_99_003: [ If `IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex)` return `IOTHUB_CLIENT_OK`, it shall call `getDataCallbackEx` with `result` set to `FILE_UPLOAD_OK`, and `data` and `size` set to NULL. ]*/
+        /*Codes_SRS_IOTHUBCLIENT_LL_99_004: [ If `IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex)` does not return `IOTHUB_CLIENT_OK`, it shall call `getDataCallbackEx` with `result` set to `FILE_UPLOAD_ERROR`, and `data` and `size` set to NULL. ]*/
+        (void)getDataCallbackEx(result == IOTHUB_CLIENT_OK ? FILE_UPLOAD_OK : FILE_UPLOAD_ERROR, NULL, NULL, context);
+    }
+
+    return result;
+}
+
+IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE handle, const char* destinationFileName, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, void* context)
+{
+    return upload_multiple_blocks_to_blob(handle, destinationFileName, getDataCallbackEx, NULL, context);
+}
+
+/*reads up to size bytes of the file at offset, returns the number of bytes read, 0 at the end of the file or -1 on failure*/
+static int read_file_at(int fd, unsigned char* destination, size_t size, unsigned long long offset)
+{
+    int result;
+#ifdef _WIN32
+    if (_lseeki64(fd, (__int64)offset, SEEK_SET) < 0)
+    {
+        result = -1;
+    }
+    else
+    {
+        result = _read(fd, destination, (unsigned int)size);
+    }
+#else
+    result = (int)pread(fd, destination, size, (off_t)offset);
+#endif
+    return result;
+}
+
+// this callback reads one block of the source file directly into the buffer that is uploaded
+static int FileUpload_ReadFileBlock_Callback(BUFFER_HANDLE block, unsigned long long offset, void* context)
+{
+    int result;
+    FILE_UPLOAD_CONTEXT* uploadContext = (FILE_UPLOAD_CONTEXT*)context;
+    size_t blockSize;
+
+    if (offset >= uploadContext->fileSize)
+    {
+        blockSize = 0;
+    }
+    else
+    {
+        blockSize = (uploadContext->fileSize - offset < BLOCK_SIZE) ? (size_t)(uploadContext->fileSize - offset) : BLOCK_SIZE;
+    }
+
+    if (blockSize == 0)
+    {
+        /*the whole file has been read, the block is left empty*/
+        result = 0;
+    }
+    else if (BUFFER_pre_build(block, blockSize) != 0)
+    {
+        LogError("unable to BUFFER_pre_build");
+        result = __FAILURE__;
+    }
+    else
+    {
+        /*Codes_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+        unsigned char* destination = BUFFER_u_char(block);
+        size_t readSize = 0;
+
+        result = 0;
+        while (readSize < blockSize && result == 0)
+        {
+            int thisReadSize = read_file_at(uploadContext->fd, destination + readSize, blockSize - readSize, offset + readSize);
+            if (thisReadSize <= 0)
+            {
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_023: [ If reading the file fails, or the file is shorter than when it was opened, the upload shall fail and `IoTHubClient_LL_UploadFileToBlob_Impl` shall return `IOTHUB_CLIENT_ERROR`. ]*/
+                LogError("unable to read the file at offset %llu", offset + readSize);
+                result = __FAILURE__;
+            }
+            else
+            {
+                readSize += (size_t)thisReadSize;
+            }
+        }
+
+#if defined(__linux__) && defined(POSIX_FADV_WILLNEED)
+        /*Codes_SRS_IOTHUBCLIENT_LL_09_024: [ Where available, the next block shall be read ahead while the current block is being uploaded. ]*/
+        if (result == 0 && offset + blockSize < uploadContext->fileSize)
+        {
+            (void)posix_fadvise(uploadContext->fd, (off_t)(offset + blockSize), BLOCK_SIZE, POSIX_FADV_WILLNEED);
+        }
+#endif
+    }
+
+    return result;
+}
+
+IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadFileToBlob_Impl(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE handle, const char* destinationFileName, const char* sourceFilePath)
+{
+    IOTHUB_CLIENT_RESULT result;
+
+    /*Codes_SRS_IOTHUBCLIENT_LL_09_020: [ If `handle`, `destinationFileName` or `sourceFilePath` is `NULL` then `IoTHubClient_LL_UploadFileToBlob_Impl` shall fail and return `IOTHUB_CLIENT_INVALID_ARG`. ]*/
+    if (
+        (handle == NULL) ||
+        (destinationFileName == NULL) ||
+        (sourceFilePath == NULL)
+        )
+    {
+        LogError("invalid argument detected handle=%p destinationFileName=%p sourceFilePath=%p", handle, destinationFileName, sourceFilePath);
+        result = IOTHUB_CLIENT_INVALID_ARG;
+    }
+    else
+    {
+        FILE_UPLOAD_CONTEXT context;
+#ifdef _WIN32
+        struct _stati64 fileStatus;
+        context.fd = _open(sourceFilePath, _O_RDONLY | _O_BINARY);
+#else
+        struct stat fileStatus;
+        context.fd = open(sourceFilePath, O_RDONLY);
+#endif
+
+        if (context.fd < 0)
+        {
+            /*Codes_SRS_IOTHUBCLIENT_LL_09_021: [ If the file cannot be opened or its size cannot be obtained, `IoTHubClient_LL_UploadFileToBlob_Impl` shall fail and return `IOTHUB_CLIENT_ERROR`. ]*/
+            LogError("unable to open %s", sourceFilePath);
+            result = IOTHUB_CLIENT_ERROR;
+        }
+        else
+        {
+#ifdef _WIN32
+            if (_fstati64(context.fd, &fileStatus) != 0)
+#else
+            if (fstat(context.fd, &fileStatus) != 0)
+#endif
+            {
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_021: [ If the file cannot be opened or its size cannot be obtained, `IoTHubClient_LL_UploadFileToBlob_Impl` shall fail and return `IOTHUB_CLIENT_ERROR`. ]*/
+                LogError("unable to get the size of %s", sourceFilePath);
+                result = IOTHUB_CLIENT_ERROR;
+            }
+            else
+            {
+                context.fileSize = (unsigned long long)fileStatus.st_size;
+#if defined(__linux__) && defined(POSIX_FADV_SEQUENTIAL)
+                (void)posix_fadvise(context.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_023: [ If reading the file fails, or the file is shorter than when it was opened, the upload shall fail and `IoTHubClient_LL_UploadFileToBlob_Impl` shall return `IOTHUB_CLIENT_ERROR`. ]*/
+                result = upload_multiple_blocks_to_blob(handle, destinationFileName, NULL, FileUpload_ReadFileBlock_Callback, &context);
+            }
+#ifdef _WIN32
+            (void)_close(context.fd);
+#else
+            (void)close(context.fd);
+#endif
+        }
+    }
     return result;
 }
 
@@ -1113,6 +1374,10 @@ void IoTHubClient_LL_UploadToBlob_Destroy(IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h
         {
             free((char *)handleData->http_proxy_options.password);
         }
+        if (handleData->checkpoint_store != NULL)
+        {
+            free(handleData->checkpoint_store);
+        }
         free(handleData);
     }
 }
@@ -1284,6 +1549,55 @@ IOTHUB_CLIENT_RESULT IoTHubClient_LL_UploadToBlob_SetOption(IOTHUB_CLIENT_LL_UPL
             handleData->curl_verbose = *(size_t*)value;
             result = IOTHUB_CLIENT_OK;
         }
+        /*Codes_SRS_IOTHUBCLIENT_LL_09_011: [ OPTION_BLOB_UPLOAD_PARALLELISM - then the value is a pointer to a size_t with the number of blocks to upload concurrently, passed to Blob_UploadMultipleBlocksFromSasUri. ]*/
+        else if (strcmp(optionName, OPTION_BLOB_UPLOAD_PARALLELISM) == 0)
+        {
+            size_t parallel_uploads = *(size_t*)value;
+
+            if (parallel_uploads == 0 || parallel_uploads > BLOB_MAX_PARALLEL_UPLOADS)
+            {
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_012: [ If the value is 0 or greater than BLOB_MAX_PARALLEL_UPLOADS, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+                LogError("invalid %s value (%lu), it must be between 1 and %d", OPTION_BLOB_UPLOAD_PARALLELISM, (unsigned long)parallel_uploads, BLOB_MAX_PARALLEL_UPLOADS);
+                result = IOTHUB_CLIENT_INVALID_ARG;
+            }
+            else
+            {
+                handleData->parallel_uploads = parallel_uploads;
+                result = IOTHUB_CLIENT_OK;
+            }
+        }
+        /*Codes_SRS_IOTHUBCLIENT_LL_09_013: [ OPTION_BLOB_UPLOAD_CHECKPOINT_STORE - then the value is a pointer to an IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE which shall be copied, or NULL to stop saving checkpoints. ]*/
+        else if (strcmp(optionName, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE) == 0)
+        {
+            const IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE* store = (const IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE*)value;
+            IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE* tempCopy = NULL;
+
+            if ((store != NULL) && ((store->load_checkpoint == NULL) || (store->save_checkpoint == NULL) || (store->delete_checkpoint == NULL)))
+            {
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_027: [ If any function of the store is NULL, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+                LogError("invalid %s value, all its functions must be set", OPTION_BLOB_UPLOAD_CHECKPOINT_STORE);
+                result = IOTHUB_CLIENT_INVALID_ARG;
+            }
+            else if ((store != NULL) && ((tempCopy = (IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE*)malloc(sizeof(IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE))) == NULL))
+            {
+                /*Codes_SRS_IOTHUBCLIENT_LL_09_014: [ If copying the store fails, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+                LogError("unable to malloc");
+                result = IOTHUB_CLIENT_ERROR;
+            }
+            else
+            {
+                if (tempCopy != NULL)
+                {
+                    *tempCopy = *store;
+                }
+                if (handleData->checkpoint_store != NULL)
+                {
+                    free(handleData->checkpoint_store);
+                }
+                handleData->checkpoint_store = tempCopy;
+                result = IOTHUB_CLIENT_OK;
+            }
+        }
         else
         {
             /*Codes_SRS_IOTHUBCLIENT_LL_02_102: [ If an unknown option is presented then IoTHubClient_LL_UploadToBlob_SetOption shall return IOTHUB_CLIENT_INVALID_ARG. ]*/
@@ -7,11 +7,14 @@
 
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/agenttime.h"
+#include "azure_c_shared_utility/tickcounter.h"
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 
 #define RESULT_OK           0
 #define INDEFINITE_TIME     ((time_t)-1)
+#define MAX_WAIT_TIME_IN_MS ((double)UINT32_MAX)
+#define DEFAULT_RANDOM_SEED 0x9E3779B9
 
 typedef struct RETRY_CONTROL_INSTANCE_TAG
 {
@@ -20,11 +23,16 @@ typedef struct RETRY_CONTROL_INSTANCE_TAG
 
 	unsigned int initial_wait_time_in_secs;
 	unsigned int max_jitter_percent;
+	unsigned int max_delay_in_secs;
 
 	unsigned int retry_count;
 	time_t first_retry_time;
-	time_t last_retry_time;
-	unsigned int current_wait_time_in_secs;
+	bool is_last_retry_time_set;
+	tickcounter_ms_t last_retry_time_in_ms;
+	tickcounter_ms_t current_wait_time_in_ms;
+
+	TICK_COUNTER_HANDLE tick_counter;
+	uint32_t random_state;
 } RETRY_CONTROL_INSTANCE;
 
 typedef int (*RETRY_ACTION_EVALUATION_FUNCTION)(RETRY_CONTROL_INSTANCE* retry_state, RETRY_ACTION* retry_action);
@@ -44,7 +52,8 @@ static void* retry_control_clone_option(const char* name, const void* value)
 		result = NULL;
 	}
 	else if (strcmp(RETRY_CONTROL_OPTION_INITIAL_WAIT_TIME_IN_SECS, name) == 0 ||
-			strcmp(RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, name) == 0)
+			strcmp(RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, name) == 0 ||
+			strcmp(RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, name) == 0)
 	{
 		unsigned int* cloned_value;
 
@@ -76,7 +85,8 @@ static void retry_control_destroy_option(const char* name, const void* value)
 		LogError("Failed to destroy option (either name (%p) or value (%p) are NULL)", name, value);
 	}
 	else if (strcmp(RETRY_CONTROL_OPTION_INITIAL_WAIT_TIME_IN_SECS, name) == 0 ||
-		strcmp(RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, name) == 0)
+		strcmp(RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, name) == 0 ||
+		strcmp(RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, name) == 0)
 	{
 		free((void*)value);
 	}
@@ -98,11 +108,11 @@ static int evaluate_retry_action(RETRY_CONTROL_INSTANCE* retry_control, RETRY_AC
 		*retry_action = RETRY_ACTION_RETRY_NOW;
 		result = RESULT_OK;
 	}
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_020: [If `retry_control->last_retry_time` is INDEFINITE_TIME and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, the evaluation function shall return non-zero]
-	else if (retry_control->last_retry_time == INDEFINITE_TIME &&
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_020: [If `retry_control->last_retry_time_in_ms` is not set and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, the evaluation function shall return non-zero]
+	else if (!retry_control->is_last_retry_time_set &&
 		     retry_control->policy != IOTHUB_CLIENT_RETRY_IMMEDIATE)
 	{
-		LogError("Failed to evaluate retry action (last_retry_time is INDEFINITE_TIME)");
+		LogError("Failed to evaluate retry action (last_retry_time is not set)");
 		result = __FAILURE__;
 	}
 	else
@@ -133,58 +143,139 @@ static int evaluate_retry_action(RETRY_CONTROL_INSTANCE* retry_control, RETRY_AC
 			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
 			result = RESULT_OK;
 		}
-		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_024: [Otherwise, if (`current_time` - `retry_control->last_retry_time`) is less than `retry_control->current_wait_time_in_secs`, `retry_action` shall be set to RETRY_ACTION_RETRY_LATER]
-		else if (get_difftime(current_time, retry_control->last_retry_time) < retry_control->current_wait_time_in_secs)
-		{
-			*retry_action = RETRY_ACTION_RETRY_LATER;
-
-			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
-			result = RESULT_OK;
-		}
-		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_025: [Otherwise, if (`current_time` - `retry_control->last_retry_time`) is greater or equal to `retry_control->current_wait_time_in_secs`, `retry_action` shall be set to RETRY_ACTION_RETRY_NOW]
 		else
 		{
-			*retry_action = RETRY_ACTION_RETRY_NOW;
+			tickcounter_ms_t current_time_in_ms;
 
-			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
-			result = RESULT_OK;
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_064: [`current_time_in_ms` shall be set using tickcounter_get_current_ms()]
+			if (tickcounter_get_current_ms(retry_control->tick_counter, &current_time_in_ms) != 0)
+			{
+				// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_065: [If tickcounter_get_current_ms() fails, the evaluation function shall return non-zero]
+				LogError("Failed to evaluate retry action (tickcounter_get_current_ms() failed)");
+				result = __FAILURE__;
+			}
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_024: [Otherwise, if (`current_time_in_ms` - `retry_control->last_retry_time_in_ms`) is less than `retry_control->current_wait_time_in_ms`, `retry_action` shall be set to RETRY_ACTION_RETRY_LATER]
+			else if ((current_time_in_ms - retry_control->last_retry_time_in_ms) < retry_control->current_wait_time_in_ms)
+			{
+				*retry_action = RETRY_ACTION_RETRY_LATER;
+
+				// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
+				result = RESULT_OK;
+			}
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_025: [Otherwise, if (`current_time_in_ms` - `retry_control->last_retry_time_in_ms`) is greater or equal to `retry_control->current_wait_time_in_ms`, `retry_action` shall be set to RETRY_ACTION_RETRY_NOW]
+			else
+			{
+				*retry_action = RETRY_ACTION_RETRY_NOW;
+
+				// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
+				result = RESULT_OK;
+			}
 		}
 	}
 
 	return result;
 }
 
-static unsigned int calculate_next_wait_time(RETRY_CONTROL_INSTANCE* retry_control)
+static void set_random_seed(RETRY_CONTROL_INSTANCE* retry_control, uint32_t seed)
+{
+	// The seed is scrambled (murmur3 finalizer) so that seeds close to each other, like sequential
+	// device numbers, do not produce near-identical first wait times.
+	seed ^= seed >> 16;
+	seed *= 0x85EBCA6B;
+	seed ^= seed >> 13;
+	seed *= 0xC2B2AE35;
+	seed ^= seed >> 16;
+
+	// xorshift32 never leaves the all-zeros state, so it is replaced by a fixed non-zero one.
+	retry_control->random_state = (seed == 0 ? DEFAULT_RANDOM_SEED : seed);
+}
+
+static double get_next_random_ratio(RETRY_CONTROL_INSTANCE* retry_control)
+{
+	// Each instance owns its generator (xorshift32), so a seeded instance produces a reproducible
+	// sequence regardless of how other modules use rand().
+	uint32_t x = retry_control->random_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	retry_control->random_state = x;
+
+	return (double)x / (double)UINT32_MAX;
+}
+
+static tickcounter_ms_t cap_wait_time(RETRY_CONTROL_INSTANCE* retry_control, double wait_time_in_ms)
+{
+	double max_wait_time_in_ms = MAX_WAIT_TIME_IN_MS;
+
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_068: [If `retry_control->max_delay_in_secs` is not 0, the value returned by `calculate_next_wait_time` shall not exceed (`retry_control->max_delay_in_secs` * 1000)]
+	if (retry_control->max_delay_in_secs > 0)
+	{
+		max_wait_time_in_ms = retry_control->max_delay_in_secs * 1000.0;
+	}
+
+	if (wait_time_in_ms > max_wait_time_in_ms)
+	{
+		wait_time_in_ms = max_wait_time_in_ms;
+	}
+	else if (wait_time_in_ms < 0)
+	{
+		wait_time_in_ms = 0;
+	}
+
+	return (tickcounter_ms_t)wait_time_in_ms;
+}
+
+static tickcounter_ms_t calculate_next_wait_time(RETRY_CONTROL_INSTANCE* retry_control)
 {
-	unsigned int result;
+	tickcounter_ms_t result;
+	double initial_wait_time_in_ms = retry_control->initial_wait_time_in_secs * 1000.0;
 
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_029: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_INTERVAL, `calculate_next_wait_time` shall return `retry_control->initial_wait_time_in_secs`]
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_029: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_INTERVAL, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000)]
 	if (retry_control->policy == IOTHUB_CLIENT_RETRY_INTERVAL)
 	{
-		result = retry_control->initial_wait_time_in_secs;
+		result = cap_wait_time(retry_control, initial_wait_time_in_ms);
 	}
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_030: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * (`retry_control->retry_count`))]
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_030: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000 * (`retry_control->retry_count`))]
 	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF)
 	{
-		result = retry_control->initial_wait_time_in_secs * (retry_control->retry_count);
+		result = cap_wait_time(retry_control, initial_wait_time_in_ms * retry_control->retry_count);
 	}
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_031: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, `calculate_next_wait_time` shall return (pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs`)]
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_031: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, `calculate_next_wait_time` shall return (pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000)]
 	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF)
 	{
-		result = (unsigned int)(pow(2, retry_control->retry_count - 1) * retry_control->initial_wait_time_in_secs);
+		result = cap_wait_time(retry_control, pow(2, retry_control->retry_count - 1) * initial_wait_time_in_ms);
 	}
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs`) * (1 + (`retry_control->max_jitter_percent` / 100) * (rand() / RAND_MAX)))]
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000) * (1 + (`retry_control->max_jitter_percent` / 100) * `random_ratio`))]
 	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER)
 	{
-		double jitter_percent = (retry_control->max_jitter_percent / 100.0) * (rand() / ((double)RAND_MAX));
+		double jitter_percent = (retry_control->max_jitter_percent / 100.0) * get_next_random_ratio(retry_control);
 
-		result = (unsigned int)(pow(2, retry_control->retry_count - 1) * retry_control->initial_wait_time_in_secs * (1 + jitter_percent));
+		result = cap_wait_time(retry_control, pow(2, retry_control->retry_count - 1) * initial_wait_time_in_ms * (1 + jitter_percent));
 	}
-	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_033: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_RANDOM, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * (rand() / RAND_MAX))]
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_033: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_RANDOM, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000 * `random_ratio`)]
 	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_RANDOM)
 	{
-		double random_percent = ((double)rand() / (double)RAND_MAX);
-		result = (unsigned int)(retry_control->initial_wait_time_in_secs * random_percent);
+		result = cap_wait_time(retry_control, initial_wait_time_in_ms * get_next_random_ratio(retry_control));
+	}
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_069: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER, `calculate_next_wait_time` shall return (`random_ratio` * min(`max_delay`, pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000))]
+	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER)
+	{
+		tickcounter_ms_t upper_bound = cap_wait_time(retry_control, pow(2, retry_control->retry_count - 1) * initial_wait_time_in_ms);
+
+		result = cap_wait_time(retry_control, upper_bound * get_next_random_ratio(retry_control));
+	}
+	// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_070: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, `calculate_next_wait_time` shall return min(`max_delay`, `initial_wait_time` + `random_ratio` * (3 * `previous_wait_time` - `initial_wait_time`)), where `previous_wait_time` is `retry_control->current_wait_time_in_ms`, or `initial_wait_time` if that is 0]
+	else if (retry_control->policy == IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER)
+	{
+		double previous_wait_time_in_ms = (retry_control->current_wait_time_in_ms == 0 ? initial_wait_time_in_ms : (double)retry_control->current_wait_time_in_ms);
+		double upper_bound = previous_wait_time_in_ms * 3;
+
+		if (upper_bound < initial_wait_time_in_ms)
+		{
+			upper_bound = initial_wait_time_in_ms;
+		}
+
+		result = cap_wait_time(retry_control, initial_wait_time_in_ms + (upper_bound - initial_wait_time_in_ms) * get_next_random_ratio(retry_control));
 	}
 	else
 	{
@@ -258,11 +349,12 @@ void retry_control_reset(RETRY_CONTROL_HANDLE retry_control_handle)
 	{
 		RETRY_CONTROL_INSTANCE* retry_control = (RETRY_CONTROL_INSTANCE*)retry_control_handle;
 
-		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_035: [`retry_control` shall have fields `retry_count` and `current_wait_time_in_secs` set to 0 (zero), `first_retry_time` and `last_retry_time` set to INDEFINITE_TIME]
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_035: [`retry_control` shall have fields `retry_count`, `current_wait_time_in_ms` and `last_retry_time_in_ms` set to 0 (zero), `first_retry_time` set to INDEFINITE_TIME and `last_retry_time_in_ms` marked as not set]
 		retry_control->retry_count = 0;
-		retry_control->current_wait_time_in_secs = 0;
+		retry_control->current_wait_time_in_ms = 0;
 		retry_control->first_retry_time = INDEFINITE_TIME;
-		retry_control->last_retry_time = INDEFINITE_TIME;
+		retry_control->last_retry_time_in_ms = 0;
+		retry_control->is_last_retry_time_set = false;
 	}
 }
 
@@ -278,14 +370,29 @@ RETRY_CONTROL_HANDLE retry_control_create(IOTHUB_CLIENT_RETRY_POLICY policy, uns
 	}
 	else
 	{
-		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_004: [The parameters passed to `retry_control_create` shall be saved into `retry_control`]
 		memset(retry_control, 0, sizeof(RETRY_CONTROL_INSTANCE));
+
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_066: [`retry_control->tick_counter` shall be created using tickcounter_create()]
+		if ((retry_control->tick_counter = tickcounter_create()) == NULL)
+		{
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_067: [If tickcounter_create() fails, `retry_control_create` shall free `retry_control` and return NULL]
+			LogError("Failed creating the retry control (tickcounter_create failed)");
+			free(retry_control);
+			retry_control = NULL;
+		}
+	}
+
+	if (retry_control != NULL)
+	{
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_004: [The parameters passed to `retry_control_create` shall be saved into `retry_control`]
 		retry_control->policy = policy;
 		retry_control->max_retry_time_in_secs = max_retry_time_in_secs;
 
-		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_005: [If `policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF or IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `retry_control->initial_wait_time_in_secs` shall be set to 1]
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_005: [If `policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER or IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, `retry_control->initial_wait_time_in_secs` shall be set to 1]
 		if (retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF ||
-			retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER)
+			retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER ||
+			retry_control->policy == IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER ||
+			retry_control->policy == IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER)
 		{
 			retry_control->initial_wait_time_in_secs = 1;
 		}
@@ -297,7 +404,13 @@ RETRY_CONTROL_HANDLE retry_control_create(IOTHUB_CLIENT_RETRY_POLICY policy, uns
 
 		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_007: [`retry_control->max_jitter_percent` shall be set to 5]
 		retry_control->max_jitter_percent = 5;
-	
+
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_071: [`retry_control->max_delay_in_secs` shall be set to 0 (no cap)]
+		retry_control->max_delay_in_secs = 0;
+
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_072: [The random generator of `retry_control` shall be seeded from rand() mixed with the address of `retry_control`]
+		set_random_seed(retry_control, (uint32_t)rand() ^ (uint32_t)(uintptr_t)retry_control);
+
 		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_008: [The remaining fields in `retry_control` shall be initialized according to retry_control_reset()]
 		retry_control_reset(retry_control);
 	}
@@ -315,8 +428,13 @@ void retry_control_destroy(RETRY_CONTROL_HANDLE retry_control_handle)
 	}
 	else
 	{
+		RETRY_CONTROL_INSTANCE* retry_control = (RETRY_CONTROL_INSTANCE*)retry_control_handle;
+
+		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_073: [`retry_control_destroy` shall destroy `retry_control->tick_counter` using tickcounter_destroy()]
+		tickcounter_destroy(retry_control->tick_counter);
+
 		// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_056: [`retry_control_destroy` shall destroy `retry_control_handle` using free()]
-		free(retry_control_handle);
+		free(retry_control);
 	}
 }
 
@@ -363,11 +481,11 @@ int retry_control_should_retry(RETRY_CONTROL_HANDLE retry_control_handle, RETRY_
 
 				if (retry_control->policy != IOTHUB_CLIENT_RETRY_IMMEDIATE)
 				{
-					// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_016: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->last_retry_time` shall be set using get_time()]
-					retry_control->last_retry_time = get_time(NULL);
+					// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_016: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->last_retry_time_in_ms` shall be set using tickcounter_get_current_ms()]
+					retry_control->is_last_retry_time_set = (tickcounter_get_current_ms(retry_control->tick_counter, &retry_control->last_retry_time_in_ms) == 0);
 
-					// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_017: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->current_wait_time_in_secs` shall be set using calculate_next_wait_time()]
-					retry_control->current_wait_time_in_secs = calculate_next_wait_time(retry_control);
+					// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_017: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->current_wait_time_in_ms` shall be set using calculate_next_wait_time()]
+					retry_control->current_wait_time_in_ms = calculate_next_wait_time(retry_control);
 				}
 			}
 
@@ -431,6 +549,22 @@ int retry_control_set_option(RETRY_CONTROL_HANDLE retry_control_handle, const ch
 				result = RESULT_OK;
 			}
 		}
+		else if (strcmp(RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, name) == 0)
+		{
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_074: [If `name` is "max_delay_in_secs", value shall be saved on `retry_control->max_delay_in_secs`]
+			retry_control->max_delay_in_secs = *((unsigned int*)value);
+
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_044: [If no errors occur, retry_control_set_option shall return 0]
+			result = RESULT_OK;
+		}
+		else if (strcmp(RETRY_CONTROL_OPTION_RANDOM_SEED, name) == 0)
+		{
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_075: [If `name` is "random_seed", value (an unsigned int) shall be used to re-seed the random generator of `retry_control`]
+			set_random_seed(retry_control, (uint32_t)*((unsigned int*)value));
+
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_044: [If no errors occur, retry_control_set_option shall return 0]
+			result = RESULT_OK;
+		}
 		else if (strcmp(RETRY_CONTROL_OPTION_SAVED_OPTIONS, name) == 0)
 		{
 			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_041: [If `name` is "retry_control_options", value shall be fed to `retry_control` using OptionHandler_FeedOptions]
@@ -496,6 +630,13 @@ OPTIONHANDLER_HANDLE retry_control_retrieve_options(RETRY_CONTROL_HANDLE retry_c
 				LogError("Failed to retrieve options (OptionHandler_Create failed for option '%s')", RETRY_CONTROL_OPTION_INITIAL_WAIT_TIME_IN_SECS);
 				result = NULL;
 			}
+			// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_076: [`retry_control->max_delay_in_secs` shall be added to `options` using OptionHandler_Add]
+			else if (OptionHandler_AddOption(options, RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, (void*)&retry_control->max_delay_in_secs) != OPTIONHANDLER_OK)
+			{
+				// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_052: [If any call to OptionHandler_Add fails, `retry_control_retrieve_options` shall fail and return NULL]
+				LogError("Failed to retrieve options (OptionHandler_Create failed for option '%s')", RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS);
+				result = NULL;
+			}
 			else
 			{
 				// Codes_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_054: [If no errors occur, `retry_control_retrieve_options` shall return the OPTIONHANDLER_HANDLE instance]
@@ -16,6 +16,7 @@
 #define DEFAULT_CBS_REQUEST_TIMEOUT_SECS          UINT32_MAX
 #define DEFAULT_SAS_TOKEN_LIFETIME_SECS           3600
 #define DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS       1800
+#define SAS_TOKEN_REFRESH_SPREAD_DIVISOR          4
 
 typedef struct AUTHENTICATION_INSTANCE_TAG 
 {
@@ -31,6 +32,7 @@ typedef struct AUTHENTICATION_INSTANCE_TAG
     size_t cbs_request_timeout_secs;
     size_t sas_token_lifetime_secs;
     size_t sas_token_refresh_time_secs;
+    size_t sas_token_refresh_spread_seed;   // Hash of the device id, used to spread refreshes of devices authenticated together.
 
     AUTHENTICATION_STATE state;
     CBS_HANDLE cbs_handle;
@@ -43,8 +45,22 @@ typedef struct AUTHENTICATION_INSTANCE_TAG
     // Auth module used to generating handle authorization
     // with either SAS Token, x509 Certs, and Device SAS Token
     IOTHUB_AUTHORIZATION_HANDLE authorization_module;
+
+    struct AUTHENTICATION_PUT_TOKEN_QUEUE_TAG* put_token_queue;        // If NULL, SAS tokens are put to CBS as soon as they are due.
+    bool is_put_token_queued;                                           // Waiting in `put_token_queue` for a put-token to be sent.
+    bool is_put_token_slot_held;                                        // Counted in `put_token_queue->number_of_put_tokens_in_progress`.
+    struct AUTHENTICATION_INSTANCE_TAG* previous_queued;
+    struct AUTHENTICATION_INSTANCE_TAG* next_queued;
 } AUTHENTICATION_INSTANCE;
 
+typedef struct AUTHENTICATION_PUT_TOKEN_QUEUE_TAG
+{
+    size_t max_put_tokens_in_progress;
+    size_t number_of_put_tokens_in_progress;
+    AUTHENTICATION_INSTANCE* head;                                      // Instances waiting to put a SAS token, oldest first.
+    AUTHENTICATION_INSTANCE* tail;
+} AUTHENTICATION_PUT_TOKEN_QUEUE;
+
 
 // Helper functions:
 
@@ -104,6 +120,15 @@ static int verify_cbs_put_token_timeout(AUTHENTICATION_INSTANCE* instance, bool*
     return result;
 }
 
+// @brief    Gets the SAS token refresh time of this device, brought forward by up to a quarter of `sas_token_refresh_time_secs`
+//           so devices authenticated at the same time do not all refresh on the same DoWork.
+static size_t get_sas_token_refresh_time_secs(AUTHENTICATION_INSTANCE* instance)
+{
+    size_t spread_window_secs = instance->sas_token_refresh_time_secs / SAS_TOKEN_REFRESH_SPREAD_DIVISOR;
+
+    return instance->sas_token_refresh_time_secs - instance->sas_token_refresh_spread_seed % (spread_window_secs + 1);
+}
+
 static int verify_sas_token_refresh_timeout(AUTHENTICATION_INSTANCE* instance, bool* is_timed_out)
 {
     int result;
@@ -122,7 +147,8 @@ static int verify_sas_token_refresh_timeout(AUTHENTICATION_INSTANCE* instance, b
             result = __FAILURE__;
             LogError("Failed verifying if SAS token refresh timed out (get_time failed)");
         }
-        else if ((uint32_t)get_difftime(current_time, instance->current_sas_token_put_time) >= instance->sas_token_refresh_time_secs)
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_129: [The SAS token refresh time shall be brought forward by an offset derived from `config->device_id_hash`, no greater than 25% of `instance->sas_token_refresh_time_secs`]
+        else if ((uint32_t)get_difftime(current_time, instance->current_sas_token_put_time) >= get_sas_token_refresh_time_secs(instance))
         {
             *is_timed_out = true;
             result = RESULT_OK;
@@ -137,6 +163,15 @@ static int verify_sas_token_refresh_timeout(AUTHENTICATION_INSTANCE* instance, b
     return result;
 }
 
+static void release_put_token_slot(AUTHENTICATION_INSTANCE* instance)
+{
+    if (instance->is_put_token_slot_held)
+    {
+        instance->put_token_queue->number_of_put_tokens_in_progress--;
+        instance->is_put_token_slot_held = false;
+    }
+}
+
 static STRING_HANDLE create_devices_path(STRING_HANDLE iothub_host_fqdn, const char* device_id)
 {
     STRING_HANDLE devices_path;
@@ -158,6 +193,9 @@ static void on_cbs_put_token_complete_callback(void* context, CBS_OPERATION_RESU
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_095: [`instance->is_sas_token_refresh_in_progress` and `instance->is_cbs_put_token_in_progress` shall be set to FALSE]
     instance->is_cbs_put_token_in_progress = false;
 
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_133: [When the put-token completes or times out, the instance shall give back its place among the put-tokens in progress of `config->put_token_queue`]
+    release_put_token_slot(instance);
+
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_091: [If `result` is CBS_OPERATION_RESULT_OK `instance->state` shall be set to AUTHENTICATION_STATE_STARTED and `instance->on_state_changed_callback` invoked]
     if (operation_result == CBS_OPERATION_RESULT_OK)
     {
@@ -325,6 +363,100 @@ static int create_and_put_SAS_token_to_cbs(AUTHENTICATION_INSTANCE* instance)
     return result;
 }
 
+static void put_SAS_token(AUTHENTICATION_INSTANCE* instance)
+{
+    if (create_and_put_SAS_token_to_cbs(instance) != RESULT_OK)
+    {
+        LogError("Failed putting SAS token to CBS for device '%s'", instance->device_id);
+    }
+
+    if (!instance->is_cbs_put_token_in_progress)
+    {
+        if (instance->is_sas_token_refresh_in_progress)
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_120: [If cbs_put_token() fails, `instance->is_sas_token_refresh_in_progress` shall be set to FALSE]
+            instance->is_sas_token_refresh_in_progress = false;
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_079: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
+            update_state(instance, AUTHENTICATION_STATE_ERROR);
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_080: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_SAS_REFRESH_FAILED]
+            notify_error(instance, AUTHENTICATION_ERROR_SAS_REFRESH_FAILED);
+        }
+        else
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_061: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_121: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
+            update_state(instance, AUTHENTICATION_STATE_ERROR);
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_062: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_AUTH_FAILED]
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_122: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_AUTH_FAILED]
+            notify_error(instance, AUTHENTICATION_ERROR_AUTH_FAILED);
+        }
+    }
+}
+
+// ---------- Put-Token Queue Helpers ----------//
+static void remove_from_put_token_queue(AUTHENTICATION_INSTANCE* instance)
+{
+    if (instance->is_put_token_queued)
+    {
+        AUTHENTICATION_PUT_TOKEN_QUEUE* queue = instance->put_token_queue;
+
+        if (instance->previous_queued == NULL)
+        {
+            queue->head = instance->next_queued;
+        }
+        else
+        {
+            instance->previous_queued->next_queued = instance->next_queued;
+        }
+
+        if (instance->next_queued == NULL)
+        {
+            queue->tail = instance->previous_queued;
+        }
+        else
+        {
+            instance->next_queued->previous_queued = instance->previous_queued;
+        }
+
+        instance->previous_queued = NULL;
+        instance->next_queued = NULL;
+        instance->is_put_token_queued = false;
+    }
+}
+
+// @brief    Puts a SAS token to CBS right away or, if the instance shares a put-token queue, waits in it for
+//           authentication_put_token_queue_do_work() to send it.
+static void request_SAS_token_put(AUTHENTICATION_INSTANCE* instance)
+{
+    if (instance->put_token_queue == NULL)
+    {
+        put_SAS_token(instance);
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_130: [If `config->put_token_queue` is not NULL, authentication_do_work() shall add the instance to the end of the queue instead of putting the SAS token to CBS]
+    else if (!instance->is_put_token_queued)
+    {
+        AUTHENTICATION_PUT_TOKEN_QUEUE* queue = instance->put_token_queue;
+
+        instance->previous_queued = queue->tail;
+        instance->next_queued = NULL;
+
+        if (queue->tail == NULL)
+        {
+            queue->head = instance;
+        }
+        else
+        {
+            queue->tail->next_queued = instance;
+        }
+
+        queue->tail = instance;
+        instance->is_put_token_queued = true;
+    }
+}
+
 // ---------- Set/Retrieve Options Helpers ----------//
 static void* authentication_clone_option(const char* name, const void* value)
 {
@@ -446,6 +578,10 @@ int authentication_stop(AUTHENTICATION_HANDLE authentication_handle)
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_033: [`instance->cbs_handle` shall be set to NULL]
             instance->cbs_handle = NULL;
 
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_134: [authentication_stop() shall remove the instance from `config->put_token_queue` and give back its place among the put-tokens in progress]
+            remove_from_put_token_queue(instance);
+            release_put_token_slot(instance);
+
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_034: [`instance->state` shall be set to AUTHENTICATION_STATE_STOPPED and `instance->on_state_changed_callback` invoked]
             update_state(instance, AUTHENTICATION_STATE_STOPPED);
 
@@ -542,6 +678,7 @@ AUTHENTICATION_HANDLE authentication_create(const AUTHENTICATION_CONFIG* config)
             else
             {
                 instance->state = AUTHENTICATION_STATE_STOPPED;
+                instance->sas_token_refresh_spread_seed = config->device_id_hash;
 
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_018: [authentication_create() shall save `config->on_state_changed_callback` and `config->on_state_changed_callback_context` into `instance->on_state_changed_callback` and `instance->on_state_changed_callback_context`.]
                 instance->on_state_changed_callback = config->on_state_changed_callback;
@@ -559,6 +696,7 @@ AUTHENTICATION_HANDLE authentication_create(const AUTHENTICATION_CONFIG* config)
                 instance->sas_token_refresh_time_secs = DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS;
 
                 instance->authorization_module = config->authorization_module;
+                instance->put_token_queue = (AUTHENTICATION_PUT_TOKEN_QUEUE*)config->put_token_queue;
 
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_024: [If no failure occurs, authentication_create() shall return a reference to the AUTHENTICATION_INSTANCE handle]
                 result = (AUTHENTICATION_HANDLE)instance;
@@ -596,6 +734,9 @@ void authentication_do_work(AUTHENTICATION_HANDLE authentication_handle)
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_085: [`instance->is_cbs_put_token_in_progress` shall be set to FALSE]
                 instance->is_cbs_put_token_in_progress = false;
+
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_133: [When the put-token completes or times out, the instance shall give back its place among the put-tokens in progress of `config->put_token_queue`]
+                release_put_token_slot(instance);
             
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_086: [`instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
                 update_state(instance, AUTHENTICATION_STATE_ERROR);
@@ -615,6 +756,10 @@ void authentication_do_work(AUTHENTICATION_HANDLE authentication_handle)
                 instance->is_sas_token_refresh_in_progress = false;
             }
         }
+        else if (instance->is_put_token_queued)
+        {
+            // Waiting for authentication_put_token_queue_do_work() to put the SAS token.
+        }
         else if (instance->state == AUTHENTICATION_STATE_STARTED)
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_040: [If `instance->state` is AUTHENTICATION_STATE_STARTED and user-provided SAS token was used, authentication_do_work() shall return]
@@ -632,42 +777,13 @@ void authentication_do_work(AUTHENTICATION_HANDLE authentication_handle)
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_067: [authentication_do_work() shall create a SAS token using `instance->device_primary_key`, unless it has failed previously]
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_069: [If using `instance->device_primary_key` has failed previously, a SAS token shall be created using `instance->device_secondary_key`]
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_068: [If using `instance->device_primary_key` has failed previously and `instance->device_secondary_key` is not provided,  authentication_do_work() shall fail and return]
-                    if (create_and_put_SAS_token_to_cbs(instance) != RESULT_OK)
-                    {
-                        LogError("Failed refreshing SAS token '%'", instance->device_id);
-                    }
-
-                    if (!instance->is_cbs_put_token_in_progress)
-                    {
-                        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_120: [If cbs_put_token() fails, `instance->is_sas_token_refresh_in_progress` shall be set to FALSE]
-                        instance->is_sas_token_refresh_in_progress = false;
-
-                        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_079: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
-                        update_state(instance, AUTHENTICATION_STATE_ERROR);
-
-                        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_080: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_SAS_REFRESH_FAILED]
-                        notify_error(instance, AUTHENTICATION_ERROR_SAS_REFRESH_FAILED);
-                    }
+                    request_SAS_token_put(instance);
                 }
             }
         }
         else if (instance->state == AUTHENTICATION_STATE_STARTING)
         {
-            if (create_and_put_SAS_token_to_cbs(instance) != RESULT_OK)
-            {
-                LogError("Failed authenticating device '%s' using device keys", instance->device_id);
-            }
-
-            if (!instance->is_cbs_put_token_in_progress)
-            {
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_061: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_121: [If cbs_put_token() fails, `instance->state` shall be updated to AUTHENTICATION_STATE_ERROR and `instance->on_state_changed_callback` invoked]
-                update_state(instance, AUTHENTICATION_STATE_ERROR);
-
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_062: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_AUTH_FAILED]
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_122: [If cbs_put_token() fails, `instance->on_error_callback` shall be invoked with AUTHENTICATION_ERROR_AUTH_FAILED]
-                notify_error(instance, AUTHENTICATION_ERROR_AUTH_FAILED);
-            }
+            request_SAS_token_put(instance);
         }
         else
         {
@@ -793,3 +909,79 @@ OPTIONHANDLER_HANDLE authentication_retrieve_options(AUTHENTICATION_HANDLE authe
     }
     return result;
 }
+
+AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE authentication_put_token_queue_create(size_t max_put_tokens_in_progress)
+{
+    AUTHENTICATION_PUT_TOKEN_QUEUE* queue;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_135: [If `max_put_tokens_in_progress` is zero, authentication_put_token_queue_create() shall fail and return NULL]
+    if (max_put_tokens_in_progress == 0)
+    {
+        LogError("authentication_put_token_queue_create failed (max_put_tokens_in_progress is zero)");
+        queue = NULL;
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_136: [authentication_put_token_queue_create() shall allocate an empty queue that allows up to `max_put_tokens_in_progress` put-tokens in progress]
+    else if ((queue = (AUTHENTICATION_PUT_TOKEN_QUEUE*)malloc(sizeof(AUTHENTICATION_PUT_TOKEN_QUEUE))) == NULL)
+    {
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_137: [If malloc() fails, authentication_put_token_queue_create() shall fail and return NULL]
+        LogError("authentication_put_token_queue_create failed (malloc failed)");
+    }
+    else
+    {
+        memset(queue, 0, sizeof(AUTHENTICATION_PUT_TOKEN_QUEUE));
+        queue->max_put_tokens_in_progress = max_put_tokens_in_progress;
+    }
+
+    return (AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE)queue;
+}
+
+void authentication_put_token_queue_do_work(AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue)
+{
+    if (put_token_queue == NULL)
+    {
+        LogError("authentication_put_token_queue_do_work failed (put_token_queue is NULL)");
+    }
+    else
+    {
+        AUTHENTICATION_PUT_TOKEN_QUEUE* queue = (AUTHENTICATION_PUT_TOKEN_QUEUE*)put_token_queue;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_131: [authentication_put_token_queue_do_work() shall put the SAS tokens of the queued instances to CBS in the order they were queued, while fewer than `max_put_tokens_in_progress` put-tokens are in progress]
+        while (queue->head != NULL && queue->number_of_put_tokens_in_progress < queue->max_put_tokens_in_progress)
+        {
+            AUTHENTICATION_INSTANCE* instance = queue->head;
+
+            remove_from_put_token_queue(instance);
+
+            queue->number_of_put_tokens_in_progress++;
+            instance->is_put_token_slot_held = true;
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_132: [If the SAS token fails to be put, the instance shall be handled as it would by authentication_do_work() and not count as a put-token in progress]
+            put_SAS_token(instance);
+
+            if (!instance->is_cbs_put_token_in_progress)
+            {
+                release_put_token_slot(instance);
+            }
+        }
+    }
+}
+
+void authentication_put_token_queue_destroy(AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue)
+{
+    if (put_token_queue == NULL)
+    {
+        LogError("authentication_put_token_queue_destroy failed (put_token_queue is NULL)");
+    }
+    else
+    {
+        AUTHENTICATION_PUT_TOKEN_QUEUE* queue = (AUTHENTICATION_PUT_TOKEN_QUEUE*)put_token_queue;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_138: [authentication_put_token_queue_destroy() shall remove any instances still queued and free the queue]
+        while (queue->head != NULL)
+        {
+            remove_from_put_token_queue(queue->head);
+        }
+
+        free(queue);
+    }
+}
@@ -51,6 +51,11 @@
 // DEFAULT_MAX_RETRY_TIME_IN_SECS = 0 means infinite retry.
 #define DEFAULT_MAX_RETRY_TIME_IN_SECS            0
 #define MAX_SERVICE_KEEP_ALIVE_RATIO              0.9
+#define DEVICE_INDEX_BUCKET_COUNT                 128
+#define IDLE_DEVICE_DO_WORK_INTERVAL_SECS         1
+#define DEFAULT_AMQP_SESSION_COUNT                1
+#define MAX_AMQP_SESSION_COUNT                    16
+#define MAX_CBS_PUT_TOKENS_IN_PROGRESS            16
 
 // ---------- Data Definitions ---------- //
 
@@ -94,6 +99,12 @@ DEFINE_LOCAL_ENUM(AMQP_TRANSPORT_STATE, AMQP_TRANSPORT_STATE_STRINGS);
 #pragma clang diagnostic pop
 #endif
 
+typedef struct AMQP_TRANSPORT_DEVICE_QUEUE_TAG
+{
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* head;
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* tail;
+} AMQP_TRANSPORT_DEVICE_QUEUE;
+
 typedef struct AMQP_TRANSPORT_INSTANCE_TAG
 {
     STRING_HANDLE iothub_host_fqdn;                                     // FQDN of the IoT Hub.
@@ -103,12 +114,20 @@ typedef struct AMQP_TRANSPORT_INSTANCE_TAG
     AMQP_CONNECTION_STATE amqp_connection_state;                        // Current state of the amqp_connection.
     AMQP_TRANSPORT_AUTHENTICATION_MODE preferred_authentication_mode;   // Used to avoid registered devices using different authentication modes.
     SINGLYLINKEDLIST_HANDLE registered_devices;                         // List of devices currently registered in this transport.
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* device_index[DEVICE_INDEX_BUCKET_COUNT]; // Registered devices hashed by device id (chained through next_in_device_index).
+    size_t number_of_registered_devices;                                // Number of devices in registered_devices.
+    AMQP_TRANSPORT_DEVICE_QUEUE ready_devices;                          // Registered devices with pending events, requests, timers or inbound traffic; the only ones DoWork processes.
+    AMQP_TRANSPORT_DEVICE_QUEUE idle_devices;                           // Idle registered devices, in the order their periodic do_work becomes due.
+    time_t time_of_current_do_work;                                     // Time the current DoWork pass started.
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue;              // Bounds the CBS put-tokens in progress across all registered devices.
     bool is_trace_on;                                                   // Turns logging on and off.
     OPTIONHANDLER_HANDLE saved_tls_options;                             // Here are the options from the xio layer if any is saved.
     AMQP_TRANSPORT_STATE state;                                         // Current state of the transport.
     RETRY_CONTROL_HANDLE connection_retry_control;                      // Controls when the re-connection attempt should occur.
     size_t svc2cl_keep_alive_timeout_secs;                       // Service to device keep alive frequency
     double cl2svc_keep_alive_send_ratio;								    // Client to service keep alive frequency
+    size_t amqp_session_count;                                          // Number of AMQP sessions registered devices are spread over.
+    size_t amqp_connection_session_count;                               // Number of AMQP sessions `amqp_connection` was created with.
 
     char* http_proxy_hostname;
     int http_proxy_port;
@@ -119,6 +138,14 @@ typedef struct AMQP_TRANSPORT_INSTANCE_TAG
     size_t option_sas_token_refresh_time_secs;                          // Device-specific option.
     size_t option_cbs_request_timeout_secs;                             // Device-specific option.
     size_t option_send_event_timeout_secs;                              // Device-specific option.
+    IOTHUB_EVENT_BATCHING_OPTIONS option_event_batching;                // Device-specific option.
+    bool is_option_event_batching_set;                                  // Only replicated to new devices if set by the user.
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS option_event_sender_links;        // Device-specific option.
+    bool is_option_event_sender_links_set;                              // Only replicated to new devices if set by the user.
+    size_t option_twin_reported_state_coalesce_secs;                    // Device-specific option.
+    bool is_option_twin_reported_state_coalesce_secs_set;               // Only replicated to new devices if set by the user.
+    IOTHUB_C2D_PREFETCH_OPTIONS option_c2d_prefetch;                    // Device-specific option.
+    bool is_option_c2d_prefetch_set;                                    // Only replicated to new devices if set by the user.
 
                                                                         // Auth module used to generating handle authorization
     IOTHUB_AUTHORIZATION_HANDLE authorization_module;                   // with either SAS Token, x509 Certs, and Device SAS Token
@@ -142,6 +169,17 @@ typedef struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG
     bool subscribe_methods_needed;                                       // Indicates if should subscribe for device methods.
     // is the transport subscribed for methods?
     bool subscribed_for_methods;                                         // Indicates if device is subscribed for device methods.
+    LIST_ITEM_HANDLE list_item;                                         // Item of this device in `transport_instance->registered_devices`.
+    size_t device_id_hash;                                              // Hash of the device id, used by `transport_instance->device_index`.
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* next_in_device_index;    // Next device in the same `transport_instance->device_index` bucket.
+    bool is_do_work_requested;                                          // Set when something happened that requires a device-specific do_work on the next DoWork pass.
+    AMQP_TRANSPORT_DEVICE_QUEUE* do_work_queue;                         // `transport_instance->ready_devices` or `idle_devices`; NULL while DoWork processes the device.
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* previous_in_queue;       // Previous device in `do_work_queue`.
+    struct AMQP_TRANSPORT_DEVICE_INSTANCE_TAG* next_in_queue;           // Next device in `do_work_queue`.
+    time_t time_of_last_do_work;                                        // Last DoWork pass the device was processed on; idle devices are processed again IDLE_DEVICE_DO_WORK_INTERVAL_SECS later.
+    size_t number_of_pending_operations;                                // D2C events and reported properties handed to device_handle that did not complete yet.
+    bool is_subscription_change_pending;                                // Set when C2D or twin (un)subscription was requested and device_handle may still be attaching/detaching its links.
+    time_t time_of_last_subscription_change;                            // First DoWork pass the pending subscription change was checked on (INDEFINITE_TIME until then).
 } AMQP_TRANSPORT_DEVICE_INSTANCE;
 
 typedef struct MESSAGE_DISPOSITION_CONTEXT_TAG
@@ -155,6 +193,7 @@ typedef struct AMQP_TRANSPORT_DEVICE_TWIN_CONTEXT_TAG
 {
     uint32_t item_id;
     IOTHUB_CLIENT_LL_HANDLE client_handle;
+    AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device;
 } AMQP_TRANSPORT_DEVICE_TWIN_CONTEXT;
 
 
@@ -211,6 +250,74 @@ static void reset_retry_control(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_devic
 }
 
 
+// ---------- Device Do Work Queue Helpers ---------- //
+
+static void append_device_to_queue(AMQP_TRANSPORT_DEVICE_QUEUE* queue, AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    registered_device->do_work_queue = queue;
+    registered_device->previous_in_queue = queue->tail;
+    registered_device->next_in_queue = NULL;
+
+    if (queue->tail == NULL)
+    {
+        queue->head = registered_device;
+    }
+    else
+    {
+        queue->tail->next_in_queue = registered_device;
+    }
+
+    queue->tail = registered_device;
+}
+
+static void remove_device_from_queue(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    AMQP_TRANSPORT_DEVICE_QUEUE* queue = registered_device->do_work_queue;
+
+    if (queue != NULL)
+    {
+        if (registered_device->previous_in_queue == NULL)
+        {
+            queue->head = registered_device->next_in_queue;
+        }
+        else
+        {
+            registered_device->previous_in_queue->next_in_queue = registered_device->next_in_queue;
+        }
+
+        if (registered_device->next_in_queue == NULL)
+        {
+            queue->tail = registered_device->previous_in_queue;
+        }
+        else
+        {
+            registered_device->next_in_queue->previous_in_queue = registered_device->previous_in_queue;
+        }
+
+        registered_device->do_work_queue = NULL;
+        registered_device->previous_in_queue = NULL;
+        registered_device->next_in_queue = NULL;
+    }
+}
+
+// @brief
+//     Flags that a registered device needs a device-specific do_work, moving it to the ready list if it is idle.
+// @remarks
+//     A device DoWork is processing is not on any list; the flag alone keeps it on the ready list afterwards.
+static void request_device_do_work(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    AMQP_TRANSPORT_INSTANCE* transport_instance = registered_device->transport_instance;
+
+    registered_device->is_do_work_requested = true;
+
+    if (registered_device->do_work_queue == &transport_instance->idle_devices)
+    {
+        remove_device_from_queue(registered_device);
+        append_device_to_queue(&transport_instance->ready_devices, registered_device);
+    }
+}
+
+
 // ---------- Register/Unregister Helpers ---------- //
 
 static void internal_destroy_amqp_device_instance(AMQP_TRANSPORT_DEVICE_INSTANCE *trdev_inst)
@@ -275,6 +382,8 @@ static void on_device_state_changed_callback(void* context, DEVICE_STATE previou
         registered_device->device_state = new_state;
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_063: [If `registered_device->time_of_last_state_change` shall be set using get_time()]
         registered_device->time_of_last_state_change = get_time(NULL);
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_156: [A device-specific do_work shall be requested for `registered_device`]
+        request_device_do_work(registered_device);
 
         if (new_state == DEVICE_STATE_STARTED)
         {
@@ -312,65 +421,92 @@ static void on_device_state_changed_callback(void* context, DEVICE_STATE previou
     }
 }
 
-// @brief    Auxiliary function to be used to find a device in the registered_devices list.
-// @returns  true if the device ids match, false otherwise.
-static bool find_device_by_id_callback(LIST_ITEM_HANDLE list_item, const void* match_context)
+// @brief    Hashes a device id (FNV-1a) for the transport device index; also handed to the device to spread its SAS token refreshes.
+static size_t get_device_id_hash(const char* device_id)
 {
-    bool result;
+    size_t result = 2166136261u;
 
-    if (match_context == NULL)
+    while (*device_id != '\0')
     {
-        result = false;
+        result = (result ^ (unsigned char)(*device_id)) * 16777619u;
+        device_id++;
     }
-    else
+
+    return result;
+}
+
+// @brief       Looks up a registered device by id using the transport device index.
+// @returns     The registered device instance if found, NULL otherwise.
+static AMQP_TRANSPORT_DEVICE_INSTANCE* find_registered_device_by_id(AMQP_TRANSPORT_INSTANCE* transport, const char* device_id)
+{
+    size_t device_id_hash = get_device_id_hash(device_id);
+    AMQP_TRANSPORT_DEVICE_INSTANCE* result = transport->device_index[device_id_hash % DEVICE_INDEX_BUCKET_COUNT];
+
+    while (result != NULL)
     {
-        AMQP_TRANSPORT_DEVICE_INSTANCE* device_instance = (AMQP_TRANSPORT_DEVICE_INSTANCE*)singlylinkedlist_item_get_value(list_item);
+        const char* registered_device_id;
 
-        if (device_instance == NULL || 
-            device_instance->device_id == NULL || 
-            STRING_c_str(device_instance->device_id) != match_context)
+        if (result->device_id_hash == device_id_hash &&
+            (registered_device_id = STRING_c_str(result->device_id)) != NULL &&
+            strcmp(registered_device_id, device_id) == 0)
         {
-            result = false;
-        }
-        else
-        {
-            result = true;
+            break;
         }
+
+        result = result->next_in_device_index;
     }
 
     return result;
 }
 
-// @brief       Verifies if a device is already registered within the transport that owns the list of registered devices.
-// @remarks     Returns the correspoding LIST_ITEM_HANDLE in registered_devices, if found.
-// @returns     true if the device is already in the list, false otherwise.
-static bool is_device_registered_ex(SINGLYLINKEDLIST_HANDLE registered_devices, const char* device_id, LIST_ITEM_HANDLE *list_item)
+// @brief       Verifies if a device instance is in the transport device index under the given device id.
+// @returns     true if the device is registered, false otherwise.
+static bool is_device_registered_ex(AMQP_TRANSPORT_INSTANCE* transport, const char* device_id, AMQP_TRANSPORT_DEVICE_INSTANCE* amqp_device_instance)
 {
-    return ((*list_item = singlylinkedlist_find(registered_devices, find_device_by_id_callback, device_id)) != NULL ? 1 : 0);
+    size_t device_id_hash = get_device_id_hash(device_id);
+    AMQP_TRANSPORT_DEVICE_INSTANCE* indexed_device = transport->device_index[device_id_hash % DEVICE_INDEX_BUCKET_COUNT];
+
+    while (indexed_device != NULL && indexed_device != amqp_device_instance)
+    {
+        indexed_device = indexed_device->next_in_device_index;
+    }
+
+    return (indexed_device != NULL && indexed_device->device_id_hash == device_id_hash);
 }
 
 // @brief       Verifies if a device is already registered within the transport that owns the list of registered devices.
 // @returns     true if the device is already in the list, false otherwise.
 static bool is_device_registered(AMQP_TRANSPORT_DEVICE_INSTANCE* amqp_device_instance)
 {
-    LIST_ITEM_HANDLE list_item;
     const char* device_id = STRING_c_str(amqp_device_instance->device_id);
-    return is_device_registered_ex(amqp_device_instance->transport_instance->registered_devices, device_id, &list_item);
+    return (device_id != NULL && is_device_registered_ex(amqp_device_instance->transport_instance, device_id, amqp_device_instance));
 }
 
-static size_t get_number_of_registered_devices(AMQP_TRANSPORT_INSTANCE* transport)
+static void add_device_to_index(AMQP_TRANSPORT_INSTANCE* transport, AMQP_TRANSPORT_DEVICE_INSTANCE* amqp_device_instance)
 {
-    size_t result = 0;
+    size_t bucket = amqp_device_instance->device_id_hash % DEVICE_INDEX_BUCKET_COUNT;
 
-    LIST_ITEM_HANDLE list_item = singlylinkedlist_get_head_item(transport->registered_devices);
+    amqp_device_instance->next_in_device_index = transport->device_index[bucket];
+    transport->device_index[bucket] = amqp_device_instance;
+    transport->number_of_registered_devices++;
+}
 
-    while (list_item != NULL)
+static void remove_device_from_index(AMQP_TRANSPORT_INSTANCE* transport, AMQP_TRANSPORT_DEVICE_INSTANCE* amqp_device_instance)
+{
+    AMQP_TRANSPORT_DEVICE_INSTANCE** indexed_device = &transport->device_index[amqp_device_instance->device_id_hash % DEVICE_INDEX_BUCKET_COUNT];
+
+    while (*indexed_device != NULL)
     {
-        result++;
-        list_item = singlylinkedlist_get_next_item(list_item);
-    }
+        if (*indexed_device == amqp_device_instance)
+        {
+            *indexed_device = amqp_device_instance->next_in_device_index;
+            amqp_device_instance->next_in_device_index = NULL;
+            transport->number_of_registered_devices--;
+            break;
+        }
 
-    return result;
+        indexed_device = &(*indexed_device)->next_in_device_index;
+    }
 }
 
 
@@ -460,6 +596,9 @@ static DEVICE_MESSAGE_DISPOSITION_RESULT on_message_received(IOTHUB_MESSAGE_HAND
     DEVICE_MESSAGE_DISPOSITION_RESULT device_disposition_result;
     MESSAGE_CALLBACK_INFO* message_data;
 
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_178: [Completions and inbound traffic reported for a registered device shall request a device-specific do_work for it]
+    request_device_do_work(amqp_device_instance);
+
     if ((message_data = MESSAGE_CALLBACK_INFO_Create(message, disposition_info, amqp_device_instance)) == NULL)
     {
         LogError("Failed processing message received (failed to assemble callback info)");
@@ -499,6 +638,7 @@ static void on_methods_unsubscribed(void* context)
 
     iothubtransportamqp_methods_unsubscribe(device_state->methods_handle);
     device_state->subscribed_for_methods = false;
+    request_device_do_work(device_state);
 }
 
 static int on_method_request_received(void* context, const char* method_name, const unsigned char* request, size_t request_size, IOTHUBTRANSPORT_AMQP_METHOD_HANDLE method_handle)
@@ -506,6 +646,8 @@ static int on_method_request_received(void* context, const char* method_name, co
     int result;
     AMQP_TRANSPORT_DEVICE_INSTANCE* device_state = (AMQP_TRANSPORT_DEVICE_INSTANCE*)context;
 
+    request_device_do_work(device_state);
+
     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_01_017: [ `on_methods_request_received` shall call the `IoTHubClient_LL_DeviceMethodComplete` passing the method name, request buffer and size and the newly created BUFFER handle. ]*/
     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_01_022: [ The status code shall be the return value of the call to `IoTHubClient_LL_DeviceMethodComplete`. ]*/
     if (IoTHubClient_LL_DeviceMethodComplete(device_state->iothub_client_handle, method_name, request, request_size, (void*)method_handle) != 0)
@@ -520,6 +662,35 @@ static int on_method_request_received(void* context, const char* method_name, co
     return result;
 }
 
+// @brief
+//     Gets the index of the AMQP session of the current connection a registered device is on.
+// @remarks
+//     `amqp_session_count` can be changed by SetOption at any time, so the number of sessions the current connection actually has is used.
+static size_t get_device_session_index(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    AMQP_TRANSPORT_INSTANCE* transport_instance = registered_device->transport_instance;
+
+    return (transport_instance->amqp_connection_session_count > 1 ? registered_device->device_id_hash % transport_instance->amqp_connection_session_count : 0);
+}
+
+static int get_device_session_handle(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device, SESSION_HANDLE* session_handle)
+{
+    int result;
+    AMQP_TRANSPORT_INSTANCE* transport_instance = registered_device->transport_instance;
+
+    if (transport_instance->amqp_connection_session_count > 1)
+    {
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_161: [If the AMQP connection was created with more than 1 session, the session of a registered device shall be obtained using amqp_connection_get_session_handle_by_index(), passing the hash of the device id modulo the number of sessions the connection was created with]
+        result = amqp_connection_get_session_handle_by_index(transport_instance->amqp_connection, get_device_session_index(registered_device), session_handle);
+    }
+    else
+    {
+        result = amqp_connection_get_session_handle(transport_instance->amqp_connection, session_handle);
+    }
+
+    return result;
+}
+
 static int subscribe_methods(AMQP_TRANSPORT_DEVICE_INSTANCE* deviceState)
 {
     int result;
@@ -532,7 +703,7 @@ static int subscribe_methods(AMQP_TRANSPORT_DEVICE_INSTANCE* deviceState)
     {
         SESSION_HANDLE session_handle;
 
-        if ((amqp_connection_get_session_handle(deviceState->transport_instance->amqp_connection, &session_handle)) != RESULT_OK)
+        if (get_device_session_handle(deviceState, &session_handle) != RESULT_OK)
         {
             LogError("Device '%s' failed subscribing for methods (failed getting session handle)", STRING_c_str(deviceState->device_id));
             result = __FAILURE__;
@@ -567,6 +738,16 @@ static void on_device_send_twin_update_complete_callback(DEVICE_TWIN_UPDATE_RESU
     {
         AMQP_TRANSPORT_DEVICE_TWIN_CONTEXT* dev_twin_ctx = (AMQP_TRANSPORT_DEVICE_TWIN_CONTEXT*)context;
 
+        if (dev_twin_ctx->registered_device != NULL)
+        {
+            if (dev_twin_ctx->registered_device->number_of_pending_operations > 0)
+            {
+                dev_twin_ctx->registered_device->number_of_pending_operations--;
+            }
+
+            request_device_do_work(dev_twin_ctx->registered_device);
+        }
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_152: [`IoTHubClient_LL_ReportedStateComplete` shall be invoked passing `status_code` and `context` details]
         IoTHubClient_LL_ReportedStateComplete(dev_twin_ctx->client_handle, dev_twin_ctx->item_id, status_code);
 
@@ -586,6 +767,8 @@ static void on_device_twin_update_received_callback(DEVICE_TWIN_UPDATE_TYPE upda
     {
         AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = (AMQP_TRANSPORT_DEVICE_INSTANCE*)context;
 
+        request_device_do_work(registered_device);
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_138: [If `update_type` is DEVICE_TWIN_UPDATE_TYPE_PARTIAL IoTHubClient_LL_RetrievePropertyComplete shall be invoked passing `context` as handle, `DEVICE_TWIN_UPDATE_PARTIAL`, `payload` and `size`.]
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_139: [If `update_type` is DEVICE_TWIN_UPDATE_TYPE_COMPLETE IoTHubClient_LL_RetrievePropertyComplete shall be invoked passing `context` as handle, `DEVICE_TWIN_UPDATE_COMPLETE`, `payload` and `size`.]
         IoTHubClient_LL_RetrievePropertyComplete(
@@ -807,6 +990,8 @@ static int establish_amqp_connection(AMQP_TRANSPORT_INSTANCE* transport_instance
         amqp_connection_config.svc2cl_keep_alive_timeout_secs = transport_instance->svc2cl_keep_alive_timeout_secs;
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_99_001: [AMQP connection will be configured using the `remote_idle_timeout_ratio` value from SetOption ]
         amqp_connection_config.cl2svc_keep_alive_send_ratio = transport_instance->cl2svc_keep_alive_send_ratio;
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_160: [`instance->amqp_session_count` shall be set into `AMQP_CONNECTION_CONFIG->session_count`]
+        amqp_connection_config.session_count = transport_instance->amqp_session_count;
         
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_027: [If `transport->preferred_authentication_method` is CBS, AMQP_CONNECTION_CONFIG shall be set with `create_sasl_io` = true and `create_cbs_connection` = true]
         if (transport_instance->preferred_authentication_mode == AMQP_TRANSPORT_AUTHENTICATION_MODE_CBS)
@@ -843,6 +1028,7 @@ static int establish_amqp_connection(AMQP_TRANSPORT_INSTANCE* transport_instance
         else
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_110: [If amqp_connection_create() succeeds, IoTHubTransport_AMQP_Common_DoWork shall proceed to invoke amqp_connection_do_work]
+            transport_instance->amqp_connection_session_count = amqp_connection_config.session_count;
             result = RESULT_OK;
         }
     }
@@ -867,6 +1053,7 @@ static void prepare_device_for_connection_retry(AMQP_TRANSPORT_DEVICE_INSTANCE*
 
     registered_device->number_of_previous_failures = 0;
     registered_device->number_of_send_event_complete_failures = 0;
+    request_device_do_work(registered_device);
 }
 
 static void prepare_for_connection_retry(AMQP_TRANSPORT_INSTANCE* transport_instance)
@@ -908,6 +1095,53 @@ static void prepare_for_connection_retry(AMQP_TRANSPORT_INSTANCE* transport_inst
     update_state(transport_instance, AMQP_TRANSPORT_STATE_READY_FOR_RECONNECTION);
 }
 
+// @brief
+//     Recovers from a critical failure of a registered device by resetting only the AMQP session it is on, if possible.
+// @remarks
+//     The first session hosts the CBS link and every session shares the same TLS connection, so failures
+//     on the first session (or on a connection with a single session) still trigger the connection retry logic.
+static void prepare_device_session_for_retry(AMQP_TRANSPORT_INSTANCE* transport_instance, AMQP_TRANSPORT_DEVICE_INSTANCE* failed_device)
+{
+    size_t session_index = get_device_session_index(failed_device);
+
+    if (session_index == 0)
+    {
+        update_state(transport_instance, AMQP_TRANSPORT_STATE_RECONNECTION_REQUIRED);
+    }
+    else
+    {
+        LIST_ITEM_HANDLE list_item = singlylinkedlist_get_head_item(transport_instance->registered_devices);
+
+        LogInfo("Resetting AMQP session %lu after a critical failure of device '%s'", (unsigned long)session_index, STRING_c_str(failed_device->device_id));
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_179: [If the failed device is not on the first AMQP session, only the registered devices on the same session shall be prepared for connection retry]
+        while (list_item != NULL)
+        {
+            AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = (AMQP_TRANSPORT_DEVICE_INSTANCE*)singlylinkedlist_item_get_value(list_item);
+
+            if (registered_device == NULL)
+            {
+                LogError("Failed preparing device for session reset (singlylinkedlist_item_get_value failed)");
+            }
+            else if (get_device_session_index(registered_device) == session_index)
+            {
+                prepare_device_for_connection_retry(registered_device);
+            }
+
+            list_item = singlylinkedlist_get_next_item(list_item);
+        }
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_180: [The session of the failed device shall then be reset using amqp_connection_reset_session_by_index()]
+        if (amqp_connection_reset_session_by_index(transport_instance->amqp_connection, session_index) != RESULT_OK)
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_181: [If amqp_connection_reset_session_by_index() fails, the connection retry logic shall be triggered]
+            LogError("Failed resetting AMQP session %lu; connection retry will be triggered.", (unsigned long)session_index);
+
+            update_state(transport_instance, AMQP_TRANSPORT_STATE_RECONNECTION_REQUIRED);
+        }
+    }
+}
+
 
 // @brief    Verifies if the crendentials used by the device match the requirements and authentication mode currently supported by the transport.
 // @returns  true if credentials are good, false otherwise.
@@ -1000,6 +1234,11 @@ static void on_event_send_complete(IOTHUB_MESSAGE_LIST* message, D2C_EVENT_SEND_
 {
     AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = (AMQP_TRANSPORT_DEVICE_INSTANCE*)context;
 
+    if (registered_device->number_of_pending_operations > 0)
+    {
+        registered_device->number_of_pending_operations--;
+    }
+
     if (result != D2C_EVENT_SEND_COMPLETE_RESULT_OK && result != D2C_EVENT_SEND_COMPLETE_RESULT_DEVICE_DESTROYED)
     {
         registered_device->number_of_send_event_complete_failures++;
@@ -1009,6 +1248,9 @@ static void on_event_send_complete(IOTHUB_MESSAGE_LIST* message, D2C_EVENT_SEND_
         registered_device->number_of_send_event_complete_failures = 0;
     }
 
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_178: [Completions and inbound traffic reported for a registered device shall request a device-specific do_work for it]
+    request_device_do_work(registered_device);
+
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_056: [If `message->callback` is not NULL, it shall invoked with the `iothub_send_result`]
     if (message->callback != NULL)
     {
@@ -1043,6 +1285,9 @@ static int send_pending_events(AMQP_TRANSPORT_DEVICE_INSTANCE* device_state)
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_047: [If the registered device is started, each event on `registered_device->wait_to_send_list` shall be removed from the list and sent using device_send_event_async()]
     while ((message = get_next_event_to_send(device_state)) != NULL)
     {
+        // Counted before sending, as on_event_send_complete is invoked (and discounts it) on failures as well.
+        device_state->number_of_pending_operations++;
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_048: [device_send_event_async() shall be invoked passing `on_event_send_complete`]
         if (device_send_event_async(device_state->device_handle, message, on_event_send_complete, device_state) != RESULT_OK)
         {
@@ -1068,6 +1313,9 @@ static int IoTHubTransport_AMQP_Common_Device_DoWork(AMQP_TRANSPORT_DEVICE_INSTA
 {
     int result;
 
+    // Cleared before doing work, so anything requested while processing gets its own pass.
+    registered_device->is_do_work_requested = false;
+
     if (registered_device->device_state != DEVICE_STATE_STARTED)
     {
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_036: [If the device state is DEVICE_STATE_STOPPED, it shall be started]
@@ -1077,7 +1325,7 @@ static int IoTHubTransport_AMQP_Common_Device_DoWork(AMQP_TRANSPORT_DEVICE_INSTA
             CBS_HANDLE cbs_handle = NULL;
 
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_039: [amqp_connection_get_session_handle() shall be invoked on `instance->connection`]
-            if (amqp_connection_get_session_handle(registered_device->transport_instance->amqp_connection, &session_handle) != RESULT_OK)
+            if (get_device_session_handle(registered_device, &session_handle) != RESULT_OK)
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_040: [If amqp_connection_get_session_handle() fails, IoTHubTransport_AMQP_Common_DoWork shall fail and return]
                 LogError("Failed performing DoWork for device '%s' (failed to get the amqp_connection session_handle)", STRING_c_str(registered_device->device_id));
@@ -1181,6 +1429,118 @@ static int IoTHubTransport_AMQP_Common_Device_DoWork(AMQP_TRANSPORT_DEVICE_INSTA
 }
 
 
+// @brief
+//     Flags a C2D or twin (un)subscription of a registered device, which device_handle only completes over several do_work passes.
+static void set_device_subscription_change_pending(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    registered_device->is_subscription_change_pending = true;
+    registered_device->time_of_last_subscription_change = INDEFINITE_TIME;
+    request_device_do_work(registered_device);
+}
+
+// @brief
+//     Verifies if a C2D or twin (un)subscription of a registered device may still be attaching or detaching its links.
+//     The change is considered complete after `max_state_change_timeout_secs`, by when device_handle has either finished it or reported a failure.
+// @returns
+//     true if the subscription change is still pending, false otherwise.
+static bool is_device_subscription_change_pending(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    bool result;
+    AMQP_TRANSPORT_INSTANCE* transport_instance = registered_device->transport_instance;
+
+    if (!registered_device->is_subscription_change_pending)
+    {
+        result = false;
+    }
+    else if (registered_device->time_of_last_subscription_change == INDEFINITE_TIME)
+    {
+        registered_device->time_of_last_subscription_change = transport_instance->time_of_current_do_work;
+        result = true;
+    }
+    else if (get_difftime(transport_instance->time_of_current_do_work, registered_device->time_of_last_subscription_change) < registered_device->max_state_change_timeout_secs)
+    {
+        result = true;
+    }
+    else
+    {
+        registered_device->is_subscription_change_pending = false;
+        result = false;
+    }
+
+    return result;
+}
+
+// @brief
+//     Verifies if a registered device has nothing for IoTHubTransport_AMQP_Common_Device_DoWork to do (started, no pending events, subscriptions or requests).
+// @returns
+//     true if the device is idle, false otherwise.
+static bool is_device_idle(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device)
+{
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_167: [Registered devices with a C2D or twin subscription change requested in the last `max_state_change_timeout_secs` shall not be considered idle]
+    return (registered_device->device_state == DEVICE_STATE_STARTED &&
+        !registered_device->is_do_work_requested &&
+        registered_device->number_of_pending_operations == 0 &&
+        (!registered_device->subscribe_methods_needed || registered_device->subscribed_for_methods) &&
+        DList_IsListEmpty(registered_device->waiting_to_send) &&
+        !is_device_subscription_change_pending(registered_device));
+}
+
+// @brief
+//     Verifies if an idle device is due its periodic do_work (so SAS token refresh and timeouts are still tracked).
+// @returns
+//     true if the device shall be processed on this DoWork pass, false otherwise.
+static bool is_idle_device_do_work_due(AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device, time_t current_time)
+{
+    bool result;
+
+    if (current_time == INDEFINITE_TIME)
+    {
+        result = true;
+    }
+    else
+    {
+        double seconds_since_last_do_work = get_difftime(current_time, registered_device->time_of_last_do_work);
+
+        // A negative value means the clock was set back; the device is processed rather than left waiting for the old time.
+        result = (seconds_since_last_do_work >= IDLE_DEVICE_DO_WORK_INTERVAL_SECS || seconds_since_last_do_work < 0);
+    }
+
+    return result;
+}
+
+// @brief
+//     Moves the idle devices whose periodic do_work is due to the transport ready list.
+// @remarks
+//     `idle_devices` is kept in the order the devices became idle, so it is only scanned up to the first device that is not due.
+//     Devices that became idle on the same DoWork pass are due together, so their time is only compared once.
+static void wake_due_idle_devices(AMQP_TRANSPORT_INSTANCE* transport_instance)
+{
+    AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = transport_instance->idle_devices.head;
+    time_t time_of_last_do_work = INDEFINITE_TIME;
+    bool is_due = false;
+
+    while (registered_device != NULL)
+    {
+        if (!is_due || registered_device->time_of_last_do_work != time_of_last_do_work)
+        {
+            time_of_last_do_work = registered_device->time_of_last_do_work;
+            is_due = is_idle_device_do_work_due(registered_device, transport_instance->time_of_current_do_work);
+        }
+
+        if (is_due)
+        {
+            remove_device_from_queue(registered_device);
+            append_device_to_queue(&transport_instance->ready_devices, registered_device);
+            registered_device = transport_instance->idle_devices.head;
+        }
+        else
+        {
+            registered_device = NULL;
+        }
+    }
+}
+
+
 //---------- SetOption-ish Helpers ----------//
 
 // @brief
@@ -1199,6 +1559,42 @@ static int replicate_device_options_to(AMQP_TRANSPORT_DEVICE_INSTANCE* dev_insta
         LogError("Failed to apply option DEVICE_OPTION_EVENT_SEND_TIMEOUT_SECS to device '%s' (device_set_option failed)", STRING_c_str(dev_instance->device_id));
         result = __FAILURE__;
     }
+    else if (dev_instance->transport_instance->is_option_event_batching_set &&
+        device_set_option(
+            dev_instance->device_handle,
+            DEVICE_OPTION_EVENT_BATCHING,
+            &dev_instance->transport_instance->option_event_batching) != RESULT_OK)
+    {
+        LogError("Failed to apply option DEVICE_OPTION_EVENT_BATCHING to device '%s' (device_set_option failed)", STRING_c_str(dev_instance->device_id));
+        result = __FAILURE__;
+    }
+    else if (dev_instance->transport_instance->is_option_event_sender_links_set &&
+        device_set_option(
+            dev_instance->device_handle,
+            DEVICE_OPTION_EVENT_SENDER_LINKS,
+            &dev_instance->transport_instance->option_event_sender_links) != RESULT_OK)
+    {
+        LogError("Failed to apply option DEVICE_OPTION_EVENT_SENDER_LINKS to device '%s' (device_set_option failed)", STRING_c_str(dev_instance->device_id));
+        result = __FAILURE__;
+    }
+    else if (dev_instance->transport_instance->is_option_twin_reported_state_coalesce_secs_set &&
+        device_set_option(
+            dev_instance->device_handle,
+            DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS,
+            &dev_instance->transport_instance->option_twin_reported_state_coalesce_secs) != RESULT_OK)
+    {
+        LogError("Failed to apply option DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS to device '%s' (device_set_option failed)", STRING_c_str(dev_instance->device_id));
+        result = __FAILURE__;
+    }
+    else if (dev_instance->transport_instance->is_option_c2d_prefetch_set &&
+        device_set_option(
+            dev_instance->device_handle,
+            DEVICE_OPTION_C2D_PREFETCH,
+            &dev_instance->transport_instance->option_c2d_prefetch) != RESULT_OK)
+    {
+        LogError("Failed to apply option DEVICE_OPTION_C2D_PREFETCH to device '%s' (device_set_option failed)", STRING_c_str(dev_instance->device_id));
+        result = __FAILURE__;
+    }
     else if (auth_mode == DEVICE_AUTH_MODE_CBS)
     {
         if (device_set_option(
@@ -1260,6 +1656,22 @@ static const char* get_device_option_name_from(const char* iothubclient_option_n
     {
         device_option_name = DEVICE_OPTION_EVENT_SEND_TIMEOUT_SECS;
     }
+    else if (strcmp(OPTION_EVENT_BATCHING, iothubclient_option_name) == 0)
+    {
+        device_option_name = DEVICE_OPTION_EVENT_BATCHING;
+    }
+    else if (strcmp(OPTION_EVENT_SENDER_LINKS, iothubclient_option_name) == 0)
+    {
+        device_option_name = DEVICE_OPTION_EVENT_SENDER_LINKS;
+    }
+    else if (strcmp(OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, iothubclient_option_name) == 0)
+    {
+        device_option_name = DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS;
+    }
+    else if (strcmp(OPTION_C2D_PREFETCH, iothubclient_option_name) == 0)
+    {
+        device_option_name = DEVICE_OPTION_C2D_PREFETCH;
+    }
     else
     {
         device_option_name = NULL;
@@ -1334,6 +1746,11 @@ static void internal_destroy_instance(AMQP_TRANSPORT_INSTANCE* instance)
             singlylinkedlist_destroy(instance->registered_devices);
         }
 
+        if (instance->put_token_queue != NULL)
+        {
+            authentication_put_token_queue_destroy(instance->put_token_queue);
+        }
+
         if (instance->amqp_connection != NULL)
         {
             amqp_connection_destroy(instance->amqp_connection);
@@ -1443,6 +1860,13 @@ TRANSPORT_LL_HANDLE IoTHubTransport_AMQP_Common_Create(const IOTHUBTRANSPORT_CON
                 LogError("Failed to initialize the internal list of registered devices (singlylinkedlist_create failed)");
                 result = NULL;
             }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_168: [`instance->put_token_queue` shall be set using authentication_put_token_queue_create(), allowing MAX_CBS_PUT_TOKENS_IN_PROGRESS put-tokens in progress]
+            else if ((instance->put_token_queue = authentication_put_token_queue_create(MAX_CBS_PUT_TOKENS_IN_PROGRESS)) == NULL)
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_169: [If authentication_put_token_queue_create() fails, IoTHubTransport_AMQP_Common_Create shall fail and return NULL]
+                LogError("Failed to create the CBS put-token queue");
+                result = NULL;
+            }
             else
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_010: [`get_io_transport` shall be saved on `instance->underlying_io_transport_provider`]
@@ -1456,6 +1880,7 @@ TRANSPORT_LL_HANDLE IoTHubTransport_AMQP_Common_Create(const IOTHUBTRANSPORT_CON
                 instance->svc2cl_keep_alive_timeout_secs = DEFAULT_SERVICE_KEEP_ALIVE_FREQ_SECS;
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_99_001: [The remote idle timeout ratio shall be set to 0.5 using connection_set_remote_idle_timeout_empty_frame_send_ratio()]
                 instance->cl2svc_keep_alive_send_ratio = DEFAULT_REMOTE_IDLE_PING_RATIO;
+                instance->amqp_session_count = DEFAULT_AMQP_SESSION_COUNT;
 
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_012: [If IoTHubTransport_AMQP_Common_Create succeeds it shall return a pointer to `instance`.]
                 result = (TRANSPORT_LL_HANDLE)instance;
@@ -1499,6 +1924,8 @@ IOTHUB_PROCESS_ITEM_RESULT IoTHubTransport_AMQP_Common_ProcessItem(TRANSPORT_LL_
 
                 dev_twin_ctx->client_handle = iothub_item->device_twin->client_handle;
                 dev_twin_ctx->item_id = iothub_item->device_twin->item_id;
+                dev_twin_ctx->registered_device = registered_device;
+                registered_device->number_of_pending_operations++;
 
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_146: [device_send_twin_update_async() shall be invoked passing `iothub_item->device_twin->report_data_handle` and `on_device_send_twin_update_complete_callback`]
                 if (device_send_twin_update_async(
@@ -1508,11 +1935,14 @@ IOTHUB_PROCESS_ITEM_RESULT IoTHubTransport_AMQP_Common_ProcessItem(TRANSPORT_LL_
                 {
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_147: [If device_send_twin_update_async() fails, `IoTHubTransport_AMQP_Common_ProcessItem` shall fail and return IOTHUB_PROCESS_ERROR.]
                     LogError("Failed sending TWIN update");
+                    registered_device->number_of_pending_operations--;
                     free(dev_twin_ctx);
                     result = IOTHUB_PROCESS_ERROR;
                 }
                 else
                 {
+                    request_device_do_work(registered_device);
+
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_150: [If no errors occur, `IoTHubTransport_AMQP_Common_ProcessItem` shall return IOTHUB_PROCESS_OK.]
                     result = IOTHUB_PROCESS_OK;
                 }
@@ -1541,7 +1971,6 @@ void IoTHubTransport_AMQP_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
     else
     {
         AMQP_TRANSPORT_INSTANCE* transport_instance = (AMQP_TRANSPORT_INSTANCE*)handle;
-        LIST_ITEM_HANDLE list_item;
 
         if (transport_instance->state == AMQP_TRANSPORT_STATE_NOT_CONNECTED_NO_MORE_RETRIES)
         {
@@ -1573,7 +2002,7 @@ void IoTHubTransport_AMQP_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
         else
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_018: [If there are no devices registered on the transport, IoTHubTransport_AMQP_Common_DoWork shall skip do_work for devices]
-            if ((list_item = singlylinkedlist_get_head_item(transport_instance->registered_devices)) != NULL)
+            if (singlylinkedlist_get_head_item(transport_instance->registered_devices) != NULL)
             {
                 // We need to check if there are devices, otherwise the amqp_connection won't be able to be created since
                 // there is not a preferred authentication mode set yet on the transport.
@@ -1586,35 +2015,65 @@ void IoTHubTransport_AMQP_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
 
                     update_state(transport_instance, AMQP_TRANSPORT_STATE_RECONNECTION_REQUIRED);
                 }
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_020: [If the amqp_connection is OPENED, the transport shall iterate through each registered device and perform a device-specific do_work on each]
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_020: [If the amqp_connection is OPENED, the transport shall perform a device-specific do_work on each registered device on its ready list]
                 else if (transport_instance->amqp_connection_state == AMQP_CONNECTION_STATE_OPENED)
                 {
-                    while (list_item != NULL)
+                    AMQP_TRANSPORT_DEVICE_INSTANCE* last_ready_device;
+                    bool is_last_ready_device_processed;
+
+                    if ((transport_instance->time_of_current_do_work = get_time(NULL)) == INDEFINITE_TIME)
                     {
-                        AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device;
+                        LogError("Failed getting the current time; all idle devices will be processed on this DoWork pass");
+                    }
 
-                        if ((registered_device = (AMQP_TRANSPORT_DEVICE_INSTANCE*)singlylinkedlist_item_get_value(list_item)) == NULL)
-                        {
-                            LogError("Transport had an unexpected failure during DoWork (failed to fetch a registered_devices list item value)");
-                        }
-                        else if (registered_device->number_of_send_event_complete_failures >= MAX_NUMBER_OF_DEVICE_FAILURES)
+                    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_173: [Idle registered devices processed IDLE_DEVICE_DO_WORK_INTERVAL_SECS or more ago shall be moved to the transport ready list]
+                    wake_due_idle_devices(transport_instance);
+
+                    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_174: [Only the registered devices on the transport ready list when the DoWork pass starts shall be processed]
+                    last_ready_device = transport_instance->ready_devices.tail;
+                    is_last_ready_device_processed = (last_ready_device == NULL);
+
+                    while (!is_last_ready_device_processed)
+                    {
+                        AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = transport_instance->ready_devices.head;
+
+                        is_last_ready_device_processed = (registered_device == last_ready_device);
+                        remove_device_from_queue(registered_device);
+
+                        if (registered_device->number_of_send_event_complete_failures >= MAX_NUMBER_OF_DEVICE_FAILURES)
                         {
-                            LogError("Device '%s' reported a critical failure (events completed sending with failures); connection retry will be triggered.", STRING_c_str(registered_device->device_id));
+                            LogError("Device '%s' reported a critical failure (events completed sending with failures); its session or connection will be retried.", STRING_c_str(registered_device->device_id));
 
-                            update_state(transport_instance, AMQP_TRANSPORT_STATE_RECONNECTION_REQUIRED);
+                            prepare_device_session_for_retry(transport_instance, registered_device);
                         }
                         else if (IoTHubTransport_AMQP_Common_Device_DoWork(registered_device) != RESULT_OK)
                         {
-                            // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_021: [If DoWork fails for the registered device for more than MAX_NUMBER_OF_DEVICE_FAILURES, connection retry shall be triggered]
+                            // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_021: [If DoWork fails for the registered device for more than MAX_NUMBER_OF_DEVICE_FAILURES, the AMQP session of the device shall be retried, or the connection if the device is on the first session]
                             if (registered_device->number_of_previous_failures >= MAX_NUMBER_OF_DEVICE_FAILURES)
                             {
-                                LogError("Device '%s' reported a critical failure; connection retry will be triggered.", STRING_c_str(registered_device->device_id));
+                                LogError("Device '%s' reported a critical failure; its session or connection will be retried.", STRING_c_str(registered_device->device_id));
 
-                                update_state(transport_instance, AMQP_TRANSPORT_STATE_RECONNECTION_REQUIRED);
+                                prepare_device_session_for_retry(transport_instance, registered_device);
                             }
                         }
 
-                        list_item = singlylinkedlist_get_next_item(list_item);
+                        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_159: [Registered devices that are started and have no pending events, subscriptions or requests shall be moved to the transport idle list, and only processed again after IDLE_DEVICE_DO_WORK_INTERVAL_SECS or once a do_work is requested for them]
+                        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_175: [Any other registered device processed shall be added back to the end of the transport ready list]
+                        if (is_device_idle(registered_device))
+                        {
+                            registered_device->time_of_last_do_work = transport_instance->time_of_current_do_work;
+                            append_device_to_queue(&transport_instance->idle_devices, registered_device);
+                        }
+                        else
+                        {
+                            append_device_to_queue(&transport_instance->ready_devices, registered_device);
+                        }
+                    }
+
+                    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_170: [If the transport is using CBS authentication, authentication_put_token_queue_do_work() shall be invoked on `instance->put_token_queue` after the registered devices are processed]
+                    if (transport_instance->preferred_authentication_mode == AMQP_TRANSPORT_AUTHENTICATION_MODE_CBS)
+                    {
+                        authentication_put_token_queue_do_work(transport_instance->put_token_queue);
                     }
                 }
             }
@@ -1657,6 +2116,8 @@ int IoTHubTransport_AMQP_Common_Subscribe(IOTHUB_DEVICE_HANDLE handle)
         }
         else
         {
+            set_device_subscription_change_pending(amqp_device_instance);
+
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_088: [If no failures occur, IoTHubTransport_AMQP_Common_Subscribe shall return 0]
             result = RESULT_OK;
         }
@@ -1686,6 +2147,10 @@ void IoTHubTransport_AMQP_Common_Unsubscribe(IOTHUB_DEVICE_HANDLE handle)
         {
             LogError("Device '%s' failed unsubscribing to cloud-to-device messages (device_unsubscribe_message failed)", STRING_c_str(amqp_device_instance->device_id));
         }
+        else
+        {
+            set_device_subscription_change_pending(amqp_device_instance);
+        }
     }
 }
 
@@ -1703,7 +2168,7 @@ int IoTHubTransport_AMQP_Common_Subscribe_DeviceTwin(IOTHUB_DEVICE_HANDLE handle
     {
         AMQP_TRANSPORT_INSTANCE* transport = (AMQP_TRANSPORT_INSTANCE*)handle;
 
-        if (get_number_of_registered_devices(transport) != 1)
+        if (transport->number_of_registered_devices != 1)
         {
             LogError("Device Twin not supported on device multiplexing scenario");
             result = __FAILURE__;
@@ -1734,6 +2199,8 @@ int IoTHubTransport_AMQP_Common_Subscribe_DeviceTwin(IOTHUB_DEVICE_HANDLE handle
                     break;
                 }
 
+                set_device_subscription_change_pending(registered_device);
+
                 list_item = singlylinkedlist_get_next_item(list_item);
             }
         }
@@ -1753,7 +2220,7 @@ void IoTHubTransport_AMQP_Common_Unsubscribe_DeviceTwin(IOTHUB_DEVICE_HANDLE han
     {
         AMQP_TRANSPORT_INSTANCE* transport = (AMQP_TRANSPORT_INSTANCE*)handle;
 
-        if (get_number_of_registered_devices(transport) != 1)
+        if (transport->number_of_registered_devices != 1)
         {
             LogError("Device Twin not supported on device multiplexing scenario");
         }
@@ -1778,6 +2245,8 @@ void IoTHubTransport_AMQP_Common_Unsubscribe_DeviceTwin(IOTHUB_DEVICE_HANDLE han
                     break;
                 }
 
+                set_device_subscription_change_pending(registered_device);
+
                 list_item = singlylinkedlist_get_next_item(list_item);
             }
         }
@@ -1801,6 +2270,7 @@ int IoTHubTransport_AMQP_Common_Subscribe_DeviceMethod(IOTHUB_DEVICE_HANDLE hand
         /* Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_01_005: [ If the transport is already subscribed to receive C2D method requests, `IoTHubTransport_AMQP_Common_Subscribe_DeviceMethod` shall perform no additional action and return 0. ]*/
         device_state->subscribe_methods_needed = true;
         device_state->subscribed_for_methods = false;
+        request_device_do_work(device_state);
         result = 0;
     }
 
@@ -1902,6 +2372,20 @@ IOTHUB_CLIENT_RESULT IoTHubTransport_AMQP_Common_GetSendStatus(IOTHUB_DEVICE_HAN
     return result;
 }
 
+void IoTHubTransport_AMQP_Common_NotifyEventQueued(IOTHUB_DEVICE_HANDLE handle)
+{
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_176: [If `handle` is NULL, IoTHubTransport_AMQP_Common_NotifyEventQueued shall return]
+    if (handle == NULL)
+    {
+        LogError("Failed notifying event queued (handle is NULL)");
+    }
+    else
+    {
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_177: [IoTHubTransport_AMQP_Common_NotifyEventQueued shall request a device-specific do_work for the device, moving it to the transport ready list if it is idle]
+        request_device_do_work((AMQP_TRANSPORT_DEVICE_INSTANCE*)handle);
+    }
+}
+
 IOTHUB_CLIENT_RESULT IoTHubTransport_AMQP_Common_SetOption(TRANSPORT_LL_HANDLE handle, const char* option, const void* value)
 {
     IOTHUB_CLIENT_RESULT result;
@@ -1938,6 +2422,34 @@ IOTHUB_CLIENT_RESULT IoTHubTransport_AMQP_Common_SetOption(TRANSPORT_LL_HANDLE h
             is_device_specific_option = true;
             transport_instance->option_send_event_timeout_secs = *(size_t*)value;
         }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_154: [If `option` is OPTION_EVENT_BATCHING, the IOTHUB_EVENT_BATCHING_OPTIONS value shall be saved and applied to each registered device using device_set_option()]
+        else if (strcmp(OPTION_EVENT_BATCHING, option) == 0)
+        {
+            is_device_specific_option = true;
+            transport_instance->option_event_batching = *(IOTHUB_EVENT_BATCHING_OPTIONS*)value;
+            transport_instance->is_option_event_batching_set = true;
+        }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_155: [If `option` is OPTION_EVENT_SENDER_LINKS, the IOTHUB_EVENT_SENDER_LINKS_OPTIONS value shall be saved and applied to each registered device using device_set_option()]
+        else if (strcmp(OPTION_EVENT_SENDER_LINKS, option) == 0)
+        {
+            is_device_specific_option = true;
+            transport_instance->option_event_sender_links = *(IOTHUB_EVENT_SENDER_LINKS_OPTIONS*)value;
+            transport_instance->is_option_event_sender_links_set = true;
+        }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_165: [If `option` is OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, the size_t value shall be saved and applied to each registered device using device_set_option()]
+        else if (strcmp(OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, option) == 0)
+        {
+            is_device_specific_option = true;
+            transport_instance->option_twin_reported_state_coalesce_secs = *(size_t*)value;
+            transport_instance->is_option_twin_reported_state_coalesce_secs_set = true;
+        }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_166: [If `option` is OPTION_C2D_PREFETCH, the IOTHUB_C2D_PREFETCH_OPTIONS value shall be saved and applied to each registered device using device_set_option()]
+        else if (strcmp(OPTION_C2D_PREFETCH, option) == 0)
+        {
+            is_device_specific_option = true;
+            transport_instance->option_c2d_prefetch = *(IOTHUB_C2D_PREFETCH_OPTIONS*)value;
+            transport_instance->is_option_c2d_prefetch_set = true;
+        }
         else
         {
             is_device_specific_option = false;
@@ -1976,6 +2488,21 @@ IOTHUB_CLIENT_RESULT IoTHubTransport_AMQP_Common_SetOption(TRANSPORT_LL_HANDLE h
             }
             
         }
+        else if (strcmp(OPTION_AMQP_SESSION_COUNT, option) == 0)
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_162: [If `option` is `amqp_session_count` and `value` is not between 1 and 16, IoTHubTransport_AMQP_Common_SetOption shall return IOTHUB_CLIENT_INVALID_ARG]
+            if (*(size_t*)value == 0 || *(size_t*)value > MAX_AMQP_SESSION_COUNT)
+            {
+                LogError("Invalid AMQP session count %lu", (unsigned long)*(size_t*)value);
+                result = IOTHUB_CLIENT_INVALID_ARG;
+            }
+            else
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_163: [If `option` is `amqp_session_count`, `value` shall be saved on `instance->amqp_session_count` and used from the next AMQP connection]
+                transport_instance->amqp_session_count = *(size_t*)value;
+                result = IOTHUB_CLIENT_OK;
+            }
+        }
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_104: [If `option` is `logtrace`, `value` shall be saved and applied to `instance->connection` using amqp_connection_set_logging()]
         else if (strcmp(OPTION_LOG_TRACE, option) == 0)
         {
@@ -2145,11 +2672,10 @@ IOTHUB_DEVICE_HANDLE IoTHubTransport_AMQP_Common_Register(TRANSPORT_LL_HANDLE ha
     }
     else
     {
-        LIST_ITEM_HANDLE list_item;
         AMQP_TRANSPORT_INSTANCE* transport_instance = (AMQP_TRANSPORT_INSTANCE*)handle;
 
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_064: [If the device is already registered, IoTHubTransport_AMQP_Common_Register shall fail and return NULL.]
-        if (is_device_registered_ex(transport_instance->registered_devices, device->deviceId, &list_item))
+        if (find_registered_device_by_id(transport_instance, device->deviceId) != NULL)
         {
             LogError("IoTHubTransport_AMQP_Common_Register failed (device '%s' already registered on this transport instance)", device->deviceId);
             result = NULL;
@@ -2206,8 +2732,11 @@ IOTHUB_DEVICE_HANDLE IoTHubTransport_AMQP_Common_Register(TRANSPORT_LL_HANDLE ha
                 {
                     DEVICE_CONFIG device_config;
                     memset(&device_config, 0, sizeof(DEVICE_CONFIG));
+                    amqp_device_instance->device_id_hash = get_device_id_hash(device->deviceId);
                     device_config.iothub_host_fqdn = (char*)STRING_c_str(transport_instance->iothub_host_fqdn);
                     device_config.authorization_module = device->authorization_module;
+                    device_config.device_id_hash = amqp_device_instance->device_id_hash;
+                    device_config.put_token_queue = transport_instance->put_token_queue;
 
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_072: [The configuration for device_create shall be set according to the authentication preferred by IOTHUB_DEVICE_CONFIG]
                     device_config.authentication_mode = get_authentication_mode(device);
@@ -2224,7 +2753,7 @@ IOTHUB_DEVICE_HANDLE IoTHubTransport_AMQP_Common_Register(TRANSPORT_LL_HANDLE ha
                     }
                     else
                     {
-                        bool is_first_device_being_registered = (singlylinkedlist_get_head_item(transport_instance->registered_devices) == NULL);
+                        bool is_first_device_being_registered = (transport_instance->number_of_registered_devices == 0);
 
                         /* Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_01_010: [ `IoTHubTransport_AMQP_Common_Create` shall create a new iothubtransportamqp_methods instance by calling `iothubtransportamqp_methods_create` while passing to it the the fully qualified domain name and the device Id. ]*/
                         amqp_device_instance->methods_handle = iothubtransportamqp_methods_create(STRING_c_str(transport_instance->iothub_host_fqdn), device->deviceId);
@@ -2242,7 +2771,7 @@ IOTHUB_DEVICE_HANDLE IoTHubTransport_AMQP_Common_Register(TRANSPORT_LL_HANDLE ha
                                 result = NULL;
                             }
                             // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_074: [IoTHubTransport_AMQP_Common_Register shall add the `amqp_device_instance` to `instance->registered_devices`]
-                            else if (singlylinkedlist_add(transport_instance->registered_devices, amqp_device_instance) == NULL)
+                            else if ((amqp_device_instance->list_item = singlylinkedlist_add(transport_instance->registered_devices, amqp_device_instance)) == NULL)
                             {
                                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_075: [If it fails to add `amqp_device_instance`, IoTHubTransport_AMQP_Common_Register shall fail and return NULL]
                                 LogError("Transport failed to register device '%s' (singlylinkedlist_add failed)", device->deviceId);
@@ -2250,6 +2779,13 @@ IOTHUB_DEVICE_HANDLE IoTHubTransport_AMQP_Common_Register(TRANSPORT_LL_HANDLE ha
                             }
                             else
                             {
+                                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_157: [IoTHubTransport_AMQP_Common_Register shall add the `amqp_device_instance` to the transport device index, keyed by `device->deviceId`]
+                                add_device_to_index(transport_instance, amqp_device_instance);
+
+                                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_171: [IoTHubTransport_AMQP_Common_Register shall add the `amqp_device_instance` to the transport ready list]
+                                amqp_device_instance->is_do_work_requested = true;
+                                append_device_to_queue(&transport_instance->ready_devices, amqp_device_instance);
+
                                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_076: [If the device is the first being registered on the transport, IoTHubTransport_AMQP_Common_Register shall save its authentication mode as the transport preferred authentication mode]
                                 if (transport_instance->preferred_authentication_mode == AMQP_TRANSPORT_AUTHENTICATION_MODE_NOT_SET &&
                                     is_first_device_being_registered)
@@ -2295,7 +2831,6 @@ void IoTHubTransport_AMQP_Common_Unregister(IOTHUB_DEVICE_HANDLE deviceHandle)
     {
         AMQP_TRANSPORT_DEVICE_INSTANCE* registered_device = (AMQP_TRANSPORT_DEVICE_INSTANCE*)deviceHandle;
         const char* device_id;
-        LIST_ITEM_HANDLE list_item;
 
         if ((device_id = STRING_c_str(registered_device->device_id)) == NULL)
         {
@@ -2307,19 +2842,25 @@ void IoTHubTransport_AMQP_Common_Unregister(IOTHUB_DEVICE_HANDLE deviceHandle)
             LogError("Failed to unregister device '%s' (deviceHandle does not have a transport state associated to).", device_id);
         }
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_081: [If the device is not registered with this transport, IoTHubTransport_AMQP_Common_Unregister shall return]
-        else if (!is_device_registered_ex(registered_device->transport_instance->registered_devices, device_id, &list_item))
+        else if (!is_device_registered_ex(registered_device->transport_instance, device_id, registered_device))
         {
             LogError("Failed to unregister device '%s' (device is not registered within this transport).", device_id);
         }
         else
         {
             // Removing it first so the race hazzard is reduced between this function and DoWork. Best would be to use locks.
-            if (singlylinkedlist_remove(registered_device->transport_instance->registered_devices, list_item) != RESULT_OK)
+            if (singlylinkedlist_remove(registered_device->transport_instance->registered_devices, registered_device->list_item) != RESULT_OK)
             {
                 LogError("Failed to unregister device '%s' (singlylinkedlist_remove failed).", device_id);
             }
             else
             {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_158: [`device_instance` shall be removed from the transport device index]
+                remove_device_from_index(registered_device->transport_instance, registered_device);
+
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_172: [`device_instance` shall be removed from the transport ready or idle list]
+                remove_device_from_queue(registered_device);
+
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_01_012: [IoTHubTransport_AMQP_Common_Unregister shall destroy the C2D methods handler by calling iothubtransportamqp_methods_destroy]
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_083: [IoTHubTransport_AMQP_Common_Unregister shall free all the memory allocated for the `device_instance`]
                 internal_destroy_amqp_device_instance(registered_device);
@@ -27,6 +27,8 @@ typedef struct AMQP_CONNECTION_INSTANCE_TAG
     CBS_HANDLE cbs_handle;
     CONNECTION_HANDLE connection_handle;
     SESSION_HANDLE session_handle;
+    SESSION_HANDLE* additional_session_handles;
+    size_t number_of_additional_sessions;
     XIO_HANDLE sasl_io;
     SASL_MECHANISM_HANDLE sasl_mechanism;
     bool has_cbs;
@@ -228,6 +230,21 @@ static int create_connection_handle(AMQP_CONNECTION_INSTANCE* instance)
     return result;
 }
 
+static void set_session_windows(SESSION_HANDLE session_handle)
+{
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_026: [The `instance->session_handle` incoming window size shall be set as UINT_MAX using session_set_incoming_window()]
+    if (session_set_incoming_window(session_handle, (uint32_t)DEFAULT_INCOMING_WINDOW_SIZE) != 0)
+    {
+        LogError("Failed to set the AMQP session incoming window size.");
+    }
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_027: [The `instance->session_handle` outgoing window size shall be set as 100 using session_set_outgoing_window()]
+    if (session_set_outgoing_window(session_handle, DEFAULT_OUTGOING_WINDOW_SIZE) != 0)
+    {
+        LogError("Failed to set the AMQP session outgoing window size.");
+    }
+}
+
 static int create_session_handle(AMQP_CONNECTION_INSTANCE* instance)
 {
     int result;
@@ -241,17 +258,7 @@ static int create_session_handle(AMQP_CONNECTION_INSTANCE* instance)
     }
     else
     {
-        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_026: [The `instance->session_handle` incoming window size shall be set as UINT_MAX using session_set_incoming_window()]
-        if (session_set_incoming_window(instance->session_handle, (uint32_t)DEFAULT_INCOMING_WINDOW_SIZE) != 0)
-        {
-            LogError("Failed to set the AMQP session incoming window size.");
-        }
-
-        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_027: [The `instance->session_handle` outgoing window size shall be set as 100 using session_set_outgoing_window()]
-        if (session_set_outgoing_window(instance->session_handle, DEFAULT_OUTGOING_WINDOW_SIZE) != 0)
-        {
-            LogError("Failed to set the AMQP session outgoing window size.");
-        }
+        set_session_windows(instance->session_handle);
 
         result = RESULT_OK;
     }
@@ -259,6 +266,41 @@ static int create_session_handle(AMQP_CONNECTION_INSTANCE* instance)
     return result;
 }
 
+static int create_additional_session_handles(AMQP_CONNECTION_INSTANCE* instance, size_t number_of_additional_sessions)
+{
+    int result;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_075: [If `config->session_count` is greater than 1, amqp_connection_create() shall create `config->session_count` - 1 additional sessions using session_create(), with the same window sizes as `instance->session_handle`]
+    if ((instance->additional_session_handles = (SESSION_HANDLE*)malloc(sizeof(SESSION_HANDLE) * number_of_additional_sessions)) == NULL)
+    {
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_076: [If creating any of the additional sessions fails, amqp_connection_create() shall fail and return NULL]
+        result = __FAILURE__;
+        LogError("Failed creating the additional AMQP sessions (malloc failed)");
+    }
+    else
+    {
+        result = RESULT_OK;
+
+        while (instance->number_of_additional_sessions < number_of_additional_sessions)
+        {
+            SESSION_HANDLE session_handle;
+
+            if ((session_handle = session_create(instance->connection_handle, NULL, NULL)) == NULL)
+            {
+                result = __FAILURE__;
+                LogError("Failed creating additional AMQP session %lu (session_create failed)", (unsigned long)instance->number_of_additional_sessions);
+                break;
+            }
+
+            set_session_windows(session_handle);
+
+            instance->additional_session_handles[instance->number_of_additional_sessions++] = session_handle;
+        }
+    }
+
+    return result;
+}
+
 static int create_cbs_handle(AMQP_CONNECTION_INSTANCE* instance)
 {
     int result;
@@ -301,6 +343,19 @@ void amqp_connection_destroy(AMQP_CONNECTION_HANDLE conn_handle)
             cbs_destroy(instance->cbs_handle);
         }
 
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_077: [amqp_connection_destroy() shall destroy the additional sessions using session_destroy()]
+        if (instance->additional_session_handles != NULL)
+        {
+            size_t i;
+
+            for (i = 0; i < instance->number_of_additional_sessions; i++)
+            {
+                session_destroy(instance->additional_session_handles[i]);
+            }
+
+            free(instance->additional_session_handles);
+        }
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_037: [amqp_connection_destroy() shall destroy `instance->session_handle` if set using session_destroy()]
         if (instance->session_handle != NULL)
         {
@@ -414,6 +469,11 @@ AMQP_CONNECTION_HANDLE amqp_connection_create(AMQP_CONNECTION_CONFIG* config)
                     result = NULL;
                     LogError("amqp_connection_create failed (failed creating the AMQP session)");
                 }
+                else if (config->session_count > 1 && create_additional_session_handles(instance, config->session_count - 1) != RESULT_OK)
+                {
+                    result = NULL;
+                    LogError("amqp_connection_create failed (failed creating the additional AMQP sessions)");
+                }
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_028: [Only if `config->create_cbs_connection` is true, amqp_connection_create() shall create and open the CBS_HANDLE]
                 else if (config->create_cbs_connection && create_cbs_handle(instance) != RESULT_OK)
                 {
@@ -479,6 +539,88 @@ int amqp_connection_get_session_handle(AMQP_CONNECTION_HANDLE conn_handle, SESSI
     return result;
 }
 
+int amqp_connection_get_session_handle_by_index(AMQP_CONNECTION_HANDLE conn_handle, size_t session_index, SESSION_HANDLE* session_handle)
+{
+    int result;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_078: [If `conn_handle` or `session_handle` are NULL, amqp_connection_get_session_handle_by_index() shall fail and return __FAILURE__]
+    if (conn_handle == NULL || session_handle == NULL)
+    {
+        result = __FAILURE__;
+        LogError("amqp_connection_get_session_handle_by_index failed (conn_handle=%p, session_handle=%p)", conn_handle, session_handle);
+    }
+    else
+    {
+        AMQP_CONNECTION_INSTANCE* instance = (AMQP_CONNECTION_INSTANCE*)conn_handle;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_079: [If `session_index` is not lower than the number of sessions of the connection, amqp_connection_get_session_handle_by_index() shall fail and return __FAILURE__]
+        if (session_index > instance->number_of_additional_sessions)
+        {
+            result = __FAILURE__;
+            LogError("amqp_connection_get_session_handle_by_index failed (session_index %lu is out of range)", (unsigned long)session_index);
+        }
+        else
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_080: [`session_handle` shall be set to `instance->session_handle` if `session_index` is 0, or to the additional session `session_index` - 1 otherwise]
+            *session_handle = (session_index == 0 ? instance->session_handle : instance->additional_session_handles[session_index - 1]);
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_081: [amqp_connection_get_session_handle_by_index() shall return success code 0]
+            result = RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+int amqp_connection_reset_session_by_index(AMQP_CONNECTION_HANDLE conn_handle, size_t session_index)
+{
+    int result;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_082: [If `conn_handle` is NULL, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+    if (conn_handle == NULL)
+    {
+        result = __FAILURE__;
+        LogError("amqp_connection_reset_session_by_index failed (conn_handle is NULL)");
+    }
+    else
+    {
+        AMQP_CONNECTION_INSTANCE* instance = (AMQP_CONNECTION_INSTANCE*)conn_handle;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_083: [If `session_index` is 0 or not lower than the number of sessions of the connection, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+        if (session_index == 0 || session_index > instance->number_of_additional_sessions)
+        {
+            result = __FAILURE__;
+            LogError("amqp_connection_reset_session_by_index failed (session_index %lu cannot be reset)", (unsigned long)session_index);
+        }
+        else
+        {
+            SESSION_HANDLE new_session_handle;
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_084: [A new session shall be created using session_create(), passing `instance->connection_handle`]
+            if ((new_session_handle = session_create(instance->connection_handle, NULL, NULL)) == NULL)
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_085: [If session_create() fails, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+                result = __FAILURE__;
+                LogError("amqp_connection_reset_session_by_index failed (session_create failed for session %lu)", (unsigned long)session_index);
+            }
+            else
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_086: [The new session shall have the same window sizes as `instance->session_handle`]
+                set_session_windows(new_session_handle);
+
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_087: [The additional session `session_index` - 1 shall be destroyed using session_destroy() and replaced by the new session]
+                session_destroy(instance->additional_session_handles[session_index - 1]);
+                instance->additional_session_handles[session_index - 1] = new_session_handle;
+
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_088: [amqp_connection_reset_session_by_index() shall return success code 0]
+                result = RESULT_OK;
+            }
+        }
+    }
+
+    return result;
+}
+
 int amqp_connection_get_cbs_handle(AMQP_CONNECTION_HANDLE conn_handle, CBS_HANDLE* cbs_handle)
 {
     int result;
@@ -492,6 +492,8 @@ static DEVICE_CONFIG* clone_device_config(DEVICE_CONFIG *config)
         else
         {
             new_config->authorization_module = config->authorization_module;
+            new_config->device_id_hash = config->device_id_hash;
+            new_config->put_token_queue = config->put_token_queue;
             new_config->authentication_mode = config->authentication_mode;
             new_config->on_state_changed_callback = config->on_state_changed_callback;
             new_config->on_state_changed_context = config->on_state_changed_context;
@@ -520,6 +522,8 @@ static void set_authentication_config(AMQP_DEVICE_INSTANCE* device_instance, AUT
     auth_config->on_state_changed_callback = on_authentication_state_changed_callback;
     auth_config->on_state_changed_callback_context = device_instance;
     auth_config->authorization_module = device_config->authorization_module;
+    auth_config->device_id_hash = device_config->device_id_hash;
+    auth_config->put_token_queue = device_config->put_token_queue;
 }
 
 // Create and Destroy Helpers
@@ -1414,6 +1418,62 @@ int device_set_option(AMQP_DEVICE_HANDLE handle, const char* name, void* value)
                 result = RESULT_OK;
             }
         }
+        else if (strcmp(DEVICE_OPTION_EVENT_BATCHING, name) == 0)
+        {
+            // Codes_SRS_DEVICE_09_152: [If `name` is DEVICE_OPTION_EVENT_BATCHING, `value` shall be passed to telemetry_messenger_set_option as TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING]
+            if (telemetry_messenger_set_option(instance->messenger_handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, value) != RESULT_OK)
+            {
+                // Codes_SRS_DEVICE_09_153: [If telemetry_messenger_set_option fails, device_set_option shall return a non-zero result]
+                LogError("failed setting option for device '%s' (failed setting messenger option '%s')", instance->config->device_id, name);
+                result = __FAILURE__;
+            }
+            else
+            {
+                result = RESULT_OK;
+            }
+        }
+        else if (strcmp(DEVICE_OPTION_EVENT_SENDER_LINKS, name) == 0)
+        {
+            // Codes_SRS_DEVICE_09_154: [If `name` is DEVICE_OPTION_EVENT_SENDER_LINKS, `value` shall be passed to telemetry_messenger_set_option as TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS]
+            if (telemetry_messenger_set_option(instance->messenger_handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, value) != RESULT_OK)
+            {
+                // Codes_SRS_DEVICE_09_155: [If telemetry_messenger_set_option fails, device_set_option shall return a non-zero result]
+                LogError("failed setting option for device '%s' (failed setting messenger option '%s')", instance->config->device_id, name);
+                result = __FAILURE__;
+            }
+            else
+            {
+                result = RESULT_OK;
+            }
+        }
+        else if (strcmp(DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, name) == 0)
+        {
+            // Codes_SRS_DEVICE_09_156: [If `name` is DEVICE_OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, `value` shall be passed to twin_messenger_set_option as TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS]
+            if (twin_messenger_set_option(instance->twin_messenger_handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, value) != RESULT_OK)
+            {
+                // Codes_SRS_DEVICE_09_157: [If twin_messenger_set_option fails, device_set_option shall return a non-zero result]
+                LogError("failed setting option for device '%s' (failed setting twin messenger option '%s')", instance->config->device_id, name);
+                result = __FAILURE__;
+            }
+            else
+            {
+                result = RESULT_OK;
+            }
+        }
+        else if (strcmp(DEVICE_OPTION_C2D_PREFETCH, name) == 0)
+        {
+            // Codes_SRS_DEVICE_09_158: [If `name` is DEVICE_OPTION_C2D_PREFETCH, `value` shall be passed to telemetry_messenger_set_option as TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH]
+            if (telemetry_messenger_set_option(instance->messenger_handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, value) != RESULT_OK)
+            {
+                // Codes_SRS_DEVICE_09_159: [If telemetry_messenger_set_option fails, device_set_option shall return a non-zero result]
+                LogError("failed setting option for device '%s' (failed setting messenger option '%s')", instance->config->device_id, name);
+                result = __FAILURE__;
+            }
+            else
+            {
+                result = RESULT_OK;
+            }
+        }
         else if (strcmp(DEVICE_OPTION_SAVED_AUTH_OPTIONS, name) == 0)
         {
             // Codes_SRS_DEVICE_09_088: [If `name` is DEVICE_OPTION_SAVED_AUTH_OPTIONS but CBS authentication is not being used, device_set_option shall return a non-zero result]
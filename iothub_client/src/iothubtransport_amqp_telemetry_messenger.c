@@ -10,6 +10,8 @@
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/uniqueid.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
+#include "azure_c_shared_utility/tickcounter.h"
+#include "azure_c_shared_utility/buffer_.h"
 #include "azure_uamqp_c/link.h"
 #include "azure_uamqp_c/messaging.h"
 #include "azure_uamqp_c/message_sender.h"
@@ -17,6 +19,7 @@
 #include "uamqp_messaging.h"
 #include "iothub_client_private.h"
 #include "iothub_client_version.h"
+#include "iothub_client_options.h"
 #include "iothubtransport_amqp_telemetry_messenger.h"
 
 #define RESULT_OK 0
@@ -29,15 +32,32 @@
 #define MESSAGE_SENDER_MAX_LINK_SIZE                    UINT64_MAX
 #define MESSAGE_RECEIVER_LINK_NAME_PREFIX               "link-rcv"
 #define MESSAGE_RECEIVER_MAX_LINK_SIZE                  65536
+#define RECEIVER_LINK_CREDIT_UPDATE_PERIOD_SECS         1
 #define DEFAULT_EVENT_SEND_RETRY_LIMIT                  10
 #define DEFAULT_EVENT_SEND_TIMEOUT_SECS                 600
 #define MAX_MESSAGE_SENDER_STATE_CHANGE_TIMEOUT_SECS    300
 #define MAX_MESSAGE_RECEIVER_STATE_CHANGE_TIMEOUT_SECS  300
+#define DEFAULT_EVENT_SENDER_LINK_COUNT                 1
+#define MAX_EVENT_SENDER_LINK_COUNT                     8
 #define UNIQUE_ID_BUFFER_SIZE                           37
 #define STRING_NULL_TERMINATOR                          '\0'
 
 #define AMQP_BATCHING_FORMAT_CODE 0x80013700
- 
+
+struct TELEMETRY_MESSENGER_INSTANCE_TAG;
+
+// EVENT_SENDER_LINK is one of the AMQP links events are sent on; a messenger has between 1 and MAX_EVENT_SENDER_LINK_COUNT of them.
+typedef struct EVENT_SENDER_LINK_TAG
+{
+    struct TELEMETRY_MESSENGER_INSTANCE_TAG* messenger;
+    LINK_HANDLE sender_link;
+    MESSAGE_SENDER_HANDLE message_sender;
+    MESSAGE_SENDER_STATE message_sender_current_state;
+    MESSAGE_SENDER_STATE message_sender_previous_state;
+    time_t last_message_sender_state_change_time;
+    size_t outstanding_task_count;                  // Batches sent on this link that have not been settled yet.
+} EVENT_SENDER_LINK;
+
 typedef struct TELEMETRY_MESSENGER_INSTANCE_TAG
 {
     STRING_HANDLE device_id;
@@ -55,20 +75,35 @@ typedef struct TELEMETRY_MESSENGER_INSTANCE_TAG
     void* on_message_received_context;
 
     SESSION_HANDLE session_handle;
-    LINK_HANDLE sender_link;
-    MESSAGE_SENDER_HANDLE message_sender;
-    MESSAGE_SENDER_STATE message_sender_current_state;
-    MESSAGE_SENDER_STATE message_sender_previous_state;
+    EVENT_SENDER_LINK event_senders[MAX_EVENT_SENDER_LINK_COUNT];
+    size_t event_sender_count;                      // Number of `event_senders` created on the last start.
+    size_t next_event_sender;                       // Round-robin position in `event_senders`.
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS event_sender_links;
+    bool is_completion_ordered;                     // `event_sender_links.ordered_completion` as of the last start.
     LINK_HANDLE receiver_link;
     MESSAGE_RECEIVER_HANDLE message_receiver;
     MESSAGE_RECEIVER_STATE message_receiver_current_state;
     MESSAGE_RECEIVER_STATE message_receiver_previous_state;
 
+    IOTHUB_C2D_PREFETCH_OPTIONS c2d_prefetch;
+    bool is_c2d_prefetch_set;                       // If false the receiver link keeps the uAMQP default credit.
+    size_t receiver_link_credit;                    // Credit currently requested on `receiver_link`.
+    size_t received_message_count;                  // Messages received since the credit was last evaluated.
+    size_t unsettled_message_count;                 // Messages the application has not sent a disposition for yet.
+    time_t last_receiver_link_credit_update_time;
+
     size_t event_send_retry_limit;
     size_t event_send_error_count;
     size_t event_send_timeout_secs;
-    time_t last_message_sender_state_change_time;
     time_t last_message_receiver_state_change_time;
+
+    IOTHUB_EVENT_BATCHING_OPTIONS event_batching;   // Linger policy; all-zero means events are sent on the next do_work.
+    TICK_COUNTER_HANDLE event_batching_tick_counter;
+    size_t lingering_event_count;                   // Events added to waiting_to_send since the last batch was sent.
+    size_t lingering_event_bytes;                   // Body size of those events; only tracked if event_batching.max_batch_size_bytes is set.
+    tickcounter_ms_t first_lingering_event_time;
+
+    BUFFER_HANDLE encode_buffer;                    // Scratch space for the AMQP encoding of each event; grows as needed and is reused.
 } TELEMETRY_MESSENGER_INSTANCE;
 
 // MESSENGER_SEND_EVENT_CALLER_INFORMATION corresponds to a message sent from the API, including
@@ -87,7 +122,10 @@ typedef struct MESSENGER_SEND_EVENT_TASK_TAG
     SINGLYLINKEDLIST_HANDLE callback_list;  // List of MESSENGER_SEND_EVENT_CALLER_INFORMATION's
     time_t send_time;
     TELEMETRY_MESSENGER_INSTANCE *messenger;
+    EVENT_SENDER_LINK *event_sender;        // Link the batch was sent on; NULL until then.
     bool is_timed_out;
+    bool is_completed;                      // Settled, but held back until all earlier tasks complete (ordered completion only).
+    TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT send_result;
 } MESSENGER_SEND_EVENT_TASK;
 
 
@@ -336,27 +374,41 @@ static void attach_device_client_type_to_link(LINK_HANDLE link, STRING_HANDLE pr
     }
 }
 
-static void destroy_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
+static void destroy_event_sender(EVENT_SENDER_LINK* event_sender)
 {
-    if (instance->message_sender != NULL)
+    if (event_sender->message_sender != NULL)
     {
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_060: [`instance->message_sender` shall be destroyed using messagesender_destroy()]
-        messagesender_destroy(instance->message_sender);
-        instance->message_sender = NULL;
+        messagesender_destroy(event_sender->message_sender);
+        event_sender->message_sender = NULL;
     }
 
-    instance->message_sender_current_state = MESSAGE_SENDER_STATE_IDLE;
-    instance->message_sender_previous_state = MESSAGE_SENDER_STATE_IDLE;
-    instance->last_message_sender_state_change_time = INDEFINITE_TIME;
+    event_sender->message_sender_current_state = MESSAGE_SENDER_STATE_IDLE;
+    event_sender->message_sender_previous_state = MESSAGE_SENDER_STATE_IDLE;
+    event_sender->last_message_sender_state_change_time = INDEFINITE_TIME;
+    event_sender->outstanding_task_count = 0;
 
-    if (instance->sender_link != NULL)
+    if (event_sender->sender_link != NULL)
     {
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_063: [`instance->sender_link` shall be destroyed using link_destroy()]
-        link_destroy(instance->sender_link);
-        instance->sender_link = NULL;
+        link_destroy(event_sender->sender_link);
+        event_sender->sender_link = NULL;
     }
 }
 
+static void destroy_event_senders(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    size_t i;
+
+    for (i = 0; i < MAX_EVENT_SENDER_LINK_COUNT; i++)
+    {
+        destroy_event_sender(&instance->event_senders[i]);
+    }
+
+    instance->event_sender_count = 0;
+    instance->next_event_sender = 0;
+}
+
 static void on_event_sender_state_changed_callback(void* context, MESSAGE_SENDER_STATE new_state, MESSAGE_SENDER_STATE previous_state)
 {
     if (context == NULL)
@@ -367,15 +419,15 @@ static void on_event_sender_state_changed_callback(void* context, MESSAGE_SENDER
     {
         if (new_state != previous_state)
         {
-            TELEMETRY_MESSENGER_INSTANCE* instance = (TELEMETRY_MESSENGER_INSTANCE*)context;
-            instance->message_sender_current_state = new_state;
-            instance->message_sender_previous_state = previous_state;
-            instance->last_message_sender_state_change_time = get_time(NULL);
+            EVENT_SENDER_LINK* event_sender = (EVENT_SENDER_LINK*)context;
+            event_sender->message_sender_current_state = new_state;
+            event_sender->message_sender_previous_state = previous_state;
+            event_sender->last_message_sender_state_change_time = get_time(NULL);
         }
     }
 }
 
-static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
+static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance, EVENT_SENDER_LINK* event_sender)
 {
     int result;
 
@@ -427,7 +479,7 @@ static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
         LogError("Failed creating the message sender (messaging_create_target failed)");
     }
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_043: [`instance->sender_link` shall be set using link_create(), passing `instance->session_handle`, `link_name`, "role_sender", `source` and `target` as parameters]
-    else if ((instance->sender_link = link_create(instance->session_handle, STRING_c_str(link_name), role_sender, source, target)) == NULL)
+    else if ((event_sender->sender_link = link_create(instance->session_handle, STRING_c_str(link_name), role_sender, source, target)) == NULL)
     {
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_044: [If link_create() fails, telemetry_messenger_do_work() shall fail and return]
         result = __FAILURE__;
@@ -436,7 +488,7 @@ static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
     else
     {
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_047: [`instance->sender_link` maximum message size shall be set to UINT64_MAX using link_set_max_message_size()]
-        if (link_set_max_message_size(instance->sender_link, MESSAGE_SENDER_MAX_LINK_SIZE) != RESULT_OK)
+        if (link_set_max_message_size(event_sender->sender_link, MESSAGE_SENDER_MAX_LINK_SIZE) != RESULT_OK)
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_048: [If link_set_max_message_size() fails, it shall be logged and ignored.]
             LogError("Failed setting message sender link max message size.");
@@ -444,24 +496,24 @@ static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
 
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_049: [`instance->sender_link` should have a property "com.microsoft:client-version" set as `CLIENT_DEVICE_TYPE_PREFIX/IOTHUB_SDK_VERSION`, using amqpvalue_set_map_value() and link_set_attach_properties()]
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_050: [If amqpvalue_set_map_value() or link_set_attach_properties() fail, the failure shall be ignored]
-        attach_device_client_type_to_link(instance->sender_link, instance->product_info);
+        attach_device_client_type_to_link(event_sender->sender_link, instance->product_info);
 
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_051: [`instance->message_sender` shall be created using messagesender_create(), passing the `instance->sender_link` and `on_event_sender_state_changed_callback`]
-        if ((instance->message_sender = messagesender_create(instance->sender_link, on_event_sender_state_changed_callback, (void*)instance)) == NULL)
+        if ((event_sender->message_sender = messagesender_create(event_sender->sender_link, on_event_sender_state_changed_callback, (void*)event_sender)) == NULL)
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_052: [If messagesender_create() fails, telemetry_messenger_do_work() shall fail and return]
             LogError("Failed creating the message sender (messagesender_create failed)");
-            destroy_event_sender(instance);
+            destroy_event_sender(event_sender);
             result = __FAILURE__;
         }
         else
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_053: [`instance->message_sender` shall be opened using messagesender_open()]
-            if (messagesender_open(instance->message_sender) != RESULT_OK)
+            if (messagesender_open(event_sender->message_sender) != RESULT_OK)
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_054: [If messagesender_open() fails, telemetry_messenger_do_work() shall fail and return]
                 LogError("Failed opening the AMQP message sender.");
-                destroy_event_sender(instance);
+                destroy_event_sender(event_sender);
                 result = __FAILURE__;
             }
             else
@@ -488,6 +540,31 @@ static int create_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
     return result;
 }
 
+static int create_event_senders(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    int result = RESULT_OK;
+    size_t i;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_204: [`instance->event_sender_links.link_count` event sender links shall be created, each with its own message sender]
+    for (i = 0; i < instance->event_sender_links.link_count; i++)
+    {
+        if (create_event_sender(instance, &instance->event_senders[i]) != RESULT_OK)
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_205: [If any of the event sender links fails to be created, the ones already created shall be destroyed]
+            LogError("Failed creating event sender link %lu of %lu", (unsigned long)(i + 1), (unsigned long)instance->event_sender_links.link_count);
+            destroy_event_senders(instance);
+            result = __FAILURE__;
+            break;
+        }
+
+        instance->event_sender_count++;
+    }
+
+    instance->is_completion_ordered = instance->event_sender_links.ordered_completion;
+
+    return result;
+}
+
 static void destroy_message_receiver(TELEMETRY_MESSENGER_INSTANCE* instance)
 {
     if (instance->message_receiver != NULL)
@@ -511,6 +588,8 @@ static void destroy_message_receiver(TELEMETRY_MESSENGER_INSTANCE* instance)
     instance->message_receiver_current_state = MESSAGE_RECEIVER_STATE_IDLE;
     instance->message_receiver_previous_state = MESSAGE_RECEIVER_STATE_IDLE;
     instance->last_message_receiver_state_change_time = INDEFINITE_TIME;
+    instance->received_message_count = 0;
+    instance->unsettled_message_count = 0;
 
     if (instance->receiver_link != NULL)
     {
@@ -651,6 +730,14 @@ static AMQP_VALUE on_message_received_internal_callback(const void* context, MES
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_123: [`instance->on_message_received_callback` shall be invoked passing the IOTHUB_MESSAGE_HANDLE and TELEMETRY_MESSENGER_MESSAGE_DISPOSITION_INFO instance]
             TELEMETRY_MESSENGER_DISPOSITION_RESULT disposition_result = instance->on_message_received_callback(iothub_message, message_disposition_info, instance->on_message_received_context);
 
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_217: [Each message received shall be counted towards the drain rate of the receiver link, and counted as unsettled if `instance->on_message_received_callback` returns TELEMETRY_MESSENGER_DISPOSITION_RESULT_NONE]
+            instance->received_message_count++;
+
+            if (disposition_result == TELEMETRY_MESSENGER_DISPOSITION_RESULT_NONE)
+            {
+                instance->unsettled_message_count++;
+            }
+
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_188: [The memory allocated for the TELEMETRY_MESSENGER_MESSAGE_DISPOSITION_INFO instance shall be released]
             destroy_message_disposition_info(message_disposition_info);
 
@@ -738,6 +825,19 @@ static int create_message_receiver(TELEMETRY_MESSENGER_INSTANCE* instance)
             LogError("Failed setting message receiver link max message size.");
         }
 
+        if (instance->is_c2d_prefetch_set)
+        {
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_213: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set, `instance->receiver_link` credit shall be set to `initial_credit` using link_set_max_link_credit()]
+            if (link_set_max_link_credit(instance->receiver_link, (uint32_t)instance->c2d_prefetch.initial_credit) != RESULT_OK)
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_214: [If link_set_max_link_credit() fails, it shall be logged and ignored.]
+                LogError("Failed setting message receiver link credit.");
+            }
+
+            instance->receiver_link_credit = instance->c2d_prefetch.initial_credit;
+            instance->last_receiver_link_credit_update_time = INDEFINITE_TIME;
+        }
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_084: [`instance->receiver_link` should have a property "com.microsoft:client-version" set as `CLIENT_DEVICE_TYPE_PREFIX/IOTHUB_SDK_VERSION`, using amqpvalue_set_map_value() and link_set_attach_properties()]
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_085: [If amqpvalue_set_map_value() or link_set_attach_properties() fail, the failure shall be ignored]
         attach_device_client_type_to_link(instance->receiver_link, instance->product_info);
@@ -837,6 +937,21 @@ static void free_task(MESSENGER_SEND_EVENT_TASK* task)
     free(task);
 }
 
+static void invoke_callback(const void* item, const void* action_context, bool* continue_processing)
+{
+    MESSENGER_SEND_EVENT_CALLER_INFORMATION *caller_info = (MESSENGER_SEND_EVENT_CALLER_INFORMATION*)item;
+
+    if (NULL != caller_info->on_event_send_complete_callback)
+    {
+#pragma warning(push)
+#pragma warning(disable:4305) // Allow typecasting to smaller type on 64 bit systems, since we control ultimate caller.
+        TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT messenger_send_result = (TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT)action_context;
+#pragma warning(pop)
+        caller_info->on_event_send_complete_callback(caller_info->message, messenger_send_result, caller_info->context);
+    }
+    *continue_processing = true;
+}
+
 static int copy_events_to_list(SINGLYLINKEDLIST_HANDLE from_list, SINGLYLINKEDLIST_HANDLE to_list)
 {
     int result;
@@ -877,28 +992,36 @@ static int copy_events_from_in_progress_to_waiting_list(TELEMETRY_MESSENGER_INST
     {
         MESSENGER_SEND_EVENT_TASK* task = (MESSENGER_SEND_EVENT_TASK*)singlylinkedlist_item_get_value(list_task_item);
         
-        LIST_ITEM_HANDLE list_caller_item;
-        
-        list_caller_item = singlylinkedlist_get_head_item(task->callback_list);
-        
-        while (list_caller_item != NULL)
+        if (task->is_completed)
         {
-            MESSENGER_SEND_EVENT_CALLER_INFORMATION* caller_information = (MESSENGER_SEND_EVENT_CALLER_INFORMATION*)singlylinkedlist_item_get_value(list_caller_item);
-            
-            if (singlylinkedlist_add(to_list, caller_information) == NULL)
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_209: [Events already settled but held back for ordered completion shall be reported with their result instead of being moved back to `instance->wait_to_send_list`]
+            singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)((size_t)task->send_result));
+        }
+        else
+        {
+            LIST_ITEM_HANDLE list_caller_item;
+
+            list_caller_item = singlylinkedlist_get_head_item(task->callback_list);
+
+            while (list_caller_item != NULL)
             {
-                LogError("Failed copying event to destination list (singlylinkedlist_add failed)");
-                result = __FAILURE__;
-                break;
+                MESSENGER_SEND_EVENT_CALLER_INFORMATION* caller_information = (MESSENGER_SEND_EVENT_CALLER_INFORMATION*)singlylinkedlist_item_get_value(list_caller_item);
+
+                if (singlylinkedlist_add(to_list, caller_information) == NULL)
+                {
+                    LogError("Failed copying event to destination list (singlylinkedlist_add failed)");
+                    result = __FAILURE__;
+                    break;
+                }
+
+                list_caller_item = singlylinkedlist_get_next_item(list_caller_item);
             }
 
-            list_caller_item = singlylinkedlist_get_next_item(list_caller_item);
+            singlylinkedlist_destroy(task->callback_list);
+            task->callback_list = NULL;
         }
-        
-        list_task_item_next = singlylinkedlist_get_next_item(list_task_item);
 
-        singlylinkedlist_destroy(task->callback_list);
-        task->callback_list = NULL;
+        list_task_item_next = singlylinkedlist_get_next_item(list_task_item);
 
         free_task(task);
         singlylinkedlist_remove(instance->in_progress_list, list_task_item);
@@ -993,20 +1116,50 @@ static MESSENGER_SEND_EVENT_TASK* create_task(TELEMETRY_MESSENGER_INSTANCE *mess
 }
 
 
+static void complete_event_task(MESSENGER_SEND_EVENT_TASK* task)
+{
+    if (task->is_timed_out == false)
+    {
+        // Initially typecast to a size_t to avoid 64 bit compiler warnings on casting of void* to larger type.
+        singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)((size_t)task->send_result));
+    }
+    else
+    {
+        LogInfo("messenger on_event_send_complete_callback invoked for timed out event %p; not firing upper layer callback.", task);
+    }
+}
 
-static void invoke_callback(const void* item, const void* action_context, bool* continue_processing)
+// @brief
+//     Completes the settled tasks in in_progress_list in the order they were sent, stopping at the first one still in flight.
+//     Timed out tasks were already reported, so they do not hold back the tasks sent after them; they stay in the list until settled.
+static void complete_event_tasks_in_order(TELEMETRY_MESSENGER_INSTANCE* instance)
 {
-    MESSENGER_SEND_EVENT_CALLER_INFORMATION *caller_info = (MESSENGER_SEND_EVENT_CALLER_INFORMATION*)item;
+    LIST_ITEM_HANDLE list_item = singlylinkedlist_get_head_item(instance->in_progress_list);
 
-    if (NULL != caller_info->on_event_send_complete_callback)
+    while (list_item != NULL)
     {
-#pragma warning(push)
-#pragma warning(disable:4305) // Allow typecasting to smaller type on 64 bit systems, since we control ultimate caller.
-        TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT messenger_send_result = (TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT)action_context;
-#pragma warning(pop)
-        caller_info->on_event_send_complete_callback(caller_info->message, messenger_send_result, caller_info->context);
+        MESSENGER_SEND_EVENT_TASK* task = (MESSENGER_SEND_EVENT_TASK*)singlylinkedlist_item_get_value(list_item);
+        LIST_ITEM_HANDLE next_list_item = singlylinkedlist_get_next_item(list_item);
+
+        if (task->is_completed)
+        {
+            complete_event_task(task);
+
+            if (singlylinkedlist_remove(instance->in_progress_list, list_item) != RESULT_OK)
+            {
+                LogError("Failed removing event from in_progress list (singlylinkedlist_remove failed)");
+                break;
+            }
+
+            free_task(task);
+        }
+        else if (task->is_timed_out == false)
+        {
+            break;
+        }
+
+        list_item = next_list_item;
     }
-    *continue_processing = true;
 }
 
 static void internal_on_event_send_complete_callback(void* context, MESSAGE_SEND_RESULT send_result)
@@ -1015,36 +1168,37 @@ static void internal_on_event_send_complete_callback(void* context, MESSAGE_SEND
     {
         MESSENGER_SEND_EVENT_TASK* task = (MESSENGER_SEND_EVENT_TASK*)context;
 
-        if (task->messenger->message_sender_current_state != MESSAGE_SENDER_STATE_ERROR)
+        if (task->event_sender->message_sender_current_state != MESSAGE_SENDER_STATE_ERROR)
         {
-            if (task->is_timed_out == false)
-            {
-                TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT messenger_send_result;
-
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_189: [If no failure occurs, `on_event_send_complete_callback` shall be invoked with result TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK for all callers associated with this task]
-                if (send_result == MESSAGE_SEND_OK)
-                {
-                    messenger_send_result = TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK;
-                }
-                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_190: [If a failure occured, `on_event_send_complete_callback` shall be invoked with result TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING for all callers associated with this task]
-                else
-                {
-                    messenger_send_result = TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING;
-                }
+            task->event_sender->outstanding_task_count--;
 
-                // Initially typecast to a size_t to avoid 64 bit compiler warnings on casting of void* to larger type.
-                singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)((size_t)messenger_send_result));
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_189: [If no failure occurs, `on_event_send_complete_callback` shall be invoked with result TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK for all callers associated with this task]
+            if (send_result == MESSAGE_SEND_OK)
+            {
+                task->send_result = TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK;
             }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_190: [If a failure occured, `on_event_send_complete_callback` shall be invoked with result TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING for all callers associated with this task]
             else
             {
-                LogInfo("messenger on_event_send_complete_callback invoked for timed out event %p; not firing upper layer callback.", task);
+                task->send_result = TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING;
             }
 
-            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_128: [`task` shall be removed from `instance->in_progress_list`]  
-            remove_event_from_in_progress_list(task);
+            if (task->messenger->is_completion_ordered)
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_208: [If ordered completion is enabled, `task` shall only be completed once all tasks sent before it have completed or timed out]
+                task->is_completed = true;
+                complete_event_tasks_in_order(task->messenger);
+            }
+            else
+            {
+                complete_event_task(task);
 
-            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_130: [`task` shall be destroyed()]
-            free_task(task);
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_128: [`task` shall be removed from `instance->in_progress_list`]  
+                remove_event_from_in_progress_list(task);
+
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_130: [`task` shall be destroyed()]
+                free_task(task);
+            }
         }
     }
 }
@@ -1076,6 +1230,7 @@ typedef struct SEND_PENDING_EVENTS_STATE_TAG
     MESSENGER_SEND_EVENT_TASK* task;
     MESSAGE_HANDLE message_batch_container;
     uint64_t bytes_pending;
+    size_t message_count;
 } SEND_PENDING_EVENTS_STATE;
 
 
@@ -1113,18 +1268,53 @@ static void invoke_callback_on_error(MESSENGER_SEND_EVENT_CALLER_INFORMATION* ca
     caller_info->on_event_send_complete_callback(caller_info->message, messenger_event_send_complete_result, (void*)caller_info->context);
 }
 
+// @brief
+//     Picks the event sender link the next batch goes out on, according to `instance->event_sender_links.dispatch`.
+static EVENT_SENDER_LINK* get_next_event_sender(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    EVENT_SENDER_LINK* result;
+
+    if (instance->event_sender_links.dispatch == IOTHUB_EVENT_SENDER_DISPATCH_LEAST_OUTSTANDING)
+    {
+        size_t i;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_207: [If dispatch is IOTHUB_EVENT_SENDER_DISPATCH_LEAST_OUTSTANDING, each batch shall be sent on the link with the fewest unsettled batches]
+        result = &instance->event_senders[0];
+
+        for (i = 1; i < instance->event_sender_count; i++)
+        {
+            if (instance->event_senders[i].outstanding_task_count < result->outstanding_task_count)
+            {
+                result = &instance->event_senders[i];
+            }
+        }
+    }
+    else
+    {
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_206: [If dispatch is IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, each batch shall be sent on the next event sender link in turn]
+        result = &instance->event_senders[instance->next_event_sender];
+        instance->next_event_sender = (instance->next_event_sender + 1) % instance->event_sender_count;
+    }
+
+    return result;
+}
+
 // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_194: [When message is ready to send, invoke AMQP's messagesender_send and free temporary values associated with this batch.]
 static int send_batched_message_and_reset_state(TELEMETRY_MESSENGER_INSTANCE* instance, SEND_PENDING_EVENTS_STATE *send_pending_events_state)
 {
     int result;
+    EVENT_SENDER_LINK* event_sender = get_next_event_sender(instance);
 
-    if (messagesender_send_async(instance->message_sender, send_pending_events_state->message_batch_container, internal_on_event_send_complete_callback, send_pending_events_state->task, 0) == NULL)
+    send_pending_events_state->task->event_sender = event_sender;
+
+    if (messagesender_send_async(event_sender->message_sender, send_pending_events_state->message_batch_container, internal_on_event_send_complete_callback, send_pending_events_state->task, 0) == NULL)
     {
         LogError("messagesender_send failed");
         result = __FAILURE__;
     }
     else
     {
+        event_sender->outstanding_task_count++;
         send_pending_events_state->task->send_time = get_time(NULL);
         result = RESULT_OK;
     }
@@ -1138,23 +1328,105 @@ static int send_batched_message_and_reset_state(TELEMETRY_MESSENGER_INSTANCE* in
 // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_196: [Determine the maximum message size we can send over this link from AMQP, then remove AMQP_BATCHING_RESERVE_SIZE (1024) bytes as reserve buffer.]          
 static int get_max_message_size_for_batching(TELEMETRY_MESSENGER_INSTANCE* instance, uint64_t* max_messagesize)
 {
-    int result;
+    int result = 0;
+    size_t i;
 
-    if (link_get_peer_max_message_size(instance->sender_link, max_messagesize) != 0)
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_222: [The maximum message size shall be the smallest peer maximum message size across all event sender links, since a batch may go out on any of them]
+    for (i = 0; i < instance->event_sender_count; i++)
     {
-        LogError("link_get_peer_max_message_size failed");
-        result = __FAILURE__;
+        uint64_t link_max_messagesize;
+
+        if (link_get_peer_max_message_size(instance->event_senders[i].sender_link, &link_max_messagesize) != 0)
+        {
+            LogError("link_get_peer_max_message_size failed (event sender link %lu)", (unsigned long)i);
+            result = __FAILURE__;
+            break;
+        }
+        else if (i == 0 || link_max_messagesize < *max_messagesize)
+        {
+            *max_messagesize = link_max_messagesize;
+        }
     }
-    // Reserve AMQP_BATCHING_RESERVE_SIZE bytes for AMQP overhead of the "main" message itself.
-    else if (*max_messagesize <= AMQP_BATCHING_RESERVE_SIZE)
+
+    if (result == 0)
     {
-        LogError("link_get_peer_max_message_size (%d) is less than the reserve size (%d)", max_messagesize, AMQP_BATCHING_RESERVE_SIZE);
-        result = __FAILURE__;
+        // Reserve AMQP_BATCHING_RESERVE_SIZE bytes for AMQP overhead of the "main" message itself.
+        if (*max_messagesize <= AMQP_BATCHING_RESERVE_SIZE)
+        {
+            LogError("link_get_peer_max_message_size (%d) is less than the reserve size (%d)", max_messagesize, AMQP_BATCHING_RESERVE_SIZE);
+            result = __FAILURE__;
+        }
+        else
+        {
+            *max_messagesize -= AMQP_BATCHING_RESERVE_SIZE;
+        }
+    }
+
+    return result;
+}
+
+static size_t get_event_body_size(IOTHUB_MESSAGE_HANDLE message)
+{
+    size_t size = 0;
+    IOTHUBMESSAGE_CONTENT_TYPE content_type = IoTHubMessage_GetContentType(message);
+
+    if (content_type == IOTHUBMESSAGE_BYTEARRAY)
+    {
+        const unsigned char* buffer;
+
+        if (IoTHubMessage_GetByteArray(message, &buffer, &size) != IOTHUB_MESSAGE_OK)
+        {
+            size = 0;
+        }
+    }
+    else if (content_type == IOTHUBMESSAGE_STRING)
+    {
+        const char* string = IoTHubMessage_GetString(message);
+
+        if (string != NULL)
+        {
+            size = strlen(string);
+        }
     }
+
+    return size;
+}
+
+// @brief
+//     Evaluates the linger policy in `instance->event_batching` against the events added since the last batch was sent.
+// @returns
+//     true if the events shall be held for a later do_work, false if they shall be sent now.
+static bool should_linger(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    bool result;
+    tickcounter_ms_t current_time;
+
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_192: [If `linger_time_ms` is zero or no events were added since the last batch, events shall be sent immediately]
+    if (instance->event_batching.linger_time_ms == 0 || instance->lingering_event_count == 0)
+    {
+        result = false;
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_193: [If `max_batch_message_count` is set and reached, events shall be sent immediately]
+    else if (instance->event_batching.max_batch_message_count > 0 &&
+        instance->lingering_event_count >= instance->event_batching.max_batch_message_count)
+    {
+        result = false;
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_194: [If `max_batch_size_bytes` is set and reached, events shall be sent immediately]
+    else if (instance->event_batching.max_batch_size_bytes > 0 &&
+        instance->lingering_event_bytes >= instance->event_batching.max_batch_size_bytes)
+    {
+        result = false;
+    }
+    else if (tickcounter_get_current_ms(instance->event_batching_tick_counter, &current_time) != 0)
+    {
+        LogError("Failed evaluating linger time (tickcounter_get_current_ms failed); sending events now");
+        result = false;
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_195: [Otherwise events shall be held until `linger_time_ms` has elapsed since the first of them was added]
     else
     {
-        *max_messagesize -= AMQP_BATCHING_RESERVE_SIZE;
-        result = 0;
+        result = ((current_time - instance->first_lingering_event_time) < instance->event_batching.linger_time_ms);
     }
 
     return result;
@@ -1172,17 +1444,17 @@ static int send_pending_events(TELEMETRY_MESSENGER_INSTANCE* instance)
     memset(&body_binary_data, 0, sizeof(body_binary_data));
 
     uint64_t max_messagesize = 0;
+    uint64_t max_batchsize;
+
+    instance->lingering_event_count = 0;
+    instance->lingering_event_bytes = 0;
 
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_192: [Enumerate through all messages waiting to send, building up AMQP message to send and sending when size will be greater than link max size.]
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_198: [While processing pending messages, errors shall result in user callback being invoked.]    
     // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_199: [Errors specific to a message (e.g. failure to encode) are NOT fatal but we'll keep processing.  More general errors (e.g. out of memory) will stop processing.]
     while ((caller_info = get_next_caller_message_to_send(instance)) != NULL)
     {
-        if (body_binary_data.bytes != NULL)
-        {
-            // Free here as this may have been set during previous run through loop.
-            free((unsigned char*)body_binary_data.bytes);
-        }
+        // body_binary_data points into instance->encode_buffer, which is overwritten by each message; nothing to free here.
         memset(&body_binary_data, 0, sizeof(body_binary_data));
     
         if ((0 == max_messagesize) && (get_max_message_size_for_batching(instance, &max_messagesize)) != 0)
@@ -1202,7 +1474,8 @@ static int send_pending_events(TELEMETRY_MESSENGER_INSTANCE* instance)
             break;
         }
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_200: [Retrieve an AMQP encoded representation of this message for later appending to main batched message.  On error, invoke callback but continue send loop; this is NOT a fatal error.]
-        else if (message_create_uamqp_encoding_from_iothub_message(send_pending_events_state.message_batch_container, caller_info->message->messageHandle, &body_binary_data) != RESULT_OK)
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_199: [The message shall be encoded into `instance->encode_buffer` using message_create_uamqp_encoding_from_iothub_message_in_buffer, so no memory is allocated per event once the buffer has grown]
+        else if (message_create_uamqp_encoding_from_iothub_message_in_buffer(send_pending_events_state.message_batch_container, caller_info->message->messageHandle, instance->encode_buffer, &body_binary_data) != RESULT_OK)
         {
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_201: [If message_create_uamqp_encoding_from_iothub_message fails, invoke callback with TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_CANNOT_PARSE]
             LogError("message_create_uamqp_encoding_from_iothub_message() failed.  Will continue to try to process messages, result");
@@ -1232,7 +1505,14 @@ static int send_pending_events(TELEMETRY_MESSENGER_INSTANCE* instance)
         // Similarly, responsibility for freeing this memory falls on the 'task' cleanup also.
 
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_31_193: [If (length of current user AMQP message) + (length of user messages pending for this batched message) + (1KB reserve buffer) > maximum link send, send pending messages and create new batched message.]
-        if (body_binary_data.length + send_pending_events_state.bytes_pending > max_messagesize)
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_196: [If `max_batch_size_bytes` is set and smaller than the maximum link send, it shall be used instead as the limit of a batched message]
+        max_batchsize = max_messagesize;
+        if ((instance->event_batching.max_batch_size_bytes > 0) && (instance->event_batching.max_batch_size_bytes < max_batchsize))
+        {
+            max_batchsize = instance->event_batching.max_batch_size_bytes;
+        }
+
+        if ((send_pending_events_state.bytes_pending != 0) && (body_binary_data.length + send_pending_events_state.bytes_pending > max_batchsize))
         {
             // If we tried to add the current message, we would overflow.  Send what we've queued immediately.
             if (send_batched_message_and_reset_state(instance, &send_pending_events_state) != RESULT_OK)
@@ -1260,6 +1540,19 @@ static int send_pending_events(TELEMETRY_MESSENGER_INSTANCE* instance)
         }
 
         send_pending_events_state.bytes_pending += body_binary_data.length;
+        send_pending_events_state.message_count++;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_197: [If `max_batch_message_count` is set and the batched message holds that many events, it shall be sent and a new batched message created for the remaining events]
+        if ((instance->event_batching.max_batch_message_count > 0) &&
+            (send_pending_events_state.message_count >= instance->event_batching.max_batch_message_count))
+        {
+            if (send_batched_message_and_reset_state(instance, &send_pending_events_state) != RESULT_OK)
+            {
+                LogError("send_batched_message_and_reset_state failed");
+                result = __FAILURE__;
+                break;
+            }
+        }
     }
 
     if ((result == 0) && (send_pending_events_state.bytes_pending != 0))
@@ -1271,11 +1564,6 @@ static int send_pending_events(TELEMETRY_MESSENGER_INSTANCE* instance)
         }
     }
 
-    if (body_binary_data.bytes != NULL)
-    {
-        free((unsigned char*)body_binary_data.bytes);
-    }
-
     // A non-NULL task indicates error, since otherwise send_batched_message_and_reset_state would've sent off messages and reset send_pending_events_state
     if (send_pending_events_state.task != NULL)
     {
@@ -1304,13 +1592,15 @@ static int process_event_send_timeouts(TELEMETRY_MESSENGER_INSTANCE* instance)
 
     if (instance->event_send_timeout_secs > 0)
     {
+        bool has_timed_out_events = false;
         LIST_ITEM_HANDLE list_item = singlylinkedlist_get_head_item(instance->in_progress_list);
 
         while (list_item != NULL)
         {
             MESSENGER_SEND_EVENT_TASK* task = (MESSENGER_SEND_EVENT_TASK*)singlylinkedlist_item_get_value(list_item);
 
-            if (task->is_timed_out == false)
+            // Tasks held back for ordered completion have already been settled, so they cannot time out.
+            if (task->is_timed_out == false && task->is_completed == false)
             {
                 int is_timed_out;
 
@@ -1319,6 +1609,7 @@ static int process_event_send_timeouts(TELEMETRY_MESSENGER_INSTANCE* instance)
                     if (is_timed_out)
                     {
                         task->is_timed_out = true;
+                        has_timed_out_events = true;
                         singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_TIMEOUT);
                     }
                 }
@@ -1331,6 +1622,12 @@ static int process_event_send_timeouts(TELEMETRY_MESSENGER_INSTANCE* instance)
 
             list_item = singlylinkedlist_get_next_item(list_item);
         }
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_221: [If ordered completion is enabled, the settled tasks sent after a timed out task shall be completed]
+        if (has_timed_out_events && instance->is_completion_ordered)
+        {
+            complete_event_tasks_in_order(instance);
+        }
     }
 
     return result;
@@ -1357,9 +1654,74 @@ static void remove_timed_out_events(TELEMETRY_MESSENGER_INSTANCE* instance)
     }
 }
 
+// @brief
+//     Grows the receiver link credit while messages are drained faster than it gets replenished, and shrinks it
+//     while the application holds on to as many unsettled messages as the credit allows.
+static void update_receiver_link_credit(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    time_t current_time;
+
+    if ((current_time = get_time(NULL)) == INDEFINITE_TIME)
+    {
+        LogError("Failed updating the message receiver link credit (get_time failed)");
+    }
+    else if (instance->last_receiver_link_credit_update_time == INDEFINITE_TIME)
+    {
+        instance->received_message_count = 0;
+        instance->last_receiver_link_credit_update_time = current_time;
+    }
+    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_219: [The receiver link credit shall be re-evaluated every RECEIVER_LINK_CREDIT_UPDATE_PERIOD_SECS]
+    else if (get_difftime(current_time, instance->last_receiver_link_credit_update_time) >= RECEIVER_LINK_CREDIT_UPDATE_PERIOD_SECS)
+    {
+        size_t link_credit = instance->receiver_link_credit;
+
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_216: [If the unsettled messages reach the current credit, the credit shall be halved, down to `min_credit`; otherwise if at least half the credit was received in the period, it shall be doubled, up to `max_credit`]
+        if (instance->unsettled_message_count >= link_credit)
+        {
+            link_credit = (link_credit / 2 < instance->c2d_prefetch.min_credit ? instance->c2d_prefetch.min_credit : link_credit / 2);
+        }
+        else if (instance->received_message_count >= (link_credit + 1) / 2)
+        {
+            link_credit = (link_credit > instance->c2d_prefetch.max_credit / 2 ? instance->c2d_prefetch.max_credit : link_credit * 2);
+        }
+
+        if (link_credit != instance->receiver_link_credit)
+        {
+            if (link_set_max_link_credit(instance->receiver_link, (uint32_t)link_credit) != RESULT_OK)
+            {
+                LogError("Failed updating the message receiver link credit to %lu (link_set_max_link_credit failed)", (unsigned long)link_credit);
+            }
+            else
+            {
+                instance->receiver_link_credit = link_credit;
+            }
+        }
+
+        instance->received_message_count = 0;
+        instance->last_receiver_link_credit_update_time = current_time;
+    }
+}
+
 
 // ---------- Set/Retrieve Options Helpers ----------//
 
+// The saved options outlive the messenger, so they cannot point into `instance`.
+static void* clone_option_struct(const char* name, const void* value, size_t size)
+{
+    void* result;
+
+    if ((result = malloc(size)) == NULL)
+    {
+        LogError("Failed to clone messenger option '%s' (malloc failed)", name);
+    }
+    else
+    {
+        (void)memcpy(result, value, size);
+    }
+
+    return result;
+}
+
 static void* telemetry_messenger_clone_option(const char* name, const void* value)
 {
     void* result;
@@ -1381,6 +1743,18 @@ static void* telemetry_messenger_clone_option(const char* name, const void* valu
         {
             result = (void*)value;
         }
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, name) == 0)
+        {
+            result = clone_option_struct(name, value, sizeof(IOTHUB_EVENT_BATCHING_OPTIONS));
+        }
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, name) == 0)
+        {
+            result = clone_option_struct(name, value, sizeof(IOTHUB_EVENT_SENDER_LINKS_OPTIONS));
+        }
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, name) == 0)
+        {
+            result = clone_option_struct(name, value, sizeof(IOTHUB_C2D_PREFETCH_OPTIONS));
+        }
         else
         {
             LogError("Failed to clone messenger option (option with name '%s' is not suppported)", name);
@@ -1401,9 +1775,15 @@ static void telemetry_messenger_destroy_option(const char* name, const void* val
     {
         LogError("Failed to destroy messenger option (value is NULL)");
     }
+    else if (strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, name) == 0 ||
+        strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, name) == 0 ||
+        strcmp(TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, name) == 0)
+    {
+        free((void*)value);
+    }
     else
     {
-        // Nothing to be done for the supported options.
+        // Nothing to be done for the other supported options.
     }
 }
 
@@ -1541,6 +1921,12 @@ int telemetry_messenger_send_message_disposition(TELEMETRY_MESSENGER_HANDLE mess
                 }
                 else
                 {
+                    // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_218: [If the disposition is sent, the message shall no longer be counted as unsettled]
+                    if (messenger->unsettled_message_count > 0)
+                    {
+                        messenger->unsettled_message_count--;
+                    }
+
                     // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_185: [If no failures occurr, telemetry_messenger_send_message_disposition() shall return 0]  
                     result = RESULT_OK;
                 }
@@ -1605,7 +1991,26 @@ int telemetry_messenger_send_async(TELEMETRY_MESSENGER_HANDLE messenger_handle,
             caller_info->message = message;
             caller_info->on_event_send_complete_callback = on_messenger_event_send_complete_callback;
             caller_info->context = context;
-            
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_198: [If a linger time is set, the time the first event was queued since the last batch, and the number and size of queued events, shall be tracked]
+            if (instance->event_batching.linger_time_ms > 0)
+            {
+                if (instance->lingering_event_count == 0 &&
+                    tickcounter_get_current_ms(instance->event_batching_tick_counter, &instance->first_lingering_event_time) != 0)
+                {
+                    LogError("Failed getting the time the event was queued (tickcounter_get_current_ms failed); it will not linger");
+                }
+                else
+                {
+                    instance->lingering_event_count++;
+
+                    if (instance->event_batching.max_batch_size_bytes > 0)
+                    {
+                        instance->lingering_event_bytes += get_event_body_size(message->messageHandle);
+                    }
+                }
+            }
+
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_143: [If no failures occur, telemetry_messenger_send_async() shall return zero]  
             result = RESULT_OK;
         }
@@ -1721,7 +2126,7 @@ int telemetry_messenger_stop(TELEMETRY_MESSENGER_HANDLE messenger_handle)
             update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_STOPPING);
 
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_152: [telemetry_messenger_stop() shall close and destroy `instance->message_sender` and `instance->message_receiver`]  
-            destroy_event_sender(instance);
+            destroy_event_senders(instance);
             destroy_message_receiver(instance);
 
             remove_timed_out_events(instance);
@@ -1747,6 +2152,34 @@ int telemetry_messenger_stop(TELEMETRY_MESSENGER_HANDLE messenger_handle)
     return result;
 }
 
+// @brief
+//     Finds the event sender link that most needs attention: the first one in ERROR or CLOSING state, otherwise the first one not OPEN.
+// @returns
+//     NULL if all the event sender links created on start are OPEN.
+static EVENT_SENDER_LINK* get_event_sender_not_open(TELEMETRY_MESSENGER_INSTANCE* instance)
+{
+    EVENT_SENDER_LINK* result = NULL;
+    size_t i;
+
+    for (i = 0; i < instance->event_sender_count; i++)
+    {
+        EVENT_SENDER_LINK* event_sender = &instance->event_senders[i];
+
+        if (event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_ERROR ||
+            event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_CLOSING)
+        {
+            result = event_sender;
+            break;
+        }
+        else if (result == NULL && event_sender->message_sender_current_state != MESSAGE_SENDER_STATE_OPEN)
+        {
+            result = event_sender;
+        }
+    }
+
+    return result;
+}
+
 // @brief
 //     Sets the messenger module state based on the state changes from messagesender and messagereceiver
 static void process_state_changes(TELEMETRY_MESSENGER_INSTANCE* instance)
@@ -1756,9 +2189,11 @@ static void process_state_changes(TELEMETRY_MESSENGER_INSTANCE* instance)
 
     if (instance->state == TELEMETRY_MESSENGER_STATE_STARTED)
     {
-        if (instance->message_sender_current_state != MESSAGE_SENDER_STATE_OPEN)
+        EVENT_SENDER_LINK* event_sender = get_event_sender_not_open(instance);
+
+        if (event_sender != NULL)
         {
-            LogError("messagesender reported unexpected state %d while messenger was started", instance->message_sender_current_state);
+            LogError("messagesender reported unexpected state %d while messenger was started", event_sender->message_sender_current_state);
             update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_ERROR);
         }
         else if (instance->message_receiver != NULL && instance->message_receiver_current_state != MESSAGE_RECEIVER_STATE_OPEN)
@@ -1789,14 +2224,20 @@ static void process_state_changes(TELEMETRY_MESSENGER_INSTANCE* instance)
     {
         if (instance->state == TELEMETRY_MESSENGER_STATE_STARTING)
         {
-            if (instance->message_sender_current_state == MESSAGE_SENDER_STATE_OPEN)
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_210: [The messenger shall only be considered started once all its event sender links are open]
+            EVENT_SENDER_LINK* event_sender = get_event_sender_not_open(instance);
+
+            if (event_sender == NULL)
             {
-                update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_STARTED);
+                if (instance->event_sender_count > 0)
+                {
+                    update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_STARTED);
+                }
             }
-            else if (instance->message_sender_current_state == MESSAGE_SENDER_STATE_OPENING)
+            else if (event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_OPENING)
             {
                 int is_timed_out;
-                if (is_timeout_reached(instance->last_message_sender_state_change_time, MAX_MESSAGE_SENDER_STATE_CHANGE_TIMEOUT_SECS, &is_timed_out) != RESULT_OK)
+                if (is_timeout_reached(event_sender->last_message_sender_state_change_time, MAX_MESSAGE_SENDER_STATE_CHANGE_TIMEOUT_SECS, &is_timed_out) != RESULT_OK)
                 {
                     LogError("messenger failed to start (failed to verify messagesender start timeout)");
                     update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_ERROR);
@@ -1809,11 +2250,11 @@ static void process_state_changes(TELEMETRY_MESSENGER_INSTANCE* instance)
             }
             // For this module, the only valid scenario where messagesender state is IDLE is if 
             // the messagesender hasn't been created yet or already destroyed.
-            else if ((instance->message_sender_current_state == MESSAGE_SENDER_STATE_ERROR) ||
-                (instance->message_sender_current_state == MESSAGE_SENDER_STATE_CLOSING) ||
-                (instance->message_sender_current_state == MESSAGE_SENDER_STATE_IDLE && instance->message_sender != NULL))
+            else if ((event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_ERROR) ||
+                (event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_CLOSING) ||
+                (event_sender->message_sender_current_state == MESSAGE_SENDER_STATE_IDLE && event_sender->message_sender != NULL))
             {
-                LogError("messagesender reported unexpected state %d while messenger is starting", instance->message_sender_current_state);
+                LogError("messagesender reported unexpected state %d while messenger is starting", event_sender->message_sender_current_state);
                 update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_ERROR);
             }
         }
@@ -1837,9 +2278,9 @@ void telemetry_messenger_do_work(TELEMETRY_MESSENGER_HANDLE messenger_handle)
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_151: [If `instance->state` is TELEMETRY_MESSENGER_STATE_STARTING, telemetry_messenger_do_work() shall create and open `instance->message_sender`]
         if (instance->state == TELEMETRY_MESSENGER_STATE_STARTING)
         {
-            if (instance->message_sender == NULL)
+            if (instance->event_sender_count == 0)
             {
-                if (create_event_sender(instance) != RESULT_OK)
+                if (create_event_senders(instance) != RESULT_OK)
                 {
                     update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_ERROR);
                 }
@@ -1860,11 +2301,20 @@ void telemetry_messenger_do_work(TELEMETRY_MESSENGER_HANDLE messenger_handle)
             {
                 destroy_message_receiver(instance);
             }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_215: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set and `instance->message_receiver` is open, its link credit shall be updated]
+            else if (instance->is_c2d_prefetch_set && instance->message_receiver_current_state == MESSAGE_RECEIVER_STATE_OPEN)
+            {
+                update_receiver_link_credit(instance);
+            }
 
             if (process_event_send_timeouts(instance) != RESULT_OK)
             {
                 update_messenger_state(instance, TELEMETRY_MESSENGER_STATE_ERROR);
             }
+            else if (should_linger(instance))
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_191: [If the linger policy in TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING says events shall be held, telemetry_messenger_do_work() shall not send pending events]
+            }
             else if (send_pending_events(instance) != RESULT_OK && instance->event_send_retry_limit > 0)
             {
                 instance->event_send_error_count++;
@@ -1914,7 +2364,8 @@ void telemetry_messenger_destroy(TELEMETRY_MESSENGER_HANDLE messenger_handle)
 
             if (task != NULL)
             {
-                singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_MESSENGER_DESTROYED);
+                TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT send_result = (task->is_completed ? task->send_result : TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_MESSENGER_DESTROYED);
+                singlylinkedlist_foreach(task->callback_list, invoke_callback, (void*)((size_t)send_result));
                 free_task(task);
             }
         }
@@ -1944,6 +2395,16 @@ void telemetry_messenger_destroy(TELEMETRY_MESSENGER_HANDLE messenger_handle)
 
         STRING_delete(instance->product_info);
 
+        if (instance->event_batching_tick_counter != NULL)
+        {
+            tickcounter_destroy(instance->event_batching_tick_counter);
+        }
+
+        if (instance->encode_buffer != NULL)
+        {
+            BUFFER_delete(instance->encode_buffer);
+        }
+
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_114: [telemetry_messenger_destroy() shall destroy `instance` with free()]
         (void)free(instance);
     }
@@ -1974,6 +2435,7 @@ TELEMETRY_MESSENGER_HANDLE telemetry_messenger_create(const TELEMETRY_MESSENGER_
     else
     {
         TELEMETRY_MESSENGER_INSTANCE* instance;
+        size_t i;
 
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_006: [telemetry_messenger_create() shall allocate memory for the messenger instance structure (aka `instance`)]
         if ((instance = (TELEMETRY_MESSENGER_INSTANCE*)malloc(sizeof(TELEMETRY_MESSENGER_INSTANCE))) == NULL)
@@ -1986,14 +2448,20 @@ TELEMETRY_MESSENGER_HANDLE telemetry_messenger_create(const TELEMETRY_MESSENGER_
         {
             memset(instance, 0, sizeof(TELEMETRY_MESSENGER_INSTANCE));
             instance->state = TELEMETRY_MESSENGER_STATE_STOPPED;
-            instance->message_sender_current_state = MESSAGE_SENDER_STATE_IDLE;
-            instance->message_sender_previous_state = MESSAGE_SENDER_STATE_IDLE;
             instance->message_receiver_current_state = MESSAGE_RECEIVER_STATE_IDLE;
             instance->message_receiver_previous_state = MESSAGE_RECEIVER_STATE_IDLE;
             instance->event_send_retry_limit = DEFAULT_EVENT_SEND_RETRY_LIMIT;
             instance->event_send_timeout_secs = DEFAULT_EVENT_SEND_TIMEOUT_SECS;
-            instance->last_message_sender_state_change_time = INDEFINITE_TIME;
             instance->last_message_receiver_state_change_time = INDEFINITE_TIME;
+            instance->event_sender_links.link_count = DEFAULT_EVENT_SENDER_LINK_COUNT;
+
+            for (i = 0; i < MAX_EVENT_SENDER_LINK_COUNT; i++)
+            {
+                instance->event_senders[i].messenger = instance;
+                instance->event_senders[i].message_sender_current_state = MESSAGE_SENDER_STATE_IDLE;
+                instance->event_senders[i].message_sender_previous_state = MESSAGE_SENDER_STATE_IDLE;
+                instance->event_senders[i].last_message_sender_state_change_time = INDEFINITE_TIME;
+            }
 
             // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_008: [telemetry_messenger_create() shall save a copy of `messenger_config->device_id` into `instance->device_id`]
             if ((instance->device_id = STRING_construct(messenger_config->device_id)) == NULL)
@@ -2028,6 +2496,13 @@ TELEMETRY_MESSENGER_HANDLE telemetry_messenger_create(const TELEMETRY_MESSENGER_
                 handle = NULL;
                 LogError("telemetry_messenger_create failed (singlylinkedlist_create failed to create in_progress_list)");
             }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_200: [`instance->encode_buffer` shall be created using BUFFER_new()]
+            else if ((instance->encode_buffer = BUFFER_new()) == NULL)
+            {
+                // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_201: [If BUFFER_new() fails, telemetry_messenger_create() shall fail and return NULL]
+                handle = NULL;
+                LogError("telemetry_messenger_create failed (BUFFER_new failed to create encode_buffer)");
+            }
             else
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_013: [`messenger_config->on_state_changed_callback` shall be saved into `instance->on_state_changed_callback`]
@@ -2071,6 +2546,65 @@ int telemetry_messenger_set_option(TELEMETRY_MESSENGER_HANDLE messenger_handle,
             instance->event_send_timeout_secs = *((size_t*)value);
             result = RESULT_OK;
         }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_190: [If name matches TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, `value` shall be saved on `instance->event_batching`, creating a tickcounter if a linger time is set]
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, name) == 0)
+        {
+            IOTHUB_EVENT_BATCHING_OPTIONS* event_batching = (IOTHUB_EVENT_BATCHING_OPTIONS*)value;
+
+            if (event_batching->linger_time_ms > 0 &&
+                instance->event_batching_tick_counter == NULL &&
+                (instance->event_batching_tick_counter = tickcounter_create()) == NULL)
+            {
+                LogError("telemetry_messenger_set_option failed (tickcounter_create failed)");
+                result = __FAILURE__;
+            }
+            else
+            {
+                instance->event_batching = *event_batching;
+                instance->lingering_event_count = 0;
+                instance->lingering_event_bytes = 0;
+                result = RESULT_OK;
+            }
+        }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_202: [If name matches TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, `value` shall be saved on `instance->event_sender_links`; `link_count` and `ordered_completion` take effect the next time the messenger starts]
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, name) == 0)
+        {
+            IOTHUB_EVENT_SENDER_LINKS_OPTIONS* event_sender_links = (IOTHUB_EVENT_SENDER_LINKS_OPTIONS*)value;
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_203: [If `link_count` is zero or greater than MAX_EVENT_SENDER_LINK_COUNT, telemetry_messenger_set_option shall fail and return a non-zero value]
+            if (event_sender_links->link_count == 0 || event_sender_links->link_count > MAX_EVENT_SENDER_LINK_COUNT)
+            {
+                LogError("telemetry_messenger_set_option failed (invalid event sender link count %lu; must be between 1 and %d)", (unsigned long)event_sender_links->link_count, MAX_EVENT_SENDER_LINK_COUNT);
+                result = __FAILURE__;
+            }
+            else
+            {
+                instance->event_sender_links = *event_sender_links;
+                result = RESULT_OK;
+            }
+        }
+        // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_211: [If name matches TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, `value` shall be saved on `instance->c2d_prefetch`; it takes effect the next time the message receiver is created]
+        else if (strcmp(TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, name) == 0)
+        {
+            IOTHUB_C2D_PREFETCH_OPTIONS* c2d_prefetch = (IOTHUB_C2D_PREFETCH_OPTIONS*)value;
+
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_212: [If `min_credit` is zero, `initial_credit` is not between `min_credit` and `max_credit`, or `max_credit` is greater than UINT32_MAX, telemetry_messenger_set_option shall fail and return a non-zero value]
+            if (c2d_prefetch->min_credit == 0 ||
+                c2d_prefetch->initial_credit < c2d_prefetch->min_credit ||
+                c2d_prefetch->initial_credit > c2d_prefetch->max_credit ||
+                c2d_prefetch->max_credit > UINT32_MAX)
+            {
+                LogError("telemetry_messenger_set_option failed (invalid C2D prefetch credit; initial=%lu, min=%lu, max=%lu)",
+                    (unsigned long)c2d_prefetch->initial_credit, (unsigned long)c2d_prefetch->min_credit, (unsigned long)c2d_prefetch->max_credit);
+                result = __FAILURE__;
+            }
+            else
+            {
+                instance->c2d_prefetch = *c2d_prefetch;
+                instance->is_c2d_prefetch_set = true;
+                result = RESULT_OK;
+            }
+        }
         // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_169: [If name matches TELEMETRY_MESSENGER_OPTION_SAVED_OPTIONS, `value` shall be applied using OptionHandler_FeedOptions]
         else if (strcmp(TELEMETRY_MESSENGER_OPTION_SAVED_OPTIONS, name) == 0)
         {
@@ -2129,6 +2663,25 @@ OPTIONHANDLER_HANDLE telemetry_messenger_retrieve_options(TELEMETRY_MESSENGER_HA
                 LogError("Failed to retrieve options from messenger instance (OptionHandler_Create failed for option '%s')", TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS);
                 result = NULL;
             }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_220: [TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING shall be added with the value of `instance->event_batching`]
+            else if (OptionHandler_AddOption(options, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, (void*)&instance->event_batching) != OPTIONHANDLER_OK)
+            {
+                LogError("Failed to retrieve options from messenger instance (OptionHandler_Create failed for option '%s')", TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING);
+                result = NULL;
+            }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_223: [TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS shall be added with the value of `instance->event_sender_links`]
+            else if (OptionHandler_AddOption(options, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, (void*)&instance->event_sender_links) != OPTIONHANDLER_OK)
+            {
+                LogError("Failed to retrieve options from messenger instance (OptionHandler_Create failed for option '%s')", TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS);
+                result = NULL;
+            }
+            // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_224: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set, it shall be added with the value of `instance->c2d_prefetch`]
+            else if (instance->is_c2d_prefetch_set &&
+                OptionHandler_AddOption(options, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, (void*)&instance->c2d_prefetch) != OPTIONHANDLER_OK)
+            {
+                LogError("Failed to retrieve options from messenger instance (OptionHandler_Create failed for option '%s')", TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH);
+                result = NULL;
+            }
             else
             {
                 // Codes_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_179: [If no failures occur, telemetry_messenger_retrieve_options shall return the OPTIONHANDLER_HANDLE instance]
@@ -13,6 +13,7 @@
 #include "azure_c_shared_utility/singlylinkedlist.h"
 #include "azure_uamqp_c/amqp_definitions_fields.h"
 #include "azure_uamqp_c/messaging.h"
+#include "parson.h"
 #include "iothub_client_private.h"
 #include "iothubtransport_amqp_messenger.h"
 #include "iothubtransport_amqp_twin_messenger.h"
@@ -48,6 +49,7 @@ DEFINE_ENUM_STRINGS(TWIN_UPDATE_TYPE, TWIN_UPDATE_TYPE_VALUES);
 
 #define DEFAULT_MAX_TWIN_SUBSCRIPTION_ERROR_COUNT		3
 #define DEFAULT_TWIN_OPERATION_TIMEOUT_SECS				300.0
+#define MAX_REPORTED_STATE_COALESCE_SECS				60
 
 static char* DEFAULT_TWIN_SEND_LINK_SOURCE_NAME =		"twin";
 static char* DEFAULT_TWIN_RECEIVE_LINK_TARGET_NAME =	"twin";
@@ -96,6 +98,7 @@ typedef struct TWIN_MESSENGER_INSTANCE_TAG
 
 	SINGLYLINKEDLIST_HANDLE pending_patches;
 	SINGLYLINKEDLIST_HANDLE operations;
+	size_t reported_state_coalesce_secs;
 	
 	TWIN_MESSENGER_STATE_CHANGED_CALLBACK on_state_changed_callback;
 	void* on_state_changed_context;
@@ -116,8 +119,22 @@ typedef struct TWIN_PATCH_OPERATION_CONTEXT_TAG
 	TWIN_MESSENGER_REPORT_STATE_COMPLETE_CALLBACK on_report_state_complete_callback;
 	const void* on_report_state_complete_context;
 	time_t time_enqueued;
+	bool is_coalesced;
 } TWIN_PATCH_OPERATION_CONTEXT;
 
+typedef struct REPORT_STATE_COMPLETE_CALLBACK_INFO_TAG
+{
+	TWIN_MESSENGER_REPORT_STATE_COMPLETE_CALLBACK callback;
+	const void* context;
+} REPORT_STATE_COMPLETE_CALLBACK_INFO;
+
+// Completion target of a PATCH built from several coalesced reported state patches.
+typedef struct COALESCED_PATCH_CONTEXT_TAG
+{
+	REPORT_STATE_COMPLETE_CALLBACK_INFO* callbacks;
+	size_t callback_count;
+} COALESCED_PATCH_CONTEXT;
+
 typedef struct TWIN_OPERATION_CONTEXT_TAG
 {
 	TWIN_OPERATION_TYPE type;
@@ -1173,6 +1190,340 @@ static bool send_pending_twin_patch(const void* item, const void* match_context,
 	return result;
 }
 
+static void on_coalesced_patch_complete_callback(TWIN_REPORT_STATE_RESULT result, TWIN_REPORT_STATE_REASON reason, int status_code, const void* context)
+{
+	COALESCED_PATCH_CONTEXT* coalesced_ctx = (COALESCED_PATCH_CONTEXT*)context;
+	size_t i;
+
+	// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_113: [When a coalesced PATCH completes, the `on_report_state_complete_callback` of each original request shall be invoked with the same result, reason and status code, in the order the requests were made]
+	for (i = 0; i < coalesced_ctx->callback_count; i++)
+	{
+		if (coalesced_ctx->callbacks[i].callback != NULL)
+		{
+			coalesced_ctx->callbacks[i].callback(result, reason, status_code, coalesced_ctx->callbacks[i].context);
+		}
+	}
+
+	free(coalesced_ctx->callbacks);
+	free(coalesced_ctx);
+}
+
+static int merge_reported_state_patch(JSON_Object* target, JSON_Object* patch)
+{
+	int result = RESULT_OK;
+	size_t count = json_object_get_count(patch);
+	size_t i;
+
+	for (i = 0; i < count && result == RESULT_OK; i++)
+	{
+		const char* name = json_object_get_name(patch, i);
+		JSON_Value* value = json_object_get_value(patch, name);
+		JSON_Object* target_child = json_object_get_object(target, name);
+
+		if (target_child != NULL && json_value_get_type(value) == JSONObject)
+		{
+			result = merge_reported_state_patch(target_child, json_value_get_object(value));
+		}
+		else
+		{
+			JSON_Value* value_copy;
+
+			if ((value_copy = json_value_deep_copy(value)) == NULL)
+			{
+				LogError("Failed copying reported property '%s'", name);
+				result = __FAILURE__;
+			}
+			else if (json_object_set_value(target, name, value_copy) != JSONSuccess)
+			{
+				LogError("Failed setting reported property '%s'", name);
+				json_value_free(value_copy);
+				result = __FAILURE__;
+			}
+		}
+	}
+
+	return result;
+}
+
+// @brief
+//     Verifies if `patch` can be merged into `target` without changing the result of applying both on the service.
+//     An object cannot be merged into a property set to null (deleted) or to a non-object value, as the service would
+//     merge it into the property's current value instead of starting from an empty one.
+static bool can_merge_reported_state_patch(JSON_Object* target, JSON_Object* patch)
+{
+	bool result = true;
+	size_t count = json_object_get_count(patch);
+	size_t i;
+
+	for (i = 0; i < count && result; i++)
+	{
+		const char* name = json_object_get_name(patch, i);
+		JSON_Value* value = json_object_get_value(patch, name);
+		JSON_Value* target_value = json_object_get_value(target, name);
+
+		if (target_value != NULL && json_value_get_type(value) == JSONObject)
+		{
+			if (json_value_get_type(target_value) != JSONObject)
+			{
+				result = false;
+			}
+			else
+			{
+				result = can_merge_reported_state_patch(json_value_get_object(target_value), json_value_get_object(value));
+			}
+		}
+	}
+
+	return result;
+}
+
+static JSON_Value* parse_reported_state_patch(CONSTBUFFER_HANDLE data)
+{
+	JSON_Value* result;
+	const CONSTBUFFER* content = CONSTBUFFER_GetContent(data);
+	char* json_string;
+
+	if ((json_string = (char*)malloc(content->size + 1)) == NULL)
+	{
+		LogError("Failed allocating reported state patch string");
+		result = NULL;
+	}
+	else
+	{
+		(void)memcpy(json_string, content->buffer, content->size);
+		json_string[content->size] = '\0';
+
+		if ((result = json_parse_string(json_string)) == NULL)
+		{
+			LogError("Failed parsing reported state patch");
+		}
+		else if (json_value_get_type(result) != JSONObject)
+		{
+			LogError("Reported state patch is not a JSON object");
+			json_value_free(result);
+			result = NULL;
+		}
+
+		free(json_string);
+	}
+
+	return result;
+}
+
+static bool remove_coalesced_twin_patch(const void* item, const void* match_context, bool* continue_processing)
+{
+	bool result;
+	TWIN_PATCH_OPERATION_CONTEXT* twin_patch_ctx = (TWIN_PATCH_OPERATION_CONTEXT*)item;
+
+	(void)match_context;
+
+	if (!twin_patch_ctx->is_coalesced)
+	{
+		result = false;
+	}
+	else
+	{
+		CONSTBUFFER_Destroy(twin_patch_ctx->data);
+		free(twin_patch_ctx);
+		result = true;
+	}
+
+	*continue_processing = true;
+
+	return result;
+}
+
+// @brief
+//     Merges the run of pending patches starting at `first_item` into the first patch of the run (last writer wins for each property path).
+//     The run ends before the first patch that cannot be merged into the previous ones; the other patches of the run are flagged with `is_coalesced`.
+// @returns
+//     0 if the run was merged, non-zero otherwise (the patches of the run are left untouched). `next_item` is set to the first patch after the run.
+static int coalesce_twin_patch_run(TWIN_MESSENGER_INSTANCE* twin_msgr, LIST_ITEM_HANDLE first_item, LIST_ITEM_HANDLE* next_item)
+{
+	int result;
+	TWIN_PATCH_OPERATION_CONTEXT* first_patch_ctx = (TWIN_PATCH_OPERATION_CONTEXT*)singlylinkedlist_item_get_value(first_item);
+	LIST_ITEM_HANDLE list_item = singlylinkedlist_get_next_item(first_item);
+	JSON_Value* merged_value;
+
+	if (list_item == NULL)
+	{
+		// Nothing to merge the last patch with.
+		*next_item = NULL;
+		result = RESULT_OK;
+	}
+	else if ((merged_value = parse_reported_state_patch(first_patch_ctx->data)) == NULL)
+	{
+		*next_item = list_item;
+		result = __FAILURE__;
+	}
+	else
+	{
+		size_t run_length = 1;
+		bool is_end_of_run = false;
+
+		result = RESULT_OK;
+
+		// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_111: [The pending patches shall be merged in the order they were queued, later values replacing earlier ones for the same property path]
+		while (list_item != NULL && result == RESULT_OK && !is_end_of_run)
+		{
+			TWIN_PATCH_OPERATION_CONTEXT* twin_patch_ctx = (TWIN_PATCH_OPERATION_CONTEXT*)singlylinkedlist_item_get_value(list_item);
+			JSON_Value* patch_value;
+
+			if ((patch_value = parse_reported_state_patch(twin_patch_ctx->data)) == NULL)
+			{
+				result = __FAILURE__;
+			}
+			else
+			{
+				// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_115: [A patch that sets a JSON object on a property an earlier pending patch set to null or to a non-object value shall not be merged, and shall start a new merged patch]
+				if (!can_merge_reported_state_patch(json_value_get_object(merged_value), json_value_get_object(patch_value)))
+				{
+					is_end_of_run = true;
+				}
+				else if ((result = merge_reported_state_patch(json_value_get_object(merged_value), json_value_get_object(patch_value))) == RESULT_OK)
+				{
+					run_length++;
+					list_item = singlylinkedlist_get_next_item(list_item);
+				}
+
+				json_value_free(patch_value);
+			}
+		}
+
+		*next_item = list_item;
+
+		if (result != RESULT_OK)
+		{
+			LogError("Failed merging reported state patches (%s)", twin_msgr->device_id);
+		}
+		else if (run_length > 1)
+		{
+			COALESCED_PATCH_CONTEXT* coalesced_ctx;
+			char* merged_json;
+
+			if ((coalesced_ctx = (COALESCED_PATCH_CONTEXT*)malloc(sizeof(COALESCED_PATCH_CONTEXT))) == NULL)
+			{
+				LogError("Failed allocating coalesced patch context (%s)", twin_msgr->device_id);
+				result = __FAILURE__;
+			}
+			else if ((coalesced_ctx->callbacks = (REPORT_STATE_COMPLETE_CALLBACK_INFO*)malloc(run_length * sizeof(REPORT_STATE_COMPLETE_CALLBACK_INFO))) == NULL)
+			{
+				LogError("Failed allocating coalesced patch callbacks (%s)", twin_msgr->device_id);
+				free(coalesced_ctx);
+				result = __FAILURE__;
+			}
+			else if ((merged_json = json_serialize_to_string(merged_value)) == NULL)
+			{
+				LogError("Failed serializing coalesced patch (%s)", twin_msgr->device_id);
+				free(coalesced_ctx->callbacks);
+				free(coalesced_ctx);
+				result = __FAILURE__;
+			}
+			else
+			{
+				CONSTBUFFER_HANDLE merged_data;
+
+				if ((merged_data = CONSTBUFFER_Create((const unsigned char*)merged_json, strlen(merged_json))) == NULL)
+				{
+					LogError("Failed creating coalesced patch data (%s)", twin_msgr->device_id);
+					free(coalesced_ctx->callbacks);
+					free(coalesced_ctx);
+					result = __FAILURE__;
+				}
+				else
+				{
+					list_item = first_item;
+
+					for (coalesced_ctx->callback_count = 0; coalesced_ctx->callback_count < run_length; coalesced_ctx->callback_count++)
+					{
+						TWIN_PATCH_OPERATION_CONTEXT* twin_patch_ctx = (TWIN_PATCH_OPERATION_CONTEXT*)singlylinkedlist_item_get_value(list_item);
+
+						coalesced_ctx->callbacks[coalesced_ctx->callback_count].callback = twin_patch_ctx->on_report_state_complete_callback;
+						coalesced_ctx->callbacks[coalesced_ctx->callback_count].context = twin_patch_ctx->on_report_state_complete_context;
+						twin_patch_ctx->is_coalesced = (twin_patch_ctx != first_patch_ctx);
+
+						list_item = singlylinkedlist_get_next_item(list_item);
+					}
+
+					// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_112: [The patches of each run shall be replaced in `twin_msgr->pending_patches` by a single merged patch, keeping the position of the first patch of the run]
+					CONSTBUFFER_Destroy(first_patch_ctx->data);
+					first_patch_ctx->data = merged_data;
+					first_patch_ctx->on_report_state_complete_callback = on_coalesced_patch_complete_callback;
+					first_patch_ctx->on_report_state_complete_context = coalesced_ctx;
+				}
+
+				json_free_serialized_string(merged_json);
+			}
+		}
+
+		json_value_free(merged_value);
+	}
+
+	return result;
+}
+
+// @brief
+//     Merges the pending reported state patches into as few patches as possible, keeping the order in which they are sent.
+// @returns
+//     0 if the patches were merged or there was nothing to merge, non-zero otherwise (the patches not merged yet are left untouched).
+static int coalesce_pending_twin_patches(TWIN_MESSENGER_INSTANCE* twin_msgr)
+{
+	int result = RESULT_OK;
+	LIST_ITEM_HANDLE list_item = singlylinkedlist_get_head_item(twin_msgr->pending_patches);
+
+	while (list_item != NULL && result == RESULT_OK)
+	{
+		result = coalesce_twin_patch_run(twin_msgr, list_item, &list_item);
+	}
+
+	(void)singlylinkedlist_remove_if(twin_msgr->pending_patches, remove_coalesced_twin_patch, NULL);
+
+	return result;
+}
+
+static bool is_time_to_send_pending_twin_patches(TWIN_MESSENGER_INSTANCE* twin_msgr)
+{
+	bool result;
+	LIST_ITEM_HANDLE list_item;
+
+	if (twin_msgr->reported_state_coalesce_secs == 0)
+	{
+		result = true;
+	}
+	else if ((list_item = singlylinkedlist_get_head_item(twin_msgr->pending_patches)) == NULL)
+	{
+		result = false;
+	}
+	else
+	{
+		TWIN_PATCH_OPERATION_CONTEXT* first_patch_ctx = (TWIN_PATCH_OPERATION_CONTEXT*)singlylinkedlist_item_get_value(list_item);
+		time_t current_time;
+
+		if ((current_time = get_time(NULL)) == INDEFINITE_TIME)
+		{
+			LogError("Failed obtaining current time (%s)", twin_msgr->device_id);
+			result = true;
+		}
+		// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_110: [If reported state coalescing is enabled, pending patches shall be held until the oldest one has been queued for at least `reported_state_coalesce_secs`]
+		else if (get_difftime(current_time, first_patch_ctx->time_enqueued) < (double)twin_msgr->reported_state_coalesce_secs)
+		{
+			result = false;
+		}
+		else
+		{
+			if (coalesce_pending_twin_patches(twin_msgr) != RESULT_OK)
+			{
+				// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_114: [If the pending patches cannot be merged, they shall be sent individually]
+				LogError("Failed coalescing reported state patches; sending them individually (%s)", twin_msgr->device_id);
+			}
+
+			result = true;
+		}
+	}
+
+	return result;
+}
+
 static void process_twin_subscription(TWIN_MESSENGER_INSTANCE* twin_msgr)
 {
 	// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_078: [If failures occur sending subscription requests to the service for more than 3 times, TWIN messenger shall set its state to TWIN_MESSENGER_STATE_ERROR and inform the user]
@@ -1836,6 +2187,7 @@ int twin_messenger_report_state_async(TWIN_MESSENGER_HANDLE twin_msgr_handle, CO
 		{
 			twin_patch_ctx->on_report_state_complete_callback = on_report_state_complete_callback;
 			twin_patch_ctx->on_report_state_complete_context = context;
+			twin_patch_ctx->is_coalesced = false;
 
 			// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_029: [`twin_op_ctx` shall be added to `twin_msgr->pending_patches` using singlylinkedlist_add()]  
 			if (singlylinkedlist_add(twin_msgr->pending_patches, twin_patch_ctx) == NULL)
@@ -2032,7 +2384,10 @@ void twin_messenger_do_work(TWIN_MESSENGER_HANDLE twin_msgr_handle)
 		if (twin_msgr->state == TWIN_MESSENGER_STATE_STARTED)
 		{
 			// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_058: [If `twin_msgr->state` is TWIN_MESSENGER_STATE_STARTED, twin_messenger_do_work() shall send the PATCHES in `twin_msgr->pending_patches`, removing them from the list]
-			(void)singlylinkedlist_remove_if(twin_msgr->pending_patches, send_pending_twin_patch, (const void*)twin_msgr);
+			if (is_time_to_send_pending_twin_patches(twin_msgr))
+			{
+				(void)singlylinkedlist_remove_if(twin_msgr->pending_patches, send_pending_twin_patch, (const void*)twin_msgr);
+			}
 
 			process_twin_subscription(twin_msgr);
 		}
@@ -2071,8 +2426,24 @@ int twin_messenger_set_option(TWIN_MESSENGER_HANDLE twin_msgr_handle, const char
 	{
 		TWIN_MESSENGER_INSTANCE* twin_msgr = (TWIN_MESSENGER_INSTANCE*)twin_msgr_handle;
 
+		if (strcmp(TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, name) == 0)
+		{
+			size_t coalesce_secs = *(size_t*)value;
+
+			// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_109: [If `name` is TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, `value` shall be saved as the reported state coalescing window; values above 60 shall fail]
+			if (coalesce_secs > MAX_REPORTED_STATE_COALESCE_SECS)
+			{
+				LogError("Invalid reported state coalescing window (%s, %lu)", twin_msgr->device_id, (unsigned long)coalesce_secs);
+				result = __FAILURE__;
+			}
+			else
+			{
+				twin_msgr->reported_state_coalesce_secs = coalesce_secs;
+				result = RESULT_OK;
+			}
+		}
 		// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_104: [amqp_messenger_set_option() shall be invoked passing `name` and `option`]
-		if (amqp_messenger_set_option(twin_msgr->amqp_msgr, name, value) != RESULT_OK)
+		else if (amqp_messenger_set_option(twin_msgr->amqp_msgr, name, value) != RESULT_OK)
 		{
 			// Codes_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_105: [If amqp_messenger_set_option() fails, twin_messenger_set_option() shall fail and return a non-zero value]
 			LogError("Failed setting TWIN messenger option (%s, %s)", twin_msgr->device_id, name);
@@ -28,6 +28,7 @@
 #include "iothub_client_retry_control.h"
 
 #include "iothubtransport_mqtt_common.h"
+#include "parson.h"
 
 #include <stdarg.h>
 #include <stdio.h>
@@ -48,6 +49,7 @@
 #define FAILED_CONN_BACKOFF_VALUE           5
 #define STATUS_CODE_FAILURE_VALUE           500
 #define STATUS_CODE_TIMEOUT_VALUE           408
+#define MAX_REPORTED_STATE_COALESCE_SECS    60
 
 #define DEFAULT_RETRY_POLICY                IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER
 #define DEFAULT_RETRY_TIMEOUT_IN_SECONDS    0
@@ -176,6 +178,9 @@ typedef struct MQTTTRANSPORT_HANDLE_DATA_TAG
     bool isDestroyCalled;
     bool device_twin_get_sent;
     bool isRecoverableError;
+    bool useCleanSession;
+    bool isSessionPresent;
+    bool resendInflightMessages;
     uint16_t keepAliveValue;
     uint16_t connect_timeout_in_sec;
     tickcounter_ms_t mqtt_connect_time;
@@ -191,6 +196,11 @@ typedef struct MQTTTRANSPORT_HANDLE_DATA_TAG
     PDLIST_ENTRY waitingToSend;
     DLIST_ENTRY ack_waiting_queue;
 
+    // Reported state coalescing, 0 sends every reported state as soon as it is processed
+    size_t option_twin_reported_state_coalesce_secs;
+    // Reported states held until the oldest one is option_twin_reported_state_coalesce_secs old
+    DLIST_ENTRY reported_state_waiting;
+
     // Message tracking
     CONTROL_PACKET_TYPE currPacketState;
 
@@ -221,6 +231,7 @@ typedef struct MQTT_DEVICE_TWIN_ITEM_TAG
     IOTHUB_DEVICE_TWIN* device_twin_data;
     DEVICE_TWIN_MSG_TYPE device_twin_msg_type;
     DLIST_ENTRY entry;
+    struct MQTT_DEVICE_TWIN_ITEM_TAG* next_coalesced;  // reported states merged into this one, completed along with it
 } MQTT_DEVICE_TWIN_ITEM;
 
 typedef struct MQTT_MESSAGE_DETAILS_LIST_TAG
@@ -748,7 +759,7 @@ static STRING_HANDLE addPropertiesTouMqttMessage(IOTHUB_MESSAGE_HANDLE iothub_me
     return result;
 }
 
-static int publish_mqtt_telemetry_msg(PMQTTTRANSPORT_HANDLE_DATA transport_data, MQTT_MESSAGE_DETAILS_LIST* mqttMsgEntry, const unsigned char* payload, size_t len)
+static int publish_mqtt_telemetry_msg(PMQTTTRANSPORT_HANDLE_DATA transport_data, MQTT_MESSAGE_DETAILS_LIST* mqttMsgEntry, const unsigned char* payload, size_t len, bool is_duplicate)
 {
     int result;
     STRING_HANDLE msgTopic = addPropertiesTouMqttMessage(mqttMsgEntry->iotHubMessageEntry->messageHandle, STRING_c_str(transport_data->topic_MqttEvent));
@@ -765,6 +776,13 @@ static int publish_mqtt_telemetry_msg(PMQTTTRANSPORT_HANDLE_DATA transport_data,
             LogError("Failed creating mqtt message");
             result = __FAILURE__;
         }
+        // Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_018: [ A telemetry message republished with the same packet id shall have the DUP flag set using mqttmessage_setIsDuplicateMsg ]
+        else if (is_duplicate && mqttmessage_setIsDuplicateMsg(mqttMsg, true) != 0)
+        {
+            LogError("Failed setting the duplicate flag on the mqtt message");
+            mqttmessage_destroy(mqttMsg);
+            result = __FAILURE__;
+        }
         else
         {
             if (tickcounter_get_current_ms(transport_data->msgTickCounter, &mqttMsgEntry->msgPublishTime) != 0)
@@ -847,6 +865,7 @@ static int publish_device_twin_get_message(MQTTTRANSPORT_HANDLE_DATA* transport_
         mqtt_info->msgPublishTime = 0;
         mqtt_info->iothub_type = IOTHUB_TYPE_DEVICE_TWIN;
         mqtt_info->device_twin_data = NULL;
+        mqtt_info->next_coalesced = NULL;
         STRING_HANDLE msg_topic = STRING_construct_sprintf(GET_PROPERTIES_TOPIC, mqtt_info->packet_id);
         if (msg_topic == NULL)
         {
@@ -884,7 +903,7 @@ static int publish_device_twin_get_message(MQTTTRANSPORT_HANDLE_DATA* transport_
     return result;
 }
 
-static int publish_device_twin_message(MQTTTRANSPORT_HANDLE_DATA* transport_data, IOTHUB_DEVICE_TWIN* device_twin_info, MQTT_DEVICE_TWIN_ITEM* mqtt_info)
+static int publish_device_twin_message(MQTTTRANSPORT_HANDLE_DATA* transport_data, CONSTBUFFER_HANDLE report_data_handle, MQTT_DEVICE_TWIN_ITEM* mqtt_info)
 {
     int result;
     mqtt_info->packet_id = get_next_packet_id(transport_data);
@@ -897,7 +916,7 @@ static int publish_device_twin_message(MQTTTRANSPORT_HANDLE_DATA* transport_data
     }
     else
     {
-        const CONSTBUFFER* data_buff = CONSTBUFFER_GetContent(device_twin_info->report_data_handle);
+        const CONSTBUFFER* data_buff = CONSTBUFFER_GetContent(report_data_handle);
         MQTT_MESSAGE_HANDLE mqtt_rpt_msg = mqttmessage_create(mqtt_info->packet_id, STRING_c_str(msgTopic), DELIVER_AT_MOST_ONCE, data_buff->buffer, data_buff->size);
         if (mqtt_rpt_msg == NULL)
         {
@@ -931,6 +950,228 @@ static int publish_device_twin_message(MQTTTRANSPORT_HANDLE_DATA* transport_data
     return result;
 }
 
+static void complete_reported_state(MQTTTRANSPORT_HANDLE_DATA* transport_data, MQTT_DEVICE_TWIN_ITEM* mqtt_info, int status_code)
+{
+    /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_004: [ When a coalesced reported state completes, IoTHubClient_LL_ReportedStateComplete shall be called with the same status code for each of the reported states it was merged from, in the order they were processed. ] */
+    while (mqtt_info != NULL)
+    {
+        MQTT_DEVICE_TWIN_ITEM* next_coalesced = mqtt_info->next_coalesced;
+        IoTHubClient_LL_ReportedStateComplete(transport_data->llClientHandle, mqtt_info->iothub_msg_id, status_code);
+        free(mqtt_info);
+        mqtt_info = next_coalesced;
+    }
+}
+
+static JSON_Value* parse_reported_state(CONSTBUFFER_HANDLE report_data_handle)
+{
+    JSON_Value* result;
+    const CONSTBUFFER* data_buff = CONSTBUFFER_GetContent(report_data_handle);
+    char* json_string = (char*)malloc(data_buff->size + 1);
+    if (json_string == NULL)
+    {
+        LogError("Failed allocating reported state string");
+        result = NULL;
+    }
+    else
+    {
+        (void)memcpy(json_string, data_buff->buffer, data_buff->size);
+        json_string[data_buff->size] = '\0';
+
+        result = json_parse_string(json_string);
+        if (result == NULL)
+        {
+            LogError("Failed parsing reported state");
+        }
+        else if (json_value_get_type(result) != JSONObject)
+        {
+            LogError("Reported state is not a JSON object");
+            json_value_free(result);
+            result = NULL;
+        }
+        free(json_string);
+    }
+    return result;
+}
+
+/* An object cannot be merged over a property that an earlier reported state deleted (null) or set to a non-object, */
+/* the service would merge it with the property's current value instead. */
+static bool can_merge_reported_state(JSON_Object* merged, JSON_Object* reported)
+{
+    bool result = true;
+    size_t count = json_object_get_count(reported);
+    size_t index;
+    for (index = 0; index < count && result; index++)
+    {
+        const char* name = json_object_get_name(reported, index);
+        JSON_Value* value = json_object_get_value(reported, name);
+        JSON_Value* merged_value = json_object_get_value(merged, name);
+        if (merged_value != NULL && json_value_get_type(value) == JSONObject)
+        {
+            result = (json_value_get_type(merged_value) == JSONObject) &&
+                can_merge_reported_state(json_value_get_object(merged_value), json_value_get_object(value));
+        }
+    }
+    return result;
+}
+
+static int merge_reported_state(JSON_Object* merged, JSON_Object* reported)
+{
+    int result = 0;
+    size_t count = json_object_get_count(reported);
+    size_t index;
+    for (index = 0; index < count && result == 0; index++)
+    {
+        const char* name = json_object_get_name(reported, index);
+        JSON_Value* value = json_object_get_value(reported, name);
+        JSON_Object* merged_child = json_object_get_object(merged, name);
+        if (merged_child != NULL && json_value_get_type(value) == JSONObject)
+        {
+            result = merge_reported_state(merged_child, json_value_get_object(value));
+        }
+        else
+        {
+            JSON_Value* value_copy = json_value_deep_copy(value);
+            if (value_copy == NULL)
+            {
+                LogError("Failed copying reported property %s", name);
+                result = __FAILURE__;
+            }
+            else if (json_object_set_value(merged, name, value_copy) != JSONSuccess)
+            {
+                LogError("Failed setting reported property %s", name);
+                json_value_free(value_copy);
+                result = __FAILURE__;
+            }
+        }
+    }
+    return result;
+}
+
+/* Takes from reported_state_waiting the reported states that can be merged with first_info and merges them, */
+/* last writer wins per property path. They are chained in first_info->next_coalesced and *merged_data */
+/* receives the merged JSON. On failure they are put back in reported_state_waiting and first_info is sent alone. */
+static int coalesce_reported_states(MQTTTRANSPORT_HANDLE_DATA* transport_data, MQTT_DEVICE_TWIN_ITEM* first_info, CONSTBUFFER_HANDLE* merged_data)
+{
+    int result;
+    JSON_Value* merged_value = parse_reported_state(first_info->device_twin_data->report_data_handle);
+    if (merged_value == NULL)
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        MQTT_DEVICE_TWIN_ITEM* last_info = first_info;
+        result = 0;
+
+        /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_002: [ The waiting reported states shall be merged in the order they were processed, later values replacing earlier ones for the same property path, into as few reported state messages as possible. ] */
+        while (result == 0 && !DList_IsListEmpty(&transport_data->reported_state_waiting))
+        {
+            MQTT_DEVICE_TWIN_ITEM* next_info = containingRecord(transport_data->reported_state_waiting.Flink, MQTT_DEVICE_TWIN_ITEM, entry);
+            JSON_Value* reported_value = parse_reported_state(next_info->device_twin_data->report_data_handle);
+            if (reported_value == NULL)
+            {
+                // sent on its own
+                break;
+            }
+            else if (!can_merge_reported_state(json_value_get_object(merged_value), json_value_get_object(reported_value)))
+            {
+                json_value_free(reported_value);
+                break;
+            }
+            else
+            {
+                result = merge_reported_state(json_value_get_object(merged_value), json_value_get_object(reported_value));
+                if (result == 0)
+                {
+                    (void)DList_RemoveEntryList(&next_info->entry);
+                    last_info->next_coalesced = next_info;
+                    last_info = next_info;
+                }
+                json_value_free(reported_value);
+            }
+        }
+
+        if (result == 0)
+        {
+            char* merged_json = json_serialize_to_string(merged_value);
+            if (merged_json == NULL)
+            {
+                LogError("Failed serializing coalesced reported state");
+                result = __FAILURE__;
+            }
+            else
+            {
+                if ((*merged_data = CONSTBUFFER_Create((const unsigned char*)merged_json, strlen(merged_json))) == NULL)
+                {
+                    LogError("Failed creating coalesced reported state");
+                    result = __FAILURE__;
+                }
+                json_free_serialized_string(merged_json);
+            }
+        }
+
+        if (result != 0)
+        {
+            /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_005: [ If the reported states cannot be merged they shall be published one by one. ] */
+            PDLIST_ENTRY insert_after = &transport_data->reported_state_waiting;
+            MQTT_DEVICE_TWIN_ITEM* coalesced_info = first_info->next_coalesced;
+            first_info->next_coalesced = NULL;
+            while (coalesced_info != NULL)
+            {
+                MQTT_DEVICE_TWIN_ITEM* next_coalesced = coalesced_info->next_coalesced;
+                coalesced_info->next_coalesced = NULL;
+                DList_InsertHeadList(insert_after, &coalesced_info->entry);
+                insert_after = &coalesced_info->entry;
+                coalesced_info = next_coalesced;
+            }
+        }
+        json_value_free(merged_value);
+    }
+    return result;
+}
+
+static void publish_waiting_reported_states(MQTTTRANSPORT_HANDLE_DATA* transport_data)
+{
+    if (transport_data->reported_state_waiting.Flink != &transport_data->reported_state_waiting)
+    {
+        MQTT_DEVICE_TWIN_ITEM* oldest_info = containingRecord(transport_data->reported_state_waiting.Flink, MQTT_DEVICE_TWIN_ITEM, entry);
+        tickcounter_ms_t current_ms;
+
+        if (tickcounter_get_current_ms(transport_data->msgTickCounter, &current_ms) != 0)
+        {
+            LogError("Failed retrieving tickcounter info");
+        }
+        /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_001: [ If reported state coalescing is enabled IoTHubTransport_MQTT_Common_DoWork shall hold the reported states until the oldest one has waited `twin_reported_state_coalesce_secs`. ] */
+        else if ((current_ms - oldest_info->msgPublishTime) / 1000 >= transport_data->option_twin_reported_state_coalesce_secs)
+        {
+            while (!DList_IsListEmpty(&transport_data->reported_state_waiting))
+            {
+                PDLIST_ENTRY first_entry = DList_RemoveHeadList(&transport_data->reported_state_waiting);
+                MQTT_DEVICE_TWIN_ITEM* first_info = containingRecord(first_entry, MQTT_DEVICE_TWIN_ITEM, entry);
+                CONSTBUFFER_HANDLE merged_data;
+
+                if (coalesce_reported_states(transport_data, first_info, &merged_data) != 0)
+                {
+                    merged_data = CONSTBUFFER_Clone(first_info->device_twin_data->report_data_handle);
+                }
+
+                /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_003: [ Each merged reported state shall be published as a single reported state message and added to the acknowledgement queue. ] */
+                DList_InsertTailList(&transport_data->ack_waiting_queue, &first_info->entry);
+                if (merged_data == NULL || publish_device_twin_message(transport_data, merged_data, first_info) != 0)
+                {
+                    LogError("Failed publishing coalesced reported state");
+                    (void)DList_RemoveEntryList(&first_info->entry);
+                    complete_reported_state(transport_data, first_info, STATUS_CODE_FAILURE_VALUE);
+                }
+                if (merged_data != NULL)
+                {
+                    CONSTBUFFER_Destroy(merged_data);
+                }
+            }
+        }
+    }
+}
+
 static bool isSystemProperty(const char* tokenData)
 {
     bool result = false;
@@ -1182,13 +1423,13 @@ static void mqtt_notification_callback(MQTT_MESSAGE_HANDLE msgHandle, void* call
                                 {
                                     /* Codes_SRS_IOTHUB_MQTT_TRANSPORT_07_054: [ If type is IOTHUB_TYPE_DEVICE_TWIN, then on success if msg_type is RETRIEVE_PROPERTIES then mqtt_notification_callback shall call IoTHubClient_LL_RetrievePropertyComplete... ] */
                                     IoTHubClient_LL_RetrievePropertyComplete(transportData->llClientHandle, DEVICE_TWIN_UPDATE_COMPLETE, payload->message, payload->length);
+                                    free(msg_entry);
                                 }
                                 else
                                 {
                                     /* Codes_SRS_IOTHUB_MQTT_TRANSPORT_07_055: [ if device_twin_msg_type is not RETRIEVE_PROPERTIES then mqtt_notification_callback shall call IoTHubClient_LL_ReportedStateComplete ] */
-                                    IoTHubClient_LL_ReportedStateComplete(transportData->llClientHandle, msg_entry->iothub_msg_id, status_code);
+                                    complete_reported_state(transportData, msg_entry, status_code);
                                 }
-                                free(msg_entry);
                                 break;
                             }
                             dev_twin_item = saveListEntry.Flink;
@@ -1331,6 +1572,10 @@ static void mqtt_operation_complete_callback(MQTT_CLIENT_HANDLE handle, MQTT_CLI
                         transport_data->isRecoverableError = true;
                         transport_data->mqttClientStatus = MQTT_CLIENT_STATUS_CONNECTED;
 
+                        // Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_016: [ Upon successful connection any telemetry still waiting for PUBACK shall be scheduled for immediate retransmission ]
+                        transport_data->isSessionPresent = connack->isSessionPresent;
+                        transport_data->resendInflightMessages = true;
+
                         // Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_008: [ Upon successful connection the retry control shall be reset using retry_control_reset() ]
                         retry_control_reset(transport_data->retry_control_handle);
 
@@ -1587,6 +1832,51 @@ static const unsigned char* RetrieveMessagePayload(IOTHUB_MESSAGE_HANDLE message
     return result;
 }
 
+static void ResendInflightMessages(PMQTTTRANSPORT_HANDLE_DATA transport_data)
+{
+    PDLIST_ENTRY currentListEntry = transport_data->telemetry_waitingForAck.Flink;
+
+    transport_data->resendInflightMessages = false;
+
+    while (currentListEntry != &transport_data->telemetry_waitingForAck)
+    {
+        MQTT_MESSAGE_DETAILS_LIST* mqttMsgEntry = containingRecord(currentListEntry, MQTT_MESSAGE_DETAILS_LIST, entry);
+        DLIST_ENTRY nextListEntry;
+        size_t messageLength;
+        const unsigned char* messagePayload;
+        bool is_duplicate;
+
+        nextListEntry.Flink = currentListEntry->Flink;
+
+        // Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_017: [ If the service reported the session as present the message shall be republished with its original packet id and the DUP flag set, otherwise it shall be published with a new packet id ]
+        if (transport_data->isSessionPresent)
+        {
+            is_duplicate = true;
+        }
+        else
+        {
+            mqttMsgEntry->packet_id = get_next_packet_id(transport_data);
+            is_duplicate = false;
+        }
+        // The reconnect republish does not count against MAX_SEND_RECOUNT_LIMIT
+        mqttMsgEntry->retryCount = 0;
+
+        messagePayload = RetrieveMessagePayload(mqttMsgEntry->iotHubMessageEntry->messageHandle, &messageLength);
+        if (messageLength == 0 || messagePayload == NULL)
+        {
+            LogError("Failure from creating Message IoTHubMessage_GetData");
+        }
+        else if (publish_mqtt_telemetry_msg(transport_data, mqttMsgEntry, messagePayload, messageLength, is_duplicate) != 0)
+        {
+            (void)DList_RemoveEntryList(currentListEntry);
+            sendMsgComplete(mqttMsgEntry->iotHubMessageEntry, transport_data, IOTHUB_CLIENT_CONFIRMATION_ERROR);
+            free(mqttMsgEntry);
+        }
+
+        currentListEntry = nextListEntry.Flink;
+    }
+}
+
 static int GetTransportProviderIfNecessary(PMQTTTRANSPORT_HANDLE_DATA transport_data)
 {
     int result;
@@ -1777,7 +2067,7 @@ static int SendMqttConnectMsg(PMQTTTRANSPORT_HANDLE_DATA transport_data)
             options.password = sasToken;
         }
         options.keepAliveInterval = transport_data->keepAliveValue;
-        options.useCleanSession = false;
+        options.useCleanSession = transport_data->useCleanSession;
         options.qualityOfServiceValue = DELIVER_AT_LEAST_ONCE;
 
         if (GetTransportProviderIfNecessary(transport_data) == 0)
@@ -1989,11 +2279,15 @@ static PMQTTTRANSPORT_HANDLE_DATA InitializeTransportHandleData(const IOTHUB_CLI
                         /* Codes_SRS_IOTHUB_MQTT_TRANSPORT_07_010: [IoTHubTransport_MQTT_Common_Create shall allocate memory to save its internal state where all topics, hostname, device_id, device_key, sasTokenSr and client handle shall be saved.] */
                         DList_InitializeListHead(&(state->telemetry_waitingForAck));
                         DList_InitializeListHead(&(state->ack_waiting_queue));
+                        DList_InitializeListHead(&(state->reported_state_waiting));
                         state->isDestroyCalled = false;
                         state->isRegistered = false;
                         state->mqttClientStatus = MQTT_CLIENT_STATUS_NOT_CONNECTED;
                         state->device_twin_get_sent = false;
                         state->isRecoverableError = true;
+                        state->useCleanSession = false;
+                        state->isSessionPresent = false;
+                        state->resendInflightMessages = false;
                         state->packetId = 1;
                         state->llClientHandle = NULL;
                         state->xioTransport = NULL;
@@ -2014,6 +2308,7 @@ static PMQTTTRANSPORT_HANDLE_DATA InitializeTransportHandleData(const IOTHUB_CLI
                         state->authorization_module = auth_module;
                         state->isProductInfoSet = false;
                         state->option_sas_token_lifetime_secs = SAS_TOKEN_DEFAULT_LIFETIME;
+                        state->option_twin_reported_state_coalesce_secs = 0;
                     }
                 }
             }
@@ -2122,8 +2417,13 @@ void IoTHubTransport_MQTT_Common_Destroy(TRANSPORT_LL_HANDLE handle)
         {
             PDLIST_ENTRY currentEntry = DList_RemoveHeadList(&transport_data->ack_waiting_queue);
             MQTT_DEVICE_TWIN_ITEM* mqtt_device_twin = containingRecord(currentEntry, MQTT_DEVICE_TWIN_ITEM, entry);
-            IoTHubClient_LL_ReportedStateComplete(transport_data->llClientHandle, mqtt_device_twin->iothub_msg_id, STATUS_CODE_TIMEOUT_VALUE);
-            free(mqtt_device_twin);
+            complete_reported_state(transport_data, mqtt_device_twin, STATUS_CODE_TIMEOUT_VALUE);
+        }
+        while (!DList_IsListEmpty(&transport_data->reported_state_waiting))
+        {
+            PDLIST_ENTRY currentEntry = DList_RemoveHeadList(&transport_data->reported_state_waiting);
+            MQTT_DEVICE_TWIN_ITEM* mqtt_device_twin = containingRecord(currentEntry, MQTT_DEVICE_TWIN_ITEM, entry);
+            complete_reported_state(transport_data, mqtt_device_twin, STATUS_CODE_TIMEOUT_VALUE);
         }
 
         /* Codes_SRS_IOTHUB_MQTT_TRANSPORT_07_014: [IoTHubTransport_MQTT_Common_Destroy shall free all the resources currently in use.] */
@@ -2431,21 +2731,41 @@ IOTHUB_PROCESS_ITEM_RESULT IoTHubTransport_MQTT_Common_ProcessItem(TRANSPORT_LL_
                     mqtt_info->iothub_type = item_type;
                     mqtt_info->iothub_msg_id = iothub_item->device_twin->item_id;
                     mqtt_info->retryCount = 0;
-                    
-                    /* Codes_SRS_IOTHUBCLIENT_LL_07_005: [ If successful IoTHubTransport_MQTT_Common_ProcessItem shall add mqtt info structure acknowledgement queue. ] */
-                    DList_InsertTailList(&transport_data->ack_waiting_queue, &mqtt_info->entry);
+                    mqtt_info->device_twin_data = iothub_item->device_twin;
+                    mqtt_info->next_coalesced = NULL;
 
-                    if (publish_device_twin_message(transport_data, iothub_item->device_twin, mqtt_info) != 0)
+                    if (transport_data->option_twin_reported_state_coalesce_secs > 0)
                     {
-                        DList_RemoveEntryList(&mqtt_info->entry);
-
-                        free(mqtt_info);
-                        /* Codes_SRS_IOTHUBCLIENT_LL_07_004: [ If any errors are encountered IoTHubTransport_MQTT_Common_ProcessItem shall return IOTHUB_PROCESS_ERROR. ]*/
-                        result = IOTHUB_PROCESS_ERROR;
+                        /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_001: [ If reported state coalescing is enabled IoTHubTransport_MQTT_Common_DoWork shall hold the reported states until the oldest one has waited `twin_reported_state_coalesce_secs`. ] */
+                        if (tickcounter_get_current_ms(transport_data->msgTickCounter, &mqtt_info->msgPublishTime) != 0)
+                        {
+                            LogError("Failed retrieving tickcounter info");
+                            free(mqtt_info);
+                            result = IOTHUB_PROCESS_ERROR;
+                        }
+                        else
+                        {
+                            DList_InsertTailList(&transport_data->reported_state_waiting, &mqtt_info->entry);
+                            result = IOTHUB_PROCESS_OK;
+                        }
                     }
                     else
                     {
-                        result = IOTHUB_PROCESS_OK;
+                        /* Codes_SRS_IOTHUBCLIENT_LL_07_005: [ If successful IoTHubTransport_MQTT_Common_ProcessItem shall add mqtt info structure acknowledgement queue. ] */
+                        DList_InsertTailList(&transport_data->ack_waiting_queue, &mqtt_info->entry);
+
+                        if (publish_device_twin_message(transport_data, iothub_item->device_twin->report_data_handle, mqtt_info) != 0)
+                        {
+                            DList_RemoveEntryList(&mqtt_info->entry);
+
+                            free(mqtt_info);
+                            /* Codes_SRS_IOTHUBCLIENT_LL_07_004: [ If any errors are encountered IoTHubTransport_MQTT_Common_ProcessItem shall return IOTHUB_PROCESS_ERROR. ]*/
+                            result = IOTHUB_PROCESS_ERROR;
+                        }
+                        else
+                        {
+                            result = IOTHUB_PROCESS_OK;
+                        }
                     }
                 }
             }
@@ -2486,6 +2806,10 @@ void IoTHubTransport_MQTT_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
             }
             else if (transport_data->currPacketState == CONNACK_TYPE || transport_data->currPacketState == SUBSCRIBE_TYPE)
             {
+                if (transport_data->resendInflightMessages)
+                {
+                    ResendInflightMessages(transport_data);
+                }
                 SubscribeToMqttProtocol(transport_data);
             }
             else if (transport_data->currPacketState == SUBACK_TYPE)
@@ -2508,7 +2832,11 @@ void IoTHubTransport_MQTT_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
             }
             else if (transport_data->currPacketState == PUBLISH_TYPE)
             {
-                PDLIST_ENTRY currentListEntry = transport_data->telemetry_waitingForAck.Flink;
+                PDLIST_ENTRY currentListEntry;
+
+                publish_waiting_reported_states(transport_data);
+
+                currentListEntry = transport_data->telemetry_waitingForAck.Flink;
                 while (currentListEntry != &transport_data->telemetry_waitingForAck)
                 {
                     tickcounter_ms_t current_ms;
@@ -2552,7 +2880,7 @@ void IoTHubTransport_MQTT_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
                             }
                             else
                             {
-                                if (publish_mqtt_telemetry_msg(transport_data, mqttMsgEntry, messagePayload, messageLength) != 0)
+                                if (publish_mqtt_telemetry_msg(transport_data, mqttMsgEntry, messagePayload, messageLength, true) != 0)
                                 {
                                     (void)DList_RemoveEntryList(currentListEntry);
                                     sendMsgComplete(mqttMsgEntry->iotHubMessageEntry, transport_data, IOTHUB_CLIENT_CONFIRMATION_ERROR);
@@ -2592,7 +2920,7 @@ void IoTHubTransport_MQTT_Common_DoWork(TRANSPORT_LL_HANDLE handle, IOTHUB_CLIEN
                             mqttMsgEntry->retryCount = 0;
                             mqttMsgEntry->iotHubMessageEntry = iothubMsgList;
                             mqttMsgEntry->packet_id = get_next_packet_id(transport_data);
-                            if (publish_mqtt_telemetry_msg(transport_data, mqttMsgEntry, messagePayload, messageLength) != 0)
+                            if (publish_mqtt_telemetry_msg(transport_data, mqttMsgEntry, messagePayload, messageLength, false) != 0)
                             {
                                 (void)(DList_RemoveEntryList(currentListEntry));
                                 sendMsgComplete(iothubMsgList, transport_data, IOTHUB_CLIENT_CONFIRMATION_ERROR);
@@ -2681,6 +3009,27 @@ IOTHUB_CLIENT_RESULT IoTHubTransport_MQTT_Common_SetOption(TRANSPORT_LL_HANDLE h
             transport_data->option_sas_token_lifetime_secs = *sas_lifetime;
             result = IOTHUB_CLIENT_OK;
         }
+        /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_006: [ If the option parameter is set to "twin_reported_state_coalesce_secs" then the value shall be a size_t_ptr, from 0 (disabled) to 60, used as the reported state coalescing window; other values shall fail with IOTHUB_CLIENT_INVALID_ARG. ] */
+        else if (strcmp(OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, option) == 0)
+        {
+            size_t coalesce_secs = *((size_t*)value);
+            if (coalesce_secs > MAX_REPORTED_STATE_COALESCE_SECS)
+            {
+                LogError("invalid reported state coalescing window %lu, the maximum is %d seconds", (unsigned long)coalesce_secs, MAX_REPORTED_STATE_COALESCE_SECS);
+                result = IOTHUB_CLIENT_INVALID_ARG;
+            }
+            else
+            {
+                transport_data->option_twin_reported_state_coalesce_secs = coalesce_secs;
+                result = IOTHUB_CLIENT_OK;
+            }
+        }
+        /* Codes_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_019: [ If the option parameter is set to "clean_session" then the value shall be a bool_ptr and the value will be used as the CleanSession flag on the next mqtt_client_connect.] */
+        else if (strcmp(OPTION_CLEAN_SESSION, option) == 0)
+        {
+            transport_data->useCleanSession = *((bool*)value);
+            result = IOTHUB_CLIENT_OK;
+        }
         else if (strcmp(OPTION_CONNECTION_TIMEOUT, option) == 0)
         {
             int* connection_time = (int*)value;
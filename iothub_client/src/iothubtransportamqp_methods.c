@@ -39,6 +39,8 @@ typedef struct IOTHUBTRANSPORT_AMQP_METHODS_TAG
     SUBSCRIBE_STATE subscribe_state;
     IOTHUBTRANSPORT_AMQP_METHOD_HANDLE* method_request_handles;
     size_t method_request_handle_count;
+    size_t method_request_handle_capacity;
+    struct IOTHUBTRANSPORT_AMQP_METHOD_TAG* free_method_handles;
     bool receiver_link_disconnected;
     bool sender_link_disconnected;
 } IOTHUBTRANSPORT_AMQP_METHODS;
@@ -54,40 +56,52 @@ typedef struct IOTHUBTRANSPORT_AMQP_METHOD_TAG
 {
     IOTHUBTRANSPORT_AMQP_METHODS_HANDLE iothubtransport_amqp_methods_handle;
     uuid correlation_id;
+    size_t tracked_index;
+    struct IOTHUBTRANSPORT_AMQP_METHOD_TAG* next_free;
 } IOTHUBTRANSPORT_AMQP_METHOD;
 
 static void remove_tracked_handle(IOTHUBTRANSPORT_AMQP_METHODS* amqp_methods_handle, IOTHUBTRANSPORT_AMQP_METHOD_HANDLE method_request_handle)
 {
-    size_t i;
+    size_t index = method_request_handle->tracked_index;
 
-    for (i = 0; i < amqp_methods_handle->method_request_handle_count; i++)
+    if ((index < amqp_methods_handle->method_request_handle_count) &&
+        (amqp_methods_handle->method_request_handles[index] == method_request_handle))
     {
-        if (amqp_methods_handle->method_request_handles[i] == method_request_handle)
-        {
-            if (amqp_methods_handle->method_request_handle_count - i > 1)
-            {
-                (void)memmove(&amqp_methods_handle->method_request_handles[i], &amqp_methods_handle->method_request_handles[i + 1],
-                    (amqp_methods_handle->method_request_handle_count - i - 1) * sizeof(IOTHUBTRANSPORT_AMQP_METHOD_HANDLE));
-            }
+        /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_150: [ The handle shall be removed from the tracking array by moving the last tracked handle into its slot, without resizing the array. ]*/
+        size_t last_index = amqp_methods_handle->method_request_handle_count - 1;
 
-            amqp_methods_handle->method_request_handle_count--;
-            i--;
+        if (index != last_index)
+        {
+            amqp_methods_handle->method_request_handles[index] = amqp_methods_handle->method_request_handles[last_index];
+            amqp_methods_handle->method_request_handles[index]->tracked_index = index;
         }
+
+        amqp_methods_handle->method_request_handle_count--;
     }
+}
+
+static IOTHUBTRANSPORT_AMQP_METHOD* get_method_handle(IOTHUBTRANSPORT_AMQP_METHODS* amqp_methods_handle)
+{
+    IOTHUBTRANSPORT_AMQP_METHOD* result;
 
-    if (amqp_methods_handle->method_request_handle_count == 0)
+    if (amqp_methods_handle->free_method_handles != NULL)
     {
-        free(amqp_methods_handle->method_request_handles);
-        amqp_methods_handle->method_request_handles = NULL;
+        /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_151: [ If a previously released `IOTHUBTRANSPORT_AMQP_METHOD_HANDLE` is available it shall be reused instead of allocating a new one. ]*/
+        result = amqp_methods_handle->free_method_handles;
+        amqp_methods_handle->free_method_handles = result->next_free;
     }
     else
     {
-        IOTHUBTRANSPORT_AMQP_METHOD_HANDLE* new_handles = (IOTHUBTRANSPORT_AMQP_METHOD_HANDLE*)realloc(amqp_methods_handle->method_request_handles, amqp_methods_handle->method_request_handle_count * sizeof(IOTHUBTRANSPORT_AMQP_METHOD_HANDLE));
-        if (new_handles != NULL)
-        {
-            amqp_methods_handle->method_request_handles = new_handles;
-        }
+        result = (IOTHUBTRANSPORT_AMQP_METHOD*)malloc(sizeof(IOTHUBTRANSPORT_AMQP_METHOD));
     }
+
+    return result;
+}
+
+static void release_method_handle(IOTHUBTRANSPORT_AMQP_METHODS* amqp_methods_handle, IOTHUBTRANSPORT_AMQP_METHOD* method_handle)
+{
+    method_handle->next_free = amqp_methods_handle->free_method_handles;
+    amqp_methods_handle->free_method_handles = method_handle;
 }
 
 IOTHUBTRANSPORT_AMQP_METHODS_HANDLE iothubtransportamqp_methods_create(const char* hostname, const char* device_id)
@@ -137,6 +151,8 @@ IOTHUBTRANSPORT_AMQP_METHODS_HANDLE iothubtransportamqp_methods_create(const cha
                     result->subscribe_state = SUBSCRIBE_STATE_NOT_SUBSCRIBED;
                     result->method_request_handles = NULL;
                     result->method_request_handle_count = 0;
+                    result->method_request_handle_capacity = 0;
+                    result->free_method_handles = NULL;
                     result->receiver_link_disconnected = false;
                     result->sender_link_disconnected = false;
                 }
@@ -174,6 +190,13 @@ void iothubtransportamqp_methods_destroy(IOTHUBTRANSPORT_AMQP_METHODS_HANDLE iot
             free(iothubtransport_amqp_methods_handle->method_request_handles);
         }
 
+        while (iothubtransport_amqp_methods_handle->free_method_handles != NULL)
+        {
+            IOTHUBTRANSPORT_AMQP_METHOD* next_free = iothubtransport_amqp_methods_handle->free_method_handles->next_free;
+            free(iothubtransport_amqp_methods_handle->free_method_handles);
+            iothubtransport_amqp_methods_handle->free_method_handles = next_free;
+        }
+
         /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_005: [ `iothubtransportamqp_methods_destroy` shall free all resources allocated by `iothubtransportamqp_methods_create` for the handle `iothubtransport_amqp_methods_handle`. ]*/
         free(iothubtransport_amqp_methods_handle->hostname);
         free(iothubtransport_amqp_methods_handle->device_id);
@@ -286,7 +309,7 @@ static AMQP_VALUE on_message_received(const void* context, MESSAGE_HANDLE messag
             else
             {
                 /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_112: [ Memory shall be allocated for the `IOTHUBTRANSPORT_AMQP_METHOD_HANDLE` to hold the correlation-id, so that it can be used in the `iothubtransportamqp_methods_respond` function. ]*/
-                IOTHUBTRANSPORT_AMQP_METHOD* method_handle = (IOTHUBTRANSPORT_AMQP_METHOD*)malloc(sizeof(IOTHUBTRANSPORT_AMQP_METHOD));
+                IOTHUBTRANSPORT_AMQP_METHOD* method_handle = get_method_handle(amqp_methods_handle);
                 if (method_handle == NULL)
                 {
                     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_130: [ If allocating memory for the `IOTHUBTRANSPORT_AMQP_METHOD_HANDLE` handle fails, the RELEASED outcome shall be returned and an error shall be indicated. ]*/
@@ -297,7 +320,21 @@ static AMQP_VALUE on_message_received(const void* context, MESSAGE_HANDLE messag
                 {
                     IOTHUBTRANSPORT_AMQP_METHOD_HANDLE* new_handles;
                     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_113: [ All `IOTHUBTRANSPORT_AMQP_METHOD_HANDLE` handles shall be tracked in an array of handles that shall be resized accordingly when a methopd handle is added to it. ]*/
-                    new_handles = (IOTHUBTRANSPORT_AMQP_METHOD_HANDLE*)realloc(amqp_methods_handle->method_request_handles, (amqp_methods_handle->method_request_handle_count + 1) * sizeof(IOTHUBTRANSPORT_AMQP_METHOD_HANDLE));
+                    if (amqp_methods_handle->method_request_handle_count < amqp_methods_handle->method_request_handle_capacity)
+                    {
+                        new_handles = amqp_methods_handle->method_request_handles;
+                    }
+                    else
+                    {
+                        /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_152: [ When the tracking array is full its capacity shall be doubled (starting at 1). ]*/
+                        size_t new_capacity = (amqp_methods_handle->method_request_handle_capacity == 0) ? 1 : (amqp_methods_handle->method_request_handle_capacity * 2);
+                        new_handles = (IOTHUBTRANSPORT_AMQP_METHOD_HANDLE*)realloc(amqp_methods_handle->method_request_handles, new_capacity * sizeof(IOTHUBTRANSPORT_AMQP_METHOD_HANDLE));
+                        if (new_handles != NULL)
+                        {
+                            amqp_methods_handle->method_request_handle_capacity = new_capacity;
+                        }
+                    }
+
                     if (new_handles == NULL)
                     {
                         /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_138: [ If resizing the tracked method handles array fails, the RELEASED outcome shall be returned and an error shall be indicated. ]*/
@@ -407,6 +444,7 @@ static AMQP_VALUE on_message_received(const void* context, MESSAGE_HANDLE messag
                                                         method_handle->iothubtransport_amqp_methods_handle = amqp_methods_handle;
 
                                                         /* set the method request handle in the handle array */
+                                                        method_handle->tracked_index = amqp_methods_handle->method_request_handle_count;
                                                         amqp_methods_handle->method_request_handles[amqp_methods_handle->method_request_handle_count] = method_handle;
                                                         amqp_methods_handle->method_request_handle_count++;
 
@@ -982,7 +1020,7 @@ int iothubtransportamqp_methods_respond(IOTHUBTRANSPORT_AMQP_METHOD_HANDLE metho
                                                     remove_tracked_handle(method_handle->iothubtransport_amqp_methods_handle, method_handle);
 
                                                     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_111: [ The handle `method_handle` shall be freed (have no meaning) after `iothubtransportamqp_methods_respond` has been executed. ]*/
-                                                    free(method_handle);
+                                                    release_method_handle(method_handle->iothubtransport_amqp_methods_handle, method_handle);
 
                                                     /* Codes_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_060: [ `iothubtransportamqp_methods_respond` shall construct a response message and on success it shall return 0. ]*/
                                                     result = 0;
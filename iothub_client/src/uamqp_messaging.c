@@ -15,6 +15,7 @@
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/xlogging.h"
 #include "azure_c_shared_utility/uuid.h"
+#include "azure_c_shared_utility/buffer_.h"
 #include "azure_uamqp_c/amqp_definitions.h"
 #include "azure_uamqp_c/message.h"
 #include "azure_uamqp_c/amqpvalue.h"
@@ -29,6 +30,58 @@
 #define AMQP_DIAGNOSTIC_CONTEXT_KEY "Correlation-Context"
 #define AMQP_DIAGNOSTIC_CREATION_TIME_UTC_KEY "creationtimeutc"
 
+#define AMQP_DESCRIBED_CONSTRUCTOR              0x00
+#define AMQP_SMALLULONG_CONSTRUCTOR             0x53
+#define AMQP_PROPERTIES_DESCRIPTOR              0x73
+#define AMQP_APPLICATION_PROPERTIES_DESCRIPTOR  0x74
+#define AMQP_NULL_CONSTRUCTOR                   0x40
+#define AMQP_LIST0_CONSTRUCTOR                  0x45
+#define AMQP_STR8_CONSTRUCTOR                   0xA1
+#define AMQP_SYM8_CONSTRUCTOR                   0xA3
+#define AMQP_STR32_CONSTRUCTOR                  0xB1
+#define AMQP_SYM32_CONSTRUCTOR                  0xB3
+#define AMQP_LIST8_CONSTRUCTOR                  0xC0
+#define AMQP_MAP8_CONSTRUCTOR                   0xC1
+#define AMQP_LIST32_CONSTRUCTOR                 0xD0
+#define AMQP_MAP32_CONSTRUCTOR                  0xD1
+
+#define AMQP_DESCRIPTOR_SIZE                    3
+#define AMQP_NULL_SIZE                          1
+#define AMQP_LIST0_SIZE                         1
+#define AMQP_STR8_HEADER_SIZE                   2
+#define AMQP_STR32_HEADER_SIZE                  5
+#define AMQP_COMPOUND8_HEADER_SIZE              3
+#define AMQP_COMPOUND32_HEADER_SIZE             9
+
+// Positions of the fields set by this module in the AMQP `properties` list.
+#define MESSAGE_PROPERTIES_MESSAGE_ID_INDEX         0
+#define MESSAGE_PROPERTIES_CORRELATION_ID_INDEX     5
+#define MESSAGE_PROPERTIES_CONTENT_TYPE_INDEX       6
+#define MESSAGE_PROPERTIES_CONTENT_ENCODING_INDEX   7
+#define MESSAGE_PROPERTIES_MAX_FIELD_COUNT          8
+
+typedef struct AMQP_STRING_FIELD_TAG
+{
+    const char* value;                      // NULL if the field is not set; encoded as an AMQP null.
+    size_t length;
+    bool is_symbol;
+} AMQP_STRING_FIELD;
+
+typedef struct MESSAGE_PROPERTIES_TO_ENCODE_TAG
+{
+    AMQP_STRING_FIELD fields[MESSAGE_PROPERTIES_MAX_FIELD_COUNT];
+    size_t field_count;                     // Up to the last field set; trailing unset fields are omitted from the list.
+    size_t content_length;
+} MESSAGE_PROPERTIES_TO_ENCODE;
+
+typedef struct APPLICATION_PROPERTIES_TO_ENCODE_TAG
+{
+    const char* const* keys;                // Owned by the IOTHUB_MESSAGE_HANDLE properties map.
+    const char* const* values;
+    size_t count;
+    size_t content_length;
+} APPLICATION_PROPERTIES_TO_ENCODE;
+
 static int encode_callback(void* context, const unsigned char* bytes, size_t length)
 {
     BINARY_DATA* message_body_binary = (BINARY_DATA*)context;
@@ -37,187 +90,179 @@ static int encode_callback(void* context, const unsigned char* bytes, size_t len
     return 0;
 }
 
-// Codes_SRS_UAMQP_MESSAGING_31_112: [If optional message-id is present in the message, encode it into the AMQP message.]
-static int set_message_id_if_needed(IOTHUB_MESSAGE_HANDLE messageHandle, PROPERTIES_HANDLE uamqp_message_properties)
+// Codes_SRS_UAMQP_MESSAGING_09_113: [The message properties and application properties shall be encoded straight into the output buffer, as the AMQP `properties` list and `application-properties` map, without creating intermediate AMQP_VALUEs]
+static size_t get_encoded_string_length(size_t length)
 {
-    int result;
-    const char* messageId;
-
-    if (NULL != (messageId = IoTHubMessage_GetMessageId(messageHandle)))
-    {
-        AMQP_VALUE uamqp_message_id;
+    return (length <= UINT8_MAX ? AMQP_STR8_HEADER_SIZE : AMQP_STR32_HEADER_SIZE) + length;
+}
 
-        if ((uamqp_message_id = amqpvalue_create_string(messageId)) == NULL)
-        {
-            LogError("Failed amqpvalue_create_string for message_id");
-            result = __FAILURE__;
-        }
-        else if (properties_set_message_id(uamqp_message_properties, uamqp_message_id) != 0)
-        {
-            LogError("Failed properties_set_message_id");
-            result = __FAILURE__;
-        }
-        else
-        {
-            result = RESULT_OK;
-        }
+static bool is_small_compound(size_t content_length, size_t count)
+{
+    return (count <= UINT8_MAX && content_length + 1 <= UINT8_MAX);
+}
 
-        if (NULL != uamqp_message_id)
-        {
-            amqpvalue_destroy(uamqp_message_id);
-        }
-    }
-    else
-    {
-        result = RESULT_OK;
-    }
+static size_t get_encoded_compound_length(size_t content_length, size_t count)
+{
+    return AMQP_DESCRIPTOR_SIZE + (is_small_compound(content_length, count) ? AMQP_COMPOUND8_HEADER_SIZE : AMQP_COMPOUND32_HEADER_SIZE) + content_length;
+}
 
-    return result;
+static unsigned char* write_uint32(unsigned char* destination, size_t value)
+{
+    *destination++ = (unsigned char)((value >> 24) & 0xFF);
+    *destination++ = (unsigned char)((value >> 16) & 0xFF);
+    *destination++ = (unsigned char)((value >> 8) & 0xFF);
+    *destination++ = (unsigned char)(value & 0xFF);
+    return destination;
 }
 
-// Codes_SRS_UAMQP_MESSAGING_31_113: [If optional correlation-id is present in the message, encode it into the AMQP message.]
-static int set_message_correlation_id_if_needed(IOTHUB_MESSAGE_HANDLE messageHandle, PROPERTIES_HANDLE uamqp_message_properties)
+static unsigned char* write_descriptor(unsigned char* destination, unsigned char descriptor)
 {
-    int result;
-    const char* correlationId;
+    *destination++ = AMQP_DESCRIBED_CONSTRUCTOR;
+    *destination++ = AMQP_SMALLULONG_CONSTRUCTOR;
+    *destination++ = descriptor;
+    return destination;
+}
 
-    if (NULL != (correlationId = IoTHubMessage_GetCorrelationId(messageHandle)))
+static unsigned char* write_compound_header(unsigned char* destination, unsigned char constructor8, unsigned char constructor32, size_t content_length, size_t count)
+{
+    if (is_small_compound(content_length, count))
     {
-        AMQP_VALUE uamqp_correlation_id;
-
-        if ((uamqp_correlation_id = amqpvalue_create_string(correlationId)) == NULL)
-        {
-            LogError("Failed amqpvalue_create_string for message_id");
-            result = __FAILURE__;
-        }
-        else if (properties_set_correlation_id(uamqp_message_properties, uamqp_correlation_id) != 0)
-        {
-            LogError("Failed properties_set_correlation_id");
-            result = __FAILURE__;
-        }
-        else
-        {
-            result = RESULT_OK;
-        }
-
-        if (uamqp_correlation_id != NULL)
-        {
-            amqpvalue_destroy(uamqp_correlation_id);
-        }
+        *destination++ = constructor8;
+        *destination++ = (unsigned char)(content_length + 1);
+        *destination++ = (unsigned char)count;
     }
     else
     {
-        result = RESULT_OK;
+        *destination++ = constructor32;
+        destination = write_uint32(destination, content_length + 4);
+        destination = write_uint32(destination, count);
     }
 
-    return result;
+    return destination;
 }
 
-// Codes_SRS_UAMQP_MESSAGING_31_114: [If optional content-type is present in the message, encode it into the AMQP message.]
-static int set_message_content_type_if_needed(IOTHUB_MESSAGE_HANDLE messageHandle, PROPERTIES_HANDLE uamqp_message_properties)
+static unsigned char* write_string(unsigned char* destination, unsigned char constructor8, unsigned char constructor32, const char* value, size_t length)
 {
-    int result;
-    const char* content_type;
-
-    if ((content_type = IoTHubMessage_GetContentTypeSystemProperty(messageHandle)) != NULL)
+    if (length <= UINT8_MAX)
     {
-        if (properties_set_content_type(uamqp_message_properties, content_type) != 0)
-        {
-            LogError("Failed properties_set_content_type");
-            result = __FAILURE__;
-        }
-        else
-        {
-            result = RESULT_OK;
-        }
+        *destination++ = constructor8;
+        *destination++ = (unsigned char)length;
     }
     else
     {
-        result = RESULT_OK;
+        *destination++ = constructor32;
+        destination = write_uint32(destination, length);
     }
 
-    return result;
+    (void)memcpy(destination, value, length);
+    return destination + length;
 }
 
-// Codes_SRS_UAMQP_MESSAGING_31_115: [If optional content-encoding is present in the message, encode it into the AMQP message.]
-static int set_message_content_encoding_if_needed(IOTHUB_MESSAGE_HANDLE messageHandle, PROPERTIES_HANDLE uamqp_message_properties)
+static void set_message_property_field(MESSAGE_PROPERTIES_TO_ENCODE* message_properties, size_t index, const char* value, bool is_symbol)
 {
-    int result;
-    const char* content_encoding;
+    message_properties->fields[index].value = value;
+    message_properties->fields[index].length = strlen(value);
+    message_properties->fields[index].is_symbol = is_symbol;
 
-    if ((content_encoding = IoTHubMessage_GetContentEncodingSystemProperty(messageHandle)) != NULL)
+    if (index >= message_properties->field_count)
     {
-        if (properties_set_content_encoding(uamqp_message_properties, content_encoding) != 0)
-        {
-            LogError("Failed properties_set_content_encoding");
-            result = __FAILURE__;
-        }
-        else
-        {
-            result = RESULT_OK;
-        }
-    }
-    else
-    {
-        result = RESULT_OK;
+        message_properties->field_count = index + 1;
     }
-
-    return result;
 }
 
-
 // Codes_SRS_UAMQP_MESSAGING_31_116: [Gets message properties associated with the IOTHUB_MESSAGE_HANDLE to encode, returning the properties and their encoded length.]
-static int create_message_properties_to_encode(IOTHUB_MESSAGE_HANDLE messageHandle, AMQP_VALUE *message_properties, size_t *message_properties_length)
+static int create_message_properties_to_encode(IOTHUB_MESSAGE_HANDLE messageHandle, MESSAGE_PROPERTIES_TO_ENCODE* message_properties, size_t *message_properties_length)
 {
-    PROPERTIES_HANDLE uamqp_message_properties = NULL;
     int result;
+    const char* messageId;
+    const char* correlationId;
+    const char* content_type;
+    const char* content_encoding;
+    size_t content_length = 0;
+    size_t i;
+
+    memset(message_properties, 0, sizeof(MESSAGE_PROPERTIES_TO_ENCODE));
 
-    if ((uamqp_message_properties = properties_create()) == NULL)
+    // Codes_SRS_UAMQP_MESSAGING_31_112: [If optional message-id is present in the message, encode it into the AMQP message.]
+    if ((messageId = IoTHubMessage_GetMessageId(messageHandle)) != NULL)
     {
-        LogError("Failed on properties_create()");
-        result = __FAILURE__;
+        set_message_property_field(message_properties, MESSAGE_PROPERTIES_MESSAGE_ID_INDEX, messageId, false);
     }
-    else if (set_message_id_if_needed(messageHandle, uamqp_message_properties) != RESULT_OK)
+
+    // Codes_SRS_UAMQP_MESSAGING_31_113: [If optional correlation-id is present in the message, encode it into the AMQP message.]
+    if ((correlationId = IoTHubMessage_GetCorrelationId(messageHandle)) != NULL)
     {
-        LogError("Failed on set_message_id_if_needed()");
-        result = __FAILURE__;
+        set_message_property_field(message_properties, MESSAGE_PROPERTIES_CORRELATION_ID_INDEX, correlationId, false);
     }
-    else if (set_message_correlation_id_if_needed(messageHandle, uamqp_message_properties) != RESULT_OK)
+
+    // Codes_SRS_UAMQP_MESSAGING_31_114: [If optional content-type is present in the message, encode it into the AMQP message.]
+    if ((content_type = IoTHubMessage_GetContentTypeSystemProperty(messageHandle)) != NULL)
     {
-        LogError("Failed on set_message_correlation_id_if_needed()");
-        result = __FAILURE__;
+        set_message_property_field(message_properties, MESSAGE_PROPERTIES_CONTENT_TYPE_INDEX, content_type, true);
     }
-    else if (set_message_content_type_if_needed(messageHandle, uamqp_message_properties) != RESULT_OK)
+
+    // Codes_SRS_UAMQP_MESSAGING_31_115: [If optional content-encoding is present in the message, encode it into the AMQP message.]
+    if ((content_encoding = IoTHubMessage_GetContentEncodingSystemProperty(messageHandle)) != NULL)
     {
-        LogError("Failed on set_message_content_type_if_needed()");
-        result = __FAILURE__;
+        set_message_property_field(message_properties, MESSAGE_PROPERTIES_CONTENT_ENCODING_INDEX, content_encoding, true);
     }
-    else if (set_message_content_encoding_if_needed(messageHandle, uamqp_message_properties) != RESULT_OK)
+
+    for (i = 0; i < message_properties->field_count; i++)
     {
-        LogError("Failed on set_message_content_encoding_if_needed()");
-        result = __FAILURE__;
+        content_length += (message_properties->fields[i].value == NULL ? AMQP_NULL_SIZE : get_encoded_string_length(message_properties->fields[i].length));
     }
-    else if ((*message_properties = amqpvalue_create_properties(uamqp_message_properties)) == NULL)
-    {
-        LogError("Failed on amqpvalue_create_properties()");
-        result = __FAILURE__;
-    }
-    else if ((amqpvalue_get_encoded_size(*message_properties, message_properties_length)) != 0)
+
+    // Codes_SRS_UAMQP_MESSAGING_09_114: [If the encoded message properties or application properties do not fit the 32-bit AMQP size field, encoding shall fail]
+    if (content_length > UINT32_MAX - AMQP_COMPOUND32_HEADER_SIZE)
     {
-        LogError("Failed on amqpvalue_get_encoded_size()");
+        LogError("Message properties are too large to be encoded (%lu bytes)", (unsigned long)content_length);
         result = __FAILURE__;
     }
     else
     {
+        message_properties->content_length = content_length;
+        *message_properties_length = (message_properties->field_count == 0 ? AMQP_DESCRIPTOR_SIZE + AMQP_LIST0_SIZE : get_encoded_compound_length(content_length, message_properties->field_count));
         result = RESULT_OK;
     }
 
-    if (NULL != uamqp_message_properties)
+    return result;
+}
+
+static void encode_message_properties(const MESSAGE_PROPERTIES_TO_ENCODE* message_properties, BINARY_DATA* body_binary_data)
+{
+    unsigned char* start = (unsigned char*)body_binary_data->bytes + body_binary_data->length;
+    unsigned char* destination = write_descriptor(start, AMQP_PROPERTIES_DESCRIPTOR);
+
+    if (message_properties->field_count == 0)
     {
-        properties_destroy(uamqp_message_properties);
+        *destination++ = AMQP_LIST0_CONSTRUCTOR;
     }
+    else
+    {
+        size_t i;
 
-    return result;
+        destination = write_compound_header(destination, AMQP_LIST8_CONSTRUCTOR, AMQP_LIST32_CONSTRUCTOR, message_properties->content_length, message_properties->field_count);
+
+        for (i = 0; i < message_properties->field_count; i++)
+        {
+            const AMQP_STRING_FIELD* field = &message_properties->fields[i];
+
+            if (field->value == NULL)
+            {
+                *destination++ = AMQP_NULL_CONSTRUCTOR;
+            }
+            else if (field->is_symbol)
+            {
+                destination = write_string(destination, AMQP_SYM8_CONSTRUCTOR, AMQP_SYM32_CONSTRUCTOR, field->value, field->length);
+            }
+            else
+            {
+                destination = write_string(destination, AMQP_STR8_CONSTRUCTOR, AMQP_STR32_CONSTRUCTOR, field->value, field->length);
+            }
+        }
+    }
+
+    body_binary_data->length += (size_t)(destination - start);
 }
 
 // Adds fault injection properties to an AMQP message.
@@ -303,15 +348,16 @@ static int override_fault_injection_properties_if_needed(MESSAGE_HANDLE message_
 }
 
 // Codes_SRS_UAMQP_MESSAGING_31_117: [Get application message properties associated with the IOTHUB_MESSAGE_HANDLE to encode, returning the properties and their encoded length.]
-static int create_application_properties_to_encode(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE messageHandle, AMQP_VALUE *application_properties, size_t *application_properties_length)
+static int create_application_properties_to_encode(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE messageHandle, APPLICATION_PROPERTIES_TO_ENCODE* application_properties, size_t *application_properties_length)
 {
     MAP_HANDLE properties_map;
     const char* const* property_keys;
     const char* const* property_values;
     size_t property_count = 0;
-    AMQP_VALUE uamqp_properties_map = NULL;
     int result;
 
+    memset(application_properties, 0, sizeof(APPLICATION_PROPERTIES_TO_ENCODE));
+
     if ((properties_map = IoTHubMessage_Properties(messageHandle)) == NULL)
     {
         LogError("Failed to get property map from IoTHub message.");
@@ -324,65 +370,32 @@ static int create_application_properties_to_encode(MESSAGE_HANDLE message_batch_
     }
     else if (property_count > 0)
     {
-        size_t i;
-        if ((uamqp_properties_map = amqpvalue_create_map()) == NULL)
-        {
-            LogError("amqpvalue_create_map failed");
-            result = __FAILURE__;
-        }
-        else
+        bool override_for_fault_injection = false;
+        result = override_fault_injection_properties_if_needed(message_batch_container, property_keys, property_values, property_count, &override_for_fault_injection);
+
+        if (result == RESULT_OK && override_for_fault_injection == false)
         {
-            bool override_for_fault_injection = false;
-            result = override_fault_injection_properties_if_needed(message_batch_container, property_keys, property_values, property_count, &override_for_fault_injection);
+            size_t content_length = 0;
+            size_t i;
 
-            if (override_for_fault_injection == false)
+            for (i = 0; i < property_count; i++)
             {
-                for (i = 0; i < property_count; i++)
-                {
-                    AMQP_VALUE map_property_key;
-                    AMQP_VALUE map_property_value;
-
-                    if ((map_property_key = amqpvalue_create_string(property_keys[i])) == NULL)
-                    {
-                        LogError("Failed amqpvalue_create_string for key");
-                        result = __FAILURE__;
-                        break;
-                    }
-
-                    if ((map_property_value = amqpvalue_create_string(property_values[i])) == NULL)
-                    {
-                        LogError("Failed amqpvalue_create_string for value");
-                        amqpvalue_destroy(map_property_key);
-                        result = __FAILURE__;
-                        break;
-                    }
-
-                    if (amqpvalue_set_map_value(uamqp_properties_map, map_property_key, map_property_value) != 0)
-                    {
-                        LogError("Failed amqpvalue_set_map_value");
-                        amqpvalue_destroy(map_property_key);
-                        amqpvalue_destroy(map_property_value);
-                        result = __FAILURE__;
-                        break;
-                    }
-
-                    amqpvalue_destroy(map_property_key);
-                    amqpvalue_destroy(map_property_value);
-                }
+                content_length += get_encoded_string_length(strlen(property_keys[i])) + get_encoded_string_length(strlen(property_values[i]));
+            }
 
-                if (RESULT_OK == result)
-                {
-                    if ((*application_properties = amqpvalue_create_application_properties(uamqp_properties_map)) == NULL)
-                    {
-                        LogError("Failed amqpvalue_create_application_properties");
-                        result = __FAILURE__;
-                    }
-                    else if (amqpvalue_get_encoded_size(*application_properties, application_properties_length) != 0)
-                    {
-                        LogError("Failed amqpvalue_get_encoded_size");
-                        result = __FAILURE__;
-                    }
-                }
+            // Codes_SRS_UAMQP_MESSAGING_09_114: [If the encoded message properties or application properties do not fit the 32-bit AMQP size field, encoding shall fail]
+            if (content_length > UINT32_MAX - AMQP_COMPOUND32_HEADER_SIZE || property_count > UINT32_MAX / 2)
+            {
+                LogError("Application properties are too large to be encoded (%lu bytes)", (unsigned long)content_length);
+                result = __FAILURE__;
+            }
+            else
+            {
+                application_properties->keys = property_keys;
+                application_properties->values = property_values;
+                application_properties->count = property_count;
+                application_properties->content_length = content_length;
+                *application_properties_length = get_encoded_compound_length(content_length, property_count * 2);
             }
         }
     }
@@ -391,12 +404,24 @@ static int create_application_properties_to_encode(MESSAGE_HANDLE message_batch_
         result = RESULT_OK;
     }
 
-    if (NULL != uamqp_properties_map)
+    return result;
+}
+
+static void encode_application_properties(const APPLICATION_PROPERTIES_TO_ENCODE* application_properties, BINARY_DATA* body_binary_data)
+{
+    unsigned char* start = (unsigned char*)body_binary_data->bytes + body_binary_data->length;
+    unsigned char* destination = write_descriptor(start, AMQP_APPLICATION_PROPERTIES_DESCRIPTOR);
+    size_t i;
+
+    destination = write_compound_header(destination, AMQP_MAP8_CONSTRUCTOR, AMQP_MAP32_CONSTRUCTOR, application_properties->content_length, application_properties->count * 2);
+
+    for (i = 0; i < application_properties->count; i++)
     {
-        amqpvalue_destroy(uamqp_properties_map);
+        destination = write_string(destination, AMQP_STR8_CONSTRUCTOR, AMQP_STR32_CONSTRUCTOR, application_properties->keys[i], strlen(application_properties->keys[i]));
+        destination = write_string(destination, AMQP_STR8_CONSTRUCTOR, AMQP_STR32_CONSTRUCTOR, application_properties->values[i], strlen(application_properties->values[i]));
     }
 
-    return result;
+    body_binary_data->length += (size_t)(destination - start);
 }
 
 static int add_map_item(AMQP_VALUE map, const char* name, const char* value)
@@ -568,14 +593,40 @@ static int create_data_to_encode(IOTHUB_MESSAGE_HANDLE messageHandle, AMQP_VALUE
     return result;
 }
 
+// Codes_SRS_UAMQP_MESSAGING_09_111: [If `encode_buffer` is smaller than the encoded message it shall be enlarged using BUFFER_enlarge, to at least twice its current size]
+// Codes_SRS_UAMQP_MESSAGING_09_112: [`body_binary_data` shall point to the contents of `encode_buffer`, and no memory shall be allocated if it is already large enough]
+static int get_encode_buffer(BUFFER_HANDLE encode_buffer, size_t required_length, BINARY_DATA* body_binary_data)
+{
+    int result;
+    size_t current_length = BUFFER_length(encode_buffer);
+
+    if ((current_length < required_length) &&
+        (BUFFER_enlarge(encode_buffer, ((required_length > 2 * current_length) ? required_length : 2 * current_length) - current_length) != 0))
+    {
+        LogError("BUFFER_enlarge to %lu bytes failed", (unsigned long)required_length);
+        result = __FAILURE__;
+    }
+    else if ((body_binary_data->bytes = BUFFER_u_char(encode_buffer)) == NULL)
+    {
+        LogError("BUFFER_u_char failed");
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = RESULT_OK;
+    }
+
+    return result;
+}
+
 // Codes_SRS_UAMQP_MESSAGING_31_120: [Create a blob that contains AMQP encoding of IOTHUB_MESSAGE_HANDLE.]
 // Codes_SRS_UAMQP_MESSAGING_31_121: [Any errors during `message_create_uamqp_encoding_from_iothub_message` stop processing on this message.]
-int message_create_uamqp_encoding_from_iothub_message(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BINARY_DATA* body_binary_data)
+static int encode_iothub_message(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BUFFER_HANDLE encode_buffer, BINARY_DATA* body_binary_data)
 {
     int result;
 
-    AMQP_VALUE message_properties = NULL;
-    AMQP_VALUE application_properties = NULL;
+    MESSAGE_PROPERTIES_TO_ENCODE message_properties;
+    APPLICATION_PROPERTIES_TO_ENCODE application_properties;
     AMQP_VALUE message_annotations = NULL;
     AMQP_VALUE data_value = NULL;
     size_t message_properties_length = 0;
@@ -606,36 +657,43 @@ int message_create_uamqp_encoding_from_iothub_message(MESSAGE_HANDLE message_bat
         LogError("create_data_to_encode() failed");
         result = __FAILURE__;
     }
-    else if ((body_binary_data->bytes = malloc(message_properties_length + application_properties_length + data_length + message_annotations_length)) == NULL)
+    else if ((encode_buffer != NULL) &&
+        (get_encode_buffer(encode_buffer, message_properties_length + application_properties_length + data_length + message_annotations_length, body_binary_data) != RESULT_OK))
     {
-        LogError("malloc of %d bytes failed", message_properties_length + application_properties_length + data_length + message_annotations_length);
+        LogError("failed getting %d bytes from the encode buffer", message_properties_length + application_properties_length + data_length + message_annotations_length);
         result = __FAILURE__;
     }
-    // Codes_SRS_UAMQP_MESSAGING_31_119: [Invoke underlying AMQP encode routines on data waiting to be encoded.]
-    else if (amqpvalue_encode(message_properties, &encode_callback, body_binary_data) != RESULT_OK)
+    else if ((encode_buffer == NULL) &&
+        ((body_binary_data->bytes = malloc(message_properties_length + application_properties_length + data_length + message_annotations_length)) == NULL))
     {
-        LogError("amqpvalue_encode() for message properties failed");
-        result = __FAILURE__;
-    }
-    else if ((application_properties_length > 0) && (amqpvalue_encode(application_properties, &encode_callback, body_binary_data)  != RESULT_OK))
-    {
-        LogError("amqpvalue_encode() for application properties failed");
-        result = __FAILURE__;
-    }
-    else if (message_annotations_length > 0 && amqpvalue_encode(message_annotations, &encode_callback, body_binary_data) != RESULT_OK)
-    {
-        LogError("amqpvalue_encode() for message annotations failed");
-        result = __FAILURE__;
-    }
-    else if (RESULT_OK != amqpvalue_encode(data_value, &encode_callback, body_binary_data))
-    {
-        LogError("amqpvalue_encode() for data value failed");
+        LogError("malloc of %d bytes failed", message_properties_length + application_properties_length + data_length + message_annotations_length);
         result = __FAILURE__;
     }
     else
     {
-        body_binary_data->length = message_properties_length + application_properties_length + data_length + message_annotations_length;
-        result = RESULT_OK;
+        // Codes_SRS_UAMQP_MESSAGING_31_119: [Invoke underlying AMQP encode routines on data waiting to be encoded.]
+        encode_message_properties(&message_properties, body_binary_data);
+
+        if (application_properties_length > 0)
+        {
+            encode_application_properties(&application_properties, body_binary_data);
+        }
+
+        if (message_annotations_length > 0 && amqpvalue_encode(message_annotations, &encode_callback, body_binary_data) != RESULT_OK)
+        {
+            LogError("amqpvalue_encode() for message annotations failed");
+            result = __FAILURE__;
+        }
+        else if (RESULT_OK != amqpvalue_encode(data_value, &encode_callback, body_binary_data))
+        {
+            LogError("amqpvalue_encode() for data value failed");
+            result = __FAILURE__;
+        }
+        else
+        {
+            body_binary_data->length = message_properties_length + application_properties_length + data_length + message_annotations_length;
+            result = RESULT_OK;
+        }
     }
 
     if (NULL != data_value)
@@ -643,19 +701,32 @@ int message_create_uamqp_encoding_from_iothub_message(MESSAGE_HANDLE message_bat
         amqpvalue_destroy(data_value);
     }
 
-    if (NULL != application_properties)
-    {
-        amqpvalue_destroy(application_properties);
-    }
-
     if (NULL != message_annotations)
     {
         amqpvalue_destroy(message_annotations);
     }
 
-    if (NULL != message_properties)
+    return result;
+}
+
+int message_create_uamqp_encoding_from_iothub_message(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BINARY_DATA* body_binary_data)
+{
+    return encode_iothub_message(message_batch_container, message_handle, NULL, body_binary_data);
+}
+
+int message_create_uamqp_encoding_from_iothub_message_in_buffer(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BUFFER_HANDLE encode_buffer, BINARY_DATA* body_binary_data)
+{
+    int result;
+
+    // Codes_SRS_UAMQP_MESSAGING_09_110: [If `encode_buffer` is NULL, message_create_uamqp_encoding_from_iothub_message_in_buffer shall fail and return a non-zero value]
+    if (encode_buffer == NULL)
+    {
+        LogError("Invalid argument (encode_buffer is NULL)");
+        result = __FAILURE__;
+    }
+    else
     {
-        amqpvalue_destroy(message_properties);
+        result = encode_iothub_message(message_batch_container, message_handle, encode_buffer, body_binary_data);
     }
 
     return result;
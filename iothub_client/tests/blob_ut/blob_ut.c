@@ -30,6 +30,8 @@ static void my_gballoc_free(void* s)
 #include "azure_c_shared_utility/httpheaders.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/shared_util_options.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "azure_c_shared_utility/lock.h"
 #undef ENABLE_MOCKS
 
 #include "blob.h"
@@ -49,9 +51,18 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE_VALUES);
 TEST_DEFINE_ENUM_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT_VALUES);
 
+TEST_DEFINE_ENUM_TYPE(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTPAPI_RESULT, HTTPAPI_RESULT_VALUES);
+
 TEST_DEFINE_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 IMPLEMENT_UMOCK_C_ENUM_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT_VALUES);
 
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+TEST_DEFINE_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LOCK_RESULT, LOCK_RESULT_VALUES);
+
 static HTTPAPIEX_HANDLE my_HTTPAPIEX_Create(const char* hostName)
 {
     (void)hostName;
@@ -75,6 +86,11 @@ static void my_BUFFER_delete(BUFFER_HANDLE h)
     my_gballoc_free(h);
 }
 
+static BUFFER_HANDLE my_BUFFER_new(void)
+{
+    return (BUFFER_HANDLE)my_gballoc_malloc(1);
+}
+
 static HTTP_HEADERS_HANDLE my_HTTPHeaders_Alloc(void)
 {
     return (HTTP_HEADERS_HANDLE)my_gballoc_malloc(1);
@@ -98,6 +114,52 @@ static void my_STRING_delete(STRING_HANDLE h)
     my_gballoc_free((void*)h);
 }
 
+static STRING_HANDLE my_STRING_new(void)
+{
+    return (STRING_HANDLE)my_gballoc_malloc(1);
+}
+
+/*upload threads only run inside ThreadAPI_Join so the expected calls are deterministic*/
+typedef struct TEST_THREAD_TAG
+{
+    THREAD_START_FUNC func;
+    void* arg;
+} TEST_THREAD;
+
+static THREADAPI_RESULT my_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+{
+    TEST_THREAD* thread = (TEST_THREAD*)my_gballoc_malloc(sizeof(TEST_THREAD));
+    thread->func = func;
+    thread->arg = arg;
+    *threadHandle = (THREAD_HANDLE)thread;
+    return THREADAPI_OK;
+}
+
+static THREADAPI_RESULT my_ThreadAPI_Join(THREAD_HANDLE threadHandle, int* res)
+{
+    TEST_THREAD* thread = (TEST_THREAD*)threadHandle;
+    *res = thread->func(thread->arg);
+    my_gballoc_free(thread);
+    return THREADAPI_OK;
+}
+
+static LOCK_HANDLE my_Lock_Init(void)
+{
+    return (LOCK_HANDLE)my_gballoc_malloc(1);
+}
+
+static void my_Lock_Deinit(LOCK_HANDLE handle)
+{
+    my_gballoc_free(handle);
+}
+
+static STRING_HANDLE my_STRING_from_byte_array(const unsigned char* source, size_t size)
+{
+    (void)source;
+    (void)size;
+    return (STRING_HANDLE)my_gballoc_malloc(1);
+}
+
 static STRING_HANDLE my_Base64_Encode_Bytes(const unsigned char* source, size_t size)
 {
     (void)source;
@@ -130,6 +192,7 @@ static BUFFER_HANDLE testValidBufferHandle; /*assigned in TEST_SUITE_INITIALIZE*
 static unsigned int httpResponse; /*used as out parameter in every call to Blob_....*/
 static const unsigned int TwoHundred = 200;
 static const unsigned int FourHundredFour = 404;
+static const unsigned int FiveHundredThree = 503;
 
 
 /**
@@ -253,12 +316,18 @@ TEST_SUITE_INITIALIZE(TestSuiteInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_create, my_BUFFER_create);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(BUFFER_create, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_delete, my_BUFFER_delete);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_new, my_BUFFER_new);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(BUFFER_new, NULL);
 
     REGISTER_GLOBAL_MOCK_HOOK(HTTPHeaders_Alloc, my_HTTPHeaders_Alloc);
     REGISTER_GLOBAL_MOCK_HOOK(HTTPHeaders_Free, my_HTTPHeaders_Free);
 
     REGISTER_GLOBAL_MOCK_HOOK(STRING_construct, my_STRING_construct);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_construct, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_new, my_STRING_new);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_new, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(STRING_from_byte_array, my_STRING_from_byte_array);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_from_byte_array, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(Base64_Encode_Bytes, my_Base64_Encode_Bytes);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(Base64_Encode_Bytes, NULL);
 
@@ -266,6 +335,7 @@ TEST_SUITE_INITIALIZE(TestSuiteInitialize)
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_concat_with_STRING, __FAILURE__);
 
     REGISTER_GLOBAL_MOCK_RETURNS(HTTPAPIEX_SetOption, HTTPAPIEX_OK, HTTPAPIEX_ERROR);
+    REGISTER_GLOBAL_MOCK_RETURNS(HTTPAPI_Init, HTTPAPI_OK, HTTPAPI_ERROR);
 
     REGISTER_GLOBAL_MOCK_RETURN(STRING_c_str, "a");
     REGISTER_GLOBAL_MOCK_HOOK(STRING_delete, my_STRING_delete);
@@ -275,10 +345,25 @@ TEST_SUITE_INITIALIZE(TestSuiteInitialize)
 
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_START_FUNC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, my_ThreadAPI_Create);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(ThreadAPI_Create, THREADAPI_ERROR);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Join, my_ThreadAPI_Join);
+    REGISTER_GLOBAL_MOCK_HOOK(Lock_Init, my_Lock_Init);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(Lock_Init, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Lock_Deinit, my_Lock_Deinit);
+    REGISTER_GLOBAL_MOCK_RETURNS(Lock, LOCK_OK, LOCK_ERROR);
+    REGISTER_GLOBAL_MOCK_RETURNS(Unlock, LOCK_OK, LOCK_ERROR);
 
     REGISTER_TYPE(HTTPAPI_REQUEST_TYPE, HTTPAPI_REQUEST_TYPE);
     REGISTER_TYPE(HTTPAPIEX_RESULT, HTTPAPIEX_RESULT);
+    REGISTER_TYPE(HTTPAPI_RESULT, HTTPAPI_RESULT);
     REGISTER_TYPE(HTTP_HEADERS_RESULT, HTTP_HEADERS_RESULT);
+    REGISTER_TYPE(THREADAPI_RESULT, THREADAPI_RESULT);
+    REGISTER_TYPE(LOCK_RESULT, LOCK_RESULT);
 
     testValidBufferHandle = BUFFER_create((const unsigned char*)"a", 1);
     ASSERT_IS_NOT_NULL(testValidBufferHandle);
@@ -317,7 +402,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_NULL_SasUri_fails)
     ///arrange
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(NULL, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(NULL, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -332,7 +417,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_NULL_getDataCallBack_and_
     ///arrange
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, NULL, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, NULL, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -409,7 +494,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_succeeds_when_HTTP_status_code
         .IgnoreArgument_ptr();
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
@@ -487,7 +572,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_fails_when_HTTPAPIEX_ExecuteRe
         .IgnoreArgument_ptr();
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_HTTP_ERROR, result);
@@ -526,7 +611,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_fails_when_BUFFER_create_fails
     }
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -554,7 +639,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_fails_when_HTTPAPIEX_Create_fa
     }
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
@@ -577,7 +662,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_fails_when_malloc_fails)
         ;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri(TEST_VALID_SASURI_1, FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
@@ -596,7 +681,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_SasUri_is_wrong_fails_1)
     context.toUpload = context.size;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https:/h.h/doms", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL); /*wrong format for protocol, notice it is actually http:\h.h\doms (missing a \ from http)*/
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https:/h.h/doms", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL); /*wrong format for protocol, notice it is actually http:\h.h\doms (missing a \ from http)*/
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -615,7 +700,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_SasUri_is_wrong_fails_2)
     context.toUpload = context.size;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL); /*there's no relative path here*/
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL); /*there's no relative path here*/
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -757,7 +842,7 @@ static void Blob_UploadMultipleBlocksFromSasUri_various_sizes_happy_path_Impl(HT
             .IgnoreArgument_ptr();
 
         ///act
-        BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, proxyOptions);
+        BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, proxyOptions, 1, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -939,7 +1024,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_various_sizes_with_certificate
             .IgnoreArgument_ptr();
 
         ///act
-        BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, "a", NULL);
+        BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, "a", NULL, 1, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -1165,7 +1250,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_64MB_unhappy_paths)
             
             ///act
             context.toUpload = context.size; /* Reinit context */
-            BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+            BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
             ///assert
             ASSERT_ARE_NOT_EQUAL_WITH_MSG(BLOB_RESULT, BLOB_OK, result, temp_str);
@@ -1395,7 +1480,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_64MB_with_certificate_unhappy_
 
             ///act
             context.toUpload = context.size; /* Reinit context */
-            BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, "a", NULL);
+            BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, "a", NULL, 1, NULL);
 
             ///assert
             ASSERT_ARE_NOT_EQUAL_WITH_MSG(BLOB_RESULT, BLOB_OK, result, temp_str);
@@ -1487,7 +1572,7 @@ TEST_FUNCTION(Blob_UploadFromSasUri_when_http_code_is_404_it_immediately_succeed
         .IgnoreArgument_ptr();
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetData_Callback, &context, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -1510,7 +1595,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_blockSize_too_big_fails)
     fakeContext.abortOnBlockNumber = -1;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -1531,7 +1616,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_blockSize_is_4MB_succeeds
     fakeContext.abortOnBlockNumber = -1;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
@@ -1552,7 +1637,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_blockCount_is_maximum_suc
     fakeContext.abortOnBlockNumber = -1;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
@@ -1573,7 +1658,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_when_blockCount_is_one_over_ma
     fakeContext.abortOnBlockNumber = -1;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
@@ -1594,7 +1679,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_returns_BLOB_ABORTED_when_call
     fakeContext.abortOnBlockNumber = 0;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ABORTED, result);
@@ -1615,7 +1700,7 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_returns_BLOB_ABORTED_when_call
     fakeContext.abortOnBlockNumber = 5;
 
     ///act
-    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL);
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ABORTED, result);
@@ -1624,4 +1709,774 @@ TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_returns_BLOB_ABORTED_when_call
     gballoc_free(fakeContext.fakeData);
 }
 
+static void set_expected_calls_for_parallel_step(void)
+{
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG));
+}
+
+static void set_expected_calls_for_parallel_block_read(size_t size)
+{
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, size));
+    set_expected_calls_for_parallel_step(); /*this is queuing the block*/
+}
+
+static void set_expected_calls_for_parallel_block_upload_attempt(const unsigned int* statusCode)
+{
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=block&blockid="));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_statusCode(statusCode, sizeof(*statusCode));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is unbuilding the relativePath*/
+}
+
+static void set_expected_calls_for_parallel_block_upload_start(void)
+{
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 6));
+}
+
+static void set_expected_calls_for_parallel_block_upload_end(void)
+{
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is unbuilding the blockID string to a base64 representation*/
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG)); /*the block is released as soon as it is uploaded*/
+    set_expected_calls_for_parallel_step();
+}
+
+static void set_expected_calls_for_parallel_block_upload(const unsigned int* statusCode)
+{
+    set_expected_calls_for_parallel_block_upload_start();
+    set_expected_calls_for_parallel_block_upload_attempt(statusCode);
+    set_expected_calls_for_parallel_block_upload_end();
+}
+
+static void set_expected_calls_for_parallel_block_commit(void)
+{
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 6));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "<Latest>"));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</Latest>"));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+}
+
+static void set_expected_calls_for_parallel_upload_start(size_t parallelUploads, size_t threadsCreated)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the parallel upload*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*these are the blocks not yet in the block list*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*these are the uploaders*/
+    STRICT_EXPECTED_CALL(HTTPAPI_Init()); /*initialized on the calling thread, before any upload thread exists*/
+    STRICT_EXPECTED_CALL(Lock_Init());
+
+    for (size_t i = 0; i < parallelUploads; i++)
+    {
+        if (i > 0)
+        {
+            STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h")); /*every uploader but the calling thread has its own connection*/
+        }
+        STRICT_EXPECTED_CALL(BUFFER_new());
+    }
+
+    for (size_t i = 1; i < parallelUploads; i++)
+    {
+        if (i <= threadsCreated)
+        {
+            STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        }
+        else
+        {
+            STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .SetReturn(THREADAPI_ERROR);
+        }
+    }
+}
+
+static void set_expected_calls_for_parallel_upload_stop(size_t threadsCreated)
+{
+    set_expected_calls_for_parallel_step(); /*this is stopping the upload threads*/
+
+    for (size_t i = 0; i < threadsCreated; i++)
+    {
+        STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        set_expected_calls_for_parallel_step(); /*the upload thread finds out it is stopped*/
+    }
+}
+
+static void set_expected_calls_for_parallel_upload_end(size_t parallelUploads, size_t queuedBlocks, int putBlockList)
+{
+    for (size_t i = 0; i < queuedBlocks; i++)
+    {
+        STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG)); /*blocks that were never uploaded*/
+    }
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*these are the blocks not yet in the block list*/
+
+    for (size_t i = 0; i < parallelUploads; i++)
+    {
+        if (i > 0)
+        {
+            STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+        }
+        STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+    }
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*these are the uploaders*/
+    STRICT_EXPECTED_CALL(Lock_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPI_Deinit());
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is the parallel upload*/
+
+    if (putBlockList)
+    {
+        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</BlockList>"));
+        STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+        STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=blocklist"));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, &httpResponse, NULL, testValidBufferHandle))
+            .CopyOutArgumentBuffer_statusCode(&TwoHundred, sizeof(TwoHundred));
+        STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    }
+
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+}
+
+/*Tests_SRS_BLOB_09_001: [ If `parallelUploads` is greater than 1, `Blob_UploadMultipleBlocksFromSasUri` shall keep up to `parallelUploads` Put Block requests in flight at once, uploading a block on the calling thread when all the upload threads are busy. ]*/
+/*Tests_SRS_BLOB_09_002: [ The calling thread and each of the `parallelUploads` - 1 upload threads shall use their own HTTPAPIEX_HANDLE, configured like the first one, for all the blocks they upload. ]*/
+/*Tests_SRS_BLOB_09_003: [ When uploading in parallel, no more than `parallelUploads` blocks obtained from `getDataCallbackEx` shall be held in memory at any time, and a block shall be released as soon as it is uploaded. ]*/
+/*Tests_SRS_BLOB_09_006: [ Uploaded blocks shall be appended to the block list in block order, each one as soon as all the blocks before it are uploaded. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_parallel_uploads_succeeds)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 3;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+
+    set_expected_calls_for_parallel_upload_start(2, 1);
+
+    /*blocks 0 and 1 are read, then the calling thread uploads block 0 because no more blocks fit in memory*/
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the fake data, allocated on the first callback*/
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 10));
+    set_expected_calls_for_parallel_step();
+    set_expected_calls_for_parallel_block_read(10);
+    set_expected_calls_for_parallel_block_upload(&TwoHundred);
+    set_expected_calls_for_parallel_block_commit();
+
+    /*block 2 takes the place of block 0*/
+    set_expected_calls_for_parallel_block_read(10);
+    set_expected_calls_for_parallel_block_upload(&TwoHundred);
+    set_expected_calls_for_parallel_block_commit();
+
+    /*the end of the data*/
+    set_expected_calls_for_parallel_step();
+    set_expected_calls_for_parallel_block_upload(&TwoHundred);
+    set_expected_calls_for_parallel_block_commit();
+    set_expected_calls_for_parallel_step(); /*nothing is left to do*/
+
+    set_expected_calls_for_parallel_upload_stop(1);
+    set_expected_calls_for_parallel_upload_end(2, 0, 1);
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 2, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+    ASSERT_ARE_EQUAL(int, 200, (int)httpResponse);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_09_004: [ When uploading in parallel, a block that fails with `BLOB_HTTP_ERROR` or an HTTP status >= 500 shall be uploaded again, up to 3 attempts in total. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_parallel_uploads_retries_block_on_5xx)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 1;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+
+    set_expected_calls_for_parallel_upload_start(2, 1);
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the fake data, allocated on the first callback*/
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 10));
+    set_expected_calls_for_parallel_step();
+    set_expected_calls_for_parallel_step(); /*the end of the data*/
+    set_expected_calls_for_parallel_block_upload_start();
+    set_expected_calls_for_parallel_block_upload_attempt(&FiveHundredThree);
+    set_expected_calls_for_parallel_block_upload_attempt(&TwoHundred);
+    set_expected_calls_for_parallel_block_upload_end();
+    set_expected_calls_for_parallel_block_commit();
+    set_expected_calls_for_parallel_step(); /*nothing is left to do*/
+    set_expected_calls_for_parallel_upload_stop(1);
+    set_expected_calls_for_parallel_upload_end(2, 0, 1);
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 2, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_02_026: [ Otherwise, if HTTP response code is >=300 then Blob_UploadMultipleBlocksFromSasUri shall succeed and return BLOB_OK. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_parallel_uploads_and_http_status_404_does_not_put_block_list)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 2;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+
+    set_expected_calls_for_parallel_upload_start(2, 1);
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the fake data, allocated on the first callback*/
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 10));
+    set_expected_calls_for_parallel_step();
+    set_expected_calls_for_parallel_block_read(10);
+    set_expected_calls_for_parallel_block_upload(&FourHundredFour);
+    set_expected_calls_for_parallel_step(); /*block 1 is not uploaded once block 0 failed*/
+    set_expected_calls_for_parallel_upload_stop(1);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG)); /*the response of the failed block is reported*/
+    STRICT_EXPECTED_CALL(BUFFER_length(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_build(testValidBufferHandle, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    set_expected_calls_for_parallel_upload_end(2, 1, 0);
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 2, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+    ASSERT_ARE_EQUAL(int, 404, (int)httpResponse);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_09_007: [ If an upload thread cannot be created, its blocks shall be uploaded by the other upload threads and the calling thread. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_parallel_uploads_uploads_on_calling_thread_when_ThreadAPI_Create_fails)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 1;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+
+    set_expected_calls_for_parallel_upload_start(2, 0);
+    set_expected_calls_for_parallel_step();
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the fake data, allocated on the first callback*/
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 10));
+    set_expected_calls_for_parallel_step();
+    set_expected_calls_for_parallel_step(); /*the end of the data*/
+    set_expected_calls_for_parallel_block_upload(&TwoHundred);
+    set_expected_calls_for_parallel_block_commit();
+    set_expected_calls_for_parallel_step(); /*nothing is left to do*/
+    set_expected_calls_for_parallel_upload_stop(0);
+    set_expected_calls_for_parallel_upload_end(2, 0, 1);
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 2, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_09_016: [ Before any upload thread is created, `Blob_UploadMultipleBlocksFromSasUri` shall call `HTTPAPI_Init` on the calling thread, so the upload threads do not run the HTTP stack global initialization concurrently, and shall call `HTTPAPI_Deinit` once the upload is done. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_parallel_uploads_fails_when_HTTPAPI_Init_fails)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 1;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the parallel upload*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*these are the blocks not yet in the block list*/
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*these are the uploaders*/
+    STRICT_EXPECTED_CALL(HTTPAPI_Init())
+        .SetReturn(HTTPAPI_ERROR);
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*these are the blocks not yet in the block list*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*these are the uploaders*/
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is the parallel upload*/
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 2, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
+}
+
+static unsigned int checkpointBlockCount;
+static size_t checkpointUploadedBytes;
+static uint64_t checkpointContentHash;
+
+static void on_block_uploaded(unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash, void* context)
+{
+    (void)context;
+    checkpointBlockCount = blockCount;
+    checkpointUploadedBytes = uploadedBytes;
+    checkpointContentHash = contentHash;
+}
+
+/*64 bit FNV-1a of size bytes of data, repeated count times*/
+static uint64_t test_content_hash(const unsigned char* data, size_t size, unsigned int count)
+{
+    uint64_t result = 14695981039346656037ULL;
+    unsigned int i;
+    size_t j;
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < size; j++)
+        {
+            result = (result ^ data[j]) * 1099511628211ULL;
+        }
+    }
+    return result;
+}
+
+/*the fake data is allocated here instead of in FileUpload_GetFakeData_Callback so that its content is known*/
+static void allocate_fake_data(BLOB_UPLOAD_CONTEXT_FAKE* fakeContext, unsigned char value)
+{
+    fakeContext->fakeData = (unsigned char*)gballoc_malloc(fakeContext->blockSize);
+    ASSERT_IS_NOT_NULL(fakeContext->fakeData);
+    (void)memset(fakeContext->fakeData, value, fakeContext->blockSize);
+    umock_c_reset_all_calls();
+}
+
+static void set_expected_calls_for_skipped_block(void)
+{
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 6));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "<Latest>"));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</Latest>"));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+}
+
+/*Tests_SRS_BLOB_09_008: [ `Blob_UploadMultipleBlocksFromSasUri` shall obtain the first `checkpoint->blockCount` blocks from `getDataCallbackEx` and add their IDs to the block list without uploading them. ]*/
+/*Tests_SRS_BLOB_09_010: [ After each block is uploaded with an HTTP status < 300, `Blob_UploadMultipleBlocksFromSasUri` shall call `checkpoint->onBlockUploaded`, in block order, with the number of blocks and bytes uploaded so far. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_checkpoint_skips_uploaded_blocks)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    BLOB_UPLOAD_CHECKPOINT checkpoint;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 2;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+    allocate_fake_data(&fakeContext, 'a');
+    checkpoint.blockCount = 1;
+    checkpoint.uploadedBytes = 10;
+    checkpoint.contentHash = test_content_hash(fakeContext.fakeData, 10, 1);
+    checkpoint.onBlockUploaded = on_block_uploaded;
+    checkpoint.onBlockUploadedContext = NULL;
+    checkpointBlockCount = 0;
+    checkpointUploadedBytes = 0;
+    checkpointContentHash = 0;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+
+    /*block 0 is only added to the block list*/
+    set_expected_calls_for_skipped_block();
+
+    /*block 1 is uploaded*/
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 10));
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 6));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "<Latest>"));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</Latest>"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=block&blockid="));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, &httpResponse, NULL, testValidBufferHandle))
+        .CopyOutArgumentBuffer_statusCode(&TwoHundred, sizeof(TwoHundred));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+
+    /*Put Block List*/
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</BlockList>"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=blocklist"));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, &httpResponse, NULL, testValidBufferHandle))
+        .CopyOutArgumentBuffer_statusCode(&TwoHundred, sizeof(TwoHundred));
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, &checkpoint);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, (int)checkpointBlockCount);
+    ASSERT_ARE_EQUAL(size_t, 20, checkpointUploadedBytes);
+    ASSERT_IS_TRUE(checkpointContentHash == test_content_hash(fakeContext.fakeData, 10, 2));
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_09_009: [ If the data ends before `checkpoint->blockCount` blocks, or their total size is not `checkpoint->uploadedBytes`, or their fingerprint is not `checkpoint->contentHash`, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_checkpoint_fails_when_data_does_not_match)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    BLOB_UPLOAD_CHECKPOINT checkpoint;
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 2;
+    fakeContext.fakeData = NULL;
+    fakeContext.abortOnBlockNumber = -1;
+    checkpoint.blockCount = 1;
+    checkpoint.uploadedBytes = 5;
+    checkpoint.contentHash = 0;
+    checkpoint.onBlockUploaded = on_block_uploaded;
+    checkpoint.onBlockUploadedContext = NULL;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is the fake data, allocated on the first callback*/
+    set_expected_calls_for_skipped_block();
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, &checkpoint);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+/*Tests_SRS_BLOB_09_009: [ If the data ends before `checkpoint->blockCount` blocks, or their total size is not `checkpoint->uploadedBytes`, or their fingerprint is not `checkpoint->contentHash`, `Blob_UploadMultipleBlocksFromSasUri` shall fail and return `BLOB_INVALID_ARG`. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromSasUri_with_checkpoint_fails_when_data_of_the_same_size_has_changed)
+{
+    ///arrange
+    BLOB_UPLOAD_CONTEXT_FAKE fakeContext;
+    BLOB_UPLOAD_CHECKPOINT checkpoint;
+    unsigned char savedData[10];
+    fakeContext.blockSent = 0;
+    fakeContext.blockSize = 10;
+    fakeContext.blocksCount = 2;
+    fakeContext.abortOnBlockNumber = -1;
+    allocate_fake_data(&fakeContext, 'b');
+    (void)memset(savedData, 'a', sizeof(savedData));
+    checkpoint.blockCount = 1;
+    checkpoint.uploadedBytes = 10;
+    checkpoint.contentHash = test_content_hash(savedData, sizeof(savedData), 1);
+    checkpoint.onBlockUploaded = on_block_uploaded;
+    checkpoint.onBlockUploadedContext = NULL;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+    set_expected_calls_for_skipped_block();
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromSasUri("https://h.h/something?a=b", FileUpload_GetFakeData_Callback, &fakeContext, &httpResponse, testValidBufferHandle, NULL, NULL, 1, &checkpoint);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
+
+    ///cleanup
+    gballoc_free(fakeContext.fakeData);
+}
+
+#define TEST_MAX_READ_BLOCKS 4
+
+static unsigned long long readBlockOffsets[TEST_MAX_READ_BLOCKS];
+static size_t readBlockCount;
+static int readBlockResult;
+static unsigned char readBlockData[10];
+
+static int test_read_block(BUFFER_HANDLE block, unsigned long long offset, void* context)
+{
+    (void)block;
+    (void)context;
+    if (readBlockCount < TEST_MAX_READ_BLOCKS)
+    {
+        readBlockOffsets[readBlockCount] = offset;
+    }
+    readBlockCount++;
+    return readBlockResult;
+}
+
+/*Tests_SRS_BLOB_09_030: [ If `SASURI` or `readBlockCallback` is NULL then `Blob_UploadMultipleBlocksFromReader` shall fail and return `BLOB_INVALID_ARG`. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromReader_with_NULL_readBlockCallback_fails)
+{
+    ///arrange
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromReader("https://h.h/something?a=b", NULL, NULL, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_BLOB_09_027: [ `Blob_UploadMultipleBlocksFromReader` shall create an empty BUFFER_HANDLE for every block and call `readBlockCallback` with it and the offset of the block, and shall upload that same buffer. ]*/
+/*Tests_SRS_BLOB_09_029: [ If `readBlockCallback` leaves the buffer empty, `Blob_UploadMultipleBlocksFromReader` shall exit the loop. ]*/
+/*Tests_SRS_BLOB_09_031: [ Otherwise `Blob_UploadMultipleBlocksFromReader` shall upload the blocks like `Blob_UploadMultipleBlocksFromSasUri`, reading them with `readBlockCallback` instead of copying them from `getDataCallbackEx`. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromReader_uploads_the_buffers_read_without_copying_them)
+{
+    ///arrange
+    readBlockCount = 0;
+    readBlockResult = 0;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+
+    /*block 0 is read into its upload buffer, there is no BUFFER_create*/
+    STRICT_EXPECTED_CALL(BUFFER_new());
+    STRICT_EXPECTED_CALL(BUFFER_length(IGNORED_PTR_ARG))
+        .SetReturn(10);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG)) /*the block is hashed for the checkpoint*/
+        .SetReturn(readBlockData);
+    STRICT_EXPECTED_CALL(Base64_Encode_Bytes(IGNORED_PTR_ARG, 6));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "<Latest>"));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</Latest>"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=block&blockid="));
+    STRICT_EXPECTED_CALL(STRING_concat_with_STRING(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, &httpResponse, NULL, testValidBufferHandle))
+        .CopyOutArgumentBuffer_statusCode(&TwoHundred, sizeof(TwoHundred));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+
+    /*the reader leaves the next buffer empty*/
+    STRICT_EXPECTED_CALL(BUFFER_new());
+    STRICT_EXPECTED_CALL(BUFFER_length(IGNORED_PTR_ARG))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+
+    /*Put Block List*/
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "</BlockList>"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=blocklist"));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_PUT, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, &httpResponse, NULL, testValidBufferHandle))
+        .CopyOutArgumentBuffer_statusCode(&TwoHundred, sizeof(TwoHundred));
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromReader("https://h.h/something?a=b", test_read_block, NULL, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, (int)readBlockCount);
+    ASSERT_ARE_EQUAL(int, 0, (int)readBlockOffsets[0]);
+    ASSERT_ARE_EQUAL(int, 10, (int)readBlockOffsets[1]);
+}
+
+/*Tests_SRS_BLOB_09_028: [ If `readBlockCallback` fails, `Blob_UploadMultipleBlocksFromReader` shall fail and return `BLOB_ERROR`. ]*/
+TEST_FUNCTION(Blob_UploadMultipleBlocksFromReader_fails_when_readBlockCallback_fails)
+{
+    ///arrange
+    readBlockCount = 0;
+    readBlockResult = __LINE__;
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n<BlockList>"));
+    STRICT_EXPECTED_CALL(BUFFER_new());
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the XML string used for Put Block List operation*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+
+    ///act
+    BLOB_RESULT result = Blob_UploadMultipleBlocksFromReader("https://h.h/something?a=b", test_read_block, NULL, &httpResponse, testValidBufferHandle, NULL, NULL, 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
+    ASSERT_ARE_EQUAL(int, 1, (int)readBlockCount);
+}
+
+static void set_expected_calls_for_Blob_VerifyUncommittedBlocks_start(const unsigned int* statusCode)
+{
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=blocklist&blocklisttype=uncommitted"));
+    STRICT_EXPECTED_CALL(BUFFER_new());
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_GET, IGNORED_PTR_ARG, NULL, NULL, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_statusCode(statusCode, sizeof(*statusCode));
+}
+
+static void set_expected_calls_for_Blob_VerifyUncommittedBlocks_end(void)
+{
+    STRICT_EXPECTED_CALL(BUFFER_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the relative path*/
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG)); /*this is freeing the copy of the hostname*/
+}
+
+/*Tests_SRS_BLOB_09_011: [ If `SASURI` is NULL, or the hostname cannot be determined from it, `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_INVALID_ARG`. ]*/
+TEST_FUNCTION(Blob_VerifyUncommittedBlocks_with_NULL_SASURI_fails)
+{
+    ///arrange
+
+    ///act
+    BLOB_RESULT result = Blob_VerifyUncommittedBlocks(NULL, 1, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_INVALID_ARG, result);
+}
+
+/*Tests_SRS_BLOB_09_012: [ `Blob_VerifyUncommittedBlocks` shall get the uncommitted block list of the blob with a GET request to the relative path of `SASURI` + "&comp=blocklist&blocklisttype=uncommitted". ]*/
+/*Tests_SRS_BLOB_09_015: [ `Blob_VerifyUncommittedBlocks` shall succeed and return `BLOB_OK` only if the IDs of blocks 0 to `blockCount` - 1 are all in the uncommitted block list, otherwise it shall return `BLOB_ERROR`. ]*/
+/*Tests_SRS_BLOB_09_032: [ `Blob_VerifyUncommittedBlocks` shall read the block list only once, decoding the ID of every block it contains. ]*/
+TEST_FUNCTION(Blob_VerifyUncommittedBlocks_succeeds_when_all_blocks_are_uncommitted)
+{
+    ///arrange
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_start(&TwoHundred);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_length(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_from_byte_array(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(3)); /*this is the set of the blocks found in the list*/
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+        .SetReturn("<UncommittedBlocks><Block><Name>ICAgICAx</Name><Size>10</Size></Block><Block><Name>ICAgICAw</Name><Size>10</Size></Block></UncommittedBlocks>");
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the block list*/
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_end();
+
+    ///act
+    BLOB_RESULT result = Blob_VerifyUncommittedBlocks("https://h.h/something?a=b", 2, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_OK, result);
+}
+
+/*Tests_SRS_BLOB_09_015: [ `Blob_VerifyUncommittedBlocks` shall succeed and return `BLOB_OK` only if the IDs of blocks 0 to `blockCount` - 1 are all in the uncommitted block list, otherwise it shall return `BLOB_ERROR`. ]*/
+/*Tests_SRS_BLOB_09_032: [ `Blob_VerifyUncommittedBlocks` shall read the block list only once, decoding the ID of every block it contains. ]*/
+TEST_FUNCTION(Blob_VerifyUncommittedBlocks_fails_when_a_block_is_missing)
+{
+    ///arrange
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_start(&TwoHundred);
+    STRICT_EXPECTED_CALL(BUFFER_u_char(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_length(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_from_byte_array(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(gballoc_malloc(3)); /*this is the set of the blocks found in the list*/
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+        .SetReturn("<UncommittedBlocks><Block><Name>ICAgICAx</Name></Block><Block><Name>ICAgICAx</Name></Block><Block><Name>ICAgICA5</Name></Block></UncommittedBlocks>");
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG)); /*this is the block list*/
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_end();
+
+    ///act
+    BLOB_RESULT result = Blob_VerifyUncommittedBlocks("https://h.h/something?a=b", 2, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
+}
+
+/*Tests_SRS_BLOB_09_014: [ If the HTTP status is >= 300 (for example the SAS has expired), `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_ERROR`. ]*/
+TEST_FUNCTION(Blob_VerifyUncommittedBlocks_fails_when_http_status_is_404)
+{
+    ///arrange
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_start(&FourHundredFour);
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_end();
+
+    ///act
+    BLOB_RESULT result = Blob_VerifyUncommittedBlocks("https://h.h/something?a=b", 2, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_ERROR, result);
+}
+
+/*Tests_SRS_BLOB_09_013: [ If the request fails, `Blob_VerifyUncommittedBlocks` shall fail and return `BLOB_HTTP_ERROR`. ]*/
+TEST_FUNCTION(Blob_VerifyUncommittedBlocks_fails_when_HTTPAPIEX_ExecuteRequest_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)); /*this is creating a copy of the hostname */
+    STRICT_EXPECTED_CALL(HTTPAPIEX_Create("h.h"));
+    STRICT_EXPECTED_CALL(STRING_construct("/something?a=b"));
+    STRICT_EXPECTED_CALL(STRING_concat(IGNORED_PTR_ARG, "&comp=blocklist&blocklisttype=uncommitted"));
+    STRICT_EXPECTED_CALL(BUFFER_new());
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(HTTPAPIEX_ExecuteRequest(IGNORED_PTR_ARG, HTTPAPI_REQUEST_GET, IGNORED_PTR_ARG, NULL, NULL, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        .SetReturn(HTTPAPIEX_ERROR);
+    set_expected_calls_for_Blob_VerifyUncommittedBlocks_end();
+
+    ///act
+    BLOB_RESULT result = Blob_VerifyUncommittedBlocks("https://h.h/something?a=b", 2, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(BLOB_RESULT, BLOB_HTTP_ERROR, result);
+}
+
 END_TEST_SUITE(blob_ut);
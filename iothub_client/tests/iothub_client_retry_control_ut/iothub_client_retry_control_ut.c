@@ -37,6 +37,7 @@ void real_free(void* ptr)
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/agenttime.h"
+#include "azure_c_shared_utility/tickcounter.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "iothub_client_ll.h"
 #undef ENABLE_MOCKS
@@ -60,9 +61,11 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 
 #define INDEFINITE_TIME                     ((time_t)-1)
 #define TEST_OPTIONHANDLER_HANDLE           (OPTIONHANDLER_HANDLE)0x7771
+#define TEST_TICK_COUNTER_HANDLE            (TICK_COUNTER_HANDLE)0x7772
 
 
 static time_t TEST_current_time;
+static tickcounter_ms_t TEST_current_ms;
 
 
 // Helpers
@@ -97,11 +100,20 @@ static OPTIONHANDLER_RESULT TEST_OptionHandler_AddOption_result;
 static OPTIONHANDLER_RESULT TEST_OptionHandler_AddOption(OPTIONHANDLER_HANDLE handle, const char* name, const void* value)
 {
     (void)handle;
-    (void)name;
-    TEST_OptionHandler_AddOption_saved_value = *(const unsigned int*)value;
+    if (strcmp(name, RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT) == 0)
+    {
+        TEST_OptionHandler_AddOption_saved_value = *(const unsigned int*)value;
+    }
     return TEST_OptionHandler_AddOption_result;
 }
 
+static int TEST_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    *current_ms = TEST_current_ms;
+    return 0;
+}
+
 static time_t add_seconds(time_t base_time, int seconds)
 {
     time_t new_time;
@@ -120,9 +132,11 @@ static time_t add_seconds(time_t base_time, int seconds)
     return new_time;
 }
 
-static void run_and_verify_should_retry(RETRY_CONTROL_HANDLE handle, time_t first_retry_time, time_t last_retry_time, time_t current_time, double secs_since_first_retry, double secs_since_last_retry, RETRY_ACTION expected_retry_action, bool is_first_check)
+static void run_and_verify_should_retry(RETRY_CONTROL_HANDLE handle, time_t first_retry_time, time_t current_time, tickcounter_ms_t current_ms, double secs_since_first_retry, RETRY_ACTION expected_retry_action, bool is_first_check)
 {
     // arrange
+    TEST_current_ms = current_ms;
+
     umock_c_reset_all_calls();
     if (is_first_check)
     {
@@ -135,13 +149,13 @@ static void run_and_verify_should_retry(RETRY_CONTROL_HANDLE handle, time_t firs
 
         if (expected_retry_action != RETRY_ACTION_STOP_RETRYING)
         {
-            STRICT_EXPECTED_CALL(get_difftime(current_time, last_retry_time)).SetReturn(secs_since_last_retry);
+            STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
         }
     }
 
     if (expected_retry_action == RETRY_ACTION_RETRY_NOW)
     {
-        STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(current_time);
+        STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
     }
 
     // act
@@ -156,19 +170,16 @@ static void run_and_verify_should_retry(RETRY_CONTROL_HANDLE handle, time_t firs
 
 // @brief
 //     The first element of 'expected_retry_times' shall be 0
-static void run_and_verify_should_retry_times(RETRY_CONTROL_HANDLE handle, int* expected_retry_times, int number_of_elements, unsigned int max_retry_time_in_secs)
+//     RETRY_NOW is checked after the longest wait 'max_jitter_percent' can add to each expected time
+static void run_and_verify_should_retry_times_with_jitter(RETRY_CONTROL_HANDLE handle, int* expected_retry_times, int number_of_elements, unsigned int max_retry_time_in_secs, unsigned int max_jitter_percent)
 {
     time_t current_time = TEST_current_time;
-    time_t first_time = INDEFINITE_TIME;
-    time_t last_time = INDEFINITE_TIME;
+    time_t first_time = current_time;
+    tickcounter_ms_t current_ms = 0;
     unsigned int secs_since_first_try = 0;
-    unsigned int secs_since_last_try = 0;
     RETRY_ACTION expected_retry_action = RETRY_ACTION_RETRY_NOW;
 
-    run_and_verify_should_retry(handle, first_time, last_time, current_time, secs_since_first_try, secs_since_last_try, expected_retry_action, true);
-
-    first_time = current_time;
-    last_time = current_time;
+    run_and_verify_should_retry(handle, INDEFINITE_TIME, current_time, current_ms, secs_since_first_try, expected_retry_action, true);
 
     int i;
     for (i = 1; i < number_of_elements; i++)
@@ -182,27 +193,94 @@ static void run_and_verify_should_retry_times(RETRY_CONTROL_HANDLE handle, int*
             time_t half_current_time = add_seconds(current_time, half_secs_since_last_try);
             expected_retry_action = (half_secs_since_first_try < max_retry_time_in_secs ? RETRY_ACTION_RETRY_LATER : RETRY_ACTION_STOP_RETRYING);
 
-            run_and_verify_should_retry(handle, first_time, last_time, half_current_time, half_secs_since_first_try, half_secs_since_last_try, expected_retry_action, false);
+            run_and_verify_should_retry(handle, first_time, half_current_time, current_ms + half_secs_since_last_try * 1000, half_secs_since_first_try, expected_retry_action, false);
         }
 
         // RETRY_NOW/STOP_RETRYING time test
-        secs_since_last_try = expected_retry_times[i];
         secs_since_first_try += expected_retry_times[i];
-        current_time = add_seconds(current_time, secs_since_last_try);
+        current_time = add_seconds(current_time, expected_retry_times[i]);
+        current_ms += expected_retry_times[i] * (1000 + 10 * max_jitter_percent);
         expected_retry_action = (secs_since_first_try < max_retry_time_in_secs ? RETRY_ACTION_RETRY_NOW : RETRY_ACTION_STOP_RETRYING);
 
-        run_and_verify_should_retry(handle, first_time, last_time, current_time, secs_since_first_try, secs_since_last_try, expected_retry_action, false);
+        run_and_verify_should_retry(handle, first_time, current_time, current_ms, secs_since_first_try, expected_retry_action, false);
+    }
+}
+
+// @brief
+//     The first element of 'expected_retry_times' shall be 0
+static void run_and_verify_should_retry_times(RETRY_CONTROL_HANDLE handle, int* expected_retry_times, int number_of_elements, unsigned int max_retry_time_in_secs)
+{
+    run_and_verify_should_retry_times_with_jitter(handle, expected_retry_times, number_of_elements, max_retry_time_in_secs, 0);
+}
+
+// @brief
+//     Advances the clock in 'step_ms' increments until `handle` allows the next attempt.
+//     Returns the time waited, or 0 if 'limit_ms' elapsed first.
+static tickcounter_ms_t wait_for_next_retry(RETRY_CONTROL_HANDLE handle, tickcounter_ms_t step_ms, tickcounter_ms_t limit_ms)
+{
+    tickcounter_ms_t result = 0;
+    tickcounter_ms_t start_ms = TEST_current_ms;
+    RETRY_ACTION retry_action;
+
+    while (TEST_current_ms - start_ms < limit_ms)
+    {
+        TEST_current_ms += step_ms;
+        umock_c_reset_all_calls();
 
-        if (expected_retry_action == RETRY_ACTION_RETRY_NOW)
+        if (retry_control_should_retry(handle, &retry_action) == 0 && retry_action == RETRY_ACTION_RETRY_NOW)
         {
-            last_time = current_time;
+            result = TEST_current_ms - start_ms;
+            break;
+        }
+    }
+
+    return result;
+}
+
+static RETRY_CONTROL_HANDLE create_seeded_retry_control(IOTHUB_CLIENT_RETRY_POLICY policy_name, unsigned int seed, unsigned int max_delay_in_secs)
+{
+    RETRY_CONTROL_HANDLE handle = create_retry_control(policy_name, 0);
+    ASSERT_ARE_EQUAL(int, 0, retry_control_set_option(handle, RETRY_CONTROL_OPTION_RANDOM_SEED, &seed));
+    ASSERT_ARE_EQUAL(int, 0, retry_control_set_option(handle, RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, &max_delay_in_secs));
+
+    // First attempt, always allowed right away.
+    RETRY_ACTION retry_action;
+    TEST_current_ms = 0;
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, retry_control_should_retry(handle, &retry_action));
+    ASSERT_ARE_EQUAL(int, RETRY_ACTION_RETRY_NOW, retry_action);
+
+    return handle;
+}
+
+static size_t count_distinct_buckets(tickcounter_ms_t* values, size_t count, tickcounter_ms_t bucket_size_ms)
+{
+    size_t result = 0;
+    size_t i, j;
+
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            if (values[j] / bucket_size_ms == values[i] / bucket_size_ms)
+            {
+                break;
+            }
+        }
+
+        if (j == i)
+        {
+            result++;
         }
     }
+
+    return result;
 }
 
 static void reset_test_data()
 {
     TEST_current_time = time(NULL);
+    TEST_current_ms = 0;
 
     TEST_OptionHandler_AddOption_saved_value = 0;
     TEST_OptionHandler_AddOption_result = OPTIONHANDLER_OK;
@@ -215,6 +293,7 @@ static void register_umock_alias_types()
 {
     REGISTER_UMOCK_ALIAS_TYPE(time_t, long long);
     REGISTER_UMOCK_ALIAS_TYPE(OPTIONHANDLER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(OPTIONHANDLER_RESULT, int);
     REGISTER_UMOCK_ALIAS_TYPE(pfCloneOption, void*);
     REGISTER_UMOCK_ALIAS_TYPE(pfDestroyOption, void*);
@@ -226,6 +305,7 @@ static void register_global_mock_hooks()
     REGISTER_GLOBAL_MOCK_HOOK(malloc, TEST_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(free, TEST_free);
     REGISTER_GLOBAL_MOCK_HOOK(OptionHandler_AddOption, TEST_OptionHandler_AddOption);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, TEST_tickcounter_get_current_ms);
 }
 
 static void register_global_mock_returns() 
@@ -238,6 +318,11 @@ static void register_global_mock_returns()
 
     REGISTER_GLOBAL_MOCK_RETURN(OptionHandler_FeedOptions, OPTIONHANDLER_OK);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(OptionHandler_FeedOptions, OPTIONHANDLER_ERROR);
+
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER_HANDLE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(tickcounter_create, NULL);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(tickcounter_get_current_ms, 1);
 }
 
 
@@ -245,6 +330,7 @@ static RETRY_CONTROL_HANDLE create_retry_control(IOTHUB_CLIENT_RETRY_POLICY poli
 {
     umock_c_reset_all_calls();
     EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
     RETRY_CONTROL_HANDLE handle = retry_control_create(policy_name, max_retry_time_in_secs);
 
     return handle;
@@ -324,13 +410,34 @@ TEST_FUNCTION(create_malloc_fails)
     umock_c_reset_all_calls();
 }
 
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_067: [If tickcounter_create() fails, `retry_control_create` shall free `retry_control` and return NULL]
+TEST_FUNCTION(create_tickcounter_create_fails)
+{
+    // arrange
+    umock_c_reset_all_calls();
+    EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create()).SetReturn(NULL);
+    EXPECTED_CALL(free(IGNORED_PTR_ARG));
+
+    // act
+    RETRY_CONTROL_HANDLE handle = retry_control_create(IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, 10);
+
+    // assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_002: [`retry_control_create` shall allocate memory for the retry control instance structure (a.k.a. `retry_control`)]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_066: [`retry_control->tick_counter` shall be created using tickcounter_create()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_009: [If no errors occur, `retry_control_create` shall return a handle to `retry_control`]
 TEST_FUNCTION(create_success)
 {
     // arrange
     umock_c_reset_all_calls();
     EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
 
     // act
     RETRY_CONTROL_HANDLE handle = retry_control_create(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 10);
@@ -358,15 +465,18 @@ TEST_FUNCTION(destroy_NULL_handle)
     // cleanup
 }
 
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_073: [`retry_control_destroy` shall destroy `retry_control->tick_counter` using tickcounter_destroy()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_056: [`retry_control_destroy` shall destroy `retry_control_handle` using free()]
 TEST_FUNCTION(destroy_success)
 {
     // arrange
     umock_c_reset_all_calls();
     EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
     RETRY_CONTROL_HANDLE handle = retry_control_create(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 10);
 
     umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(tickcounter_destroy(TEST_TICK_COUNTER_HANDLE));
     EXPECTED_CALL(free(IGNORED_PTR_ARG));
 
     // act
@@ -492,12 +602,14 @@ TEST_FUNCTION(Retrieve_Options_NULL_handle)
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_046: [An instance of OPTIONHANDLER_HANDLE (a.k.a. `options`) shall be created using OptionHandler_Create]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_050: [`retry_control->initial_wait_time_in_secs` shall be added to `options` using OptionHandler_Add]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_051: [`retry_control->max_jitter_percent` shall be added to `options` using OptionHandler_Add]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_076: [`retry_control->max_delay_in_secs` shall be added to `options` using OptionHandler_Add]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_054: [If no errors occur, `retry_control_retrieve_options` shall return the OPTIONHANDLER_HANDLE instance]
 TEST_FUNCTION(Retrieve_Options_success)
 {
     // arrange
     umock_c_reset_all_calls();
     EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
     RETRY_CONTROL_HANDLE handle = retry_control_create(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 10);
 
     umock_c_reset_all_calls();
@@ -506,6 +618,8 @@ TEST_FUNCTION(Retrieve_Options_success)
         .IgnoreArgument_value();
     STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, IGNORED_PTR_ARG))
         .IgnoreArgument_value();
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, IGNORED_PTR_ARG))
+        .IgnoreArgument_value();
 
     // act
     OPTIONHANDLER_HANDLE result = retry_control_retrieve_options(handle);
@@ -529,6 +643,7 @@ TEST_FUNCTION(Retrieve_Options_failure_checks)
 
     umock_c_reset_all_calls();
     EXPECTED_CALL(malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_create());
     RETRY_CONTROL_HANDLE handle = retry_control_create(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 10);
 
     umock_c_reset_all_calls();
@@ -537,6 +652,8 @@ TEST_FUNCTION(Retrieve_Options_failure_checks)
         .IgnoreArgument_value();
     STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, IGNORED_PTR_ARG))
         .IgnoreArgument_value();
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, IGNORED_PTR_ARG))
+        .IgnoreArgument_value();
     umock_c_negative_tests_snapshot();
 
     // act
@@ -803,7 +920,7 @@ TEST_FUNCTION(Should_Retry_evaluate_retry_action_failure)
     // This first call succeeds because retry_count is 0
     umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(TEST_current_time);
-    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(TEST_current_time);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
     RETRY_ACTION retry_action;
     (void)retry_control_should_retry(handle, &retry_action);
 
@@ -822,7 +939,7 @@ TEST_FUNCTION(Should_Retry_evaluate_retry_action_failure)
 }
 
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_014: [If evaluate_retry_action() fails, retry_control_should_retry shall fail and return non-zero]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_020: [If `retry_control->last_retry_time` is INDEFINITE_TIME and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, the evaluation function shall return non-zero]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_020: [If `retry_control->last_retry_time_in_ms` is not set and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, the evaluation function shall return non-zero]
 TEST_FUNCTION(Should_Retry_INDEFINITE_last_retry_time)
 {
     // arrange
@@ -832,7 +949,7 @@ TEST_FUNCTION(Should_Retry_INDEFINITE_last_retry_time)
     // This first call succeeds because retry_count is 0
     umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(TEST_current_time);
-    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(INDEFINITE_TIME);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG)).SetReturn(1);
     RETRY_ACTION retry_action;
     (void)retry_control_should_retry(handle, &retry_action);
 
@@ -882,21 +999,21 @@ TEST_FUNCTION(Should_Retry_NO_MAX_RETRY_TIME_success)
 }
 
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_004: [The parameters passed to `retry_control_create` shall be saved into `retry_control`]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_005: [If `policy_name` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF or IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `retry_control->initial_wait_time_in_secs` shall be set to 1]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_005: [If `policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER or IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, `retry_control->initial_wait_time_in_secs` shall be set to 1]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_008: [The remaining fields in `retry_control` shall be initialized according to retry_control_reset()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_011: [If `retry_control->first_retry_time` is INDEFINITE_TIME, it shall be set using get_time()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_013: [evaluate_retry_action() shall be invoked]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_015: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW, `retry_control->retry_count` shall be incremented by 1]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_016: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->last_retry_time` shall be set using get_time()]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_017: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->current_wait_time_in_secs` shall be set using calculate_next_wait_time()]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_016: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->last_retry_time_in_ms` shall be set using tickcounter_get_current_ms()]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_017: [If `retry_action` is set to RETRY_ACTION_RETRY_NOW and policy is not IOTHUB_CLIENT_RETRY_IMMEDIATE, `retry_control->current_wait_time_in_ms` shall be set using calculate_next_wait_time()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_018: [If no errors occur, `retry_control_should_retry` shall return 0]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_019: [If `retry_control->retry_count` is 0, `retry_action` shall be set to RETRY_ACTION_RETRY_NOW]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_021: [`current_time` shall be set using get_time()]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_023: [If `retry_control->max_retry_time_in_secs` is not 0 and (`current_time` - `retry_control->first_retry_time`) is greater than or equal to `retry_control->max_retry_time_in_secs`, `retry_action` shall be set to RETRY_ACTION_STOP_RETRYING]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_024: [Otherwise, if (`current_time` - `retry_control->last_retry_time`) is less than `retry_control->current_wait_time_in_secs`, `retry_action` shall be set to RETRY_ACTION_RETRY_LATER]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_025: [Otherwise, if (`current_time` - `retry_control->last_retry_time`) is greater or equal to `retry_control->current_wait_time_in_secs`, `retry_action` shall be set to RETRY_ACTION_RETRY_NOW]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_024: [Otherwise, if (`current_time_in_ms` - `retry_control->last_retry_time_in_ms`) is less than `retry_control->current_wait_time_in_ms`, `retry_action` shall be set to RETRY_ACTION_RETRY_LATER]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_025: [Otherwise, if (`current_time_in_ms` - `retry_control->last_retry_time_in_ms`) is greater or equal to `retry_control->current_wait_time_in_ms`, `retry_action` shall be set to RETRY_ACTION_RETRY_NOW]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_026: [If no errors occur, the evaluation function shall return 0]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy_name` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs`) * (1 + (`retry_control->max_jitter_percent` / 100) * (rand() / RAND_MAX)))]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000) * (1 + (`retry_control->max_jitter_percent` / 100) * `random_ratio`))]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_040: [If `name` is "max_jitter_percent", value shall be saved on `retry_control->max_jitter_percent`]
 TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_WITH_JITTER_success)
 {
@@ -908,6 +1025,26 @@ TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_WITH_JITTER_success)
 
     int expected_retry_times[] = { 0, 1, 2, 4, 8 };
 
+    run_and_verify_should_retry_times_with_jitter(handle, expected_retry_times, 5, 10, option_value);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, set_option_result);
+
+    // cleanup
+    retry_control_destroy(handle);
+}
+
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000) * (1 + (`retry_control->max_jitter_percent` / 100) * `random_ratio`))]
+TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_WITH_JITTER_zero_jitter_waits_exact_milliseconds)
+{
+    // arrange
+    RETRY_CONTROL_HANDLE handle = create_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 10);
+
+    unsigned int option_value = 0;
+    int set_option_result = retry_control_set_option(handle, RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, &option_value);
+
+    int expected_retry_times[] = { 0, 1, 2, 4, 8 };
+
     run_and_verify_should_retry_times(handle, expected_retry_times, 5, 10);
 
     // assert
@@ -917,7 +1054,34 @@ TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_WITH_JITTER_success)
     retry_control_destroy(handle);
 }
 
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_031: [If `retry_control->policy_name` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, `calculate_next_wait_time` shall return (pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs`)]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_032: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, `calculate_next_wait_time` shall return ((pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000) * (1 + (`retry_control->max_jitter_percent` / 100) * `random_ratio`))]
+TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_WITH_JITTER_waits_within_jitter_bounds)
+{
+    // arrange
+    RETRY_CONTROL_HANDLE handle = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER, 7, 0);
+    unsigned int max_jitter_percent = 50;
+    tickcounter_ms_t base_wait_ms = 1000;
+    int i;
+
+    ASSERT_ARE_EQUAL(int, 0, retry_control_set_option(handle, RETRY_CONTROL_OPTION_MAX_JITTER_PERCENT, &max_jitter_percent));
+
+    for (i = 0; i < 4; i++)
+    {
+        // act
+        tickcounter_ms_t wait = wait_for_next_retry(handle, 1, 60000);
+
+        // assert
+        ASSERT_IS_TRUE(wait >= base_wait_ms);
+        ASSERT_IS_TRUE(wait <= base_wait_ms + base_wait_ms / 2);
+
+        base_wait_ms *= 2;
+    }
+
+    // cleanup
+    retry_control_destroy(handle);
+}
+
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_031: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, `calculate_next_wait_time` shall return (pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000)]
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_038: [If `name` is "initial_wait_time_in_secs", `value` shall be saved on `retry_control->initial_wait_time_in_secs`]
 TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_success)
 {
@@ -939,7 +1103,7 @@ TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_success)
     retry_control_destroy(handle);
 }
 
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_029: [If `retry_control->policy_name` is IOTHUB_CLIENT_RETRY_INTERVAL, `calculate_next_wait_time` shall return `retry_control->initial_wait_time_in_secs`]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_029: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_INTERVAL, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000)]
 TEST_FUNCTION(Should_Retry_INTERVAL_success)
 {
     // arrange
@@ -957,7 +1121,7 @@ TEST_FUNCTION(Should_Retry_INTERVAL_success)
 }
 
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_006: [Otherwise `retry_control->initial_wait_time_in_secs` shall be set to 5]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_030: [If `retry_control->policy_name` is IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * (`retry_control->retry_count`))]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_030: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_LINEAR_BACKOFF, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000 * (`retry_control->retry_count`))]
 TEST_FUNCTION(Should_Retry_LINEAR_BACKOFF_success)
 {
     // arrange
@@ -974,7 +1138,7 @@ TEST_FUNCTION(Should_Retry_LINEAR_BACKOFF_success)
     retry_control_destroy(handle);
 }
 
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_033: [If `retry_control->policy_name` is IOTHUB_CLIENT_RETRY_RANDOM, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * (rand() / RAND_MAX))]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_033: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_RANDOM, `calculate_next_wait_time` shall return (`retry_control->initial_wait_time_in_secs` * 1000 * `random_ratio`)]
 // This test must be replaced. Create an auxiliary module for get_rand() in c-shared-utilities and test using that
 /*
 TEST_FUNCTION(Should_Retry_RANDOM_success)
@@ -1118,7 +1282,7 @@ TEST_FUNCTION(Should_Retry_RETRY_NONE_success)
 }
 
 // Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_034: [If `retry_control_handle` is NULL, `retry_control_reset` shall return]
-// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_035: [`retry_control` shall have fields `retry_count` and `current_wait_time_in_secs` set to 0 (zero), `first_retry_time` and `last_retry_time` set to INDEFINITE_TIME]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_035: [`retry_control` shall have fields `retry_count`, `current_wait_time_in_ms` and `last_retry_time_in_ms` set to 0 (zero), `first_retry_time` set to INDEFINITE_TIME and `last_retry_time_in_ms` marked as not set]
 TEST_FUNCTION(Reset_success)
 {
     // arrange
@@ -1162,4 +1326,130 @@ TEST_FUNCTION(Reset_success)
     retry_control_destroy(handle);
 }
 
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_068: [If `retry_control->max_delay_in_secs` is not 0, the value returned by `calculate_next_wait_time` shall not exceed (`retry_control->max_delay_in_secs` * 1000)]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_074: [If `name` is "max_delay_in_secs", value shall be saved on `retry_control->max_delay_in_secs`]
+TEST_FUNCTION(Should_Retry_EXPONENTIAL_BACKOFF_max_delay_success)
+{
+    // arrange
+    unsigned int max_retry_time_in_secs = 20;
+    RETRY_CONTROL_HANDLE handle = create_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, max_retry_time_in_secs);
+
+    unsigned int option_value = 3;
+    int set_option_result = retry_control_set_option(handle, RETRY_CONTROL_OPTION_MAX_DELAY_IN_SECS, &option_value);
+
+    int expected_retry_times[] = { 0, 1, 2, 3, 3, 3 };
+
+    // act
+    run_and_verify_should_retry_times(handle, expected_retry_times, 6, max_retry_time_in_secs);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, set_option_result);
+
+    // cleanup
+    retry_control_destroy(handle);
+}
+
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_064: [`current_time_in_ms` shall be set using tickcounter_get_current_ms()]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_069: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER, `calculate_next_wait_time` shall return (`random_ratio` * min(`max_delay`, pow(2, `retry_control->retry_count` - 1) * `retry_control->initial_wait_time_in_secs` * 1000))]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_075: [If `name` is "random_seed", value (an unsigned int) shall be used to re-seed the random generator of `retry_control`]
+TEST_FUNCTION(Should_Retry_FULL_JITTER_same_seed_same_waits)
+{
+    // arrange
+    RETRY_CONTROL_HANDLE handle1 = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER, 1234, 0);
+    tickcounter_ms_t waits1[6];
+    tickcounter_ms_t waits2[6];
+    size_t i;
+
+    for (i = 0; i < 6; i++)
+    {
+        waits1[i] = wait_for_next_retry(handle1, 10, 60000);
+    }
+
+    RETRY_CONTROL_HANDLE handle2 = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_FULL_JITTER, 1234, 0);
+
+    // act
+    for (i = 0; i < 6; i++)
+    {
+        waits2[i] = wait_for_next_retry(handle2, 10, 60000);
+    }
+
+    // assert
+    for (i = 0; i < 6; i++)
+    {
+        tickcounter_ms_t upper_bound = ((tickcounter_ms_t)1000 << i) + 10;
+
+        ASSERT_ARE_EQUAL(uint64_t, waits1[i], waits2[i]);
+        ASSERT_IS_TRUE(waits1[i] > 0);
+        ASSERT_IS_TRUE(waits1[i] <= upper_bound);
+    }
+
+    // cleanup
+    retry_control_destroy(handle1);
+    retry_control_destroy(handle2);
+}
+
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_068: [If `retry_control->max_delay_in_secs` is not 0, the value returned by `calculate_next_wait_time` shall not exceed (`retry_control->max_delay_in_secs` * 1000)]
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_070: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, `calculate_next_wait_time` shall return min(`max_delay`, `initial_wait_time` + `random_ratio` * (3 * `previous_wait_time` - `initial_wait_time`)), where `previous_wait_time` is `retry_control->current_wait_time_in_ms`, or `initial_wait_time` if that is 0]
+TEST_FUNCTION(Should_Retry_DECORRELATED_JITTER_max_delay_success)
+{
+    // arrange
+    RETRY_CONTROL_HANDLE handle = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, 42, 4);
+    tickcounter_ms_t previous_wait = 1000;
+    size_t i;
+
+    for (i = 0; i < 10; i++)
+    {
+        // act
+        tickcounter_ms_t wait = wait_for_next_retry(handle, 10, 60000);
+
+        // assert
+        ASSERT_IS_TRUE(wait >= 1000);
+        ASSERT_IS_TRUE(wait <= 4000 + 10);
+        ASSERT_IS_TRUE(wait <= previous_wait * 3 + 10);
+
+        previous_wait = wait;
+    }
+
+    // cleanup
+    retry_control_destroy(handle);
+}
+
+// Simulates a fleet of devices that lose their connection at the same instant and shows when each one
+// is allowed to reconnect. Plain exponential backoff keeps the whole fleet in lockstep; decorrelated
+// jitter spreads the first reconnect over [initial_wait, 3 * initial_wait].
+// Tests_SRS_IOTHUB_CLIENT_RETRY_CONTROL_09_070: [If `retry_control->policy` is IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, `calculate_next_wait_time` shall return min(`max_delay`, `initial_wait_time` + `random_ratio` * (3 * `previous_wait_time` - `initial_wait_time`)), where `previous_wait_time` is `retry_control->current_wait_time_in_ms`, or `initial_wait_time` if that is 0]
+TEST_FUNCTION(Should_Retry_DECORRELATED_JITTER_spreads_fleet_reconnects)
+{
+    // arrange
+    tickcounter_ms_t exponential_waits[100];
+    tickcounter_ms_t decorrelated_waits[100];
+    size_t number_of_devices = sizeof(decorrelated_waits) / sizeof(decorrelated_waits[0]);
+    size_t i;
+
+    // act
+    for (i = 0; i < number_of_devices; i++)
+    {
+        RETRY_CONTROL_HANDLE handle = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF, (unsigned int)i + 1, 0);
+        exponential_waits[i] = wait_for_next_retry(handle, 10, 10000);
+        retry_control_destroy(handle);
+
+        handle = create_seeded_retry_control(IOTHUB_CLIENT_RETRY_DECORRELATED_JITTER, (unsigned int)i + 1, 0);
+        decorrelated_waits[i] = wait_for_next_retry(handle, 10, 10000);
+        retry_control_destroy(handle);
+    }
+
+    // assert
+    for (i = 0; i < number_of_devices; i++)
+    {
+        ASSERT_ARE_EQUAL(uint64_t, 1000, exponential_waits[i]);
+        ASSERT_IS_TRUE(decorrelated_waits[i] >= 1000);
+        ASSERT_IS_TRUE(decorrelated_waits[i] <= 3000 + 10);
+    }
+
+    ASSERT_ARE_EQUAL(size_t, 1, count_distinct_buckets(exponential_waits, number_of_devices, 100));
+    ASSERT_IS_TRUE(count_distinct_buckets(decorrelated_waits, number_of_devices, 100) >= 15);
+
+    // cleanup
+}
+
 END_TEST_SUITE(iothub_client_retry_control_ut)
@@ -256,6 +256,190 @@ static IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_RESULT FileUpload_GetData_Callback(IOT
     return IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_OK;
 }
 
+/**
+ * TEST_CHECKPOINT_STORE records what upload-to-blob does with OPTION_BLOB_UPLOAD_CHECKPOINT_STORE
+ */
+typedef struct TEST_CHECKPOINT_STORE_TAG
+{
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT loadResult; /* returned by load_checkpoint */
+    unsigned int loadedBlockCount;
+    size_t loadedUploadedBytes;
+    uint64_t loadedContentHash;
+    int loadCount;
+    int saveCount;
+    unsigned int savedBlockCount; /* block count of the latest save */
+    uint64_t savedContentHash; /* content hash of the latest save */
+    int deleteCount;
+}TEST_CHECKPOINT_STORE;
+
+static TEST_CHECKPOINT_STORE testCheckpointStore;
+
+static IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOAD_RESULT test_load_checkpoint(const char* destinationFileName, unsigned int* blockCount, size_t* uploadedBytes, uint64_t* contentHash, void* context)
+{
+    TEST_CHECKPOINT_STORE* store = (TEST_CHECKPOINT_STORE*)context;
+    (void)destinationFileName;
+    store->loadCount++;
+    *blockCount = store->loadedBlockCount;
+    *uploadedBytes = store->loadedUploadedBytes;
+    *contentHash = store->loadedContentHash;
+    return store->loadResult;
+}
+
+static void test_save_checkpoint(const char* destinationFileName, unsigned int blockCount, size_t uploadedBytes, uint64_t contentHash, void* context)
+{
+    TEST_CHECKPOINT_STORE* store = (TEST_CHECKPOINT_STORE*)context;
+    (void)destinationFileName;
+    (void)uploadedBytes;
+    store->saveCount++;
+    store->savedBlockCount = blockCount;
+    store->savedContentHash = contentHash;
+}
+
+static void test_delete_checkpoint(const char* destinationFileName, void* context)
+{
+    TEST_CHECKPOINT_STORE* store = (TEST_CHECKPOINT_STORE*)context;
+    (void)destinationFileName;
+    store->deleteCount++;
+}
+
+static const IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE TEST_CHECKPOINT_STORE_FUNCTIONS =
+{
+    test_load_checkpoint,
+    test_save_checkpoint,
+    test_delete_checkpoint,
+    &testCheckpointStore
+};
+
+/**
+ * my_Blob_UploadMultipleBlocksFromSasUri pulls every block out of getDataCallbackEx, like the real upload does,
+ * and records the sizes of the blocks. Only the tests that need it register it as a hook.
+ */
+#define TEST_MAX_BLOCKS 8
+
+#define TEST_CONTENT_HASH 0x0123456789ABCDEFULL /* the hooks report it as the fingerprint of the uploaded bytes */
+
+typedef struct TEST_BLOB_UPLOAD_TAG
+{
+    int callCount;
+    unsigned int blockCount;
+    size_t blockSizes[TEST_MAX_BLOCKS];
+    unsigned int checkpointBlockCount; /* blockCount of the checkpoint passed to the upload */
+    uint64_t checkpointContentHash; /* contentHash of the checkpoint passed to the upload */
+}TEST_BLOB_UPLOAD;
+
+static TEST_BLOB_UPLOAD testBlobUpload;
+
+static BLOB_RESULT my_Blob_UploadMultipleBlocksFromSasUri(const char* SASURI, IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_CALLBACK_EX getDataCallbackEx, void* context, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS* proxyOptions, size_t parallelUploads, BLOB_UPLOAD_CHECKPOINT* checkpoint)
+{
+    BLOB_RESULT result = BLOB_OK;
+    unsigned char const * data;
+    size_t size;
+    size_t uploadedBytes = 0;
+
+    (void)SASURI;
+    (void)httpResponse;
+    (void)certificates;
+    (void)proxyOptions;
+    (void)parallelUploads;
+
+    testBlobUpload.callCount++;
+    if (checkpoint != NULL)
+    {
+        testBlobUpload.checkpointBlockCount = checkpoint->blockCount;
+        testBlobUpload.checkpointContentHash = checkpoint->contentHash;
+    }
+    do
+    {
+        data = NULL;
+        size = 0;
+        if (getDataCallbackEx(FILE_UPLOAD_OK, &data, &size, context) == IOTHUB_CLIENT_FILE_UPLOAD_GET_DATA_ABORT)
+        {
+            result = BLOB_ABORTED;
+        }
+        else if (data != NULL && size > 0)
+        {
+            if (testBlobUpload.blockCount < TEST_MAX_BLOCKS)
+            {
+                testBlobUpload.blockSizes[testBlobUpload.blockCount] = size;
+            }
+            testBlobUpload.blockCount++;
+            uploadedBytes += size;
+            if (checkpoint != NULL)
+            {
+                checkpoint->onBlockUploaded(testBlobUpload.blockCount, uploadedBytes, TEST_CONTENT_HASH, checkpoint->onBlockUploadedContext);
+            }
+        }
+    } while (result == BLOB_OK && data != NULL && size > 0);
+
+    *httpStatus = 201;
+    return result;
+}
+
+/**
+ * my_Blob_UploadMultipleBlocksFromReader has readBlockCallback read every block into TEST_READ_BLOCK_BUFFER, whose
+ * storage is testReadBlock, and records the sizes of the blocks like my_Blob_UploadMultipleBlocksFromSasUri.
+ */
+#define TEST_READ_BLOCK_BUFFER ((BUFFER_HANDLE)0x4449)
+
+static unsigned char testReadBlock[BLOCK_SIZE];
+static size_t testReadBlockSize;
+static int testTruncateSourceFile; /*when set, the source file is emptied before the first block is read*/
+
+static void truncate_test_source_file(void);
+
+static BLOB_RESULT my_Blob_UploadMultipleBlocksFromReader(const char* SASURI, BLOB_READ_BLOCK_CALLBACK readBlockCallback, void* context, unsigned int* httpStatus, BUFFER_HANDLE httpResponse, const char* certificates, HTTP_PROXY_OPTIONS* proxyOptions, size_t parallelUploads, BLOB_UPLOAD_CHECKPOINT* checkpoint)
+{
+    BLOB_RESULT result = BLOB_OK;
+    unsigned long long offset = 0;
+
+    (void)SASURI;
+    (void)httpResponse;
+    (void)certificates;
+    (void)proxyOptions;
+    (void)parallelUploads;
+
+    if (testTruncateSourceFile)
+    {
+        truncate_test_source_file();
+    }
+
+    testBlobUpload.callCount++;
+    do
+    {
+        testReadBlockSize = 0;
+        if (readBlockCallback(TEST_READ_BLOCK_BUFFER, offset, context) != 0)
+        {
+            result = BLOB_ERROR;
+        }
+        else if (testReadBlockSize > 0)
+        {
+            if (testBlobUpload.blockCount < TEST_MAX_BLOCKS)
+            {
+                testBlobUpload.blockSizes[testBlobUpload.blockCount] = testReadBlockSize;
+            }
+            testBlobUpload.blockCount++;
+            offset += testReadBlockSize;
+            if (checkpoint != NULL)
+            {
+                checkpoint->onBlockUploaded(testBlobUpload.blockCount, (size_t)offset, TEST_CONTENT_HASH, checkpoint->onBlockUploadedContext);
+            }
+        }
+    } while (result == BLOB_OK && testReadBlockSize > 0);
+
+    *httpStatus = 201;
+    return result;
+}
+
+static int my_BUFFER_pre_build(BUFFER_HANDLE handle, size_t size)
+{
+    if (handle == TEST_READ_BLOCK_BUFFER)
+    {
+        ASSERT_IS_TRUE(size <= BLOCK_SIZE);
+        testReadBlockSize = size;
+    }
+    return 0;
+}
+
 #include "azure_c_shared_utility/gballoc.h"
 
 #undef ENABLE_MOCKS
@@ -452,6 +636,53 @@ TEST_SUITE_CLEANUP(TestClassCleanup)
 static void reset_test_data()
 {
     memset(&context, 0, sizeof(context));
+    memset(&testCheckpointStore, 0, sizeof(testCheckpointStore));
+    memset(&testBlobUpload, 0, sizeof(testBlobUpload));
+    testReadBlockSize = 0;
+    testTruncateSourceFile = 0;
+}
+
+#define TEST_SOURCE_FILE "iothub_client_ll_u2b_ut.bin"
+
+/*byte N of the test source file is N % 251, so that misplaced blocks can be detected*/
+static void create_test_source_file(size_t size)
+{
+    unsigned char chunk[1004]; /*a multiple of 251*/
+    size_t i;
+    FILE* file = fopen(TEST_SOURCE_FILE, "wb");
+    ASSERT_IS_NOT_NULL(file);
+    for (i = 0; i < sizeof(chunk); i++)
+    {
+        chunk[i] = (unsigned char)(i % 251);
+    }
+    while (size > 0)
+    {
+        size_t chunkSize = (size > sizeof(chunk)) ? sizeof(chunk) : size;
+        ASSERT_ARE_EQUAL(size_t, chunkSize, fwrite(chunk, 1, chunkSize, file));
+        size -= chunkSize;
+    }
+    ASSERT_ARE_EQUAL(int, 0, fclose(file));
+}
+
+static void truncate_test_source_file(void)
+{
+    FILE* file = fopen(TEST_SOURCE_FILE, "wb");
+    ASSERT_IS_NOT_NULL(file);
+    ASSERT_ARE_EQUAL(int, 0, fclose(file));
+}
+
+static unsigned char* my_BUFFER_u_char(BUFFER_HANDLE handle)
+{
+    return (handle == TEST_READ_BLOCK_BUFFER) ? testReadBlock : TestValid_BUFFER_u_char;
+}
+
+/*makes Blob_UploadMultipleBlocksFromSasUri and Blob_UploadMultipleBlocksFromReader read the data source, the rest of the upload succeeds with the default mocks*/
+static void register_blob_upload_hooks(void)
+{
+    REGISTER_GLOBAL_MOCK_HOOK(Blob_UploadMultipleBlocksFromSasUri, my_Blob_UploadMultipleBlocksFromSasUri);
+    REGISTER_GLOBAL_MOCK_HOOK(Blob_UploadMultipleBlocksFromReader, my_Blob_UploadMultipleBlocksFromReader);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_pre_build, my_BUFFER_pre_build);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, my_BUFFER_u_char);
 }
 
 TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
@@ -467,6 +698,10 @@ TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
 
 TEST_FUNCTION_CLEANUP(TestMethodCleanup)
 {
+    REGISTER_GLOBAL_MOCK_HOOK(Blob_UploadMultipleBlocksFromSasUri, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Blob_UploadMultipleBlocksFromReader, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_pre_build, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, NULL);
     reset_test_data();
     TEST_MUTEX_RELEASE(g_testByTest);
 }
@@ -867,7 +1102,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_happypath)
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -1195,7 +1430,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_with_certificates_happypath
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, "some certificates", IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, "some certificates", IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -1693,7 +1928,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_when_step2_httpStatusCode_i
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -2018,7 +2253,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_when_step2_aborts_succeeds)
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -2332,7 +2567,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_when_step2_aborts_unhappypa
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -2691,7 +2926,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_when_step3_httpStatusCode_i
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -3026,7 +3261,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SAS_token_unhappypaths)
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -3524,7 +3759,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadMultipleBlocksToBlob_deviceKey_happypath)
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -4021,7 +4256,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_deviceKey_when_step3_httpStatusCode_i
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -4376,7 +4611,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadMultipleBlocksToBlob_deviceKey_unhappypaths)
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -4773,7 +5008,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_passes_x509_information_to_HTTPAPIEX_
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -5103,7 +5338,7 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_passes_x509_information_to_HTTPAPIEX_
             .CaptureReturn(&sasUri_as_const_char)
             .IgnoreArgument(1);
 
-        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG))
+        STRICT_EXPECTED_CALL(Blob_UploadMultipleBlocksFromSasUri(sasUri_as_const_char, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL, IGNORED_PTR_ARG, 1, NULL))
             .IgnoreArgument(1)
             .IgnoreArgument(4)
             .IgnoreArgument(5)
@@ -5421,5 +5656,369 @@ TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_x509privatekey_fails_when_s
     IoTHubClient_LL_UploadToBlob_Destroy(h);
 }
 
+/*Tests_SRS_IOTHUBCLIENT_LL_09_011: [ OPTION_BLOB_UPLOAD_PARALLELISM - then the value is a pointer to a size_t with the number of blocks to upload concurrently, passed to Blob_UploadMultipleBlocksFromSasUri. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_parallelism_succeeds)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    size_t parallelUploads = 4;
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_PARALLELISM, &parallelUploads);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_012: [ If the value is 0 or greater than BLOB_MAX_PARALLEL_UPLOADS, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_parallelism_0_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    size_t parallelUploads = 0;
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_PARALLELISM, &parallelUploads);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_013: [ OPTION_BLOB_UPLOAD_CHECKPOINT_STORE - then the value is a pointer to an IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE which shall be copied, or NULL to stop saving checkpoints. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_checkpoint_store_succeeds)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE)));
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_013: [ OPTION_BLOB_UPLOAD_CHECKPOINT_STORE - then the value is a pointer to an IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE which shall be copied, or NULL to stop saving checkpoints. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_checkpoint_store_NULL_succeeds)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    (void)IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_027: [ If any function of the store is NULL, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_checkpoint_store_without_delete_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE store = TEST_CHECKPOINT_STORE_FUNCTIONS;
+    store.delete_checkpoint = NULL;
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &store);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_014: [ If copying the store fails, IoTHubClient_LL_UploadToBlob_SetOption shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadToBlob_SetOption_blob_upload_checkpoint_store_fails_when_malloc_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_X509);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(sizeof(IOTHUB_BLOB_UPLOAD_CHECKPOINT_STORE)))
+        .SetReturn(NULL);
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_015: [ If a checkpoint store is set, IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall have Blob_UploadMultipleBlocksFromSasUri save the number of blocks and bytes uploaded, and the fingerprint of those bytes, to it after every block. ]*/
+/*Tests_SRS_IOTHUBCLIENT_LL_09_017: [ The checkpoint shall be deleted when the blob is uploaded, when the upload is aborted, or when the data does not match the checkpoint (BLOB_INVALID_ARG); otherwise it is kept for the next upload. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadMultipleBlocksToBlob_saves_checkpoints_and_deletes_them_when_uploaded)
+{
+    ///arrange
+    unsigned char source[10] = { 0 };
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    (void)IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+    testCheckpointStore.loadResult = IOTHUB_BLOB_UPLOAD_CHECKPOINT_NOT_FOUND;
+    context.source = source;
+    context.size = sizeof(source);
+    context.toUpload = sizeof(source);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(h, "text.txt", FileUpload_GetData_Callback, &context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, testCheckpointStore.loadCount);
+    ASSERT_ARE_EQUAL(int, 1, testCheckpointStore.saveCount);
+    ASSERT_ARE_EQUAL(int, 1, (int)testCheckpointStore.savedBlockCount);
+    ASSERT_IS_TRUE(testCheckpointStore.savedContentHash == TEST_CONTENT_HASH);
+    ASSERT_ARE_EQUAL(int, 1, testCheckpointStore.deleteCount);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_016: [ If the checkpoint store loads a checkpoint of destinationFileName, and Blob_VerifyUncommittedBlocks confirms its blocks are still in storage, the upload shall resume after those blocks once Blob_UploadMultipleBlocksFromSasUri has checked that the data still has the fingerprint of the checkpoint. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadMultipleBlocksToBlob_resumes_with_the_fingerprint_of_the_checkpoint)
+{
+    ///arrange
+    unsigned char source[10] = { 0 };
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    (void)IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+    testCheckpointStore.loadResult = IOTHUB_BLOB_UPLOAD_CHECKPOINT_LOADED;
+    testCheckpointStore.loadedBlockCount = 1;
+    testCheckpointStore.loadedUploadedBytes = 10;
+    testCheckpointStore.loadedContentHash = TEST_CONTENT_HASH;
+    context.source = source;
+    context.size = sizeof(source);
+    context.toUpload = sizeof(source);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(h, "text.txt", FileUpload_GetData_Callback, &context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, (int)testBlobUpload.checkpointBlockCount);
+    ASSERT_IS_TRUE(testBlobUpload.checkpointContentHash == TEST_CONTENT_HASH);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_025: [ If the checkpoint store fails to load the checkpoint, nothing shall be uploaded, the checkpoint shall be kept and IoTHubClient_LL_UploadMultipleBlocksToBlob(Ex) shall fail as if Blob_UploadMultipleBlocksFromSasUri had failed. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadMultipleBlocksToBlob_keeps_the_checkpoint_when_it_cannot_be_loaded)
+{
+    ///arrange
+    unsigned char source[10] = { 0 };
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    (void)IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+    testCheckpointStore.loadResult = IOTHUB_BLOB_UPLOAD_CHECKPOINT_ERROR;
+    context.source = source;
+    context.size = sizeof(source);
+    context.toUpload = sizeof(source);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadMultipleBlocksToBlob_Impl(h, "text.txt", FileUpload_GetData_Callback, &context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(int, 0, testBlobUpload.callCount);
+    ASSERT_ARE_EQUAL(int, 0, testCheckpointStore.saveCount);
+    ASSERT_ARE_EQUAL(int, 0, testCheckpointStore.deleteCount);
+    ASSERT_ARE_EQUAL(int, (int)FILE_UPLOAD_ERROR, (int)context.lastResult);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_020: [ If `handle`, `destinationFileName` or `sourceFilePath` is `NULL` then `IoTHubClient_LL_UploadFileToBlob_Impl` shall fail and return `IOTHUB_CLIENT_INVALID_ARG`. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_with_NULL_source_path_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_021: [ If the file cannot be opened or its size cannot be obtained, `IoTHubClient_LL_UploadFileToBlob_Impl` shall fail and return `IOTHUB_CLIENT_ERROR`. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_fails_when_the_file_does_not_exist)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", "this/file/does/not/exist.txt");
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_uploads_a_short_file_in_one_block)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    create_test_source_file(100);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", TEST_SOURCE_FILE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, (int)testBlobUpload.blockCount);
+    ASSERT_ARE_EQUAL(size_t, 100, testBlobUpload.blockSizes[0]);
+    ASSERT_ARE_EQUAL(int, 0, (int)testReadBlock[0]);
+    ASSERT_ARE_EQUAL(int, 99, (int)testReadBlock[99]);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+    (void)remove(TEST_SOURCE_FILE);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_uploads_full_blocks_and_a_short_final_block)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    create_test_source_file(2 * BLOCK_SIZE + 100);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", TEST_SOURCE_FILE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(int, 3, (int)testBlobUpload.blockCount);
+    ASSERT_ARE_EQUAL(size_t, BLOCK_SIZE, testBlobUpload.blockSizes[0]);
+    ASSERT_ARE_EQUAL(size_t, BLOCK_SIZE, testBlobUpload.blockSizes[1]);
+    ASSERT_ARE_EQUAL(size_t, 100, testBlobUpload.blockSizes[2]);
+    /*the last block was read at offset 2 * BLOCK_SIZE*/
+    ASSERT_ARE_EQUAL(int, (int)((2 * BLOCK_SIZE) % 251), (int)testReadBlock[0]);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+    (void)remove(TEST_SOURCE_FILE);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_022: [ `IoTHubClient_LL_UploadFileToBlob_Impl` shall call `Blob_UploadMultipleBlocksFromReader`, which reads every block of the file directly into the buffer that is uploaded. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_uploads_a_multiple_of_BLOCK_SIZE_without_an_empty_block)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    create_test_source_file(2 * BLOCK_SIZE);
+    register_blob_upload_hooks();
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", TEST_SOURCE_FILE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, (int)testBlobUpload.blockCount);
+    ASSERT_ARE_EQUAL(size_t, BLOCK_SIZE, testBlobUpload.blockSizes[0]);
+    ASSERT_ARE_EQUAL(size_t, BLOCK_SIZE, testBlobUpload.blockSizes[1]);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+    (void)remove(TEST_SOURCE_FILE);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_023: [ If reading the file fails, or the file is shorter than when it was opened, the upload shall fail and `IoTHubClient_LL_UploadFileToBlob_Impl` shall return `IOTHUB_CLIENT_ERROR`. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_fails_when_the_file_is_truncated_while_uploading)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    create_test_source_file(100);
+    register_blob_upload_hooks();
+    testTruncateSourceFile = 1;
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", TEST_SOURCE_FILE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(int, 1, testBlobUpload.callCount);
+    ASSERT_ARE_EQUAL(int, 0, (int)testBlobUpload.blockCount);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+    (void)remove(TEST_SOURCE_FILE);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_LL_09_026: [ The checkpoint shall be kept when reading the source file fails. ]*/
+TEST_FUNCTION(IoTHubClient_LL_UploadFileToBlob_Impl_keeps_the_checkpoint_when_reading_the_file_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_LL_UPLOADTOBLOB_HANDLE h = IoTHubClient_LL_UploadToBlob_Create(&TEST_CONFIG_SAS);
+    (void)IoTHubClient_LL_UploadToBlob_SetOption(h, OPTION_BLOB_UPLOAD_CHECKPOINT_STORE, &TEST_CHECKPOINT_STORE_FUNCTIONS);
+    testCheckpointStore.loadResult = IOTHUB_BLOB_UPLOAD_CHECKPOINT_NOT_FOUND;
+    create_test_source_file(100);
+    register_blob_upload_hooks();
+    testTruncateSourceFile = 1;
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_LL_UploadFileToBlob_Impl(h, "text.txt", TEST_SOURCE_FILE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(int, 1, testBlobUpload.callCount);
+    ASSERT_ARE_EQUAL(int, 0, testCheckpointStore.deleteCount);
+
+    ///cleanup
+    IoTHubClient_LL_UploadToBlob_Destroy(h);
+    (void)remove(TEST_SOURCE_FILE);
+}
+
 END_TEST_SUITE(iothubclient_ll_uploadtoblob_ut)
 #endif /*DONT_USE_UPLOADTOBLOB*/
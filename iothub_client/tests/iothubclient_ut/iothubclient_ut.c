@@ -466,6 +466,8 @@ TEST_SUITE_INITIALIZE(suite_init)
 #ifndef DONT_USE_UPLOADTOBLOB
     REGISTER_GLOBAL_MOCK_RETURN(IoTHubClient_LL_UploadToBlob, IOTHUB_CLIENT_OK);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(IoTHubClient_LL_UploadToBlob, IOTHUB_CLIENT_ERROR);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubClient_LL_UploadFileToBlob, IOTHUB_CLIENT_OK);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(IoTHubClient_LL_UploadFileToBlob, IOTHUB_CLIENT_ERROR);
 #endif
     REGISTER_GLOBAL_MOCK_RETURN(IoTHubClient_LL_GetRetryPolicy, IOTHUB_CLIENT_OK);
     REGISTER_GLOBAL_MOCK_HOOK(IoTHubClient_LL_Destroy, my_IoTHubClient_LL_Destroy);
@@ -670,6 +672,7 @@ static void setup_gargageCollection(void* saved_data, bool can_item_be_collected
         EXPECTED_CALL(free(IGNORED_PTR_ARG));
         EXPECTED_CALL(free(IGNORED_PTR_ARG));
         EXPECTED_CALL(free(IGNORED_PTR_ARG));
+        EXPECTED_CALL(free(IGNORED_PTR_ARG));
     }
     else
     {
@@ -2666,6 +2669,7 @@ static void set_expected_calls_for_freeUploadToBlobThreadInfo()
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 }
 
 static void set_expected_calls_for_allocateUploadToBlob()
@@ -2675,6 +2679,144 @@ static void set_expected_calls_for_allocateUploadToBlob()
     STRICT_EXPECTED_CALL(Lock_Init());
 }
 
+/*Tests_SRS_IOTHUBCLIENT_09_001: [ If iotHubClientHandle, destinationFileName or sourceFilePath is NULL then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_with_NULL_iotHubClientHandle_fails)
+{
+    ///arrange
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_UploadFileToBlobAsync(NULL, "someFileName.txt", "log.txt", test_file_upload_callback, (void*)1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_IOTHUBCLIENT_09_001: [ If iotHubClientHandle, destinationFileName or sourceFilePath is NULL then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_with_NULL_destinationFileName_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_HANDLE iothub_handle = IoTHubClient_Create(TEST_CLIENT_CONFIG);
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_UploadFileToBlobAsync(iothub_handle, NULL, "log.txt", test_file_upload_callback, (void*)1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_Destroy(iothub_handle);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_09_001: [ If iotHubClientHandle, destinationFileName or sourceFilePath is NULL then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_INVALID_ARG. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_with_NULL_sourceFilePath_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_HANDLE iothub_handle = IoTHubClient_Create(TEST_CLIENT_CONFIG);
+    umock_c_reset_all_calls();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_UploadFileToBlobAsync(iothub_handle, "someFileName.txt", NULL, test_file_upload_callback, (void*)1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_Destroy(iothub_handle);
+}
+
+static void IoTHubClient_UploadFileToBlobAsync_calls_the_callback_Impl(IOTHUB_CLIENT_RESULT llResult, IOTHUB_CLIENT_FILE_UPLOAD_RESULT uploadResult)
+{
+    ///arrange
+    IOTHUB_CLIENT_HANDLE iothub_handle = IoTHubClient_Create(TEST_CLIENT_CONFIG);
+    umock_c_reset_all_calls();
+
+    set_expected_calls_for_allocateUploadToBlob();
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "log.txt"))
+        .IgnoreArgument_destination();
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_add(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG));
+
+    /* thread uploading function */
+    STRICT_EXPECTED_CALL(IoTHubClient_LL_UploadFileToBlob(TEST_IOTHUB_CLIENT_HANDLE, "someFileName.txt", "log.txt"))
+        .SetReturn(llResult);
+    STRICT_EXPECTED_CALL(test_file_upload_callback(uploadResult, (void*)1));
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Exit(0));
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_UploadFileToBlobAsync(iothub_handle, "someFileName.txt", "log.txt", test_file_upload_callback, (void*)1);
+    g_thread_func(g_thread_func_arg); /*this is the thread uploading function*/
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG));
+
+    EXPECTED_CALL(ThreadAPI_Join(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
+    EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_SLL_HANDLE))
+        .SetReturn(TEST_LIST_HANDLE);
+
+    setup_gargageCollection(my_malloc_items[2], true);
+    setup_IothubClient_Destroy_after_garbage_collection();
+
+    IoTHubClient_Destroy(iothub_handle);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_09_002: [ IoTHubClient_UploadFileToBlobAsync shall copy the destinationFileName, sourceFilePath, iotHubClientFileUploadCallback and context into a structure. ]*/
+/*Tests_SRS_IOTHUBCLIENT_09_003: [ IoTHubClient_UploadFileToBlobAsync shall add the structure to the list of structures that need to be cleaned once file upload finishes and spawn a thread passing the structure as thread data. ]*/
+/*Tests_SRS_IOTHUBCLIENT_09_005: [ The thread shall call IoTHubClient_LL_UploadFileToBlob passing the destinationFileName and the sourceFilePath packed in the structure. ]*/
+/*Tests_SRS_IOTHUBCLIENT_09_007: [ Otherwise the thread shall call iotHubClientFileUploadCallback passing as result FILE_UPLOAD_OK and the context. ]*/
+/*Tests_SRS_IOTHUBCLIENT_09_008: [ The thread shall mark itself as disposable. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_succeeds)
+{
+    IoTHubClient_UploadFileToBlobAsync_calls_the_callback_Impl(IOTHUB_CLIENT_OK, FILE_UPLOAD_OK);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_09_006: [ If IoTHubClient_LL_UploadFileToBlob fails then the thread shall call iotHubClientFileUploadCallback passing as result FILE_UPLOAD_ERROR and the context. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_calls_the_callback_with_FILE_UPLOAD_ERROR_when_the_upload_fails)
+{
+    IoTHubClient_UploadFileToBlobAsync_calls_the_callback_Impl(IOTHUB_CLIENT_ERROR, FILE_UPLOAD_ERROR);
+}
+
+/*Tests_SRS_IOTHUBCLIENT_09_004: [ If copying to the structure or spawning the thread fails, then IoTHubClient_UploadFileToBlobAsync shall fail and return IOTHUB_CLIENT_ERROR. ]*/
+TEST_FUNCTION(IoTHubClient_UploadFileToBlobAsync_fails_when_copying_sourceFilePath_fails)
+{
+    ///arrange
+    IOTHUB_CLIENT_HANDLE iothub_handle = IoTHubClient_Create(TEST_CLIENT_CONFIG);
+    umock_c_reset_all_calls();
+
+    set_expected_calls_for_allocateUploadToBlob();
+    STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "log.txt"))
+        .IgnoreArgument_destination()
+        .SetReturn(__FAILURE__);
+    set_expected_calls_for_freeUploadToBlobThreadInfo();
+
+    ///act
+    IOTHUB_CLIENT_RESULT result = IoTHubClient_UploadFileToBlobAsync(iothub_handle, "someFileName.txt", "log.txt", test_file_upload_callback, (void*)1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    IoTHubClient_Destroy(iothub_handle);
+}
+
 /*Tests_SRS_IOTHUBCLIENT_99_072: [ If `iotHubClientHandle` is `NULL` then `IoTHubClient_UploadMultipleBlocksToBlobAsync(Ex)` shall fail and return `IOTHUB_CLIENT_INVALID_ARG`. ]*/
 TEST_FUNCTION(IoTHubClient_UploadMultipleBlocksToBlobAsync_fails_when_handle_is_NULL)
 {
@@ -42,6 +42,7 @@ void real_free(void* ptr)
 #include "azure_c_shared_utility/strings.h"
 #include "azure_c_shared_utility/singlylinkedlist.h"
 #include "azure_c_shared_utility/uniqueid.h"
+#include "azure_c_shared_utility/buffer_.h"
 #include "azure_c_shared_utility/optionhandler.h"
 #include "azure_uamqp_c/link.h"
 #include "azure_uamqp_c/messaging.h"
@@ -53,6 +54,7 @@ void real_free(void* ptr)
 
 #undef ENABLE_MOCKS
 
+#include "iothub_client_options.h"
 #include "iothubtransport_amqp_telemetry_messenger.h"
 
 
@@ -143,6 +145,8 @@ static SINGLYLINKEDLIST_HANDLE TEST_IN_PROGRESS_LIST;
 #define TEST_IN_PROGRESS_LIST2                            (SINGLYLINKEDLIST_HANDLE)0x4484
 #define TEST_OPTIONHANDLER_HANDLE                         (OPTIONHANDLER_HANDLE)0x4485
 #define TEST_CALLBACK_LIST1                               (SINGLYLINKEDLIST_HANDLE)0x4486
+#define TEST_TICK_COUNTER_HANDLE                          (TICK_COUNTER_HANDLE)0x4487
+#define TEST_ENCODE_BUFFER_HANDLE                         (BUFFER_HANDLE)0x4488
 #define INDEFINITE_TIME                                   ((time_t)-1)
 
 static delivery_number TEST_DELIVERY_NUMBER;
@@ -282,9 +286,11 @@ static void TEST_on_state_changed_callback(void* context, TELEMETRY_MESSENGER_ST
 static LINK_HANDLE saved_messagesender_create_link;
 static ON_MESSAGE_SENDER_STATE_CHANGED saved_messagesender_create_on_message_sender_state_changed;
 static void* saved_messagesender_create_context;
+static void* saved_messagesender_create_previous_context;
 
 static MESSAGE_SENDER_HANDLE TEST_messagesender_create(LINK_HANDLE link, ON_MESSAGE_SENDER_STATE_CHANGED on_message_sender_state_changed, void* context)
 {
+    saved_messagesender_create_previous_context = saved_messagesender_create_context;
     saved_messagesender_create_link = link;
     saved_messagesender_create_on_message_sender_state_changed = on_message_sender_state_changed;
     saved_messagesender_create_context = context;
@@ -305,6 +311,14 @@ static MESSAGE_RECEIVER_HANDLE TEST_messagereceiver_create(LINK_HANDLE link, ON_
     return TEST_messagereceiver_create_result;
 }
 
+static uint32_t saved_link_set_max_link_credit;
+static int TEST_link_set_max_link_credit(LINK_HANDLE link, uint32_t max_link_credit)
+{
+    (void)link;
+    saved_link_set_max_link_credit = max_link_credit;
+    return 0;
+}
+
 
 static IOTHUB_MESSAGE_HANDLE saved_on_new_message_received_callback_message;
 static void* saved_on_new_message_received_callback_context;
@@ -446,10 +460,11 @@ static MESSENGER_DO_WORK_EXP_CALL_PROFILE* get_msgr_do_work_exp_call_profile(TEL
     return &g_do_work_profile;
 }
 
-static int TEST_message_create_uamqp_encoding_from_iothub_message(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BINARY_DATA* body_binary_data)
+static int TEST_message_create_uamqp_encoding_from_iothub_message_in_buffer(MESSAGE_HANDLE message_batch_container, IOTHUB_MESSAGE_HANDLE message_handle, BUFFER_HANDLE encode_buffer, BINARY_DATA* body_binary_data)
 {
     (void)message_batch_container;
     (void)message_handle;
+    (void)encode_buffer;
     (void)body_binary_data;
     return 0;
 }
@@ -486,6 +501,14 @@ static ASYNC_OPERATION_HANDLE TEST_messagesender_send_async(MESSAGE_SENDER_HANDL
 }
 
 
+static tickcounter_ms_t TEST_current_ms;
+static int TEST_tickcounter_get_current_ms(TICK_COUNTER_HANDLE tick_counter, tickcounter_ms_t* current_ms)
+{
+    (void)tick_counter;
+    *current_ms = TEST_current_ms;
+    return 0;
+}
+
 static bool TEST_singlylinkedlist_add_fail_return = false;
 static LIST_ITEM_HANDLE TEST_singlylinkedlist_add(SINGLYLINKEDLIST_HANDLE list, const void* item)
 {
@@ -766,6 +789,7 @@ static void set_expected_calls_for_telemetry_messenger_create(TELEMETRY_MESSENGE
     STRICT_EXPECTED_CALL(STRING_construct(config->iothub_host_fqdn)).SetReturn(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE);
     STRICT_EXPECTED_CALL(singlylinkedlist_create()).SetReturn(TEST_WAIT_TO_SEND_LIST);
     STRICT_EXPECTED_CALL(singlylinkedlist_create()).SetReturn(TEST_IN_PROGRESS_LIST);
+    STRICT_EXPECTED_CALL(BUFFER_new());
 }
 
 static void set_expected_calls_for_attach_device_client_type_to_link(LINK_HANDLE link_handle, int amqpvalue_set_map_value_result, int link_set_attach_properties_result)
@@ -1360,8 +1384,8 @@ static void set_expected_calls_for_message_do_work_send_pending_events(SEND_PEND
 
         TEST_amqp_data.length = test_config->test_events[i].number_bytes_encoded;
 
-        STRICT_EXPECTED_CALL(message_create_uamqp_encoding_from_iothub_message(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .CopyOutArgumentBuffer(3, &TEST_amqp_data, sizeof(TEST_amqp_data)).SetReturn(message_create_uamqp_encoding_from_iothub_message_return);
+        STRICT_EXPECTED_CALL(message_create_uamqp_encoding_from_iothub_message_in_buffer(IGNORED_PTR_ARG, IGNORED_PTR_ARG, TEST_ENCODE_BUFFER_HANDLE, IGNORED_PTR_ARG))
+            .CopyOutArgumentBuffer(4, &TEST_amqp_data, sizeof(TEST_amqp_data)).SetReturn(message_create_uamqp_encoding_from_iothub_message_return);
 
         if ((SEND_PENDING_EXPECT_ERROR_TOO_LARGE == expected_action) || (SEND_PENDING_EXPECT_CREATE_MESSAGE_FAILURE == expected_action))
         {
@@ -1506,6 +1530,7 @@ static void set_expected_calls_for_telemetry_messenger_destroy(TELEMETRY_MESSENG
     STRICT_EXPECTED_CALL(STRING_delete(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE));
     STRICT_EXPECTED_CALL(STRING_delete(TEST_DEVICE_ID_STRING_HANDLE));
     STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BUFFER_delete(TEST_ENCODE_BUFFER_HANDLE));
     STRICT_EXPECTED_CALL(free(messenger_handle));
 }
 
@@ -1688,6 +1713,8 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(TELEMETRY_MESSENGER_MESSAGE_DISPOSITION_INFO, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BINARY_DATA, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LIST_ACTION_FUNCTION, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TICK_COUNTER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
     type_size = sizeof(time_t);
     if (type_size == sizeof(uint64_t))
     {
@@ -1708,7 +1735,8 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(messagesender_send_async, TEST_messagesender_send_async);
     REGISTER_GLOBAL_MOCK_HOOK(messagereceiver_create, TEST_messagereceiver_create);
     REGISTER_GLOBAL_MOCK_HOOK(messagereceiver_open, TEST_messagereceiver_open);
-    REGISTER_GLOBAL_MOCK_HOOK(message_create_uamqp_encoding_from_iothub_message, TEST_message_create_uamqp_encoding_from_iothub_message);
+    REGISTER_GLOBAL_MOCK_HOOK(link_set_max_link_credit, TEST_link_set_max_link_credit);
+    REGISTER_GLOBAL_MOCK_HOOK(message_create_uamqp_encoding_from_iothub_message_in_buffer, TEST_message_create_uamqp_encoding_from_iothub_message_in_buffer);
     REGISTER_GLOBAL_MOCK_HOOK(message_create_IoTHubMessage_from_uamqp_message, TEST_message_create_IoTHubMessage_from_uamqp_message);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, TEST_singlylinkedlist_add);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, TEST_singlylinkedlist_get_head_item);
@@ -1719,6 +1747,13 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_foreach, TEST_singlylinkedlist_foreach);
     
     REGISTER_GLOBAL_MOCK_HOOK(messagereceiver_get_link_name, TEST_messagereceiver_get_link_name);
+    REGISTER_GLOBAL_MOCK_HOOK(tickcounter_get_current_ms, TEST_tickcounter_get_current_ms);
+
+    REGISTER_GLOBAL_MOCK_RETURN(tickcounter_create, TEST_TICK_COUNTER_HANDLE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(tickcounter_create, NULL);
+
+    REGISTER_GLOBAL_MOCK_RETURN(BUFFER_new, TEST_ENCODE_BUFFER_HANDLE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(BUFFER_new, NULL);
 
     REGISTER_GLOBAL_MOCK_RETURN(singlylinkedlist_remove, 0);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(singlylinkedlist_remove, 555);
@@ -1839,6 +1874,7 @@ static void reset_test_data()
     TEST_IN_PROGRESS_LIST = TEST_IN_PROGRESS_LIST1;
 
     TEST_singlylinkedlist_add_fail_return = false;
+    TEST_current_ms = 0;
     saved_wait_to_send_list_count = 0;
     saved_wait_to_send_list_count2 = 0;
     saved_in_progress_list_count = 0;
@@ -1848,6 +1884,7 @@ static void reset_test_data()
     saved_messagesender_create_link = NULL;
     saved_messagesender_create_on_message_sender_state_changed = NULL;
     saved_messagesender_create_context = NULL;
+    saved_messagesender_create_previous_context = NULL;
 
     saved_message_create_IoTHubMessage_from_uamqp_message_uamqp_message = NULL;
     TEST_message_create_IoTHubMessage_from_uamqp_message_return = 0;
@@ -1868,6 +1905,8 @@ static void reset_test_data()
     saved_messagereceiver_open_callback_context = NULL;
     TEST_messagereceiver_open_result = 0;
 
+    saved_link_set_max_link_credit = 0;
+
     saved_on_new_message_received_callback_message = NULL;
     saved_on_new_message_received_callback_context = NULL;
     TEST_on_new_message_received_callback_result = TELEMETRY_MESSENGER_DISPOSITION_RESULT_ACCEPTED;
@@ -2127,7 +2166,7 @@ TEST_FUNCTION(messenger_state_on_event_sender_state_changed_callback_OPEN)
     // act
     ASSERT_IS_NOT_NULL(saved_messagesender_create_on_message_sender_state_changed);
 
-    saved_messagesender_create_on_message_sender_state_changed((void*)handle, MESSAGE_SENDER_STATE_OPEN, MESSAGE_SENDER_STATE_IDLE);
+    saved_messagesender_create_on_message_sender_state_changed(saved_messagesender_create_context, MESSAGE_SENDER_STATE_OPEN, MESSAGE_SENDER_STATE_IDLE);
     crank_telemetry_messenger_do_work(handle, do_work_profile);
 
     // assert
@@ -2153,7 +2192,7 @@ TEST_FUNCTION(messenger_state_on_event_sender_state_changed_callback_ERROR)
     // act
     ASSERT_IS_NOT_NULL(saved_messagesender_create_on_message_sender_state_changed);
 
-    saved_messagesender_create_on_message_sender_state_changed((void*)handle, MESSAGE_SENDER_STATE_ERROR, MESSAGE_SENDER_STATE_IDLE);
+    saved_messagesender_create_on_message_sender_state_changed(saved_messagesender_create_context, MESSAGE_SENDER_STATE_ERROR, MESSAGE_SENDER_STATE_IDLE);
     crank_telemetry_messenger_do_work(handle, do_work_profile);
 
     // assert
@@ -3291,6 +3330,495 @@ TEST_FUNCTION(telemetry_messenger_set_option_OptionHandler_FeedOptions_fails)
     telemetry_messenger_destroy(handle);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_190: [If name matches TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, `value` shall be saved on `instance->event_batching`, creating a tickcounter if a linger time is set]
+TEST_FUNCTION(telemetry_messenger_set_option_EVENT_BATCHING)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_EVENT_BATCHING_OPTIONS value = { 100, 0, 0 };
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(tickcounter_create());
+
+    // act
+    int result = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_190: [If name matches TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, `value` shall be saved on `instance->event_batching`, creating a tickcounter if a linger time is set]
+TEST_FUNCTION(telemetry_messenger_set_option_EVENT_BATCHING_tickcounter_create_fails)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_EVENT_BATCHING_OPTIONS value = { 100, 0, 0 };
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(tickcounter_create()).SetReturn(NULL);
+
+    // act
+    int result = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, &value);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_191: [If the linger policy in TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING says events shall be held, telemetry_messenger_do_work() shall not send pending events]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_195: [Otherwise events shall be held until `linger_time_ms` has elapsed since the first of them was added]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_198: [If a linger time is set, the time the first event was queued since the last batch, and the number and size of queued events, shall be tracked]
+TEST_FUNCTION(telemetry_messenger_do_work_EVENT_BATCHING_linger_time)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_EVENT_BATCHING_OPTIONS value = { 1000, 0, 0 };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, &value));
+
+    TEST_current_ms = 5000;
+    umock_c_reset_all_calls();
+    set_expected_calls_for_telemetry_messenger_send_async();
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_send_async(handle, TEST_IOTHUB_MESSAGE_LIST_HANDLE, TEST_on_event_send_complete, TEST_IOTHUB_CLIENT_HANDLE));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    time_t current_time = time(NULL);
+
+    // act
+    TEST_current_ms = 5999;
+    umock_c_reset_all_calls();
+    set_expected_calls_for_process_event_send_timeouts(0, DEFAULT_EVENT_SEND_TIMEOUT_SECS, current_time);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // act
+    TEST_current_ms = 6000;
+    umock_c_reset_all_calls();
+    set_expected_calls_for_process_event_send_timeouts(0, DEFAULT_EVENT_SEND_TIMEOUT_SECS, current_time);
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_TICK_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    set_expected_calls_for_message_do_work_send_pending_events(&test_send_one_message_config, current_time);
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_193: [If `max_batch_message_count` is set and reached, events shall be sent immediately]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_197: [If `max_batch_message_count` is set and the batched message holds that many events, it shall be sent and a new batched message created for the remaining events]
+TEST_FUNCTION(telemetry_messenger_do_work_EVENT_BATCHING_max_batch_message_count)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_EVENT_BATCHING_OPTIONS value = { 60000, 0, 2 };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, &value));
+
+    ASSERT_ARE_EQUAL(int, 2, send_events(handle, 2));
+
+    time_t current_time = time(NULL);
+    uint64_t peer_max_message_size = 100 + AMQP_BATCHING_RESERVE_SIZE;
+    BINARY_DATA binary_data;
+    memset(&binary_data, 0, sizeof(binary_data));
+    TEST_amqp_data.length = 10;
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_process_event_send_timeouts(0, DEFAULT_EVENT_SEND_TIMEOUT_SECS, current_time);
+
+    for (int i = 0; i < 2; i++)
+    {
+        STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_WAIT_TO_SEND_LIST));
+        STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_WAIT_TO_SEND_LIST, IGNORED_PTR_ARG));
+
+        if (i == 0)
+        {
+            STRICT_EXPECTED_CALL(link_get_peer_max_message_size(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .CopyOutArgumentBuffer(2, &peer_max_message_size, sizeof(peer_max_message_size));
+            set_expected_calls_for_create_send_pending_events_state();
+        }
+
+        STRICT_EXPECTED_CALL(message_create_uamqp_encoding_from_iothub_message_in_buffer(IGNORED_PTR_ARG, IGNORED_PTR_ARG, TEST_ENCODE_BUFFER_HANDLE, IGNORED_PTR_ARG))
+            .CopyOutArgumentBuffer(4, &TEST_amqp_data, sizeof(TEST_amqp_data));
+        STRICT_EXPECTED_CALL(singlylinkedlist_add(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(message_add_body_amqp_data(IGNORED_PTR_ARG, binary_data));
+    }
+
+    set_expected_calls_for_send_batched_message_and_reset_state(current_time);
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_WAIT_TO_SEND_LIST));
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_203: [If `link_count` is zero or greater than MAX_EVENT_SENDER_LINK_COUNT, telemetry_messenger_set_option shall fail and return a non-zero value]
+TEST_FUNCTION(telemetry_messenger_set_option_EVENT_SENDER_LINKS_invalid_link_count)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS no_links = { 0, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, false };
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS too_many_links = { 9, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, false };
+
+    umock_c_reset_all_calls();
+
+    // act
+    int result1 = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &no_links);
+    int result2 = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &too_many_links);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_202: [If name matches TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, `value` shall be saved on `instance->event_sender_links`; `link_count` and `ordered_completion` take effect the next time the messenger starts]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_204: [`instance->event_sender_links.link_count` event sender links shall be created, each with its own message sender]
+TEST_FUNCTION(telemetry_messenger_do_work_EVENT_SENDER_LINKS_creates_all_links)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger(config);
+
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS value = { 2, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, false };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &value));
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_message_sender_create();
+    set_expected_calls_for_message_sender_create();
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_208: [If ordered completion is enabled, `task` shall only be completed once all tasks sent before it have completed or timed out]
+TEST_FUNCTION(telemetry_messenger_on_event_send_complete_EVENT_SENDER_LINKS_ordered_completion)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger(config);
+
+    size_t event_send_timeout_secs = 0;
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS value = { 1, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, true };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, &event_send_timeout_secs));
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &value));
+
+    time_t current_time = time(NULL);
+    MESSENGER_DO_WORK_EXP_CALL_PROFILE *do_work_profile = get_msgr_do_work_exp_call_profile(TELEMETRY_MESSENGER_STATE_STARTING, false, false, 0, 0, current_time, DEFAULT_EVENT_SEND_TIMEOUT_SECS);
+    do_work_profile->create_message_sender = true;
+    crank_telemetry_messenger_do_work(handle, do_work_profile);
+
+    void* first_send_context;
+    void* second_send_context;
+
+    ASSERT_ARE_EQUAL(int, 1, send_events(handle, 1));
+    umock_c_reset_all_calls();
+    set_expected_calls_for_message_do_work_send_pending_events(&test_send_one_message_config, current_time);
+    telemetry_messenger_do_work(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    first_send_context = saved_messagesender_send_callback_context;
+
+    ASSERT_ARE_EQUAL(int, 1, send_events(handle, 1));
+    umock_c_reset_all_calls();
+    set_expected_calls_for_message_do_work_send_pending_events(&test_send_one_message_config, current_time);
+    telemetry_messenger_do_work(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    second_send_context = saved_messagesender_send_callback_context;
+
+    ASSERT_ARE_NOT_EQUAL(void_ptr, first_send_context, second_send_context);
+
+    // act
+    saved_messagesender_send_on_message_send_complete(second_send_context, MESSAGE_SEND_OK);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, TEST_number_test_on_send_complete_data);
+
+    // act
+    saved_messagesender_send_on_message_send_complete(first_send_context, MESSAGE_SEND_ERROR);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 2, TEST_number_test_on_send_complete_data);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING, TEST_on_send_complete_data[0].result);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK, TEST_on_send_complete_data[1].result);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_208: [If ordered completion is enabled, `task` shall only be completed once all tasks sent before it have completed or timed out]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_221: [If ordered completion is enabled, the settled tasks sent after a timed out task shall be completed]
+TEST_FUNCTION(telemetry_messenger_do_work_EVENT_SENDER_LINKS_ordered_completion_head_times_out)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger(config);
+
+    size_t event_send_timeout_secs = 0;
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS value = { 1, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, true };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, &event_send_timeout_secs));
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &value));
+
+    time_t current_time = time(NULL);
+    MESSENGER_DO_WORK_EXP_CALL_PROFILE *do_work_profile = get_msgr_do_work_exp_call_profile(TELEMETRY_MESSENGER_STATE_STARTING, false, false, 0, 0, current_time, DEFAULT_EVENT_SEND_TIMEOUT_SECS);
+    do_work_profile->create_message_sender = true;
+    crank_telemetry_messenger_do_work(handle, do_work_profile);
+
+    void* first_send_context;
+    void* second_send_context;
+
+    ASSERT_ARE_EQUAL(int, 1, send_events(handle, 1));
+    umock_c_reset_all_calls();
+    set_expected_calls_for_message_do_work_send_pending_events(&test_send_one_message_config, current_time);
+    telemetry_messenger_do_work(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    first_send_context = saved_messagesender_send_callback_context;
+
+    ASSERT_ARE_EQUAL(int, 1, send_events(handle, 1));
+    umock_c_reset_all_calls();
+    set_expected_calls_for_message_do_work_send_pending_events(&test_send_one_message_config, current_time);
+    telemetry_messenger_do_work(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    second_send_context = saved_messagesender_send_callback_context;
+
+    saved_messagesender_send_on_message_send_complete(second_send_context, MESSAGE_SEND_OK);
+    ASSERT_ARE_EQUAL(int, 0, TEST_number_test_on_send_complete_data);
+
+    event_send_timeout_secs = 10;
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, &event_send_timeout_secs));
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(current_time + 20);
+    STRICT_EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(20.0);
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 2, TEST_number_test_on_send_complete_data);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_TIMEOUT, TEST_on_send_complete_data[0].result);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_OK, TEST_on_send_complete_data[1].result);
+
+    // act
+    saved_messagesender_send_on_message_send_complete(first_send_context, MESSAGE_SEND_OK);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 2, TEST_number_test_on_send_complete_data);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_222: [The maximum message size shall be the smallest peer maximum message size across all event sender links, since a batch may go out on any of them]
+TEST_FUNCTION(telemetry_messenger_do_work_EVENT_SENDER_LINKS_uses_smallest_peer_max_message_size)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger(config);
+
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS value = { 2, IOTHUB_EVENT_SENDER_DISPATCH_ROUND_ROBIN, false };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &value));
+
+    umock_c_reset_all_calls();
+    telemetry_messenger_do_work(handle);
+    saved_messagesender_create_on_message_sender_state_changed(saved_messagesender_create_previous_context, MESSAGE_SENDER_STATE_OPEN, MESSAGE_SENDER_STATE_IDLE);
+    saved_messagesender_create_on_message_sender_state_changed(saved_messagesender_create_context, MESSAGE_SENDER_STATE_OPEN, MESSAGE_SENDER_STATE_IDLE);
+    telemetry_messenger_do_work(handle);
+
+    ASSERT_ARE_EQUAL(int, 1, send_events(handle, 1));
+
+    uint64_t first_link_max_message_size = 1000 + AMQP_BATCHING_RESERVE_SIZE;
+    uint64_t second_link_max_message_size = 100 + AMQP_BATCHING_RESERVE_SIZE;
+    TEST_amqp_data.length = 500;
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(link_get_peer_max_message_size(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer(2, &first_link_max_message_size, sizeof(first_link_max_message_size));
+    STRICT_EXPECTED_CALL(link_get_peer_max_message_size(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer(2, &second_link_max_message_size, sizeof(second_link_max_message_size));
+    STRICT_EXPECTED_CALL(message_create_uamqp_encoding_from_iothub_message_in_buffer(IGNORED_PTR_ARG, IGNORED_PTR_ARG, TEST_ENCODE_BUFFER_HANDLE, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer(4, &TEST_amqp_data, sizeof(TEST_amqp_data));
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 1, TEST_number_test_on_send_complete_data);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_MESSENGER_EVENT_SEND_COMPLETE_RESULT_ERROR_FAIL_SENDING, TEST_on_send_complete_data[0].result);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_212: [If `min_credit` is zero, `initial_credit` is not between `min_credit` and `max_credit`, or `max_credit` is greater than UINT32_MAX, telemetry_messenger_set_option shall fail and return a non-zero value]
+TEST_FUNCTION(telemetry_messenger_set_option_C2D_PREFETCH_invalid_credit)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    IOTHUB_C2D_PREFETCH_OPTIONS zero_min_credit = { 1, 0, 8 };
+    IOTHUB_C2D_PREFETCH_OPTIONS initial_below_min = { 1, 2, 8 };
+    IOTHUB_C2D_PREFETCH_OPTIONS initial_above_max = { 16, 1, 8 };
+
+    umock_c_reset_all_calls();
+
+    // act
+    int result1 = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, &zero_min_credit);
+    int result2 = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, &initial_below_min);
+    int result3 = telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, &initial_above_max);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result2);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result3);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+static TELEMETRY_MESSENGER_HANDLE create_and_start_messenger_with_c2d_prefetch(IOTHUB_C2D_PREFETCH_OPTIONS* c2d_prefetch, time_t current_time)
+{
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, false);
+
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, c2d_prefetch));
+    (void)telemetry_messenger_subscribe_for_messages(handle, TEST_on_new_message_received_callback, TEST_ON_NEW_MESSAGE_RECEIVED_CB_CONTEXT);
+
+    MESSENGER_DO_WORK_EXP_CALL_PROFILE *do_work_profile = get_msgr_do_work_exp_call_profile(TELEMETRY_MESSENGER_STATE_STARTED, true, false, 0, 0, current_time, DEFAULT_EVENT_SEND_TIMEOUT_SECS);
+    do_work_profile->create_message_receiver = true;
+    crank_telemetry_messenger_do_work(handle, do_work_profile);
+
+    // The first do_work with the receiver open starts the first credit period.
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(current_time);
+    telemetry_messenger_do_work(handle);
+
+    return handle;
+}
+
+static void receive_messages(size_t count, TELEMETRY_MESSENGER_DISPOSITION_RESULT disposition_result)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        umock_c_reset_all_calls();
+        set_expected_calls_for_on_message_received_internal_callback(disposition_result);
+        (void)saved_messagereceiver_open_on_message_received(saved_messagereceiver_open_callback_context, TEST_MESSAGE_HANDLE);
+    }
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_211: [If name matches TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, `value` shall be saved on `instance->c2d_prefetch`; it takes effect the next time the message receiver is created]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_213: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set, `instance->receiver_link` credit shall be set to `initial_credit` using link_set_max_link_credit()]
+TEST_FUNCTION(telemetry_messenger_do_work_C2D_PREFETCH_sets_initial_link_credit)
+{
+    // arrange
+    IOTHUB_C2D_PREFETCH_OPTIONS c2d_prefetch = { 4, 1, 16 };
+
+    // act
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger_with_c2d_prefetch(&c2d_prefetch, time(NULL));
+
+    // assert
+    ASSERT_ARE_EQUAL(uint32_t, 4, saved_link_set_max_link_credit);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_215: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set and `instance->message_receiver` is open, its link credit shall be updated]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_216: [If the unsettled messages reach the current credit, the credit shall be halved, down to `min_credit`; otherwise if at least half the credit was received in the period, it shall be doubled, up to `max_credit`]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_217: [Each message received shall be counted towards the drain rate of the receiver link, and counted as unsettled if `instance->on_message_received_callback` returns TELEMETRY_MESSENGER_DISPOSITION_RESULT_NONE]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_219: [The receiver link credit shall be re-evaluated every RECEIVER_LINK_CREDIT_UPDATE_PERIOD_SECS]
+TEST_FUNCTION(telemetry_messenger_do_work_C2D_PREFETCH_grows_link_credit)
+{
+    // arrange
+    time_t current_time = time(NULL);
+    IOTHUB_C2D_PREFETCH_OPTIONS c2d_prefetch = { 4, 1, 6 };
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger_with_c2d_prefetch(&c2d_prefetch, current_time);
+
+    receive_messages(2, TELEMETRY_MESSENGER_DISPOSITION_RESULT_ACCEPTED);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(current_time + 1);
+    STRICT_EXPECTED_CALL(get_difftime(current_time + 1, current_time)).SetReturn(1.0);
+    STRICT_EXPECTED_CALL(link_set_max_link_credit(TEST_MESSAGE_RECEIVER_LINK_HANDLE, 6));
+    set_expected_calls_for_telemetry_messenger_do_work(get_msgr_do_work_exp_call_profile(TELEMETRY_MESSENGER_STATE_STARTED, true, true, 0, 0, current_time + 1, DEFAULT_EVENT_SEND_TIMEOUT_SECS));
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 6, saved_link_set_max_link_credit);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_216: [If the unsettled messages reach the current credit, the credit shall be halved, down to `min_credit`; otherwise if at least half the credit was received in the period, it shall be doubled, up to `max_credit`]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_217: [Each message received shall be counted towards the drain rate of the receiver link, and counted as unsettled if `instance->on_message_received_callback` returns TELEMETRY_MESSENGER_DISPOSITION_RESULT_NONE]
+TEST_FUNCTION(telemetry_messenger_do_work_C2D_PREFETCH_shrinks_link_credit_with_unsettled_messages)
+{
+    // arrange
+    time_t current_time = time(NULL);
+    IOTHUB_C2D_PREFETCH_OPTIONS c2d_prefetch = { 4, 1, 16 };
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger_with_c2d_prefetch(&c2d_prefetch, current_time);
+
+    receive_messages(4, TELEMETRY_MESSENGER_DISPOSITION_RESULT_NONE);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(current_time + 1);
+    STRICT_EXPECTED_CALL(get_difftime(current_time + 1, current_time)).SetReturn(1.0);
+    STRICT_EXPECTED_CALL(link_set_max_link_credit(TEST_MESSAGE_RECEIVER_LINK_HANDLE, 2));
+    set_expected_calls_for_telemetry_messenger_do_work(get_msgr_do_work_exp_call_profile(TELEMETRY_MESSENGER_STATE_STARTED, true, true, 0, 0, current_time + 1, DEFAULT_EVENT_SEND_TIMEOUT_SECS));
+
+    // act
+    telemetry_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, saved_link_set_max_link_credit);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_171: [If name does not match any supported option, authentication_set_option shall fail and return a non-zero value]
 TEST_FUNCTION(telemetry_messenger_set_option_name_not_supported)
 {
@@ -3498,6 +4026,10 @@ static void set_expected_calls_for_telemetry_messenger_retrieve_options()
 
     STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, IGNORED_PTR_ARG))
         .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
 }
 
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_173: [If `messenger_handle` is NULL, telemetry_messenger_retrieve_options shall fail and return NULL]
@@ -3539,6 +4071,89 @@ TEST_FUNCTION(telemetry_messenger_retrieve_options_succeeds)
     telemetry_messenger_destroy(handle);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_220: [TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING shall be added with the value of `instance->event_batching`]
+TEST_FUNCTION(telemetry_messenger_retrieve_options_saves_event_batching)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, true);
+    IOTHUB_EVENT_BATCHING_OPTIONS value = { 100, 2048, 10 };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, &value));
+
+    umock_c_reset_all_calls();
+    EXPECTED_CALL(OptionHandler_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, &value, sizeof(value));
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
+
+    // act
+    OPTIONHANDLER_HANDLE result = telemetry_messenger_retrieve_options(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_OPTIONHANDLER_HANDLE, result);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_223: [TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS shall be added with the value of `instance->event_sender_links`]
+TEST_FUNCTION(telemetry_messenger_retrieve_options_saves_event_sender_links)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, true);
+    IOTHUB_EVENT_SENDER_LINKS_OPTIONS value = { 3, IOTHUB_EVENT_SENDER_DISPATCH_LEAST_OUTSTANDING, true };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, &value));
+
+    umock_c_reset_all_calls();
+    EXPECTED_CALL(OptionHandler_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SEND_TIMEOUT_SECS, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_BATCHING, IGNORED_PTR_ARG))
+        .IgnoreArgument(3);
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_EVENT_SENDER_LINKS, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, &value, sizeof(value));
+
+    // act
+    OPTIONHANDLER_HANDLE result = telemetry_messenger_retrieve_options(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_OPTIONHANDLER_HANDLE, result);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_224: [If TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH is set, it shall be added with the value of `instance->c2d_prefetch`]
+TEST_FUNCTION(telemetry_messenger_retrieve_options_saves_c2d_prefetch)
+{
+    // arrange
+    TELEMETRY_MESSENGER_CONFIG* config = get_messenger_config();
+    TELEMETRY_MESSENGER_HANDLE handle = create_and_start_messenger2(config, true);
+    IOTHUB_C2D_PREFETCH_OPTIONS value = { 16, 4, 64 };
+    ASSERT_ARE_EQUAL(int, 0, telemetry_messenger_set_option(handle, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, &value));
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_telemetry_messenger_retrieve_options();
+    STRICT_EXPECTED_CALL(OptionHandler_AddOption(TEST_OPTIONHANDLER_HANDLE, TELEMETRY_MESSENGER_OPTION_C2D_PREFETCH, IGNORED_PTR_ARG))
+        .ValidateArgumentBuffer(3, &value, sizeof(value));
+
+    // act
+    OPTIONHANDLER_HANDLE result = telemetry_messenger_retrieve_options(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_OPTIONHANDLER_HANDLE, result);
+
+    // cleanup
+    telemetry_messenger_destroy(handle);
+}
+
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_175: [If an OPTIONHANDLER_HANDLE instance fails to be created, telemetry_messenger_retrieve_options shall fail and return NULL]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_177: [If OptionHandler_AddOption fails, telemetry_messenger_retrieve_options shall fail and return NULL]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_MESSENGER_09_178: [If telemetry_messenger_retrieve_options fails, any allocated memory shall be freed]
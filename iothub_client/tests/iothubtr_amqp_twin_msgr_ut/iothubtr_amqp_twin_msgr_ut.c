@@ -288,6 +288,23 @@ static time_t add_seconds(time_t base_time, int seconds)
     return new_time;
 }
 
+static size_t TEST_message_add_body_amqp_data_call_count;
+static char TEST_message_add_body_amqp_data_last_body[256];
+static int TEST_message_add_body_amqp_data(MESSAGE_HANDLE message, BINARY_DATA amqp_data)
+{
+    size_t length = (amqp_data.length < sizeof(TEST_message_add_body_amqp_data_last_body) - 1 ? amqp_data.length : sizeof(TEST_message_add_body_amqp_data_last_body) - 1);
+    (void)message;
+
+    if (amqp_data.bytes != NULL)
+    {
+        (void)memcpy(TEST_message_add_body_amqp_data_last_body, amqp_data.bytes, length);
+    }
+    TEST_message_add_body_amqp_data_last_body[length] = '\0';
+    TEST_message_add_body_amqp_data_call_count++;
+
+    return 0;
+}
+
 // ---------- Callbacks ---------- //
 
 static void* TEST_on_state_changed_callback_context;
@@ -658,6 +675,17 @@ static void send_one_report_patch(TWIN_MESSENGER_HANDLE handle, time_t current_t
     real_CONSTBUFFER_Destroy(report);
 }
 
+static void send_report_patch(TWIN_MESSENGER_HANDLE handle, const char* json, time_t current_time)
+{
+    CONSTBUFFER_HANDLE report = real_CONSTBUFFER_Create((const unsigned char*)json, strlen(json));
+
+    umock_c_reset_all_calls();
+    set_twin_messenger_report_state_async_expected_calls(report, current_time);
+    (void)twin_messenger_report_state_async(handle, report, TEST_on_report_state_complete_callback, NULL);
+
+    real_CONSTBUFFER_Destroy(report);
+}
+
 static void crank_twin_messenger_do_work(TWIN_MESSENGER_HANDLE handle, TWIN_MESSENGER_CONFIG* config, DOWORK_TEST_PROFILE* dwtp)
 {
     (void)config;
@@ -699,6 +727,8 @@ static void register_global_mock_hooks()
     REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_Clone, real_CONSTBUFFER_Clone);
     REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_Destroy, real_CONSTBUFFER_Destroy);
     REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_GetContent, real_CONSTBUFFER_GetContent);
+    REGISTER_GLOBAL_MOCK_HOOK(CONSTBUFFER_Create, real_CONSTBUFFER_Create);
+    REGISTER_GLOBAL_MOCK_HOOK(message_add_body_amqp_data, TEST_message_add_body_amqp_data);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_create, real_singlylinkedlist_create);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_destroy, real_singlylinkedlist_destroy);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_add, real_singlylinkedlist_add);
@@ -863,6 +893,9 @@ static void reset_test_data()
     TEST_CONSTBUFFER.size = TWIN_REPORTED_PROPERTIES_LENGTH;
 
     TEST_on_state_changed_callback_context = NULL;
+
+    TEST_message_add_body_amqp_data_call_count = 0;
+    TEST_message_add_body_amqp_data_last_body[0] = '\0';
 }
 
 BEGIN_TEST_SUITE(iothubtr_amqp_twin_msgr_ut)
@@ -1590,5 +1623,141 @@ TEST_FUNCTION(twin_msgr_do_work_started_with_EXPIRED_in_progress_patches_success
 
 // Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_082: [If any failure occurs while verifying/removing timed-out items `twin_msgr->state` shall be set to TWIN_MESSENGER_STATE_ERROR and user informed]  
 
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_109: [If `name` is TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, `value` shall be saved as the reported state coalescing window; values above 60 shall fail]
+TEST_FUNCTION(twin_msgr_set_option_reported_state_coalesce_secs_success)
+{
+    // arrange
+    TWIN_MESSENGER_CONFIG* config = get_twin_messenger_config();
+    TWIN_MESSENGER_HANDLE handle = create_twin_messenger(config);
+    size_t coalesce_secs = 10;
+
+    umock_c_reset_all_calls();
+
+    // act
+    int result = twin_messenger_set_option(handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    twin_messenger_destroy(handle);
+}
+
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_109: [If `name` is TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, `value` shall be saved as the reported state coalescing window; values above 60 shall fail]
+TEST_FUNCTION(twin_msgr_set_option_reported_state_coalesce_secs_too_large_fails)
+{
+    // arrange
+    TWIN_MESSENGER_CONFIG* config = get_twin_messenger_config();
+    TWIN_MESSENGER_HANDLE handle = create_twin_messenger(config);
+    size_t coalesce_secs = 61;
+
+    umock_c_reset_all_calls();
+
+    // act
+    int result = twin_messenger_set_option(handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    twin_messenger_destroy(handle);
+}
+
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_110: [If reported state coalescing is enabled, pending patches shall be held until the oldest one has been queued for at least `reported_state_coalesce_secs`]
+TEST_FUNCTION(twin_msgr_do_work_holds_patches_within_coalescing_window)
+{
+    // arrange
+    TWIN_MESSENGER_CONFIG* config = get_twin_messenger_config();
+    TWIN_MESSENGER_HANDLE handle = create_and_start_twin_messenger(config);
+    size_t coalesce_secs = 10;
+    (void)twin_messenger_set_option(handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    send_one_report_patch(handle, g_initial_time);
+    send_one_report_patch(handle, g_initial_time);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(g_initial_time);
+    STRICT_EXPECTED_CALL(get_difftime(g_initial_time, IGNORED_NUM_ARG)).SetReturn(5);
+    set_process_timeouts_expected_calls(g_initial_time, 2, 0, 0, 0);
+    STRICT_EXPECTED_CALL(amqp_messenger_do_work(TEST_AMQP_MESSENGER_HANDLE));
+
+    // act
+    twin_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(size_t, 0, TEST_message_add_body_amqp_data_call_count);
+
+    // cleanup
+    twin_messenger_destroy(handle);
+}
+
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_111: [The pending patches shall be merged in the order they were queued, later values replacing earlier ones for the same property path]
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_112: [The patches of each run shall be replaced in `twin_msgr->pending_patches` by a single merged patch, keeping the position of the first patch of the run]
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_113: [When a coalesced PATCH completes, the `on_report_state_complete_callback` of each original request shall be invoked with the same result, reason and status code, in the order the requests were made]
+TEST_FUNCTION(twin_msgr_do_work_coalesces_pending_patches)
+{
+    // arrange
+    TWIN_MESSENGER_CONFIG* config = get_twin_messenger_config();
+    TWIN_MESSENGER_HANDLE handle = create_and_start_twin_messenger(config);
+    size_t coalesce_secs = 10;
+    (void)twin_messenger_set_option(handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    send_report_patch(handle, "{\"a\":1,\"b\":{\"c\":1}}", g_initial_time);
+    send_report_patch(handle, "{\"b\":{\"d\":2},\"a\":3}", g_initial_time);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(g_initial_time_plus_30_secs);
+    STRICT_EXPECTED_CALL(get_difftime(g_initial_time_plus_30_secs, IGNORED_NUM_ARG)).SetReturn(30);
+
+    // act
+    twin_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_message_add_body_amqp_data_call_count);
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":3,\"b\":{\"c\":1,\"d\":2}}", TEST_message_add_body_amqp_data_last_body);
+
+    // cleanup
+    twin_messenger_destroy(handle);
+
+    ASSERT_ARE_EQUAL(size_t, 2, TEST_on_report_state_complete_callback_result_CANCELLED_count);
+    ASSERT_ARE_EQUAL(size_t, 2, TEST_on_report_state_complete_callback_reason_MESSENGER_DESTROYED_count);
+}
+
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_115: [A patch that sets a JSON object on a property an earlier pending patch set to null or to a non-object value shall not be merged, and shall start a new merged patch]
+// Tests_IOTHUBTRANSPORT_AMQP_TWIN_MESSENGER_09_112: [The patches of each run shall be replaced in `twin_msgr->pending_patches` by a single merged patch, keeping the position of the first patch of the run]
+TEST_FUNCTION(twin_msgr_do_work_does_not_coalesce_object_into_deleted_property)
+{
+    // arrange
+    TWIN_MESSENGER_CONFIG* config = get_twin_messenger_config();
+    TWIN_MESSENGER_HANDLE handle = create_and_start_twin_messenger(config);
+    size_t coalesce_secs = 10;
+    (void)twin_messenger_set_option(handle, TWIN_MESSENGER_OPTION_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    send_report_patch(handle, "{\"x\":1}", g_initial_time);
+    send_report_patch(handle, "{\"a\":null}", g_initial_time);
+    send_report_patch(handle, "{\"a\":{\"b\":1}}", g_initial_time);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(g_initial_time_plus_30_secs);
+    STRICT_EXPECTED_CALL(get_difftime(g_initial_time_plus_30_secs, IGNORED_NUM_ARG)).SetReturn(30);
+
+    // act
+    twin_messenger_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, TEST_message_add_body_amqp_data_call_count);
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":{\"b\":1}}", TEST_message_add_body_amqp_data_last_body);
+
+    // cleanup
+    twin_messenger_destroy(handle);
+
+    ASSERT_ARE_EQUAL(size_t, 3, TEST_on_report_state_complete_callback_result_CANCELLED_count);
+}
+
 
 END_TEST_SUITE(iothubtr_amqp_twin_msgr_ut)
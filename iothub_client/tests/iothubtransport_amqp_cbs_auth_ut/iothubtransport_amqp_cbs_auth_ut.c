@@ -81,6 +81,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define DEFAULT_CBS_REQUEST_TIMEOUT_SECS                  UINT32_MAX
 #define DEFAULT_SAS_TOKEN_LIFETIME_SECS                   3600
 #define DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS               1800
+#define SAS_TOKEN_REFRESH_SPREAD_DIVISOR                  4
 #define INDEFINITE_TIME                                   ((time_t)(-1))
 #define TEST_GENERIC_CHAR_PTR                             "generic char* string"
 #define TEST_DEVICE_ID                                    "my_device"
@@ -1179,6 +1180,7 @@ TEST_FUNCTION(authentication_do_work_SAS_TOKEN_next_calls_no_op)
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_023: [authentication_create() shall set `instance->sas_token_refresh_time_secs` with the default value of 30 minutes]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_065: [The SAS token shall be refreshed if the current time minus `instance->current_sas_token_put_time` equals or exceeds `instance->sas_token_refresh_time_secs`]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_066: [If SAS token does not need to be refreshed, authentication_do_work() shall return]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_129: [The SAS token refresh time shall be brought forward by an offset derived from `config->device_id_hash`, no greater than 25% of `instance->sas_token_refresh_time_secs`]
 TEST_FUNCTION(authentication_do_work_DEVICE_KEYS_sas_token_refresh_check)
 {
     // arrange
@@ -1186,7 +1188,7 @@ TEST_FUNCTION(authentication_do_work_DEVICE_KEYS_sas_token_refresh_check)
     AUTHENTICATION_HANDLE handle = create_and_start_authentication(config);
 
     time_t current_time = time(NULL);
-    time_t next_time = add_seconds(current_time, DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS - 1);
+    time_t next_time = add_seconds(current_time, DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS - DEFAULT_SAS_TOKEN_REFRESH_TIME_SECS / SAS_TOKEN_REFRESH_SPREAD_DIVISOR - 1);
     ASSERT_IS_TRUE_WITH_MSG(INDEFINITE_TIME != next_time, "failed to computer 'next_time'");
 
     AUTHENTICATION_DO_WORK_EXPECTED_STATE *exp_state = get_do_work_expected_state_struct();
@@ -1214,6 +1216,47 @@ TEST_FUNCTION(authentication_do_work_DEVICE_KEYS_sas_token_refresh_check)
     authentication_destroy(handle);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_129: [The SAS token refresh time shall be brought forward by an offset derived from `config->device_id_hash`, no greater than 25% of `instance->sas_token_refresh_time_secs`]
+TEST_FUNCTION(authentication_do_work_DEVICE_KEYS_sas_token_refresh_brought_forward_by_device_id_hash)
+{
+    // arrange
+    AUTHENTICATION_CONFIG* config = get_auth_config(USE_DEVICE_KEYS);
+    config->device_id_hash = 25;
+    AUTHENTICATION_HANDLE handle = create_and_start_authentication(config);
+
+    time_t current_time = time(NULL);
+    time_t next_time = add_seconds(current_time, 80);
+    ASSERT_IS_TRUE_WITH_MSG(INDEFINITE_TIME != next_time, "failed to computer 'next_time'");
+
+    size_t refresh_time_secs = 100;
+    ASSERT_ARE_EQUAL(int, 0, authentication_set_option(handle, AUTHENTICATION_OPTION_SAS_TOKEN_REFRESH_TIME_SECS, &refresh_time_secs));
+
+    AUTHENTICATION_DO_WORK_EXPECTED_STATE *exp_state = get_do_work_expected_state_struct();
+    exp_state->current_state = AUTHENTICATION_STATE_STARTING;
+    exp_state->sas_token_to_use = TEST_PRIMARY_DEVICE_KEY_STRING_HANDLE;
+    exp_state->sastoken_expiration_time = (size_t)(difftime(current_time, (time_t)0) + DEFAULT_SAS_TOKEN_LIFETIME_SECS);
+
+    crank_authentication_do_work(config, handle, current_time, exp_state);
+    saved_cbs_put_token_on_operation_complete(saved_cbs_put_token_context, CBS_OPERATION_RESULT_OK, 0, "all good");
+    saved_cbs_put_token_context = NULL;
+
+    // The spread window is 100 / 4 = 25 secs, so a hash of 25 refreshes at 75 secs instead of 100.
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(IoTHubClient_Auth_Get_Credential_Type(IGNORED_PTR_ARG)).SetReturn(IOTHUB_CREDENTIAL_TYPE_DEVICE_KEY);
+    STRICT_EXPECTED_CALL(get_time(NULL)).SetReturn(next_time);
+    STRICT_EXPECTED_CALL(get_difftime(next_time, current_time)).SetReturn(80.0);
+    set_expected_calls_for_create_and_put_sas_token(handle, next_time, exp_state);
+
+    // act
+    authentication_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, handle, saved_cbs_put_token_context);
+
+    // cleanup
+    authentication_destroy(handle);
+}
+
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_067: [authentication_do_work() shall create a SAS token using `instance->device_primary_key`, unless it has failed previously]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_071: [A STRING_HANDLE, referred to as `devices_path`, shall be created from the following parts: iothub_host_fqdn + "/devices/" + device_id]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_117: [An empty STRING_HANDLE, referred to as `sasTokenKeyName`, shall be created using STRING_new()]
@@ -1351,6 +1394,131 @@ TEST_FUNCTION(authentication_do_work_first_auth_times_out)
     authentication_destroy(handle);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_135: [If `max_put_tokens_in_progress` is zero, authentication_put_token_queue_create() shall fail and return NULL]
+TEST_FUNCTION(authentication_put_token_queue_create_zero_max_put_tokens_fails)
+{
+    // arrange
+    umock_c_reset_all_calls();
+
+    // act
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue = authentication_put_token_queue_create(0);
+
+    // assert
+    ASSERT_IS_NULL(put_token_queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_130: [If `config->put_token_queue` is not NULL, authentication_do_work() shall add the instance to the end of the queue instead of putting the SAS token to CBS]
+TEST_FUNCTION(authentication_do_work_with_put_token_queue_queues_put_token)
+{
+    // arrange
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue = authentication_put_token_queue_create(1);
+    ASSERT_IS_NOT_NULL(put_token_queue);
+
+    AUTHENTICATION_CONFIG* config = get_auth_config(USE_DEVICE_KEYS);
+    config->put_token_queue = put_token_queue;
+    AUTHENTICATION_HANDLE handle = create_and_start_authentication(config);
+
+    umock_c_reset_all_calls();
+
+    // act
+    authentication_do_work(handle);
+    authentication_do_work(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(saved_cbs_put_token_context);
+    ASSERT_ARE_EQUAL(int, AUTHENTICATION_STATE_STARTING, saved_on_state_changed_callback_new_state);
+
+    // cleanup
+    authentication_destroy(handle);
+    authentication_put_token_queue_destroy(put_token_queue);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_131: [authentication_put_token_queue_do_work() shall put the SAS tokens of the queued instances to CBS in the order they were queued, while fewer than `max_put_tokens_in_progress` put-tokens are in progress]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_133: [When the put-token completes or times out, the instance shall give back its place among the put-tokens in progress of `config->put_token_queue`]
+TEST_FUNCTION(authentication_put_token_queue_do_work_bounds_put_tokens_in_progress)
+{
+    // arrange
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue = authentication_put_token_queue_create(1);
+    ASSERT_IS_NOT_NULL(put_token_queue);
+
+    AUTHENTICATION_CONFIG* config = get_auth_config(USE_DEVICE_KEYS);
+    config->put_token_queue = put_token_queue;
+    AUTHENTICATION_HANDLE handle1 = create_and_start_authentication(config);
+    AUTHENTICATION_HANDLE handle2 = create_and_start_authentication(config);
+
+    time_t current_time = time(NULL);
+
+    AUTHENTICATION_DO_WORK_EXPECTED_STATE *exp_state = get_do_work_expected_state_struct();
+    exp_state->current_state = AUTHENTICATION_STATE_STARTING;
+
+    authentication_do_work(handle1);
+    authentication_do_work(handle2);
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_authentication_do_work(config, handle1, current_time, exp_state);
+
+    // act
+    authentication_put_token_queue_do_work(put_token_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, handle1, saved_cbs_put_token_context);
+
+    // arrange
+    umock_c_reset_all_calls();
+    authentication_put_token_queue_do_work(put_token_queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    saved_cbs_put_token_on_operation_complete(saved_cbs_put_token_context, CBS_OPERATION_RESULT_OK, 0, "all good");
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_authentication_do_work(config, handle2, current_time, exp_state);
+
+    // act
+    authentication_put_token_queue_do_work(put_token_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, handle2, saved_cbs_put_token_context);
+
+    // cleanup
+    authentication_destroy(handle1);
+    authentication_destroy(handle2);
+    authentication_put_token_queue_destroy(put_token_queue);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_AUTH_09_134: [authentication_stop() shall remove the instance from `config->put_token_queue` and give back its place among the put-tokens in progress]
+TEST_FUNCTION(authentication_stop_removes_instance_from_put_token_queue)
+{
+    // arrange
+    AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue = authentication_put_token_queue_create(1);
+    ASSERT_IS_NOT_NULL(put_token_queue);
+
+    AUTHENTICATION_CONFIG* config = get_auth_config(USE_DEVICE_KEYS);
+    config->put_token_queue = put_token_queue;
+    AUTHENTICATION_HANDLE handle = create_and_start_authentication(config);
+
+    authentication_do_work(handle);
+    ASSERT_ARE_EQUAL(int, 0, authentication_stop(handle));
+
+    umock_c_reset_all_calls();
+
+    // act
+    authentication_put_token_queue_do_work(put_token_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(saved_cbs_put_token_context);
+
+    // cleanup
+    authentication_destroy(handle);
+    authentication_put_token_queue_destroy(put_token_queue);
+}
+
 // Tests_SRSIOTHUBTRANSPORT_AMQP_AUTH_09_097: [If `authentication_handle` or `name` or `value` is NULL, authentication_set_option shall fail and return a non-zero value]
 TEST_FUNCTION(authentication_set_option_NULL_handle)
 {
@@ -6,12 +6,14 @@
 #include <cstdlib>
 #include <cstddef>
 #include <ctime>
+#include <cstring>
 #else
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <time.h>
+#include <string.h>
 #endif
 
 void* real_malloc(size_t size)
@@ -199,13 +201,6 @@ extern "C"
         return item_found == 1 ? 0 : 1;
     }
 
-    static LIST_ITEM_HANDLE TEST_singlylinkedlist_find(SINGLYLINKEDLIST_HANDLE list, LIST_MATCH_FUNCTION match_function, const void* match_context)
-    {
-        (void)list;
-        (void)match_function;
-        return (LIST_ITEM_HANDLE)match_context;
-    }
-
     static SINGLYLINKEDLIST_HANDLE TEST_singlylinkedlist_foreach_list;
     static LIST_ACTION_FUNCTION TEST_singlylinkedlist_foreach_action_function;
     static const void* TEST_singlylinkedlist_foreach_context;
@@ -357,6 +352,8 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define TEST_DEVICE_ID_CHAR_PTR                    "deviceid"
 #define TEST_PRODUCT_INFO_CHAR_PTR                 "product info"
 #define TEST_DEVICE_ID_2_CHAR_PTR                  "deviceid2"
+#define TEST_UNREGISTERED_DEVICE_ID_CHAR_PTR       "unregistereddeviceid"
+#define TEST_IDLE_DEVICE_DO_WORK_INTERVAL_SECS     1
 #define TEST_DEVICE_KEY                            "devicekey"
 #define TEST_DEVICE_SAS_TOKEN                      "deviceSas"
 #define TEST_IOT_HUB_NAME                          "servername"
@@ -371,6 +368,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define TEST_USER_REMOTE_IDLE_TIMEOUT_RATIO        0.875
 #define DEFAULT_RETRY_POLICY                      IOTHUB_CLIENT_RETRY_EXPONENTIAL_BACKOFF_WITH_JITTER
 #define DEFAULT_MAX_RETRY_TIME_IN_SECS            0
+#define MAX_CBS_PUT_TOKENS_IN_PROGRESS            16
 
 #define TEST_STRING_HANDLE                         (STRING_HANDLE)0x4240
 #define TEST_IOTHUBTRANSPORTAMQP_METHODS           ((IOTHUBTRANSPORT_AMQP_METHODS_HANDLE)0x4244)
@@ -407,6 +405,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define TEST_X509_PRIVATE_KEY                      "Raphael Rabello"
 #define TEST_MESSAGE_SOURCE_CHAR_PTR               "messagereceiver_link_name"
 #define TEST_RETRY_CONTROL_HANDLE                  (RETRY_CONTROL_HANDLE)0x4276
+#define TEST_PUT_TOKEN_QUEUE_HANDLE                (AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE)0x4277
 
 
 static const unsigned char* TEST_DEVICE_METHOD_RESPONSE = (const unsigned char*)0x62;
@@ -442,6 +441,8 @@ static void set_expected_calls_for_Create(IOTHUBTRANSPORT_CONFIG* transport_conf
 
     STRICT_EXPECTED_CALL(singlylinkedlist_create())
         .SetReturn(TEST_REGISTERED_DEVICES_LIST);
+
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_create(MAX_CBS_PUT_TOKENS_IN_PROGRESS));
 }
 
 static void set_expected_calls_for_GetSendStatus(DEVICE_SEND_STATUS send_status)
@@ -457,16 +458,6 @@ static void set_expected_calls_for_GetHostname()
     STRICT_EXPECTED_CALL(STRING_clone(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE)).SetReturn(TEST_IOTHUB_HOST_FQDN_CLONE_STRING_HANDLE);
 }
 
-static void set_expected_calls_for_is_device_registered_ex(IOTHUB_DEVICE_CONFIG* device_config, IOTHUB_DEVICE_HANDLE registered_device)
-{
-    (void)device_config;
-
-    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-        .IgnoreArgument(2)
-        .IgnoreArgument(3)
-        .SetReturn((LIST_ITEM_HANDLE)registered_device);
-}
-
 static MESSAGE_DISPOSITION_CONTEXT* TRANSPORT_CONTEXT_DATA_create2(IOTHUB_DEVICE_HANDLE device_handle)
 {
     MESSAGE_DISPOSITION_CONTEXT* result = (MESSAGE_DISPOSITION_CONTEXT*)malloc(sizeof(MESSAGE_DISPOSITION_CONTEXT));
@@ -527,20 +518,18 @@ static void set_expected_calls_for_SendMessageDisposition(IOTHUBMESSAGE_DISPOSIT
 }
 
 // @param registered_device
-//     provide the handle to the registered device if the expected call is supposed to return an item, 
+//     provide the handle to the registered device if it is supposed to be found in the transport device index, 
 //     or NULL if the intent is to return "not registered".
 static void set_expected_calls_for_is_device_registered(IOTHUB_DEVICE_CONFIG* device_config, IOTHUB_DEVICE_HANDLE registered_device)
 {
-    STRICT_EXPECTED_CALL(STRING_c_str(TEST_DEVICE_ID_STRING_HANDLE))
-        .SetReturn(TEST_DEVICE_ID_CHAR_PTR);
+    (void)device_config;
 
-    set_expected_calls_for_is_device_registered_ex(device_config, registered_device);
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_DEVICE_ID_STRING_HANDLE))
+        .SetReturn(registered_device != NULL ? TEST_DEVICE_ID_CHAR_PTR : TEST_UNREGISTERED_DEVICE_ID_CHAR_PTR);
 }
 
 static void set_expected_calls_for_Register(IOTHUB_DEVICE_CONFIG* device_config, bool is_using_cbs)
 {
-    set_expected_calls_for_is_device_registered_ex(device_config, NULL);
-
     // is_device_credential_acceptable
     // Nothing to expect.
 
@@ -553,8 +542,6 @@ static void set_expected_calls_for_Register(IOTHUB_DEVICE_CONFIG* device_config,
     STRICT_EXPECTED_CALL(STRING_c_str(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE))
         .SetReturn(TEST_IOTHUB_HOST_FQDN_CHAR_PTR);
     EXPECTED_CALL(device_create(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_REGISTERED_DEVICES_LIST))
-        .SetReturn(NULL);
 
     STRICT_EXPECTED_CALL(STRING_c_str(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE)).SetReturn(TEST_IOTHUB_HOST_FQDN_CHAR_PTR);
     EXPECTED_CALL(iothubtransportamqp_methods_create(TEST_IOTHUB_HOST_FQDN_CHAR_PTR, device_config->deviceId));
@@ -583,13 +570,7 @@ static void set_expected_calls_for_Unregister(IOTHUB_DEVICE_HANDLE iothub_device
     STRICT_EXPECTED_CALL(STRING_c_str(TEST_DEVICE_ID_STRING_HANDLE))
         .SetReturn(TEST_DEVICE_ID_CHAR_PTR);
 
-    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-        .IgnoreArgument(2)
-        .IgnoreArgument(3)
-        .SetReturn((LIST_ITEM_HANDLE)iothub_device_handle);
-
-    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG))
-        .IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(singlylinkedlist_remove(TEST_REGISTERED_DEVICES_LIST, (LIST_ITEM_HANDLE)iothub_device_handle));
 
     STRICT_EXPECTED_CALL(iothubtransportamqp_methods_destroy(TEST_IOTHUBTRANSPORTAMQP_METHODS));
 
@@ -701,6 +682,9 @@ static void set_expected_calls_for_get_new_underlying_io_transport(bool feed_opt
     }
 }
 
+static time_t TEST_number_of_do_work_passes;
+static bool TEST_are_registered_devices_idle;
+
 static void set_expected_calls_for_DoWork2(PDLIST_ENTRY wts, int wts_length, DEVICE_STATE current_device_state, bool is_tls_io_acquired, bool feed_options, bool is_using_cbs, bool is_connection_created, bool is_connection_open, int number_of_registered_devices, time_t current_time, bool subscribe_for_methods)
 {
     STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_REGISTERED_DEVICES_LIST));
@@ -717,14 +701,35 @@ static void set_expected_calls_for_DoWork2(PDLIST_ENTRY wts, int wts_length, DEV
         is_connection_created = true;
     }
 
-    if (is_connection_open)
+    if (is_connection_open && number_of_registered_devices > 0)
     {
+        // Time is advanced on every pass, so idle devices are always due their periodic do_work.
+        STRICT_EXPECTED_CALL(get_time(NULL))
+            .SetReturn(current_time + (++TEST_number_of_do_work_passes) * TEST_IDLE_DEVICE_DO_WORK_INTERVAL_SECS);
+
+        if (TEST_are_registered_devices_idle)
+        {
+            // is_idle_device_do_work_due (devices idled on the same pass are compared once)
+            EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+        }
+
         int i;
         for (i = 0; i < number_of_registered_devices; i++)
         {
-            EXPECTED_CALL(singlylinkedlist_item_get_value(IGNORED_PTR_ARG));
             set_expected_calls_for_Device_DoWork(wts, wts_length, current_device_state, is_using_cbs, current_time, subscribe_for_methods);
-            EXPECTED_CALL(singlylinkedlist_get_next_item(IGNORED_PTR_ARG));
+
+            if (current_device_state == DEVICE_STATE_STARTED && wts_length == 0)
+            {
+                // is_device_idle
+                STRICT_EXPECTED_CALL(DList_IsListEmpty(wts));
+            }
+        }
+
+        TEST_are_registered_devices_idle = (current_device_state == DEVICE_STATE_STARTED && wts_length == 0);
+
+        if (is_using_cbs)
+        {
+            STRICT_EXPECTED_CALL(authentication_put_token_queue_do_work(TEST_PUT_TOKEN_QUEUE_HANDLE));
         }
     }
 
@@ -752,6 +757,7 @@ static void set_expected_calls_for_Destroy(int number_of_registered_devices, IOT
     }
     
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_REGISTERED_DEVICES_LIST));
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_destroy(TEST_PUT_TOKEN_QUEUE_HANDLE));
     STRICT_EXPECTED_CALL(amqp_connection_destroy(TEST_AMQP_CONNECTION_HANDLE));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_UNDERLYING_IO_TRANSPORT));
     STRICT_EXPECTED_CALL(retry_control_destroy(TEST_RETRY_CONTROL_HANDLE));
@@ -806,6 +812,9 @@ static void set_expected_calls_for_prepare_for_connection_retry(int number_of_re
 
     STRICT_EXPECTED_CALL(amqp_connection_destroy(TEST_AMQP_CONNECTION_HANDLE));
     STRICT_EXPECTED_CALL(xio_destroy(TEST_UNDERLYING_IO_TRANSPORT));
+
+    // prepare_device_for_connection_retry moves every device back to the ready list.
+    TEST_are_registered_devices_idle = false;
 }
 
 // ---------- Test Hooks ---------- //
@@ -843,6 +852,7 @@ static ON_AMQP_CONNECTION_STATE_CHANGED TEST_amqp_connection_create_saved_on_sta
 static const void* TEST_amqp_connection_create_saved_on_state_changed_context;
 static size_t TEST_amqp_connection_create_saved_c2d_keep_alive_freq_secs;
 static double TEST_amqp_connection_create_saved_cl2svc_keep_alive_send_ratio;
+static size_t TEST_amqp_connection_create_saved_session_count;
 static AMQP_CONNECTION_HANDLE TEST_amqp_connection_create_return;
 static AMQP_CONNECTION_HANDLE TEST_amqp_connection_create(AMQP_CONNECTION_CONFIG* config)
 {
@@ -852,10 +862,31 @@ static AMQP_CONNECTION_HANDLE TEST_amqp_connection_create(AMQP_CONNECTION_CONFIG
     TEST_amqp_connection_create_saved_on_state_changed_context = config->on_state_changed_context;
     TEST_amqp_connection_create_saved_c2d_keep_alive_freq_secs = config->svc2cl_keep_alive_timeout_secs;
     TEST_amqp_connection_create_saved_cl2svc_keep_alive_send_ratio = config->cl2svc_keep_alive_send_ratio;
+    TEST_amqp_connection_create_saved_session_count = config->session_count;
 
     return TEST_amqp_connection_create_return;
 }
 
+static size_t TEST_amqp_connection_get_session_handle_by_index_saved_session_index;
+static int TEST_amqp_connection_get_session_handle_by_index(AMQP_CONNECTION_HANDLE conn_handle, size_t session_index, SESSION_HANDLE* session_handle)
+{
+    (void)conn_handle;
+    TEST_amqp_connection_get_session_handle_by_index_saved_session_index = session_index;
+    *session_handle = TEST_SESSION_HANDLE;
+    return 0;
+}
+
+static size_t TEST_amqp_connection_reset_session_by_index_call_count;
+static size_t TEST_amqp_connection_reset_session_by_index_saved_session_index;
+static int TEST_amqp_connection_reset_session_by_index_return;
+static int TEST_amqp_connection_reset_session_by_index(AMQP_CONNECTION_HANDLE conn_handle, size_t session_index)
+{
+    (void)conn_handle;
+    TEST_amqp_connection_reset_session_by_index_call_count++;
+    TEST_amqp_connection_reset_session_by_index_saved_session_index = session_index;
+    return TEST_amqp_connection_reset_session_by_index_return;
+}
+
 static SESSION_HANDLE TEST_amqp_connection_get_session_handle_session_handle;
 static int TEST_amqp_connection_get_session_handle_return;
 static int TEST_amqp_connection_get_session_handle(AMQP_CONNECTION_HANDLE conn_handle, SESSION_HANDLE* session_handle)
@@ -891,6 +922,30 @@ static AMQP_DEVICE_HANDLE TEST_device_create(DEVICE_CONFIG* config)
     return TEST_device_create_return;
 }
 
+static size_t TEST_device_start_async_call_count;
+static int TEST_device_start_async(AMQP_DEVICE_HANDLE handle, SESSION_HANDLE session_handle, CBS_HANDLE cbs_handle)
+{
+    (void)handle;
+    (void)session_handle;
+    (void)cbs_handle;
+    TEST_device_start_async_call_count++;
+    return 0;
+}
+
+static size_t TEST_iothubtransportamqp_methods_unsubscribe_call_count;
+static void TEST_iothubtransportamqp_methods_unsubscribe(IOTHUBTRANSPORT_AMQP_METHODS_HANDLE iothubtransport_amqp_methods_handle)
+{
+    (void)iothubtransport_amqp_methods_handle;
+    TEST_iothubtransportamqp_methods_unsubscribe_call_count++;
+}
+
+static size_t TEST_authentication_put_token_queue_do_work_call_count;
+static void TEST_authentication_put_token_queue_do_work(AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE put_token_queue)
+{
+    (void)put_token_queue;
+    TEST_authentication_put_token_queue_do_work_call_count++;
+}
+
 static bool g_MessageCallback_return;
 bool TEST_IoTHubClient_LL_MessageCallback(IOTHUB_CLIENT_LL_HANDLE handle, MESSAGE_CALLBACK_INFO* messageData)
 {
@@ -1053,6 +1108,7 @@ static void register_umock_alias_types()
     REGISTER_UMOCK_ALIAS_TYPE(AMQP_TYPE, int);
     REGISTER_UMOCK_ALIAS_TYPE(AMQP_VALUE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(AUTHENTICATION_STATE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(AUTHENTICATION_PUT_TOKEN_QUEUE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BINARY_DATA, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(CBS_HANDLE, void*);
@@ -1121,7 +1177,6 @@ static void register_global_mock_hooks()
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_remove, TEST_singlylinkedlist_remove);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_head_item, TEST_singlylinkedlist_get_head_item);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_get_next_item, TEST_singlylinkedlist_get_next_item);
-    REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_find, TEST_singlylinkedlist_find);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_foreach, TEST_singlylinkedlist_foreach);
     REGISTER_GLOBAL_MOCK_HOOK(singlylinkedlist_item_get_value, TEST_singlylinkedlist_item_get_value);
 
@@ -1132,6 +1187,8 @@ static void register_global_mock_hooks()
 
     REGISTER_GLOBAL_MOCK_HOOK(amqp_connection_create, TEST_amqp_connection_create);
     REGISTER_GLOBAL_MOCK_HOOK(amqp_connection_get_session_handle, TEST_amqp_connection_get_session_handle);
+    REGISTER_GLOBAL_MOCK_HOOK(amqp_connection_get_session_handle_by_index, TEST_amqp_connection_get_session_handle_by_index);
+    REGISTER_GLOBAL_MOCK_HOOK(amqp_connection_reset_session_by_index, TEST_amqp_connection_reset_session_by_index);
     REGISTER_GLOBAL_MOCK_HOOK(amqp_connection_get_cbs_handle, TEST_amqp_connection_get_cbs_handle);
 
     REGISTER_GLOBAL_MOCK_HOOK(get_difftime, TEST_get_difftime);
@@ -1159,7 +1216,12 @@ static void register_global_mock_returns()
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(singlylinkedlist_create, NULL);
 
-    REGISTER_GLOBAL_MOCK_RETURN(device_start_async, 0);
+    REGISTER_GLOBAL_MOCK_HOOK(authentication_put_token_queue_do_work, TEST_authentication_put_token_queue_do_work);
+    REGISTER_GLOBAL_MOCK_RETURN(authentication_put_token_queue_create, TEST_PUT_TOKEN_QUEUE_HANDLE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(authentication_put_token_queue_create, NULL);
+
+    REGISTER_GLOBAL_MOCK_HOOK(device_start_async, TEST_device_start_async);
+    REGISTER_GLOBAL_MOCK_HOOK(iothubtransportamqp_methods_unsubscribe, TEST_iothubtransportamqp_methods_unsubscribe);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(device_start_async, 1);
 
     REGISTER_GLOBAL_MOCK_RETURN(device_stop, 0);
@@ -1210,6 +1272,12 @@ static void reset_test_data()
     TEST_device_create_saved_on_state_changed_callback = NULL;
     TEST_device_create_saved_on_state_changed_context = NULL;
     TEST_device_create_return = TEST_DEVICE_HANDLE;
+    TEST_device_start_async_call_count = 0;
+    TEST_authentication_put_token_queue_do_work_call_count = 0;
+    TEST_iothubtransportamqp_methods_unsubscribe_call_count = 0;
+    TEST_amqp_connection_reset_session_by_index_call_count = 0;
+    TEST_amqp_connection_reset_session_by_index_saved_session_index = 0;
+    TEST_amqp_connection_reset_session_by_index_return = 0;
 
     saved_registered_devices_list_count = 0;
 
@@ -1238,6 +1306,9 @@ static void initialize_test_variables()
     ASSERT_IS_TRUE_WITH_MSG(INDEFINITE_TIME != TEST_current_time, "Failed setting TEST_current_time");
 
     real_DList_InitializeListHead(&TEST_waitingToSend);
+
+    TEST_number_of_do_work_passes = 0;
+    TEST_are_registered_devices_idle = false;
 }
 
 
@@ -1555,6 +1626,8 @@ TEST_FUNCTION(on_methods_unsubscribed_re_subscribes)
     set_expected_calls_for_on_methods_unsubscribed();
     g_on_methods_unsubscribed(g_on_methods_unsubscribed_context);
 
+    // on_methods_unsubscribed moves the device back to the ready list.
+    TEST_are_registered_devices_idle = false;
     set_expected_calls_for_DoWork(&TEST_waitingToSend, 0, DEVICE_STATE_STARTED, true, true, true, true, 1, TEST_current_time, true /* here lies the difference */);
 
     // act
@@ -1969,6 +2042,7 @@ TEST_FUNCTION(GetHostName_success)
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_010: [`get_io_transport` shall be saved on `instance->underlying_io_transport_provider`]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_012: [If IoTHubTransport_AMQP_Common_Create succeeds it shall return a pointer to `instance`.]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_124: [`instance->connection_retry_control` shall be set using retry_control_create(), passing defaults EXPONENTIAL_BACKOFF_WITH_JITTER and 0]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_168: [`instance->put_token_queue` shall be set using authentication_put_token_queue_create(), allowing MAX_CBS_PUT_TOKENS_IN_PROGRESS put-tokens in progress]
 TEST_FUNCTION(Create_success)
 {
     // arrange
@@ -1995,6 +2069,7 @@ TEST_FUNCTION(Create_success)
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_009: [If singlylinkedlist_create() fails, IoTHubTransport_AMQP_Common_Create shall fail and return NULL]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_011: [If IoTHubTransport_AMQP_Common_Create fails it shall free any memory it allocated]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_125: [If retry_control_create() fails, IoTHubTransport_AMQP_Common_Create shall fail and return NULL]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_169: [If authentication_put_token_queue_create() fails, IoTHubTransport_AMQP_Common_Create shall fail and return NULL]
 TEST_FUNCTION(Create_failure_checks)
 {
     // arrange
@@ -2168,20 +2243,22 @@ TEST_FUNCTION(Register_device_already_registered)
     TRANSPORT_LL_HANDLE handle = create_transport();
 
     IOTHUB_DEVICE_CONFIG* device_config = create_device_config(TEST_DEVICE_ID_CHAR_PTR, true);
+    IOTHUB_DEVICE_HANDLE registered_device_handle = register_device(handle, device_config, &TEST_waitingToSend, true);
 
-    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG, device_config->deviceId))
-        .IgnoreArgument(2)
-        .SetReturn(TEST_LIST_ITEM_HANDLE);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(STRING_c_str(TEST_DEVICE_ID_STRING_HANDLE))
+        .SetReturn(TEST_DEVICE_ID_CHAR_PTR);
 
     // act
     IOTHUB_DEVICE_HANDLE device_handle = IoTHubTransport_AMQP_Common_Register(handle, device_config, TEST_IOTHUB_CLIENT_LL_HANDLE, &TEST_waitingToSend);
 
     // assert
+    ASSERT_IS_NOT_NULL(registered_device_handle);
     ASSERT_IS_NULL(device_handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
-    destroy_transport(handle, device_handle, NULL);
+    destroy_transport(handle, registered_device_handle, NULL);
 }
 
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_065: [IoTHubTransport_AMQP_Common_Register shall fail and return NULL if the device is not using an authentication mode compatible with the currently used by the transport.]
@@ -2200,10 +2277,6 @@ TEST_FUNCTION(Register_CBS_transport_X509_credentials)
 
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG, device_config2->deviceId))
-        .IgnoreArgument(2)
-        .SetReturn(NULL);
-
     // act
     IOTHUB_DEVICE_HANDLE device_handle2 = IoTHubTransport_AMQP_Common_Register(handle, device_config2, TEST_IOTHUB_CLIENT_LL_HANDLE, &TEST_waitingToSend);
 
@@ -2232,10 +2305,6 @@ TEST_FUNCTION(Register_X509_transport_CBS_credentials)
 
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(singlylinkedlist_find(TEST_REGISTERED_DEVICES_LIST, IGNORED_PTR_ARG, device_config2->deviceId))
-        .IgnoreArgument(2)
-        .SetReturn(NULL);
-
     // act
     IOTHUB_DEVICE_HANDLE device_handle2 = IoTHubTransport_AMQP_Common_Register(handle, device_config2, TEST_IOTHUB_CLIENT_LL_HANDLE, &TEST_waitingToSend);
 
@@ -2271,7 +2340,7 @@ TEST_FUNCTION(Register_failure_checks)
     size_t i, n = umock_c_negative_tests_call_count();
     for (i = 0; i < n; i++)
     {
-        if (i == 0 || i == 2 || i == 3 || i == 4 || i >= 6)
+        if (i == 1 || i == 2 || i == 3 || i >= 5)
         {
             // These expected calls do not cause the API to fail.
             continue;
@@ -3775,6 +3844,7 @@ TEST_FUNCTION(IoTHubTransport_AMQP_Common_Destroy_frees_proxy_options)
     set_expected_calls_for_Unregister(device_handle);
 
     STRICT_EXPECTED_CALL(singlylinkedlist_destroy(TEST_REGISTERED_DEVICES_LIST));
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_destroy(TEST_PUT_TOKEN_QUEUE_HANDLE));
     STRICT_EXPECTED_CALL(retry_control_destroy(TEST_RETRY_CONTROL_HANDLE));
     STRICT_EXPECTED_CALL(STRING_delete(TEST_IOTHUB_HOST_FQDN_STRING_HANDLE));
     STRICT_EXPECTED_CALL(free(IGNORED_PTR_ARG));
@@ -3817,8 +3887,7 @@ TEST_FUNCTION(Unregister_device_not_registered)
 
     umock_c_reset_all_calls();
     STRICT_EXPECTED_CALL(STRING_c_str(TEST_DEVICE_ID_STRING_HANDLE))
-        .SetReturn(TEST_DEVICE_ID_CHAR_PTR);
-    set_expected_calls_for_is_device_registered_ex(device_config, NULL);
+        .SetReturn(TEST_UNREGISTERED_DEVICE_ID_CHAR_PTR);
 
     // act
     IoTHubTransport_AMQP_Common_Unregister(device_handle);
@@ -4008,6 +4077,130 @@ TEST_FUNCTION(DoWork_success)
     destroy_transport(handle, device_handle, NULL);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_159: [Registered devices that are started and have no pending events, subscriptions or requests shall be moved to the transport idle list, and only processed again after IDLE_DEVICE_DO_WORK_INTERVAL_SECS or once a do_work is requested for them]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_173: [Idle registered devices processed IDLE_DEVICE_DO_WORK_INTERVAL_SECS or more ago shall be moved to the transport ready list]
+TEST_FUNCTION(DoWork_skips_idle_device_within_idle_interval)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    IOTHUB_DEVICE_CONFIG* device_config = create_device_config(TEST_DEVICE_ID_CHAR_PTR, true);
+    IOTHUB_DEVICE_HANDLE device_handle = register_device(handle, device_config, &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handle);
+
+    crank_transport_ready_after_create(handle, &TEST_waitingToSend, 0, false, true, 1, TEST_current_time, false);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_REGISTERED_DEVICES_LIST));
+    STRICT_EXPECTED_CALL(get_time(NULL))
+        .SetReturn(TEST_current_time + TEST_number_of_do_work_passes * TEST_IDLE_DEVICE_DO_WORK_INTERVAL_SECS);
+    EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_do_work(TEST_PUT_TOKEN_QUEUE_HANDLE));
+    STRICT_EXPECTED_CALL(amqp_connection_do_work(TEST_AMQP_CONNECTION_HANDLE));
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    destroy_transport(handle, device_handle, NULL);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_177: [IoTHubTransport_AMQP_Common_NotifyEventQueued shall request a device-specific do_work for the device, moving it to the transport ready list if it is idle]
+TEST_FUNCTION(DoWork_processes_idle_device_notified_of_queued_event_within_idle_interval)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    IOTHUB_DEVICE_CONFIG* device_config = create_device_config(TEST_DEVICE_ID_CHAR_PTR, true);
+    IOTHUB_DEVICE_HANDLE device_handle = register_device(handle, device_config, &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handle);
+
+    crank_transport_ready_after_create(handle, &TEST_waitingToSend, 0, false, true, 1, TEST_current_time, false);
+
+    umock_c_reset_all_calls();
+    IoTHubTransport_AMQP_Common_NotifyEventQueued(device_handle);
+
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_REGISTERED_DEVICES_LIST));
+    STRICT_EXPECTED_CALL(get_time(NULL))
+        .SetReturn(TEST_current_time + TEST_number_of_do_work_passes * TEST_IDLE_DEVICE_DO_WORK_INTERVAL_SECS);
+    set_expected_calls_for_Device_DoWork(&TEST_waitingToSend, 0, DEVICE_STATE_STARTED, true, TEST_current_time, false);
+    STRICT_EXPECTED_CALL(DList_IsListEmpty(&TEST_waitingToSend));
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_do_work(TEST_PUT_TOKEN_QUEUE_HANDLE));
+    STRICT_EXPECTED_CALL(amqp_connection_do_work(TEST_AMQP_CONNECTION_HANDLE));
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    destroy_transport(handle, device_handle, NULL);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_176: [If `handle` is NULL, IoTHubTransport_AMQP_Common_NotifyEventQueued shall return]
+TEST_FUNCTION(NotifyEventQueued_NULL_handle)
+{
+    // arrange
+    initialize_test_variables();
+    umock_c_reset_all_calls();
+
+    // act
+    IoTHubTransport_AMQP_Common_NotifyEventQueued(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_167: [Registered devices with a C2D or twin subscription change requested in the last `max_state_change_timeout_secs` shall not be considered idle]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_175: [Any other registered device processed shall be added back to the end of the transport ready list]
+TEST_FUNCTION(DoWork_processes_device_with_pending_subscription_change_within_idle_interval)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    IOTHUB_DEVICE_CONFIG* device_config = create_device_config(TEST_DEVICE_ID_CHAR_PTR, true);
+    IOTHUB_DEVICE_HANDLE device_handle = register_device(handle, device_config, &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handle);
+
+    crank_transport_ready_after_create(handle, &TEST_waitingToSend, 0, false, true, 1, TEST_current_time, false);
+
+    umock_c_reset_all_calls();
+    set_expected_calls_for_Subscribe(device_config, device_handle);
+    ASSERT_ARE_EQUAL(int, 0, IoTHubTransport_AMQP_Common_Subscribe(device_handle));
+
+    // The do_work requested by the subscription itself (which moved the device to the ready list); device_handle is still attaching the C2D link after it.
+    TEST_are_registered_devices_idle = false;
+    crank_transport(handle, &TEST_waitingToSend, 0, DEVICE_STATE_STARTED, true, true, true, true, 1, TEST_current_time, false);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(singlylinkedlist_get_head_item(TEST_REGISTERED_DEVICES_LIST));
+    STRICT_EXPECTED_CALL(get_time(NULL))
+        .SetReturn(TEST_current_time + TEST_number_of_do_work_passes * TEST_IDLE_DEVICE_DO_WORK_INTERVAL_SECS);
+    set_expected_calls_for_Device_DoWork(&TEST_waitingToSend, 0, DEVICE_STATE_STARTED, true, TEST_current_time, false);
+    STRICT_EXPECTED_CALL(DList_IsListEmpty(&TEST_waitingToSend));
+    EXPECTED_CALL(get_difftime(IGNORED_NUM_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(authentication_put_token_queue_do_work(TEST_PUT_TOKEN_QUEUE_HANDLE));
+    STRICT_EXPECTED_CALL(amqp_connection_do_work(TEST_AMQP_CONNECTION_HANDLE));
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    destroy_transport(handle, device_handle, NULL);
+}
+
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_115: [If the AMQP connection is closed by the service side, the connection retry logic shall be triggered]
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_126: [The connection retry shall be attempted only if retry_control_should_retry() returns RETRY_ACTION_NOW, or if it fails]
 TEST_FUNCTION(on_amqp_connection_state_changed_CLOSED_unexpectedly)
@@ -4220,6 +4413,232 @@ TEST_FUNCTION(DoWork_configures_AMQP_connection_using_cl2svc_keep_alive_send_rat
     destroy_transport(handle, device_handle, NULL);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_160: [`instance->amqp_session_count` shall be set into `AMQP_CONNECTION_CONFIG->session_count`]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_163: [If `option` is `amqp_session_count`, `value` shall be saved on `instance->amqp_session_count` and used from the next AMQP connection]
+TEST_FUNCTION(DoWork_configures_AMQP_connection_using_amqp_session_count)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    const char* certificate = TEST_X509_CERTIFICATE;
+    const char* private_key = TEST_X509_PRIVATE_KEY;
+    size_t session_count = 4;
+    (void)IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_X509_CERT, certificate);
+    (void)IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_X509_PRIVATE_KEY, private_key);
+    IOTHUB_CLIENT_RESULT result = IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &session_count);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, result);
+
+    IOTHUB_DEVICE_CONFIG* device_config = create_device_config_for_x509(TEST_DEVICE_ID_CHAR_PTR);
+    IOTHUB_DEVICE_HANDLE device_handle = register_device(handle, device_config, &TEST_waitingToSend, false);
+    ASSERT_IS_NOT_NULL(device_handle);
+
+    umock_c_reset_all_calls();
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 4, TEST_amqp_connection_create_saved_session_count);
+
+    // cleanup
+    destroy_transport(handle, device_handle, NULL);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_161: [If the AMQP connection was created with more than 1 session, the session of a registered device shall be obtained using amqp_connection_get_session_handle_by_index(), passing the hash of the device id modulo the number of sessions the connection was created with]
+TEST_FUNCTION(DoWork_device_session_uses_session_count_of_current_connection)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    size_t session_count = 4;
+    size_t new_session_count = 1;
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &session_count));
+
+    IOTHUB_DEVICE_CONFIG* device_config = create_device_config(TEST_DEVICE_ID_CHAR_PTR, true);
+    IOTHUB_DEVICE_HANDLE device_handle = register_device(handle, device_config, &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handle);
+
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    TEST_amqp_connection_create_saved_on_state_changed_callback(
+        TEST_amqp_connection_create_saved_on_state_changed_context,
+        AMQP_CONNECTION_STATE_CLOSED, AMQP_CONNECTION_STATE_OPENED);
+
+    // Only takes effect on the next AMQP connection.
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &new_session_count));
+
+    TEST_amqp_connection_get_session_handle_by_index_saved_session_index = session_count;
+
+    umock_c_reset_all_calls();
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_IS_TRUE(TEST_amqp_connection_get_session_handle_by_index_saved_session_index < session_count);
+
+    // cleanup
+    destroy_transport(handle, device_handle, NULL);
+}
+
+// Creates a transport with 2 AMQP sessions and registers "deviceid" (session 0) and "deviceid1" (session 1),
+// leaving "deviceid1" one DoWork pass away from its MAX_NUMBER_OF_DEVICE_FAILURES-th failure.
+static TRANSPORT_LL_HANDLE create_transport_with_failing_device_on_second_session(IOTHUB_DEVICE_HANDLE* device_handles)
+{
+    TRANSPORT_LL_HANDLE handle = create_transport();
+    size_t session_count = 2;
+    int i;
+
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_OK, IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &session_count));
+
+    device_handles[0] = register_device(handle, create_device_config(TEST_DEVICE_ID_CHAR_PTR, true), &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handles[0]);
+    device_handles[1] = register_device(handle, create_device_config("deviceid1", true), &TEST_waitingToSend, true);
+    ASSERT_IS_NOT_NULL(device_handles[1]);
+
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    TEST_amqp_connection_create_saved_on_state_changed_callback(
+        TEST_amqp_connection_create_saved_on_state_changed_context,
+        AMQP_CONNECTION_STATE_CLOSED, AMQP_CONNECTION_STATE_OPENED);
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_amqp_connection_get_session_handle_by_index_saved_session_index);
+
+    // The saved callback is the one of the last device registered.
+    TEST_device_create_saved_on_state_changed_callback(TEST_device_create_saved_on_state_changed_context, DEVICE_STATE_STARTING, DEVICE_STATE_ERROR_AUTH);
+
+    for (i = 1; i < 5; i++)
+    {
+        IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    }
+
+    return handle;
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_179: [If the failed device is not on the first AMQP session, only the registered devices on the same session shall be prepared for connection retry]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_180: [The session of the failed device shall then be reset using amqp_connection_reset_session_by_index()]
+TEST_FUNCTION(DoWork_device_failure_resets_only_its_session)
+{
+    // arrange
+    IOTHUB_DEVICE_HANDLE device_handles[2];
+
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport_with_failing_device_on_second_session(device_handles);
+
+    umock_c_reset_all_calls();
+    TEST_iothubtransportamqp_methods_unsubscribe_call_count = 0;
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_amqp_connection_reset_session_by_index_call_count);
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_amqp_connection_reset_session_by_index_saved_session_index);
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_iothubtransportamqp_methods_unsubscribe_call_count);
+    ASSERT_IS_NULL(strstr(umock_c_get_actual_calls(), "amqp_connection_destroy"));
+
+    // The transport is not flagged for connection retry.
+    umock_c_reset_all_calls();
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    ASSERT_IS_NULL(strstr(umock_c_get_actual_calls(), "retry_control_should_retry"));
+
+    // cleanup
+    umock_c_reset_all_calls();
+    IoTHubTransport_AMQP_Common_Destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_181: [If amqp_connection_reset_session_by_index() fails, the connection retry logic shall be triggered]
+TEST_FUNCTION(DoWork_device_session_reset_fails_triggers_connection_retry)
+{
+    // arrange
+    IOTHUB_DEVICE_HANDLE device_handles[2];
+    RETRY_ACTION retry_action = RETRY_ACTION_RETRY_LATER;
+
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport_with_failing_device_on_second_session(device_handles);
+    TEST_amqp_connection_reset_session_by_index_return = 1;
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_amqp_connection_reset_session_by_index_call_count);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(retry_control_should_retry(TEST_RETRY_CONTROL_HANDLE, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_retry_action(&retry_action, sizeof(RETRY_ACTION));
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    umock_c_reset_all_calls();
+    IoTHubTransport_AMQP_Common_Destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_170: [If the transport is using CBS authentication, authentication_put_token_queue_do_work() shall be invoked on `instance->put_token_queue` after the registered devices are processed]
+TEST_FUNCTION(DoWork_starts_all_devices_and_leaves_put_tokens_to_the_queue)
+{
+    // arrange
+    char device_ids[17][16];
+    IOTHUB_DEVICE_HANDLE device_handles[17];
+    size_t i;
+
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    for (i = 0; i < 17; i++)
+    {
+        (void)sprintf(device_ids[i], "deviceid%lu", (unsigned long)i);
+        device_handles[i] = register_device(handle, create_device_config(device_ids[i], true), &TEST_waitingToSend, true);
+        ASSERT_IS_NOT_NULL(device_handles[i]);
+    }
+
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    TEST_amqp_connection_create_saved_on_state_changed_callback(
+        TEST_amqp_connection_create_saved_on_state_changed_context,
+        AMQP_CONNECTION_STATE_CLOSED, AMQP_CONNECTION_STATE_OPENED);
+
+    umock_c_reset_all_calls();
+    TEST_device_start_async_call_count = 0;
+    TEST_authentication_put_token_queue_do_work_call_count = 0;
+
+    // act
+    IoTHubTransport_AMQP_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 17, TEST_device_start_async_call_count);
+    ASSERT_ARE_EQUAL(size_t, 1, TEST_authentication_put_token_queue_do_work_call_count);
+
+    // cleanup
+    umock_c_reset_all_calls();
+    IoTHubTransport_AMQP_Common_Destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_162: [If `option` is `amqp_session_count` and `value` is not between 1 and 16, IoTHubTransport_AMQP_Common_SetOption shall return IOTHUB_CLIENT_INVALID_ARG]
+TEST_FUNCTION(SetOption_amqp_session_count_out_of_range_fails)
+{
+    // arrange
+    initialize_test_variables();
+    TRANSPORT_LL_HANDLE handle = create_transport();
+
+    size_t zero_sessions = 0;
+    size_t too_many_sessions = 17;
+
+    umock_c_reset_all_calls();
+
+    // act
+    IOTHUB_CLIENT_RESULT result1 = IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &zero_sessions);
+    IOTHUB_CLIENT_RESULT result2 = IoTHubTransport_AMQP_Common_SetOption(handle, OPTION_AMQP_SESSION_COUNT, &too_many_sessions);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_INVALID_ARG, result1);
+    ASSERT_ARE_EQUAL(int, IOTHUB_CLIENT_INVALID_ARG, result2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    destroy_transport(handle, NULL, NULL);
+}
+
 
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_COMMON_09_121: [If `new_state` is DEVICE_STATE_STOPPED, IoTHubClient_LL_ConnectionStatusCallBack shall be invoked with IOTHUB_CLIENT_CONNECTION_UNAUTHENTICATED and IOTHUB_CLIENT_CONNECTION_OK]
 TEST_FUNCTION(ConnectionStatusCallBack_UNAUTH_OK)
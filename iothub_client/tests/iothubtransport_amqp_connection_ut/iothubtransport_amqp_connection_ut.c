@@ -79,6 +79,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define TEST_CONNECTION_HANDLE                            (CONNECTION_HANDLE)0x4452
 #define TEST_UNIQUE_ID                                    "ab345cd00829ef12"
 #define TEST_SESSION_HANDLE                               (SESSION_HANDLE)0x4453
+#define TEST_ADDITIONAL_SESSION_HANDLE                    (SESSION_HANDLE)0x4454
 #define TEST_CBS_HANDLE                                   (CBS_HANDLE)0x4454
 
 // Helpers
@@ -142,6 +143,17 @@ static CONNECTION_HANDLE TEST_connection_create2(XIO_HANDLE xio, const char* hos
     return TEST_connection_create2_result;
 }
 
+static size_t TEST_session_create_call_count;
+static size_t TEST_session_create_fail_on_call;
+static SESSION_HANDLE TEST_session_create(CONNECTION_HANDLE connection, ON_LINK_ATTACHED on_link_attached, void* callback_context)
+{
+    (void)connection;
+    (void)on_link_attached;
+    (void)callback_context;
+
+    return (++TEST_session_create_call_count == TEST_session_create_fail_on_call ? NULL : TEST_SESSION_HANDLE);
+}
+
 static const void* on_state_changed_callback_context;
 static AMQP_CONNECTION_STATE on_state_changed_callback_previous_state;
 static AMQP_CONNECTION_STATE on_state_changed_callback_new_state;
@@ -163,6 +175,7 @@ static AMQP_CONNECTION_CONFIG* get_amqp_connection_config()
     global_amqp_connection_config.is_trace_on = true;
     global_amqp_connection_config.svc2cl_keep_alive_timeout_secs = 123;
     global_amqp_connection_config.cl2svc_keep_alive_send_ratio   = 0.5;
+    global_amqp_connection_config.session_count = 0;
 
     return &global_amqp_connection_config;
 }
@@ -219,6 +232,21 @@ static void set_exp_calls_for_amqp_connection_create(AMQP_CONNECTION_CONFIG* amq
     STRICT_EXPECTED_CALL(session_set_incoming_window(TEST_SESSION_HANDLE, (uint32_t)DEFAULT_INCOMING_WINDOW_SIZE));
     STRICT_EXPECTED_CALL(session_set_outgoing_window(TEST_SESSION_HANDLE, (uint32_t)DEFAULT_OUTGOING_WINDOW_SIZE));
 
+    if (amqp_connection_config->session_count > 1)
+    {
+        size_t i;
+
+        STRICT_EXPECTED_CALL(malloc(IGNORED_NUM_ARG)).IgnoreArgument(1);
+
+        for (i = 1; i < amqp_connection_config->session_count; i++)
+        {
+            STRICT_EXPECTED_CALL(session_create(TEST_CONNECTION_HANDLE, NULL, NULL))
+                .SetReturn(TEST_ADDITIONAL_SESSION_HANDLE);
+            STRICT_EXPECTED_CALL(session_set_incoming_window(TEST_ADDITIONAL_SESSION_HANDLE, (uint32_t)DEFAULT_INCOMING_WINDOW_SIZE));
+            STRICT_EXPECTED_CALL(session_set_outgoing_window(TEST_ADDITIONAL_SESSION_HANDLE, (uint32_t)DEFAULT_OUTGOING_WINDOW_SIZE));
+        }
+    }
+
     // CBS
     if (amqp_connection_config->create_cbs_connection)
     {
@@ -234,6 +262,18 @@ static void set_exp_calls_for_amqp_connection_destroy(AMQP_CONNECTION_CONFIG* co
         STRICT_EXPECTED_CALL(cbs_destroy(TEST_CBS_HANDLE));
     }
 
+    if (config->session_count > 1)
+    {
+        size_t i;
+
+        for (i = 1; i < config->session_count; i++)
+        {
+            STRICT_EXPECTED_CALL(session_destroy(TEST_ADDITIONAL_SESSION_HANDLE));
+        }
+
+        EXPECTED_CALL(free(IGNORED_PTR_ARG));
+    }
+
     STRICT_EXPECTED_CALL(session_destroy(TEST_SESSION_HANDLE));
     STRICT_EXPECTED_CALL(connection_destroy(TEST_CONNECTION_HANDLE));
 
@@ -317,7 +357,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_RETURN(connection_set_remote_idle_timeout_empty_frame_send_ratio, 0);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(connection_set_remote_idle_timeout_empty_frame_send_ratio, 1);
 
-    REGISTER_GLOBAL_MOCK_RETURN(session_create, TEST_SESSION_HANDLE);
+    REGISTER_GLOBAL_MOCK_HOOK(session_create, TEST_session_create);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(session_create, NULL);
 
     REGISTER_GLOBAL_MOCK_RETURN(session_set_incoming_window, 0);
@@ -356,6 +396,8 @@ static void reset_test_data()
     connection_create2_on_connection_state_changed_context = NULL;
     connection_create2_on_io_error_context = NULL;
     on_state_changed_callback_context = NULL;
+    TEST_session_create_call_count = 0;
+    TEST_session_create_fail_on_call = 0;
 }
 
 TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
@@ -946,6 +988,253 @@ TEST_FUNCTION(amqp_connection_get_session_handle_success)
     amqp_connection_destroy(handle);
 }
 
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_075: [If `config->session_count` is greater than 1, amqp_connection_create() shall create `config->session_count` - 1 additional sessions using session_create(), with the same window sizes as `instance->session_handle`]
+TEST_FUNCTION(amqp_connection_create_multiple_sessions_success)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 3;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    // act
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(handle);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_076: [If creating any of the additional sessions fails, amqp_connection_create() shall fail and return NULL]
+TEST_FUNCTION(amqp_connection_create_additional_session_create_fails)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 3;
+
+    TEST_session_create_fail_on_call = 3;
+
+    // act
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    // assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(int, 3, (int)TEST_session_create_call_count);
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_077: [amqp_connection_destroy() shall destroy the additional sessions using session_destroy()]
+TEST_FUNCTION(amqp_connection_destroy_multiple_sessions_success)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_destroy(config, handle);
+
+    // act
+    amqp_connection_destroy(handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_078: [If `conn_handle` or `session_handle` are NULL, amqp_connection_get_session_handle_by_index() shall fail and return __FAILURE__]
+TEST_FUNCTION(amqp_connection_get_session_handle_by_index_NULL_handle)
+{
+    // arrange
+    SESSION_HANDLE session_handle;
+
+    // act
+    int result = amqp_connection_get_session_handle_by_index(NULL, 0, &session_handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result, 0);
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_079: [If `session_index` is not lower than the number of sessions of the connection, amqp_connection_get_session_handle_by_index() shall fail and return __FAILURE__]
+TEST_FUNCTION(amqp_connection_get_session_handle_by_index_out_of_range)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+
+    SESSION_HANDLE session_handle;
+
+    // act
+    int result = amqp_connection_get_session_handle_by_index(handle, 2, &session_handle);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result, 0);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_080: [`session_handle` shall be set to `instance->session_handle` if `session_index` is 0, or to the additional session `session_index` - 1 otherwise]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_081: [amqp_connection_get_session_handle_by_index() shall return success code 0]
+TEST_FUNCTION(amqp_connection_get_session_handle_by_index_success)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+
+    SESSION_HANDLE session_handle0;
+    SESSION_HANDLE session_handle1;
+
+    // act
+    int result0 = amqp_connection_get_session_handle_by_index(handle, 0, &session_handle0);
+    int result1 = amqp_connection_get_session_handle_by_index(handle, 1, &session_handle1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, result0, 0);
+    ASSERT_ARE_EQUAL(int, result1, 0);
+    ASSERT_ARE_EQUAL(void_ptr, session_handle0, TEST_SESSION_HANDLE);
+    ASSERT_ARE_EQUAL(void_ptr, session_handle1, TEST_ADDITIONAL_SESSION_HANDLE);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_082: [If `conn_handle` is NULL, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+TEST_FUNCTION(amqp_connection_reset_session_by_index_NULL_handle)
+{
+    // arrange
+    umock_c_reset_all_calls();
+
+    // act
+    int result = amqp_connection_reset_session_by_index(NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result, 0);
+
+    // cleanup
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_083: [If `session_index` is 0 or not lower than the number of sessions of the connection, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+TEST_FUNCTION(amqp_connection_reset_session_by_index_invalid_index)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+
+    // act
+    int result0 = amqp_connection_reset_session_by_index(handle, 0);
+    int result2 = amqp_connection_reset_session_by_index(handle, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result0, 0);
+    ASSERT_ARE_NOT_EQUAL(int, result2, 0);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_085: [If session_create() fails, amqp_connection_reset_session_by_index() shall fail and return __FAILURE__]
+TEST_FUNCTION(amqp_connection_reset_session_by_index_session_create_fails)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(session_create(TEST_CONNECTION_HANDLE, NULL, NULL))
+        .SetReturn(NULL);
+
+    // act
+    int result = amqp_connection_reset_session_by_index(handle, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result, 0);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_084: [A new session shall be created using session_create(), passing `instance->connection_handle`]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_086: [The new session shall have the same window sizes as `instance->session_handle`]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_087: [The additional session `session_index` - 1 shall be destroyed using session_destroy() and replaced by the new session]
+// Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_088: [amqp_connection_reset_session_by_index() shall return success code 0]
+TEST_FUNCTION(amqp_connection_reset_session_by_index_success)
+{
+    // arrange
+    AMQP_CONNECTION_CONFIG* config = get_amqp_connection_config();
+    config->session_count = 2;
+
+    umock_c_reset_all_calls();
+    set_exp_calls_for_amqp_connection_create(config);
+
+    AMQP_CONNECTION_HANDLE handle = amqp_connection_create(config);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(session_create(TEST_CONNECTION_HANDLE, NULL, NULL))
+        .SetReturn(TEST_ADDITIONAL_SESSION_HANDLE);
+    STRICT_EXPECTED_CALL(session_set_incoming_window(TEST_ADDITIONAL_SESSION_HANDLE, (uint32_t)DEFAULT_INCOMING_WINDOW_SIZE));
+    STRICT_EXPECTED_CALL(session_set_outgoing_window(TEST_ADDITIONAL_SESSION_HANDLE, (uint32_t)DEFAULT_OUTGOING_WINDOW_SIZE));
+    STRICT_EXPECTED_CALL(session_destroy(TEST_ADDITIONAL_SESSION_HANDLE));
+
+    SESSION_HANDLE session_handle;
+
+    // act
+    int result = amqp_connection_reset_session_by_index(handle, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, result, 0);
+    ASSERT_ARE_EQUAL(int, 0, amqp_connection_get_session_handle_by_index(handle, 1, &session_handle));
+    ASSERT_ARE_EQUAL(void_ptr, session_handle, TEST_ADDITIONAL_SESSION_HANDLE);
+
+    // cleanup
+    amqp_connection_destroy(handle);
+}
+
 // Tests_SRS_IOTHUBTRANSPORT_AMQP_CONNECTION_09_047: [If `conn_handle` is NULL, amqp_connection_get_cbs_handle() shall fail and return __FAILURE__]
 TEST_FUNCTION(amqp_connection_get_cbs_handle_NULL_handle)
 {
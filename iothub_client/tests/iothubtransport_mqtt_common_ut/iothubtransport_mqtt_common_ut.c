@@ -184,6 +184,8 @@ static const MAP_HANDLE TEST_MESSAGE_PROP_MAP = (MAP_HANDLE)0x1212;
 static char appMessageString[] = "App Message String";
 static uint8_t appMessage[] = { 0x54, 0x68, 0x69, 0x73, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4d, 0x73, 0x67 };
 static const size_t appMsgSize = sizeof(appMessage) / sizeof(appMessage[0]);
+static const char* TEST_REPORTED_STATE_1 = "{\"firmware\":\"1.0\",\"telemetry\":{\"interval\":10}}";
+static const char* TEST_REPORTED_STATE_2 = "{\"telemetry\":{\"enabled\":true}}";
 
 static IOTHUB_CLIENT_CONFIG g_iothubClientConfig = { 0 };
 static DLIST_ENTRY g_waitingToSend;
@@ -891,6 +893,7 @@ static void setup_IoTHubTransport_MQTT_Common_Create_mocks(bool use_gateway)
         STRICT_EXPECTED_CALL(STRING_construct(IGNORED_PTR_ARG));
     }
 
+    EXPECTED_CALL(DList_InitializeListHead(IGNORED_PTR_ARG));
     EXPECTED_CALL(DList_InitializeListHead(IGNORED_PTR_ARG));
     EXPECTED_CALL(DList_InitializeListHead(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(get_time(IGNORED_PTR_ARG))
@@ -1139,6 +1142,10 @@ static void setup_IoTHubTransport_MQTT_Common_DoWork_events_mocks(
     {
         EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
         EXPECTED_CALL(mqttmessage_create(IGNORED_NUM_ARG, IGNORED_PTR_ARG, DELIVER_AT_LEAST_ONCE, appMessage, appMsgSize));
+        if (resend)
+        {
+            STRICT_EXPECTED_CALL(mqttmessage_setIsDuplicateMsg(TEST_MQTT_MESSAGE_HANDLE, true));
+        }
         STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_COUNTER_HANDLE, IGNORED_PTR_ARG))
             .IgnoreArgument(1);
         STRICT_EXPECTED_CALL(mqtt_client_publish(TEST_MQTT_CLIENT_HANDLE, IGNORED_PTR_ARG))
@@ -1739,6 +1746,7 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_Destroy_One_Message_Ack_succeeds)
     EXPECTED_CALL(gballoc_free(NULL));
     EXPECTED_CALL(DList_IsListEmpty(IGNORED_PTR_ARG));
     EXPECTED_CALL(DList_IsListEmpty(IGNORED_PTR_ARG));
+    EXPECTED_CALL(DList_IsListEmpty(IGNORED_PTR_ARG));
 
     set_expected_calls_for_free_transport_handle_data();
 
@@ -2262,6 +2270,54 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_SAS_TOKEN_LIFETIME_succees)
     IoTHubTransport_MQTT_Common_Destroy(handle);
 }
 
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_006: [ If the option parameter is set to "twin_reported_state_coalesce_secs" then the value shall be a size_t_ptr, from 0 (disabled) to 60, used as the reported state coalescing window; other values shall fail with IOTHUB_CLIENT_INVALID_ARG. ] */
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_TWIN_REPORTED_STATE_COALESCE_SECS_succeed)
+{
+    // arrange
+    size_t coalesce_secs = 60;
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    SetupIothubTransportConfig(&config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+
+    TRANSPORT_LL_HANDLE handle = IoTHubTransport_MQTT_Common_Create(&config, get_IO_transport);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(IoTHubClient_Auth_Get_Credential_Type(IGNORED_PTR_ARG));
+
+    // act
+    IOTHUB_CLIENT_RESULT result = IoTHubTransport_MQTT_Common_SetOption(handle, OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    // assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_006: [ If the option parameter is set to "twin_reported_state_coalesce_secs" then the value shall be a size_t_ptr, from 0 (disabled) to 60, used as the reported state coalescing window; other values shall fail with IOTHUB_CLIENT_INVALID_ARG. ] */
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_TWIN_REPORTED_STATE_COALESCE_SECS_too_large_fail)
+{
+    // arrange
+    size_t coalesce_secs = 61;
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    SetupIothubTransportConfig(&config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+
+    TRANSPORT_LL_HANDLE handle = IoTHubTransport_MQTT_Common_Create(&config, get_IO_transport);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(IoTHubClient_Auth_Get_Credential_Type(IGNORED_PTR_ARG));
+
+    // act
+    IOTHUB_CLIENT_RESULT result = IoTHubTransport_MQTT_Common_SetOption(handle, OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    // assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
 /* Tests_SRS_IOTHUB_MQTT_TRANSPORT_07_039: [If the option parameter is set to "x509certificate" then the value shall be a const char of the certificate to be used for x509.] */
 TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_x509Certificate_no_509_fail)
 {
@@ -2414,6 +2470,30 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_keepAlive_succeed)
     IoTHubTransport_MQTT_Common_Destroy(handle);
 }
 
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_019: [ If the option parameter is set to "clean_session" then the value shall be a bool_ptr and the value will be used as the CleanSession flag on the next mqtt_client_connect.] */
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_clean_session_succeed)
+{
+    // arrange
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    SetupIothubTransportConfig(&config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+
+    TRANSPORT_LL_HANDLE handle = IoTHubTransport_MQTT_Common_Create(&config, get_IO_transport);
+    umock_c_reset_all_calls();
+
+    bool clean_session = true;
+    STRICT_EXPECTED_CALL(IoTHubClient_Auth_Get_Credential_Type(IGNORED_PTR_ARG));
+
+    // act
+    IOTHUB_CLIENT_RESULT result = IoTHubTransport_MQTT_Common_SetOption(handle, OPTION_CLEAN_SESSION, &clean_session);
+
+    // assert
+    ASSERT_ARE_EQUAL(IOTHUB_CLIENT_RESULT, IOTHUB_CLIENT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
 /* Tests_SRS_IOTHUB_MQTT_TRANSPORT_07_038: [If the client is connected when the keepalive is set then IoTHubTransport_MQTT_Common_SetOption shall disconnect and reconnect with the specified keepalive value.] */
 TEST_FUNCTION(IoTHubTransport_MQTT_Common_SetOption_keepAlive_previous_connection_succeed)
 {
@@ -4179,6 +4259,7 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_2_message_timeout_succeeds)
     STRICT_EXPECTED_CALL(IoTHubMessage_GetDiagnosticPropertyData(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(mqttmessage_create(IGNORED_NUM_ARG, IGNORED_PTR_ARG, DELIVER_AT_LEAST_ONCE, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(mqttmessage_setIsDuplicateMsg(IGNORED_PTR_ARG, true));
     STRICT_EXPECTED_CALL(tickcounter_get_current_ms(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(mqtt_client_publish(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(mqttmessage_destroy(IGNORED_PTR_ARG));
@@ -4194,6 +4275,131 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_2_message_timeout_succeeds)
     //cleanup
     IoTHubTransport_MQTT_Common_Destroy(handle);
 }
+
+static TRANSPORT_LL_HANDLE setup_inflight_message_and_reconnect(IOTHUBTRANSPORT_CONFIG* config, IOTHUB_MESSAGE_LIST* message, bool session_present)
+{
+    CONNECT_ACK connack = { true, CONNECTION_ACCEPTED };
+    TRANSPORT_LL_HANDLE handle;
+
+    SetupIothubTransportConfig(config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+    handle = IoTHubTransport_MQTT_Common_Create(config, get_IO_transport);
+
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    g_fnMqttOperationCallback(TEST_MQTT_CLIENT_HANDLE, MQTT_CLIENT_ON_CONNACK, &connack, g_callbackCtx);
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    memset(message, 0, sizeof(IOTHUB_MESSAGE_LIST));
+    message->messageHandle = TEST_IOTHUB_MSG_STRING;
+    DList_InsertTailList(config->waitingToSend, &(message->entry));
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    /* Break the connection and come back with or without the previous session */
+    g_fnMqttOperationCallback(TEST_MQTT_CLIENT_HANDLE, MQTT_CLIENT_ON_DISCONNECT, NULL, g_callbackCtx);
+    connack.isSessionPresent = session_present;
+    g_fnMqttOperationCallback(TEST_MQTT_CLIENT_HANDLE, MQTT_CLIENT_ON_CONNACK, &connack, g_callbackCtx);
+
+    return handle;
+}
+
+/* The in-flight message is first published with packet id 2, the transport starts counting at 1 */
+#define TEST_INFLIGHT_PACKET_ID         2
+#define TEST_INFLIGHT_NEW_PACKET_ID     3
+
+static void setup_resend_inflight_message_mocks(bool session_present, uint16_t packet_id)
+{
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetContentType(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetString(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_construct(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Properties(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetCorrelationId(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetMessageId(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetContentTypeSystemProperty(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetContentEncodingSystemProperty(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetDiagnosticPropertyData(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mqttmessage_create(packet_id, IGNORED_PTR_ARG, DELIVER_AT_LEAST_ONCE, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    if (session_present)
+    {
+        STRICT_EXPECTED_CALL(mqttmessage_setIsDuplicateMsg(IGNORED_PTR_ARG, true));
+    }
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mqtt_client_publish(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mqttmessage_destroy(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mqtt_client_dowork(IGNORED_PTR_ARG));
+}
+
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_016: [ Upon successful connection any telemetry still waiting for PUBACK shall be scheduled for immediate retransmission ]*/
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_017: [ If the service reported the session as present the message shall be republished with its original packet id and the DUP flag set, otherwise it shall be published with a new packet id ]*/
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_018: [ A telemetry message republished with the same packet id shall have the DUP flag set using mqttmessage_setIsDuplicateMsg ]*/
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_reconnect_session_present_resends_inflight_with_dup)
+{
+    // arrange
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    IOTHUB_MESSAGE_LIST message;
+    TRANSPORT_LL_HANDLE handle = setup_inflight_message_and_reconnect(&config, &message, true);
+    umock_c_reset_all_calls();
+
+    setup_resend_inflight_message_mocks(true, TEST_INFLIGHT_PACKET_ID);
+
+    // act
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_017: [ If the service reported the session as present the message shall be republished with its original packet id and the DUP flag set, otherwise it shall be published with a new packet id ]*/
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_reconnect_no_session_resends_inflight_without_dup)
+{
+    // arrange
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    IOTHUB_MESSAGE_LIST message;
+    TRANSPORT_LL_HANDLE handle = setup_inflight_message_and_reconnect(&config, &message, false);
+    umock_c_reset_all_calls();
+
+    setup_resend_inflight_message_mocks(false, TEST_INFLIGHT_NEW_PACKET_ID);
+
+    // act
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_09_016: [ Upon successful connection any telemetry still waiting for PUBACK shall be scheduled for immediate retransmission ]*/
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_reconnect_resends_inflight_only_once)
+{
+    // arrange
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    IOTHUB_MESSAGE_LIST message;
+    TRANSPORT_LL_HANDLE handle = setup_inflight_message_and_reconnect(&config, &message, true);
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(mqtt_client_dowork(IGNORED_PTR_ARG));
+
+    // act
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+}
+
 /* Test_SRS_IOTHUB_MQTT_TRANSPORT_07_055: [ IoTHubTransport_MQTT_Common_DoWork shall send a device twin get property message upon successfully retrieving a SUBACK on device twin topics. ] */
 TEST_FUNCTION(IoTHubTransport_MQTT_Common_DoWork_device_twin_resend_message_succeeds)
 {
@@ -4942,6 +5148,66 @@ TEST_FUNCTION(IoTHubTransportMqtt_MessageRecv_device_twin_succeed)
     IoTHubTransport_MQTT_Common_Destroy(handle);
 }
 
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_002: [ The waiting reported states shall be merged in the order they were processed, later values replacing earlier ones for the same property path, into as few reported state messages as possible. ] */
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_003: [ Each merged reported state shall be published as a single reported state message and added to the acknowledgement queue. ] */
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_004: [ When a coalesced reported state completes, IoTHubClient_LL_ReportedStateComplete shall be called with the same status code for each of the reported states it was merged from, in the order they were processed. ] */
+TEST_FUNCTION(IoTHubTransportMqtt_MessageRecv_device_twin_coalesced_completes_each_reported_state_succeed)
+{
+    // arrange
+    size_t coalesce_secs = 1;
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    SetupIothubTransportConfig(&config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+
+    TRANSPORT_LL_HANDLE handle = IoTHubTransport_MQTT_Common_Create(&config, get_IO_transport);
+    (void)IoTHubTransport_MQTT_Common_SetOption(handle, OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    QOS_VALUE QosValue[] = { DELIVER_AT_LEAST_ONCE };
+    SUBSCRIBE_ACK suback;
+    suback.packetId = 1234;
+    suback.qosCount = 1;
+    suback.qosReturn = QosValue;
+
+    g_fnMqttOperationCallback(TEST_MQTT_CLIENT_HANDLE, MQTT_CLIENT_ON_SUBSCRIBE_ACK, &suback, g_callbackCtx);
+
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    CONSTBUFFER_HANDLE cbh1 = CONSTBUFFER_Create((const unsigned char*)TEST_REPORTED_STATE_1, strlen(TEST_REPORTED_STATE_1));
+    CONSTBUFFER_HANDLE cbh2 = CONSTBUFFER_Create((const unsigned char*)TEST_REPORTED_STATE_2, strlen(TEST_REPORTED_STATE_2));
+    IOTHUB_DEVICE_TWIN device_twin1;
+    device_twin1.report_data_handle = cbh1;
+    device_twin1.item_id = 1;
+    IOTHUB_DEVICE_TWIN device_twin2;
+    device_twin2.report_data_handle = cbh2;
+    device_twin2.item_id = 2;
+    IOTHUB_IDENTITY_INFO identity_info1;
+    identity_info1.device_twin = &device_twin1;
+    IOTHUB_IDENTITY_INFO identity_info2;
+    identity_info2.device_twin = &device_twin2;
+    (void)IoTHubTransport_MQTT_Common_ProcessItem(handle, IOTHUB_TYPE_DEVICE_TWIN, &identity_info1);
+    (void)IoTHubTransport_MQTT_Common_ProcessItem(handle, IOTHUB_TYPE_DEVICE_TWIN, &identity_info2);
+    // both reported states go out in the one message answered below
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+    umock_c_reset_all_calls();
+
+    g_tokenizerIndex = 1;
+
+    setup_message_recv_callback_device_twin_mocks("res");
+    STRICT_EXPECTED_CALL(IoTHubClient_LL_ReportedStateComplete(IGNORED_PTR_ARG, 2, 200))
+        .IgnoreArgument_handle();
+    EXPECTED_CALL(gballoc_free(NULL));
+
+    // act
+    ASSERT_IS_NOT_NULL(g_fnMqttMsgRecv);
+    g_fnMqttMsgRecv(TEST_MQTT_MESSAGE_HANDLE, g_callbackCtx);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+    CONSTBUFFER_Destroy(cbh1);
+    CONSTBUFFER_Destroy(cbh2);
+}
+
 TEST_FUNCTION(IoTHubTransportMqtt_MessageRecv_device_twin_fail)
 {
     // arrange
@@ -6171,6 +6437,50 @@ TEST_FUNCTION(IoTHubTransport_MQTT_Common_ProcessItem_Succeed)
     CONSTBUFFER_Destroy(cbh);
 }
 
+/* Tests_SRS_IOTHUB_TRANSPORT_MQTT_COMMON_99_001: [ If reported state coalescing is enabled IoTHubTransport_MQTT_Common_DoWork shall hold the reported states until the oldest one has waited `twin_reported_state_coalesce_secs`. ] */
+TEST_FUNCTION(IoTHubTransport_MQTT_Common_ProcessItem_coalesce_holds_reported_state_succeed)
+{
+    // arrange
+    size_t coalesce_secs = 5;
+    IOTHUBTRANSPORT_CONFIG config = { 0 };
+    SetupIothubTransportConfig(&config, TEST_DEVICE_ID, TEST_DEVICE_KEY, TEST_IOTHUB_NAME, TEST_IOTHUB_SUFFIX, TEST_PROTOCOL_GATEWAY_HOSTNAME);
+
+    TRANSPORT_LL_HANDLE handle = IoTHubTransport_MQTT_Common_Create(&config, get_IO_transport);
+    (void)IoTHubTransport_MQTT_Common_SetOption(handle, OPTION_TWIN_REPORTED_STATE_COALESCE_SECS, &coalesce_secs);
+
+    QOS_VALUE QosValue[] = { DELIVER_AT_LEAST_ONCE };
+    SUBSCRIBE_ACK suback;
+    suback.packetId = 1234;
+    suback.qosCount = 1;
+    suback.qosReturn = QosValue;
+
+    g_fnMqttOperationCallback(TEST_MQTT_CLIENT_HANDLE, MQTT_CLIENT_ON_SUBSCRIBE_ACK, &suback, g_callbackCtx);
+    IoTHubTransport_MQTT_Common_DoWork(handle, TEST_IOTHUB_CLIENT_LL_HANDLE);
+
+    CONSTBUFFER_HANDLE cbh = CONSTBUFFER_Create((const unsigned char*)TEST_REPORTED_STATE_1, strlen(TEST_REPORTED_STATE_1));
+    IOTHUB_DEVICE_TWIN device_twin;
+    device_twin.report_data_handle = cbh;
+    device_twin.item_id = 1;
+    IOTHUB_IDENTITY_INFO identity_info;
+    identity_info.device_twin = &device_twin;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(tickcounter_get_current_ms(TEST_COUNTER_HANDLE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(DList_InsertTailList(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // act
+    IOTHUB_PROCESS_ITEM_RESULT result_item = IoTHubTransport_MQTT_Common_ProcessItem(handle, IOTHUB_TYPE_DEVICE_TWIN, &identity_info);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, IOTHUB_PROCESS_OK, result_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    //cleanup
+    IoTHubTransport_MQTT_Common_Destroy(handle);
+    CONSTBUFFER_Destroy(cbh);
+}
+
 /* Tests_SRS_IOTHUBCLIENT_LL_07_001: [ If handle or iothub_item are NULL then IoTHubTransport_MQTT_Common_ProcessItem shall return IOTHUB_PROCESS_ERROR.]*/
 TEST_FUNCTION(IoTHubTransport_MQTT_Common_ProcessItem_iothub_item_NULL_fail)
 {
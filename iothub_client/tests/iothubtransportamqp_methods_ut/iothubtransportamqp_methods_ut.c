@@ -460,7 +460,7 @@ static void setup_subscribe_expected_calls(void)
     STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE));
 }
 
-static void setup_message_received_calls(void)
+static void setup_message_received_calls_with_handle_reuse(bool reuse_method_handle)
 {
     AMQP_VALUE correlation_id = (AMQP_VALUE)0x5000;
     AMQP_VALUE application_properties = (AMQP_VALUE)0x5001;
@@ -479,8 +479,11 @@ static void setup_message_received_calls(void)
         .CopyOutArgumentBuffer(2, &test_properties_handle, sizeof(test_properties_handle));
     STRICT_EXPECTED_CALL(properties_get_correlation_id(test_properties_handle, IGNORED_PTR_ARG))
         .CopyOutArgumentBuffer(2, &correlation_id, sizeof(correlation_id));
-    EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
-    EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    if (!reuse_method_handle)
+    {
+        EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    }
     STRICT_EXPECTED_CALL(amqpvalue_get_uuid(correlation_id, IGNORED_PTR_ARG))
         .CopyOutArgumentBuffer(2, &correlation_id_uuid, sizeof(correlation_id_uuid));
     STRICT_EXPECTED_CALL(message_get_body_amqp_data_in_place(TEST_UAMQP_MESSAGE, 0, IGNORED_PTR_ARG))
@@ -505,6 +508,11 @@ static void setup_message_received_calls(void)
     STRICT_EXPECTED_CALL(properties_destroy(test_properties_handle));
 }
 
+static void setup_message_received_calls(void)
+{
+    setup_message_received_calls_with_handle_reuse(false);
+}
+
 static void setup_method_respond_calls(void)
 {
     static const unsigned char response_payload[] = { 0x43 };
@@ -539,7 +547,6 @@ static void setup_method_respond_calls(void)
     STRICT_EXPECTED_CALL(messagesender_send_async(TEST_MESSAGE_SENDER, TEST_RESPONSE_UAMQP_MESSAGE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG))
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context();
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 }
 
 static void setup_respond_calls(int status)
@@ -576,8 +583,6 @@ static void setup_respond_calls(int status)
     STRICT_EXPECTED_CALL(messagesender_send_async(TEST_MESSAGE_SENDER, TEST_RESPONSE_UAMQP_MESSAGE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG))
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context();
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_value));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_key));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(response_properties_map));
@@ -2209,8 +2214,6 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_sends_the_uAMQP_message)
     STRICT_EXPECTED_CALL(messagesender_send_async(TEST_MESSAGE_SENDER, TEST_RESPONSE_UAMQP_MESSAGE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG))
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context();
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_value));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_key));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(response_properties_map));
@@ -2321,11 +2324,10 @@ TEST_FUNCTION(when_a_failure_occurs_iothubtransportamqp_methods_respond_fails)
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context()
         .SetFailReturn(NULL);
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
     umock_c_negative_tests_snapshot();
 
-    for (size_t i = 0; i < umock_c_negative_tests_call_count() - 1; i++)
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
     {
         umock_c_negative_tests_reset();
         umock_c_negative_tests_fail_call(i);
@@ -2424,8 +2426,6 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_can_be_called_from_the_method_
     STRICT_EXPECTED_CALL(messagesender_send_async(TEST_MESSAGE_SENDER, TEST_RESPONSE_UAMQP_MESSAGE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG))
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context();
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_value));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_key));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(response_properties_map));
@@ -2504,8 +2504,6 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_to_the_second_method_succeeds)
     STRICT_EXPECTED_CALL(messagesender_send_async(TEST_MESSAGE_SENDER, TEST_RESPONSE_UAMQP_MESSAGE, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG))
         .IgnoreArgument_on_message_send_complete()
         .IgnoreArgument_callback_context();
-    EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG));
-    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_value));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(status_property_key));
     STRICT_EXPECTED_CALL(amqpvalue_destroy(response_properties_map));
@@ -2552,7 +2550,8 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_removes_the_handle_from_the_tr
     iothubtransportamqp_methods_unsubscribe(amqp_methods_handle);
     umock_c_reset_all_calls();
 
-    /* 1 extra free for the handle and one extra for the handle array */
+    /* 1 extra free for the tracked handle, one extra for the handle array and one for the released handle */
+    EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
     EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG));
 
@@ -2568,6 +2567,8 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_removes_the_handle_from_the_tr
 }
 
 /* Tests_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_114: [ The handle `method_handle` shall be removed from the array used to track the method handles. ]*/
+/* Tests_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_150: [ The handle shall be removed from the tracking array by moving the last tracked handle into its slot, without resizing the array. ]*/
+/* Tests_SRS_IOTHUBTRANSPORT_AMQP_METHODS_01_151: [ If a previously released `IOTHUBTRANSPORT_AMQP_METHOD_HANDLE` is available it shall be reused instead of allocating a new one. ]*/
 TEST_FUNCTION(iothubtransportamqp_methods_respond_after_a_handle_has_been_removed_works)
 {
     /// arrange
@@ -2587,7 +2588,7 @@ TEST_FUNCTION(iothubtransportamqp_methods_respond_after_a_handle_has_been_remove
     umock_c_reset_all_calls();
 
     /* setup second request */
-    setup_message_received_calls();
+    setup_message_received_calls_with_handle_reuse(true);
 
     /// act
     g_on_message_received(amqp_methods_handle, TEST_UAMQP_MESSAGE);
@@ -638,7 +638,8 @@ IoTHubTransport_Subscribe = IoTHubTransportAMQP_WS_Subscribe
 IoTHubTransport_Unsubscribe = IoTHubTransportAMQP_WS_Unsubscribe
 IoTHubTransport_DoWork = IoTHubTransportAMQP_WS_DoWork
 IoTHubTransport_SetRetryLogic = IoTHubTransportAMQP_WS_SetRetryLogic
-IoTHubTransport_SetOption = IoTHubTransportAMQP_WS_SetOption]*/
+IoTHubTransport_SetOption = IoTHubTransportAMQP_WS_SetOption
+IoTHubTransport_NotifyEventQueued = IoTHubTransportAMQP_WS_NotifyEventQueued]*/
 TEST_FUNCTION(AMQP_Create)
 {
     // arrange
@@ -1092,6 +1093,23 @@ TEST_FUNCTION(AMQP_GetSendStatus)
     // cleanup
 }
 
+TEST_FUNCTION(AMQP_NotifyEventQueued)
+{
+    // arrange
+    TRANSPORT_PROVIDER* provider = (TRANSPORT_PROVIDER*)AMQP_Protocol_over_WebSocketsTls();
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(IoTHubTransport_AMQP_Common_NotifyEventQueued(TEST_IOTHUB_DEVICE_HANDLE));
+
+    // act
+    provider->IoTHubTransport_NotifyEventQueued(TEST_IOTHUB_DEVICE_HANDLE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+}
+
 
 // Tests_SRS_IOTHUBTRANSPORTAMQP_WS_09_018: [IoTHubTransportAMQP_WS_GetHostname shall get the hostname by calling into the IoTHubTransport_AMQP_Common_GetHostname()]
 TEST_FUNCTION(AMQP_GetHostname)
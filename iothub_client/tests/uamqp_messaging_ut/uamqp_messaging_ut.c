@@ -61,6 +61,7 @@ static void TEST_free(void* ptr)
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/gballoc.h"
 #include "azure_c_shared_utility/uuid.h"
+#include "azure_c_shared_utility/buffer_.h"
 
 #include "iothub_message.h"
 #include "azure_uamqp_c/amqp_definitions_application_properties.h"
@@ -89,11 +90,18 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 #define TEST_MAP_HANDLE (MAP_HANDLE)0x103
 #define TEST_AMQP_VALUE (AMQP_VALUE)0x104
 #define TEST_PROPERTIES_HANDLE (PROPERTIES_HANDLE)0x107
+#define TEST_ENCODE_BUFFER_HANDLE (BUFFER_HANDLE)0x108
 #define TEST_CORRELATION_ID "Test Correlation Id"
 
 #define TEST_AMQP_ENCODING_SIZE 5
 
-static char g_encoding_buffer[TEST_AMQP_ENCODING_SIZE * 3];
+// Message and application properties are written in place by uamqp_messaging; these are their encoded sizes
+// for the default test message (message-id, correlation-id, content-type, content-encoding and one application property).
+#define TEST_MESSAGE_PROPERTIES_ENCODING_SIZE 76
+#define TEST_APPLICATION_PROPERTIES_ENCODING_SIZE 34
+#define TEST_MESSAGE_ENCODING_SIZE (TEST_MESSAGE_PROPERTIES_ENCODING_SIZE + TEST_APPLICATION_PROPERTIES_ENCODING_SIZE + TEST_AMQP_ENCODING_SIZE * 2)
+
+static char g_encoding_buffer[256];
 
 #define UUID_N_OF_OCTECTS 16
 #define UUID_STRING_SIZE 37
@@ -204,16 +212,9 @@ static void set_exp_calls_for_create_encoded_annotations_properties(bool has_dia
 
 static void set_exp_calls_for_create_encoded_message_properties(bool has_message_id, bool has_correlation_id, const char* content_type, const char* content_encoding)
 {
-    size_t encoding_size = TEST_AMQP_ENCODING_SIZE;
-
-    STRICT_EXPECTED_CALL(properties_create());
-
     if (has_message_id)
     {
         STRICT_EXPECTED_CALL(IoTHubMessage_GetMessageId(TEST_IOTHUB_MESSAGE_HANDLE));
-        STRICT_EXPECTED_CALL(amqpvalue_create_string(TEST_STRING));
-        STRICT_EXPECTED_CALL(properties_set_message_id(TEST_PROPERTIES_HANDLE, TEST_AMQP_VALUE));
-        STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
     }
     else
     {
@@ -223,9 +224,6 @@ static void set_exp_calls_for_create_encoded_message_properties(bool has_message
     if (has_correlation_id)
     {
         STRICT_EXPECTED_CALL(IoTHubMessage_GetCorrelationId(TEST_IOTHUB_MESSAGE_HANDLE));
-        STRICT_EXPECTED_CALL(amqpvalue_create_string(TEST_CORRELATION_ID));
-        STRICT_EXPECTED_CALL(properties_set_correlation_id(TEST_PROPERTIES_HANDLE, TEST_AMQP_VALUE));
-        STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
     }
     else
     {
@@ -234,54 +232,17 @@ static void set_exp_calls_for_create_encoded_message_properties(bool has_message
 
     STRICT_EXPECTED_CALL(IoTHubMessage_GetContentTypeSystemProperty(TEST_IOTHUB_MESSAGE_HANDLE))
         .SetReturn(content_type);
-
-    if (content_type != NULL)
-    {
-        STRICT_EXPECTED_CALL(properties_set_content_type(IGNORED_PTR_ARG, content_type));
-    }
-    
     STRICT_EXPECTED_CALL(IoTHubMessage_GetContentEncodingSystemProperty(TEST_IOTHUB_MESSAGE_HANDLE))
         .SetReturn(content_encoding);
-
-    if (content_encoding != NULL)
-    {
-        STRICT_EXPECTED_CALL(properties_set_content_encoding(IGNORED_PTR_ARG, content_encoding));
-    }
-
-    STRICT_EXPECTED_CALL(amqpvalue_create_properties(TEST_PROPERTIES_HANDLE));
-    STRICT_EXPECTED_CALL(amqpvalue_get_encoded_size(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-        .CopyOutArgumentBuffer(2, &encoding_size, sizeof(encoding_size));
-    STRICT_EXPECTED_CALL(properties_destroy(TEST_PROPERTIES_HANDLE));
 }
 
 static void set_exp_calls_for_create_encoded_application_properties(size_t number_of_app_properties)
 {
-    size_t encoding_size = TEST_AMQP_ENCODING_SIZE;
-
     STRICT_EXPECTED_CALL(IoTHubMessage_Properties(TEST_IOTHUB_MESSAGE_HANDLE)); //16
     STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
         .CopyOutArgumentBuffer(2, &TEST_MAP_KEYS, sizeof(TEST_MAP_KEYS))
         .CopyOutArgumentBuffer(3, &TEST_MAP_VALUES, sizeof(TEST_MAP_VALUES))
         .CopyOutArgumentBuffer(4, &number_of_app_properties, sizeof(number_of_app_properties));
-
-    if (number_of_app_properties > 0)
-    {
-        STRICT_EXPECTED_CALL(amqpvalue_create_map());
-
-        for (size_t i = 0; i < number_of_app_properties; i++)
-        {
-            STRICT_EXPECTED_CALL(amqpvalue_create_string(TEST_MAP_KEYS[i]));
-            STRICT_EXPECTED_CALL(amqpvalue_create_string(TEST_MAP_VALUES[i]));
-            STRICT_EXPECTED_CALL(amqpvalue_set_map_value(TEST_AMQP_VALUE, TEST_AMQP_VALUE, TEST_AMQP_VALUE));
-            STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
-            STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
-        }
-
-        STRICT_EXPECTED_CALL(amqpvalue_create_application_properties(TEST_AMQP_VALUE));
-        STRICT_EXPECTED_CALL(amqpvalue_get_encoded_size(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .CopyOutArgumentBuffer(2, &encoding_size, sizeof(encoding_size));
-        STRICT_EXPECTED_CALL(amqpvalue_destroy(IGNORED_PTR_ARG));
-    }
 }
 
 static void set_exp_calls_for_create_encoded_data(IOTHUBMESSAGE_CONTENT_TYPE msg_content_type)
@@ -306,22 +267,8 @@ static void set_exp_calls_for_create_encoded_data(IOTHUBMESSAGE_CONTENT_TYPE msg
         .CopyOutArgumentBuffer(2, &encoding_size, sizeof(encoding_size));
 }
 
-static void set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message(size_t number_of_app_properties, IOTHUBMESSAGE_CONTENT_TYPE msg_content_type, bool has_message_id, bool has_correlation_id, bool has_diag_properties, const char* content_type, const char* content_encoding)
+static void set_exp_calls_for_encode_and_destroy_values(bool has_diag_properties)
 {
-    set_exp_calls_for_create_encoded_message_properties(has_message_id, has_correlation_id, content_type, content_encoding);
-    set_exp_calls_for_create_encoded_application_properties(number_of_app_properties);
-    set_exp_calls_for_create_encoded_annotations_properties(has_diag_properties);
-    set_exp_calls_for_create_encoded_data(msg_content_type);
-
-    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-        .SetReturn(g_encoding_buffer);
-    STRICT_EXPECTED_CALL(amqpvalue_encode(TEST_AMQP_VALUE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-
-    if (number_of_app_properties > 0)
-    {
-        STRICT_EXPECTED_CALL(amqpvalue_encode(TEST_AMQP_VALUE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    }
-
     if (has_diag_properties)
     {
         STRICT_EXPECTED_CALL(amqpvalue_encode(TEST_AMQP_VALUE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
@@ -330,15 +277,40 @@ static void set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message(
     STRICT_EXPECTED_CALL(amqpvalue_encode(TEST_AMQP_VALUE, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
-    if (number_of_app_properties > 0)
+    if (has_diag_properties)
     {
         STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
     }
-    if (has_diag_properties)
+}
+
+static void set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message(size_t number_of_app_properties, IOTHUBMESSAGE_CONTENT_TYPE msg_content_type, bool has_message_id, bool has_correlation_id, bool has_diag_properties, const char* content_type, const char* content_encoding)
+{
+    set_exp_calls_for_create_encoded_message_properties(has_message_id, has_correlation_id, content_type, content_encoding);
+    set_exp_calls_for_create_encoded_application_properties(number_of_app_properties);
+    set_exp_calls_for_create_encoded_annotations_properties(has_diag_properties);
+    set_exp_calls_for_create_encoded_data(msg_content_type);
+
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(g_encoding_buffer);
+
+    set_exp_calls_for_encode_and_destroy_values(has_diag_properties);
+}
+
+static void set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message_in_buffer(size_t encode_buffer_length, bool enlarge_buffer)
+{
+    set_exp_calls_for_create_encoded_message_properties(true, true, TEST_CONTENT_TYPE, TEST_CONTENT_ENCODING);
+    set_exp_calls_for_create_encoded_application_properties(1);
+    set_exp_calls_for_create_encoded_annotations_properties(true);
+    set_exp_calls_for_create_encoded_data(IOTHUBMESSAGE_BYTEARRAY);
+
+    STRICT_EXPECTED_CALL(BUFFER_length(TEST_ENCODE_BUFFER_HANDLE)).SetReturn(encode_buffer_length);
+    if (enlarge_buffer)
     {
-        STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
+        STRICT_EXPECTED_CALL(BUFFER_enlarge(TEST_ENCODE_BUFFER_HANDLE, IGNORED_NUM_ARG));
     }
-    STRICT_EXPECTED_CALL(amqpvalue_destroy(TEST_AMQP_VALUE));
+    STRICT_EXPECTED_CALL(BUFFER_u_char(TEST_ENCODE_BUFFER_HANDLE)).SetReturn((unsigned char*)g_encoding_buffer);
+
+    set_exp_calls_for_encode_and_destroy_values(true);
 }
 
 static void set_exp_calls_for_message_create_IoTHubMessage_from_uamqp_message(
@@ -523,6 +495,8 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUBMESSAGE_CONTENT_TYPE, int);
     REGISTER_UMOCK_ALIAS_TYPE(IOTHUB_MESSAGE_RESULT, void*);
     REGISTER_UMOCK_ALIAS_TYPE(MESSAGE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(unsigned char*, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PROPERTIES_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(BINARY_DATA, void*); /*????*/
     REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
@@ -882,6 +856,108 @@ TEST_FUNCTION(message_create_from_iothub_message_no_content_encoding_success)
     // cleanup
 }
 
+// Tests_SRS_UAMQP_MESSAGING_09_110: [If `encode_buffer` is NULL, message_create_uamqp_encoding_from_iothub_message_in_buffer shall fail and return a non-zero value]
+TEST_FUNCTION(message_create_uamqp_encoding_from_iothub_message_in_buffer_NULL_buffer_fails)
+{
+    // arrange
+    BINARY_DATA binary_data;
+    memset(&binary_data, 0, sizeof(binary_data));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = message_create_uamqp_encoding_from_iothub_message_in_buffer(NULL, TEST_IOTHUB_MESSAGE_HANDLE, NULL, &binary_data);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, result, 0);
+}
+
+// Tests_SRS_UAMQP_MESSAGING_09_111: [If `encode_buffer` is smaller than the encoded message it shall be enlarged using BUFFER_enlarge, to at least twice its current size]
+TEST_FUNCTION(message_create_uamqp_encoding_from_iothub_message_in_buffer_enlarges_buffer)
+{
+    // arrange
+    BINARY_DATA binary_data;
+    memset(&binary_data, 0, sizeof(binary_data));
+    umock_c_reset_all_calls();
+    set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message_in_buffer(0, true);
+
+    // act
+    int result = message_create_uamqp_encoding_from_iothub_message_in_buffer(NULL, TEST_IOTHUB_MESSAGE_HANDLE, TEST_ENCODE_BUFFER_HANDLE, &binary_data);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, result, 0);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)g_encoding_buffer, (void*)binary_data.bytes);
+    ASSERT_ARE_EQUAL(int, TEST_MESSAGE_ENCODING_SIZE, (int)binary_data.length);
+}
+
+// Tests_SRS_UAMQP_MESSAGING_09_112: [`body_binary_data` shall point to the contents of `encode_buffer`, and no memory shall be allocated if it is already large enough]
+TEST_FUNCTION(message_create_uamqp_encoding_from_iothub_message_in_buffer_reuses_buffer)
+{
+    // arrange
+    BINARY_DATA binary_data;
+    memset(&binary_data, 0, sizeof(binary_data));
+    umock_c_reset_all_calls();
+    set_exp_calls_for_message_create_uamqp_encoding_from_iothub_message_in_buffer(TEST_MESSAGE_ENCODING_SIZE, false);
+
+    // act
+    int result = message_create_uamqp_encoding_from_iothub_message_in_buffer(NULL, TEST_IOTHUB_MESSAGE_HANDLE, TEST_ENCODE_BUFFER_HANDLE, &binary_data);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, result, 0);
+    ASSERT_ARE_EQUAL(void_ptr, (void*)g_encoding_buffer, (void*)binary_data.bytes);
+}
+
+// Tests_SRS_UAMQP_MESSAGING_09_113: [The message properties and application properties shall be encoded straight into the output buffer, as the AMQP `properties` list and `application-properties` map, without creating intermediate AMQP_VALUEs]
+TEST_FUNCTION(message_create_uamqp_encoding_from_iothub_message_encodes_properties_in_place)
+{
+    // arrange
+    static const unsigned char expected_message_properties[] = {
+        0x00, 0x53, 0x73, 0xC0, 0x0E, 0x07,
+        0xA1, 0x02, 'i', 'd',
+        0x40, 0x40, 0x40, 0x40, 0x40,
+        0xA3, 0x02, 'c', 't' };
+    static const unsigned char expected_application_properties[] = {
+        0x00, 0x53, 0x74, 0xC1, 0x07, 0x02,
+        0xA1, 0x01, 'k',
+        0xA1, 0x01, 'v' };
+    char* keys[] = { "k" };
+    char* values[] = { "v" };
+    char** test_keys = keys;
+    char** test_values = values;
+    size_t number_of_app_properties = 1;
+    BINARY_DATA binary_data;
+    memset(&binary_data, 0, sizeof(binary_data));
+    memset(g_encoding_buffer, 0, sizeof(g_encoding_buffer));
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetMessageId(TEST_IOTHUB_MESSAGE_HANDLE)).SetReturn("id");
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetCorrelationId(TEST_IOTHUB_MESSAGE_HANDLE)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetContentTypeSystemProperty(TEST_IOTHUB_MESSAGE_HANDLE)).SetReturn("ct");
+    STRICT_EXPECTED_CALL(IoTHubMessage_GetContentEncodingSystemProperty(TEST_IOTHUB_MESSAGE_HANDLE)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(IoTHubMessage_Properties(TEST_IOTHUB_MESSAGE_HANDLE));
+    STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer(2, &test_keys, sizeof(test_keys))
+        .CopyOutArgumentBuffer(3, &test_values, sizeof(test_values))
+        .CopyOutArgumentBuffer(4, &number_of_app_properties, sizeof(number_of_app_properties));
+    set_exp_calls_for_create_encoded_annotations_properties(false);
+    set_exp_calls_for_create_encoded_data(IOTHUBMESSAGE_BYTEARRAY);
+    STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+        .SetReturn(g_encoding_buffer);
+    set_exp_calls_for_encode_and_destroy_values(false);
+
+    // act
+    int result = message_create_uamqp_encoding_from_iothub_message(NULL, TEST_IOTHUB_MESSAGE_HANDLE, &binary_data);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, result, 0);
+    ASSERT_ARE_EQUAL(int, sizeof(expected_message_properties) + sizeof(expected_application_properties) + TEST_AMQP_ENCODING_SIZE, (int)binary_data.length);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(g_encoding_buffer, expected_message_properties, sizeof(expected_message_properties)));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(g_encoding_buffer + sizeof(expected_message_properties), expected_application_properties, sizeof(expected_application_properties)));
+}
+
 // Tests_SRS_UAMQP_MESSAGING_31_120: [Create a blob that contains AMQP encoding of IOTHUB_MESSAGE_HANDLE.  Errors stop processing on this message.]
 // Tests_SRS_UAMQP_MESSAGING_31_121: [Any errors during `message_create_uamqp_encoding_from_iothub_message` stop processing on this message.]
 TEST_FUNCTION(message_create_from_iothub_message_BYTEARRAY_return_errors_fails)
@@ -904,27 +980,19 @@ TEST_FUNCTION(message_create_from_iothub_message_BYTEARRAY_return_errors_fails)
         umock_c_negative_tests_reset();
         umock_c_negative_tests_fail_call(i);
 
-        if ((i == 1) || // GetMessageId is optional
-            (i == 5) || //GetCorrelationId is optional
-            (i == 9) || // ContentType is optional 
-            (i == 11) ||  // ContentEncoding is optional
-            (i == 4) || // amqpvalue_destroy
-            (i == 8) || // amqpvalue_destroy
-            (i == 15) || // properties_destroy
+        if ((i == 0) || // GetMessageId is optional
+            (i == 1) || // GetCorrelationId is optional
+            (i == 2) || // ContentType is optional
+            (i == 3) || // ContentEncoding is optional
+            (i == 6) || // IoTHubMessage_GetDiagnosticPropertyData is optional
+            (i == 11) || // amqpvalue_destroy
+            (i == 12) || // amqpvalue_destroy
+            (i == 17) || // amqpvalue_destroy
+            (i == 18) || // amqpvalue_destroy
+            (i == 21) || // free
             (i == 22) || // amqpvalue_destroy
-            (i == 23) || // amqpvalue_destroy
-            (i == 26) || // amqpvalue_destroy
-            (i == 27) || //IoTHubMessage_GetDiagnosticPropertyData is optional
-            (i == 32) || // amqpvalue_destroy
-            (i == 33) || // amqpvalue_destroy
-            (i == 38) || // amqpvalue_destroy
-            (i == 39) || // amqpvalue_destroy
-            (i == 42) || // free
-            (i == 43) || // amqpvalue_destroy
-            (i == 53) || // amqpvalue_destroy
-            (i == 54) || // amqpvalue_destroy
-            (i == 55) || // amqpvalue_destroy
-            (i == 56) // amqpvalue_destroy
+            (i == 30) || // amqpvalue_destroy
+            (i == 31) // amqpvalue_destroy
             )
         {
             continue; // these lines have functions that do not return anything (void).
@@ -967,27 +1035,19 @@ TEST_FUNCTION(message_create_from_iothub_message_STRING_return_errors_fails)
         umock_c_negative_tests_reset();
         umock_c_negative_tests_fail_call(i);
 
-        if ((i == 1) || // GetMessageId is optional
-            (i == 5) || //GetCorrelationId is optional
-            (i == 9) || // ContentType is optional 
-            (i == 11) ||  // ContentEncoding is optional
-            (i == 4) || // amqpvalue_destroy
-            (i == 8) || // amqpvalue_destroy
-            (i == 15) || // properties_destroy
+        if ((i == 0) || // GetMessageId is optional
+            (i == 1) || // GetCorrelationId is optional
+            (i == 2) || // ContentType is optional
+            (i == 3) || // ContentEncoding is optional
+            (i == 6) || // IoTHubMessage_GetDiagnosticPropertyData is optional
+            (i == 11) || // amqpvalue_destroy
+            (i == 12) || // amqpvalue_destroy
+            (i == 17) || // amqpvalue_destroy
+            (i == 18) || // amqpvalue_destroy
+            (i == 21) || // free
             (i == 22) || // amqpvalue_destroy
-            (i == 23) || // amqpvalue_destroy
-            (i == 26) || // amqpvalue_destroy
-            (i == 27) || //IoTHubMessage_GetDiagnosticPropertyData is optional
-            (i == 32) || // amqpvalue_destroy
-            (i == 33) || // amqpvalue_destroy
-            (i == 38) || // amqpvalue_destroy
-            (i == 39) || // amqpvalue_destroy
-            (i == 42) || // free
-            (i == 43) || // amqpvalue_destroy
-            (i == 53) || // amqpvalue_destroy
-            (i == 54) || // amqpvalue_destroy
-            (i == 55) || // amqpvalue_destroy
-            (i == 56) // amqpvalue_destroy
+            (i == 30) || // amqpvalue_destroy
+            (i == 31) // amqpvalue_destroy
            )
         {
             continue; // these lines have functions that do not return anything (void).
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CBORDECODER_H
+#define CBORDECODER_H
+
+#include "azure_c_shared_utility/buffer_.h"
+#include "multitree.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/*has the signature of DATA_SERIALIZER_DECODE_FUNC so it can be passed to DataSerializer_Decode*/
+/*the leaves of the produced MULTITREE_HANDLE are AGENT_DATA_TYPE**/
+MOCKABLE_FUNCTION(, MULTITREE_HANDLE, CBORDecoder_DecodeTree, BUFFER_HANDLE, decodeData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBORDECODER_H */
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CBORENCODER_H
+#define CBORENCODER_H
+
+#include "azure_c_shared_utility/buffer_.h"
+#include "multitree.h"
+#include "dataserializer.h"
+
+#ifdef __cplusplus
+#include <cstddef>
+extern "C" {
+#else
+#include <stddef.h>
+#endif
+
+/*content type of the payloads produced by CBOREncoder_EncodeTree (RFC 7049)*/
+#define CBOR_ENCODER_CONTENT_TYPE "application/cbor"
+
+#include "azure_c_shared_utility/umock_c_prod.h"
+
+/*has the signature of DATA_SERIALIZER_ENCODE_FUNC so it can be passed to DataSerializer_Encode*/
+MOCKABLE_FUNCTION(, BUFFER_HANDLE, CBOREncoder_EncodeTree, MULTITREE_HANDLE, treeHandle, DATA_SERIALIZER_MULTITREE_TYPE, dataType);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBORENCODER_H */
@@ -106,6 +106,7 @@ typedef struct REFLECTION_DESIRED_PROPERTY_TAG
     const char* name;
     const char* type;
     int(*FromAGENT_DATA_TYPE)(const AGENT_DATA_TYPE* source, void* dest); /*destination is "something" everytime. When the DESIRED_PROPERTY is a MODEL, the function is empty*/
+    int(*ToAGENT_DATA_TYPE)(const void* source, AGENT_DATA_TYPE* dest); /*reads the desired property back out of the device memory*/
     size_t offset;
     size_t size;
     const char* modelName;
@@ -179,8 +180,11 @@ MOCKABLE_FUNCTION(, void, CodeFirst_DestroyDevice, void*, device);
 
 extern CODEFIRST_RESULT CodeFirst_SendAsync(unsigned char** destination, size_t* destinationSize, size_t numProperties, ...);
 extern CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, ...);
+extern CODEFIRST_RESULT CodeFirst_SendAsyncReportedChanges(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, ...);
+MOCKABLE_FUNCTION(, CODEFIRST_RESULT, CodeFirst_ResetReportedPropertiesChanges, void*, device);
 
 MOCKABLE_FUNCTION(, CODEFIRST_RESULT, CodeFirst_IngestDesiredProperties, void*, device, const char*, jsonPayload, bool, parseDesiredNode);
+MOCKABLE_FUNCTION(, CODEFIRST_RESULT, CodeFirst_IngestDesiredPropertiesChanges, void*, device, const char*, jsonPayload, bool, parseDesiredNode);
 
 MOCKABLE_FUNCTION(, AGENT_DATA_TYPE_TYPE, CodeFirst_GetPrimitiveType, const char*, typeName);
 
@@ -35,10 +35,14 @@ DEFINE_ENUM(JSON_ENCODER_TOSTRING_RESULT, JSON_ENCODER_TOSTRING_RESULT_VALUES);
 
 typedef JSON_ENCODER_TOSTRING_RESULT(*JSON_ENCODER_TOSTRING_FUNC)(STRING_HANDLE, const void* value);
 
+/*produces the name and the value of the index-th member of the object encoded by JSONEncoder_EncodeObject*/
+typedef void(*JSON_ENCODER_GET_MEMBER_FUNC)(const void* members, size_t index, const char** name, const void** value);
+
 #include "azure_c_shared_utility/umock_c_prod.h"
 
 MOCKABLE_FUNCTION(, JSON_ENCODER_TOSTRING_RESULT, JSONEncoder_CharPtr_ToString, STRING_HANDLE, destination, const void*, value);
 MOCKABLE_FUNCTION(, JSON_ENCODER_RESULT, JSONEncoder_EncodeTree, MULTITREE_HANDLE, treeHandle, STRING_HANDLE, destination, JSON_ENCODER_TOSTRING_FUNC, toStringFunc);
+MOCKABLE_FUNCTION(, JSON_ENCODER_RESULT, JSONEncoder_EncodeObject, const void*, members, size_t, memberCount, JSON_ENCODER_GET_MEMBER_FUNC, getMember, STRING_HANDLE, destination, JSON_ENCODER_TOSTRING_FUNC, toStringFunc);
 
 #ifdef __cplusplus
 }
@@ -309,6 +309,25 @@ extern "C"
 
 #define SERIALIZE_REPORTED_PROPERTIES(destination, destinationSize,...) CodeFirst_SendAsyncReported(destination, destinationSize, COUNT_ARG(__VA_ARGS__) FOR_EACH_1(ADDRESS_MACRO, __VA_ARGS__))
 
+/**
+ * @def SERIALIZE_CHANGED_REPORTED_PROPERTIES(destination, destinationSize, ...)
+ * Same as SERIALIZE_REPORTED_PROPERTIES, but the JSON only contains the reported properties (and the
+ * members of model reported properties) whose value changed since they were last serialized by
+ * SERIALIZE_CHANGED_REPORTED_PROPERTIES for the same device. When nothing changed, it still returns
+ * CODEFIRST_OK but destination is set to NULL and destinationSize to 0: there is nothing to send.
+ * The values are remembered as soon as they are serialized; if sending the reported state fails, call
+ * RESET_CHANGED_REPORTED_PROPERTIES so the next call serializes all the reported properties again.
+ */
+#define SERIALIZE_CHANGED_REPORTED_PROPERTIES(destination, destinationSize,...) CodeFirst_SendAsyncReportedChanges(destination, destinationSize, COUNT_ARG(__VA_ARGS__) FOR_EACH_1(ADDRESS_MACRO, __VA_ARGS__))
+
+/**
+ * @def RESET_CHANGED_REPORTED_PROPERTIES(device)
+ * Forgets the reported property values remembered by SERIALIZE_CHANGED_REPORTED_PROPERTIES for the device.
+ *
+ * @param   device      return of CREATE_MODEL_INSTANCE.
+ */
+#define RESET_CHANGED_REPORTED_PROPERTIES(device) CodeFirst_ResetReportedPropertiesChanges(device)
+
 
 #define IDENTITY_MACRO(x) ,x
 #define SERIALIZE_REPORTED_PROPERTIES_FROM_POINTERS(destination, destinationSize, ...) CodeFirst_SendAsyncReported(destination, destinationSize, COUNT_ARG(__VA_ARGS__) FOR_EACH_1(IDENTITY_MACRO, __VA_ARGS__))
@@ -344,6 +363,18 @@ extern "C"
 */
 #define INGEST_DESIRED_PROPERTIES(device, jsonPayload, parseDesiredNode) (CodeFirst_IngestDesiredProperties(device, jsonPayload, parseDesiredNode))
 
+/**
+* @def   INGEST_DESIRED_PROPERTIES_CHANGES(device, jsonPayload, parseDesiredNode)
+*
+* Same as INGEST_DESIRED_PROPERTIES, but only the desired properties whose value differs from the one
+* currently in the device are written and have their callbacks called.
+*
+* @param   device                return of CodeFirst_CreateDevice.
+* @param   jsonPayload           a null terminated string containing in JSON format the desired properties (complete or a patch)
+* @param   parseDesiredNode      true if the desired properties are under a "desired" node in jsonPayload
+*/
+#define INGEST_DESIRED_PROPERTIES_CHANGES(device, jsonPayload, parseDesiredNode) (CodeFirst_IngestDesiredPropertiesChanges(device, jsonPayload, parseDesiredNode))
+
 /* Helper macros */
 
 /* These macros remove a useless comma from the beginning of an argument list that looks like:
@@ -452,7 +483,7 @@ Actions are discarded, since no marshalling will be done for those when sending
 
 
 #define REFLECTED_DESIRED_PROPERTY_WITH_ON_DESIRED_PROPERTY_CHANGE(type, name, modelName, COUNTER, onDesiredPropertyChange) \
-    static const REFLECTED_SOMETHING C2(REFLECTED_, C1(INC(COUNTER))) =      { REFLECTION_DESIRED_PROPERTY_TYPE,     &C2(REFLECTED_, C1(DEC(COUNTER))),         { {0}, {onDesiredPropertyChange, DesiredPropertyInitialize_##modelName##name, DesiredPropertyDeinitialize_##modelName##name, TOSTRING(name), TOSTRING(type), (int(*)(const AGENT_DATA_TYPE*, void*))FromAGENT_DATA_TYPE_##type, offsetof(modelName, name), sizeof(type), TOSTRING(modelName)}, {0}, {0}, {0}, {0}, {0}, {0}} };
+    static const REFLECTED_SOMETHING C2(REFLECTED_, C1(INC(COUNTER))) =      { REFLECTION_DESIRED_PROPERTY_TYPE,     &C2(REFLECTED_, C1(DEC(COUNTER))),         { {0}, {onDesiredPropertyChange, DesiredPropertyInitialize_##modelName##name, DesiredPropertyDeinitialize_##modelName##name, TOSTRING(name), TOSTRING(type), (int(*)(const AGENT_DATA_TYPE*, void*))FromAGENT_DATA_TYPE_##type, DesiredPropertyToAGENT_DATA_TYPE_##modelName##name, offsetof(modelName, name), sizeof(type), TOSTRING(modelName)}, {0}, {0}, {0}, {0}, {0}, {0}} };
 
 #define REFLECTED_DESIRED_PROPERTY(type, name, modelName, ...)                                                              \
     IF(COUNT_ARG(__VA_ARGS__),                                                                                              \
@@ -557,6 +588,10 @@ Actions are discarded, since no marshalling will be done for those when sending
     {                                                                                                   \
        GlobalDeinitialize_##propertyType(destination);                                                  \
     }                                                                                                   \
+    static int DesiredPropertyToAGENT_DATA_TYPE_##modelName##propertyName(const void* source, AGENT_DATA_TYPE* dest)   \
+    {                                                                                                   \
+        return C1(ToAGENT_DATA_TYPE_##propertyType)(dest, *(const propertyType*)source);                \
+    }                                                                                                   \
     REFLECTED_DESIRED_PROPERTY(propertyType, propertyName, modelName, __VA_ARGS__)          \
 
 #define CREATE_MODEL_ACTION(modelName, actionName, ...) \
@@ -17,6 +17,7 @@
 #include <math.h>
 #include <limits.h>
 #include <errno.h>
+#include <string.h>
 
 /*if ULLONG_MAX is defined by limits.h for whatever reasons... */
 #ifndef ULLONG_MAX
@@ -48,16 +49,18 @@
 
 #define GUID_STRING_LENGTH 38
 
-// This is an artificial upper limit on floating point string length
-// (e.g. the size of the string when printing %f). It is set to twice the
-// maximum decimal precision plus 2. 1 for the decimal point and 1 for a
-// sign (+/-)
-// Unfortunately it is quite possible to print a float larger than this.
-// An example of this would be printf("%.*f", MAX_FLOATING_POINT_STRING_LENGTH, 1.3);
-// But currently no explicit requests for this exist in the file nor are
-// any expected to reasonably occur when being used (numbers that hit
-// this limit would be experiencing significant precision loss in storage anyway.
-#define MAX_FLOATING_POINT_STRING_LENGTH (DECIMAL_DIG *2 + 2)
+// The shortest text that converts back to the same double has at most 17
+// significant digits. Together with a sign, a decimal point, up to 3 leading
+// zeros (0.000ddd) or an exponent (e-308) and '\0' it fits comfortably in 32.
+#define MAX_FLOATING_POINT_STRING_SIZE 32
+
+// Doubles whose decimal point falls within this many digits of the first
+// significant digit are written in fixed notation, the others use an exponent
+#define MAX_FIXED_NOTATION_DIGITS DBL_DIG
+#define MIN_FIXED_NOTATION_EXPONENT (-4)
+
+// '-' and 19 digits for INT64_MIN and '\0'
+#define MAX_INT64_STRING_SIZE 21
 
 // This maximum length is 11 for 32 bit integers (including the sign)
 // optionally increase to 21 if longs are 64 bit
@@ -70,6 +73,429 @@ DEFINE_ENUM_STRINGS(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_RESULT_VALUES);
 
 static int ValidateDate(int year, int month, int day);
 
+/*two ASCII digits for every number from 0 to 99, so integers are formatted two digits per division*/
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*writes the digits of value so that they end right before bufferEnd and returns where they start*/
+static char* formatUInt64Backwards(char* bufferEnd, uint64_t value)
+{
+    char* position = bufferEnd;
+    while (value >= 100)
+    {
+        size_t pair = (size_t)(value % 100) * 2;
+        value /= 100;
+        *--position = digitPairs[pair + 1];
+        *--position = digitPairs[pair];
+    }
+
+    if (value >= 10)
+    {
+        size_t pair = (size_t)value * 2;
+        *--position = digitPairs[pair + 1];
+        *--position = digitPairs[pair];
+    }
+    else
+    {
+        *--position = (char)('0' + value);
+    }
+    return position;
+}
+
+/*formats value at the end of buffer and returns the start of the '\0' terminated text*/
+static const char* formatInt64(char buffer[MAX_INT64_STRING_SIZE], int64_t value)
+{
+    char* result;
+    /*the magnitude is computed in unsigned arithmetic so that INT64_MIN does not overflow*/
+    uint64_t magnitude = (value < 0) ? (0 - (uint64_t)value) : (uint64_t)value;
+
+    buffer[MAX_INT64_STRING_SIZE - 1] = '\0';
+    result = formatUInt64Backwards(buffer + MAX_INT64_STRING_SIZE - 1, magnitude);
+    if (value < 0)
+    {
+        *--result = '-';
+    }
+    return result;
+}
+
+#ifndef NO_FLOATS
+/*the following implement Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010)*/
+/*it produces the shortest (or in very rare cases a near shortest) text that converts back to the exact same value, using only integer arithmetic*/
+typedef struct DIY_FP_TAG
+{
+    uint64_t f;
+    int e;
+} DIY_FP;
+
+typedef struct CACHED_POWER_TAG
+{
+    uint64_t f;
+    int e;
+    int k;
+} CACHED_POWER;
+
+/*normalized and rounded 64 bit approximations of 10^k for k = -300, -292, ..., 324*/
+static const CACHED_POWER cachedPowers[] =
+{
+    { 0xAB70FE17C79AC6CA, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+    { 0xBE5691EF416BD60C, -1007, -284 },
+    { 0x8DD01FAD907FFC3C, -980, -276 },
+    { 0xD3515C2831559A83, -954, -268 },
+    { 0x9D71AC8FADA6C9B5, -927, -260 },
+    { 0xEA9C227723EE8BCB, -901, -252 },
+    { 0xAECC49914078536D, -874, -244 },
+    { 0x823C12795DB6CE57, -847, -236 },
+    { 0xC21094364DFB5637, -821, -228 },
+    { 0x9096EA6F3848984F, -794, -220 },
+    { 0xD77485CB25823AC7, -768, -212 },
+    { 0xA086CFCD97BF97F4, -741, -204 },
+    { 0xEF340A98172AACE5, -715, -196 },
+    { 0xB23867FB2A35B28E, -688, -188 },
+    { 0x84C8D4DFD2C63F3B, -661, -180 },
+    { 0xC5DD44271AD3CDBA, -635, -172 },
+    { 0x936B9FCEBB25C996, -608, -164 },
+    { 0xDBAC6C247D62A584, -582, -156 },
+    { 0xA3AB66580D5FDAF6, -555, -148 },
+    { 0xF3E2F893DEC3F126, -529, -140 },
+    { 0xB5B5ADA8AAFF80B8, -502, -132 },
+    { 0x87625F056C7C4A8B, -475, -124 },
+    { 0xC9BCFF6034C13053, -449, -116 },
+    { 0x964E858C91BA2655, -422, -108 },
+    { 0xDFF9772470297EBD, -396, -100 },
+    { 0xA6DFBD9FB8E5B88F, -369, -92 },
+    { 0xF8A95FCF88747D94, -343, -84 },
+    { 0xB94470938FA89BCF, -316, -76 },
+    { 0x8A08F0F8BF0F156B, -289, -68 },
+    { 0xCDB02555653131B6, -263, -60 },
+    { 0x993FE2C6D07B7FAC, -236, -52 },
+    { 0xE45C10C42A2B3B06, -210, -44 },
+    { 0xAA242499697392D3, -183, -36 },
+    { 0xFD87B5F28300CA0E, -157, -28 },
+    { 0xBCE5086492111AEB, -130, -20 },
+    { 0x8CBCCC096F5088CC, -103, -12 },
+    { 0xD1B71758E219652C, -77, -4 },
+    { 0x9C40000000000000, -50, 4 },
+    { 0xE8D4A51000000000, -24, 12 },
+    { 0xAD78EBC5AC620000, 3, 20 },
+    { 0x813F3978F8940984, 30, 28 },
+    { 0xC097CE7BC90715B3, 56, 36 },
+    { 0x8F7E32CE7BEA5C70, 83, 44 },
+    { 0xD5D238A4ABE98068, 109, 52 },
+    { 0x9F4F2726179A2245, 136, 60 },
+    { 0xED63A231D4C4FB27, 162, 68 },
+    { 0xB0DE65388CC8ADA8, 189, 76 },
+    { 0x83C7088E1AAB65DB, 216, 84 },
+    { 0xC45D1DF942711D9A, 242, 92 },
+    { 0x924D692CA61BE758, 269, 100 },
+    { 0xDA01EE641A708DEA, 295, 108 },
+    { 0xA26DA3999AEF774A, 322, 116 },
+    { 0xF209787BB47D6B85, 348, 124 },
+    { 0xB454E4A179DD1877, 375, 132 },
+    { 0x865B86925B9BC5C2, 402, 140 },
+    { 0xC83553C5C8965D3D, 428, 148 },
+    { 0x952AB45CFA97A0B3, 455, 156 },
+    { 0xDE469FBD99A05FE3, 481, 164 },
+    { 0xA59BC234DB398C25, 508, 172 },
+    { 0xF6C69A72A3989F5C, 534, 180 },
+    { 0xB7DCBF5354E9BECE, 561, 188 },
+    { 0x88FCF317F22241E2, 588, 196 },
+    { 0xCC20CE9BD35C78A5, 614, 204 },
+    { 0x98165AF37B2153DF, 641, 212 },
+    { 0xE2A0B5DC971F303A, 667, 220 },
+    { 0xA8D9D1535CE3B396, 694, 228 },
+    { 0xFB9B7CD9A4A7443C, 720, 236 },
+    { 0xBB764C4CA7A44410, 747, 244 },
+    { 0x8BAB8EEFB6409C1A, 774, 252 },
+    { 0xD01FEF10A657842C, 800, 260 },
+    { 0x9B10A4E5E9913129, 827, 268 },
+    { 0xE7109BFBA19C0C9D, 853, 276 },
+    { 0xAC2820D9623BF429, 880, 284 },
+    { 0x80444B5E7AA7CF85, 907, 292 },
+    { 0xBF21E44003ACDD2D, 933, 300 },
+    { 0x8E679C2F5E44FF8F, 960, 308 },
+    { 0xD433179D9C8CB841, 986, 316 },
+    { 0x9E19DB92B4E31BA9, 1013, 324 }
+};
+
+#define CACHED_POWERS_MIN_DECIMAL_EXPONENT (-300)
+#define CACHED_POWERS_DECIMAL_STEP 8
+/*the cached power is chosen so that the scaled value has a binary exponent in [GRISU_ALPHA, GRISU_GAMMA]*/
+#define GRISU_ALPHA (-60)
+#define GRISU_GAMMA (-32)
+
+static DIY_FP makeDiyFp(uint64_t f, int e)
+{
+    DIY_FP result;
+    result.f = f;
+    result.e = e;
+    return result;
+}
+
+/*the product of x and y rounded to 64 bits, computed from 32 bit halves*/
+static DIY_FP multiplyDiyFp(DIY_FP x, DIY_FP y)
+{
+    uint64_t xLow = x.f & 0xFFFFFFFFU;
+    uint64_t xHigh = x.f >> 32;
+    uint64_t yLow = y.f & 0xFFFFFFFFU;
+    uint64_t yHigh = y.f >> 32;
+
+    uint64_t p0 = xLow * yLow;
+    uint64_t p1 = xLow * yHigh;
+    uint64_t p2 = xHigh * yLow;
+    uint64_t p3 = xHigh * yHigh;
+
+    uint64_t middle = (p0 >> 32) + (p1 & 0xFFFFFFFFU) + (p2 & 0xFFFFFFFFU);
+    middle += (uint64_t)1 << 31; /*round*/
+
+    return makeDiyFp(p3 + (p2 >> 32) + (p1 >> 32) + (middle >> 32), x.e + y.e + 64);
+}
+
+static DIY_FP normalizeDiyFp(DIY_FP x)
+{
+    while ((x.f >> 63) == 0)
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+/*value is (fraction + hidden bit) * 2^(biasedExponent - bias); computes it normalized together with the normalized midpoints to its neighbours*/
+static void computeBoundaries(uint64_t fraction, int biasedExponent, int precision, int bias, DIY_FP* v, DIY_FP* minus, DIY_FP* plus)
+{
+    DIY_FP value = (biasedExponent == 0) ?
+        makeDiyFp(fraction, 1 - bias) : /*subnormal*/
+        makeDiyFp(fraction + ((uint64_t)1 << (precision - 1)), biasedExponent - bias);
+    /*the lower neighbour is closer when the value is a power of 2 (other than the smallest normal)*/
+    bool lowerBoundaryIsCloser = (fraction == 0) && (biasedExponent > 1);
+    DIY_FP lower = lowerBoundaryIsCloser ?
+        makeDiyFp(4 * value.f - 1, value.e - 2) :
+        makeDiyFp(2 * value.f - 1, value.e - 1);
+
+    *plus = normalizeDiyFp(makeDiyFp(2 * value.f + 1, value.e - 1));
+    minus->f = lower.f << (lower.e - plus->e);
+    minus->e = plus->e;
+    *v = normalizeDiyFp(value);
+}
+
+static CACHED_POWER getCachedPower(int binaryExponent)
+{
+    /*k = ceil((GRISU_ALPHA - binaryExponent - 1) * log10(2)), 78913 / 2^18 approximates log10(2)*/
+    int f = GRISU_ALPHA - binaryExponent - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+    int index = (-CACHED_POWERS_MIN_DECIMAL_EXPONENT + k + (CACHED_POWERS_DECIMAL_STEP - 1)) / CACHED_POWERS_DECIMAL_STEP;
+    return cachedPowers[index];
+}
+
+/*returns the number of decimal digits of n and the largest power of 10 not greater than n*/
+static int findLargestPow10(uint32_t n, uint32_t* pow10)
+{
+    int result;
+    *pow10 = 1000000000U;
+    result = 10;
+    while ((result > 1) && (n < *pow10))
+    {
+        *pow10 /= 10;
+        result--;
+    }
+    return result;
+}
+
+/*moves the last digit closer to the exact value while it stays inside the rounding interval*/
+static void grisuRound(char* buffer, int length, uint64_t distance, uint64_t delta, uint64_t rest, uint64_t tenK)
+{
+    while ((rest < distance) &&
+        (delta - rest >= tenK) &&
+        ((rest + tenK < distance) || (distance - rest > rest + tenK - distance)))
+    {
+        buffer[length - 1]--;
+        rest += tenK;
+    }
+}
+
+/*generates the digits of the shortest number in [minus, plus], with minus, w and plus scaled by the cached power*/
+static void grisuGenerateDigits(char* buffer, int* length, int* decimalExponent, DIY_FP minus, DIY_FP w, DIY_FP plus)
+{
+    uint64_t delta = plus.f - minus.f;
+    uint64_t distance = plus.f - w.f;
+    int shift = -plus.e;
+    uint64_t one = (uint64_t)1 << shift;
+    uint32_t integral = (uint32_t)(plus.f >> shift);
+    uint64_t fractional = plus.f & (one - 1);
+    uint32_t pow10;
+    int n = findLargestPow10(integral, &pow10);
+
+    *length = 0;
+    while (n > 0)
+    {
+        uint64_t rest;
+        buffer[(*length)++] = (char)('0' + integral / pow10);
+        integral %= pow10;
+        n--;
+
+        rest = ((uint64_t)integral << shift) + fractional;
+        if (rest <= delta)
+        {
+            *decimalExponent += n;
+            grisuRound(buffer, *length, distance, delta, rest, (uint64_t)pow10 << shift);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    for (;;)
+    {
+        fractional *= 10;
+        buffer[(*length)++] = (char)('0' + (fractional >> shift));
+        fractional &= one - 1;
+        (*decimalExponent)--;
+        delta *= 10;
+        distance *= 10;
+        if (fractional <= delta)
+        {
+            break;
+        }
+    }
+    grisuRound(buffer, *length, distance, delta, fractional, one);
+}
+
+/*writes the exponent as e, sign and at least 2 digits; returns the position after it*/
+static char* formatExponent(char* position, int exponent)
+{
+    *position++ = 'e';
+    if (exponent < 0)
+    {
+        *position++ = '-';
+        exponent = -exponent;
+    }
+    else
+    {
+        *position++ = '+';
+    }
+
+    if (exponent >= 100)
+    {
+        *position++ = (char)('0' + exponent / 100);
+        exponent %= 100;
+    }
+    *position++ = digitPairs[exponent * 2];
+    *position++ = digitPairs[exponent * 2 + 1];
+    return position;
+}
+
+/*turns the length digits in buffer meaning digits * 10^decimalExponent into a '\0' terminated doubleValue*/
+static void formatDecimalDigits(char* buffer, int length, int decimalExponent)
+{
+    /*position of the decimal point relative to the first digit*/
+    int n = length + decimalExponent;
+    char* end;
+
+    if ((length <= n) && (n <= MAX_FIXED_NOTATION_DIGITS))
+    {
+        /*digits followed by zeros: 1234000.0*/
+        (void)memset(buffer + length, '0', n - length);
+        buffer[n] = '.';
+        buffer[n + 1] = '0';
+        end = buffer + n + 2;
+    }
+    else if ((0 < n) && (n <= MAX_FIXED_NOTATION_DIGITS))
+    {
+        /*decimal point among the digits: 12.34*/
+        (void)memmove(buffer + n + 1, buffer + n, length - n);
+        buffer[n] = '.';
+        end = buffer + length + 1;
+    }
+    else if ((MIN_FIXED_NOTATION_EXPONENT < n) && (n <= 0))
+    {
+        /*leading zeros: 0.001234*/
+        (void)memmove(buffer + 2 - n, buffer, length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        (void)memset(buffer + 2, '0', -n);
+        end = buffer + 2 - n + length;
+    }
+    else
+    {
+        /*scientific notation: 1.234e+300*/
+        if (length == 1)
+        {
+            end = buffer + 1;
+        }
+        else
+        {
+            (void)memmove(buffer + 2, buffer + 1, length - 1);
+            buffer[1] = '.';
+            end = buffer + length + 1;
+        }
+        end = formatExponent(end, n - 1);
+    }
+    *end = '\0';
+}
+
+/*formats a finite floating point number given by its IEEE 754 fields; destination shall hold MAX_FLOATING_POINT_STRING_SIZE characters*/
+static void formatFloatingPoint(char* destination, bool isNegative, uint64_t fraction, int biasedExponent, int precision, int bias)
+{
+    if (isNegative)
+    {
+        *destination++ = '-';
+    }
+
+    if ((fraction == 0) && (biasedExponent == 0))
+    {
+        (void)memcpy(destination, "0.0", sizeof("0.0"));
+    }
+    else
+    {
+        DIY_FP v;
+        DIY_FP minus;
+        DIY_FP plus;
+        DIY_FP cachedPower;
+        CACHED_POWER cached;
+        int length;
+        int decimalExponent;
+
+        computeBoundaries(fraction, biasedExponent, precision, bias, &v, &minus, &plus);
+        cached = getCachedPower(plus.e);
+        cachedPower = makeDiyFp(cached.f, cached.e);
+        decimalExponent = -cached.k;
+
+        v = multiplyDiyFp(v, cachedPower);
+        minus = multiplyDiyFp(minus, cachedPower);
+        plus = multiplyDiyFp(plus, cachedPower);
+        /*shrink the interval by 1 ulp on each side to account for the error of the multiplications*/
+        minus.f++;
+        plus.f--;
+
+        grisuGenerateDigits(destination, &length, &decimalExponent, minus, v, plus);
+        formatDecimalDigits(destination, length, decimalExponent);
+    }
+}
+
+static void formatDouble(char destination[MAX_FLOATING_POINT_STRING_SIZE], double value)
+{
+    uint64_t bits;
+    (void)memcpy(&bits, &value, sizeof(bits));
+    formatFloatingPoint(destination, (bits >> 63) != 0, bits & (((uint64_t)1 << 52) - 1), (int)((bits >> 52) & 0x7FF), 53, 1075);
+}
+
+static void formatSingle(char destination[MAX_FLOATING_POINT_STRING_SIZE], float value)
+{
+    uint32_t bits;
+    (void)memcpy(&bits, &value, sizeof(bits));
+    formatFloatingPoint(destination, (bits >> 31) != 0, bits & ((1U << 23) - 1), (int)((bits >> 23) & 0xFF), 24, 150);
+}
+#endif
+
 static int NoCloneFunction(void** destination, const void* source)
 {
     *destination = (void*)source;
@@ -1667,39 +2093,11 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
                 }
                 break;
             }
-            case (EDM_INT16_TYPE) :
+            case (EDM_INT16_TYPE):
             {
                 /*-32768 to +32767*/
-                char buffertemp2[7]; /*because 5 digits and sign and '\0'*/
-                uint16_t positiveValue;
-                size_t pos = 0;
-                uint16_t rank = (uint16_t)10000;
-                bool foundFirstDigit = false;
-
-                if (value->value.edmInt16.value < 0)
-                {
-                    buffertemp2[pos++] = '-';
-                    positiveValue = -value->value.edmInt16.value;
-                }
-                else
-                {
-                    positiveValue = value->value.edmInt16.value;
-                }
-
-                while (rank >= 10)
-                {
-                    if ((foundFirstDigit == true) || (positiveValue / rank) > 0)
-                    {
-                        buffertemp2[pos++] = '0' + (char)(positiveValue / rank);
-                        foundFirstDigit = true;
-                    }
-                    positiveValue %= rank;
-                    rank /= 10;
-                }
-                buffertemp2[pos++] = '0' + (char)(positiveValue);
-                buffertemp2[pos++] = '\0';
-                
-                if (STRING_concat(destination, buffertemp2) != 0)
+                char buffertemp2[MAX_INT64_STRING_SIZE];
+                if (STRING_concat(destination, formatInt64(buffertemp2, value->value.edmInt16.value)) != 0)
                 {
                     result = AGENT_DATA_TYPES_ERROR;
                     LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
@@ -1710,39 +2108,11 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
                 }
                 break;
             }
-            case (EDM_INT32_TYPE) :
+            case (EDM_INT32_TYPE):
             {
                 /*-2147483648 to +2147483647*/
-                char buffertemp2[12]; /*because 10 digits and sign and '\0'*/
-                uint32_t positiveValue;
-                size_t pos = 0;
-                uint32_t rank = 1000000000UL;
-                bool foundFirstDigit = false;
-
-                if (value->value.edmInt32.value < 0)
-                {
-                    buffertemp2[pos++] = '-';
-                    positiveValue = - value->value.edmInt32.value;
-                }
-                else
-                {
-                    positiveValue = value->value.edmInt32.value;
-                }
-
-                while (rank >= 10)
-                {
-                    if ((foundFirstDigit == true) || (positiveValue / rank) > 0)
-                    {
-                        buffertemp2[pos++] = '0' + (char)(positiveValue / rank);
-                        foundFirstDigit = true;
-                    }
-                    positiveValue %= rank;
-                    rank /= 10;
-                }
-                buffertemp2[pos++] = '0' + (char)(positiveValue);
-                buffertemp2[pos++] = '\0';
-                
-                if (STRING_concat(destination, buffertemp2) != 0)
+                char buffertemp2[MAX_INT64_STRING_SIZE];
+                if (STRING_concat(destination, formatInt64(buffertemp2, value->value.edmInt32.value)) != 0)
                 {
                     result = AGENT_DATA_TYPES_ERROR;
                     LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
@@ -1755,36 +2125,8 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
             }
             case (EDM_INT64_TYPE):
             {
-                char buffertemp2[21]; /*because 19 digits and sign and '\0'*/
-                uint64_t positiveValue;
-                size_t pos = 0;
-                uint64_t rank = 10000000000000000000ULL;
-                bool foundFirstDigit = false;
-
-                if (value->value.edmInt64.value < 0)
-                {
-                    buffertemp2[pos++] = '-';
-                    positiveValue = -value->value.edmInt64.value;
-                }
-                else
-                {
-                    positiveValue = value->value.edmInt64.value;
-                }
-
-                while (rank >= 10)
-                {
-                    if ((foundFirstDigit == true) || (positiveValue / rank) > 0)
-                    {
-                        buffertemp2[pos++] = '0' + (char)(positiveValue / rank);
-                        foundFirstDigit = true;
-                    }
-                    positiveValue %= rank;
-                    rank /= 10;
-                }
-                buffertemp2[pos++] = '0' + (char)(positiveValue);
-                buffertemp2[pos++] = '\0';
-
-                if (STRING_concat(destination, buffertemp2) != 0)
+                char buffertemp2[MAX_INT64_STRING_SIZE];
+                if (STRING_concat(destination, formatInt64(buffertemp2, value->value.edmInt64.value)) != 0)
                 {
                     result = AGENT_DATA_TYPES_ERROR;
                     LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
@@ -1955,7 +2297,6 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
                 /*C89 standard says: When a float is promoted to double or long double, or a double is promoted to long double, its value is unchanged*/
                 /*I read that as : when a float is NaN or Inf, it will stay NaN or INF in double representation*/
 
-                /*The sprintf function returns the number of characters written in the array, not counting the terminating null character.*/
 
                 if(ISNAN(value->value.edmSingle.value))
                 {
@@ -1995,38 +2336,23 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
                 }
                 else
                 {
-                    size_t tempBufferSize = MAX_FLOATING_POINT_STRING_LENGTH;
-                    char* tempBuffer = (char*)malloc(tempBufferSize);
-                    if (tempBuffer == NULL)
+                    char tempBuffer[MAX_FLOATING_POINT_STRING_SIZE];
+                    /*Codes_SRS_AGENT_TYPE_SYSTEM_99_112: [ EDM_SINGLE and EDM_DOUBLE values that are not NaN or infinite shall be written as the shortest doubleValue that converts back to the same value, independent of the current locale. ]*/
+                    formatSingle(tempBuffer, value->value.edmSingle.value);
+                    if (STRING_concat(destination, tempBuffer) != 0)
                     {
                         result = AGENT_DATA_TYPES_ERROR;
                         LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
                     }
                     else
                     {
-                        if (sprintf_s(tempBuffer, tempBufferSize, "%.*f", FLT_DIG, (double)(value->value.edmSingle.value)) < 0)
-                        {
-                            result = AGENT_DATA_TYPES_ERROR;
-                            LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
-                        }
-                        else if (STRING_concat(destination, tempBuffer) != 0)
-                        {
-                            result = AGENT_DATA_TYPES_ERROR;
-                            LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
-                        }
-                        else
-                        {
-                            result = AGENT_DATA_TYPES_OK;
-                        }
-
-                        free(tempBuffer);
+                        result = AGENT_DATA_TYPES_OK;
                     }
                 }
                 break;
             }
             case(EDM_DOUBLE_TYPE):
             {
-                /*The sprintf function returns the number of characters written in the array, not counting the terminating null character.*/
                 /*OData-ABNF says these can be used: nanInfinity = 'NaN' / '-INF' / 'INF'*/
                 /*C90 doesn't declare a NaN or Inf in the standard, however, values might be NaN or Inf...*/
                 /*C99 ... does*/
@@ -2073,31 +2399,17 @@ AGENT_DATA_TYPES_RESULT AgentDataTypes_ToString(STRING_HANDLE destination, const
                 /*Codes_SRS_AGENT_TYPE_SYSTEM_99_022:[ EDM_DOUBLE: doubleValue = decimalValue [ "e" [SIGN] 1*DIGIT ] / nanInfinity ; IEEE 754 binary64 floating-point number (15-17 decimal digits). The representation shall use DBL_DIG C #define*/
                 else
                 {
-                    size_t tempBufferSize = DECIMAL_DIG * 2;
-                    char* tempBuffer = (char*)malloc(tempBufferSize);
-                    if (tempBuffer == NULL)
+                    char tempBuffer[MAX_FLOATING_POINT_STRING_SIZE];
+                    /*Codes_SRS_AGENT_TYPE_SYSTEM_99_112: [ EDM_SINGLE and EDM_DOUBLE values that are not NaN or infinite shall be written as the shortest doubleValue that converts back to the same value, independent of the current locale. ]*/
+                    formatDouble(tempBuffer, value->value.edmDouble.value);
+                    if (STRING_concat(destination, tempBuffer) != 0)
                     {
                         result = AGENT_DATA_TYPES_ERROR;
                         LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
                     }
                     else
                     {
-                        if (sprintf_s(tempBuffer, tempBufferSize, "%.*f", DBL_DIG, value->value.edmDouble.value) < 0)
-                        {
-                            result = AGENT_DATA_TYPES_ERROR;
-                            LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
-                        }
-                        else if (STRING_concat(destination, tempBuffer) != 0)
-                        {
-                            result = AGENT_DATA_TYPES_ERROR;
-                            LogError("(result = %s)", ENUM_TO_STRING(AGENT_DATA_TYPES_RESULT, result));
-                        }
-                        else
-                        {
-                            result = AGENT_DATA_TYPES_OK;
-                        }
-
-                        free(tempBuffer);
+                        result = AGENT_DATA_TYPES_OK;
                     }
                 }
                 break;
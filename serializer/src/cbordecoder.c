@@ -0,0 +1,526 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include "azure_c_shared_utility/gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "cbordecoder.h"
+#include "agenttypesystem.h"
+#include "azure_c_shared_utility/xlogging.h"
+
+#define CBOR_MAJOR_TYPE_UNSIGNED_INTEGER    0
+#define CBOR_MAJOR_TYPE_NEGATIVE_INTEGER    1
+#define CBOR_MAJOR_TYPE_BYTE_STRING         2
+#define CBOR_MAJOR_TYPE_TEXT_STRING         3
+#define CBOR_MAJOR_TYPE_ARRAY               4
+#define CBOR_MAJOR_TYPE_MAP                 5
+#define CBOR_MAJOR_TYPE_TAG                 6
+#define CBOR_MAJOR_TYPE_SIMPLE              7
+
+#define CBOR_SIMPLE_FALSE                   20
+#define CBOR_SIMPLE_TRUE                    21
+#define CBOR_SIMPLE_NULL                    22
+#define CBOR_SIMPLE_UNDEFINED               23
+#define CBOR_FLOAT16                        25
+#define CBOR_FLOAT32                        26
+#define CBOR_FLOAT64                        27
+
+#define CBOR_TAG_DATE_TIME_STRING           0
+#define CBOR_TAG_UUID                       37
+#define CBOR_TAG_FULL_DATE_STRING           1004
+
+/*nesting of maps and tags accepted from the wire, keeps the recursion bounded*/
+#define CBOR_DECODER_MAX_DEPTH              32
+
+typedef struct CBOR_READER_TAG
+{
+    const unsigned char* bytes;
+    size_t size;
+    size_t position;
+} CBOR_READER;
+
+static int AgentDataTypeCloneFunction(void** destination, const void* source)
+{
+    int result;
+    AGENT_DATA_TYPE* clone = (AGENT_DATA_TYPE*)malloc(sizeof(AGENT_DATA_TYPE));
+    if (clone == NULL)
+    {
+        result = __FAILURE__;
+        LogError("unable to malloc");
+    }
+    else if (Create_AGENT_DATA_TYPE_from_AGENT_DATA_TYPE(clone, (const AGENT_DATA_TYPE*)source) != AGENT_DATA_TYPES_OK)
+    {
+        result = __FAILURE__;
+        LogError("unable to Create_AGENT_DATA_TYPE_from_AGENT_DATA_TYPE");
+        free(clone);
+    }
+    else
+    {
+        *destination = clone;
+        result = 0;
+    }
+    return result;
+}
+
+static void AgentDataTypeFreeFunction(void* value)
+{
+    Destroy_AGENT_DATA_TYPE((AGENT_DATA_TYPE*)value);
+    free(value);
+}
+
+/*reads the initial byte of a data item and the argument that follows it*/
+/*for major type 7 the argument is the raw bit pattern of the simple value or float*/
+static int readHead(CBOR_READER* reader, unsigned char* majorType, unsigned char* additionalInformation, uint64_t* argument)
+{
+    int result;
+
+    if (reader->position >= reader->size)
+    {
+        result = __FAILURE__;
+        LogError("unexpected end of data");
+    }
+    else
+    {
+        size_t argumentSize;
+        unsigned char initialByte = reader->bytes[reader->position++];
+        *majorType = (unsigned char)(initialByte >> 5);
+        *additionalInformation = (unsigned char)(initialByte & 0x1F);
+
+        if (*additionalInformation < 24)
+        {
+            argumentSize = 0;
+            *argument = *additionalInformation;
+            result = 0;
+        }
+        else if (*additionalInformation <= 27)
+        {
+            argumentSize = (size_t)1 << (*additionalInformation - 24);
+            *argument = 0;
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_CBOR_DECODER_99_006: [ Indefinite length items and reserved additional information values shall be rejected. ]*/
+            argumentSize = 0;
+            result = __FAILURE__;
+            LogError("unsupported additional information %u", (unsigned int)*additionalInformation);
+        }
+
+        if (result == 0)
+        {
+            if (argumentSize > reader->size - reader->position)
+            {
+                result = __FAILURE__;
+                LogError("unexpected end of data");
+            }
+            else
+            {
+                size_t i;
+                for (i = 0; i < argumentSize; i++)
+                {
+                    *argument = (*argument << 8) | reader->bytes[reader->position++];
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static int readStringContent(CBOR_READER* reader, uint64_t length, const unsigned char** content)
+{
+    int result;
+
+    if (length > reader->size - reader->position)
+    {
+        result = __FAILURE__;
+        LogError("string goes past the end of data");
+    }
+    else
+    {
+        *content = reader->bytes + reader->position;
+        reader->position += (size_t)length;
+        result = 0;
+    }
+
+    return result;
+}
+
+/*copies the content of a text string into a new zero terminated string, optionally surrounded by quotes*/
+static char* copyText(const unsigned char* content, uint64_t length, bool addQuotes)
+{
+    char* result;
+
+    if ((result = (char*)malloc((size_t)length + (addQuotes ? 3 : 1))) == NULL)
+    {
+        LogError("unable to malloc");
+    }
+    else
+    {
+        size_t pos = 0;
+        if (addQuotes)
+        {
+            result[pos++] = '"';
+        }
+        (void)memcpy(result + pos, content, (size_t)length);
+        pos += (size_t)length;
+        if (addQuotes)
+        {
+            result[pos++] = '"';
+        }
+        result[pos] = '\0';
+    }
+
+    return result;
+}
+
+static char* readText(CBOR_READER* reader, bool addQuotes)
+{
+    char* result;
+    unsigned char majorType;
+    unsigned char additionalInformation;
+    uint64_t length;
+    const unsigned char* content;
+
+    if ((readHead(reader, &majorType, &additionalInformation, &length) != 0) ||
+        (majorType != CBOR_MAJOR_TYPE_TEXT_STRING) ||
+        (readStringContent(reader, length, &content) != 0))
+    {
+        result = NULL;
+        LogError("expected a text string");
+    }
+    else
+    {
+        result = copyText(content, length, addQuotes);
+    }
+
+    return result;
+}
+
+#ifndef NO_FLOATS
+static double halfToDouble(uint16_t bits)
+{
+    int exponent = (bits >> 10) & 0x1F;
+    int mantissa = bits & 0x3FF;
+    double value;
+
+    if (exponent == 0)
+    {
+        value = ldexp(mantissa, -24);
+    }
+    else if (exponent != 31)
+    {
+        value = ldexp(mantissa + 1024, exponent - 25);
+    }
+    else
+    {
+        value = (mantissa == 0) ? HUGE_VAL : NAN;
+    }
+
+    return (bits & 0x8000) ? -value : value;
+}
+#endif
+
+static int decodeMap(CBOR_READER* reader, MULTITREE_HANDLE treeHandle, uint64_t pairCount, size_t depth);
+
+/*decodes the data item at the current position of reader and stores it under name in treeHandle*/
+static int decodeItem(CBOR_READER* reader, MULTITREE_HANDLE treeHandle, const char* name, size_t depth)
+{
+    int result;
+    unsigned char majorType;
+    unsigned char additionalInformation;
+    uint64_t argument;
+    AGENT_DATA_TYPE value;
+    AGENT_DATA_TYPES_RESULT createResult = AGENT_DATA_TYPES_ERROR;
+    bool isLeaf = true;
+
+    if (depth > CBOR_DECODER_MAX_DEPTH)
+    {
+        /*Codes_SRS_CBOR_DECODER_99_007: [ Data nested deeper than 32 maps or tags shall be rejected. ]*/
+        result = __FAILURE__;
+        LogError("data is nested too deep");
+    }
+    else if (readHead(reader, &majorType, &additionalInformation, &argument) != 0)
+    {
+        result = __FAILURE__;
+        LogError("unable to read the head of an item");
+    }
+    else
+    {
+        result = 0;
+
+        switch (majorType)
+        {
+            /*Codes_SRS_CBOR_DECODER_99_008: [ Unsigned and negative integers shall be decoded as EDM_INT64. ]*/
+            case CBOR_MAJOR_TYPE_UNSIGNED_INTEGER:
+            case CBOR_MAJOR_TYPE_NEGATIVE_INTEGER:
+            {
+                if (argument > INT64_MAX)
+                {
+                    /*Codes_SRS_CBOR_DECODER_99_009: [ Integers that do not fit in EDM_INT64 shall be rejected. ]*/
+                    result = __FAILURE__;
+                    LogError("integer out of range");
+                }
+                else
+                {
+                    createResult = Create_AGENT_DATA_TYPE_from_SINT64(&value, (majorType == CBOR_MAJOR_TYPE_UNSIGNED_INTEGER) ? (int64_t)argument : -1 - (int64_t)argument);
+                }
+                break;
+            }
+            /*Codes_SRS_CBOR_DECODER_99_010: [ Byte strings shall be decoded as EDM_BINARY. ]*/
+            case CBOR_MAJOR_TYPE_BYTE_STRING:
+            {
+                const unsigned char* content;
+                if (readStringContent(reader, argument, &content) != 0)
+                {
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    EDM_BINARY binary;
+                    binary.size = (size_t)argument;
+                    binary.data = (binary.size == 0) ? NULL : (unsigned char*)content;
+                    createResult = Create_AGENT_DATA_TYPE_from_EDM_BINARY(&value, binary);
+                }
+                break;
+            }
+            /*Codes_SRS_CBOR_DECODER_99_011: [ Text strings shall be decoded as EDM_STRING. ]*/
+            case CBOR_MAJOR_TYPE_TEXT_STRING:
+            {
+                const unsigned char* content;
+                char* text;
+                if ((readStringContent(reader, argument, &content) != 0) ||
+                    ((text = copyText(content, argument, false)) == NULL))
+                {
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    createResult = Create_AGENT_DATA_TYPE_from_charz(&value, text);
+                    free(text);
+                }
+                break;
+            }
+            /*Codes_SRS_CBOR_DECODER_99_012: [ Maps shall be decoded as child nodes named after their keys. ]*/
+            case CBOR_MAJOR_TYPE_MAP:
+            {
+                MULTITREE_HANDLE childTreeHandle;
+                isLeaf = false;
+                if (MultiTree_AddChild(treeHandle, name, &childTreeHandle) != MULTITREE_OK)
+                {
+                    result = __FAILURE__;
+                    LogError("unable to add child %s", name);
+                }
+                else if (decodeMap(reader, childTreeHandle, argument, depth + 1) != 0)
+                {
+                    result = __FAILURE__;
+                    LogError("unable to decode child %s", name);
+                }
+                break;
+            }
+            case CBOR_MAJOR_TYPE_TAG:
+            {
+                /*Codes_SRS_CBOR_DECODER_99_013: [ A text string tagged 0 shall be decoded as EDM_DATE_TIME_OFFSET and a text string tagged 1004 as EDM_DATE. ]*/
+                if ((argument == CBOR_TAG_DATE_TIME_STRING) ||
+                    (argument == CBOR_TAG_FULL_DATE_STRING))
+                {
+                    char* text = readText(reader, true);
+                    if (text == NULL)
+                    {
+                        result = __FAILURE__;
+                    }
+                    else
+                    {
+                        createResult = CreateAgentDataType_From_String(text, (argument == CBOR_TAG_FULL_DATE_STRING) ? EDM_DATE_TYPE : EDM_DATE_TIME_OFFSET_TYPE, &value);
+                        free(text);
+                    }
+                }
+                /*Codes_SRS_CBOR_DECODER_99_014: [ A 16 bytes byte string tagged 37 shall be decoded as EDM_GUID. ]*/
+                else if (argument == CBOR_TAG_UUID)
+                {
+                    const unsigned char* content;
+                    if ((readHead(reader, &majorType, &additionalInformation, &argument) != 0) ||
+                        (majorType != CBOR_MAJOR_TYPE_BYTE_STRING) ||
+                        (argument != sizeof(value.value.edmGuid.GUID)) ||
+                        (readStringContent(reader, argument, &content) != 0))
+                    {
+                        result = __FAILURE__;
+                        LogError("tag 37 expects a 16 bytes byte string");
+                    }
+                    else
+                    {
+                        EDM_GUID guid;
+                        (void)memcpy(guid.GUID, content, sizeof(guid.GUID));
+                        createResult = Create_AGENT_DATA_TYPE_from_EDM_GUID(&value, guid);
+                    }
+                }
+                /*Codes_SRS_CBOR_DECODER_99_015: [ Any other tag shall be ignored and the tagged item decoded in its place. ]*/
+                else
+                {
+                    isLeaf = false;
+                    result = decodeItem(reader, treeHandle, name, depth + 1);
+                }
+                break;
+            }
+            case CBOR_MAJOR_TYPE_SIMPLE:
+            {
+                /*Codes_SRS_CBOR_DECODER_99_016: [ The simple values false and true shall be decoded as EDM_BOOLEAN, null and undefined as EDM_NULL. ]*/
+                if ((additionalInformation == CBOR_SIMPLE_FALSE) ||
+                    (additionalInformation == CBOR_SIMPLE_TRUE))
+                {
+                    createResult = Create_EDM_BOOLEAN_from_int(&value, additionalInformation == CBOR_SIMPLE_TRUE);
+                }
+                else if ((additionalInformation == CBOR_SIMPLE_NULL) ||
+                    (additionalInformation == CBOR_SIMPLE_UNDEFINED))
+                {
+                    createResult = Create_NULL_AGENT_DATA_TYPE(&value);
+                }
+#ifndef NO_FLOATS
+                /*Codes_SRS_CBOR_DECODER_99_017: [ Half, single and double precision floats shall be decoded as EDM_DOUBLE. ]*/
+                else if (additionalInformation == CBOR_FLOAT16)
+                {
+                    createResult = Create_AGENT_DATA_TYPE_from_DOUBLE(&value, halfToDouble((uint16_t)argument));
+                }
+                else if (additionalInformation == CBOR_FLOAT32)
+                {
+                    uint32_t bits = (uint32_t)argument;
+                    float single;
+                    (void)memcpy(&single, &bits, sizeof(single));
+                    createResult = Create_AGENT_DATA_TYPE_from_DOUBLE(&value, single);
+                }
+                else if (additionalInformation == CBOR_FLOAT64)
+                {
+                    double dbl;
+                    (void)memcpy(&dbl, &argument, sizeof(dbl));
+                    createResult = Create_AGENT_DATA_TYPE_from_DOUBLE(&value, dbl);
+                }
+#endif
+                else
+                {
+                    result = __FAILURE__;
+                    LogError("unsupported simple value %u", (unsigned int)additionalInformation);
+                }
+                break;
+            }
+            /*Codes_SRS_CBOR_DECODER_99_018: [ Arrays shall be rejected since a MULTITREE_HANDLE cannot hold them. ]*/
+            default:
+            {
+                result = __FAILURE__;
+                LogError("unsupported major type %u", (unsigned int)majorType);
+                break;
+            }
+        }
+    }
+
+    if ((result == 0) && isLeaf)
+    {
+        if (createResult != AGENT_DATA_TYPES_OK)
+        {
+            result = __FAILURE__;
+            LogError("unable to create the value of %s", name);
+        }
+        else
+        {
+            if (MultiTree_AddLeaf(treeHandle, name, &value) != MULTITREE_OK)
+            {
+                result = __FAILURE__;
+                LogError("unable to add leaf %s", name);
+            }
+            Destroy_AGENT_DATA_TYPE(&value);
+        }
+    }
+
+    return result;
+}
+
+static int decodeMap(CBOR_READER* reader, MULTITREE_HANDLE treeHandle, uint64_t pairCount, size_t depth)
+{
+    int result = 0;
+    uint64_t i;
+
+    for (i = 0; (i < pairCount) && (result == 0); i++)
+    {
+        /*Codes_SRS_CBOR_DECODER_99_019: [ Map keys shall be non-empty text strings that do not contain '/'. ]*/
+        char* name = readText(reader, false);
+        if (name == NULL)
+        {
+            result = __FAILURE__;
+            LogError("map keys need to be text strings");
+        }
+        else
+        {
+            if ((name[0] == '\0') ||
+                (strchr(name, '/') != NULL))
+            {
+                result = __FAILURE__;
+                LogError("invalid map key %s", name);
+            }
+            else
+            {
+                result = decodeItem(reader, treeHandle, name, depth);
+            }
+            free(name);
+        }
+    }
+
+    return result;
+}
+
+MULTITREE_HANDLE CBORDecoder_DecodeTree(BUFFER_HANDLE decodeData)
+{
+    MULTITREE_HANDLE result;
+
+    /*Codes_SRS_CBOR_DECODER_99_001: [ If decodeData is NULL, CBORDecoder_DecodeTree shall fail and return NULL. ]*/
+    if (decodeData == NULL)
+    {
+        result = NULL;
+        LogError("invalid arg BUFFER_HANDLE decodeData=%p", decodeData);
+    }
+    else
+    {
+        CBOR_READER reader;
+        unsigned char majorType;
+        unsigned char additionalInformation;
+        uint64_t pairCount;
+
+        reader.bytes = BUFFER_u_char(decodeData);
+        reader.size = BUFFER_length(decodeData);
+        reader.position = 0;
+
+        /*Codes_SRS_CBOR_DECODER_99_003: [ The data shall hold exactly one map (RFC 7049). ]*/
+        if ((readHead(&reader, &majorType, &additionalInformation, &pairCount) != 0) ||
+            (majorType != CBOR_MAJOR_TYPE_MAP))
+        {
+            result = NULL;
+            LogError("data does not start with a map");
+        }
+        /*Codes_SRS_CBOR_DECODER_99_004: [ CBORDecoder_DecodeTree shall create a MULTITREE_HANDLE whose values are AGENT_DATA_TYPE*. ]*/
+        else if ((result = MultiTree_Create(AgentDataTypeCloneFunction, AgentDataTypeFreeFunction)) == NULL)
+        {
+            LogError("failure in MultiTree_Create");
+        }
+        else if (decodeMap(&reader, result, pairCount, 0) != 0)
+        {
+            /*Codes_SRS_CBOR_DECODER_99_020: [ If any failure occurs, CBORDecoder_DecodeTree shall fail and return NULL. ]*/
+            LogError("unable to decode the data");
+            MultiTree_Destroy(result);
+            result = NULL;
+        }
+        else if (reader.position != reader.size)
+        {
+            /*Codes_SRS_CBOR_DECODER_99_005: [ Bytes following the map shall be rejected. ]*/
+            LogError("unexpected bytes after the map");
+            MultiTree_Destroy(result);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CBOR_DECODER_99_002: [ On success, CBORDecoder_DecodeTree shall return the MULTITREE_HANDLE holding the decoded data. ]*/
+        }
+    }
+
+    return result;
+}
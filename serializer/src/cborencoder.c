@@ -0,0 +1,533 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include "azure_c_shared_utility/gballoc.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "cborencoder.h"
+#include "agenttypesystem.h"
+#include "azure_c_shared_utility/xlogging.h"
+#include "azure_c_shared_utility/strings.h"
+
+#define CBOR_MAJOR_TYPE_UNSIGNED_INTEGER    0
+#define CBOR_MAJOR_TYPE_NEGATIVE_INTEGER    1
+#define CBOR_MAJOR_TYPE_BYTE_STRING         2
+#define CBOR_MAJOR_TYPE_TEXT_STRING         3
+#define CBOR_MAJOR_TYPE_MAP                 5
+#define CBOR_MAJOR_TYPE_TAG                 6
+
+#define CBOR_FALSE                          0xF4
+#define CBOR_TRUE                           0xF5
+#define CBOR_NULL                           0xF6
+#define CBOR_FLOAT32                        0xFA
+#define CBOR_FLOAT64                        0xFB
+
+#define CBOR_TAG_DATE_TIME_STRING           0
+#define CBOR_TAG_UUID                       37
+#define CBOR_TAG_FULL_DATE_STRING           1004
+
+#define CBOR_ENCODER_INITIAL_CAPACITY       64
+
+typedef struct CBOR_WRITER_TAG
+{
+    unsigned char* bytes;
+    size_t size;
+    size_t capacity;
+} CBOR_WRITER;
+
+static int writeRaw(CBOR_WRITER* writer, const unsigned char* bytes, size_t count)
+{
+    int result;
+
+    if (writer->capacity - writer->size >= count)
+    {
+        result = 0;
+    }
+    else if (count > (SIZE_MAX / 2) - writer->size)
+    {
+        result = __FAILURE__;
+        LogError("payload too big");
+    }
+    else
+    {
+        size_t newCapacity = (writer->capacity == 0) ? CBOR_ENCODER_INITIAL_CAPACITY : writer->capacity;
+        unsigned char* newBytes;
+
+        while (newCapacity - writer->size < count)
+        {
+            newCapacity *= 2;
+        }
+
+        if ((newBytes = (unsigned char*)realloc(writer->bytes, newCapacity)) == NULL)
+        {
+            result = __FAILURE__;
+            LogError("failure in realloc");
+        }
+        else
+        {
+            writer->bytes = newBytes;
+            writer->capacity = newCapacity;
+            result = 0;
+        }
+    }
+
+    if ((result == 0) && (count > 0))
+    {
+        (void)memcpy(writer->bytes + writer->size, bytes, count);
+        writer->size += count;
+    }
+
+    return result;
+}
+
+/*Codes_SRS_CBOR_ENCODER_99_006: [ Every data item shall start with the shortest head able to hold its argument (lengths, counts, integers and tags). ]*/
+static int writeHead(CBOR_WRITER* writer, unsigned char majorType, uint64_t argument)
+{
+    unsigned char head[9];
+    size_t headSize;
+
+    head[0] = (unsigned char)(majorType << 5);
+    if (argument < 24)
+    {
+        head[0] |= (unsigned char)argument;
+        headSize = 1;
+    }
+    else if (argument <= UINT8_MAX)
+    {
+        head[0] |= 24;
+        headSize = 2;
+    }
+    else if (argument <= UINT16_MAX)
+    {
+        head[0] |= 25;
+        headSize = 3;
+    }
+    else if (argument <= UINT32_MAX)
+    {
+        head[0] |= 26;
+        headSize = 5;
+    }
+    else
+    {
+        head[0] |= 27;
+        headSize = 9;
+    }
+
+    if (headSize > 1)
+    {
+        size_t i;
+        for (i = headSize - 1; i > 0; i--)
+        {
+            head[i] = (unsigned char)(argument & 0xFF);
+            argument >>= 8;
+        }
+    }
+
+    return writeRaw(writer, head, headSize);
+}
+
+static int writeInteger(CBOR_WRITER* writer, int64_t value)
+{
+    return (value < 0) ?
+        writeHead(writer, CBOR_MAJOR_TYPE_NEGATIVE_INTEGER, (uint64_t)(-(value + 1))) :
+        writeHead(writer, CBOR_MAJOR_TYPE_UNSIGNED_INTEGER, (uint64_t)value);
+}
+
+static int writeString(CBOR_WRITER* writer, unsigned char majorType, const void* data, size_t length)
+{
+    int result;
+
+    if (writeHead(writer, majorType, length) != 0)
+    {
+        result = __FAILURE__;
+        LogError("unable to write string head");
+    }
+    else if (writeRaw(writer, (const unsigned char*)data, length) != 0)
+    {
+        result = __FAILURE__;
+        LogError("unable to write string content");
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static int writeText(CBOR_WRITER* writer, const char* text)
+{
+    return writeString(writer, CBOR_MAJOR_TYPE_TEXT_STRING, text, strlen(text));
+}
+
+static int writeSimple(CBOR_WRITER* writer, unsigned char simpleValue)
+{
+    return writeRaw(writer, &simpleValue, 1);
+}
+
+#ifndef NO_FLOATS
+static int writeFloat(CBOR_WRITER* writer, float value)
+{
+    unsigned char bytes[5];
+    uint32_t bits;
+
+    (void)memcpy(&bits, &value, sizeof(bits));
+    bytes[0] = CBOR_FLOAT32;
+    bytes[1] = (unsigned char)(bits >> 24);
+    bytes[2] = (unsigned char)(bits >> 16);
+    bytes[3] = (unsigned char)(bits >> 8);
+    bytes[4] = (unsigned char)bits;
+    return writeRaw(writer, bytes, sizeof(bytes));
+}
+
+static int writeDouble(CBOR_WRITER* writer, double value)
+{
+    int result;
+
+    /*Codes_SRS_CBOR_ENCODER_99_011: [ An EDM_DOUBLE that can be converted to float and back without loss shall be written as a single precision float. ]*/
+    if ((fabs(value) <= FLT_MAX) &&
+        ((double)(float)value == value))
+    {
+        result = writeFloat(writer, (float)value);
+    }
+    else
+    {
+        unsigned char bytes[9];
+        uint64_t bits;
+        size_t i;
+
+        (void)memcpy(&bits, &value, sizeof(bits));
+        bytes[0] = CBOR_FLOAT64;
+        for (i = 8; i > 0; i--)
+        {
+            bytes[i] = (unsigned char)(bits & 0xFF);
+            bits >>= 8;
+        }
+        result = writeRaw(writer, bytes, sizeof(bytes));
+    }
+
+    return result;
+}
+#endif
+
+/*writes the JSON text produced by AgentDataTypes_ToString as a text string, without its surrounding quotes*/
+static int writeAgentDataAsText(CBOR_WRITER* writer, const AGENT_DATA_TYPE* value)
+{
+    int result;
+    STRING_HANDLE text = STRING_new();
+
+    if (text == NULL)
+    {
+        result = __FAILURE__;
+        LogError("failure in STRING_new");
+    }
+    else
+    {
+        if (AgentDataTypes_ToString(text, value) != AGENT_DATA_TYPES_OK)
+        {
+            result = __FAILURE__;
+            LogError("failure in AgentDataTypes_ToString");
+        }
+        else
+        {
+            const char* chars = STRING_c_str(text);
+            size_t length = strlen(chars);
+
+            if ((length >= 2) &&
+                (chars[0] == '"') &&
+                (chars[length - 1] == '"'))
+            {
+                chars++;
+                length -= 2;
+            }
+
+            result = writeString(writer, CBOR_MAJOR_TYPE_TEXT_STRING, chars, length);
+        }
+        STRING_delete(text);
+    }
+
+    return result;
+}
+
+static int writeAgentData(CBOR_WRITER* writer, const AGENT_DATA_TYPE* value)
+{
+    int result;
+
+    switch (value->type)
+    {
+        /*Codes_SRS_CBOR_ENCODER_99_008: [ EDM_BOOLEAN shall be written as the simple value true or false. ]*/
+        case EDM_BOOLEAN_TYPE:
+        {
+            result = writeSimple(writer, (value->value.edmBoolean.value == EDM_TRUE) ? CBOR_TRUE : CBOR_FALSE);
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_009: [ EDM_BYTE, EDM_SBYTE, EDM_INT16, EDM_INT32 and EDM_INT64 shall be written as an unsigned integer when positive or as a negative integer otherwise. ]*/
+        case EDM_BYTE_TYPE:
+        {
+            result = writeInteger(writer, value->value.edmByte.value);
+            break;
+        }
+        case EDM_SBYTE_TYPE:
+        {
+            result = writeInteger(writer, value->value.edmSbyte.value);
+            break;
+        }
+        case EDM_INT16_TYPE:
+        {
+            result = writeInteger(writer, value->value.edmInt16.value);
+            break;
+        }
+        case EDM_INT32_TYPE:
+        {
+            result = writeInteger(writer, value->value.edmInt32.value);
+            break;
+        }
+        case EDM_INT64_TYPE:
+        {
+            result = writeInteger(writer, value->value.edmInt64.value);
+            break;
+        }
+#ifndef NO_FLOATS
+        /*Codes_SRS_CBOR_ENCODER_99_010: [ EDM_SINGLE shall be written as a single precision float. ]*/
+        case EDM_SINGLE_TYPE:
+        {
+            result = writeFloat(writer, value->value.edmSingle.value);
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_012: [ Any other EDM_DOUBLE shall be written as a double precision float. ]*/
+        case EDM_DOUBLE_TYPE:
+        {
+            result = writeDouble(writer, value->value.edmDouble.value);
+            break;
+        }
+#endif
+        /*Codes_SRS_CBOR_ENCODER_99_013: [ EDM_STRING and EDM_STRING_NO_QUOTES shall be written as a text string holding their characters, unescaped. ]*/
+        case EDM_STRING_TYPE:
+        {
+            result = writeString(writer, CBOR_MAJOR_TYPE_TEXT_STRING, value->value.edmString.chars, value->value.edmString.length);
+            break;
+        }
+        case EDM_STRING_NO_QUOTES_TYPE:
+        {
+            result = writeString(writer, CBOR_MAJOR_TYPE_TEXT_STRING, value->value.edmStringNoQuotes.chars, value->value.edmStringNoQuotes.length);
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_014: [ EDM_BINARY shall be written as a byte string. ]*/
+        case EDM_BINARY_TYPE:
+        {
+            result = writeString(writer, CBOR_MAJOR_TYPE_BYTE_STRING, value->value.edmBinary.data, value->value.edmBinary.size);
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_015: [ EDM_GUID shall be written as a 16 bytes byte string tagged 37. ]*/
+        case EDM_GUID_TYPE:
+        {
+            if (writeHead(writer, CBOR_MAJOR_TYPE_TAG, CBOR_TAG_UUID) != 0)
+            {
+                result = __FAILURE__;
+                LogError("unable to write tag");
+            }
+            else
+            {
+                result = writeString(writer, CBOR_MAJOR_TYPE_BYTE_STRING, value->value.edmGuid.GUID, sizeof(value->value.edmGuid.GUID));
+            }
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_016: [ EDM_NULL shall be written as the simple value null. ]*/
+        case EDM_NULL_TYPE:
+        {
+            result = writeSimple(writer, CBOR_NULL);
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_017: [ EDM_DATE_TIME_OFFSET shall be written as its RFC 3339 text tagged 0 and EDM_DATE as its full-date text tagged 1004. ]*/
+        case EDM_DATE_TIME_OFFSET_TYPE:
+        case EDM_DATE_TYPE:
+        {
+            if (writeHead(writer, CBOR_MAJOR_TYPE_TAG, (value->type == EDM_DATE_TYPE) ? CBOR_TAG_FULL_DATE_STRING : CBOR_TAG_DATE_TIME_STRING) != 0)
+            {
+                result = __FAILURE__;
+                LogError("unable to write tag");
+            }
+            else
+            {
+                result = writeAgentDataAsText(writer, value);
+            }
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_018: [ EDM_COMPLEX_TYPE shall be written as a map from field names to the encoded field values. ]*/
+        case EDM_COMPLEX_TYPE_TYPE:
+        {
+            size_t i;
+            if (writeHead(writer, CBOR_MAJOR_TYPE_MAP, value->value.edmComplexType.nMembers) != 0)
+            {
+                result = __FAILURE__;
+                LogError("unable to write map head");
+            }
+            else
+            {
+                result = 0;
+                for (i = 0; (i < value->value.edmComplexType.nMembers) && (result == 0); i++)
+                {
+                    const char* fieldName = value->value.edmComplexType.fields[i].fieldName;
+                    if (writeText(writer, fieldName) != 0)
+                    {
+                        result = __FAILURE__;
+                        LogError("unable to write field name");
+                    }
+                    else if (writeAgentData(writer, value->value.edmComplexType.fields[i].value) != 0)
+                    {
+                        result = __FAILURE__;
+                        LogError("unable to write field %s", fieldName);
+                    }
+                }
+            }
+            break;
+        }
+        /*Codes_SRS_CBOR_ENCODER_99_019: [ Any other AGENT_DATA_TYPE shall be written as a text string holding the text produced by AgentDataTypes_ToString, without surrounding quotes. ]*/
+        default:
+        {
+            result = writeAgentDataAsText(writer, value);
+            break;
+        }
+    }
+
+    return result;
+}
+
+static int writeNode(CBOR_WRITER* writer, MULTITREE_HANDLE treeHandle, DATA_SERIALIZER_MULTITREE_TYPE dataType, STRING_HANDLE name);
+
+/*Codes_SRS_CBOR_ENCODER_99_004: [ A node that has children shall be written as a map holding, for every child in order, the child's name as a text string followed by the child's encoding. ]*/
+static int writeChildren(CBOR_WRITER* writer, MULTITREE_HANDLE treeHandle, size_t childCount, DATA_SERIALIZER_MULTITREE_TYPE dataType, STRING_HANDLE name)
+{
+    int result;
+
+    if (writeHead(writer, CBOR_MAJOR_TYPE_MAP, childCount) != 0)
+    {
+        result = __FAILURE__;
+        LogError("unable to write map head");
+    }
+    else
+    {
+        size_t i;
+        result = 0;
+        for (i = 0; (i < childCount) && (result == 0); i++)
+        {
+            MULTITREE_HANDLE childTreeHandle;
+            if (MultiTree_GetChild(treeHandle, i, &childTreeHandle) != MULTITREE_OK)
+            {
+                result = __FAILURE__;
+                LogError("failure in MultiTree_GetChild");
+            }
+            else if (STRING_empty(name) != 0)
+            {
+                result = __FAILURE__;
+                LogError("failure in STRING_empty");
+            }
+            else if (MultiTree_GetName(childTreeHandle, name) != MULTITREE_OK)
+            {
+                result = __FAILURE__;
+                LogError("failure in MultiTree_GetName");
+            }
+            else if (writeText(writer, STRING_c_str(name)) != 0)
+            {
+                result = __FAILURE__;
+                LogError("unable to write the child name");
+            }
+            else
+            {
+                result = writeNode(writer, childTreeHandle, dataType, name);
+            }
+        }
+    }
+
+    return result;
+}
+
+static int writeNode(CBOR_WRITER* writer, MULTITREE_HANDLE treeHandle, DATA_SERIALIZER_MULTITREE_TYPE dataType, STRING_HANDLE name)
+{
+    int result;
+    size_t childCount;
+    const void* value;
+
+    if (MultiTree_GetChildCount(treeHandle, &childCount) != MULTITREE_OK)
+    {
+        result = __FAILURE__;
+        LogError("failure in MultiTree_GetChildCount");
+    }
+    else if (childCount > 0)
+    {
+        result = writeChildren(writer, treeHandle, childCount, dataType, name);
+    }
+    else if (MultiTree_GetValue(treeHandle, &value) != MULTITREE_OK)
+    {
+        result = __FAILURE__;
+        LogError("failure in MultiTree_GetValue");
+    }
+    /*Codes_SRS_CBOR_ENCODER_99_005: [ When dataType is DATA_SERIALIZER_TYPE_CHAR_PTR the value of a leaf shall be written as a text string. ]*/
+    else if (dataType == DATA_SERIALIZER_TYPE_CHAR_PTR)
+    {
+        result = writeText(writer, (const char*)value);
+    }
+    /*Codes_SRS_CBOR_ENCODER_99_007: [ When dataType is DATA_SERIALIZER_TYPE_AGENT_DATA the value of a leaf shall be written according to its AGENT_DATA_TYPE type: ]*/
+    else
+    {
+        result = writeAgentData(writer, (const AGENT_DATA_TYPE*)value);
+    }
+
+    return result;
+}
+
+BUFFER_HANDLE CBOREncoder_EncodeTree(MULTITREE_HANDLE treeHandle, DATA_SERIALIZER_MULTITREE_TYPE dataType)
+{
+    BUFFER_HANDLE result;
+    size_t childCount;
+
+    /*Codes_SRS_CBOR_ENCODER_99_001: [ If treeHandle is NULL, CBOREncoder_EncodeTree shall fail and return NULL. ]*/
+    if (treeHandle == NULL)
+    {
+        result = NULL;
+        LogError("invalid arg MULTITREE_HANDLE treeHandle=%p", treeHandle);
+    }
+    else if (MultiTree_GetChildCount(treeHandle, &childCount) != MULTITREE_OK)
+    {
+        /*Codes_SRS_CBOR_ENCODER_99_020: [ If any failure occurs, CBOREncoder_EncodeTree shall fail and return NULL. ]*/
+        result = NULL;
+        LogError("failure in MultiTree_GetChildCount");
+    }
+    else
+    {
+        STRING_HANDLE name = STRING_new();
+        if (name == NULL)
+        {
+            result = NULL;
+            LogError("failure in STRING_new");
+        }
+        else
+        {
+            CBOR_WRITER writer;
+            writer.bytes = NULL;
+            writer.size = 0;
+            writer.capacity = 0;
+
+            /*Codes_SRS_CBOR_ENCODER_99_003: [ The root of the tree shall be written as a map (RFC 7049), also when it has no children. ]*/
+            if (writeChildren(&writer, treeHandle, childCount, dataType, name) != 0)
+            {
+                result = NULL;
+                LogError("unable to encode the tree");
+            }
+            /*Codes_SRS_CBOR_ENCODER_99_002: [ On success, CBOREncoder_EncodeTree shall return a BUFFER_HANDLE holding the encoded tree. ]*/
+            else if ((result = BUFFER_create(writer.bytes, writer.size)) == NULL)
+            {
+                LogError("failure in BUFFER_create");
+            }
+
+            free(writer.bytes);
+            STRING_delete(name);
+        }
+    }
+
+    return result;
+}
@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 
 #include "codefirst.h"
@@ -19,6 +20,20 @@ DEFINE_ENUM_STRINGS(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_RESULT_VALUES)
 #define LOG_CODEFIRST_ERROR \
     LogError("(result = %s)", ENUM_TO_STRING(CODEFIRST_RESULT, result))
 
+/*a property of the device model or of one of its child models, together with where it lives in the device data and the path it is published under*/
+typedef struct PROPERTY_INDEX_ENTRY_TAG
+{
+    size_t offset; /*from the beginning of the device data*/
+    char* path; /*for example "ChildModel/InnerProperty"*/
+    int(*Create_AGENT_DATA_TYPE_from_Ptr)(void* param, AGENT_DATA_TYPE* dest);
+} PROPERTY_INDEX_ENTRY;
+
+typedef struct PROPERTY_INDEX_TAG
+{
+    PROPERTY_INDEX_ENTRY* entries; /*sorted by offset*/
+    size_t count;
+} PROPERTY_INDEX;
+
 typedef struct DEVICE_HEADER_DATA_TAG
 {
     DEVICE_HANDLE DeviceHandle;
@@ -26,6 +41,9 @@ typedef struct DEVICE_HEADER_DATA_TAG
     SCHEMA_MODEL_TYPE_HANDLE ModelHandle;
     size_t DataSize;
     unsigned char* data;
+    bool IsPropertyIndexBuilt; /*the indexes below are built the first time a value of the device is sent*/
+    PROPERTY_INDEX Properties;
+    PROPERTY_INDEX ReportedProperties;
 } DEVICE_HEADER_DATA;
 
 #define COUNT_OF(A) (sizeof(A) / sizeof((A)[0]))
@@ -80,7 +98,7 @@ DEFINE_ENUM(CODEFIRST_STATE, CODEFIRST_STATE_VALUES)
 static CODEFIRST_STATE g_state = CODEFIRST_STATE_NOT_INIT;
 static const char* g_OverrideSchemaNamespace;
 static size_t g_DeviceCount = 0;
-static DEVICE_HEADER_DATA** g_Devices = NULL;
+static DEVICE_HEADER_DATA** g_Devices = NULL; /*sorted by the address of the device data*/
 
 static void deinitializeDesiredProperties(SCHEMA_MODEL_TYPE_HANDLE model, void* destination)
 {
@@ -153,12 +171,28 @@ static void deinitializeDesiredProperties(SCHEMA_MODEL_TYPE_HANDLE model, void*
     }
 }
 
+static void DestroyPropertyIndex(PROPERTY_INDEX* propertyIndex)
+{
+    size_t i;
+
+    for (i = 0; i < propertyIndex->count; i++)
+    {
+        free(propertyIndex->entries[i].path);
+    }
+
+    free(propertyIndex->entries);
+    propertyIndex->entries = NULL;
+    propertyIndex->count = 0;
+}
+
 static void DestroyDevice(DEVICE_HEADER_DATA* deviceHeader)
 {
     /* Codes_SRS_CODEFIRST_99_085:[CodeFirst_DestroyDevice shall free all resources associated with a device.] */
     /* Codes_SRS_CODEFIRST_99_087:[In order to release the device handle, CodeFirst_DestroyDevice shall call Device_Destroy.] */
     
     Device_Destroy(deviceHeader->DeviceHandle);
+    DestroyPropertyIndex(&deviceHeader->Properties);
+    DestroyPropertyIndex(&deviceHeader->ReportedProperties);
     free(deviceHeader->data);
     free(deviceHeader);
 }
@@ -305,6 +339,7 @@ static CODEFIRST_RESULT buildModel(SCHEMA_HANDLE schemaHandle, const REFLECTED_D
                     something->what.desiredProperty.name, 
                     something->what.desiredProperty.type, 
                     something->what.desiredProperty.FromAGENT_DATA_TYPE, 
+                    something->what.desiredProperty.ToAGENT_DATA_TYPE, 
                     something->what.desiredProperty.desiredPropertInitialize, 
                     something->what.desiredProperty.desiredPropertDeinitialize, 
                     something->what.desiredProperty.offset, 
@@ -876,6 +911,28 @@ static void initializeDesiredProperties(SCHEMA_MODEL_TYPE_HANDLE model, void* de
     }
 }
 
+/*returns how many devices have their data starting at or before address, that is, the position at which a device with data at address is (or would be) in g_Devices*/
+static size_t CountDevicesStartingAtOrBefore(const unsigned char* address)
+{
+    size_t low = 0;
+    size_t high = g_DeviceCount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (g_Devices[middle]->data <= address)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
 /* Codes_SRS_CODEFIRST_99_079:[CodeFirst_CreateDevice shall create a device and allocate a memory block that should hold the device data.] */
 void* CodeFirst_CreateDevice(SCHEMA_MODEL_TYPE_HANDLE model, const REFLECTED_DATA_FROM_DATAPROVIDER* metadata, size_t dataSize, bool includePropertyPath)
 {
@@ -942,6 +999,11 @@ void* CodeFirst_CreateDevice(SCHEMA_MODEL_TYPE_HANDLE model, const REFLECTED_DAT
                     deviceHeader->ReflectedData = metadata;
                     deviceHeader->DataSize = dataSize;
                     deviceHeader->ModelHandle = model;
+                    deviceHeader->IsPropertyIndexBuilt = false;
+                    deviceHeader->Properties.entries = NULL;
+                    deviceHeader->Properties.count = 0;
+                    deviceHeader->ReportedProperties.entries = NULL;
+                    deviceHeader->ReportedProperties.count = 0;
                     schemaResult = Schema_AddDeviceRef(model);
                     if (schemaResult != SCHEMA_OK)
                     {
@@ -954,8 +1016,12 @@ void* CodeFirst_CreateDevice(SCHEMA_MODEL_TYPE_HANDLE model, const REFLECTED_DAT
                     }
                     else
                     {
+                        /* Codes_SRS_CODEFIRST_99_145: [ CodeFirst_CreateDevice shall keep the devices ordered by the address of their data, so that the device owning a value is found by a binary search. ]*/
+                        size_t position;
                         g_Devices = newDevices;
-                        g_Devices[g_DeviceCount] = deviceHeader;
+                        position = CountDevicesStartingAtOrBefore(deviceHeader->data);
+                        (void)memmove(&g_Devices[position + 1], &g_Devices[position], (g_DeviceCount - position) * sizeof(DEVICE_HEADER_DATA*));
+                        g_Devices[position] = deviceHeader;
                         g_DeviceCount++;
 
                         /* Codes_SRS_CODEFIRST_99_101:[On success, CodeFirst_CreateDevice shall return a non NULL pointer to the device data.] */
@@ -975,23 +1041,22 @@ void CodeFirst_DestroyDevice(void* device)
     /* Codes_SRS_CODEFIRST_99_086:[If the argument is NULL, CodeFirst_DestroyDevice shall do nothing.] */
     if (device != NULL)
     {
-        size_t i;
+        size_t position = CountDevicesStartingAtOrBefore((unsigned char*)device);
 
-        for (i = 0; i < g_DeviceCount; i++)
+        if ((position > 0) &&
+            (g_Devices[position - 1]->data == device))
         {
-            if (g_Devices[i]->data == device)
-            {
-                deinitializeDesiredProperties(g_Devices[i]->ModelHandle, g_Devices[i]->data);
-                Schema_ReleaseDeviceRef(g_Devices[i]->ModelHandle);
+            size_t i = position - 1;
 
-                // Delete the Created Schema if all the devices are unassociated
-                Schema_DestroyIfUnused(g_Devices[i]->ModelHandle);
+            deinitializeDesiredProperties(g_Devices[i]->ModelHandle, g_Devices[i]->data);
+            Schema_ReleaseDeviceRef(g_Devices[i]->ModelHandle);
 
-                DestroyDevice(g_Devices[i]);
-                (void)memcpy(&g_Devices[i], &g_Devices[i + 1], (g_DeviceCount - i - 1) * sizeof(DEVICE_HEADER_DATA*));
-                g_DeviceCount--;
-                break;
-            }
+            // Delete the Created Schema if all the devices are unassociated
+            Schema_DestroyIfUnused(g_Devices[i]->ModelHandle);
+
+            DestroyDevice(g_Devices[i]);
+            (void)memmove(&g_Devices[i], &g_Devices[i + 1], (g_DeviceCount - i - 1) * sizeof(DEVICE_HEADER_DATA*));
+            g_DeviceCount--;
         }
 
         /*Codes_SRS_CODEFIRST_02_039: [ If the current device count is zero then CodeFirst_DestroyDevice shall deallocate all other used resources. ]*/
@@ -1006,96 +1071,151 @@ void CodeFirst_DestroyDevice(void* device)
 
 static DEVICE_HEADER_DATA* FindDevice(void* value)
 {
-    size_t i;
     DEVICE_HEADER_DATA* result = NULL;
+    /*device data blocks do not overlap, so only the last device starting at or before value can contain it*/
+    size_t position = CountDevicesStartingAtOrBefore((unsigned char*)value);
 
-    for (i = 0; i < g_DeviceCount; i++)
+    if ((position > 0) &&
+        (g_Devices[position - 1]->data + g_Devices[position - 1]->DataSize > (unsigned char*)value))
     {
-        if ((g_Devices[i]->data <= (unsigned char*)value) &&
-            (g_Devices[i]->data + g_Devices[i]->DataSize > (unsigned char*)value))
-        {
-            result = g_Devices[i];
-            break;
-        }
+        result = g_Devices[position - 1];
     }
 
     return result;
 }
 
-static const REFLECTED_SOMETHING* FindValue(DEVICE_HEADER_DATA* deviceHeader, void* value, const char* modelName, size_t startOffset, STRING_HANDLE valuePath)
+/* Codes_SRS_CODEFIRST_99_133:[CodeFirst_SendAsync shall allow sending of properties that are part of a child model.] */
+/* Codes_SRS_CODEFIRST_99_136:[CodeFirst_SendAsync shall build the full path for each property and then pass it to Device_PublishTransacted.] */
+static int AddToPropertyIndex(PROPERTY_INDEX* propertyIndex, const REFLECTED_SOMETHING* reflectedData, REFLECTION_TYPE propertyType, const char* modelName, size_t startOffset, const char* pathPrefix)
 {
-    const REFLECTED_SOMETHING* result;
-    size_t valueOffset = (size_t)((unsigned char*)value - (unsigned char*)deviceHeader->data) - startOffset;
+    int result = 0;
+    const REFLECTED_SOMETHING* something;
 
-    for (result = deviceHeader->ReflectedData->reflectedData; result != NULL; result = result->next)
+    for (something = reflectedData; (something != NULL) && (result == 0); something = something->next)
     {
-        if (result->type == REFLECTION_PROPERTY_TYPE &&
-            (strcmp(result->what.property.modelName, modelName) == 0) &&
-            (result->what.property.offset <= valueOffset) &&
-            (result->what.property.offset + result->what.property.size > valueOffset))
+        if (something->type == propertyType)
         {
-            if (startOffset != 0)
+            /*WITH_DATA and WITH_REPORTED_PROPERTY are reflected with the same fields*/
+            const char* name = (propertyType == REFLECTION_PROPERTY_TYPE) ? something->what.property.name : something->what.reportedProperty.name;
+            const char* type = (propertyType == REFLECTION_PROPERTY_TYPE) ? something->what.property.type : something->what.reportedProperty.type;
+            const char* propertyModelName = (propertyType == REFLECTION_PROPERTY_TYPE) ? something->what.property.modelName : something->what.reportedProperty.modelName;
+            size_t offset = startOffset + ((propertyType == REFLECTION_PROPERTY_TYPE) ? something->what.property.offset : something->what.reportedProperty.offset);
+
+            if (strcmp(propertyModelName, modelName) == 0)
             {
-                STRING_concat(valuePath, "/");
-            }
+                size_t prefixLength = (pathPrefix == NULL) ? 0 : strlen(pathPrefix) + 1;
+                size_t nameLength = strlen(name);
+                PROPERTY_INDEX_ENTRY* newEntries;
+                char* path;
 
-            STRING_concat(valuePath, result->what.property.name);
-            break;
+                if ((path = (char*)malloc(prefixLength + nameLength + 1)) == NULL)
+                {
+                    LogError("unable to allocate the path of property %s", name);
+                    result = __FAILURE__;
+                }
+                else if ((newEntries = (PROPERTY_INDEX_ENTRY*)realloc(propertyIndex->entries, sizeof(PROPERTY_INDEX_ENTRY) * (propertyIndex->count + 1))) == NULL)
+                {
+                    free(path);
+                    LogError("unable to grow the property index");
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    if (pathPrefix != NULL)
+                    {
+                        (void)memcpy(path, pathPrefix, prefixLength - 1);
+                        path[prefixLength - 1] = '/';
+                    }
+                    (void)memcpy(path + prefixLength, name, nameLength + 1);
+
+                    propertyIndex->entries = newEntries;
+                    propertyIndex->entries[propertyIndex->count].offset = offset;
+                    propertyIndex->entries[propertyIndex->count].path = path;
+                    propertyIndex->entries[propertyIndex->count].Create_AGENT_DATA_TYPE_from_Ptr = (propertyType == REFLECTION_PROPERTY_TYPE) ? something->what.property.Create_AGENT_DATA_TYPE_from_Ptr : something->what.reportedProperty.Create_AGENT_DATA_TYPE_from_Ptr;
+                    propertyIndex->count++;
+
+                    /*when the property is a child model, its own properties are indexed under it*/
+                    result = AddToPropertyIndex(propertyIndex, reflectedData, propertyType, type, offset, path);
+                }
+            }
         }
     }
 
-    if (result != NULL)
+    return result;
+}
+
+static int ComparePropertyIndexEntries(const void* left, const void* right)
+{
+    size_t leftOffset = ((const PROPERTY_INDEX_ENTRY*)left)->offset;
+    size_t rightOffset = ((const PROPERTY_INDEX_ENTRY*)right)->offset;
+    return (leftOffset < rightOffset) ? -1 : ((leftOffset > rightOffset) ? 1 : 0);
+}
+
+/* Codes_SRS_CODEFIRST_99_143: [ The first time a value of a device is sent, CodeFirst_SendAsync and CodeFirst_SendAsyncReported shall resolve the offset and the full path of every property of the device model and of its child models, and reuse them for every later value of that device. ]*/
+static CODEFIRST_RESULT BuildPropertyIndex(DEVICE_HEADER_DATA* deviceHeader)
+{
+    CODEFIRST_RESULT result;
+    const char* modelName;
+
+    if (deviceHeader->IsPropertyIndexBuilt)
+    {
+        result = CODEFIRST_OK;
+    }
+    else if ((modelName = Schema_GetModelName(deviceHeader->ModelHandle)) == NULL)
+    {
+        /* Codes_SRS_CODEFIRST_99_144: [ If resolving the properties of the device fails, CodeFirst_SendAsync and CodeFirst_SendAsyncReported shall return CODEFIRST_ERROR. ]*/
+        result = CODEFIRST_ERROR;
+        LOG_CODEFIRST_ERROR;
+    }
+    else if ((AddToPropertyIndex(&deviceHeader->Properties, deviceHeader->ReflectedData->reflectedData, REFLECTION_PROPERTY_TYPE, modelName, 0, NULL) != 0) ||
+        (AddToPropertyIndex(&deviceHeader->ReportedProperties, deviceHeader->ReflectedData->reflectedData, REFLECTION_REPORTED_PROPERTY_TYPE, modelName, 0, NULL) != 0))
+    {
+        /* Codes_SRS_CODEFIRST_99_144: [ If resolving the properties of the device fails, CodeFirst_SendAsync and CodeFirst_SendAsyncReported shall return CODEFIRST_ERROR. ]*/
+        DestroyPropertyIndex(&deviceHeader->Properties);
+        DestroyPropertyIndex(&deviceHeader->ReportedProperties);
+        result = CODEFIRST_ERROR;
+        LOG_CODEFIRST_ERROR;
+    }
+    else
     {
-        /* Codes_SRS_CODEFIRST_99_133:[CodeFirst_SendAsync shall allow sending of properties that are part of a child model.] */
-        if (result->what.property.offset < valueOffset)
+        if (deviceHeader->Properties.count > 1)
+        {
+            qsort(deviceHeader->Properties.entries, deviceHeader->Properties.count, sizeof(PROPERTY_INDEX_ENTRY), ComparePropertyIndexEntries);
+        }
+        if (deviceHeader->ReportedProperties.count > 1)
         {
-            /* find recursively the property in the inner model, if there is one */
-            result = FindValue(deviceHeader, value, result->what.property.type, startOffset + result->what.property.offset, valuePath);
+            qsort(deviceHeader->ReportedProperties.entries, deviceHeader->ReportedProperties.count, sizeof(PROPERTY_INDEX_ENTRY), ComparePropertyIndexEntries);
         }
+        deviceHeader->IsPropertyIndexBuilt = true;
+        result = CODEFIRST_OK;
     }
 
     return result;
 }
 
-static const REFLECTED_SOMETHING* FindReportedProperty(DEVICE_HEADER_DATA* deviceHeader, void* value, const char* modelName, size_t startOffset, STRING_HANDLE valuePath)
+/*a value is a property only when it points at the first byte of that property*/
+static const PROPERTY_INDEX_ENTRY* FindInPropertyIndex(const PROPERTY_INDEX* propertyIndex, const DEVICE_HEADER_DATA* deviceHeader, const void* value)
 {
-    const REFLECTED_SOMETHING* result;
-    size_t valueOffset = (size_t)((unsigned char*)value - (unsigned char*)deviceHeader->data) - startOffset;
+    const PROPERTY_INDEX_ENTRY* result = NULL;
+    size_t valueOffset = (size_t)((const unsigned char*)value - deviceHeader->data);
+    size_t low = 0;
+    size_t high = propertyIndex->count;
 
-    for (result = deviceHeader->ReflectedData->reflectedData; result != NULL; result = result->next)
+    while (low < high)
     {
-        if (result->type == REFLECTION_REPORTED_PROPERTY_TYPE &&
-            (strcmp(result->what.reportedProperty.modelName, modelName) == 0) &&
-            (result->what.reportedProperty.offset <= valueOffset) &&
-            (result->what.reportedProperty.offset + result->what.reportedProperty.size > valueOffset))
+        size_t middle = low + (high - low) / 2;
+        if (propertyIndex->entries[middle].offset < valueOffset)
         {
-            if (startOffset != 0)
-            {
-                if (STRING_concat(valuePath, "/") != 0)
-                {
-                    LogError("unable to STRING_concat");
-                    result = NULL;
-                    break;
-                }
-            }
-
-            if (STRING_concat(valuePath, result->what.reportedProperty.name) != 0)
-            {
-                LogError("unable to STRING_concat");
-                result = NULL;
-                break;
-            }
-            break;
+            low = middle + 1;
         }
-    }
-
-    if (result != NULL)
-    {
-        /* Codes_SRS_CODEFIRST_99_133:[CodeFirst_SendAsync shall allow sending of properties that are part of a child model.] */
-        if (result->what.reportedProperty.offset < valueOffset)
+        else if (propertyIndex->entries[middle].offset > valueOffset)
+        {
+            high = middle;
+        }
+        else
         {
-            /* find recursively the property in the inner model, if there is one */
-            result = FindReportedProperty(deviceHeader, value, result->what.reportedProperty.type, startOffset + result->what.reportedProperty.offset, valuePath);
+            result = &propertyIndex->entries[middle];
+            break;
         }
     }
 
@@ -1265,70 +1385,50 @@ CODEFIRST_RESULT CodeFirst_SendAsync(unsigned char** destination, size_t* destin
                 }
                 else
                 {
-                    const REFLECTED_SOMETHING* propertyReflectedData;
-                    const char* modelName;
-                    STRING_HANDLE valuePath;
+                    const PROPERTY_INDEX_ENTRY* property;
 
-                    if ((valuePath = STRING_new()) == NULL)
+                    if (BuildPropertyIndex(deviceHeader) != CODEFIRST_OK)
                     {
                         /* Codes_SRS_CODEFIRST_99_134:[If CodeFirst_Notify fails for any other reason it shall return CODEFIRST_ERROR.] */
                         result = CODEFIRST_ERROR;
                         LOG_CODEFIRST_ERROR;
                         break;
                     }
+                    else if ((property = FindInPropertyIndex(&deviceHeader->Properties, deviceHeader, value)) == NULL)
+                    {
+                        /* Codes_SRS_CODEFIRST_99_104:[If a property cannot be associated with a device, CodeFirst_SendAsync shall return CODEFIRST_INVALID_ARG.] */
+                        result = CODEFIRST_INVALID_ARG;
+                        LOG_CODEFIRST_ERROR;
+                        break;
+                    }
                     else
                     {
-                        if ((modelName = Schema_GetModelName(deviceHeader->ModelHandle)) == NULL)
-                        {
-                            /* Codes_SRS_CODEFIRST_99_134:[If CodeFirst_Notify fails for any other reason it shall return CODEFIRST_ERROR.] */
-                            result = CODEFIRST_ERROR;
-                            LOG_CODEFIRST_ERROR;
-                            STRING_delete(valuePath);
-                            break;
-                        }
-                        else if ((propertyReflectedData = FindValue(deviceHeader, value, modelName, 0, valuePath)) == NULL)
+                        AGENT_DATA_TYPE agentDataType;
+
+                        /* Codes_SRS_CODEFIRST_99_097:[For each value marshalling to AGENT_DATA_TYPE shall be performed.] */
+                        /* Codes_SRS_CODEFIRST_99_098:[The marshalling shall be done by calling the Create_AGENT_DATA_TYPE_from_Ptr function associated with the property.] */
+                        if (property->Create_AGENT_DATA_TYPE_from_Ptr(value, &agentDataType) != AGENT_DATA_TYPES_OK)
                         {
-                            /* Codes_SRS_CODEFIRST_99_104:[If a property cannot be associated with a device, CodeFirst_SendAsync shall return CODEFIRST_INVALID_ARG.] */
-                            result = CODEFIRST_INVALID_ARG;
+                            /* Codes_SRS_CODEFIRST_99_099:[If Create_AGENT_DATA_TYPE_from_Ptr fails, CodeFirst_SendAsync shall return CODEFIRST_AGENT_DATA_TYPE_ERROR.] */
+                            result = CODEFIRST_AGENT_DATA_TYPE_ERROR;
                             LOG_CODEFIRST_ERROR;
-                            STRING_delete(valuePath);
                             break;
                         }
                         else
                         {
-                            AGENT_DATA_TYPE agentDataType;
-
-                            /* Codes_SRS_CODEFIRST_99_097:[For each value marshalling to AGENT_DATA_TYPE shall be performed.] */
-                            /* Codes_SRS_CODEFIRST_99_098:[The marshalling shall be done by calling the Create_AGENT_DATA_TYPE_from_Ptr function associated with the property.] */
-                            if (propertyReflectedData->what.property.Create_AGENT_DATA_TYPE_from_Ptr(value, &agentDataType) != AGENT_DATA_TYPES_OK)
+                            /* Codes_SRS_CODEFIRST_99_092:[CodeFirst shall publish each value by using Device_PublishTransacted.] */
+                            /* Codes_SRS_CODEFIRST_99_136:[CodeFirst_SendAsync shall build the full path for each property and then pass it to Device_PublishTransacted.] */
+                            if (Device_PublishTransacted(transaction, property->path, &agentDataType) != DEVICE_OK)
                             {
-                                /* Codes_SRS_CODEFIRST_99_099:[If Create_AGENT_DATA_TYPE_from_Ptr fails, CodeFirst_SendAsync shall return CODEFIRST_AGENT_DATA_TYPE_ERROR.] */
-                                result = CODEFIRST_AGENT_DATA_TYPE_ERROR;
+                                Destroy_AGENT_DATA_TYPE(&agentDataType);
+
+                                /* Codes_SRS_CODEFIRST_99_094:[If any Device API fail, CodeFirst_SendAsync shall return CODEFIRST_DEVICE_PUBLISH_FAILED.] */
+                                result = CODEFIRST_DEVICE_PUBLISH_FAILED;
                                 LOG_CODEFIRST_ERROR;
-                                STRING_delete(valuePath);
                                 break;
                             }
-                            else
-                            {
-                                /* Codes_SRS_CODEFIRST_99_092:[CodeFirst shall publish each value by using Device_PublishTransacted.] */
-                                /* Codes_SRS_CODEFIRST_99_136:[CodeFirst_SendAsync shall build the full path for each property and then pass it to Device_PublishTransacted.] */
-                                if (Device_PublishTransacted(transaction, STRING_c_str(valuePath), &agentDataType) != DEVICE_OK)
-                                {
-                                    Destroy_AGENT_DATA_TYPE(&agentDataType);
-
-                                    /* Codes_SRS_CODEFIRST_99_094:[If any Device API fail, CodeFirst_SendAsync shall return CODEFIRST_DEVICE_PUBLISH_FAILED.] */
-                                    result = CODEFIRST_DEVICE_PUBLISH_FAILED;
-                                    LOG_CODEFIRST_ERROR;
-                                    STRING_delete(valuePath);
-                                    break;
-                                }
-                                else
-                                {
-                                    STRING_delete(valuePath); /*anyway*/
-                                }
 
-                                Destroy_AGENT_DATA_TYPE(&agentDataType);
-                            }
+                            Destroy_AGENT_DATA_TYPE(&agentDataType);
                         }
                     }
                 }
@@ -1362,7 +1462,7 @@ CODEFIRST_RESULT CodeFirst_SendAsync(unsigned char** destination, size_t* destin
     return result;
 }
 
-CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, ...)
+static CODEFIRST_RESULT SendAsyncReported(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, va_list ap, bool onlyChanges)
 {
     CODEFIRST_RESULT result;
     if ((destination == NULL) || (destinationSize == NULL) || numReportedProperties == 0)
@@ -1379,11 +1479,8 @@ CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t
         DEVICE_HEADER_DATA* deviceHeader = NULL;
         size_t i;
         REPORTED_PROPERTIES_TRANSACTION_HANDLE transaction = NULL;
-        va_list ap;
         result = CODEFIRST_ACTION_EXECUTION_ERROR; /*this initialization squelches a false warning about result not being initialized*/
 
-        va_start(ap, numReportedProperties);
-
         for (i = 0; i < numReportedProperties; i++)
         {
             void* value = (void*)va_arg(ap, void*);
@@ -1434,57 +1531,43 @@ CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t
                     }
                     else
                     {
-                        /*Codes_SRS_CODEFIRST_02_020: [ If values passed through va_args are not all of type REFLECTED_REPORTED_PROPERTY then CodeFirst_SendAsyncReported shall fail and return CODEFIRST_INVALID_ARG. ]*/
-                        const REFLECTED_SOMETHING* propertyReflectedData;
-                        const char* modelName;
+                        const PROPERTY_INDEX_ENTRY* reportedProperty;
 
-                        STRING_HANDLE valuePath;
-                        if ((valuePath = STRING_new()) == NULL)
+                        if (BuildPropertyIndex(deviceHeader) != CODEFIRST_OK)
                         {
                             result = CODEFIRST_ERROR;
                             LOG_CODEFIRST_ERROR;
                             break;
                         }
+                        /*Codes_SRS_CODEFIRST_02_020: [ If values passed through va_args are not all of type REFLECTED_REPORTED_PROPERTY then CodeFirst_SendAsyncReported shall fail and return CODEFIRST_INVALID_ARG. ]*/
+                        /*Codes_SRS_CODEFIRST_02_025: [ CodeFirst_SendAsyncReported shall compute for every AGENT_DATA_TYPE the valuePath. ]*/
+                        else if ((reportedProperty = FindInPropertyIndex(&deviceHeader->ReportedProperties, deviceHeader, value)) == NULL)
+                        {
+                            result = CODEFIRST_INVALID_ARG;
+                            LOG_CODEFIRST_ERROR;
+                            break;
+                        }
                         else
                         {
-                            modelName = Schema_GetModelName(deviceHeader->ModelHandle);
-
-                            /*Codes_SRS_CODEFIRST_02_025: [ CodeFirst_SendAsyncReported shall compute for every AGENT_DATA_TYPE the valuePath. ]*/
-                            if ((propertyReflectedData = FindReportedProperty(deviceHeader, value, modelName, 0, valuePath)) == NULL)
+                            AGENT_DATA_TYPE agentDataType;
+                            /*Codes_SRS_CODEFIRST_02_023: [ CodeFirst_SendAsyncReported shall convert all REPORTED_PROPERTY model components to AGENT_DATA_TYPE. ]*/
+                            if (reportedProperty->Create_AGENT_DATA_TYPE_from_Ptr(value, &agentDataType) != AGENT_DATA_TYPES_OK)
                             {
-                                result = CODEFIRST_INVALID_ARG;
+                                result = CODEFIRST_AGENT_DATA_TYPE_ERROR;
                                 LOG_CODEFIRST_ERROR;
-                                STRING_delete(valuePath);
                                 break;
                             }
                             else
                             {
-                                AGENT_DATA_TYPE agentDataType;
-                                /*Codes_SRS_CODEFIRST_02_023: [ CodeFirst_SendAsyncReported shall convert all REPORTED_PROPERTY model components to AGENT_DATA_TYPE. ]*/
-                                if (propertyReflectedData->what.reportedProperty.Create_AGENT_DATA_TYPE_from_Ptr(value, &agentDataType) != AGENT_DATA_TYPES_OK)
+                                /*Codes_SRS_CODEFIRST_02_024: [ CodeFirst_SendAsyncReported shall call Device_PublishTransacted_ReportedProperty for every AGENT_DATA_TYPE converted from REPORTED_PROPERTY. ]*/
+                                if (Device_PublishTransacted_ReportedProperty(transaction, reportedProperty->path, &agentDataType) != DEVICE_OK)
                                 {
-                                    result = CODEFIRST_AGENT_DATA_TYPE_ERROR;
+                                    Destroy_AGENT_DATA_TYPE(&agentDataType);
+                                    result = CODEFIRST_DEVICE_PUBLISH_FAILED;
                                     LOG_CODEFIRST_ERROR;
-                                    STRING_delete(valuePath);
                                     break;
                                 }
-                                else
-                                {
-                                    /*Codes_SRS_CODEFIRST_02_024: [ CodeFirst_SendAsyncReported shall call Device_PublishTransacted_ReportedProperty for every AGENT_DATA_TYPE converted from REPORTED_PROPERTY. ]*/
-                                    if (Device_PublishTransacted_ReportedProperty(transaction, STRING_c_str(valuePath), &agentDataType) != DEVICE_OK)
-                                    {
-                                        Destroy_AGENT_DATA_TYPE(&agentDataType);
-                                        result = CODEFIRST_DEVICE_PUBLISH_FAILED;
-                                        LOG_CODEFIRST_ERROR;
-                                        STRING_delete(valuePath);
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        STRING_delete(valuePath);
-                                    }
-                                    Destroy_AGENT_DATA_TYPE(&agentDataType);
-                                }
+                                Destroy_AGENT_DATA_TYPE(&agentDataType);
                             }
                         }
                     }
@@ -1500,10 +1583,21 @@ CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t
                 Device_DestroyTransaction_ReportedProperties(transaction);
             }
         }
-        /*Codes_SRS_CODEFIRST_02_026: [ CodeFirst_SendAsyncReported shall call Device_CommitTransaction_ReportedProperties to commit the transaction. ]*/
         else
         {
-            if (Device_CommitTransaction_ReportedProperties(transaction, destination, destinationSize) != DEVICE_OK)
+            DEVICE_RESULT commitResult;
+            if (onlyChanges)
+            {
+                /*Codes_SRS_CODEFIRST_99_152: [ CodeFirst_SendAsyncReportedChanges shall call Device_CommitTransaction_ReportedPropertiesChanges to commit the transaction. ]*/
+                commitResult = Device_CommitTransaction_ReportedPropertiesChanges(transaction, destination, destinationSize);
+            }
+            else
+            {
+                /*Codes_SRS_CODEFIRST_02_026: [ CodeFirst_SendAsyncReported shall call Device_CommitTransaction_ReportedProperties to commit the transaction. ]*/
+                commitResult = Device_CommitTransaction_ReportedProperties(transaction, destination, destinationSize);
+            }
+
+            if (commitResult != DEVICE_OK)
             {
                 result = CODEFIRST_DEVICE_PUBLISH_FAILED;
                 LOG_CODEFIRST_ERROR;
@@ -1517,12 +1611,31 @@ CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t
             /*Codes_SRS_CODEFIRST_02_029: [ CodeFirst_SendAsyncReported shall call Device_DestroyTransaction_ReportedProperties to destroy the transaction. ]*/
             Device_DestroyTransaction_ReportedProperties(transaction);
         }
-
-        va_end(ap);
     }
     return result;
 }
 
+CODEFIRST_RESULT CodeFirst_SendAsyncReported(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, ...)
+{
+    CODEFIRST_RESULT result;
+    va_list ap;
+    va_start(ap, numReportedProperties);
+    result = SendAsyncReported(destination, destinationSize, numReportedProperties, ap, false);
+    va_end(ap);
+    return result;
+}
+
+/*Codes_SRS_CODEFIRST_99_151: [ CodeFirst_SendAsyncReportedChanges shall behave as CodeFirst_SendAsyncReported, except for committing the transaction. ]*/
+CODEFIRST_RESULT CodeFirst_SendAsyncReportedChanges(unsigned char** destination, size_t* destinationSize, size_t numReportedProperties, ...)
+{
+    CODEFIRST_RESULT result;
+    va_list ap;
+    va_start(ap, numReportedProperties);
+    result = SendAsyncReported(destination, destinationSize, numReportedProperties, ap, true);
+    va_end(ap);
+    return result;
+}
+
 EXECUTE_COMMAND_RESULT CodeFirst_ExecuteCommand(void* device, const char* command)
 {
     EXECUTE_COMMAND_RESULT result;
@@ -1581,6 +1694,43 @@ METHODRETURN_HANDLE CodeFirst_ExecuteMethod(void* device, const char* methodName
     return result;
 }
 
+CODEFIRST_RESULT CodeFirst_ResetReportedPropertiesChanges(void* device)
+{
+    CODEFIRST_RESULT result;
+    /*Codes_SRS_CODEFIRST_99_153: [ If argument device is NULL then CodeFirst_ResetReportedPropertiesChanges shall fail and return CODEFIRST_INVALID_ARG. ]*/
+    if (device == NULL)
+    {
+        LogError("invalid argument void* device=%p", device);
+        result = CODEFIRST_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CODEFIRST_99_154: [ CodeFirst_ResetReportedPropertiesChanges shall locate the device associated with device. ]*/
+        DEVICE_HEADER_DATA* deviceHeader = FindDevice(device);
+        if (deviceHeader == NULL)
+        {
+            /*Codes_SRS_CODEFIRST_99_156: [ If there is any failure, then CodeFirst_ResetReportedPropertiesChanges shall fail and return CODEFIRST_ERROR. ]*/
+            LogError("unable to find a device having this memory address %p", device);
+            result = CODEFIRST_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_CODEFIRST_99_155: [ CodeFirst_ResetReportedPropertiesChanges shall call Device_ResetReportedPropertiesChanges. ]*/
+            if (Device_ResetReportedPropertiesChanges(deviceHeader->DeviceHandle) != DEVICE_OK)
+            {
+                LogError("failure in Device_ResetReportedPropertiesChanges");
+                result = CODEFIRST_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_CODEFIRST_99_157: [ Otherwise, CodeFirst_ResetReportedPropertiesChanges shall return CODEFIRST_OK. ]*/
+                result = CODEFIRST_OK;
+            }
+        }
+    }
+    return result;
+}
+
 CODEFIRST_RESULT CodeFirst_IngestDesiredProperties(void* device, const char* jsonPayload, bool parseDesiredNode)
 {
     CODEFIRST_RESULT result;
@@ -1622,4 +1772,44 @@ CODEFIRST_RESULT CodeFirst_IngestDesiredProperties(void* device, const char* jso
     return result;
 }
 
+CODEFIRST_RESULT CodeFirst_IngestDesiredPropertiesChanges(void* device, const char* jsonPayload, bool parseDesiredNode)
+{
+    CODEFIRST_RESULT result;
+    /*Codes_SRS_CODEFIRST_99_146: [ If argument device or jsonPayload is NULL then CodeFirst_IngestDesiredPropertiesChanges shall fail and return CODEFIRST_INVALID_ARG. ]*/
+    if (
+        (device == NULL) ||
+        (jsonPayload == NULL)
+        )
+    {
+        LogError("invalid argument void* device=%p, const char* jsonPayload=%p", device, jsonPayload);
+        result = CODEFIRST_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CODEFIRST_99_147: [ CodeFirst_IngestDesiredPropertiesChanges shall locate the device associated with device. ]*/
+        DEVICE_HEADER_DATA* deviceHeader = FindDevice(device);
+        if (deviceHeader == NULL)
+        {
+            /*Codes_SRS_CODEFIRST_99_149: [ If there is any failure, then CodeFirst_IngestDesiredPropertiesChanges shall fail and return CODEFIRST_ERROR. ]*/
+            LogError("unable to find a device having this memory address %p", device);
+            result = CODEFIRST_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_CODEFIRST_99_148: [ CodeFirst_IngestDesiredPropertiesChanges shall call Device_IngestDesiredPropertiesChanges. ]*/
+            if (Device_IngestDesiredPropertiesChanges(device, deviceHeader->DeviceHandle, jsonPayload, parseDesiredNode) != DEVICE_OK)
+            {
+                LogError("failure in Device_IngestDesiredPropertiesChanges");
+                result = CODEFIRST_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_CODEFIRST_99_150: [ Otherwise, CodeFirst_IngestDesiredPropertiesChanges shall return CODEFIRST_OK. ]*/
+                result = CODEFIRST_OK;
+            }
+        }
+    }
+    return result;
+}
+
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
 #include "azure_c_shared_utility/optimize_size.h"
 #include "azure_c_shared_utility/gballoc.h"
 
@@ -795,10 +796,62 @@ void CommandDecoder_Destroy(COMMAND_DECODER_HANDLE commandDecoderHandle)
 
 DEFINE_ENUM_STRINGS(AGENT_DATA_TYPE_TYPE, AGENT_DATA_TYPE_TYPE_VALUES);
 
+/*Codes_SRS_COMMAND_DECODER_99_060: [ CommandDecoder_IngestDesiredPropertiesChanges shall read the current value of a desired property out of the device memory by calling its pfDesiredPropertyToAGENT_DATA_TYPE, convert both the current and the new value to strings by calling AgentDataTypes_ToString and compare them. ]*/
+/*Codes_SRS_COMMAND_DECODER_99_063: [ If either value cannot be converted, the desired property shall be treated as changed. ]*/
+static bool DesiredPropertyHasChanged(SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle, const void* currentValueAddress, const AGENT_DATA_TYPE* value)
+{
+    bool result;
+    pfDesiredPropertyToAGENT_DATA_TYPE toAGENT_DATA_TYPE = Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(desiredPropertyHandle);
+    AGENT_DATA_TYPE currentValue;
+
+    if (toAGENT_DATA_TYPE == NULL)
+    {
+        LogError("failure in Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE, the desired property is considered changed");
+        result = true;
+    }
+    else if (toAGENT_DATA_TYPE(currentValueAddress, &currentValue) != 0)
+    {
+        LogError("failure in a function that converts from C data to AGENT_DATA_TYPE, the desired property is considered changed");
+        result = true;
+    }
+    else
+    {
+        STRING_HANDLE currentValueAsString = STRING_new();
+        STRING_HANDLE valueAsString = STRING_new();
+        if ((currentValueAsString == NULL) || (valueAsString == NULL))
+        {
+            LogError("failure in STRING_new, the desired property is considered changed");
+            result = true;
+        }
+        else if ((AgentDataTypes_ToString(currentValueAsString, &currentValue) != AGENT_DATA_TYPES_OK) ||
+            (AgentDataTypes_ToString(valueAsString, value) != AGENT_DATA_TYPES_OK))
+        {
+            LogError("failure in AgentDataTypes_ToString, the desired property is considered changed");
+            result = true;
+        }
+        else
+        {
+            result = (strcmp(STRING_c_str(currentValueAsString), STRING_c_str(valueAsString)) != 0);
+        }
+
+        if (valueAsString != NULL)
+        {
+            STRING_delete(valueAsString);
+        }
+        if (currentValueAsString != NULL)
+        {
+            STRING_delete(currentValueAsString);
+        }
+        Destroy_AGENT_DATA_TYPE(&currentValue);
+    }
+    return result;
+}
+
 /*validates that the multitree (coming from a JSON) is actually a serialization of the model (complete or incomplete)*/
 /*if the serialization contains more than the model, then it fails.*/
 /*if the serialization does not contain mandatory items from the model, it fails*/
-static bool validateModel_vs_Multitree(void* startAddress, SCHEMA_MODEL_TYPE_HANDLE modelHandle, MULTITREE_HANDLE desiredPropertiesTree, size_t offset)
+/*when onlyChanges is true only the desired properties whose value differs from the one in the device memory are written, *changed tells if any was*/
+static bool validateModel_vs_Multitree(void* startAddress, SCHEMA_MODEL_TYPE_HANDLE modelHandle, MULTITREE_HANDLE desiredPropertiesTree, size_t offset, bool onlyChanges, bool* changed)
 {
     
     bool result;
@@ -866,22 +919,31 @@ static bool validateModel_vs_Multitree(void* startAddress, SCHEMA_MODEL_TYPE_HAN
                             }
                             else
                             {
-                                /*Codes_SRS_COMMAND_DECODER_02_008: [ The desired property shall be constructed in memory by calling pfDesiredPropertyFromAGENT_DATA_TYPE. ]*/
-                                pfDesiredPropertyFromAGENT_DATA_TYPE leFunction = Schema_GetModelDesiredProperty_pfDesiredPropertyFromAGENT_DATA_TYPE(desiredPropertyHandle);
-                                if (leFunction(&output, (char*)startAddress + offset + Schema_GetModelDesiredProperty_offset(desiredPropertyHandle)) != 0)
+                                /*Codes_SRS_COMMAND_DECODER_99_061: [ If the value is the same, CommandDecoder_IngestDesiredPropertiesChanges shall neither write the desired property nor call its pfOnDesiredProperty. ]*/
+                                if (!onlyChanges ||
+                                    DesiredPropertyHasChanged(desiredPropertyHandle, (char*)startAddress + offset + Schema_GetModelDesiredProperty_offset(desiredPropertyHandle), &output))
                                 {
-                                    LogError("failure in a function that converts from AGENT_DATA_TYPE to C data");
-                                }
-                                else
-                                {
-                                    /*Codes_SRS_COMMAND_DECODER_02_013: [ If the desired property has a non-NULL pfOnDesiredProperty then it shall be called. ]*/
-                                    pfOnDesiredProperty onDesiredProperty = Schema_GetModelDesiredProperty_pfOnDesiredProperty(desiredPropertyHandle);
-                                    if (onDesiredProperty != NULL)
+                                    /*Codes_SRS_COMMAND_DECODER_02_008: [ The desired property shall be constructed in memory by calling pfDesiredPropertyFromAGENT_DATA_TYPE. ]*/
+                                    pfDesiredPropertyFromAGENT_DATA_TYPE leFunction = Schema_GetModelDesiredProperty_pfDesiredPropertyFromAGENT_DATA_TYPE(desiredPropertyHandle);
+                                    if (leFunction(&output, (char*)startAddress + offset + Schema_GetModelDesiredProperty_offset(desiredPropertyHandle)) != 0)
                                     {
-                                        onDesiredProperty((char*)startAddress + offset);
+                                        LogError("failure in a function that converts from AGENT_DATA_TYPE to C data");
+                                    }
+                                    else
+                                    {
+                                        pfOnDesiredProperty onDesiredProperty;
+
+                                        /*Codes_SRS_COMMAND_DECODER_02_013: [ If the desired property has a non-NULL pfOnDesiredProperty then it shall be called. ]*/
+                                        onDesiredProperty = Schema_GetModelDesiredProperty_pfOnDesiredProperty(desiredPropertyHandle);
+                                        if (onDesiredProperty != NULL)
+                                        {
+                                            onDesiredProperty((char*)startAddress + offset);
+                                        }
+                                        *changed = true;
                                     }
-                                    nProcessedChildren++;
                                 }
+                                nProcessedChildren++;
+
                                 Destroy_AGENT_DATA_TYPE(&output);
                             }
                             
@@ -890,21 +952,27 @@ static bool validateModel_vs_Multitree(void* startAddress, SCHEMA_MODEL_TYPE_HAN
                         case(SCHEMA_MODEL_IN_MODEL):
                         {
                             SCHEMA_MODEL_TYPE_HANDLE modelModel = elementType.elementHandle.modelHandle;
+                            bool modelModelChanged = false;
                             
                             /*Codes_SRS_COMMAND_DECODER_02_009: [ If the child name corresponds to a model in model then the function shall call itself recursively. ]*/
-                            if (!validateModel_vs_Multitree(startAddress, modelModel, child, offset + Schema_GetModelModelByName_Offset(modelHandle, childName_str)))
+                            if (!validateModel_vs_Multitree(startAddress, modelModel, child, offset + Schema_GetModelModelByName_Offset(modelHandle, childName_str), onlyChanges, &modelModelChanged))
                             {
                                 LogError("failure in validateModel_vs_Multitree");
                                 i = nChildren;
                             }
                             else
                             {
-                                /*if the model in model so happened to be a WITH_DESIRED_PROPERTY... (only those has non_NULL pfOnDesiredProperty) */
-                                /*Codes_SRS_COMMAND_DECODER_02_012: [ If the child model in model has a non-NULL pfOnDesiredProperty then pfOnDesiredProperty shall be called. ]*/
-                                pfOnDesiredProperty onDesiredProperty = Schema_GetModelModelByName_OnDesiredProperty(modelHandle, childName_str);
-                                if (onDesiredProperty != NULL)
+                                /*Codes_SRS_COMMAND_DECODER_99_062: [ CommandDecoder_IngestDesiredPropertiesChanges shall call the pfOnDesiredProperty of a model in model only if at least one of its desired properties changed. ]*/
+                                if (!onlyChanges || modelModelChanged)
                                 {
-                                    onDesiredProperty((char*)startAddress + offset);
+                                    /*if the model in model so happened to be a WITH_DESIRED_PROPERTY... (only those has non_NULL pfOnDesiredProperty) */
+                                    /*Codes_SRS_COMMAND_DECODER_02_012: [ If the child model in model has a non-NULL pfOnDesiredProperty then pfOnDesiredProperty shall be called. ]*/
+                                    pfOnDesiredProperty onDesiredProperty = Schema_GetModelModelByName_OnDesiredProperty(modelHandle, childName_str);
+                                    if (onDesiredProperty != NULL)
+                                    {
+                                        onDesiredProperty((char*)startAddress + offset);
+                                    }
+                                    *changed = true;
                                 }
                                 
                                 nProcessedChildren++;
@@ -934,10 +1002,11 @@ static bool validateModel_vs_Multitree(void* startAddress, SCHEMA_MODEL_TYPE_HAN
     return result;
 }
 
-static EXECUTE_COMMAND_RESULT DecodeDesiredProperties(void* startAddress, COMMAND_DECODER_HANDLE_DATA* handle, MULTITREE_HANDLE desiredPropertiesTree)
+static EXECUTE_COMMAND_RESULT DecodeDesiredProperties(void* startAddress, COMMAND_DECODER_HANDLE_DATA* handle, MULTITREE_HANDLE desiredPropertiesTree, bool onlyChanges)
 {
+    bool changed = false;
     /*Codes_SRS_COMMAND_DECODER_02_006: [ CommandDecoder_IngestDesiredProperties shall parse the MULTITREEE recursively. ]*/
-    return validateModel_vs_Multitree(startAddress, handle->ModelHandle, desiredPropertiesTree, 0 )?EXECUTE_COMMAND_SUCCESS:EXECUTE_COMMAND_FAILED;
+    return validateModel_vs_Multitree(startAddress, handle->ModelHandle, desiredPropertiesTree, 0, onlyChanges, &changed)?EXECUTE_COMMAND_SUCCESS:EXECUTE_COMMAND_FAILED;
 }
 
 /* Raw JSON has properties we don't need; potentially nodes other than "desired" for full TWIN as well as a $version we don't pass to callees */
@@ -977,7 +1046,7 @@ static bool RemoveUnneededTwinProperties(MULTITREE_HANDLE initialParsedTree, boo
     return result;
 }
 
-EXECUTE_COMMAND_RESULT CommandDecoder_IngestDesiredProperties(void* startAddress, COMMAND_DECODER_HANDLE handle, const char* jsonPayload, bool parseDesiredNode)
+static EXECUTE_COMMAND_RESULT IngestDesiredProperties(void* startAddress, COMMAND_DECODER_HANDLE handle, const char* jsonPayload, bool parseDesiredNode, bool onlyChanges)
 {
     EXECUTE_COMMAND_RESULT result;
     
@@ -1025,7 +1094,7 @@ EXECUTE_COMMAND_RESULT CommandDecoder_IngestDesiredProperties(void* startAddress
                     COMMAND_DECODER_HANDLE_DATA* commandDecoderInstance = (COMMAND_DECODER_HANDLE_DATA*)handle;
 
                     /*Codes_SRS_COMMAND_DECODER_02_006: [ CommandDecoder_IngestDesiredProperties shall parse the MULTITREEE recursively. ]*/
-                    result = DecodeDesiredProperties(startAddress, commandDecoderInstance, desiredPropertiesTree);
+                    result = DecodeDesiredProperties(startAddress, commandDecoderInstance, desiredPropertiesTree, onlyChanges);
 
                     // Do NOT free desiredPropertiesTree.  It is only a pointer into initialParsedTree.
                     MultiTree_Destroy(initialParsedTree);
@@ -1036,3 +1105,14 @@ EXECUTE_COMMAND_RESULT CommandDecoder_IngestDesiredProperties(void* startAddress
     }
     return result;
 }
+
+EXECUTE_COMMAND_RESULT CommandDecoder_IngestDesiredProperties(void* startAddress, COMMAND_DECODER_HANDLE handle, const char* jsonPayload, bool parseDesiredNode)
+{
+    return IngestDesiredProperties(startAddress, handle, jsonPayload, parseDesiredNode, false);
+}
+
+/*Codes_SRS_COMMAND_DECODER_99_064: [ CommandDecoder_IngestDesiredPropertiesChanges shall behave as CommandDecoder_IngestDesiredProperties for the desired properties whose value changed. ]*/
+EXECUTE_COMMAND_RESULT CommandDecoder_IngestDesiredPropertiesChanges(void* startAddress, COMMAND_DECODER_HANDLE handle, const char* jsonPayload, bool parseDesiredNode)
+{
+    return IngestDesiredProperties(startAddress, handle, jsonPayload, parseDesiredNode, true);
+}
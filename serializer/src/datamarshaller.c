@@ -36,6 +36,104 @@ static void NoFreeFunction(void* value)
     (void)value;
 }
 
+static void GetValueMember(const void* members, size_t index, const char** name, const void** value)
+{
+    const DATA_MARSHALLER_VALUE* values = (const DATA_MARSHALLER_VALUE*)members;
+    *name = values[index].PropertyPath;
+    *value = values[index].Value;
+}
+
+static void GetFieldMember(const void* members, size_t index, const char** name, const void** value)
+{
+    const COMPLEX_TYPE_FIELD_TYPE* fields = (const COMPLEX_TYPE_FIELD_TYPE*)members;
+    *name = fields[index].fieldName;
+    *value = fields[index].value;
+}
+
+/*true when every name is a single, non empty, path component and no 2 names are the same, that is when the JSON object has no inner objects*/
+static bool IsFlatObject(const void* members, size_t memberCount, JSON_ENCODER_GET_MEMBER_FUNC getMember)
+{
+    bool result = true;
+    size_t i;
+    for (i = 0; (i < memberCount) && result; i++)
+    {
+        const char* name;
+        const void* value;
+        size_t j;
+        getMember(members, i, &name, &value);
+        if ((name == NULL) ||
+            (name[0] == '\0') ||
+            (strchr(name, '/') != NULL))
+        {
+            result = false;
+        }
+        else
+        {
+            for (j = 0; j < i; j++)
+            {
+                const char* previousName;
+                getMember(members, j, &previousName, &value);
+                if (strcmp(previousName, name) == 0)
+                {
+                    /*the MultiTree path reports the duplicate*/
+                    result = false;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static DATA_MARSHALLER_RESULT CopyPayload(STRING_HANDLE payload, unsigned char** destination, size_t* destinationSize)
+{
+    DATA_MARSHALLER_RESULT result;
+    /*Codes_SRS_DATAMARSHALLER_02_007: [DataMarshaller_SendData shall copy in the output parameters *destination, *destinationSize the content and the content length of the encoded JSON tree.] */
+    size_t resultSize = STRING_length(payload);
+    unsigned char* temp = malloc(resultSize);
+    if (temp == NULL)
+    {
+        /*Codes_SRS_DATA_MARSHALLER_99_015:[ DATA_MARSHALLER_ERROR shall be returned in all the other error cases not explicitly defined here.]*/
+        result = DATA_MARSHALLER_ERROR;
+        LOG_DATA_MARSHALLER_ERROR;
+    }
+    else
+    {
+        (void)memcpy(temp, STRING_c_str(payload), resultSize);
+        *destination = temp;
+        *destinationSize = resultSize;
+        result = DATA_MARSHALLER_OK;
+    }
+    return result;
+}
+
+/*Codes_SRS_DATA_MARSHALLER_99_049: [ When the JSON object has no inner objects, DataMarshaller_SendData shall not build a MultiTree and shall have JSONEncoder_EncodeObject write the members straight into the payload. ]*/
+static DATA_MARSHALLER_RESULT SendFlatObject(const void* members, size_t memberCount, JSON_ENCODER_GET_MEMBER_FUNC getMember, unsigned char** destination, size_t* destinationSize)
+{
+    DATA_MARSHALLER_RESULT result;
+    STRING_HANDLE payload = STRING_new();
+    if (payload == NULL)
+    {
+        result = DATA_MARSHALLER_ERROR;
+        LOG_DATA_MARSHALLER_ERROR
+    }
+    else
+    {
+        if (JSONEncoder_EncodeObject(members, memberCount, getMember, payload, (JSON_ENCODER_TOSTRING_FUNC)AgentDataTypes_ToString) != JSON_ENCODER_OK)
+        {
+            /* Codes_SRS_DATA_MARSHALLER_99_027:[ DATA_MARSHALLER_JSON_ENCODER_ERROR shall be returned when JSONEncoder returns an error code.] */
+            result = DATA_MARSHALLER_JSON_ENCODER_ERROR;
+            LOG_DATA_MARSHALLER_ERROR
+        }
+        else
+        {
+            result = CopyPayload(payload, destination, destinationSize);
+        }
+        STRING_delete(payload);
+    }
+    return result;
+}
+
 DATA_MARSHALLER_HANDLE DataMarshaller_Create(SCHEMA_MODEL_TYPE_HANDLE modelHandle, bool includePropertyPath)
 {
     DATA_MARSHALLER_HANDLE_DATA* result;
@@ -118,7 +216,24 @@ DATA_MARSHALLER_RESULT DataMarshaller_SendData(DATA_MARSHALLER_HANDLE dataMarsha
             }
         }
 
-        if (i == valueCount)
+        if (i < valueCount)
+        {
+            /*result is already set*/
+        }
+        else if ((includePropertyPath == false) &&
+            (values[0].Value->type == EDM_COMPLEX_TYPE_TYPE) &&
+            IsFlatObject(values[0].Value->value.edmComplexType.fields, values[0].Value->value.edmComplexType.nMembers, GetFieldMember))
+        {
+            /* Codes_SRS_DATAMARSHALLER_01_001: [If the includePropertyPath argument passed to DataMarshaller_Create was false and only one struct is being sent, the relative path of the value passed to DataMarshaller_SendData - including property name - shall be ignored and the value shall be placed at JSON root.] */
+            result = SendFlatObject(values[0].Value->value.edmComplexType.fields, values[0].Value->value.edmComplexType.nMembers, GetFieldMember, destination, destinationSize);
+        }
+        else if (((includePropertyPath == true) || (values[0].Value->type != EDM_COMPLEX_TYPE_TYPE)) &&
+            IsFlatObject(values, valueCount, GetValueMember))
+        {
+            /* Codes_SRS_DATA_MARSHALLER_99_038:[For each pair in the values argument, a string : value pair shall exist in the JSON object in the form of propertyName : value.] */
+            result = SendFlatObject(values, valueCount, GetValueMember, destination, destinationSize);
+        }
+        else
         {
             /* Codes_SRS_DATA_MARSHALLER_99_037:[DataMarshaller shall store as MultiTree the data to be encoded by the JSONEncoder module.] */
             if ((treeHandle = MultiTree_Create(NoCloneFunction, NoFreeFunction)) == NULL)
@@ -188,22 +303,7 @@ DATA_MARSHALLER_RESULT DataMarshaller_SendData(DATA_MARSHALLER_HANDLE dataMarsha
                         }
                         else
                         {
-                            /*Codes_SRS_DATAMARSHALLER_02_007: [DataMarshaller_SendData shall copy in the output parameters *destination, *destinationSize the content and the content length of the encoded JSON tree.] */
-                            size_t resultSize = STRING_length(payload);
-                            unsigned char* temp = malloc(resultSize);
-                            if (temp == NULL)
-                            {
-                                /*Codes_SRS_DATA_MARSHALLER_99_015:[ DATA_MARSHALLER_ERROR shall be returned in all the other error cases not explicitly defined here.]*/
-                                result = DATA_MARSHALLER_ERROR;
-                                LOG_DATA_MARSHALLER_ERROR;
-                            }
-                            else
-                            {
-                                (void)memcpy(temp, STRING_c_str(payload), resultSize);
-                                *destination = temp;
-                                *destinationSize = resultSize;
-                                result = DATA_MARSHALLER_OK;
-                            }
+                            result = CopyPayload(payload, destination, destinationSize);
                         }
                         STRING_delete(payload);
                     }
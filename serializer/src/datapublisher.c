@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 
 #include <stdbool.h>
@@ -24,10 +25,18 @@ DEFINE_ENUM_STRINGS(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_RESULT_VALUES)
 /* Codes_SRS_DATA_PUBLISHER_99_067:[ Before any call to DataPublisher_SetMaxBufferSize, the default max buffer size shall be equal to 10KB.] */
 static size_t maxBufferSize_ = DEFAULT_MAX_BUFFER_SIZE;
 
+typedef struct REPORTED_PROPERTY_VALUE_TAG
+{
+    char* PropertyPath;
+    STRING_HANDLE Value; /*the JSON value last committed by DataPublisher_CommitTransaction_ReportedPropertiesChanges*/
+} REPORTED_PROPERTY_VALUE;
+
 typedef struct DATA_PUBLISHER_HANDLE_DATA_TAG
 {
     DATA_MARSHALLER_HANDLE DataMarshallerHandle;
     SCHEMA_MODEL_TYPE_HANDLE ModelHandle;
+    REPORTED_PROPERTY_VALUE* ReportedPropertyValues; /*sorted by PropertyPath*/
+    size_t ReportedPropertyValueCount;
 } DATA_PUBLISHER_HANDLE_DATA;
 
 typedef struct TRANSACTION_HANDLE_DATA_TAG
@@ -43,6 +52,13 @@ typedef struct REPORTED_PROPERTIES_TRANSACTION_HANDLE_DATA_TAG
     VECTOR_HANDLE value; /*holds (DATA_MARSHALLER_VALUE*) */
 }REPORTED_PROPERTIES_TRANSACTION_HANDLE_DATA;
 
+/*a changed reported property (nested properties are flattened), marshallerValue.Value points inside the transaction*/
+typedef struct REPORTED_PROPERTY_CHANGE_TAG
+{
+    DATA_MARSHALLER_VALUE marshallerValue; /*first, so the VECTOR of changes can be given to DataMarshaller as it is*/
+    STRING_HANDLE jsonValue;
+} REPORTED_PROPERTY_CHANGE;
+
 DATA_PUBLISHER_HANDLE DataPublisher_Create(SCHEMA_MODEL_TYPE_HANDLE modelHandle, bool includePropertyPath)
 {
     DATA_PUBLISHER_HANDLE_DATA* result;
@@ -75,19 +91,37 @@ DATA_PUBLISHER_HANDLE DataPublisher_Create(SCHEMA_MODEL_TYPE_HANDLE modelHandle,
         {
             /* Codes_SRS_DATA_PUBLISHER_99_041:[ DataPublisher_Create shall create a new DataPublisher instance and return a non-NULL handle in case of success.] */
             result->ModelHandle = modelHandle;
+            result->ReportedPropertyValues = NULL;
+            result->ReportedPropertyValueCount = 0;
         }
     }
 
     return result;
 }
 
+static void ForgetReportedPropertyValues(DATA_PUBLISHER_HANDLE_DATA* dataPublisherInstance)
+{
+    if (dataPublisherInstance->ReportedPropertyValues != NULL)
+    {
+        size_t i;
+        for (i = 0; i < dataPublisherInstance->ReportedPropertyValueCount; i++)
+        {
+            free(dataPublisherInstance->ReportedPropertyValues[i].PropertyPath);
+            STRING_delete(dataPublisherInstance->ReportedPropertyValues[i].Value);
+        }
+        free(dataPublisherInstance->ReportedPropertyValues);
+        dataPublisherInstance->ReportedPropertyValues = NULL;
+        dataPublisherInstance->ReportedPropertyValueCount = 0;
+    }
+}
+
 void DataPublisher_Destroy(DATA_PUBLISHER_HANDLE dataPublisherHandle)
 {
     if (dataPublisherHandle != NULL)
     {
         DATA_PUBLISHER_HANDLE_DATA* dataPublisherInstance = (DATA_PUBLISHER_HANDLE_DATA*)dataPublisherHandle;
         DataMarshaller_Destroy(dataPublisherInstance->DataMarshallerHandle);
-        
+        ForgetReportedPropertyValues(dataPublisherInstance);
         free(dataPublisherHandle);
     }
 }
@@ -543,6 +577,271 @@ DATA_PUBLISHER_RESULT DataPublisher_CommitTransaction_ReportedProperties(REPORTE
     return result;
 }
 
+/*returns the position of the first committed reported property value whose path is not less than propertyPath*/
+static size_t FindReportedPropertyValue(const DATA_PUBLISHER_HANDLE_DATA* dataPublisherInstance, const char* propertyPath)
+{
+    size_t low = 0;
+    size_t high = dataPublisherInstance->ReportedPropertyValueCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (strcmp(dataPublisherInstance->ReportedPropertyValues[middle].PropertyPath, propertyPath) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void DestroyReportedPropertyChanges(VECTOR_HANDLE changes)
+{
+    size_t i, nChanges = VECTOR_size(changes);
+    for (i = 0; i < nChanges; i++)
+    {
+        REPORTED_PROPERTY_CHANGE* change = *(REPORTED_PROPERTY_CHANGE**)VECTOR_element(changes, i);
+        if (change->marshallerValue.PropertyPath != NULL)
+        {
+            free((void*)change->marshallerValue.PropertyPath);
+        }
+        if (change->jsonValue != NULL)
+        {
+            STRING_delete(change->jsonValue);
+        }
+        free(change);
+    }
+    VECTOR_destroy(changes);
+}
+
+/*Codes_SRS_DATA_PUBLISHER_99_072: [ The members of a reported property that is a complex type (a model) shall be compared one by one, with a path of the form reportedPropertyPath/memberName. ]*/
+/*Codes_SRS_DATA_PUBLISHER_99_073: [ The JSON value of every reported property shall be obtained by calling AgentDataTypes_ToString and compared with the JSON value last committed for the same path. ]*/
+static int AddReportedPropertyChanges(const DATA_PUBLISHER_HANDLE_DATA* dataPublisherInstance, VECTOR_HANDLE changes, const char* propertyPath, const AGENT_DATA_TYPE* value)
+{
+    int result;
+    if ((value->type == EDM_COMPLEX_TYPE_TYPE) && (value->value.edmComplexType.nMembers > 0))
+    {
+        size_t i;
+        size_t pathLength = strlen(propertyPath);
+        result = 0;
+        for (i = 0; (i < value->value.edmComplexType.nMembers) && (result == 0); i++)
+        {
+            const COMPLEX_TYPE_FIELD_TYPE* field = &value->value.edmComplexType.fields[i];
+            size_t fieldNameLength = strlen(field->fieldName);
+            char* fieldPath = (char*)malloc(pathLength + 1 + fieldNameLength + 1);
+            if (fieldPath == NULL)
+            {
+                LogError("unable to malloc");
+                result = __FAILURE__;
+            }
+            else
+            {
+                (void)memcpy(fieldPath, propertyPath, pathLength);
+                fieldPath[pathLength] = '/';
+                (void)memcpy(fieldPath + pathLength + 1, field->fieldName, fieldNameLength + 1);
+                result = AddReportedPropertyChanges(dataPublisherInstance, changes, fieldPath, field->value);
+                free(fieldPath);
+            }
+        }
+    }
+    else
+    {
+        STRING_HANDLE jsonValue = STRING_new();
+        if (jsonValue == NULL)
+        {
+            LogError("unable to STRING_new");
+            result = __FAILURE__;
+        }
+        else if (AgentDataTypes_ToString(jsonValue, value) != AGENT_DATA_TYPES_OK)
+        {
+            LogError("unable to AgentDataTypes_ToString");
+            STRING_delete(jsonValue);
+            result = __FAILURE__;
+        }
+        else
+        {
+            size_t position = FindReportedPropertyValue(dataPublisherInstance, propertyPath);
+            if ((position < dataPublisherInstance->ReportedPropertyValueCount) &&
+                (strcmp(dataPublisherInstance->ReportedPropertyValues[position].PropertyPath, propertyPath) == 0) &&
+                (strcmp(STRING_c_str(dataPublisherInstance->ReportedPropertyValues[position].Value), STRING_c_str(jsonValue)) == 0))
+            {
+                /*Codes_SRS_DATA_PUBLISHER_99_074: [ Reported properties having the same JSON value as the last committed one shall not be part of the JSON. ]*/
+                STRING_delete(jsonValue);
+                result = 0;
+            }
+            else
+            {
+                REPORTED_PROPERTY_CHANGE* change = (REPORTED_PROPERTY_CHANGE*)malloc(sizeof(REPORTED_PROPERTY_CHANGE));
+                if (change == NULL)
+                {
+                    LogError("unable to malloc");
+                    STRING_delete(jsonValue);
+                    result = __FAILURE__;
+                }
+                else if (mallocAndStrcpy_s((char**)&(change->marshallerValue.PropertyPath), propertyPath) != 0)
+                {
+                    LogError("unable to mallocAndStrcpy_s");
+                    free(change);
+                    STRING_delete(jsonValue);
+                    result = __FAILURE__;
+                }
+                else
+                {
+                    change->marshallerValue.Value = value;
+                    change->jsonValue = jsonValue;
+                    if (VECTOR_push_back(changes, &change, 1) != 0)
+                    {
+                        LogError("unable to VECTOR_push_back");
+                        free((void*)change->marshallerValue.PropertyPath);
+                        free(change);
+                        STRING_delete(jsonValue);
+                        result = __FAILURE__;
+                    }
+                    else
+                    {
+                        result = 0;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/*takes the path and the JSON value out of every change it remembers*/
+static void RememberReportedPropertyValues(DATA_PUBLISHER_HANDLE_DATA* dataPublisherInstance, VECTOR_HANDLE changes)
+{
+    size_t i, nChanges = VECTOR_size(changes);
+    for (i = 0; i < nChanges; i++)
+    {
+        REPORTED_PROPERTY_CHANGE* change = *(REPORTED_PROPERTY_CHANGE**)VECTOR_element(changes, i);
+        size_t position = FindReportedPropertyValue(dataPublisherInstance, change->marshallerValue.PropertyPath);
+        if ((position < dataPublisherInstance->ReportedPropertyValueCount) &&
+            (strcmp(dataPublisherInstance->ReportedPropertyValues[position].PropertyPath, change->marshallerValue.PropertyPath) == 0))
+        {
+            STRING_delete(dataPublisherInstance->ReportedPropertyValues[position].Value);
+            dataPublisherInstance->ReportedPropertyValues[position].Value = change->jsonValue;
+            change->jsonValue = NULL;
+        }
+        else
+        {
+            REPORTED_PROPERTY_VALUE* newValues = (REPORTED_PROPERTY_VALUE*)realloc(dataPublisherInstance->ReportedPropertyValues, sizeof(REPORTED_PROPERTY_VALUE) * (dataPublisherInstance->ReportedPropertyValueCount + 1));
+            if (newValues == NULL)
+            {
+                /*not fatal: the reported property will be part of the next commit again*/
+                LogError("unable to realloc, reported property %s will be considered changed", change->marshallerValue.PropertyPath);
+            }
+            else
+            {
+                (void)memmove(newValues + position + 1, newValues + position, sizeof(REPORTED_PROPERTY_VALUE) * (dataPublisherInstance->ReportedPropertyValueCount - position));
+                newValues[position].PropertyPath = (char*)change->marshallerValue.PropertyPath;
+                newValues[position].Value = change->jsonValue;
+                change->marshallerValue.PropertyPath = NULL;
+                change->jsonValue = NULL;
+                dataPublisherInstance->ReportedPropertyValues = newValues;
+                dataPublisherInstance->ReportedPropertyValueCount++;
+            }
+        }
+    }
+}
+
+DATA_PUBLISHER_RESULT DataPublisher_CommitTransaction_ReportedPropertiesChanges(REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle, unsigned char** destination, size_t* destinationSize)
+{
+    DATA_PUBLISHER_RESULT result;
+    /*Codes_SRS_DATA_PUBLISHER_99_070: [ If argument transactionHandle, destination or destinationSize is NULL then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+    if (
+        (transactionHandle == NULL) ||
+        (destination == NULL) ||
+        (destinationSize == NULL)
+        )
+    {
+        LogError("invalid argument REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle=%p, unsigned char** destination=%p, size_t* destinationSize=%p", transactionHandle, destination, destinationSize);
+        result = DATA_PUBLISHER_INVALID_ARG;
+    }
+    else
+    {
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE_DATA* handle = (REPORTED_PROPERTIES_TRANSACTION_HANDLE_DATA*)transactionHandle;
+        size_t nReportedProperties = VECTOR_size(handle->value);
+        VECTOR_HANDLE changes;
+        if (nReportedProperties == 0)
+        {
+            /*Codes_SRS_DATA_PUBLISHER_99_071: [ If the transaction contains zero elements then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+            LogError("cannot commit empty transaction");
+            result = DATA_PUBLISHER_INVALID_ARG;
+        }
+        else if ((changes = VECTOR_create(sizeof(REPORTED_PROPERTY_CHANGE*))) == NULL)
+        {
+            /*Codes_SRS_DATA_PUBLISHER_99_077: [ If any error occurs then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_ERROR. ]*/
+            LogError("unable to VECTOR_create");
+            result = DATA_PUBLISHER_ERROR;
+        }
+        else
+        {
+            size_t i;
+            for (i = 0; i < nReportedProperties; i++)
+            {
+                DATA_MARSHALLER_VALUE* value = *(DATA_MARSHALLER_VALUE**)VECTOR_element(handle->value, i);
+                if (AddReportedPropertyChanges(handle->DataPublisherInstance, changes, value->PropertyPath, value->Value) != 0)
+                {
+                    break;
+                }
+            }
+
+            if (i < nReportedProperties)
+            {
+                /*Codes_SRS_DATA_PUBLISHER_99_077: [ If any error occurs then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_ERROR. ]*/
+                LogError("unable to compare the reported properties with the committed ones");
+                result = DATA_PUBLISHER_ERROR;
+            }
+            else if (VECTOR_size(changes) == 0)
+            {
+                /*Codes_SRS_DATA_PUBLISHER_99_075: [ If no reported property changed then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall set destination to NULL and destinationSize to 0 and return DATA_PUBLISHER_OK. ]*/
+                *destination = NULL;
+                *destinationSize = 0;
+                result = DATA_PUBLISHER_OK;
+            }
+            /*Codes_SRS_DATA_PUBLISHER_99_076: [ DataPublisher_CommitTransaction_ReportedPropertiesChanges shall call DataMarshaller_SendData_ReportedProperties providing only the changed reported properties, destination and destinationSize. ]*/
+            else if (DataMarshaller_SendData_ReportedProperties(handle->DataPublisherInstance->DataMarshallerHandle, changes, destination, destinationSize) != DATA_MARSHALLER_OK)
+            {
+                /*Codes_SRS_DATA_PUBLISHER_99_077: [ If any error occurs then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_ERROR. ]*/
+                LogError("unable to DataMarshaller_SendData_ReportedProperties");
+                result = DATA_PUBLISHER_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_DATA_PUBLISHER_99_078: [ Otherwise DataPublisher_CommitTransaction_ReportedPropertiesChanges shall remember the JSON values of the changed reported properties, succeed and return DATA_PUBLISHER_OK. ]*/
+                RememberReportedPropertyValues(handle->DataPublisherInstance, changes);
+                result = DATA_PUBLISHER_OK;
+            }
+
+            DestroyReportedPropertyChanges(changes);
+        }
+    }
+
+    return result;
+}
+
+DATA_PUBLISHER_RESULT DataPublisher_ResetReportedPropertiesChanges(DATA_PUBLISHER_HANDLE dataPublisherHandle)
+{
+    DATA_PUBLISHER_RESULT result;
+    /*Codes_SRS_DATA_PUBLISHER_99_079: [ If argument dataPublisherHandle is NULL then DataPublisher_ResetReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+    if (dataPublisherHandle == NULL)
+    {
+        LogError("invalid argument DATA_PUBLISHER_HANDLE dataPublisherHandle=%p", dataPublisherHandle);
+        result = DATA_PUBLISHER_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_DATA_PUBLISHER_99_080: [ DataPublisher_ResetReportedPropertiesChanges shall forget all the JSON values remembered by DataPublisher_CommitTransaction_ReportedPropertiesChanges, so the next commit contains all the reported properties of the transaction. ]*/
+        ForgetReportedPropertyValues((DATA_PUBLISHER_HANDLE_DATA*)dataPublisherHandle);
+        /*Codes_SRS_DATA_PUBLISHER_99_081: [ DataPublisher_ResetReportedPropertiesChanges shall succeed and return DATA_PUBLISHER_OK. ]*/
+        result = DATA_PUBLISHER_OK;
+    }
+    return result;
+}
+
 void DataPublisher_DestroyTransaction_ReportedProperties(REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle)
 {
     /*Codes_SRS_DATA_PUBLISHER_02_025: [ If argument transactionHandle is NULL then DataPublisher_DestroyTransaction_ReportedProperties shall return. ]*/
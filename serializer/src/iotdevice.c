@@ -401,6 +401,69 @@ DEVICE_RESULT Device_CommitTransaction_ReportedProperties(REPORTED_PROPERTIES_TR
     return result;
 }
 
+DEVICE_RESULT Device_CommitTransaction_ReportedPropertiesChanges(REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle, unsigned char** destination, size_t* destinationSize)
+{
+    DEVICE_RESULT result;
+
+    /*Codes_SRS_DEVICE_99_005: [ If argument transactionHandle, destination or destinationSize is NULL then Device_CommitTransaction_ReportedPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    if (
+        (transactionHandle == NULL) ||
+        (destination == NULL) ||
+        (destinationSize == NULL)
+        )
+    {
+        LogError("invalid argument REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle=%p, unsigned char** destination=%p, size_t* destinationSize=%p", transactionHandle, destination, destinationSize);
+        result = DEVICE_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_DEVICE_99_006: [ Device_CommitTransaction_ReportedPropertiesChanges shall call DataPublisher_CommitTransaction_ReportedPropertiesChanges. ]*/
+        DATA_PUBLISHER_RESULT r = DataPublisher_CommitTransaction_ReportedPropertiesChanges(transactionHandle, destination, destinationSize);
+
+        /*Codes_SRS_DEVICE_99_007: [ If DataPublisher_CommitTransaction_ReportedPropertiesChanges fails then Device_CommitTransaction_ReportedPropertiesChanges shall fail and return DEVICE_DATA_PUBLISHER_FAILED. ]*/
+        if (r != DATA_PUBLISHER_OK)
+        {
+            LogError("unable to DataPublisher_CommitTransaction_ReportedPropertiesChanges");
+            result = DEVICE_DATA_PUBLISHER_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_DEVICE_99_008: [ Otherwise Device_CommitTransaction_ReportedPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+            result = DEVICE_OK;
+        }
+    }
+    return result;
+}
+
+DEVICE_RESULT Device_ResetReportedPropertiesChanges(DEVICE_HANDLE deviceHandle)
+{
+    DEVICE_RESULT result;
+
+    /*Codes_SRS_DEVICE_99_009: [ If argument deviceHandle is NULL then Device_ResetReportedPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    if (deviceHandle == NULL)
+    {
+        LogError("invalid argument DEVICE_HANDLE deviceHandle=%p", deviceHandle);
+        result = DEVICE_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_DEVICE_99_010: [ Device_ResetReportedPropertiesChanges shall call DataPublisher_ResetReportedPropertiesChanges. ]*/
+        DEVICE_HANDLE_DATA* device = (DEVICE_HANDLE_DATA*)deviceHandle;
+        if (DataPublisher_ResetReportedPropertiesChanges(device->dataPublisherHandle) != DATA_PUBLISHER_OK)
+        {
+            /*Codes_SRS_DEVICE_99_011: [ If DataPublisher_ResetReportedPropertiesChanges fails then Device_ResetReportedPropertiesChanges shall fail and return DEVICE_DATA_PUBLISHER_FAILED. ]*/
+            LogError("unable to DataPublisher_ResetReportedPropertiesChanges");
+            result = DEVICE_DATA_PUBLISHER_FAILED;
+        }
+        else
+        {
+            /*Codes_SRS_DEVICE_99_012: [ Otherwise Device_ResetReportedPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+            result = DEVICE_OK;
+        }
+    }
+    return result;
+}
+
 void Device_DestroyTransaction_ReportedProperties(REPORTED_PROPERTIES_TRANSACTION_HANDLE transactionHandle)
 {
     /*Codes_SRS_DEVICE_02_030: [ If argument transactionHandle is NULL then Device_DestroyTransaction_ReportedProperties shall return. ]*/
@@ -448,3 +511,35 @@ DEVICE_RESULT Device_IngestDesiredProperties(void* startAddress, DEVICE_HANDLE d
     }
     return result;
 }
+
+DEVICE_RESULT Device_IngestDesiredPropertiesChanges(void* startAddress, DEVICE_HANDLE deviceHandle, const char* jsonPayload, bool parseDesiredNode)
+{
+    DEVICE_RESULT result;
+    /*Codes_SRS_DEVICE_99_001: [ If deviceHandle, jsonPayload or startAddress is NULL then Device_IngestDesiredPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    if (
+        (deviceHandle == NULL) ||
+        (jsonPayload == NULL) ||
+        (startAddress == NULL)
+        )
+    {
+        LogError("invalid argument void* startAddress=%p, DEVICE_HANDLE deviceHandle=%p, const char* jsonPayload=%p\n", startAddress, deviceHandle, jsonPayload);
+        result = DEVICE_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_DEVICE_99_002: [ Device_IngestDesiredPropertiesChanges shall call CommandDecoder_IngestDesiredPropertiesChanges. ]*/
+        DEVICE_HANDLE_DATA* device = (DEVICE_HANDLE_DATA*)deviceHandle;
+        if (CommandDecoder_IngestDesiredPropertiesChanges(startAddress, device->commandDecoderHandle, jsonPayload, parseDesiredNode) != EXECUTE_COMMAND_SUCCESS)
+        {
+            /*Codes_SRS_DEVICE_99_003: [ If any failure happens then Device_IngestDesiredPropertiesChanges shall fail and return DEVICE_ERROR. ]*/
+            LogError("failure in CommandDecoder_IngestDesiredPropertiesChanges");
+            result = DEVICE_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_DEVICE_99_004: [ Otherwise, Device_IngestDesiredPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+            result = DEVICE_OK;
+        }
+    }
+    return result;
+}
@@ -3,6 +3,7 @@
 
 #include "azure_c_shared_utility/gballoc.h"
 
+#include <string.h>
 #include "jsonencoder.h"
 #include "azure_c_shared_utility/crt_abstractions.h"
 #include "azure_c_shared_utility/xlogging.h"
@@ -15,6 +16,9 @@
 DEFINE_ENUM_STRINGS(JSON_ENCODER_TOSTRING_RESULT, JSON_ENCODER_TOSTRING_RESULT_VALUES);
 DEFINE_ENUM_STRINGS(JSON_ENCODER_RESULT, JSON_ENCODER_RESULT_VALUES);
 
+/*a member name is written together with its separator and quotes by a single STRING_concat when it fits here*/
+#define MEMBER_NAME_BUFFER_SIZE 128
+
 JSON_ENCODER_RESULT JSONEncoder_EncodeTree(MULTITREE_HANDLE treeHandle, STRING_HANDLE destination, JSON_ENCODER_TOSTRING_FUNC toStringFunc)
 {
     JSON_ENCODER_RESULT result;
@@ -190,6 +194,95 @@ JSON_ENCODER_RESULT JSONEncoder_EncodeTree(MULTITREE_HANDLE treeHandle, STRING_H
 #endif
 }
 
+static int appendMemberName(STRING_HANDLE destination, const char* prefix, const char* name)
+{
+    int result;
+    size_t prefixLength = strlen(prefix);
+    size_t nameLength = strlen(name);
+
+    if (prefixLength + nameLength + sizeof("\":") <= MEMBER_NAME_BUFFER_SIZE)
+    {
+        char memberName[MEMBER_NAME_BUFFER_SIZE];
+        (void)memcpy(memberName, prefix, prefixLength);
+        (void)memcpy(memberName + prefixLength, name, nameLength);
+        (void)memcpy(memberName + prefixLength + nameLength, "\":", sizeof("\":"));
+        result = STRING_concat(destination, memberName);
+    }
+    else if ((STRING_concat(destination, prefix) != 0) ||
+        (STRING_concat(destination, name) != 0) ||
+        (STRING_concat(destination, "\":") != 0))
+    {
+        result = __FAILURE__;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+JSON_ENCODER_RESULT JSONEncoder_EncodeObject(const void* members, size_t memberCount, JSON_ENCODER_GET_MEMBER_FUNC getMember, STRING_HANDLE destination, JSON_ENCODER_TOSTRING_FUNC toStringFunc)
+{
+    JSON_ENCODER_RESULT result;
+
+    /*Codes_SRS_JSON_ENCODER_99_051: [ If members is NULL while memberCount is not 0, or getMember, destination or toStringFunc is NULL, JSONEncoder_EncodeObject shall return JSON_ENCODER_INVALID_ARG. ]*/
+    if (((members == NULL) && (memberCount > 0)) ||
+        (getMember == NULL) ||
+        (destination == NULL) ||
+        (toStringFunc == NULL))
+    {
+        result = JSON_ENCODER_INVALID_ARG;
+        LogError("(result = %s)", ENUM_TO_STRING(JSON_ENCODER_RESULT, result));
+    }
+    /*Codes_SRS_JSON_ENCODER_99_052: [ JSONEncoder_EncodeObject shall append to destination the JSON object with the memberCount members produced by getMember, in the same format as JSONEncoder_EncodeTree. ]*/
+    else if ((memberCount == 0) &&
+        (STRING_concat(destination, "{}") != 0))
+    {
+        /*Codes_SRS_JSON_ENCODER_99_055: [ If appending to destination fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_ERROR. ]*/
+        result = JSON_ENCODER_ERROR;
+        LogError("(result = %s)", ENUM_TO_STRING(JSON_ENCODER_RESULT, result));
+    }
+    else
+    {
+        size_t i;
+        result = JSON_ENCODER_OK;
+        for (i = 0; (i < memberCount) && (result == JSON_ENCODER_OK); i++)
+        {
+            const char* name;
+            const void* value;
+            getMember(members, i, &name, &value);
+
+            /*Codes_SRS_JSON_ENCODER_99_053: [ Every name shall be written straight into destination, followed by the value produced by toStringFunc in destination. ]*/
+            if (appendMemberName(destination, (i == 0) ? "{\"" : ", \"", name) != 0)
+            {
+                /*Codes_SRS_JSON_ENCODER_99_055: [ If appending to destination fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_ERROR. ]*/
+                result = JSON_ENCODER_ERROR;
+                LogError("(result = %s)", ENUM_TO_STRING(JSON_ENCODER_RESULT, result));
+            }
+            else if (toStringFunc(destination, value) != JSON_ENCODER_TOSTRING_OK)
+            {
+                /*Codes_SRS_JSON_ENCODER_99_054: [ If toStringFunc fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_TOSTRING_FUNCTION_ERROR. ]*/
+                result = JSON_ENCODER_TOSTRING_FUNCTION_ERROR;
+                LogError("(result = %s)", ENUM_TO_STRING(JSON_ENCODER_RESULT, result));
+            }
+            else if ((i == memberCount - 1) &&
+                (STRING_concat(destination, "}") != 0))
+            {
+                /*Codes_SRS_JSON_ENCODER_99_055: [ If appending to destination fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_ERROR. ]*/
+                result = JSON_ENCODER_ERROR;
+                LogError("(result = %s)", ENUM_TO_STRING(JSON_ENCODER_RESULT, result));
+            }
+            else
+            {
+                /*do nothing, result = JSON_ENCODER_OK is set above*/
+            }
+        }
+    }
+
+    return result;
+}
+
 JSON_ENCODER_TOSTRING_RESULT JSONEncoder_CharPtr_ToString(STRING_HANDLE destination, const void* value)
 {
     JSON_ENCODER_TOSTRING_RESULT result;
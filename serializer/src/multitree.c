@@ -14,6 +14,9 @@
 /*assume a name cannot be longer than 100 characters*/
 #define INNER_NODE_NAME_SIZE 128
 
+/*nodes with at least this many children keep a hash index of their children, smaller nodes are scanned*/
+#define CHILD_INDEX_MIN_CHILDREN 8
+
 DEFINE_ENUM_STRINGS(MULTITREE_RESULT, MULTITREE_RESULT_VALUES);
 
 typedef struct MULTITREE_HANDLE_DATA_TAG
@@ -22,8 +25,11 @@ typedef struct MULTITREE_HANDLE_DATA_TAG
     void* value;
     MULTITREE_CLONE_FUNCTION cloneFunction;
     MULTITREE_FREE_FUNCTION freeFunction;
+    size_t nameHash;
     size_t nChildren;
     struct MULTITREE_HANDLE_DATA_TAG** children; /*an array of nChildren count of MULTITREE_HANDLE_DATA*   */
+    size_t* childIndex; /*open addressing table of childIndexSize slots, a slot holds the position in children + 1, 0 is an empty slot*/
+    size_t childIndexSize; /*power of 2, at least twice nChildren*/
 }MULTITREE_HANDLE_DATA;
 
 
@@ -50,8 +56,11 @@ MULTITREE_HANDLE MultiTree_Create(MULTITREE_CLONE_FUNCTION cloneFunction, MULTIT
             result->value = NULL;
             result->cloneFunction = cloneFunction;
             result->freeFunction = freeFunction;
+            result->nameHash = 0;
             result->nChildren = 0;
             result->children = NULL;
+            result->childIndex = NULL;
+            result->childIndexSize = 0;
         }
         else
         {
@@ -63,23 +72,116 @@ MULTITREE_HANDLE MultiTree_Create(MULTITREE_CLONE_FUNCTION cloneFunction, MULTIT
 }
 
 
-/*return NULL if a child with the name "name" doesn't exists*/
+/*FNV-1a over the first nameLength characters of name*/
+static size_t hashChildName(const char* name, size_t nameLength)
+{
+    size_t result = (size_t)2166136261u;
+    size_t i;
+    for (i = 0; i < nameLength; i++)
+    {
+        result ^= (unsigned char)name[i];
+        result *= (size_t)16777619u;
+    }
+    return result;
+}
+
+static void insertIntoChildIndex(MULTITREE_HANDLE_DATA* node, size_t position)
+{
+    size_t mask = node->childIndexSize - 1;
+    size_t slot = node->children[position]->nameHash & mask;
+    while (node->childIndex[slot] != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    node->childIndex[slot] = position + 1;
+}
+
+/*Codes_SRS_MULTITREE_99_080: [ Nodes with CHILD_INDEX_MIN_CHILDREN or more children shall find their children by name through a hash index instead of comparing every child name. ]*/
+/*the index is only an accelerator: if it cannot be allocated the children are scanned as for small nodes*/
+static void rebuildChildIndex(MULTITREE_HANDLE_DATA* node)
+{
+    if (node->childIndex != NULL)
+    {
+        free(node->childIndex);
+        node->childIndex = NULL;
+        node->childIndexSize = 0;
+    }
+
+    if (node->nChildren >= CHILD_INDEX_MIN_CHILDREN)
+    {
+        size_t newSize = 2 * CHILD_INDEX_MIN_CHILDREN;
+        while (newSize < 2 * node->nChildren)
+        {
+            newSize *= 2;
+        }
+
+        node->childIndex = (size_t*)malloc(newSize * sizeof(size_t));
+        if (node->childIndex == NULL)
+        {
+            LogError("unable to allocate the child index, children will be scanned");
+        }
+        else
+        {
+            size_t i;
+            (void)memset(node->childIndex, 0, newSize * sizeof(size_t));
+            node->childIndexSize = newSize;
+            for (i = 0; i < node->nChildren; i++)
+            {
+                insertIntoChildIndex(node, i);
+            }
+        }
+    }
+}
+
+/*return NULL if a child with the first nameLength characters of "name" as name doesn't exists*/
 /*returns a pointer to the existing child (if any)*/
-static MULTITREE_HANDLE_DATA* getChildByName(MULTITREE_HANDLE_DATA* node, const char* name)
+static MULTITREE_HANDLE_DATA* getChildByNameLength(MULTITREE_HANDLE_DATA* node, const char* name, size_t nameLength)
 {
     MULTITREE_HANDLE_DATA* result = NULL;
-    size_t i;
-    for (i = 0; i < node->nChildren; i++)
+    size_t hash = hashChildName(name, nameLength);
+
+    if (node->childIndex != NULL)
     {
-        if (strcmp(node->children[i]->name, name) == 0)
+        size_t mask = node->childIndexSize - 1;
+        size_t slot = hash & mask;
+        while (node->childIndex[slot] != 0)
         {
-            result = node->children[i];
-            break;
+            MULTITREE_HANDLE_DATA* child = node->children[node->childIndex[slot] - 1];
+            if ((child->nameHash == hash) &&
+                (strncmp(child->name, name, nameLength) == 0) &&
+                (child->name[nameLength] == '\0'))
+            {
+                result = child;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < node->nChildren; i++)
+        {
+            MULTITREE_HANDLE_DATA* child = node->children[i];
+            if ((child->nameHash == hash) &&
+                (strncmp(child->name, name, nameLength) == 0) &&
+                (child->name[nameLength] == '\0'))
+            {
+                result = child;
+                break;
+            }
         }
     }
     return result;
 }
 
+/*return NULL if a child with the name "name" doesn't exists*/
+/*returns a pointer to the existing child (if any)*/
+static MULTITREE_HANDLE_DATA* getChildByName(MULTITREE_HANDLE_DATA* node, const char* name)
+{
+    return getChildByNameLength(node, name, strlen(name));
+}
+
 /*helper function to create a child immediately under this node*/
 /*return 0 if it created it, any other number is error*/
 
@@ -136,6 +238,9 @@ static CREATELEAF_RESULT createLeaf(MULTITREE_HANDLE_DATA* node, const char*name
         {
             newNode->nChildren = 0;
             newNode->children = NULL;
+            newNode->childIndex = NULL;
+            newNode->childIndexSize = 0;
+            newNode->nameHash = hashChildName(name, strlen(name));
             if (mallocAndStrcpy_s(&(newNode->name), name) != 0)
             {
                 /*not nice*/
@@ -189,6 +294,17 @@ static CREATELEAF_RESULT createLeaf(MULTITREE_HANDLE_DATA* node, const char*name
                     node->children = newChildren;
                     node->children[node->nChildren] = newNode;
                     node->nChildren++;
+
+                    /*Codes_SRS_MULTITREE_99_081: [ Children shall keep the order in which they were added. ]*/
+                    if ((node->childIndex != NULL) &&
+                        (2 * node->nChildren <= node->childIndexSize))
+                    {
+                        insertIntoChildIndex(node, node->nChildren - 1);
+                    }
+                    else if (node->nChildren >= CHILD_INDEX_MIN_CHILDREN)
+                    {
+                        rebuildChildIndex(node);
+                    }
                     if (childNode != NULL)
                     {
                         *childNode = newNode;
@@ -300,9 +416,10 @@ MULTITREE_RESULT MultiTree_AddLeaf(MULTITREE_HANDLE treeHandle, const char* dest
                 MULTITREE_HANDLE_DATA *child = getChildByName(node, firstInnerNodeName);
                 if (child == NULL)
                 {
+                    MULTITREE_HANDLE_DATA *createdChild;
                     /*Codes_SRS_MULTITREE_99_022:[ If a child along the path does not exist, it shall be created.] */
                     /*Codes_SRS_MULTITREE_99_023:[ The newly created children along the path shall have a NULL value by default.]*/
-                    CREATELEAF_RESULT res = createLeaf(node, firstInnerNodeName, NULL, NULL);
+                    CREATELEAF_RESULT res = createLeaf(node, firstInnerNodeName, NULL, &createdChild);
                     switch (res)
                     {
                         default:
@@ -320,7 +437,6 @@ MULTITREE_RESULT MultiTree_AddLeaf(MULTITREE_HANDLE treeHandle, const char* dest
                         }
                         case(CREATELEAF_OK):
                         {
-                            MULTITREE_HANDLE_DATA *createdChild = getChildByName(node, firstInnerNodeName);
                             result = MultiTree_AddLeaf(createdChild, whereIsDelimiter, value);
                             break;
                         }
@@ -507,18 +623,9 @@ MULTITREE_RESULT MultiTree_GetChildByName(MULTITREE_HANDLE treeHandle, const cha
     }
     else
     {
-        MULTITREE_HANDLE_DATA * node = (MULTITREE_HANDLE_DATA *)treeHandle;
-        size_t i;
-
-        for (i = 0; i < node->nChildren; i++)
-        {
-            if (strcmp(node->children[i]->name, childName) == 0)
-            {
-                break;
-            }
-        }
+        MULTITREE_HANDLE_DATA * child = getChildByName((MULTITREE_HANDLE_DATA *)treeHandle, childName);
 
-        if (i == node->nChildren)
+        if (child == NULL)
         {
             /* Codes_SRS_MULTITREE_99_068:[ If the specified child is not found, MultiTree_GetChildByName shall return MULTITREE_CHILD_NOT_FOUND.] */
             result = MULTITREE_CHILD_NOT_FOUND;
@@ -527,7 +634,7 @@ MULTITREE_RESULT MultiTree_GetChildByName(MULTITREE_HANDLE treeHandle, const cha
         else
         {
             /* Codes_SRS_MULTITREE_99_067:[ The child node handle shall be returned in the childHandle argument.] */
-            *childHandle = node->children[i];
+            *childHandle = child;
 
             /* Codes_SRS_MULTITREE_99_064:[ On success, MultiTree_GetChildByName shall return MULTITREE_OK.] */
             result = MULTITREE_OK;
@@ -627,6 +734,13 @@ void MultiTree_Destroy(MULTITREE_HANDLE treeHandle)
             node->children = NULL;
         }
 
+        /*Codes_SRS_MULTITREE_99_047:[ This function frees any system resource used by the tree designated by parameter treeHandle]*/
+        if (node->childIndex != NULL)
+        {
+            free(node->childIndex);
+            node->childIndex = NULL;
+        }
+
         /*Codes_SRS_MULTITREE_99_047:[ This function frees any system resource used by the tree designated by parameter treeHandle]*/
         if (node->name != NULL)
         {
@@ -692,7 +806,6 @@ MULTITREE_RESULT MultiTree_GetLeafValue(MULTITREE_HANDLE treeHandle, const char*
             /* Codes_SRS_MULTITREE_99_058:[ The last child designates the child that will receive the value.] */
             while (*pos != '\0')
             {
-                size_t i;
                 size_t childCount = node->nChildren;
 
                 whereIsDelimiter = pos;
@@ -718,17 +831,10 @@ MULTITREE_RESULT MultiTree_GetLeafValue(MULTITREE_HANDLE treeHandle, const char*
                 }
                 else
                 {
-                    for (i = 0; i < childCount; i++)
-                    {
-                        if (strncmp(node->children[i]->name, pos, whereIsDelimiter - pos) == 0)
-                        {
-                            /* Codes_SRS_MULTITREE_99_057:[ Subsequent names designate hierarchical children in the tree.] */
-                            node = node->children[i];
-                            break;
-                        }
-                    }
+                    /* Codes_SRS_MULTITREE_99_057:[ Subsequent names designate hierarchical children in the tree.] */
+                    MULTITREE_HANDLE_DATA* child = getChildByNameLength(node, pos, whereIsDelimiter - pos);
 
-                    if (i == childCount)
+                    if (child == NULL)
                     {
                         /* Codes_SRS_MULTITREE_99_071:[ When the child node is not found, MultiTree_GetLeafValue shall return MULTITREE_CHILD_NOT_FOUND.] */
                         result = MULTITREE_CHILD_NOT_FOUND;
@@ -737,6 +843,7 @@ MULTITREE_RESULT MultiTree_GetLeafValue(MULTITREE_HANDLE treeHandle, const char*
                     }
                     else
                     {
+                        node = child;
                         if (*whereIsDelimiter == '/')
                         {
                             pos = whereIsDelimiter + 1;
@@ -786,20 +893,10 @@ MULTITREE_RESULT MultiTree_DeleteChild(MULTITREE_HANDLE treeHandle, const char*
     else
     {
         size_t i;
-        size_t childToRemove = treeHandle->nChildren;
-        MULTITREE_HANDLE treeToRemove = NULL;
-
-        for (i = 0; i < treeHandle->nChildren; i++)
-        {
-            if (0 == strcmp(treeHandle->children[i]->name, childName))
-            {
-                childToRemove = i;
-                treeToRemove = treeHandle->children[childToRemove];
-                break;
-            }
-        }
+        size_t childToRemove = 0;
+        MULTITREE_HANDLE treeToRemove = getChildByName(treeHandle, childName);
 
-        if (i == treeHandle->nChildren)
+        if (treeToRemove == NULL)
         {
             /* Codes_SRS_MULTITREE_99_079:[If childName is not found, MultiTree_DeleteChild shall return MULTITREE_CHILD_NOT_FOUND.] */
             result = MULTITREE_CHILD_NOT_FOUND;
@@ -807,6 +904,11 @@ MULTITREE_RESULT MultiTree_DeleteChild(MULTITREE_HANDLE treeHandle, const char*
         }
         else
         {
+            while (treeHandle->children[childToRemove] != treeToRemove)
+            {
+                childToRemove++;
+            }
+
             for (i = childToRemove; i < treeHandle->nChildren - 1; i++)
             {
                 treeHandle->children[i] = treeHandle->children[i+1];
@@ -819,6 +921,12 @@ MULTITREE_RESULT MultiTree_DeleteChild(MULTITREE_HANDLE treeHandle, const char*
             treeHandle->children[treeHandle->nChildren - 1] = NULL;
             treeHandle->nChildren = treeHandle->nChildren - 1;
 
+            /*positions after the removed child have moved*/
+            if (treeHandle->childIndex != NULL)
+            {
+                rebuildChildIndex(treeHandle);
+            }
+
             result = MULTITREE_OK;
         }
     }
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
 #include "azure_c_shared_utility/gballoc.h"
 
 #include "schema.h"
@@ -12,6 +13,19 @@
 
 DEFINE_ENUM_STRINGS(SCHEMA_RESULT, SCHEMA_RESULT_VALUES);
 
+/*collections with fewer elements than this are searched by comparing every name*/
+#define NAME_INDEX_MIN_ELEMENTS 8
+
+/*returns the name of the element at position in collection*/
+typedef const char* (*GET_ELEMENT_NAME)(const void* collection, size_t position);
+
+typedef struct NAME_INDEX_TAG
+{
+    size_t elementCount; /*number of elements in the indexed collection*/
+    size_t* slots; /*open addressing table of slotCount slots, a slot holds a position in the collection + 1, 0 is an empty slot. NULL until the first lookup*/
+    size_t slotCount; /*power of 2, at least twice elementCount*/
+} NAME_INDEX;
+
 typedef struct SCHEMA_PROPERTY_HANDLE_DATA_TAG
 {
     const char* PropertyName;
@@ -32,6 +46,7 @@ typedef struct SCHEMA_DESIRED_PROPERTY_HANDLE_DATA_TAG
     const char* desiredPropertyName;
     const char* desiredPropertyType;
     pfDesiredPropertyFromAGENT_DATA_TYPE desiredPropertyFromAGENT_DATA_TYPE;
+    pfDesiredPropertyToAGENT_DATA_TYPE desiredPropertyToAGENT_DATA_TYPE;
     size_t offset;
 } SCHEMA_DESIRED_PROPERTY_HANDLE_DATA;
 
@@ -81,6 +96,12 @@ typedef struct SCHEMA_MODEL_TYPE_HANDLE_DATA_TAG
     size_t ActionCount;
     VECTOR_HANDLE models;
     size_t DeviceCount;
+    NAME_INDEX propertyIndex;
+    NAME_INDEX reportedPropertyIndex;
+    NAME_INDEX desiredPropertyIndex;
+    NAME_INDEX actionIndex;
+    NAME_INDEX methodIndex;
+    NAME_INDEX modelIndex;
 } SCHEMA_MODEL_TYPE_HANDLE_DATA;
 
 typedef struct SCHEMA_STRUCT_TYPE_HANDLE_DATA_TAG
@@ -88,6 +109,7 @@ typedef struct SCHEMA_STRUCT_TYPE_HANDLE_DATA_TAG
     const char* Name;
     SCHEMA_PROPERTY_HANDLE* Properties;
     size_t PropertyCount;
+    NAME_INDEX propertyIndex;
 } SCHEMA_STRUCT_TYPE_HANDLE_DATA;
 
 typedef struct SCHEMA_HANDLE_DATA_TAG
@@ -98,9 +120,214 @@ typedef struct SCHEMA_HANDLE_DATA_TAG
     size_t ModelTypeCount;
     SCHEMA_STRUCT_TYPE_HANDLE* StructTypes;
     size_t StructTypeCount;
+    NAME_INDEX modelTypeIndex;
+    NAME_INDEX structTypeIndex;
 } SCHEMA_HANDLE_DATA;
 
 static VECTOR_HANDLE g_schemas = NULL;
+static NAME_INDEX g_schemasIndex = { 0, NULL, 0 };
+
+static void NameIndex_Init(NAME_INDEX* index)
+{
+    index->elementCount = 0;
+    index->slots = NULL;
+    index->slotCount = 0;
+}
+
+static void NameIndex_Deinit(NAME_INDEX* index)
+{
+    if (index->slots != NULL)
+    {
+        free(index->slots);
+        index->slots = NULL;
+        index->slotCount = 0;
+    }
+}
+
+/*FNV-1a*/
+static size_t hashName(const char* name)
+{
+    size_t result = (size_t)2166136261u;
+    while (*name != '\0')
+    {
+        result ^= (unsigned char)*name;
+        result *= (size_t)16777619u;
+        name++;
+    }
+    return result;
+}
+
+static void NameIndex_Insert(size_t* slots, size_t slotCount, const void* collection, GET_ELEMENT_NAME getName, size_t position)
+{
+    size_t mask = slotCount - 1;
+    size_t slot = hashName(getName(collection, position)) & mask;
+    while (slots[slot] != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = position + 1;
+}
+
+/*Codes_SRS_SCHEMA_99_185: [ If the hash index cannot be built, the lookup shall compare the name of every element of the collection. ]*/
+static void NameIndex_Build(NAME_INDEX* index, const void* collection, GET_ELEMENT_NAME getName)
+{
+    size_t slotCount = 2 * NAME_INDEX_MIN_ELEMENTS;
+    size_t* slots;
+
+    /*a table that cannot be regrown is dropped so that lookups fall back to scanning the collection*/
+    NameIndex_Deinit(index);
+
+    while (slotCount < 2 * index->elementCount)
+    {
+        slotCount *= 2;
+    }
+
+    slots = (size_t*)malloc(slotCount * sizeof(size_t));
+    if (slots == NULL)
+    {
+        LogError("unable to allocate the name index, names will be scanned");
+    }
+    else
+    {
+        size_t i;
+        (void)memset(slots, 0, slotCount * sizeof(size_t));
+        for (i = 0; i < index->elementCount; i++)
+        {
+            NameIndex_Insert(slots, slotCount, collection, getName, i);
+        }
+        index->slotCount = slotCount;
+        index->slots = slots;
+    }
+}
+
+/*Codes_SRS_SCHEMA_99_184: [ Collections of NAME_INDEX_MIN_ELEMENTS or more schemas, models, struct types, properties, reported properties, desired properties, actions, methods or models in model shall be searched by name through a hash index that is updated when an element is added to or removed from the collection, so that lookups do not modify the schema. ]*/
+/*the element at position elementCount has just been appended to collection*/
+static void NameIndex_ElementAdded(NAME_INDEX* index, const void* collection, GET_ELEMENT_NAME getName)
+{
+    index->elementCount++;
+    if (index->elementCount >= NAME_INDEX_MIN_ELEMENTS)
+    {
+        if ((index->slots == NULL) ||
+            (2 * index->elementCount > index->slotCount))
+        {
+            NameIndex_Build(index, collection, getName);
+        }
+        else
+        {
+            NameIndex_Insert(index->slots, index->slotCount, collection, getName, index->elementCount - 1);
+        }
+    }
+}
+
+/*an element has just been erased from collection, the positions after it have shifted*/
+static void NameIndex_ElementRemoved(NAME_INDEX* index, const void* collection, GET_ELEMENT_NAME getName)
+{
+    index->elementCount--;
+    if (index->elementCount >= NAME_INDEX_MIN_ELEMENTS)
+    {
+        NameIndex_Build(index, collection, getName);
+    }
+    else
+    {
+        NameIndex_Deinit(index);
+    }
+}
+
+/*returns the position of the element called name in collection, or index->elementCount if there is none*/
+static size_t NameIndex_Find(const NAME_INDEX* index, const void* collection, GET_ELEMENT_NAME getName, const char* name)
+{
+    size_t result;
+
+    if (index->slots != NULL)
+    {
+        size_t mask = index->slotCount - 1;
+        size_t slot = hashName(name) & mask;
+        result = index->elementCount;
+        while (index->slots[slot] != 0)
+        {
+            size_t position = index->slots[slot] - 1;
+            if (strcmp(getName(collection, position), name) == 0)
+            {
+                result = position;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    else
+    {
+        for (result = 0; result < index->elementCount; result++)
+        {
+            if (strcmp(getName(collection, result), name) == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*small vectors are searched with VECTOR_find_if, larger ones through their name index*/
+static void* FindVectorElementByName(VECTOR_HANDLE vector, const NAME_INDEX* index, PREDICATE_FUNCTION nameMatches, GET_ELEMENT_NAME getName, const char* name)
+{
+    void* result;
+    if (index->elementCount < NAME_INDEX_MIN_ELEMENTS)
+    {
+        result = VECTOR_find_if(vector, nameMatches, name);
+    }
+    else
+    {
+        size_t position = NameIndex_Find(index, vector, getName, name);
+        result = (position < index->elementCount) ? VECTOR_element(vector, position) : NULL;
+    }
+    return result;
+}
+
+static const char* getSchemaNamespace(const void* collection, size_t position)
+{
+    return (*(SCHEMA_HANDLE_DATA**)VECTOR_element((VECTOR_HANDLE)collection, position))->Namespace;
+}
+
+static const char* getModelTypeName(const void* collection, size_t position)
+{
+    return ((const SCHEMA_MODEL_TYPE_HANDLE_DATA*)((const SCHEMA_MODEL_TYPE_HANDLE*)collection)[position])->Name;
+}
+
+static const char* getStructTypeName(const void* collection, size_t position)
+{
+    return ((const SCHEMA_STRUCT_TYPE_HANDLE_DATA*)((const SCHEMA_STRUCT_TYPE_HANDLE*)collection)[position])->Name;
+}
+
+static const char* getPropertyName(const void* collection, size_t position)
+{
+    return ((const SCHEMA_PROPERTY_HANDLE_DATA*)((const SCHEMA_PROPERTY_HANDLE*)collection)[position])->PropertyName;
+}
+
+static const char* getActionName(const void* collection, size_t position)
+{
+    return ((const SCHEMA_ACTION_HANDLE_DATA*)((const SCHEMA_ACTION_HANDLE*)collection)[position])->ActionName;
+}
+
+static const char* getReportedPropertyName(const void* collection, size_t position)
+{
+    return (*(SCHEMA_REPORTED_PROPERTY_HANDLE_DATA**)VECTOR_element((VECTOR_HANDLE)collection, position))->reportedPropertyName;
+}
+
+static const char* getDesiredPropertyName(const void* collection, size_t position)
+{
+    return (*(SCHEMA_DESIRED_PROPERTY_HANDLE_DATA**)VECTOR_element((VECTOR_HANDLE)collection, position))->desiredPropertyName;
+}
+
+static const char* getMethodName(const void* collection, size_t position)
+{
+    return (*(SCHEMA_METHOD_HANDLE*)VECTOR_element((VECTOR_HANDLE)collection, position))->methodName;
+}
+
+static const char* getModelInModelName(const void* collection, size_t position)
+{
+    return ((MODEL_IN_MODEL*)VECTOR_element((VECTOR_HANDLE)collection, position))->propertyName;
+}
 
 static void DestroyProperty(SCHEMA_PROPERTY_HANDLE propertyHandle)
 {
@@ -184,6 +411,7 @@ static void DestroyStruct(SCHEMA_STRUCT_TYPE_HANDLE structTypeHandle)
             DestroyProperty(structType->Properties[i]);
         }
         free(structType->Properties);
+        NameIndex_Deinit(&structType->propertyIndex);
 
         free((void*)structType->Name);
 
@@ -244,6 +472,13 @@ static void DestroyModel(SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle)
     VECTOR_destroy(modelType->models);
 
     free(modelType->Actions);
+
+    NameIndex_Deinit(&modelType->propertyIndex);
+    NameIndex_Deinit(&modelType->reportedPropertyIndex);
+    NameIndex_Deinit(&modelType->desiredPropertyIndex);
+    NameIndex_Deinit(&modelType->actionIndex);
+    NameIndex_Deinit(&modelType->methodIndex);
+    NameIndex_Deinit(&modelType->modelIndex);
     free(modelType);
 }
 
@@ -319,6 +554,7 @@ static SCHEMA_RESULT AddModelProperty(SCHEMA_MODEL_TYPE_HANDLE_DATA* modelType,
                     {
                         modelType->Properties[modelType->PropertyCount] = (SCHEMA_PROPERTY_HANDLE)newProperty;
                         modelType->PropertyCount++;
+                        NameIndex_ElementAdded(&modelType->propertyIndex, modelType->Properties, getPropertyName);
 
                         /* Codes_SRS_SCHEMA_99_012:[On success, Schema_AddModelProperty shall return SCHEMA_OK.] */
                         result = SCHEMA_OK;
@@ -406,7 +642,10 @@ SCHEMA_HANDLE Schema_Create(const char* schemaNamespace, void* metadata)
             result->ModelTypeCount = 0;
             result->StructTypes = NULL;
             result->StructTypeCount = 0;
+            NameIndex_Init(&result->modelTypeIndex);
+            NameIndex_Init(&result->structTypeIndex);
             result->metadata = metadata;
+            NameIndex_ElementAdded(&g_schemasIndex, g_schemas, getSchemaNamespace);
         }
     }
 
@@ -428,7 +667,7 @@ SCHEMA_HANDLE Schema_GetSchemaByNamespace(const char* schemaNamespace)
     /* Codes_SRS_SCHEMA_99_150: [If the schemaNamespace argument is NULL, Schema_GetSchemaByNamespace shall return NULL.] */
     if (schemaNamespace != NULL)
     {
-        SCHEMA_HANDLE* handle = (g_schemas==NULL)?NULL:(SCHEMA_HANDLE*)VECTOR_find_if(g_schemas, (PREDICATE_FUNCTION)SchemaNamespacesMatch, schemaNamespace);
+        SCHEMA_HANDLE* handle = (g_schemas==NULL)?NULL:(SCHEMA_HANDLE*)FindVectorElementByName(g_schemas, &g_schemasIndex, (PREDICATE_FUNCTION)SchemaNamespacesMatch, getSchemaNamespace, schemaNamespace);
         if (handle != NULL)
         {
             /* Codes_SRS_SCHEMA_99_148: [Schema_GetSchemaByNamespace shall search all active schemas and return the schema with the 
@@ -481,6 +720,8 @@ void Schema_Destroy(SCHEMA_HANDLE schemaHandle)
         }
 
         free(schema->StructTypes);
+        NameIndex_Deinit(&schema->modelTypeIndex);
+        NameIndex_Deinit(&schema->structTypeIndex);
         free((void*)schema->Namespace);
         free(schema);
 
@@ -488,6 +729,7 @@ void Schema_Destroy(SCHEMA_HANDLE schemaHandle)
         if (schema != NULL)
         {
             VECTOR_erase(g_schemas, schema, 1);
+            NameIndex_ElementRemoved(&g_schemasIndex, g_schemas, getSchemaNamespace);
         }
         // If the g_schema is empty then destroy it
         if (VECTOR_size(g_schemas) == 0)
@@ -705,9 +947,16 @@ SCHEMA_MODEL_TYPE_HANDLE Schema_CreateModelType(SCHEMA_HANDLE schemaHandle, cons
                                     modelType->Actions = NULL;
                                     modelType->SchemaHandle = schemaHandle;
                                     modelType->DeviceCount = 0;
+                                    NameIndex_Init(&modelType->propertyIndex);
+                                    NameIndex_Init(&modelType->reportedPropertyIndex);
+                                    NameIndex_Init(&modelType->desiredPropertyIndex);
+                                    NameIndex_Init(&modelType->actionIndex);
+                                    NameIndex_Init(&modelType->methodIndex);
+                                    NameIndex_Init(&modelType->modelIndex);
 
                                     schema->ModelTypes[schema->ModelTypeCount] = modelType;
                                     schema->ModelTypeCount++;
+                                    NameIndex_ElementAdded(&schema->modelTypeIndex, schema->ModelTypes, getModelTypeName);
                                     /* Codes_SRS_SCHEMA_99_008:[On success, a non-NULL handle shall be returned.] */
                                     result = (SCHEMA_MODEL_TYPE_HANDLE)modelType;
                                 }
@@ -833,6 +1082,7 @@ SCHEMA_RESULT Schema_AddModelReportedProperty(SCHEMA_MODEL_TYPE_HANDLE modelType
                         else
                         {
                             /*Codes_SRS_SCHEMA_02_007: [ Otherwise Schema_AddModelReportedProperty shall succeed and return SCHEMA_OK. ]*/
+                            NameIndex_ElementAdded(&modelType->reportedPropertyIndex, modelType->reportedProperties, getReportedPropertyName);
                             result = SCHEMA_OK;
                         }
                     }
@@ -912,6 +1162,7 @@ SCHEMA_ACTION_HANDLE Schema_CreateModelAction(SCHEMA_MODEL_TYPE_HANDLE modelType
 
                         modelType->Actions[modelType->ActionCount] = newAction;
                         modelType->ActionCount++;
+                        NameIndex_ElementAdded(&modelType->actionIndex, modelType->Actions, getActionName);
                         result = (SCHEMA_ACTION_HANDLE)(newAction);
                     }
 
@@ -1010,7 +1261,7 @@ SCHEMA_METHOD_HANDLE Schema_CreateModelMethod(SCHEMA_MODEL_TYPE_HANDLE modelType
                         else
                         {
                             /*Codes_SRS_SCHEMA_02_104: [ Otherwise, Schema_CreateModelMethod shall succeed and return a non-NULL SCHEMA_METHOD_HANDLE. ]*/
-                            /*return as is*/
+                            NameIndex_ElementAdded(&modelTypeHandle->methodIndex, modelTypeHandle->methods, getMethodName);
                         }
                     }
                 }
@@ -1223,14 +1474,7 @@ SCHEMA_PROPERTY_HANDLE Schema_GetModelPropertyByName(SCHEMA_MODEL_TYPE_HANDLE mo
         SCHEMA_MODEL_TYPE_HANDLE_DATA* modelType = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
 
         /* Codes_SRS_SCHEMA_99_036:[Schema_GetModelPropertyByName shall return a non-NULL SCHEMA_PROPERTY_HANDLE corresponding to the model type identified by modelTypeHandle and matching the propertyName argument value.] */
-        for (i = 0; i < modelType->PropertyCount; i++)
-        {
-            SCHEMA_PROPERTY_HANDLE_DATA* modelProperty = (SCHEMA_PROPERTY_HANDLE_DATA*)modelType->Properties[i];
-            if (strcmp(modelProperty->PropertyName, propertyName) == 0)
-            {
-                break;
-            }
-        }
+        i = NameIndex_Find(&modelType->propertyIndex, modelType->Properties, getPropertyName, propertyName);
 
         if (i == modelType->PropertyCount)
         {
@@ -1313,7 +1557,7 @@ SCHEMA_REPORTED_PROPERTY_HANDLE Schema_GetModelReportedPropertyByName(SCHEMA_MOD
         SCHEMA_MODEL_TYPE_HANDLE_DATA* modelType = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
         /*Codes_SRS_SCHEMA_02_013: [ If reported property by the name reportedPropertyName exists then Schema_GetModelReportedPropertyByName shall succeed and return a non-NULL value. ]*/
         /*Codes_SRS_SCHEMA_02_014: [ Otherwise Schema_GetModelReportedPropertyByName shall fail and return NULL. ]*/
-        if((result = VECTOR_find_if(modelType->reportedProperties, reportedPropertyExists, reportedPropertyName))==NULL)
+        if((result = FindVectorElementByName(modelType->reportedProperties, &modelType->reportedPropertyIndex, reportedPropertyExists, getReportedPropertyName, reportedPropertyName))==NULL)
         {
             LogError("a reported property with name \"%s\" does not exist", reportedPropertyName);
         }
@@ -1391,14 +1635,7 @@ SCHEMA_ACTION_HANDLE Schema_GetModelActionByName(SCHEMA_MODEL_TYPE_HANDLE modelT
         SCHEMA_MODEL_TYPE_HANDLE_DATA* modelType = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
 
         /* Codes_SRS_SCHEMA_99_040:[Schema_GetModelActionByName shall return a non-NULL SCHEMA_ACTION_HANDLE corresponding to the model type identified by modelTypeHandle and matching the actionName argument value.] */
-        for (i = 0; i < modelType->ActionCount; i++)
-        {
-            SCHEMA_ACTION_HANDLE_DATA* modelAction = (SCHEMA_ACTION_HANDLE_DATA*)modelType->Actions[i];
-            if (strcmp(modelAction->ActionName, actionName) == 0)
-            {
-                break;
-            }
-        }
+        i = NameIndex_Find(&modelType->actionIndex, modelType->Actions, getActionName, actionName);
 
         if (i == modelType->ActionCount)
         {
@@ -1438,7 +1675,7 @@ SCHEMA_METHOD_HANDLE Schema_GetModelMethodByName(SCHEMA_MODEL_TYPE_HANDLE modelT
     else
     {
         /*Codes_SRS_SCHEMA_02_117: [ If a method with the name methodName exists then Schema_GetModelMethodByName shall succeed and returns its handle. ]*/
-        SCHEMA_METHOD_HANDLE* found = VECTOR_find_if(modelTypeHandle->methods, matchModelMethod, methodName);
+        SCHEMA_METHOD_HANDLE* found = FindVectorElementByName(modelTypeHandle->methods, &modelTypeHandle->methodIndex, matchModelMethod, getMethodName, methodName);
         if (found == NULL)
         {
             /*Codes_SRS_SCHEMA_02_118: [ Otherwise, Schema_GetModelMethodByName shall fail and return NULL. ]*/
@@ -1797,8 +2034,10 @@ SCHEMA_STRUCT_TYPE_HANDLE Schema_CreateStructType(SCHEMA_HANDLE schemaHandle, co
                     /* Codes_SRS_SCHEMA_99_057:[Schema_CreateStructType shall create a new struct type and return a handle to it.] */
                     schema->StructTypes[schema->StructTypeCount] = structType;
                     schema->StructTypeCount++;
+                    NameIndex_ElementAdded(&schema->structTypeIndex, schema->StructTypes, getStructTypeName);
                     structType->PropertyCount = 0;
                     structType->Properties = NULL;
+                    NameIndex_Init(&structType->propertyIndex);
 
                     /* Codes_SRS_SCHEMA_99_058:[On success, a non-NULL handle shall be returned.] */
                     result = (SCHEMA_STRUCT_TYPE_HANDLE)structType;
@@ -1885,14 +2124,7 @@ SCHEMA_STRUCT_TYPE_HANDLE Schema_GetStructTypeByName(SCHEMA_HANDLE schemaHandle,
         size_t i;
 
         /* Codes_SRS_SCHEMA_99_068:[Schema_GetStructTypeByName shall return a non-NULL handle corresponding to the struct type identified by the structTypeName in the schemaHandle schema.] */
-        for (i = 0; i < schema->StructTypeCount; i++)
-        {
-            SCHEMA_STRUCT_TYPE_HANDLE_DATA* structType = (SCHEMA_STRUCT_TYPE_HANDLE_DATA*)schema->StructTypes[i];
-            if (strcmp(structType->Name, name) == 0)
-            {
-                break;
-            }
-        }
+        i = NameIndex_Find(&schema->structTypeIndex, schema->StructTypes, getStructTypeName, name);
 
         if (i == schema->StructTypeCount)
         {
@@ -2002,6 +2234,7 @@ SCHEMA_RESULT Schema_AddStructTypeProperty(SCHEMA_STRUCT_TYPE_HANDLE structTypeH
                         /* Codes_SRS_SCHEMA_99_070:[Schema_AddStructTypeProperty shall add one property to the struct type identified by structTypeHandle.] */
                         structType->Properties[structType->PropertyCount] = (SCHEMA_PROPERTY_HANDLE)newProperty;
                         structType->PropertyCount++;
+                        NameIndex_ElementAdded(&structType->propertyIndex, structType->Properties, getPropertyName);
 
                         /* Codes_SRS_SCHEMA_99_071:[On success, Schema_AddStructTypeProperty shall return SCHEMA_OK.] */
                         result = SCHEMA_OK;
@@ -2045,14 +2278,7 @@ SCHEMA_PROPERTY_HANDLE Schema_GetStructTypePropertyByName(SCHEMA_STRUCT_TYPE_HAN
         size_t i;
         SCHEMA_STRUCT_TYPE_HANDLE_DATA* structType = (SCHEMA_STRUCT_TYPE_HANDLE_DATA*)structTypeHandle;
 
-        for (i = 0; i < structType->PropertyCount; i++)
-        {
-            SCHEMA_PROPERTY_HANDLE_DATA* modelProperty = (SCHEMA_PROPERTY_HANDLE_DATA*)structType->Properties[i];
-            if (strcmp(modelProperty->PropertyName, propertyName) == 0)
-            {
-                break;
-            }
-        }
+        i = NameIndex_Find(&structType->propertyIndex, structType->Properties, getPropertyName, propertyName);
 
         /* Codes_SRS_SCHEMA_99_076:[Schema_GetStructTypePropertyByName shall return NULL if unable to find a matching property or if any of the arguments are NULL.] */
         if (i == structType->PropertyCount)
@@ -2197,15 +2423,7 @@ SCHEMA_MODEL_TYPE_HANDLE Schema_GetModelByName(SCHEMA_HANDLE schemaHandle, const
     {
         /* Codes_SRS_SCHEMA_99_124: [Schema_GetModelByName shall return a non-NULL SCHEMA_MODEL_TYPE_HANDLE corresponding to the model identified by schemaHandle and matching the modelName argument value.] */
         SCHEMA_HANDLE_DATA* schema = (SCHEMA_HANDLE_DATA*)schemaHandle;
-        size_t i;
-        for (i = 0; i < schema->ModelTypeCount; i++)
-        {
-            SCHEMA_MODEL_TYPE_HANDLE_DATA* modelType = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)schema->ModelTypes[i];
-            if (strcmp(modelName, modelType->Name)==0)
-            {
-                break;
-            }
-        }
+        size_t i = NameIndex_Find(&schema->modelTypeIndex, schema->ModelTypes, getModelTypeName, modelName);
         if (i == schema->ModelTypeCount)
         {
             /* Codes_SRS_SCHEMA_99_125: [Schema_GetModelByName shall return NULL if unable to find a matching model, or if any of the arguments are NULL.] */
@@ -2294,7 +2512,7 @@ SCHEMA_RESULT Schema_AddModelModel(SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle, con
         else
         {
             /*Codes_SRS_SCHEMA_99_164: [If the function succeeds, then the return value shall be SCHEMA_OK.]*/
-            
+            NameIndex_ElementAdded(&parentModel->modelIndex, parentModel->models, getModelInModelName);
             result = SCHEMA_OK;
         }
     }
@@ -2349,7 +2567,7 @@ SCHEMA_MODEL_TYPE_HANDLE Schema_GetModelModelByName(SCHEMA_MODEL_TYPE_HANDLE mod
         SCHEMA_MODEL_TYPE_HANDLE_DATA* model = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
         /*Codes_SRS_SCHEMA_99_170: [Schema_GetModelModelByName shall return a handle to the model identified by the property with the name propertyName in the model identified by the handle modelTypeHandle.]*/
         /*Codes_SRS_SCHEMA_99_171: [If Schema_GetModelModelByName is unable to provide the handle it shall return NULL.]*/
-        void* temp = VECTOR_find_if(model->models, matchModelName, propertyName);
+        void* temp = FindVectorElementByName(model->models, &model->modelIndex, matchModelName, getModelInModelName, propertyName);
         if (temp == NULL)
         {
             LogError("specified propertyName not found (%s)", propertyName);
@@ -2381,7 +2599,7 @@ size_t Schema_GetModelModelByName_Offset(SCHEMA_MODEL_TYPE_HANDLE modelTypeHandl
     {
         SCHEMA_MODEL_TYPE_HANDLE_DATA* model = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
         /*Codes_SRS_SCHEMA_02_056: [ If propertyName is not a model then Schema_GetModelModelByName_Offset shall fail and return 0. ]*/
-        void* temp = VECTOR_find_if(model->models, matchModelName, propertyName);
+        void* temp = FindVectorElementByName(model->models, &model->modelIndex, matchModelName, getModelInModelName, propertyName);
         if (temp == NULL)
         {
             LogError("specified propertyName not found (%s)", propertyName);
@@ -2412,7 +2630,7 @@ pfOnDesiredProperty Schema_GetModelModelByName_OnDesiredProperty(SCHEMA_MODEL_TY
     else
     {
         SCHEMA_MODEL_TYPE_HANDLE_DATA* model = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
-        void* temp = VECTOR_find_if(model->models, matchModelName, propertyName);
+        void* temp = FindVectorElementByName(model->models, &model->modelIndex, matchModelName, getModelInModelName, propertyName);
         if (temp == NULL)
         {
             LogError("specified propertyName not found (%s)", propertyName);
@@ -2694,7 +2912,7 @@ static bool desiredPropertyExists(const void* element, const void* value)
     return (strcmp(desiredProperty->desiredPropertyName, value) == 0);
 }
 
-SCHEMA_RESULT Schema_AddModelDesiredProperty(SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle, const char* desiredPropertyName, const char* desiredPropertyType, pfDesiredPropertyFromAGENT_DATA_TYPE desiredPropertyFromAGENT_DATA_TYPE, pfDesiredPropertyInitialize desiredPropertyInitialize, pfDesiredPropertyDeinitialize desiredPropertyDeinitialize, size_t offset, pfOnDesiredProperty onDesiredProperty)
+SCHEMA_RESULT Schema_AddModelDesiredProperty(SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle, const char* desiredPropertyName, const char* desiredPropertyType, pfDesiredPropertyFromAGENT_DATA_TYPE desiredPropertyFromAGENT_DATA_TYPE, pfDesiredPropertyToAGENT_DATA_TYPE desiredPropertyToAGENT_DATA_TYPE, pfDesiredPropertyInitialize desiredPropertyInitialize, pfDesiredPropertyDeinitialize desiredPropertyDeinitialize, size_t offset, pfOnDesiredProperty onDesiredProperty)
 {
     SCHEMA_RESULT result;
     /*Codes_SRS_SCHEMA_02_024: [ If modelTypeHandle is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
@@ -2703,17 +2921,19 @@ SCHEMA_RESULT Schema_AddModelDesiredProperty(SCHEMA_MODEL_TYPE_HANDLE modelTypeH
     /*Codes_SRS_SCHEMA_02_048: [ If desiredPropertyFromAGENT_DATA_TYPE is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
     /*Codes_SRS_SCHEMA_02_049: [ If desiredPropertyInitialize is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
     /*Codes_SRS_SCHEMA_02_050: [ If desiredPropertyDeinitialize is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
+    /*Codes_SRS_SCHEMA_99_186: [ If desiredPropertyToAGENT_DATA_TYPE is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
     if (
         (modelTypeHandle == NULL) ||
         (desiredPropertyName == NULL) ||
         (desiredPropertyType == NULL) ||
         (desiredPropertyFromAGENT_DATA_TYPE == NULL) ||
+        (desiredPropertyToAGENT_DATA_TYPE == NULL) ||
         (desiredPropertyInitialize == NULL) ||
         (desiredPropertyDeinitialize== NULL)
         )
     {
-        LogError("invalid arg SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle=%p, const char* desiredPropertyName=%p, const char* desiredPropertyType=%p, pfDesiredPropertyFromAGENT_DATA_TYPE desiredPropertyFromAGENT_DATA_TYPE=%p, pfDesiredPropertyInitialize desiredPropertyInitialize=%p, pfDesiredPropertyDeinitialize desiredPropertyDeinitialize=%p, size_t offset=%zu",
-            modelTypeHandle, desiredPropertyName, desiredPropertyType, desiredPropertyFromAGENT_DATA_TYPE, desiredPropertyInitialize, desiredPropertyDeinitialize, offset);
+        LogError("invalid arg SCHEMA_MODEL_TYPE_HANDLE modelTypeHandle=%p, const char* desiredPropertyName=%p, const char* desiredPropertyType=%p, pfDesiredPropertyFromAGENT_DATA_TYPE desiredPropertyFromAGENT_DATA_TYPE=%p, pfDesiredPropertyToAGENT_DATA_TYPE desiredPropertyToAGENT_DATA_TYPE=%p, pfDesiredPropertyInitialize desiredPropertyInitialize=%p, pfDesiredPropertyDeinitialize desiredPropertyDeinitialize=%p, size_t offset=%zu",
+            modelTypeHandle, desiredPropertyName, desiredPropertyType, desiredPropertyFromAGENT_DATA_TYPE, desiredPropertyToAGENT_DATA_TYPE, desiredPropertyInitialize, desiredPropertyDeinitialize, offset);
         result = SCHEMA_INVALID_ARG;
     }
     else
@@ -2769,10 +2989,12 @@ SCHEMA_RESULT Schema_AddModelDesiredProperty(SCHEMA_MODEL_TYPE_HANDLE modelTypeH
                         {
                             /*Codes_SRS_SCHEMA_02_029: [ Otherwise, Schema_AddModelDesiredProperty shall succeed and return SCHEMA_OK. ]*/
                             desiredProperty->desiredPropertyFromAGENT_DATA_TYPE = desiredPropertyFromAGENT_DATA_TYPE;
+                            desiredProperty->desiredPropertyToAGENT_DATA_TYPE = desiredPropertyToAGENT_DATA_TYPE;
                             desiredProperty->desiredPropertInitialize = desiredPropertyInitialize;
                             desiredProperty->desiredPropertDeinitialize = desiredPropertyDeinitialize;
                             desiredProperty->onDesiredProperty = onDesiredProperty; /*NULL is a perfectly fine value*/
                             desiredProperty->offset = offset;
+                            NameIndex_ElementAdded(&handleData->desiredPropertyIndex, handleData->desiredProperties, getDesiredPropertyName);
                             result = SCHEMA_OK;
                         }
                     }
@@ -2825,7 +3047,7 @@ SCHEMA_DESIRED_PROPERTY_HANDLE Schema_GetModelDesiredPropertyByName(SCHEMA_MODEL
         /*Codes_SRS_SCHEMA_02_036: [ If a desired property having the name desiredPropertyName exists then Schema_GetModelDesiredPropertyByName shall succeed and return a non-NULL value. ]*/
         /*Codes_SRS_SCHEMA_02_037: [ Otherwise, Schema_GetModelDesiredPropertyByName shall fail and return NULL. ]*/
         SCHEMA_MODEL_TYPE_HANDLE_DATA* handleData = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
-        SCHEMA_DESIRED_PROPERTY_HANDLE* temp = VECTOR_find_if(handleData->desiredProperties, desiredPropertyExists, desiredPropertyName);
+        SCHEMA_DESIRED_PROPERTY_HANDLE* temp = FindVectorElementByName(handleData->desiredProperties, &handleData->desiredPropertyIndex, desiredPropertyExists, getDesiredPropertyName, desiredPropertyName);
         if (temp == NULL)
         {
             LogError("no such desired property by name %s", desiredPropertyName);
@@ -2985,6 +3207,24 @@ pfDesiredPropertyFromAGENT_DATA_TYPE Schema_GetModelDesiredProperty_pfDesiredPro
     return result;
 }
 
+pfDesiredPropertyToAGENT_DATA_TYPE Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle)
+{
+    pfDesiredPropertyToAGENT_DATA_TYPE result;
+    /*Codes_SRS_SCHEMA_99_187: [ If desiredPropertyHandle is NULL then Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE shall fail and return NULL. ]*/
+    if (desiredPropertyHandle == NULL)
+    {
+        LogError("invalid argument SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle=%p", desiredPropertyHandle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_SCHEMA_99_188: [ Otherwise Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE shall return the desiredPropertyToAGENT_DATA_TYPE that was passed to Schema_AddModelDesiredProperty. ]*/
+        SCHEMA_DESIRED_PROPERTY_HANDLE_DATA* desirePropertyHandleData = (SCHEMA_DESIRED_PROPERTY_HANDLE_DATA*)desiredPropertyHandle;
+        result = desirePropertyHandleData->desiredPropertyToAGENT_DATA_TYPE;
+    }
+    return result;
+}
+
 pfOnDesiredProperty Schema_GetModelDesiredProperty_pfOnDesiredProperty(SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle)
 {
     pfOnDesiredProperty result;
@@ -3044,7 +3284,7 @@ SCHEMA_MODEL_ELEMENT Schema_GetModelElementByName(SCHEMA_MODEL_TYPE_HANDLE model
     {
         SCHEMA_MODEL_TYPE_HANDLE_DATA* handleData = (SCHEMA_MODEL_TYPE_HANDLE_DATA*)modelTypeHandle;
 
-        SCHEMA_DESIRED_PROPERTY_HANDLE* desiredPropertyHandle = VECTOR_find_if(handleData->desiredProperties, desiredPropertyExists, elementName);
+        SCHEMA_DESIRED_PROPERTY_HANDLE* desiredPropertyHandle = FindVectorElementByName(handleData->desiredProperties, &handleData->desiredPropertyIndex, desiredPropertyExists, getDesiredPropertyName, elementName);
         if (desiredPropertyHandle != NULL)
         {
             /*Codes_SRS_SCHEMA_02_080: [ If elementName is a desired property then Schema_GetModelElementByName shall succeed and set SCHEMA_MODEL_ELEMENT.elementType to SCHEMA_DESIRED_PROPERTY and SCHEMA_MODEL_ELEMENT.elementHandle.desiredPropertyHandle to the handle of the desired property. ]*/
@@ -3053,31 +3293,17 @@ SCHEMA_MODEL_ELEMENT Schema_GetModelElementByName(SCHEMA_MODEL_TYPE_HANDLE model
         }
         else
         {
-            size_t nProcessedProperties = 0;
-            SCHEMA_PROPERTY_HANDLE_DATA* property = NULL;
-            for (size_t i = 0; i < handleData->PropertyCount;i++)
-            {
-                property = (SCHEMA_PROPERTY_HANDLE_DATA*)(handleData->Properties[i]);
-                if (strcmp(property->PropertyName, elementName) == 0)
-                {
-                    i = handleData->PropertyCount; /*found it*/
-                }
-                else
-                {
-                    nProcessedProperties++;
-                }
-            }
-
-            if (nProcessedProperties < handleData->PropertyCount)
+            size_t propertyPosition = NameIndex_Find(&handleData->propertyIndex, handleData->Properties, getPropertyName, elementName);
+            if (propertyPosition < handleData->PropertyCount)
             {
                 /*Codes_SRS_SCHEMA_02_078: [ If elementName is a property then Schema_GetModelElementByName shall succeed and set SCHEMA_MODEL_ELEMENT.elementType to SCHEMA_PROPERTY and SCHEMA_MODEL_ELEMENT.elementHandle.propertyHandle to the handle of the property. ]*/
                 result.elementType = SCHEMA_PROPERTY;
-                result.elementHandle.propertyHandle = property;
+                result.elementHandle.propertyHandle = handleData->Properties[propertyPosition];
             }
             else
             {
 
-                SCHEMA_REPORTED_PROPERTY_HANDLE* reportedPropertyHandle = VECTOR_find_if(handleData->reportedProperties, reportedPropertyExists, elementName);
+                SCHEMA_REPORTED_PROPERTY_HANDLE* reportedPropertyHandle = FindVectorElementByName(handleData->reportedProperties, &handleData->reportedPropertyIndex, reportedPropertyExists, getReportedPropertyName, elementName);
                 if (reportedPropertyHandle != NULL)
                 {
                     /*Codes_SRS_SCHEMA_02_079: [ If elementName is a reported property then Schema_GetModelElementByName shall succeed and set SCHEMA_MODEL_ELEMENT.elementType to SCHEMA_REPORTED_PROPERTY and SCHEMA_MODEL_ELEMENT.elementHandle.reportedPropertyHandle to the handle of the reported property. ]*/
@@ -3087,30 +3313,16 @@ SCHEMA_MODEL_ELEMENT Schema_GetModelElementByName(SCHEMA_MODEL_TYPE_HANDLE model
                 else
                 {
 
-                    size_t nProcessedActions = 0;
-                    SCHEMA_ACTION_HANDLE_DATA* actionHandleData = NULL;
-                    for (size_t i = 0;i < handleData->ActionCount; i++)
-                    {
-                        actionHandleData = (SCHEMA_ACTION_HANDLE_DATA*)(handleData->Actions[i]);
-                        if (strcmp(actionHandleData->ActionName, elementName) == 0)
-                        {
-                            i = handleData->ActionCount; /*get out quickly*/
-                        }
-                        else
-                        {
-                            nProcessedActions++;
-                        }
-                    }
-
-                    if (nProcessedActions < handleData->ActionCount)
+                    size_t actionPosition = NameIndex_Find(&handleData->actionIndex, handleData->Actions, getActionName, elementName);
+                    if (actionPosition < handleData->ActionCount)
                     {
                         /*Codes_SRS_SCHEMA_02_081: [ If elementName is a model action then Schema_GetModelElementByName shall succeed and set SCHEMA_MODEL_ELEMENT.elementType to SCHEMA_MODEL_ACTION and SCHEMA_MODEL_ELEMENT.elementHandle.actionHandle to the handle of the action. ]*/
                         result.elementType = SCHEMA_MODEL_ACTION;
-                        result.elementHandle.actionHandle = actionHandleData;
+                        result.elementHandle.actionHandle = handleData->Actions[actionPosition];
                     }
                     else
                     {
-                        MODEL_IN_MODEL* modelInModel = VECTOR_find_if(handleData->models, modelInModelExists, elementName);
+                        MODEL_IN_MODEL* modelInModel = FindVectorElementByName(handleData->models, &handleData->modelIndex, modelInModelExists, getModelInModelName, elementName);
                         if (modelInModel != NULL)
                         {
                             /*Codes_SRS_SCHEMA_02_082: [ If elementName is a model in model then Schema_GetModelElementByName shall succeed and set SCHEMA_MODEL_ELEMENT.elementType to SCHEMA_MODEL_IN_MODEL and SCHEMA_MODEL_ELEMENT.elementHandle.modelHandle to the handle of the model. ]*/
@@ -4638,6 +4638,84 @@ BEGIN_TEST_SUITE(AgentTypeSystem_ut)
             ASSERT_ARE_EQUAL(float, TEST_FLOAT_2, (float)atof(STRING_c_str(global_bufferTemp)));
 
         }
+
+        /*Tests_SRS_AGENT_TYPE_SYSTEM_99_112: [ EDM_SINGLE and EDM_DOUBLE values that are not NaN or infinite shall be written as the shortest doubleValue that converts back to the same value, independent of the current locale. ]*/
+        TEST_FUNCTION(AgentDataTypes_ToString_DOUBLE_produces_the_shortest_text)
+        {
+            const struct
+            {
+                double value;
+                const char* expectedOutput;
+            } testVector[] =
+            {
+                { 23.5, "23.5" },
+                { 0.1, "0.1" },
+                { -0.0, "-0.0" },
+                { 42.0, "42.0" },
+                { 0.0001, "0.0001" },
+                { 0.00001, "1e-05" },
+                { 1e300, "1e+300" },
+                { 328647.47547929373980211, "328647.47547929373" },
+                { 123456789012345678.0, "1.2345678901234568e+17" },
+                { DBL_MAX, "1.7976931348623157e+308" },
+                { DBL_MIN, "2.2250738585072014e-308" },
+                { 4.9406564584124654e-324, "5e-324" }
+            };
+
+            for (size_t i = 0; i < sizeof(testVector) / sizeof(testVector[0]); i++)
+            {
+                ///arrange
+                AGENT_DATA_TYPE agentData;
+                (void)Create_AGENT_DATA_TYPE_from_DOUBLE(&agentData, testVector[i].value);
+                STRING_empty(global_bufferTemp);
+
+                ///act
+                auto res = AgentDataTypes_ToString(global_bufferTemp, &agentData);
+
+                ///assert
+                ASSERT_ARE_EQUAL(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_OK, res);
+                ASSERT_ARE_EQUAL(char_ptr, testVector[i].expectedOutput, STRING_c_str(global_bufferTemp));
+
+                ///cleanup
+                Destroy_AGENT_DATA_TYPE(&agentData);
+            }
+        }
+
+        /*Tests_SRS_AGENT_TYPE_SYSTEM_99_112: [ EDM_SINGLE and EDM_DOUBLE values that are not NaN or infinite shall be written as the shortest doubleValue that converts back to the same value, independent of the current locale. ]*/
+        TEST_FUNCTION(AgentDataTypes_ToString_FLOAT_produces_the_shortest_text)
+        {
+            const struct
+            {
+                float value;
+                const char* expectedOutput;
+            } testVector[] =
+            {
+                { 42.5f, "42.5" },
+                { 42.589123f, "42.589123" },
+                { 0.1f, "0.1" },
+                { 16777216.0f, "16777216.0" },
+                { FLT_MAX, "3.4028235e+38" },
+                { FLT_MIN, "1.1754944e-38" }
+            };
+
+            for (size_t i = 0; i < sizeof(testVector) / sizeof(testVector[0]); i++)
+            {
+                ///arrange
+                AGENT_DATA_TYPE agentData;
+                (void)Create_AGENT_DATA_TYPE_from_FLOAT(&agentData, testVector[i].value);
+                STRING_empty(global_bufferTemp);
+
+                ///act
+                auto res = AgentDataTypes_ToString(global_bufferTemp, &agentData);
+
+                ///assert
+                ASSERT_ARE_EQUAL(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_OK, res);
+                ASSERT_ARE_EQUAL(char_ptr, testVector[i].expectedOutput, STRING_c_str(global_bufferTemp));
+
+                ///cleanup
+                Destroy_AGENT_DATA_TYPE(&agentData);
+            }
+        }
 #endif
 
         /*Tests_SRS_AGENT_TYPE_SYSTEM_99_043:[ Creates an AGENT_DATA_TYPE containing an EDM_INT16 from int16_t]*/
@@ -0,0 +1,580 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umock_c_negative_tests.h"
+
+#include "azure_c_shared_utility/macro_utils.h"
+
+#define ENABLE_MOCKS
+#include "multitree.h"
+#include "agenttypesystem.h"
+#include "azure_c_shared_utility/buffer_.h"
+#undef ENABLE_MOCKS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    extern BUFFER_HANDLE real_BUFFER_create(const unsigned char* source, size_t size);
+    extern void real_BUFFER_delete(BUFFER_HANDLE handle);
+    extern unsigned char* real_BUFFER_u_char(BUFFER_HANDLE handle);
+    extern size_t real_BUFFER_length(BUFFER_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "cbordecoder.h"
+
+#define TEST_MULTITREE_HANDLE ((MULTITREE_HANDLE)0x4242)
+#define TEST_CHILD_HANDLE ((MULTITREE_HANDLE)0x4243)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MULTITREE_RESULT, MULTITREE_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(AGENT_DATA_TYPE_TYPE, AGENT_DATA_TYPE_TYPE_VALUES);
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static char* stringifyBytes(const unsigned char* bytes, size_t size)
+{
+    char* result = (char*)malloc(size * 2 + 1);
+    if (result == NULL)
+    {
+        ASSERT_FAIL("cannot malloc");
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < size; i++)
+        {
+            (void)sprintf(result + 2 * i, "%02X", bytes[i]);
+        }
+        result[size * 2] = '\0';
+    }
+    return result;
+}
+
+static char* umockvalue_stringify_EDM_BINARY(const EDM_BINARY* value)
+{
+    return stringifyBytes(value->data, value->size);
+}
+
+static int umockvalue_are_equal_EDM_BINARY(const EDM_BINARY* left, const EDM_BINARY* right)
+{
+    return (left->size == right->size) &&
+        ((left->size == 0) || (memcmp(left->data, right->data, left->size) == 0));
+}
+
+/*the data of the copies points into buffers that outlive the test*/
+static int umockvalue_copy_EDM_BINARY(EDM_BINARY* destination, const EDM_BINARY* source)
+{
+    *destination = *source;
+    return 0;
+}
+
+static void umockvalue_free_EDM_BINARY(EDM_BINARY* value)
+{
+    (void)value;
+}
+
+static char* umockvalue_stringify_EDM_GUID(const EDM_GUID* value)
+{
+    return stringifyBytes(value->GUID, sizeof(value->GUID));
+}
+
+static int umockvalue_are_equal_EDM_GUID(const EDM_GUID* left, const EDM_GUID* right)
+{
+    return (memcmp(left->GUID, right->GUID, sizeof(left->GUID)) == 0);
+}
+
+static int umockvalue_copy_EDM_GUID(EDM_GUID* destination, const EDM_GUID* source)
+{
+    (void)memcpy(destination->GUID, source->GUID, sizeof(source->GUID));
+    return 0;
+}
+
+static void umockvalue_free_EDM_GUID(EDM_GUID* value)
+{
+    (void)value;
+}
+
+static MULTITREE_RESULT my_MultiTree_AddChild(MULTITREE_HANDLE treeHandle, const char* childName, MULTITREE_HANDLE* childHandle)
+{
+    (void)treeHandle;
+    (void)childName;
+    *childHandle = TEST_CHILD_HANDLE;
+    return MULTITREE_OK;
+}
+
+static BUFFER_HANDLE inputBuffer;
+
+static BUFFER_HANDLE make_input(const char* bytes, size_t size)
+{
+    inputBuffer = real_BUFFER_create((const unsigned char*)bytes, size);
+    ASSERT_IS_NOT_NULL(inputBuffer);
+    return inputBuffer;
+}
+
+static void setup_one_leaf_expectations(BUFFER_HANDLE input)
+{
+    STRICT_EXPECTED_CALL(BUFFER_u_char(input));
+    STRICT_EXPECTED_CALL(BUFFER_length(input));
+    STRICT_EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+}
+
+static void assert_decoding_fails(const char* bytes, size_t size)
+{
+    ///arrange
+    BUFFER_HANDLE input = make_input(bytes, size);
+    MULTITREE_HANDLE result;
+
+    ///act
+    result = CBORDecoder_DecodeTree(input);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+}
+
+BEGIN_TEST_SUITE(cbordecoder_ut)
+
+    TEST_SUITE_INITIALIZE(TestClassInitialize)
+    {
+        TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+        g_testByTest = TEST_MUTEX_CREATE();
+        ASSERT_IS_NOT_NULL(g_testByTest);
+
+        (void)umock_c_init(on_umock_c_error);
+        (void)umocktypes_charptr_register_types();
+        (void)umocktypes_stdint_register_types();
+
+        REGISTER_UMOCK_ALIAS_TYPE(MULTITREE_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(MULTITREE_CLONE_FUNCTION, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(MULTITREE_FREE_FUNCTION, void*);
+        REGISTER_TYPE(MULTITREE_RESULT, MULTITREE_RESULT);
+        REGISTER_TYPE(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_RESULT);
+        REGISTER_TYPE(AGENT_DATA_TYPE_TYPE, AGENT_DATA_TYPE_TYPE);
+        REGISTER_UMOCK_VALUE_TYPE(EDM_BINARY,
+            umockvalue_stringify_EDM_BINARY,
+            umockvalue_are_equal_EDM_BINARY,
+            umockvalue_copy_EDM_BINARY,
+            umockvalue_free_EDM_BINARY
+        );
+        REGISTER_UMOCK_VALUE_TYPE(EDM_GUID,
+            umockvalue_stringify_EDM_GUID,
+            umockvalue_are_equal_EDM_GUID,
+            umockvalue_copy_EDM_GUID,
+            umockvalue_free_EDM_GUID
+        );
+
+        REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, real_BUFFER_u_char);
+        REGISTER_GLOBAL_MOCK_HOOK(BUFFER_length, real_BUFFER_length);
+
+        REGISTER_GLOBAL_MOCK_RETURN(MultiTree_Create, TEST_MULTITREE_HANDLE);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_Create, NULL);
+        REGISTER_GLOBAL_MOCK_HOOK(MultiTree_AddChild, my_MultiTree_AddChild);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_AddChild, MULTITREE_ERROR);
+        REGISTER_GLOBAL_MOCK_RETURN(MultiTree_AddLeaf, MULTITREE_OK);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_AddLeaf, MULTITREE_ERROR);
+
+        REGISTER_GLOBAL_MOCK_RETURN(Create_AGENT_DATA_TYPE_from_SINT64, AGENT_DATA_TYPES_OK);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(Create_AGENT_DATA_TYPE_from_SINT64, AGENT_DATA_TYPES_ERROR);
+    }
+
+    TEST_SUITE_CLEANUP(TestClassCleanup)
+    {
+        umock_c_deinit();
+
+        TEST_MUTEX_DESTROY(g_testByTest);
+        TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    }
+
+    TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+    {
+        if (TEST_MUTEX_ACQUIRE(g_testByTest))
+        {
+            ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+        }
+
+        umock_c_reset_all_calls();
+        inputBuffer = NULL;
+    }
+
+    TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+    {
+        if (inputBuffer != NULL)
+        {
+            real_BUFFER_delete(inputBuffer);
+        }
+        TEST_MUTEX_RELEASE(g_testByTest);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_001: [ If decodeData is NULL, CBORDecoder_DecodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_NULL_decodeData_fails)
+    {
+        ///arrange
+
+        ///act
+        MULTITREE_HANDLE result = CBORDecoder_DecodeTree(NULL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_002: [ On success, CBORDecoder_DecodeTree shall return the MULTITREE_HANDLE holding the decoded data. ]*/
+    /*Tests_SRS_CBOR_DECODER_99_003: [ The data shall hold exactly one map (RFC 7049). ]*/
+    /*Tests_SRS_CBOR_DECODER_99_004: [ CBORDecoder_DecodeTree shall create a MULTITREE_HANDLE whose values are AGENT_DATA_TYPE*. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_empty_map_produces_empty_tree)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA0", 1);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_008: [ Unsigned and negative integers shall be decoded as EDM_INT64. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_one_integer_happy_path)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA1\x61" "a" "\x18\x64", 5);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_SINT64(IGNORED_PTR_ARG, 100));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "a", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_020: [ If any failure occurs, CBORDecoder_DecodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_one_integer_unhappy_paths)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA1\x61" "a" "\x18\x64", 5);
+        size_t calls_that_cannot_fail[] =
+        {
+            0, /*BUFFER_u_char*/
+            1, /*BUFFER_length*/
+            5, /*Destroy_AGENT_DATA_TYPE*/
+        };
+        size_t i;
+
+        (void)umock_c_negative_tests_init();
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_SINT64(IGNORED_PTR_ARG, 100));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "a", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        umock_c_negative_tests_snapshot();
+
+        for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+        {
+            size_t j;
+            bool canFail = true;
+            for (j = 0; j < sizeof(calls_that_cannot_fail) / sizeof(calls_that_cannot_fail[0]); j++)
+            {
+                if (calls_that_cannot_fail[j] == i)
+                {
+                    canFail = false;
+                    break;
+                }
+            }
+
+            if (canFail)
+            {
+                MULTITREE_HANDLE result;
+                char temp_str[128];
+
+                umock_c_negative_tests_reset();
+                umock_c_negative_tests_fail_call(i);
+
+                ///act
+                result = CBORDecoder_DecodeTree(input);
+
+                ///assert
+                (void)sprintf(temp_str, "On failed call %zu", i);
+                ASSERT_IS_NULL_WITH_MSG(result, temp_str);
+            }
+        }
+
+        ///cleanup
+        umock_c_negative_tests_deinit();
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_008: [ Unsigned and negative integers shall be decoded as EDM_INT64. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_decodes_negative_and_64_bit_integers)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA2\x61" "n" "\x39\x01\xF3" "\x61" "m" "\x1B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 17);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_SINT64(IGNORED_PTR_ARG, -500));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "n", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_SINT64(IGNORED_PTR_ARG, INT64_MAX));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "m", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_009: [ Integers that do not fit in EDM_INT64 shall be rejected. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_integer_out_of_range_fails)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA1\x61" "a" "\x1B\x80\x00\x00\x00\x00\x00\x00\x00", 12);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(MultiTree_Destroy(TEST_MULTITREE_HANDLE));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_010: [ Byte strings shall be decoded as EDM_BINARY. ]*/
+    /*Tests_SRS_CBOR_DECODER_99_011: [ Text strings shall be decoded as EDM_STRING. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_decodes_strings)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA2\x61" "s" "\x63" "abc" "\x61" "b" "\x43\x01\x02\x03", 12);
+        unsigned char bytes[3] = { 1, 2, 3 };
+        EDM_BINARY binary;
+        MULTITREE_HANDLE result;
+        binary.size = sizeof(bytes);
+        binary.data = bytes;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_charz(IGNORED_PTR_ARG, "abc"));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "s", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_EDM_BINARY(IGNORED_PTR_ARG, binary));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "b", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_012: [ Maps shall be decoded as child nodes named after their keys. ]*/
+    /*Tests_SRS_CBOR_DECODER_99_016: [ The simple values false and true shall be decoded as EDM_BOOLEAN, null and undefined as EDM_NULL. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_decodes_nested_maps_as_children)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input("\xA1\x65" "Inner" "\xA2\x61" "x" "\xF5\x61" "z" "\xF6", 14);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(MultiTree_AddChild(TEST_MULTITREE_HANDLE, "Inner", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_EDM_BOOLEAN_from_int(IGNORED_PTR_ARG, 1));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_CHILD_HANDLE, "x", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_NULL_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_CHILD_HANDLE, "z", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_013: [ A text string tagged 0 shall be decoded as EDM_DATE_TIME_OFFSET and a text string tagged 1004 as EDM_DATE. ]*/
+    /*Tests_SRS_CBOR_DECODER_99_014: [ A 16 bytes byte string tagged 37 shall be decoded as EDM_GUID. ]*/
+    /*Tests_SRS_CBOR_DECODER_99_015: [ Any other tag shall be ignored and the tagged item decoded in its place. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_decodes_tagged_items)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input(
+            "\xA4"
+            "\x61" "t" "\xC0\x74" "2017-02-02T03:04:05Z"
+            "\x61" "d" "\xD9\x03\xEC\x6A" "2017-03-04"
+            "\x61" "g" "\xD8\x25\x50\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F"
+            "\x61" "e" "\xC1\x1A\x59\x93\x7E\x45", 1 + 24 + 16 + 21 + 8);
+        EDM_GUID guid;
+        MULTITREE_HANDLE result;
+        size_t i;
+        for (i = 0; i < sizeof(guid.GUID); i++)
+        {
+            guid.GUID[i] = (uint8_t)i;
+        }
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(CreateAgentDataType_From_String("\"2017-02-02T03:04:05Z\"", EDM_DATE_TIME_OFFSET_TYPE, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "t", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(CreateAgentDataType_From_String("\"2017-03-04\"", EDM_DATE_TYPE, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "d", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_EDM_GUID(IGNORED_PTR_ARG, guid));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "g", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_SINT64(IGNORED_PTR_ARG, 1502838341));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "e", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_017: [ Half, single and double precision floats shall be decoded as EDM_DOUBLE. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_decodes_floats_as_doubles)
+    {
+        ///arrange
+        BUFFER_HANDLE input = make_input(
+            "\xA3"
+            "\x61" "h" "\xF9\x3C\x00"
+            "\x61" "f" "\xFA\x41\xAC\x00\x00"
+            "\x61" "d" "\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 1 + 5 + 7 + 11);
+        MULTITREE_HANDLE result;
+
+        setup_one_leaf_expectations(input);
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_DOUBLE(IGNORED_PTR_ARG, 1.0));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "h", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_DOUBLE(IGNORED_PTR_ARG, 21.5));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "f", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Create_AGENT_DATA_TYPE_from_DOUBLE(IGNORED_PTR_ARG, 0.1));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(TEST_MULTITREE_HANDLE, "d", IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBORDecoder_DecodeTree(input);
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, TEST_MULTITREE_HANDLE, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_003: [ The data shall hold exactly one map (RFC 7049). ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_data_that_is_not_a_map_fails)
+    {
+        assert_decoding_fails("\x01", 1);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_005: [ Bytes following the map shall be rejected. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_trailing_bytes_fails)
+    {
+        assert_decoding_fails("\xA0\x00", 2);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_006: [ Indefinite length items and reserved additional information values shall be rejected. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_indefinite_length_map_fails)
+    {
+        assert_decoding_fails("\xBF\x61" "a" "\x01\xFF", 5);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_007: [ Data nested deeper than 32 maps or tags shall be rejected. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_too_deep_nesting_fails)
+    {
+        char bytes[1 + 40 * 3];
+        size_t i;
+        bytes[0] = '\xA1';
+        for (i = 0; i < 40; i++)
+        {
+            bytes[1 + 3 * i] = '\x61';
+            bytes[2 + 3 * i] = 'a';
+            bytes[3 + 3 * i] = (i == 39) ? '\xA0' : '\xA1';
+        }
+
+        assert_decoding_fails(bytes, sizeof(bytes));
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_014: [ A 16 bytes byte string tagged 37 shall be decoded as EDM_GUID. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_short_uuid_fails)
+    {
+        assert_decoding_fails("\xA1\x61" "g" "\xD8\x25\x42\x00\x01", 8);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_018: [ Arrays shall be rejected since a MULTITREE_HANDLE cannot hold them. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_array_fails)
+    {
+        assert_decoding_fails("\xA1\x61" "a" "\x81\x01", 5);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_019: [ Map keys shall be non-empty text strings that do not contain '/'. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_invalid_keys_fails)
+    {
+        assert_decoding_fails("\xA1\x01\x01", 3);
+    }
+
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_empty_key_fails)
+    {
+        assert_decoding_fails("\xA1\x60\x01", 3);
+    }
+
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_key_containing_slash_fails)
+    {
+        assert_decoding_fails("\xA1\x63" "a/b" "\x01", 6);
+    }
+
+    /*Tests_SRS_CBOR_DECODER_99_020: [ If any failure occurs, CBORDecoder_DecodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBORDecoder_DecodeTree_with_truncated_string_fails)
+    {
+        assert_decoding_fails("\xA1\x61" "a" "\x7B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 12);
+    }
+
+END_TEST_SUITE(cbordecoder_ut)
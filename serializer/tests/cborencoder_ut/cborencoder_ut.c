@@ -0,0 +1,581 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "testrunnerswitcher.h"
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umock_c_negative_tests.h"
+
+#include "azure_c_shared_utility/macro_utils.h"
+
+#define ENABLE_MOCKS
+#include "multitree.h"
+#include "agenttypesystem.h"
+#include "azure_c_shared_utility/strings.h"
+#include "azure_c_shared_utility/buffer_.h"
+#undef ENABLE_MOCKS
+
+#include "real_strings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    extern BUFFER_HANDLE real_BUFFER_create(const unsigned char* source, size_t size);
+    extern void real_BUFFER_delete(BUFFER_HANDLE handle);
+    extern unsigned char* real_BUFFER_u_char(BUFFER_HANDLE handle);
+    extern size_t real_BUFFER_length(BUFFER_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "cborencoder.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+static TEST_MUTEX_HANDLE g_dllByDll;
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MULTITREE_RESULT, MULTITREE_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_RESULT_VALUES);
+
+DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s", ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+/*the MULTITREE_HANDLEs given to CBOREncoder_EncodeTree are TEST_NODE* interpreted by the MultiTree hooks below*/
+typedef struct TEST_NODE_TAG
+{
+    const char* name;
+    const void* value;
+    size_t childCount;
+    struct TEST_NODE_TAG* children;
+} TEST_NODE;
+
+#define TEST_TREE(node) ((MULTITREE_HANDLE)(node))
+
+static MULTITREE_RESULT my_MultiTree_GetChildCount(MULTITREE_HANDLE treeHandle, size_t* count)
+{
+    *count = ((TEST_NODE*)treeHandle)->childCount;
+    return MULTITREE_OK;
+}
+
+static MULTITREE_RESULT my_MultiTree_GetChild(MULTITREE_HANDLE treeHandle, size_t index, MULTITREE_HANDLE* childHandle)
+{
+    *childHandle = TEST_TREE(((TEST_NODE*)treeHandle)->children + index);
+    return MULTITREE_OK;
+}
+
+static MULTITREE_RESULT my_MultiTree_GetName(MULTITREE_HANDLE treeHandle, STRING_HANDLE destination)
+{
+    return (real_STRING_concat(destination, ((TEST_NODE*)treeHandle)->name) == 0) ? MULTITREE_OK : MULTITREE_ERROR;
+}
+
+static MULTITREE_RESULT my_MultiTree_GetValue(MULTITREE_HANDLE treeHandle, const void** destination)
+{
+    *destination = ((TEST_NODE*)treeHandle)->value;
+    return MULTITREE_OK;
+}
+
+static const char* toStringOutput;
+static AGENT_DATA_TYPES_RESULT toStringResult;
+static AGENT_DATA_TYPES_RESULT my_AgentDataTypes_ToString(STRING_HANDLE destination, const AGENT_DATA_TYPE* value)
+{
+    (void)value;
+    return ((toStringResult == AGENT_DATA_TYPES_OK) && (real_STRING_concat(destination, toStringOutput) == 0)) ? AGENT_DATA_TYPES_OK : AGENT_DATA_TYPES_ERROR;
+}
+
+static void assert_buffer_is(BUFFER_HANDLE buffer, const unsigned char* expected, size_t expectedSize)
+{
+    ASSERT_IS_NOT_NULL(buffer);
+    ASSERT_ARE_EQUAL(size_t, expectedSize, real_BUFFER_length(buffer));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(real_BUFFER_u_char(buffer), expected, expectedSize));
+}
+
+/*encodes {"a": value} and checks the bytes that follow the map head and the key*/
+static void assert_value_is_encoded_as(const AGENT_DATA_TYPE* value, const unsigned char* expected, size_t expectedSize)
+{
+    ///arrange
+    TEST_NODE leaf = { "a", NULL, 0, NULL };
+    TEST_NODE root = { NULL, NULL, 1, NULL };
+    BUFFER_HANDLE result;
+    leaf.value = value;
+    root.children = &leaf;
+
+    ///act
+    result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 3 + expectedSize, real_BUFFER_length(result));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(real_BUFFER_u_char(result), "\xA1\x61" "a", 3));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(real_BUFFER_u_char(result) + 3, expected, expectedSize));
+
+    ///cleanup
+    real_BUFFER_delete(result);
+}
+
+BEGIN_TEST_SUITE(cborencoder_ut)
+
+    TEST_SUITE_INITIALIZE(TestClassInitialize)
+    {
+        TEST_INITIALIZE_MEMORY_DEBUG(g_dllByDll);
+        g_testByTest = TEST_MUTEX_CREATE();
+        ASSERT_IS_NOT_NULL(g_testByTest);
+
+        (void)umock_c_init(on_umock_c_error);
+        (void)umocktypes_charptr_register_types();
+        (void)umocktypes_stdint_register_types();
+
+        REGISTER_UMOCK_ALIAS_TYPE(MULTITREE_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+        REGISTER_TYPE(MULTITREE_RESULT, MULTITREE_RESULT);
+        REGISTER_TYPE(AGENT_DATA_TYPES_RESULT, AGENT_DATA_TYPES_RESULT);
+
+        REGISTER_STRING_GLOBAL_MOCK_HOOK;
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_new, NULL);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_empty, __LINE__);
+
+        REGISTER_GLOBAL_MOCK_HOOK(BUFFER_create, real_BUFFER_create);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(BUFFER_create, NULL);
+
+        REGISTER_GLOBAL_MOCK_HOOK(MultiTree_GetChildCount, my_MultiTree_GetChildCount);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_GetChildCount, MULTITREE_ERROR);
+        REGISTER_GLOBAL_MOCK_HOOK(MultiTree_GetChild, my_MultiTree_GetChild);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_GetChild, MULTITREE_ERROR);
+        REGISTER_GLOBAL_MOCK_HOOK(MultiTree_GetName, my_MultiTree_GetName);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_GetName, MULTITREE_ERROR);
+        REGISTER_GLOBAL_MOCK_HOOK(MultiTree_GetValue, my_MultiTree_GetValue);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(MultiTree_GetValue, MULTITREE_ERROR);
+
+        REGISTER_GLOBAL_MOCK_HOOK(AgentDataTypes_ToString, my_AgentDataTypes_ToString);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(AgentDataTypes_ToString, AGENT_DATA_TYPES_ERROR);
+    }
+
+    TEST_SUITE_CLEANUP(TestClassCleanup)
+    {
+        umock_c_deinit();
+
+        TEST_MUTEX_DESTROY(g_testByTest);
+        TEST_DEINITIALIZE_MEMORY_DEBUG(g_dllByDll);
+    }
+
+    TEST_FUNCTION_INITIALIZE(TestMethodInitialize)
+    {
+        if (TEST_MUTEX_ACQUIRE(g_testByTest))
+        {
+            ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+        }
+
+        umock_c_reset_all_calls();
+        toStringOutput = "";
+        toStringResult = AGENT_DATA_TYPES_OK;
+    }
+
+    TEST_FUNCTION_CLEANUP(TestMethodCleanup)
+    {
+        TEST_MUTEX_RELEASE(g_testByTest);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_001: [ If treeHandle is NULL, CBOREncoder_EncodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_NULL_treeHandle_fails)
+    {
+        ///arrange
+
+        ///act
+        BUFFER_HANDLE result = CBOREncoder_EncodeTree(NULL, DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_002: [ On success, CBOREncoder_EncodeTree shall return a BUFFER_HANDLE holding the encoded tree. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_003: [ The root of the tree shall be written as a map (RFC 7049), also when it has no children. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_empty_tree_produces_an_empty_map)
+    {
+        ///arrange
+        TEST_NODE root = { NULL, NULL, 0, NULL };
+        BUFFER_HANDLE result;
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(TEST_TREE(&root), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 1));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        assert_buffer_is(result, (const unsigned char*)"\xA0", 1);
+
+        ///cleanup
+        real_BUFFER_delete(result);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_004: [ A node that has children shall be written as a map holding, for every child in order, the child's name as a text string followed by the child's encoding. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_007: [ When dataType is DATA_SERIALIZER_TYPE_AGENT_DATA the value of a leaf shall be written according to its AGENT_DATA_TYPE type: ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_one_leaf_happy_path)
+    {
+        ///arrange
+        AGENT_DATA_TYPE value;
+        TEST_NODE leaf = { "temperature", NULL, 0, NULL };
+        TEST_NODE root = { NULL, NULL, 1, NULL };
+        BUFFER_HANDLE result;
+        value.type = EDM_INT32_TYPE;
+        value.value.edmInt32.value = 100;
+        leaf.value = &value;
+        root.children = &leaf;
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(TEST_TREE(&root), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(MultiTree_GetChild(TEST_TREE(&root), 0, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_empty(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetName(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetValue(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 15));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+        ///act
+        result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        assert_buffer_is(result, (const unsigned char*)"\xA1\x6B" "temperature" "\x18\x64", 15);
+
+        ///cleanup
+        real_BUFFER_delete(result);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_020: [ If any failure occurs, CBOREncoder_EncodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_one_leaf_unhappy_paths)
+    {
+        ///arrange
+        AGENT_DATA_TYPE value;
+        TEST_NODE leaf = { "temperature", NULL, 0, NULL };
+        TEST_NODE root = { NULL, NULL, 1, NULL };
+        size_t calls_that_cannot_fail[] =
+        {
+            5, /*STRING_c_str*/
+            9, /*STRING_delete*/
+        };
+        size_t i;
+        value.type = EDM_INT32_TYPE;
+        value.value.edmInt32.value = 100;
+        leaf.value = &value;
+        root.children = &leaf;
+
+        (void)umock_c_negative_tests_init();
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(TEST_TREE(&root), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(MultiTree_GetChild(TEST_TREE(&root), 0, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_empty(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetName(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_GetValue(TEST_TREE(&leaf), IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(BUFFER_create(IGNORED_PTR_ARG, 15));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+        umock_c_negative_tests_snapshot();
+
+        for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+        {
+            size_t j;
+            bool canFail = true;
+            for (j = 0; j < sizeof(calls_that_cannot_fail) / sizeof(calls_that_cannot_fail[0]); j++)
+            {
+                if (calls_that_cannot_fail[j] == i)
+                {
+                    canFail = false;
+                    break;
+                }
+            }
+
+            if (canFail)
+            {
+                BUFFER_HANDLE result;
+                char temp_str[128];
+
+                umock_c_negative_tests_reset();
+                umock_c_negative_tests_fail_call(i);
+
+                ///act
+                result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+                ///assert
+                (void)sprintf(temp_str, "On failed call %zu", i);
+                ASSERT_IS_NULL_WITH_MSG(result, temp_str);
+            }
+        }
+
+        ///cleanup
+        umock_c_negative_tests_deinit();
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_004: [ A node that has children shall be written as a map holding, for every child in order, the child's name as a text string followed by the child's encoding. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_nested_nodes_produces_nested_maps)
+    {
+        ///arrange
+        AGENT_DATA_TYPE first;
+        AGENT_DATA_TYPE second;
+        TEST_NODE innerLeaves[2] = { { "x", NULL, 0, NULL }, { "y", NULL, 0, NULL } };
+        TEST_NODE children[2] = { { "b", NULL, 0, NULL }, { "Inner", NULL, 2, NULL } };
+        TEST_NODE root = { NULL, NULL, 2, NULL };
+        BUFFER_HANDLE result;
+        first.type = EDM_BOOLEAN_TYPE;
+        first.value.edmBoolean.value = EDM_TRUE;
+        second.type = EDM_BOOLEAN_TYPE;
+        second.value.edmBoolean.value = EDM_FALSE;
+        children[0].value = &first;
+        innerLeaves[0].value = &second;
+        innerLeaves[1].value = &first;
+        children[1].children = innerLeaves;
+        root.children = children;
+
+        ///act
+        result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+        ///assert
+        assert_buffer_is(result, (const unsigned char*)"\xA2\x61" "b" "\xF5\x65" "Inner" "\xA2\x61" "x" "\xF4\x61" "y" "\xF5", 17);
+
+        ///cleanup
+        real_BUFFER_delete(result);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_005: [ When dataType is DATA_SERIALIZER_TYPE_CHAR_PTR the value of a leaf shall be written as a text string. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_with_CHAR_PTR_leaves_writes_text_strings)
+    {
+        ///arrange
+        TEST_NODE leaf = { "a", "\"hi\"", 0, NULL };
+        TEST_NODE root = { NULL, NULL, 1, NULL };
+        BUFFER_HANDLE result;
+        root.children = &leaf;
+
+        ///act
+        result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_CHAR_PTR);
+
+        ///assert
+        assert_buffer_is(result, (const unsigned char*)"\xA1\x61" "a" "\x64\"hi\"", 8);
+
+        ///cleanup
+        real_BUFFER_delete(result);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_006: [ Every data item shall start with the shortest head able to hold its argument (lengths, counts, integers and tags). ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_009: [ EDM_BYTE, EDM_SBYTE, EDM_INT16, EDM_INT32 and EDM_INT64 shall be written as an unsigned integer when positive or as a negative integer otherwise. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_integers_with_the_shortest_head)
+    {
+        AGENT_DATA_TYPE value;
+
+        value.type = EDM_BYTE_TYPE;
+        value.value.edmByte.value = 23;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x17", 1);
+
+        value.type = EDM_SBYTE_TYPE;
+        value.value.edmSbyte.value = -1;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x20", 1);
+
+        value.type = EDM_INT16_TYPE;
+        value.value.edmInt16.value = 24;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x18\x18", 2);
+
+        value.type = EDM_INT32_TYPE;
+        value.value.edmInt32.value = -500;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x39\x01\xF3", 3);
+
+        value.type = EDM_INT32_TYPE;
+        value.value.edmInt32.value = 100000;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x1A\x00\x01\x86\xA0", 5);
+
+        value.type = EDM_INT64_TYPE;
+        value.value.edmInt64.value = 4294967296;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x1B\x00\x00\x00\x01\x00\x00\x00\x00", 9);
+
+        value.type = EDM_INT64_TYPE;
+        value.value.edmInt64.value = INT64_MIN;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 9);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_008: [ EDM_BOOLEAN shall be written as the simple value true or false. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_016: [ EDM_NULL shall be written as the simple value null. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_booleans_and_null_as_simple_values)
+    {
+        AGENT_DATA_TYPE value;
+
+        value.type = EDM_BOOLEAN_TYPE;
+        value.value.edmBoolean.value = EDM_TRUE;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xF5", 1);
+
+        value.type = EDM_BOOLEAN_TYPE;
+        value.value.edmBoolean.value = EDM_FALSE;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xF4", 1);
+
+        value.type = EDM_NULL_TYPE;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xF6", 1);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_010: [ EDM_SINGLE shall be written as a single precision float. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_011: [ An EDM_DOUBLE that can be converted to float and back without loss shall be written as a single precision float. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_012: [ Any other EDM_DOUBLE shall be written as a double precision float. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_floats)
+    {
+        AGENT_DATA_TYPE value;
+
+        value.type = EDM_SINGLE_TYPE;
+        value.value.edmSingle.value = 1.5f;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xFA\x3F\xC0\x00\x00", 5);
+
+        value.type = EDM_DOUBLE_TYPE;
+        value.value.edmDouble.value = 21.5;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xFA\x41\xAC\x00\x00", 5);
+
+        value.type = EDM_DOUBLE_TYPE;
+        value.value.edmDouble.value = 0.1;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xFB\x3F\xB9\x99\x99\x99\x99\x99\x9A", 9);
+
+        value.type = EDM_DOUBLE_TYPE;
+        value.value.edmDouble.value = 1e300;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C", 9);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_013: [ EDM_STRING and EDM_STRING_NO_QUOTES shall be written as a text string holding their characters, unescaped. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_strings_unescaped)
+    {
+        AGENT_DATA_TYPE value;
+        char longString[301];
+        unsigned char expected[303];
+
+        value.type = EDM_STRING_TYPE;
+        value.value.edmString.chars = (char*)"a\"b";
+        value.value.edmString.length = 3;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x63" "a\"b", 4);
+
+        value.type = EDM_STRING_NO_QUOTES_TYPE;
+        value.value.edmStringNoQuotes.chars = (char*)"{}";
+        value.value.edmStringNoQuotes.length = 2;
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x62{}", 3);
+
+        (void)memset(longString, 'x', 300);
+        longString[300] = '\0';
+        expected[0] = 0x79;
+        expected[1] = 0x01;
+        expected[2] = 0x2C;
+        (void)memset(expected + 3, 'x', 300);
+        value.type = EDM_STRING_TYPE;
+        value.value.edmString.chars = longString;
+        value.value.edmString.length = 300;
+        assert_value_is_encoded_as(&value, expected, sizeof(expected));
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_014: [ EDM_BINARY shall be written as a byte string. ]*/
+    /*Tests_SRS_CBOR_ENCODER_99_015: [ EDM_GUID shall be written as a 16 bytes byte string tagged 37. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_binary_and_guid_as_byte_strings)
+    {
+        AGENT_DATA_TYPE value;
+        unsigned char bytes[3] = { 1, 2, 3 };
+        size_t i;
+
+        value.type = EDM_BINARY_TYPE;
+        value.value.edmBinary.data = bytes;
+        value.value.edmBinary.size = sizeof(bytes);
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x43\x01\x02\x03", 4);
+
+        value.type = EDM_GUID_TYPE;
+        for (i = 0; i < 16; i++)
+        {
+            value.value.edmGuid.GUID[i] = (uint8_t)i;
+        }
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xD8\x25\x50\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F", 19);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_017: [ EDM_DATE_TIME_OFFSET shall be written as its RFC 3339 text tagged 0 and EDM_DATE as its full-date text tagged 1004. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_dates_as_tagged_text)
+    {
+        AGENT_DATA_TYPE value;
+
+        value.type = EDM_DATE_TIME_OFFSET_TYPE;
+        toStringOutput = "\"2017-02-02T03:04:05Z\"";
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xC0\x74" "2017-02-02T03:04:05Z", 22);
+
+        value.type = EDM_DATE_TYPE;
+        toStringOutput = "\"2017-03-04\"";
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xD9\x03\xEC\x6A" "2017-03-04", 14);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_019: [ Any other AGENT_DATA_TYPE shall be written as a text string holding the text produced by AgentDataTypes_ToString, without surrounding quotes. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_other_types_as_their_text)
+    {
+        AGENT_DATA_TYPE value;
+
+        value.type = EDM_DECIMAL_TYPE;
+        toStringOutput = "12.5";
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\x64" "12.5", 5);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_020: [ If any failure occurs, CBOREncoder_EncodeTree shall fail and return NULL. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_when_AgentDataTypes_ToString_fails_fails)
+    {
+        ///arrange
+        AGENT_DATA_TYPE value;
+        TEST_NODE leaf = { "a", NULL, 0, NULL };
+        TEST_NODE root = { NULL, NULL, 1, NULL };
+        BUFFER_HANDLE result;
+        value.type = EDM_DECIMAL_TYPE;
+        leaf.value = &value;
+        root.children = &leaf;
+
+        toStringResult = AGENT_DATA_TYPES_ERROR;
+
+        ///act
+        result = CBOREncoder_EncodeTree(TEST_TREE(&root), DATA_SERIALIZER_TYPE_AGENT_DATA);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+    }
+
+    /*Tests_SRS_CBOR_ENCODER_99_018: [ EDM_COMPLEX_TYPE shall be written as a map from field names to the encoded field values. ]*/
+    TEST_FUNCTION(CBOREncoder_EncodeTree_writes_complex_types_as_maps)
+    {
+        AGENT_DATA_TYPE value;
+        AGENT_DATA_TYPE fieldValues[2];
+        COMPLEX_TYPE_FIELD_TYPE fields[2];
+
+        fieldValues[0].type = EDM_INT32_TYPE;
+        fieldValues[0].value.edmInt32.value = 1;
+        fieldValues[1].type = EDM_BOOLEAN_TYPE;
+        fieldValues[1].value.edmBoolean.value = EDM_TRUE;
+        fields[0].fieldName = "x";
+        fields[0].value = &fieldValues[0];
+        fields[1].fieldName = "on";
+        fields[1].value = &fieldValues[1];
+        value.type = EDM_COMPLEX_TYPE_TYPE;
+        value.value.edmComplexType.nMembers = 2;
+        value.value.edmComplexType.fields = fields;
+
+        assert_value_is_encoded_as(&value, (const unsigned char*)"\xA2\x61" "x" "\x01\x62" "on" "\xF5", 8);
+    }
+
+END_TEST_SUITE(cborencoder_ut)
@@ -57,6 +57,7 @@ MOCKABLE_FUNCTION(, void, onDesiredPropertyModelInModel, void*, v);
 MOCKABLE_FUNCTION(, EXECUTE_COMMAND_RESULT, ActionCallbackMock, void*, actionCallbackContext, const char*, relativeActionPath, const char*, actionName, size_t, parameterCount, const AGENT_DATA_TYPE*, parameterValues);
 MOCKABLE_FUNCTION(, METHODRETURN_HANDLE, methodCallbackMock, void*, methodCallbackContext, const char*, relativeMethodPath, const char*, mthodName, size_t, parameterCount, const AGENT_DATA_TYPE*, parameterValues);
 MOCKABLE_FUNCTION(, int, int_pfDesiredPropertyFromAGENT_DATA_TYPE, const AGENT_DATA_TYPE*, source, void*, dest);
+MOCKABLE_FUNCTION(, int, int_pfDesiredPropertyToAGENT_DATA_TYPE, const void*, source, AGENT_DATA_TYPE*, dest);
 #undef ENABLE_MOCKS
 
 #include "azure_c_shared_utility/lock.h"
@@ -137,6 +138,8 @@ DEFINE_ENUM_STRINGS(SCHEMA_ELEMENT_TYPE, SCHEMA_ELEMENT_TYPE_VALUES);
 #define TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD (SCHEMA_DESIRED_PROPERTY_HANDLE)0x4
 #define TEST_SCHEMA (SCHEMA_HANDLE)0x5
 #define SCHEMA_MODEL_TYPE_HANDLE_MODEL_IN_MODEL (SCHEMA_MODEL_TYPE_HANDLE)0x6
+#define TEST_STRING_HANDLE_VALUE_1 (STRING_HANDLE)0x7
+#define TEST_STRING_HANDLE_VALUE_2 (STRING_HANDLE)0x8
 
 static const SCHEMA_MODEL_TYPE_HANDLE TEST_MODEL_HANDLE = (SCHEMA_MODEL_TYPE_HANDLE)0x4301;
 static void* TEST_CALLBACK_CONTEXT_VALUE = (void*)0x4242;
@@ -381,6 +384,7 @@ BEGIN_TEST_SUITE(CommandDecoder_ut)
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(CreateAgentDataType_From_String, AGENT_DATA_TYPES_ERROR);
         
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(int_pfDesiredPropertyFromAGENT_DATA_TYPE, __FAILURE__);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(int_pfDesiredPropertyToAGENT_DATA_TYPE, __FAILURE__);
         
         
     }
@@ -3447,6 +3451,418 @@ BEGIN_TEST_SUITE(CommandDecoder_ut)
 
     }
     
+    /*Tests_SRS_COMMAND_DECODER_99_064: [ CommandDecoder_IngestDesiredPropertiesChanges shall behave as CommandDecoder_IngestDesiredProperties for the desired properties whose value changed. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_with_NULL_handle_fails)
+    {
+        ///arrange
+        char deviceMemoryArea[100];
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, NULL, "some properties", false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_ERROR, result);
+
+        ///clean
+    }
+
+    /*the device memory holds currentValue in "int_field", currentValue is NULL when it cannot be converted to AGENT_DATA_TYPE*/
+    void CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_desired_property_inert_path(unsigned char* deviceMemoryArea, const char* desiredPropertiesJSON, const char* three, size_t one, MULTITREE_HANDLE childHandle, const char* currentValue)
+    {
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, desiredPropertiesJSON))
+            .IgnoreArgument_destination();
+
+        STRICT_EXPECTED_CALL(JSONDecoder_JSON_To_MultiTree(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_json()
+            .IgnoreArgument_multiTreeHandle();
+
+        STRICT_EXPECTED_CALL(MultiTree_DeleteChild(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .IgnoreArgument_childName();
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .CopyOutArgumentBuffer_count(&one, sizeof(one));
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChild(IGNORED_PTR_ARG, 0, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .CopyOutArgumentBuffer_childHandle(&childHandle, sizeof(childHandle));
+
+        STRICT_EXPECTED_CALL(STRING_new())
+            .SetReturn(TEST_STRING_HANDLE_CHILD_NAME);
+
+        STRICT_EXPECTED_CALL(MultiTree_GetName(childHandle, TEST_STRING_HANDLE_CHILD_NAME));
+
+        STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_CHILD_NAME))
+            .SetReturn("int_field");
+
+        STRICT_EXPECTED_CALL(Schema_GetModelElementByName(TEST_MODEL_HANDLE, "int_field"))
+            .SetReturn(Schema_GetModelElementByName_desiredProperty_int_field);
+
+        STRICT_EXPECTED_CALL(Schema_GetModelDesiredPropertyType(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+            .SetReturn("int");
+
+        STRICT_EXPECTED_CALL(Schema_GetSchemaForModelType(TEST_MODEL_HANDLE))
+            .SetReturn(TEST_SCHEMA);
+
+        STRICT_EXPECTED_CALL(CodeFirst_GetPrimitiveType("int"))
+            .SetReturn(EDM_INT32_TYPE);
+
+        STRICT_EXPECTED_CALL(MultiTree_GetValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .CopyOutArgumentBuffer_destination(&three, sizeof(three));
+
+        STRICT_EXPECTED_CALL(CreateAgentDataType_From_String(IGNORED_PTR_ARG, EDM_INT32_TYPE, IGNORED_PTR_ARG))
+            .IgnoreArgument_source()
+            .IgnoreArgument_agentData()
+            .SetReturn(AGENT_DATA_TYPES_OK);
+
+        /*this is the comparison with the value in the device memory*/
+        STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_offset(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+            .SetReturn(2);
+
+        STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+            .SetReturn(int_pfDesiredPropertyToAGENT_DATA_TYPE);
+
+        STRICT_EXPECTED_CALL(int_pfDesiredPropertyToAGENT_DATA_TYPE((unsigned char*)deviceMemoryArea + 2, IGNORED_PTR_ARG))
+            .IgnoreArgument_dest()
+            .SetReturn(currentValue == NULL ? __FAILURE__ : 0);
+
+        if (currentValue != NULL)
+        {
+            STRICT_EXPECTED_CALL(STRING_new())
+                .SetReturn(TEST_STRING_HANDLE_VALUE_1);
+            STRICT_EXPECTED_CALL(STRING_new())
+                .SetReturn(TEST_STRING_HANDLE_VALUE_2);
+
+            STRICT_EXPECTED_CALL(AgentDataTypes_ToString(TEST_STRING_HANDLE_VALUE_1, IGNORED_PTR_ARG))
+                .IgnoreArgument_value()
+                .SetReturn(AGENT_DATA_TYPES_OK);
+            STRICT_EXPECTED_CALL(AgentDataTypes_ToString(TEST_STRING_HANDLE_VALUE_2, IGNORED_PTR_ARG))
+                .IgnoreArgument_value()
+                .SetReturn(AGENT_DATA_TYPES_OK);
+
+            STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_VALUE_1))
+                .SetReturn(currentValue);
+            STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_VALUE_2))
+                .SetReturn(three);
+
+            STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_VALUE_2));
+            STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_VALUE_1));
+            STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG))
+                .IgnoreArgument_agentData();
+        }
+
+        if ((currentValue == NULL) || (strcmp(currentValue, three) != 0))
+        {
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfDesiredPropertyFromAGENT_DATA_TYPE(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                .SetReturn(int_pfDesiredPropertyFromAGENT_DATA_TYPE);
+
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_offset(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                .SetReturn(2);
+
+            STRICT_EXPECTED_CALL(int_pfDesiredPropertyFromAGENT_DATA_TYPE(IGNORED_PTR_ARG, (unsigned char*)deviceMemoryArea + 2))
+                .IgnoreArgument_source();
+
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfOnDesiredProperty(IGNORED_PTR_ARG))
+                .IgnoreArgument_desiredPropertyHandle()
+                .SetReturn(onDesiredPropertySimpleProperty);
+
+            STRICT_EXPECTED_CALL(onDesiredPropertySimpleProperty(IGNORED_PTR_ARG))
+                .IgnoreArgument_v();
+        }
+
+        STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG))
+            .IgnoreArgument_agentData();
+
+        STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_CHILD_NAME));
+
+        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+    }
+
+    /*"modelInModel" has a pfOnDesiredProperty, the device memory holds currentValue in its "int_field"*/
+    void CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_model_in_model_desired_property_inert_path(unsigned char* deviceMemoryArea, const char* desiredPropertiesJSON, const char* three, size_t one, MULTITREE_HANDLE childHandle, const char* currentValue)
+    {
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, desiredPropertiesJSON))
+            .IgnoreArgument_destination();
+
+        STRICT_EXPECTED_CALL(JSONDecoder_JSON_To_MultiTree(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_json()
+            .IgnoreArgument_multiTreeHandle();
+
+        STRICT_EXPECTED_CALL(MultiTree_DeleteChild(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .IgnoreArgument_childName();
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChildCount(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .CopyOutArgumentBuffer_count(&one, sizeof(one));
+
+        STRICT_EXPECTED_CALL(MultiTree_GetChild(IGNORED_PTR_ARG, 0, IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle()
+            .CopyOutArgumentBuffer_childHandle(&childHandle, sizeof(childHandle));
+
+        STRICT_EXPECTED_CALL(STRING_new())
+            .SetReturn(TEST_STRING_HANDLE_CHILD_NAME);
+
+        STRICT_EXPECTED_CALL(MultiTree_GetName(childHandle, TEST_STRING_HANDLE_CHILD_NAME)); /*this fills in TEST_STRING_HANDLE_CHILD_NAME with "modelInModel"*/
+
+        STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_CHILD_NAME))
+            .SetReturn("modelInModel");
+
+        STRICT_EXPECTED_CALL(Schema_GetModelElementByName(TEST_MODEL_HANDLE, "modelInModel"))
+            .SetReturn(Schema_GetModelElementByName_modelInModel);
+
+        STRICT_EXPECTED_CALL(Schema_GetModelModelByName_Offset(TEST_MODEL_HANDLE, "modelInModel"))
+            .SetReturn(10);
+
+        /*here recursion happens*/
+
+        {
+            STRICT_EXPECTED_CALL(MultiTree_GetChildCount(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument_treeHandle()
+                .CopyOutArgumentBuffer_count(&one, sizeof(one));
+
+            STRICT_EXPECTED_CALL(MultiTree_GetChild(IGNORED_PTR_ARG, 0, IGNORED_PTR_ARG))
+                .IgnoreArgument_treeHandle()
+                .CopyOutArgumentBuffer_childHandle(&childHandle, sizeof(childHandle));
+
+            STRICT_EXPECTED_CALL(STRING_new())
+                .SetReturn(TEST_STRING_HANDLE_CHILD_NAME);
+
+            STRICT_EXPECTED_CALL(MultiTree_GetName(childHandle, TEST_STRING_HANDLE_CHILD_NAME)); /*this fills in TEST_STRING_HANDLE_CHILD_NAME with "int_field"*/
+
+            STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_CHILD_NAME))
+                .SetReturn("int_field");
+
+            STRICT_EXPECTED_CALL(Schema_GetModelElementByName(SCHEMA_MODEL_TYPE_HANDLE_MODEL_IN_MODEL, "int_field"))
+                .SetReturn(Schema_GetModelElementByName_desiredProperty_int_field);
+
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredPropertyType(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                .SetReturn("int");
+
+            STRICT_EXPECTED_CALL(Schema_GetSchemaForModelType(SCHEMA_MODEL_TYPE_HANDLE_MODEL_IN_MODEL))
+                .SetReturn(TEST_SCHEMA);
+
+            STRICT_EXPECTED_CALL(CodeFirst_GetPrimitiveType("int"))
+                .SetReturn(EDM_INT32_TYPE);
+
+            STRICT_EXPECTED_CALL(MultiTree_GetValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+                .IgnoreArgument_treeHandle()
+                .CopyOutArgumentBuffer_destination(&three, sizeof(three));
+
+            STRICT_EXPECTED_CALL(CreateAgentDataType_From_String(IGNORED_PTR_ARG, EDM_INT32_TYPE, IGNORED_PTR_ARG))
+                .IgnoreArgument_source()
+                .IgnoreArgument_agentData()
+                .SetReturn(AGENT_DATA_TYPES_OK);
+
+            /*this is the comparison with the value in the device memory*/
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_offset(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                .SetReturn(2);
+
+            STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                .SetReturn(int_pfDesiredPropertyToAGENT_DATA_TYPE);
+
+            STRICT_EXPECTED_CALL(int_pfDesiredPropertyToAGENT_DATA_TYPE((unsigned char*)deviceMemoryArea + 12, IGNORED_PTR_ARG))  /*notice here the new offset (2+10)*/
+                .IgnoreArgument_dest()
+                .SetReturn(currentValue == NULL ? __FAILURE__ : 0);
+
+            if (currentValue != NULL)
+            {
+                STRICT_EXPECTED_CALL(STRING_new())
+                    .SetReturn(TEST_STRING_HANDLE_VALUE_1);
+                STRICT_EXPECTED_CALL(STRING_new())
+                    .SetReturn(TEST_STRING_HANDLE_VALUE_2);
+
+                STRICT_EXPECTED_CALL(AgentDataTypes_ToString(TEST_STRING_HANDLE_VALUE_1, IGNORED_PTR_ARG))
+                    .IgnoreArgument_value()
+                    .SetReturn(AGENT_DATA_TYPES_OK);
+                STRICT_EXPECTED_CALL(AgentDataTypes_ToString(TEST_STRING_HANDLE_VALUE_2, IGNORED_PTR_ARG))
+                    .IgnoreArgument_value()
+                    .SetReturn(AGENT_DATA_TYPES_OK);
+
+                STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_VALUE_1))
+                    .SetReturn(currentValue);
+                STRICT_EXPECTED_CALL(STRING_c_str(TEST_STRING_HANDLE_VALUE_2))
+                    .SetReturn(three);
+
+                STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_VALUE_2));
+                STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_VALUE_1));
+                STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG))
+                    .IgnoreArgument_agentData();
+            }
+
+            if ((currentValue == NULL) || (strcmp(currentValue, three) != 0))
+            {
+                STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfDesiredPropertyFromAGENT_DATA_TYPE(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                    .SetReturn(int_pfDesiredPropertyFromAGENT_DATA_TYPE);
+
+                STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_offset(TEST_DESIRED_PROPERTY_HANDLE_INT_FIELD))
+                    .SetReturn(2);
+
+                STRICT_EXPECTED_CALL(int_pfDesiredPropertyFromAGENT_DATA_TYPE(IGNORED_PTR_ARG, (unsigned char*)deviceMemoryArea + 12))
+                    .IgnoreArgument_source();
+
+                STRICT_EXPECTED_CALL(Schema_GetModelDesiredProperty_pfOnDesiredProperty(IGNORED_PTR_ARG))
+                    .IgnoreArgument_desiredPropertyHandle()
+                    .SetReturn(NULL);
+            }
+
+            STRICT_EXPECTED_CALL(Destroy_AGENT_DATA_TYPE(IGNORED_PTR_ARG))
+                .IgnoreArgument_agentData();
+
+            STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_CHILD_NAME));
+        }
+
+        if ((currentValue == NULL) || (strcmp(currentValue, three) != 0))
+        {
+            STRICT_EXPECTED_CALL(Schema_GetModelModelByName_OnDesiredProperty(IGNORED_PTR_ARG, "modelInModel"))
+                .IgnoreArgument_modelTypeHandle()
+                .SetReturn(onDesiredPropertyModelInModel);
+
+            STRICT_EXPECTED_CALL(onDesiredPropertyModelInModel(IGNORED_PTR_ARG))
+                .IgnoreArgument_v();
+        }
+
+        STRICT_EXPECTED_CALL(STRING_delete(TEST_STRING_HANDLE_CHILD_NAME));
+
+        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG))
+            .IgnoreArgument_treeHandle();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+    }
+
+    /*Tests_SRS_COMMAND_DECODER_99_060: [ CommandDecoder_IngestDesiredPropertiesChanges shall read the current value of a desired property out of the device memory by calling its pfDesiredPropertyToAGENT_DATA_TYPE, convert both the current and the new value to strings by calling AgentDataTypes_ToString and compare them. ]*/
+    /*Tests_SRS_COMMAND_DECODER_99_064: [ CommandDecoder_IngestDesiredPropertiesChanges shall behave as CommandDecoder_IngestDesiredProperties for the desired properties whose value changed. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_with_1_changed_desired_property_writes_it)
+    {
+        ///arrange
+        COMMAND_DECODER_HANDLE commandDecoderHandle = CommandDecoder_Create(TEST_MODEL_HANDLE, ActionCallbackMock, TEST_CALLBACK_CONTEXT_VALUE, methodCallbackMock, TEST_CALLBACK_CONTEXT_VALUE);
+        umock_c_reset_all_calls();
+        unsigned char deviceMemoryArea[100];
+        const char* desiredPropertiesJSON = "{\"int_field\":3}";
+        const char* three = "3";
+        size_t one = 1;
+        MULTITREE_HANDLE childHandle = (MULTITREE_HANDLE)0x11;
+
+        CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_desired_property_inert_path(deviceMemoryArea, desiredPropertiesJSON, three, one, childHandle, "2");
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, commandDecoderHandle, desiredPropertiesJSON, false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_SUCCESS, result);
+
+        ///clean
+        CommandDecoder_Destroy(commandDecoderHandle);
+    }
+
+    /*Tests_SRS_COMMAND_DECODER_99_061: [ If the value is the same, CommandDecoder_IngestDesiredPropertiesChanges shall neither write the desired property nor call its pfOnDesiredProperty. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_with_1_unchanged_desired_property_does_not_write_it)
+    {
+        ///arrange
+        COMMAND_DECODER_HANDLE commandDecoderHandle = CommandDecoder_Create(TEST_MODEL_HANDLE, ActionCallbackMock, TEST_CALLBACK_CONTEXT_VALUE, methodCallbackMock, TEST_CALLBACK_CONTEXT_VALUE);
+        umock_c_reset_all_calls();
+        unsigned char deviceMemoryArea[100];
+        const char* desiredPropertiesJSON = "{\"int_field\":3}";
+        const char* three = "3";
+        size_t one = 1;
+        MULTITREE_HANDLE childHandle = (MULTITREE_HANDLE)0x11;
+
+        CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_desired_property_inert_path(deviceMemoryArea, desiredPropertiesJSON, three, one, childHandle, "3");
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, commandDecoderHandle, desiredPropertiesJSON, false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_SUCCESS, result);
+
+        ///clean
+        CommandDecoder_Destroy(commandDecoderHandle);
+    }
+
+    /*Tests_SRS_COMMAND_DECODER_99_063: [ If either value cannot be converted, the desired property shall be treated as changed. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_when_the_current_value_cannot_be_converted_writes_the_desired_property)
+    {
+        ///arrange
+        COMMAND_DECODER_HANDLE commandDecoderHandle = CommandDecoder_Create(TEST_MODEL_HANDLE, ActionCallbackMock, TEST_CALLBACK_CONTEXT_VALUE, methodCallbackMock, TEST_CALLBACK_CONTEXT_VALUE);
+        umock_c_reset_all_calls();
+        unsigned char deviceMemoryArea[100];
+        const char* desiredPropertiesJSON = "{\"int_field\":3}";
+        const char* three = "3";
+        size_t one = 1;
+        MULTITREE_HANDLE childHandle = (MULTITREE_HANDLE)0x11;
+
+        CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_desired_property_inert_path(deviceMemoryArea, desiredPropertiesJSON, three, one, childHandle, NULL);
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, commandDecoderHandle, desiredPropertiesJSON, false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_SUCCESS, result);
+
+        ///clean
+        CommandDecoder_Destroy(commandDecoderHandle);
+    }
+
+    /*Tests_SRS_COMMAND_DECODER_99_062: [ CommandDecoder_IngestDesiredPropertiesChanges shall call the pfOnDesiredProperty of a model in model only if at least one of its desired properties changed. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_with_changed_model_in_model_calls_its_pfOnDesiredProperty)
+    {
+        ///arrange
+        COMMAND_DECODER_HANDLE commandDecoderHandle = CommandDecoder_Create(TEST_MODEL_HANDLE, ActionCallbackMock, TEST_CALLBACK_CONTEXT_VALUE, methodCallbackMock, TEST_CALLBACK_CONTEXT_VALUE);
+        umock_c_reset_all_calls();
+        unsigned char deviceMemoryArea[100];
+        const char* desiredPropertiesJSON = "{\"modelInModel\":{\"int_field\":3}}";
+        const char* three = "3";
+        size_t one = 1;
+        MULTITREE_HANDLE childHandle = (MULTITREE_HANDLE)0x11;
+
+        CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_model_in_model_desired_property_inert_path(deviceMemoryArea, desiredPropertiesJSON, three, one, childHandle, "2");
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, commandDecoderHandle, desiredPropertiesJSON, false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_SUCCESS, result);
+
+        ///clean
+        CommandDecoder_Destroy(commandDecoderHandle);
+    }
+
+    /*Tests_SRS_COMMAND_DECODER_99_062: [ CommandDecoder_IngestDesiredPropertiesChanges shall call the pfOnDesiredProperty of a model in model only if at least one of its desired properties changed. ]*/
+    TEST_FUNCTION(CommandDecoder_IngestDesiredPropertiesChanges_with_unchanged_model_in_model_does_not_call_its_pfOnDesiredProperty)
+    {
+        ///arrange
+        COMMAND_DECODER_HANDLE commandDecoderHandle = CommandDecoder_Create(TEST_MODEL_HANDLE, ActionCallbackMock, TEST_CALLBACK_CONTEXT_VALUE, methodCallbackMock, TEST_CALLBACK_CONTEXT_VALUE);
+        umock_c_reset_all_calls();
+        unsigned char deviceMemoryArea[100];
+        const char* desiredPropertiesJSON = "{\"modelInModel\":{\"int_field\":3}}";
+        const char* three = "3";
+        size_t one = 1;
+        MULTITREE_HANDLE childHandle = (MULTITREE_HANDLE)0x11;
+
+        CommandDecoder_IngestDesiredPropertiesChanges_with_1_simple_model_in_model_desired_property_inert_path(deviceMemoryArea, desiredPropertiesJSON, three, one, childHandle, "3");
+
+        ///act
+        EXECUTE_COMMAND_RESULT result = CommandDecoder_IngestDesiredPropertiesChanges(deviceMemoryArea, commandDecoderHandle, desiredPropertiesJSON, false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(EXECUTE_COMMAND_RESULT, EXECUTE_COMMAND_SUCCESS, result);
+
+        ///clean
+        CommandDecoder_Destroy(commandDecoderHandle);
+    }
+
     /*Tests_SRS_COMMAND_DECODER_02_014: [ If handle is NULL then CommandDecoder_ExecuteMethod shall fail and return NULL. ]*/
     TEST_FUNCTION(CommandDecoder_ExecuteMethod_with_NULL_handle_fails)
     {
@@ -163,6 +163,25 @@ static AGENT_DATA_TYPES_RESULT my_AgentDataTypes_ToString(STRING_HANDLE destinat
     return AGENT_DATA_TYPES_OK;
 }
 
+/*writes name:value pairs separated by , so that tests can check which members were produced*/
+static JSON_ENCODER_RESULT my_JSONEncoder_EncodeObject(const void* members, size_t memberCount, JSON_ENCODER_GET_MEMBER_FUNC getMember, STRING_HANDLE destination, JSON_ENCODER_TOSTRING_FUNC toStringFunc)
+{
+    size_t i;
+    (void)real_STRING_concat(destination, "{");
+    for (i = 0; i < memberCount; i++)
+    {
+        const char* name;
+        const void* value;
+        getMember(members, i, &name, &value);
+        (void)real_STRING_concat(destination, (i == 0) ? "" : ",");
+        (void)real_STRING_concat(destination, name);
+        (void)real_STRING_concat(destination, ":");
+        (void)toStringFunc(destination, value);
+    }
+    (void)real_STRING_concat(destination, "}");
+    return JSON_ENCODER_OK;
+}
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     char temp_str[256];
@@ -200,6 +219,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         REGISTER_UMOCK_ALIAS_TYPE(MULTITREE_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(JSON_ENCODER_TOSTRING_FUNC, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(JSON_ENCODER_GET_MEMBER_FUNC, void*);
         REGISTER_UMOCK_ALIAS_TYPE(VECTOR_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(const VECTOR_HANDLE, void*);
         
@@ -213,6 +233,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         REGISTER_STRING_GLOBAL_MOCK_HOOK;
 
         REGISTER_GLOBAL_MOCK_HOOK(AgentDataTypes_ToString, my_AgentDataTypes_ToString);
+        REGISTER_GLOBAL_MOCK_HOOK(JSONEncoder_EncodeObject, my_JSONEncoder_EncodeObject);
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(AgentDataTypes_ToString, AGENT_DATA_TYPES_ERROR);
 
         REGISTER_GLOBAL_MOCK_HOOK(VECTOR_create, real_VECTOR_create);
@@ -559,7 +580,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         size_t destinationSize;
         umock_c_reset_all_calls();
 
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &floatValid };
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid };
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
             .SetReturn((MULTITREE_HANDLE)NULL);
@@ -584,13 +605,13 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         size_t destinationSize;
         umock_c_reset_all_calls();
 
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &floatValid };
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid };
 
         STRICT_EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
             .IgnoreArgument_cloneFunction()
             .IgnoreArgument_freeFunction();
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle()
             .SetReturn(MULTITREE_ERROR);
 
@@ -619,7 +640,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         AGENT_DATA_TYPE floatValid2;
 
         DATA_MARSHALLER_VALUE values[2];
-        values[0].PropertyPath = DEFAULT_PROPERTY_NAME;
+        values[0].PropertyPath = DEFAULT_PROPERTY_NAME_LEVEL2;
         values[0].Value = &floatValid;
 
         values[1].PropertyPath = DEFAULT_PROPERTY_NAME_2;
@@ -627,7 +648,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_2, &floatValid2))
             .IgnoreArgument_treeHandle()
@@ -655,11 +676,11 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         umock_c_reset_all_calls();
         unsigned char* destination;
         size_t destinationSize;
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &floatValid };
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid };
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         STRICT_EXPECTED_CALL(STRING_new());
         EXPECTED_CALL(JSONEncoder_EncodeTree(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
@@ -695,12 +716,12 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &structTypeValue } };
+        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &structTypeValue } };
         char json_payload[] = "Test";
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_2, &structTypeValue))
             .IgnoreArgument_treeHandle();
@@ -746,12 +767,12 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &structTypeValue } };
+        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &structTypeValue } };
         char json_payload[] = "Test";
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_2, &structTypeValue))
             .IgnoreArgument_treeHandle();
@@ -794,12 +815,12 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &floatValid } };
+        DATA_MARSHALLER_VALUE value[] = { { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &floatValid } };
         char json_payload[] = "Test";
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_2, &floatValid))
             .IgnoreArgument_treeHandle();
@@ -842,12 +863,12 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &floatValid };
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid };
         char json_payload[] = "Test";
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         EXPECTED_CALL(STRING_new());
         EXPECTED_CALL(JSONEncoder_EncodeTree(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
@@ -881,7 +902,7 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
     }
 
     /* Tests_SRS_DATAMARSHALLER_01_001: [If the includePropertyPath argument passed to DataMarshaller_Create was false and only one struct is being sent, the relative path of the value passed to DataMarshaller_SendData - including property name - shall be ignored and the value shall be placed at JSON root.] */
-    /* Tests_SRS_DATAMARSHALLER_01_004: [In this case the members of the struct shall be added as leafs into the MultiTree, each leaf having the name of the struct member.] */
+    /* Tests_SRS_DATA_MARSHALLER_99_049: [ When the JSON object has no inner objects, DataMarshaller_SendData shall not build a MultiTree and shall have JSONEncoder_EncodeObject write the members straight into the payload. ]*/
     TEST_FUNCTION(when_includePropertyPath_is_false_and_one_struct_is_being_sent_the_property_name_is_not_placed_in_the_JSON_and_SendAsync_is_called)
     {
         ///arrange
@@ -890,65 +911,140 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         size_t destinationSize;
         umock_c_reset_all_calls();
         DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &structTypeValue2Members };
-        char json_payload[] = "Test";
 
-        EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(JSONEncoder_EncodeObject(structTypeValue2Members.value.edmComplexType.fields, 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &floatValid));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &intValid));
+        STRICT_EXPECTED_CALL(STRING_length(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, "x", structTypeValue2Members.value.edmComplexType.fields[0].value))
-            .IgnoreArgument_treeHandle();
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, "y", structTypeValue2Members.value.edmComplexType.fields[1].value))
-            .IgnoreArgument_treeHandle();
-        EXPECTED_CALL(STRING_new());
-        EXPECTED_CALL(JSONEncoder_EncodeTree(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
-            .IgnoreArgument_treeHandle()
-            .IgnoreArgument_destination()
-            .IgnoreArgument_toStringFunc();
+        ///act
+        DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 1, &value, &destination, &destinationSize);
 
-        EXPECTED_CALL(STRING_length(IGNORED_PTR_ARG))
-            .SetReturn(strlen(json_payload));
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(size_t, strlen("{x:2.4,y:2.4}"), destinationSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(destination, "{x:2.4,y:2.4}", destinationSize));
 
-        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
-            .IgnoreArgument_size();
+        ///cleanup
+        free(destination);
+        DataMarshaller_Destroy(handle);
+    }
 
-        EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
-            .SetReturn(json_payload);
-        EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
-        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG))
-            .IgnoreArgument_treeHandle();
+    /* Tests_SRS_DATA_MARSHALLER_99_027:[ DATA_MARSHALLER_JSON_ENCODER_ERROR shall be returned when JSONEncoder returns an error code.] */
+    TEST_FUNCTION(when_encoding_the_members_of_the_struct_fails_then_senddata_fails)
+    {
+        ///arrange
+        DATA_MARSHALLER_HANDLE handle = DataMarshaller_Create(TEST_MODEL_HANDLE, false);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &structTypeValue2Members };
+
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(JSONEncoder_EncodeObject(structTypeValue2Members.value.edmComplexType.fields, 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .SetReturn(JSON_ENCODER_TOSTRING_FUNCTION_ERROR);
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
 
         ///act
         DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 1, &value, &destination, &destinationSize);
 
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_JSON_ENCODER_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        DataMarshaller_Destroy(handle);
+    }
+
+    /* Tests_SRS_DATA_MARSHALLER_99_038:[For each pair in the values argument, a string : value pair shall exist in the JSON object in the form of propertyName : value.] */
+    /* Tests_SRS_DATA_MARSHALLER_99_049: [ When the JSON object has no inner objects, DataMarshaller_SendData shall not build a MultiTree and shall have JSONEncoder_EncodeObject write the members straight into the payload. ]*/
+    TEST_FUNCTION(DataMarshaller_SendData_with_property_names_only_does_not_build_a_MultiTree)
+    {
+        ///arrange
+        DATA_MARSHALLER_HANDLE handle = DataMarshaller_Create(TEST_MODEL_HANDLE, true);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+        DATA_MARSHALLER_VALUE values[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &intValid } };
+
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(JSONEncoder_EncodeObject(values, 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &floatValid));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &intValid));
+        STRICT_EXPECTED_CALL(STRING_length(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
+
+        ///act
+        DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 2, values, &destination, &destinationSize);
+
         ///assert
         ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_OK, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(size_t, strlen("{" DEFAULT_PROPERTY_NAME ":2.4," DEFAULT_PROPERTY_NAME_2 ":2.4}"), destinationSize);
+        ASSERT_ARE_EQUAL(int, 0, memcmp(destination, "{" DEFAULT_PROPERTY_NAME ":2.4," DEFAULT_PROPERTY_NAME_2 ":2.4}", destinationSize));
 
         ///cleanup
         free(destination);
         DataMarshaller_Destroy(handle);
     }
 
-    /* Tests_SRS_DATA_MARSHALLER_99_035:[DATA_MARSHALLER_MULTITREE_ERROR shall be returned in case any MultiTree API call fails.] */
-    TEST_FUNCTION(when_adding_the_first_member_of_the_struct_fails_then_senddata_fails)
+    /* Tests_SRS_DATAMARSHALLER_01_002: [If the includePropertyPath argument passed to DataMarshaller_Create was false and the number of values passed to SendData is greater than 1 and at least one of them is a struct, DataMarshaller_SendData shall fallback to  including the complete property path in the output JSON.] */
+    /* Tests_SRS_DATA_MARSHALLER_99_049: [ When the JSON object has no inner objects, DataMarshaller_SendData shall not build a MultiTree and shall have JSONEncoder_EncodeObject write the members straight into the payload. ]*/
+    TEST_FUNCTION(when_includepropertypath_is_false_and_a_struct_is_sent_with_other_properties_the_struct_is_encoded_by_its_property_name)
     {
         ///arrange
         DATA_MARSHALLER_HANDLE handle = DataMarshaller_Create(TEST_MODEL_HANDLE, false);
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &structTypeValue2Members };
+        DATA_MARSHALLER_VALUE values[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME_2, &structTypeValue2Members } };
 
-        EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(JSONEncoder_EncodeObject(values, 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &floatValid));
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, &structTypeValue2Members));
+        STRICT_EXPECTED_CALL(STRING_length(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, "x", structTypeValue2Members.value.edmComplexType.fields[0].value))
-            .IgnoreArgument_treeHandle()
-            .SetReturn(MULTITREE_ERROR);
+        ///act
+        DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 2, values, &destination, &destinationSize);
 
-        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG))
-            .IgnoreArgument_treeHandle();
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        free(destination);
+        DataMarshaller_Destroy(handle);
+    }
+
+    /* Tests_SRS_DATA_MARSHALLER_99_035:[DATA_MARSHALLER_MULTITREE_ERROR shall be returned in case any MultiTree API call fails.] */
+    TEST_FUNCTION(DataMarshaller_SendData_with_the_same_property_twice_uses_the_MultiTree_and_fails)
+    {
+        ///arrange
+        DATA_MARSHALLER_HANDLE handle = DataMarshaller_Create(TEST_MODEL_HANDLE, true);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+        DATA_MARSHALLER_VALUE values[] = { { DEFAULT_PROPERTY_NAME, &floatValid }, { DEFAULT_PROPERTY_NAME, &intValid } };
+
+        STRICT_EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid));
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &intValid))
+            .SetReturn(MULTITREE_ALREADY_HAS_A_VALUE);
+        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG));
 
         ///act
-        DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 1, &value, &destination, &destinationSize);
+        DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 2, values, &destination, &destinationSize);
 
         ///assert
         ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_MULTITREE_ERROR, result);
@@ -958,8 +1054,8 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         DataMarshaller_Destroy(handle);
     }
 
-    /* Tests_SRS_DATA_MARSHALLER_99_035:[DATA_MARSHALLER_MULTITREE_ERROR shall be returned in case any MultiTree API call fails.] */
-    TEST_FUNCTION(when_adding_the_second_member_of_the_struct_fails_then_senddata_fails)
+    /* Tests_SRS_DATA_MARSHALLER_99_015:[ DATA_MARSHALLER_ERROR shall be returned in all the other error cases not explicitly defined here.]*/
+    TEST_FUNCTION(when_STRING_new_fails_for_a_struct_SendData_Fails)
     {
         ///arrange
         DATA_MARSHALLER_HANDLE handle = DataMarshaller_Create(TEST_MODEL_HANDLE, false);
@@ -968,22 +1064,14 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         umock_c_reset_all_calls();
         DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &structTypeValue2Members };
 
-        EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, "x", structTypeValue2Members.value.edmComplexType.fields[0].value))
-            .IgnoreArgument_treeHandle();
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, "y", structTypeValue2Members.value.edmComplexType.fields[1].value))
-            .IgnoreArgument_treeHandle()
-            .SetReturn(MULTITREE_ERROR);
-
-        STRICT_EXPECTED_CALL(MultiTree_Destroy(IGNORED_PTR_ARG))
-            .IgnoreArgument_treeHandle();
+        STRICT_EXPECTED_CALL(STRING_new())
+            .SetReturn(NULL);
 
         ///act
         DATA_MARSHALLER_RESULT result = DataMarshaller_SendData(handle, 1, &value, &destination, &destinationSize);
 
         ///assert
-        ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_MULTITREE_ERROR, result);
+        ASSERT_ARE_EQUAL(DATA_MARSHALLER_RESULT, DATA_MARSHALLER_ERROR, result);
         ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
         ///cleanup
@@ -998,11 +1086,11 @@ BEGIN_TEST_SUITE(DataMarshaller_ut)
         unsigned char* destination;
         size_t destinationSize;
         umock_c_reset_all_calls();
-        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME, &floatValid };
+        DATA_MARSHALLER_VALUE value = { DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid };
 
         EXPECTED_CALL(MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME, &floatValid))
+        STRICT_EXPECTED_CALL(MultiTree_AddLeaf(IGNORED_PTR_ARG, DEFAULT_PROPERTY_NAME_LEVEL2, &floatValid))
             .IgnoreArgument_treeHandle();
         EXPECTED_CALL(STRING_new())
             .SetReturn(NULL);
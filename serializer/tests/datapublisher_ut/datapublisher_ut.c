@@ -144,6 +144,30 @@ static DATA_MARSHALLER_RESULT my_DataMarshaller_SendData(DATA_MARSHALLER_HANDLE
     return DATA_MARSHALLER_OK;
 }
 
+/*a STRING_HANDLE is a plain char buffer in these tests*/
+static STRING_HANDLE my_STRING_new(void)
+{
+    char* result = (char*)my_gballoc_malloc(32);
+    result[0] = '\0';
+    return (STRING_HANDLE)result;
+}
+
+static const char* my_STRING_c_str(STRING_HANDLE handle)
+{
+    return (const char*)handle;
+}
+
+static void my_STRING_delete(STRING_HANDLE handle)
+{
+    my_gballoc_free(handle);
+}
+
+static AGENT_DATA_TYPES_RESULT my_AgentDataTypes_ToString(STRING_HANDLE destination, const AGENT_DATA_TYPE* value)
+{
+    (void)sprintf((char*)destination, "%u", (unsigned int)value->value.edmByte.value);
+    return AGENT_DATA_TYPES_OK;
+}
+
 BEGIN_TEST_SUITE(DataPublisher_ut)
 
     TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -163,6 +187,7 @@ BEGIN_TEST_SUITE(DataPublisher_ut)
         REGISTER_UMOCK_ALIAS_TYPE(VECTOR_HANDLE, void*);
         REGISTER_UMOCK_ALIAS_TYPE(PREDICATE_FUNCTION, void*);
         REGISTER_UMOCK_ALIAS_TYPE(const VECTOR_HANDLE, void*);
+        REGISTER_UMOCK_ALIAS_TYPE(STRING_HANDLE, void*);
         
         REGISTER_UMOCK_ALIAS_TYPE(DATA_PUBLISHER_RESULT, int);
         REGISTER_UMOCK_ALIAS_TYPE(AGENT_DATA_TYPES_RESULT, int);
@@ -191,6 +216,13 @@ BEGIN_TEST_SUITE(DataPublisher_ut)
         REGISTER_GLOBAL_MOCK_HOOK(Create_AGENT_DATA_TYPE_from_AGENT_DATA_TYPE, my_Create_AGENT_DATA_TYPE_from_AGENT_DATA_TYPE);
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(Create_AGENT_DATA_TYPE_from_AGENT_DATA_TYPE, AGENT_DATA_TYPES_ERROR);
 
+        REGISTER_GLOBAL_MOCK_HOOK(STRING_new, my_STRING_new);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(STRING_new, NULL);
+        REGISTER_GLOBAL_MOCK_HOOK(STRING_c_str, my_STRING_c_str);
+        REGISTER_GLOBAL_MOCK_HOOK(STRING_delete, my_STRING_delete);
+        REGISTER_GLOBAL_MOCK_HOOK(AgentDataTypes_ToString, my_AgentDataTypes_ToString);
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(AgentDataTypes_ToString, AGENT_DATA_TYPES_ERROR);
+
         REGISTER_GLOBAL_MOCK_HOOK(mallocAndStrcpy_s, real_mallocAndStrcpy_s);
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(mallocAndStrcpy_s, __FAILURE__);
         REGISTER_GLOBAL_MOCK_HOOK(unsignedIntToString, real_unsignedIntToString);
@@ -1671,6 +1703,319 @@ next_fail:;
         DataPublisher_Destroy(dataPublisherHandle);
     }
 
+    /*Tests_SRS_DATA_PUBLISHER_99_070: [ If argument transactionHandle, destination or destinationSize is NULL then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_with_NULL_transactionHandle_fails)
+    {
+        ///arrange
+        unsigned char* destination;
+        size_t destinationSize;
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(NULL, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_071: [ If the transaction contains zero elements then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_with_empty_transaction_fails)
+    {
+        ///arrange
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_073: [ The JSON value of every reported property shall be obtained by calling AgentDataTypes_ToString and compared with the JSON value last committed for the same path. ]*/
+    /*Tests_SRS_DATA_PUBLISHER_99_076: [ DataPublisher_CommitTransaction_ReportedPropertiesChanges shall call DataMarshaller_SendData_ReportedProperties providing only the changed reported properties, destination and destinationSize. ]*/
+    /*Tests_SRS_DATA_PUBLISHER_99_078: [ Otherwise DataPublisher_CommitTransaction_ReportedPropertiesChanges shall remember the JSON values of the changed reported properties, succeed and return DATA_PUBLISHER_OK. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_first_commit_succeeds)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        const char* reportedPropertyPath = "A";
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle, reportedPropertyPath, &ag1);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_create(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreAllArguments();
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument_size();
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, reportedPropertyPath))
+            .IgnoreArgument_destination();
+        STRICT_EXPECTED_CALL(VECTOR_push_back(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1))
+            .IgnoreArgument_handle()
+            .IgnoreArgument_elements();
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(DataMarshaller_SendData_ReportedProperties(IGNORED_PTR_ARG, IGNORED_PTR_ARG, &destination, &destinationSize))
+            .IgnoreArgument_dataMarshallerHandle()
+            .IgnoreArgument_values();
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(gballoc_realloc(NULL, IGNORED_NUM_ARG))
+            .IgnoreArgument(2);
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+        STRICT_EXPECTED_CALL(VECTOR_destroy(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_074: [ Reported properties having the same JSON value as the last committed one shall not be part of the JSON. ]*/
+    /*Tests_SRS_DATA_PUBLISHER_99_075: [ If no reported property changed then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall set destination to NULL and destinationSize to 0 and return DATA_PUBLISHER_OK. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_unchanged_value_produces_nothing)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        const char* reportedPropertyPath = "A";
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle, reportedPropertyPath, &ag1);
+        unsigned char* destination;
+        size_t destinationSize;
+        (void)DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+        destination = (unsigned char*)0x1;
+        destinationSize = 1;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_create(IGNORED_NUM_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(STRING_new());
+        STRICT_EXPECTED_CALL(AgentDataTypes_ToString(IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+            .IgnoreAllArguments();
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(STRING_c_str(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_size(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+        STRICT_EXPECTED_CALL(VECTOR_destroy(IGNORED_PTR_ARG))
+            .IgnoreArgument_handle();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_OK, result);
+        ASSERT_IS_NULL(destination);
+        ASSERT_ARE_EQUAL(size_t, 0, destinationSize);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_073: [ The JSON value of every reported property shall be obtained by calling AgentDataTypes_ToString and compared with the JSON value last committed for the same path. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_changed_value_is_sent)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        AGENT_DATA_TYPE ag2;
+        ag2.type = EDM_BYTE_TYPE;
+        ag2.value.edmByte.value = 2;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle1 = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle2 = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        const char* reportedPropertyPath = "A";
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle1, reportedPropertyPath, &ag1);
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle2, reportedPropertyPath, &ag2);
+        unsigned char* destination;
+        size_t destinationSize;
+        (void)DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle1, &destination, &destinationSize);
+        /*the mocked DataMarshaller_SendData_ReportedProperties does not touch destination*/
+        destination = (unsigned char*)0x1;
+        destinationSize = 1;
+        umock_c_reset_all_calls();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle2, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_OK, result);
+        ASSERT_IS_NOT_NULL(destination);
+        ASSERT_ARE_EQUAL(size_t, 1, destinationSize);
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle1);
+        DataPublisher_DestroyTransaction_ReportedProperties(handle2);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_077: [ If any error occurs then DataPublisher_CommitTransaction_ReportedPropertiesChanges shall fail and return DATA_PUBLISHER_ERROR. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_fails_when_DataMarshaller_fails)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        const char* reportedPropertyPath = "A";
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle, reportedPropertyPath, &ag1);
+        unsigned char* destination;
+        size_t destinationSize;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataMarshaller_SendData_ReportedProperties(IGNORED_PTR_ARG, IGNORED_PTR_ARG, &destination, &destinationSize))
+            .IgnoreArgument_dataMarshallerHandle()
+            .IgnoreArgument_values()
+            .SetReturn(DATA_MARSHALLER_ERROR);
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_ERROR, result);
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_079: [ If argument dataPublisherHandle is NULL then DataPublisher_ResetReportedPropertiesChanges shall fail and return DATA_PUBLISHER_INVALID_ARG. ]*/
+    TEST_FUNCTION(DataPublisher_ResetReportedPropertiesChanges_with_NULL_dataPublisherHandle_fails)
+    {
+        ///arrange
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_ResetReportedPropertiesChanges(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_080: [ DataPublisher_ResetReportedPropertiesChanges shall forget all the JSON values remembered by DataPublisher_CommitTransaction_ReportedPropertiesChanges, so the next commit contains all the reported properties of the transaction. ]*/
+    /*Tests_SRS_DATA_PUBLISHER_99_081: [ DataPublisher_ResetReportedPropertiesChanges shall succeed and return DATA_PUBLISHER_OK. ]*/
+    TEST_FUNCTION(DataPublisher_ResetReportedPropertiesChanges_succeeds)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle, "A", &ag1);
+        unsigned char* destination;
+        size_t destinationSize;
+        (void)DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+        STRICT_EXPECTED_CALL(STRING_delete(IGNORED_PTR_ARG))
+            .IgnoreArgument(1);
+        STRICT_EXPECTED_CALL(gballoc_free(IGNORED_PTR_ARG))
+            .IgnoreArgument_ptr();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_ResetReportedPropertiesChanges(dataPublisherHandle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
+    /*Tests_SRS_DATA_PUBLISHER_99_080: [ DataPublisher_ResetReportedPropertiesChanges shall forget all the JSON values remembered by DataPublisher_CommitTransaction_ReportedPropertiesChanges, so the next commit contains all the reported properties of the transaction. ]*/
+    TEST_FUNCTION(DataPublisher_CommitTransaction_ReportedPropertiesChanges_after_reset_sends_unchanged_value)
+    {
+        ///arrange
+        AGENT_DATA_TYPE ag1;
+        ag1.type = EDM_BYTE_TYPE;
+        ag1.value.edmByte.value = 1;
+        DATA_PUBLISHER_HANDLE dataPublisherHandle = DataPublisher_Create(TEST_SCHEMA_MODEL_TYPE_HANDLE, true);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE handle = DataPublisher_CreateTransaction_ReportedProperties(dataPublisherHandle);
+        (void)DataPublisher_PublishTransacted_ReportedProperty(handle, "A", &ag1);
+        unsigned char* destination;
+        size_t destinationSize;
+        (void)DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+        (void)DataPublisher_ResetReportedPropertiesChanges(dataPublisherHandle);
+        /*the mocked DataMarshaller_SendData_ReportedProperties does not touch destination*/
+        destination = (unsigned char*)0x1;
+        destinationSize = 1;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataMarshaller_SendData_ReportedProperties(IGNORED_PTR_ARG, IGNORED_PTR_ARG, &destination, &destinationSize))
+            .IgnoreArgument_dataMarshallerHandle()
+            .IgnoreArgument_values();
+
+        ///act
+        DATA_PUBLISHER_RESULT result = DataPublisher_CommitTransaction_ReportedPropertiesChanges(handle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DATA_PUBLISHER_RESULT, DATA_PUBLISHER_OK, result);
+        ASSERT_IS_NOT_NULL(destination);
+        ASSERT_ARE_EQUAL(size_t, 1, destinationSize);
+
+        ///cleanup
+        DataPublisher_DestroyTransaction_ReportedProperties(handle);
+        DataPublisher_Destroy(dataPublisherHandle);
+    }
+
     /*Tests_SRS_DATA_PUBLISHER_02_025: [ If argument transactionHandle is NULL then DataPublisher_DestroyTransaction_ReportedProperties shall return. ]*/
     TEST_FUNCTION(DataPublisher_DestroyTransaction_ReportedProperties_with_NULL_transactionHandle_fails)
     {
@@ -172,6 +172,7 @@ BEGIN_TEST_SUITE(IoTDevice_ut)
         REGISTER_GLOBAL_MOCK_FAIL_RETURN(CommandDecoder_Create, NULL);
         REGISTER_GLOBAL_MOCK_RETURNS(CommandDecoder_ExecuteCommand, EXECUTE_COMMAND_SUCCESS, EXECUTE_COMMAND_ERROR);
         REGISTER_GLOBAL_MOCK_RETURNS(CommandDecoder_IngestDesiredProperties, EXECUTE_COMMAND_SUCCESS, EXECUTE_COMMAND_ERROR);
+        REGISTER_GLOBAL_MOCK_RETURNS(CommandDecoder_IngestDesiredPropertiesChanges, EXECUTE_COMMAND_SUCCESS, EXECUTE_COMMAND_ERROR);
         REGISTER_GLOBAL_MOCK_HOOK(CommandDecoder_Destroy, my_CommandDecoder_Destroy);
         
         REGISTER_GLOBAL_MOCK_HOOK(DataPublisher_StartTransaction, my_DataPublisher_StartTransaction);
@@ -1214,6 +1215,134 @@ BEGIN_TEST_SUITE(IoTDevice_ut)
         Device_Destroy(h);
     }
 
+    /*Tests_SRS_DEVICE_99_005: [ If argument transactionHandle, destination or destinationSize is NULL then Device_CommitTransaction_ReportedPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    TEST_FUNCTION(Device_CommitTransaction_ReportedPropertiesChanges_with_NULL_transactionHandle_fails)
+    {
+        ///arrange
+        size_t destinationSize;
+        unsigned char* destination;
+
+        ///act
+        DEVICE_RESULT result = Device_CommitTransaction_ReportedPropertiesChanges(NULL, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_DEVICE_99_006: [ Device_CommitTransaction_ReportedPropertiesChanges shall call DataPublisher_CommitTransaction_ReportedPropertiesChanges. ]*/
+    /*Tests_SRS_DEVICE_99_008: [ Otherwise Device_CommitTransaction_ReportedPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+    TEST_FUNCTION(Device_CommitTransaction_ReportedPropertiesChanges_succeeds)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        unsigned char* destination;
+        size_t destinationSize;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE reportedPropertiesTransactionHandle = Device_CreateTransaction_ReportedProperties(h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataPublisher_CommitTransaction_ReportedPropertiesChanges(IGNORED_PTR_ARG, &destination, &destinationSize))
+            .IgnoreArgument_transactionHandle();
+
+        ///act
+        DEVICE_RESULT result = Device_CommitTransaction_ReportedPropertiesChanges(reportedPropertiesTransactionHandle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_DestroyTransaction_ReportedProperties(reportedPropertiesTransactionHandle);
+        Device_Destroy(h);
+    }
+
+    /*Tests_SRS_DEVICE_99_007: [ If DataPublisher_CommitTransaction_ReportedPropertiesChanges fails then Device_CommitTransaction_ReportedPropertiesChanges shall fail and return DEVICE_DATA_PUBLISHER_FAILED. ]*/
+    TEST_FUNCTION(Device_CommitTransaction_ReportedPropertiesChanges_fails)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        unsigned char* destination;
+        size_t destinationSize;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        REPORTED_PROPERTIES_TRANSACTION_HANDLE reportedPropertiesTransactionHandle = Device_CreateTransaction_ReportedProperties(h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataPublisher_CommitTransaction_ReportedPropertiesChanges(IGNORED_PTR_ARG, &destination, &destinationSize))
+            .IgnoreArgument_transactionHandle()
+            .SetReturn(DATA_PUBLISHER_ERROR);
+
+        ///act
+        DEVICE_RESULT result = Device_CommitTransaction_ReportedPropertiesChanges(reportedPropertiesTransactionHandle, &destination, &destinationSize);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_DATA_PUBLISHER_FAILED, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_DestroyTransaction_ReportedProperties(reportedPropertiesTransactionHandle);
+        Device_Destroy(h);
+    }
+
+    /*Tests_SRS_DEVICE_99_009: [ If argument deviceHandle is NULL then Device_ResetReportedPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    TEST_FUNCTION(Device_ResetReportedPropertiesChanges_with_NULL_deviceHandle_fails)
+    {
+        ///arrange
+
+        ///act
+        DEVICE_RESULT result = Device_ResetReportedPropertiesChanges(NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_DEVICE_99_010: [ Device_ResetReportedPropertiesChanges shall call DataPublisher_ResetReportedPropertiesChanges. ]*/
+    /*Tests_SRS_DEVICE_99_012: [ Otherwise Device_ResetReportedPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+    TEST_FUNCTION(Device_ResetReportedPropertiesChanges_succeeds)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataPublisher_ResetReportedPropertiesChanges(IGNORED_PTR_ARG))
+            .IgnoreArgument_dataPublisherHandle();
+
+        ///act
+        DEVICE_RESULT result = Device_ResetReportedPropertiesChanges(h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_Destroy(h);
+    }
+
+    /*Tests_SRS_DEVICE_99_011: [ If DataPublisher_ResetReportedPropertiesChanges fails then Device_ResetReportedPropertiesChanges shall fail and return DEVICE_DATA_PUBLISHER_FAILED. ]*/
+    TEST_FUNCTION(Device_ResetReportedPropertiesChanges_fails)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(DataPublisher_ResetReportedPropertiesChanges(IGNORED_PTR_ARG))
+            .IgnoreArgument_dataPublisherHandle()
+            .SetReturn(DATA_PUBLISHER_ERROR);
+
+        ///act
+        DEVICE_RESULT result = Device_ResetReportedPropertiesChanges(h);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_DATA_PUBLISHER_FAILED, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_Destroy(h);
+    }
+
     /*Tests_SRS_DEVICE_02_030: [ If argument transactionHandle is NULL then Device_DestroyTransaction_ReportedProperties shall return. ]*/
     TEST_FUNCTION(Device_DestroyTransaction_ReportedProperties_with_NULL_returns)
     {
@@ -1399,6 +1528,65 @@ BEGIN_TEST_SUITE(IoTDevice_ut)
         Device_Destroy(h);
     }
 
+    /*Tests_SRS_DEVICE_99_001: [ If deviceHandle, jsonPayload or startAddress is NULL then Device_IngestDesiredPropertiesChanges shall fail and return DEVICE_INVALID_ARG. ]*/
+    TEST_FUNCTION(Device_IngestDesiredPropertiesChanges_with_NULL_deviceHandle_fails)
+    {
+        ///arrange
+
+        ///act
+        DEVICE_RESULT result = Device_IngestDesiredPropertiesChanges(FAKE_DEVICE_START_ADDRESS, NULL, "{}", false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_DEVICE_99_002: [ Device_IngestDesiredPropertiesChanges shall call CommandDecoder_IngestDesiredPropertiesChanges. ]*/
+    /*Tests_SRS_DEVICE_99_004: [ Otherwise, Device_IngestDesiredPropertiesChanges shall succeed and return DEVICE_OK. ]*/
+    TEST_FUNCTION(Device_IngestDesiredPropertiesChanges_succeeds)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(CommandDecoder_IngestDesiredPropertiesChanges(FAKE_DEVICE_START_ADDRESS, IGNORED_PTR_ARG, "{}", false))
+            .IgnoreArgument_handle();
+
+        ///act
+        DEVICE_RESULT result = Device_IngestDesiredPropertiesChanges(FAKE_DEVICE_START_ADDRESS, h, "{}", false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_OK, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_Destroy(h);
+    }
+
+    /*Tests_SRS_DEVICE_99_003: [ If any failure happens then Device_IngestDesiredPropertiesChanges shall fail and return DEVICE_ERROR. ]*/
+    TEST_FUNCTION(Device_IngestDesiredPropertiesChanges_fails)
+    {
+        ///arrange
+        DEVICE_HANDLE h;
+        Device_Create(irrelevantModel, DeviceActionCallback, TEST_CALLBACK_CONTEXT, deviceMethodCallback, TEST_CALLBACK_CONTEXT, false, &h);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(CommandDecoder_IngestDesiredPropertiesChanges(FAKE_DEVICE_START_ADDRESS, IGNORED_PTR_ARG, "{}", false))
+            .IgnoreArgument_handle()
+            .SetReturn(EXECUTE_COMMAND_FAILED);
+
+        ///act
+        DEVICE_RESULT result = Device_IngestDesiredPropertiesChanges(FAKE_DEVICE_START_ADDRESS, h, "{}", false);
+
+        ///assert
+        ASSERT_ARE_EQUAL(DEVICE_RESULT, DEVICE_ERROR, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Device_Destroy(h);
+    }
+
     /*Tests_SRS_DEVICE_02_038: [ If deviceHandle is NULL then Device_ExecuteMethod shall fail and return NULL. ]*/
     TEST_FUNCTION(Device_ExecuteMethod_with_NULL_deviceHandle_fails)
     {
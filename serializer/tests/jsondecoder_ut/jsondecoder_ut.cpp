@@ -2589,4 +2589,50 @@ TEST_FUNCTION(JSONDecoder_When_String_Has_Several_Escaped_Chars_Decoding_Succeed
     TestSpecialCharacter_Success(json);
 }
 
+/* Tests_SRS_JSON_DECODER_99_050:[ %x22 /          ; "    quotation mark  U+0022] */
+TEST_FUNCTION(JSONDecoder_When_String_Has_Escaped_Quotes_Before_The_Ending_Quote_Decoding_Succeeds)
+{
+    char json[] = "[\"a\\\"quoted\\\" and a long tail that has no escapes at all\\\\\"]";
+    TestSpecialCharacter_Success(json);
+}
+
+/* Tests_SRS_JSON_DECODER_99_028:[ A string begins and ends with quotation marks.] */
+/* Tests_SRS_JSON_DECODER_99_007:[ If parsing the JSON fails due to the JSON string being malformed, JSONDecoder_JSON_To_MultiTree shall return JSON_DECODER_PARSE_ERROR.] */
+TEST_FUNCTION(JSONDecoder_When_The_Only_Quote_After_A_String_Begins_Is_Escaped_Decoding_Fails)
+{
+    ///arrange
+    CJSONDecoderMocks mocks;
+    MULTITREE_HANDLE multiTree;
+    char json[] = "[\"abc\\\"]";
+
+    EXPECTED_CALL(mocks, MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, MultiTree_AddChild(TestMultiTreeHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).CopyOutArgumentBuffer(3, &TestChildHandle1, sizeof(TestChildHandle1));
+    STRICT_EXPECTED_CALL(mocks, MultiTree_Destroy(TestMultiTreeHandle));
+
+    ///act
+    JSON_DECODER_RESULT result = JSONDecoder_JSON_To_MultiTree(json, &multiTree);
+
+    ///assert
+    ASSERT_ARE_EQUAL(JSON_DECODER_RESULT_TAG, JSON_DECODER_PARSE_ERROR, result);
+}
+
+/* Tests_SRS_JSON_DECODER_99_007:[ If parsing the JSON fails due to the JSON string being malformed, JSONDecoder_JSON_To_MultiTree shall return JSON_DECODER_PARSE_ERROR.] */
+TEST_FUNCTION(JSONDecoder_When_The_JSON_Ends_With_An_Escape_Inside_A_String_Decoding_Fails)
+{
+    ///arrange
+    CJSONDecoderMocks mocks;
+    MULTITREE_HANDLE multiTree;
+    char json[] = "[\"abc\\";
+
+    EXPECTED_CALL(mocks, MultiTree_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    EXPECTED_CALL(mocks, MultiTree_AddChild(TestMultiTreeHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).CopyOutArgumentBuffer(3, &TestChildHandle1, sizeof(TestChildHandle1));
+    STRICT_EXPECTED_CALL(mocks, MultiTree_Destroy(TestMultiTreeHandle));
+
+    ///act
+    JSON_DECODER_RESULT result = JSONDecoder_JSON_To_MultiTree(json, &multiTree);
+
+    ///assert
+    ASSERT_ARE_EQUAL(JSON_DECODER_RESULT_TAG, JSON_DECODER_PARSE_ERROR, result);
+}
+
 END_TEST_SUITE(JSONDecoder_ut)
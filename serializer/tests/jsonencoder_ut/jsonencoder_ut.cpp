@@ -9,6 +9,7 @@
 #include "micromock.h"
 #include "micromockcharstararenullterminatedstrings.h"
 #include <stdexcept>
+#include <string>
 #include "multitree.h"
 
 /*this is what we test*/
@@ -597,6 +598,25 @@ static void NoFreeFunction(void* value)
 
 static STRING_HANDLE global_bufferTemp=NULL;
 
+typedef struct TEST_MEMBER_TAG
+{
+    const char* name;
+    const char* value;
+} TEST_MEMBER;
+
+static const TEST_MEMBER TEST_MEMBERS[] =
+{
+    { "child1", "\"value1\"" },
+    { "child2", "\"value2\"" },
+    { "child3", "\"value3\"" }
+};
+
+static void GetTestMember(const void* members, size_t index, const char** name, const void** value)
+{
+    *name = ((const TEST_MEMBER*)members)[index].name;
+    *value = ((const TEST_MEMBER*)members)[index].value;
+}
+
 static CJSONMocks* mocks;
 
 static MICROMOCK_MUTEX_HANDLE g_testByTest;
@@ -6367,6 +6387,153 @@ BEGIN_TEST_SUITE(JSONEncoder_ut)
             ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_OK, result);
             ASSERT_ARE_EQUAL(char_ptr, "{\"child1\":\"value1\", \"child2\":\"value2\", \"child3\":\"value3\", \"subtree\":{\"child4\":\"value4\", \"child5\":\"value5\"}}", STRING_c_str(global_bufferTemp));
         }
+        /*Tests_SRS_JSON_ENCODER_99_051: [ If members is NULL while memberCount is not 0, or getMember, destination or toStringFunc is NULL, JSONEncoder_EncodeObject shall return JSON_ENCODER_INVALID_ARG. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_NULL_members_fails)
+        {
+            ///arrange
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(NULL, 1, GetTestMember, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_INVALID_ARG, result);
+            mocks->AssertActualAndExpectedCalls();
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_051: [ If members is NULL while memberCount is not 0, or getMember, destination or toStringFunc is NULL, JSONEncoder_EncodeObject shall return JSON_ENCODER_INVALID_ARG. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_NULL_getMember_fails)
+        {
+            ///arrange
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 1, NULL, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_INVALID_ARG, result);
+            mocks->AssertActualAndExpectedCalls();
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_051: [ If members is NULL while memberCount is not 0, or getMember, destination or toStringFunc is NULL, JSONEncoder_EncodeObject shall return JSON_ENCODER_INVALID_ARG. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_NULL_destination_fails)
+        {
+            ///arrange
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 1, GetTestMember, NULL, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_INVALID_ARG, result);
+            mocks->AssertActualAndExpectedCalls();
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_051: [ If members is NULL while memberCount is not 0, or getMember, destination or toStringFunc is NULL, JSONEncoder_EncodeObject shall return JSON_ENCODER_INVALID_ARG. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_NULL_toStringFunc_fails)
+        {
+            ///arrange
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 1, GetTestMember, global_bufferTemp, NULL);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_INVALID_ARG, result);
+            mocks->AssertActualAndExpectedCalls();
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_052: [ JSONEncoder_EncodeObject shall append to destination the JSON object with the memberCount members produced by getMember, in the same format as JSONEncoder_EncodeTree. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_0_members_succeeds)
+        {
+            ///arrange
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(NULL, 0, GetTestMember, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_OK, result);
+            ASSERT_ARE_EQUAL(char_ptr, "{}", STRING_c_str(global_bufferTemp));
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_052: [ JSONEncoder_EncodeObject shall append to destination the JSON object with the memberCount members produced by getMember, in the same format as JSONEncoder_EncodeTree. ]*/
+        /*Tests_SRS_JSON_ENCODER_99_053: [ Every name shall be written straight into destination, followed by the value produced by toStringFunc in destination. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_3_members_succeeds)
+        {
+            ///arrange
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, "{\"child1\":"));
+            STRICT_EXPECTED_CALL((*mocks), TestFunc_NodesAreStrings(global_bufferTemp, TEST_MEMBERS[0].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, TEST_MEMBERS[0].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, ", \"child2\":"));
+            STRICT_EXPECTED_CALL((*mocks), TestFunc_NodesAreStrings(global_bufferTemp, TEST_MEMBERS[1].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, TEST_MEMBERS[1].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, ", \"child3\":"));
+            STRICT_EXPECTED_CALL((*mocks), TestFunc_NodesAreStrings(global_bufferTemp, TEST_MEMBERS[2].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, TEST_MEMBERS[2].value));
+            STRICT_EXPECTED_CALL((*mocks), STRING_concat(global_bufferTemp, "}"));
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 3, GetTestMember, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_OK, result);
+            ASSERT_ARE_EQUAL(char_ptr, "{\"child1\":\"value1\", \"child2\":\"value2\", \"child3\":\"value3\"}", BASEIMPLEMENTATION::STRING_c_str(global_bufferTemp));
+            mocks->AssertActualAndExpectedCalls();
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_053: [ Every name shall be written straight into destination, followed by the value produced by toStringFunc in destination. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_with_a_long_member_name_succeeds)
+        {
+            ///arrange
+            char longName[200];
+            TEST_MEMBER longMember;
+            (void)memset(longName, 'a', sizeof(longName) - 1);
+            longName[sizeof(longName) - 1] = '\0';
+            longMember.name = longName;
+            longMember.value = "1";
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(&longMember, 1, GetTestMember, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_OK, result);
+            std::string expected = std::string("{\"") + longName + "\":1}";
+            ASSERT_ARE_EQUAL(char_ptr, expected.c_str(), STRING_c_str(global_bufferTemp));
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_054: [ If toStringFunc fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_TOSTRING_FUNCTION_ERROR. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_fails_when_toStringFunc_fails)
+        {
+            ///arrange
+            STRICT_EXPECTED_CALL((*mocks), TestFunc_NodesAreStrings(global_bufferTemp, TEST_MEMBERS[0].value));
+            STRICT_EXPECTED_CALL((*mocks), TestFunc_NodesAreStrings(global_bufferTemp, TEST_MEMBERS[1].value))
+                .SetReturn(JSON_ENCODER_TOSTRING_ERROR);
+
+            ///act
+            auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 3, GetTestMember, global_bufferTemp, TestFunc_NodesAreStrings);
+
+            ///assert
+            ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_TOSTRING_FUNCTION_ERROR, result);
+        }
+
+        /*Tests_SRS_JSON_ENCODER_99_055: [ If appending to destination fails, JSONEncoder_EncodeObject shall return JSON_ENCODER_ERROR. ]*/
+        TEST_FUNCTION(JSONEncoder_EncodeObject_fails_when_STRING_concat_fails)
+        {
+            size_t i;
+            for (i = 1; i <= 4; i++)
+            {
+                ///arrange
+                STRING_HANDLE destination = STRING_new();
+                currentSTRING_concat_call = 0;
+                whenShallSTRING_concat_fail = i;
+
+                ///act
+                auto result = JSONEncoder_EncodeObject(TEST_MEMBERS, 3, GetTestMember, destination, TestFunc_NodesAreStrings);
+
+                ///assert
+                ASSERT_ARE_EQUAL(JSON_ENCODER_RESULT, JSON_ENCODER_ERROR, result);
+
+                ///cleanup
+                STRING_delete(destination);
+            }
+        }
+
         /*Tests_SRS_JSON_ENCODER_99_047:[ JSONEncoder_CharPtr_ToString shall return JSON_ENCODER_TOSTRING_INVALID_ARG if destination or value parameters passed to it are NULL.]*/
         TEST_FUNCTION(JSONEncoder_CharPtr_ToString_with_NULL_destination_fails)
         {
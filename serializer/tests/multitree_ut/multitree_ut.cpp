@@ -2448,6 +2448,97 @@ TEST_FUNCTION(MultiTree_DeleteChild_With_Only_Node_Succeeds)
     mocks.ResetAllCalls();
 }
 
+/* Tests_SRS_MULTITREE_99_080: [ Nodes with CHILD_INDEX_MIN_CHILDREN or more children shall find their children by name through a hash index instead of comparing every child name. ]*/
+/* Tests_SRS_MULTITREE_99_081: [ Children shall keep the order in which they were added. ]*/
+TEST_FUNCTION(MultiTree_AddLeaf_with_many_children_finds_and_enumerates_all_of_them)
+{
+    ///arrange
+    CMultiTreeMocks mocks;
+    MULTITREE_HANDLE treeHandle = MultiTree_Create(StringClone, StringFree);
+    char name[32];
+    char path[64];
+    size_t i;
+
+    ///act
+    for (i = 0; i < 200; i++)
+    {
+        (void)sprintf(name, "child%u", (unsigned int)i);
+        (void)sprintf(path, "/%s/leaf", name);
+        ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_OK, MultiTree_AddLeaf(treeHandle, path, name));
+    }
+
+    ///assert
+    for (i = 0; i < 200; i++)
+    {
+        MULTITREE_HANDLE childHandle;
+        MULTITREE_HANDLE childByIndex;
+        const char* value;
+        (void)sprintf(name, "child%u", (unsigned int)i);
+        (void)sprintf(path, "/%s/leaf", name);
+
+        ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_OK, MultiTree_GetChildByName(treeHandle, name, &childHandle));
+        ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_OK, MultiTree_GetChild(treeHandle, i, &childByIndex));
+        ASSERT_ARE_EQUAL(void_ptr, (void*)childByIndex, (void*)childHandle);
+        ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_OK, MultiTree_GetLeafValue(treeHandle, path, (const void**)&value));
+        ASSERT_ARE_EQUAL(char_ptr, name, value);
+    }
+
+    ///cleanup
+    MultiTree_Destroy(treeHandle);
+    mocks.ResetAllCalls();
+}
 
+/* Tests_SRS_MULTITREE_99_080: [ Nodes with CHILD_INDEX_MIN_CHILDREN or more children shall find their children by name through a hash index instead of comparing every child name. ]*/
+TEST_FUNCTION(MultiTree_GetLeafValue_does_not_match_a_child_whose_name_starts_with_the_path_component)
+{
+    ///arrange
+    CMultiTreeMocks mocks;
+    MULTITREE_HANDLE treeHandle = MultiTree_Create(StringClone, StringFree);
+    const char* value;
+    (void)MultiTree_AddLeaf(treeHandle, "/child10", "value10");
+
+    ///act
+    MULTITREE_RESULT result = MultiTree_GetLeafValue(treeHandle, "/child1", (const void**)&value);
+
+    ///assert
+    ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_CHILD_NOT_FOUND, result);
+
+    ///cleanup
+    MultiTree_Destroy(treeHandle);
+    mocks.ResetAllCalls();
+}
+
+/* Tests_SRS_MULTITREE_99_077:[ MultiTree_DeleteChild shall remove the direct children node (no recursive search) set by childName.] */
+/* Tests_SRS_MULTITREE_99_080: [ Nodes with CHILD_INDEX_MIN_CHILDREN or more children shall find their children by name through a hash index instead of comparing every child name. ]*/
+TEST_FUNCTION(MultiTree_DeleteChild_with_many_children_keeps_the_other_children_reachable)
+{
+    ///arrange
+    CMultiTreeMocks mocks;
+    MULTITREE_HANDLE treeHandle = MultiTree_Create(StringClone, StringFree);
+    char name[32];
+    size_t i;
+    for (i = 0; i < 20; i++)
+    {
+        MULTITREE_HANDLE childHandle;
+        (void)sprintf(name, "child%u", (unsigned int)i);
+        (void)MultiTree_AddChild(treeHandle, name, &childHandle);
+    }
+
+    ///act
+    MULTITREE_RESULT result = MultiTree_DeleteChild(treeHandle, "child3");
+
+    ///assert
+    ASSERT_ARE_EQUAL(MULTITREE_RESULT, MULTITREE_OK, result);
+    for (i = 0; i < 20; i++)
+    {
+        MULTITREE_HANDLE childHandle;
+        (void)sprintf(name, "child%u", (unsigned int)i);
+        ASSERT_ARE_EQUAL(MULTITREE_RESULT, (i == 3) ? MULTITREE_CHILD_NOT_FOUND : MULTITREE_OK, MultiTree_GetChildByName(treeHandle, name, &childHandle));
+    }
+
+    ///cleanup
+    MultiTree_Destroy(treeHandle);
+    mocks.ResetAllCalls();
+}
 
 END_TEST_SUITE(MultiTree_ut)
@@ -115,6 +115,13 @@ static int g_pfDesiredPropertyFromAGENT_DATA_TYPE(const AGENT_DATA_TYPE* source,
     return 0;
 }
 
+static int g_pfDesiredPropertyToAGENT_DATA_TYPE(const void* source, AGENT_DATA_TYPE* dest)
+{
+    (void)source;
+    (void)dest;
+    return 0;
+}
+
 static void g_pfDesiredPropertyInitialize(void* destination)
 {
     (void)(destination);
@@ -4582,7 +4589,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(NULL, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(NULL, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4600,7 +4607,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         umock_c_reset_all_calls();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, NULL, "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, NULL, "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4619,7 +4626,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         umock_c_reset_all_calls();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", NULL, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", NULL, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4638,7 +4645,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         umock_c_reset_all_calls();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", NULL, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", NULL, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4657,7 +4664,26 @@ BEGIN_TEST_SUITE(Schema_ut)
         umock_c_reset_all_calls();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, NULL, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, NULL, g_pfDesiredPropertyDeinitialize, 0, NULL);
+
+        ///assert
+        ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
+
+    /*Tests_SRS_SCHEMA_99_186: [ If desiredPropertyToAGENT_DATA_TYPE is NULL then Schema_AddModelDesiredProperty shall fail and return SCHEMA_INVALID_ARG. ]*/
+    TEST_FUNCTION(Schema_AddModelDesiredProperty_with_NULL_desiredPropertyToAGENT_DATA_TYPE_fails)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
+        umock_c_reset_all_calls();
+
+        ///act
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, NULL, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4676,7 +4702,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         umock_c_reset_all_calls();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, NULL, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, NULL, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_INVALID_ARG, result);
@@ -4721,7 +4747,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         Schema_AddModelDesiredProperty_inert_path(name, type);
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_OK, result);
@@ -4771,7 +4797,7 @@ BEGIN_TEST_SUITE(Schema_ut)
                 sprintf(temp_str, "On failed call %zu", i);
 
                 ///act
-                SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, desiredPropertyName, desiredPropertyType, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+                SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, desiredPropertyName, desiredPropertyType, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
                 ///assert
                 ASSERT_ARE_EQUAL_WITH_MSG(SCHEMA_RESULT, SCHEMA_ERROR, result, temp_str);
@@ -4791,7 +4817,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
         const char* name = "a";
         const char* type = "b";
-        (void)Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         umock_c_reset_all_calls();
 
 
@@ -4800,7 +4826,7 @@ BEGIN_TEST_SUITE(Schema_ut)
             .IgnoreArgument_pred();
 
         ///act
-        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_RESULT result = Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///assert
         ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_DUPLICATE_ELEMENT, result);
@@ -4874,7 +4900,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         size_t nDesiredProperties;
         umock_c_reset_all_calls();
@@ -4900,8 +4926,8 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
-        (void)Schema_AddModelDesiredProperty(modelType, "A", "B", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "A", "B", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         size_t nDesiredProperties;
         umock_c_reset_all_calls();
@@ -4985,7 +5011,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         umock_c_reset_all_calls();
         const char* desiredPropertyName = "c"; /*only "a" exists*/
 
@@ -5010,7 +5036,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         umock_c_reset_all_calls();
         const char* desiredPropertyName = "a"; /*only "a" exists*/
 
@@ -5072,7 +5098,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 1))
@@ -5095,7 +5121,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         umock_c_reset_all_calls();
 
         STRICT_EXPECTED_CALL(VECTOR_element(IGNORED_PTR_ARG, 0))
@@ -5169,7 +5195,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///act
         bool result = Schema_ModelDesiredPropertyByPathExists(modelType, "z"); /*only "a" exists*/
@@ -5187,8 +5213,8 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a1", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
-        (void)Schema_AddModelDesiredProperty(modelType, "a2", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a1", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a2", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///act
         bool result = Schema_ModelDesiredPropertyByPathExists(modelType, "z"); /*only "a1" and "a2" exists*/
@@ -5206,8 +5232,8 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a1", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
-        (void)Schema_AddModelDesiredProperty(modelType, "a2", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a1", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a2", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         ///act
         bool result_a1 = Schema_ModelDesiredPropertyByPathExists(modelType, "a1"); /*only "a1" and "a2" exists*/
@@ -5230,7 +5256,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "someModel");
         SCHEMA_MODEL_TYPE_HANDLE minerModel = Schema_CreateModelType(schemaHandle, "someMinerModel");
         (void)Schema_AddModelModel(model, "ManicMiner", minerModel, 0, NULL);
-        (void)Schema_AddModelDesiredProperty(model, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(model, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         /* overview of what the above instructions produce:
         SCHEMA
@@ -5264,9 +5290,9 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "someModel");
         SCHEMA_MODEL_TYPE_HANDLE minerModel = Schema_CreateModelType(schemaHandle, "someMinerModel");
-        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         (void)Schema_AddModelModel(model, "ManicMiner", minerModel, 0, NULL);
-        (void)Schema_AddModelDesiredProperty(model, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(model, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
 
         /* overview of what the above instructions produce:
         SCHEMA
@@ -5318,7 +5344,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
         const char* name = "a";
         const char* type = "b";
-        (void)Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, name, type, g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, name);
         umock_c_reset_all_calls();
 
@@ -5332,6 +5358,40 @@ BEGIN_TEST_SUITE(Schema_ut)
         Schema_Destroy(schemaHandle);
     }
 
+    /*Tests_SRS_SCHEMA_99_187: [ If desiredPropertyHandle is NULL then Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE shall fail and return NULL. ]*/
+    TEST_FUNCTION(Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE_with_NULL_desiredPropertyHandle_fails)
+    {
+        ///arrange
+
+        ///act
+        pfDesiredPropertyToAGENT_DATA_TYPE result = Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(NULL);
+
+        ///assert
+        ASSERT_IS_TRUE(result == NULL);
+
+        ///clean
+    }
+
+    /*Tests_SRS_SCHEMA_99_188: [ Otherwise Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE shall return the desiredPropertyToAGENT_DATA_TYPE that was passed to Schema_AddModelDesiredProperty. ]*/
+    TEST_FUNCTION(Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE_succeeds)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
+        umock_c_reset_all_calls();
+
+        ///act
+        pfDesiredPropertyToAGENT_DATA_TYPE result = Schema_GetModelDesiredProperty_pfDesiredPropertyToAGENT_DATA_TYPE(desiredPropertyHandle);
+
+        ///assert
+        ASSERT_IS_TRUE(result == g_pfDesiredPropertyToAGENT_DATA_TYPE);
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
+
     /*Tests_SRS_SCHEMA_02_053: [ If modelTypeHandle is NULL then Schema_GetModelModelByName_Offset shall fail and return 0. ]*/
     TEST_FUNCTION(Schema_GetModelModelByName_Offset_with_NULL_modelTypeHandle_fails)
     {
@@ -5476,7 +5536,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
 
         umock_c_reset_all_calls();
@@ -5511,7 +5571,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "theType", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "theType", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
 
         umock_c_reset_all_calls();
@@ -5546,7 +5606,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "theType", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "theType", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
         umock_c_reset_all_calls();
 
@@ -5580,7 +5640,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
         umock_c_reset_all_calls();
 
@@ -5605,7 +5665,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "desired", "a", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "desired", "a", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
         (void)Schema_AddModelReportedProperty(modelType, "reported", "n");
         (void)Schema_AddModelProperty(modelType, "regularProperty", "j");
         (void)Schema_CreateModelAction(modelType, "action");
@@ -5663,7 +5723,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "desired", "a", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
+        (void)Schema_AddModelDesiredProperty(modelType, "desired", "a", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, NULL);
 
         ///act
         pfOnDesiredProperty onDesiredProperty = Schema_GetModelDesiredProperty_pfOnDesiredProperty(NULL);
@@ -5681,7 +5741,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///arrange
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE modelType = Schema_CreateModelType(schemaHandle, "Model");
-        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, g_onDesiredProperty);
+        (void)Schema_AddModelDesiredProperty(modelType, "a", "b", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 3, g_onDesiredProperty);
         SCHEMA_DESIRED_PROPERTY_HANDLE desiredPropertyHandle = Schema_GetModelDesiredPropertyByName(modelType, "a");
 
         ///act
@@ -5715,7 +5775,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "someModel");
         SCHEMA_MODEL_TYPE_HANDLE minerModel = Schema_CreateModelType(schemaHandle, "someMinerModel");
-        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         (void)Schema_AddModelModel(model, "ManicMiner", minerModel, 0, NULL);
 
         ///act
@@ -5735,7 +5795,7 @@ BEGIN_TEST_SUITE(Schema_ut)
         SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
         SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "someModel");
         SCHEMA_MODEL_TYPE_HANDLE minerModel = Schema_CreateModelType(schemaHandle, "someMinerModel");
-        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
+        (void)Schema_AddModelDesiredProperty(minerModel, "reported", "five_miles_of_gallery", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, 0, NULL);
         (void)Schema_AddModelModel(model, "ManicMiner", minerModel, 0, g_onDesiredProperty);
 
         ///act
@@ -6503,4 +6563,177 @@ BEGIN_TEST_SUITE(Schema_ut)
         ///clean
         Schema_Destroy(schemaHandle);
     }
+
+    /*Tests_SRS_SCHEMA_99_184: [ Collections of NAME_INDEX_MIN_ELEMENTS or more schemas, models, struct types, properties, reported properties, desired properties, actions, methods or models in model shall be searched by name through a hash index that is updated when an element is added to or removed from the collection, so that lookups do not modify the schema. ]*/
+    TEST_FUNCTION(Schema_GetModelElementByName_on_a_wide_model_finds_every_element)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "model");
+        SCHEMA_MODEL_TYPE_HANDLE innerModel = Schema_CreateModelType(schemaHandle, "innerModel");
+        char name[32];
+        size_t i;
+        for (i = 0; i < 20; i++)
+        {
+            (void)sprintf(name, "property%u", (unsigned int)i);
+            (void)Schema_AddModelProperty(model, name, "int");
+            (void)sprintf(name, "reported%u", (unsigned int)i);
+            (void)Schema_AddModelReportedProperty(model, name, "int");
+            (void)sprintf(name, "desired%u", (unsigned int)i);
+            (void)Schema_AddModelDesiredProperty(model, name, "int", g_pfDesiredPropertyFromAGENT_DATA_TYPE, g_pfDesiredPropertyToAGENT_DATA_TYPE, g_pfDesiredPropertyInitialize, g_pfDesiredPropertyDeinitialize, i, NULL);
+            (void)sprintf(name, "action%u", (unsigned int)i);
+            (void)Schema_CreateModelAction(model, name);
+            (void)sprintf(name, "method%u", (unsigned int)i);
+            (void)Schema_CreateModelMethod(model, name);
+            (void)sprintf(name, "inner%u", (unsigned int)i);
+            (void)Schema_AddModelModel(model, name, innerModel, i, NULL);
+        }
+
+        ///act
+        for (i = 0; i < 20; i++)
+        {
+            SCHEMA_MODEL_ELEMENT element;
+
+            ///assert
+            (void)sprintf(name, "property%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelPropertyByIndex(model, i), Schema_GetModelPropertyByName(model, name));
+            element = Schema_GetModelElementByName(model, name);
+            ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_PROPERTY, element.elementType);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelPropertyByIndex(model, i), element.elementHandle.propertyHandle);
+
+            (void)sprintf(name, "reported%u", (unsigned int)i);
+            ASSERT_IS_NOT_NULL(Schema_GetModelReportedPropertyByName(model, name));
+            element = Schema_GetModelElementByName(model, name);
+            ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_REPORTED_PROPERTY, element.elementType);
+
+            (void)sprintf(name, "desired%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelDesiredPropertyByIndex(model, i), Schema_GetModelDesiredPropertyByName(model, name));
+            element = Schema_GetModelElementByName(model, name);
+            ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_DESIRED_PROPERTY, element.elementType);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelDesiredPropertyByIndex(model, i), element.elementHandle.desiredPropertyHandle);
+
+            (void)sprintf(name, "action%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelActionByIndex(model, i), Schema_GetModelActionByName(model, name));
+            element = Schema_GetModelElementByName(model, name);
+            ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_MODEL_ACTION, element.elementType);
+            ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelActionByIndex(model, i), element.elementHandle.actionHandle);
+
+            (void)sprintf(name, "method%u", (unsigned int)i);
+            ASSERT_IS_NOT_NULL(Schema_GetModelMethodByName(model, name));
+
+            (void)sprintf(name, "inner%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(void_ptr, innerModel, Schema_GetModelModelByName(model, name));
+            ASSERT_ARE_EQUAL(size_t, i, Schema_GetModelModelByName_Offset(model, name));
+            element = Schema_GetModelElementByName(model, name);
+            ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_MODEL_IN_MODEL, element.elementType);
+        }
+        ASSERT_IS_NULL(Schema_GetModelPropertyByName(model, "property20"));
+        ASSERT_IS_NULL(Schema_GetModelMethodByName(model, "method20"));
+        ASSERT_ARE_EQUAL(SCHEMA_ELEMENT_TYPE, SCHEMA_NOT_FOUND, Schema_GetModelElementByName(model, "inner20").elementType);
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
+
+    /*Tests_SRS_SCHEMA_99_184: [ Collections of NAME_INDEX_MIN_ELEMENTS or more schemas, models, struct types, properties, reported properties, desired properties, actions, methods or models in model shall be searched by name through a hash index that is updated when an element is added to or removed from the collection, so that lookups do not modify the schema. ]*/
+    TEST_FUNCTION(Schema_GetModelByName_finds_a_model_added_after_a_lookup_on_a_wide_schema)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE lastModel;
+        char name[32];
+        size_t i;
+        for (i = 0; i < 16; i++)
+        {
+            (void)sprintf(name, "model%u", (unsigned int)i);
+            (void)Schema_CreateModelType(schemaHandle, name);
+            (void)sprintf(name, "struct%u", (unsigned int)i);
+            (void)Schema_CreateStructType(schemaHandle, name);
+        }
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelByIndex(schemaHandle, 15), Schema_GetModelByName(schemaHandle, "model15"));
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetStructTypeByIndex(schemaHandle, 15), Schema_GetStructTypeByName(schemaHandle, "struct15"));
+        lastModel = Schema_CreateModelType(schemaHandle, "model16");
+
+        ///act
+        SCHEMA_MODEL_TYPE_HANDLE result = Schema_GetModelByName(schemaHandle, "model16");
+
+        ///assert
+        ASSERT_ARE_EQUAL(void_ptr, lastModel, result);
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelByIndex(schemaHandle, 3), Schema_GetModelByName(schemaHandle, "model3"));
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
+
+    /*Tests_SRS_SCHEMA_99_185: [ If the hash index cannot be built, the lookup shall compare the name of every element of the collection. ]*/
+    TEST_FUNCTION(Schema_GetModelPropertyByName_when_the_name_index_cannot_be_allocated_still_finds_the_property)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "model");
+        char name[32];
+        size_t i;
+        for (i = 0; i < 7; i++)
+        {
+            (void)sprintf(name, "property%u", (unsigned int)i);
+            (void)Schema_AddModelProperty(model, name, "int");
+        }
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(gballoc_realloc(IGNORED_PTR_ARG, IGNORED_NUM_ARG))
+            .IgnoreArgument_ptr()
+            .IgnoreArgument_size();
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG))
+            .IgnoreArgument_size();
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "property7"))
+            .IgnoreArgument_destination();
+        STRICT_EXPECTED_CALL(mallocAndStrcpy_s(IGNORED_PTR_ARG, "int"))
+            .IgnoreArgument_destination();
+        STRICT_EXPECTED_CALL(gballoc_malloc(IGNORED_NUM_ARG)) /*this is the name index*/
+            .IgnoreArgument_size()
+            .SetReturn(NULL);
+
+        ///act
+        SCHEMA_RESULT addResult = Schema_AddModelProperty(model, "property7", "int");
+        SCHEMA_PROPERTY_HANDLE result = Schema_GetModelPropertyByName(model, "property5");
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(SCHEMA_RESULT, SCHEMA_OK, addResult);
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelPropertyByIndex(model, 5), result);
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelPropertyByIndex(model, 7), Schema_GetModelPropertyByName(model, "property7"));
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
+
+    /*Tests_SRS_SCHEMA_99_184: [ Collections of NAME_INDEX_MIN_ELEMENTS or more schemas, models, struct types, properties, reported properties, desired properties, actions, methods or models in model shall be searched by name through a hash index that is updated when an element is added to or removed from the collection, so that lookups do not modify the schema. ]*/
+    TEST_FUNCTION(Schema_GetModelPropertyByName_on_a_wide_model_does_not_allocate)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create(SCHEMA_NAMESPACE, TEST_SCHEMA_METADATA);
+        SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "model");
+        char name[32];
+        size_t i;
+        for (i = 0; i < 40; i++)
+        {
+            (void)sprintf(name, "property%u", (unsigned int)i);
+            (void)Schema_AddModelProperty(model, name, "int");
+            (void)sprintf(name, "action%u", (unsigned int)i);
+            (void)Schema_CreateModelAction(model, name);
+        }
+        umock_c_reset_all_calls();
+
+        ///act
+        SCHEMA_PROPERTY_HANDLE property = Schema_GetModelPropertyByName(model, "property39");
+        SCHEMA_ACTION_HANDLE action = Schema_GetModelActionByName(model, "action0");
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelPropertyByIndex(model, 39), property);
+        ASSERT_ARE_EQUAL(void_ptr, Schema_GetModelActionByIndex(model, 0), action);
+
+        ///clean
+        Schema_Destroy(schemaHandle);
+    }
 END_TEST_SUITE(Schema_ut)
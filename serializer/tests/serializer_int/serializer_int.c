@@ -13,6 +13,7 @@
 #include "umock_c_negative_tests.h"
 
 #include "parson.h"
+#include "azure_c_shared_utility/tickcounter.h"
 
 static TEST_MUTEX_HANDLE g_testByTest;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -873,6 +874,33 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+#define LARGE_MODEL_ELEMENTS 2000
+#define LARGE_MODEL_LOOKUP_ROUNDS 5
+
+static int largeModelDesiredPropertyFromAGENT_DATA_TYPE(const AGENT_DATA_TYPE* source, void* dest)
+{
+    (void)source;
+    (void)dest;
+    return 0;
+}
+
+static int largeModelDesiredPropertyToAGENT_DATA_TYPE(const void* source, AGENT_DATA_TYPE* dest)
+{
+    (void)source;
+    (void)dest;
+    return 0;
+}
+
+static void largeModelDesiredPropertyInitialize(void* destination)
+{
+    (void)destination;
+}
+
+static void largeModelDesiredPropertyDeinitialize(void* destination)
+{
+    (void)destination;
+}
+
 BEGIN_TEST_SUITE(serializer_int)
 
     TEST_SUITE_INITIALIZE(TestClassInitialize)
@@ -2421,5 +2449,68 @@ BEGIN_TEST_SUITE(serializer_int)
         DESTROY_MODEL_INSTANCE(modelWithData);
     }
 
+    /*the following test measures name lookups on a model that has LARGE_MODEL_ELEMENTS properties, reported properties, desired properties, actions, methods and models in model*/
+    /*every lookup goes through the schema name indexes, the elapsed time is logged*/
+    TEST_FUNCTION(Schema_lookups_on_a_large_model_benchmark)
+    {
+        ///arrange
+        SCHEMA_HANDLE schemaHandle = Schema_Create("largeModelNamespace", (void*)0x42);
+        SCHEMA_MODEL_TYPE_HANDLE model = Schema_CreateModelType(schemaHandle, "largeModel");
+        SCHEMA_MODEL_TYPE_HANDLE innerModel = Schema_CreateModelType(schemaHandle, "innerModel");
+        TICK_COUNTER_HANDLE tickCounter = tickcounter_create();
+        tickcounter_ms_t start;
+        tickcounter_ms_t end;
+        size_t found = 0;
+        size_t round;
+        size_t i;
+        char name[32];
+        ASSERT_IS_NOT_NULL(tickCounter);
+        for (i = 0; i < LARGE_MODEL_ELEMENTS; i++)
+        {
+            (void)sprintf(name, "property%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(int, SCHEMA_OK, Schema_AddModelProperty(model, name, "int"));
+            (void)sprintf(name, "reported%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(int, SCHEMA_OK, Schema_AddModelReportedProperty(model, name, "int"));
+            (void)sprintf(name, "desired%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(int, SCHEMA_OK, Schema_AddModelDesiredProperty(model, name, "int", largeModelDesiredPropertyFromAGENT_DATA_TYPE, largeModelDesiredPropertyToAGENT_DATA_TYPE, largeModelDesiredPropertyInitialize, largeModelDesiredPropertyDeinitialize, i, NULL));
+            (void)sprintf(name, "action%u", (unsigned int)i);
+            ASSERT_IS_NOT_NULL(Schema_CreateModelAction(model, name));
+            (void)sprintf(name, "method%u", (unsigned int)i);
+            ASSERT_IS_NOT_NULL(Schema_CreateModelMethod(model, name));
+            (void)sprintf(name, "inner%u", (unsigned int)i);
+            ASSERT_ARE_EQUAL(int, SCHEMA_OK, Schema_AddModelModel(model, name, innerModel, i, NULL));
+        }
+
+        ///act
+        ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_ms(tickCounter, &start));
+        for (round = 0; round < LARGE_MODEL_LOOKUP_ROUNDS; round++)
+        {
+            for (i = 0; i < LARGE_MODEL_ELEMENTS; i++)
+            {
+                (void)sprintf(name, "property%u", (unsigned int)i);
+                found += (Schema_GetModelElementByName(model, name).elementType == SCHEMA_PROPERTY) ? 1 : 0;
+                (void)sprintf(name, "reported%u", (unsigned int)i);
+                found += (Schema_GetModelElementByName(model, name).elementType == SCHEMA_REPORTED_PROPERTY) ? 1 : 0;
+                (void)sprintf(name, "desired%u", (unsigned int)i);
+                found += (Schema_GetModelElementByName(model, name).elementType == SCHEMA_DESIRED_PROPERTY) ? 1 : 0;
+                (void)sprintf(name, "action%u", (unsigned int)i);
+                found += (Schema_GetModelElementByName(model, name).elementType == SCHEMA_MODEL_ACTION) ? 1 : 0;
+                (void)sprintf(name, "method%u", (unsigned int)i);
+                found += (Schema_GetModelMethodByName(model, name) != NULL) ? 1 : 0;
+                (void)sprintf(name, "inner%u", (unsigned int)i);
+                found += (Schema_GetModelElementByName(model, name).elementType == SCHEMA_MODEL_IN_MODEL) ? 1 : 0;
+            }
+        }
+        ASSERT_ARE_EQUAL(int, 0, tickcounter_get_current_ms(tickCounter, &end));
+        LogInfo("%u schema lookups on a model with %u elements of each kind took %u ms", (unsigned int)found, (unsigned int)LARGE_MODEL_ELEMENTS, (unsigned int)(end - start));
+
+        ///assert
+        ASSERT_ARE_EQUAL(size_t, (size_t)(6 * LARGE_MODEL_ELEMENTS * LARGE_MODEL_LOOKUP_ROUNDS), found);
+        ASSERT_ARE_EQUAL(int, SCHEMA_NOT_FOUND, Schema_GetModelElementByName(model, "property2000").elementType);
+
+        ///clean
+        tickcounter_destroy(tickCounter);
+        Schema_Destroy(schemaHandle);
+    }
 
 END_TEST_SUITE(serializer_int)